@@ -0,0 +1,89 @@
+#include "BenchmarkUtility.h"
+
+#include "Utility.h"
+
+#include <algorithm>
+#include <fstream>
+
+LONGLONG GetBenchmarkTick()
+{
+	LARGE_INTEGER count = {};
+	QueryPerformanceCounter( &count );
+	return count.QuadPart;
+}
+
+double GetBenchmarkSeconds( const LONGLONG startTick, const LONGLONG endTick )
+{
+	LARGE_INTEGER tickFreq = {};
+	QueryPerformanceFrequency( &tickFreq );
+	return ( tickFreq.QuadPart > 0 ) ? ( static_cast<double>( endTick - startTick ) / tickFreq.QuadPart ) : 0;
+}
+
+double GetBenchmarkMilliseconds( const LONGLONG startTick, const LONGLONG endTick )
+{
+	return 1000.0 * GetBenchmarkSeconds( startTick, endTick );
+}
+
+double GetBenchmarkPercentile( BenchmarkValues values, const double percentile )
+{
+	double result = 0;
+	if ( !values.empty() ) {
+		std::sort( values.begin(), values.end() );
+		const size_t index = std::min<size_t>( values.size() - 1, static_cast<size_t>( percentile / 100 * values.size() ) );
+		result = values[ index ];
+	}
+	return result;
+}
+
+nlohmann::json BenchmarkPercentilesToJSON( const BenchmarkValues& values )
+{
+	nlohmann::json result;
+	result[ "count" ] = values.size();
+	for ( const double percentile : kBenchmarkPercentiles ) {
+		result[ "p" + std::to_string( static_cast<int>( percentile ) ) ] = GetBenchmarkPercentile( values, percentile );
+	}
+	return result;
+}
+
+std::string GetBenchmarkPercentileHeadings()
+{
+	std::string headings = "count";
+	for ( const double percentile : kBenchmarkPercentiles ) {
+		headings += ",p" + std::to_string( static_cast<int>( percentile ) );
+	}
+	return headings;
+}
+
+void WriteBenchmarkPercentiles( std::ostream& stream, const BenchmarkValues& values )
+{
+	stream << values.size();
+	for ( const double percentile : kBenchmarkPercentiles ) {
+		stream << "," << GetBenchmarkPercentile( values, percentile );
+	}
+}
+
+bool IsBenchmarkCSV( const std::wstring& outputFilename )
+{
+	return ( L"csv" == GetFileExtension( outputFilename ) );
+}
+
+bool WriteBenchmarkJSON( const nlohmann::json& document, const std::wstring& outputFilename )
+{
+	std::ofstream stream( outputFilename, std::ios::out | std::ios::trunc );
+	if ( stream.is_open() ) {
+		stream << document.dump( 2 ) << std::endl;
+	}
+	return stream.good();
+}
+
+bool WriteBenchmarkCSV( const std::wstring& outputFilename, const std::string& headings, const std::function<void( std::ostream& stream )>& writeRows )
+{
+	std::ofstream stream( outputFilename, std::ios::out | std::ios::trunc );
+	if ( stream.is_open() ) {
+		stream << headings << std::endl;
+		if ( writeRows ) {
+			writeRows( stream );
+		}
+	}
+	return stream.good();
+}
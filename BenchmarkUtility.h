@@ -0,0 +1,51 @@
+#pragma once
+
+#include "stdafx.h"
+
+#include "json.hpp"
+
+#include <array>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Shared timing, statistics & results file support for the command-line benchmarks & tests.
+
+// A list of measurements.
+using BenchmarkValues = std::vector<double>;
+
+// Percentiles reported for a list of measurements.
+constexpr std::array kBenchmarkPercentiles = { 50.0, 90.0, 99.0 };
+
+// Gets the current tick count.
+LONGLONG GetBenchmarkTick();
+
+// Returns the interval between the 'startTick' and 'endTick' tick counts, in seconds.
+double GetBenchmarkSeconds( const LONGLONG startTick, const LONGLONG endTick );
+
+// Returns the interval between the 'startTick' and 'endTick' tick counts, in milliseconds.
+double GetBenchmarkMilliseconds( const LONGLONG startTick, const LONGLONG endTick );
+
+// Returns the 'percentile' (in the range 0 to 100) of the 'values'.
+double GetBenchmarkPercentile( BenchmarkValues values, const double percentile );
+
+// Returns the number of 'values', along with each of the reported percentiles, as a JSON object.
+nlohmann::json BenchmarkPercentilesToJSON( const BenchmarkValues& values );
+
+// Returns the CSV column headings for the number of values & each of the reported percentiles (without a leading comma).
+std::string GetBenchmarkPercentileHeadings();
+
+// Writes the number of 'values', along with each of the reported percentiles, as CSV columns to the 'stream' (without a leading comma).
+void WriteBenchmarkPercentiles( std::ostream& stream, const BenchmarkValues& values );
+
+// Returns whether the results 'outputFilename' should be written as CSV (if the file has a .csv extension), rather than as JSON.
+bool IsBenchmarkCSV( const std::wstring& outputFilename );
+
+// Writes the JSON 'document' to the 'outputFilename', returning whether the file was written.
+bool WriteBenchmarkJSON( const nlohmann::json& document, const std::wstring& outputFilename );
+
+// Writes CSV results to the 'outputFilename', returning whether the file was written.
+// 'headings' - CSV column headings.
+// 'writeRows' - called to write the CSV rows to the output stream.
+bool WriteBenchmarkCSV( const std::wstring& outputFilename, const std::string& headings, const std::function<void( std::ostream& stream )>& writeRows );
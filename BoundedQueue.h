@@ -0,0 +1,104 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <utility>
+
+// A first-in first-out queue with a maximum capacity, for passing items between the stages of a pipeline.
+// Producers wait while the queue is full (so that a slow consumer holds back its producers), and consumers wait while the queue is empty.
+// The queue is closed once all producers have finished, after which consumers take any remaining items and then stop.
+template <typename T>
+class BoundedQueue
+{
+public:
+	// 'capacity' - maximum number of queued items.
+	explicit BoundedQueue( const size_t capacity ) :
+		m_Items(),
+		m_Capacity( ( capacity > 0 ) ? capacity : 1 ),
+		m_Closed( false ),
+		m_Cancelled( false ),
+		m_Mutex(),
+		m_NotEmpty(),
+		m_NotFull()
+	{
+	}
+
+	virtual ~BoundedQueue()
+	{
+	}
+
+	BoundedQueue( const BoundedQueue& ) = delete;
+	BoundedQueue& operator=( const BoundedQueue& ) = delete;
+
+	// Adds an 'item' to the queue, waiting while the queue is full.
+	// Returns false if the item could not be added because the queue has been closed or cancelled.
+	bool Push( T item )
+	{
+		std::unique_lock<std::mutex> lock( m_Mutex );
+		m_NotFull.wait( lock, [ this ] () { return m_Closed || m_Cancelled || ( m_Items.size() < m_Capacity ); } );
+		const bool success = !m_Closed && !m_Cancelled;
+		if ( success ) {
+			m_Items.push_back( std::move( item ) );
+			m_NotEmpty.notify_one();
+		}
+		return success;
+	}
+
+	// Takes the next 'item' from the queue, waiting while the queue is empty.
+	// Returns false if no item was taken because the queue has been cancelled, or closed with no items remaining.
+	bool Pop( T& item )
+	{
+		std::unique_lock<std::mutex> lock( m_Mutex );
+		m_NotEmpty.wait( lock, [ this ] () { return m_Closed || m_Cancelled || !m_Items.empty(); } );
+		const bool success = !m_Cancelled && !m_Items.empty();
+		if ( success ) {
+			item = std::move( m_Items.front() );
+			m_Items.pop_front();
+			m_NotFull.notify_one();
+		}
+		return success;
+	}
+
+	// Closes the queue, indicating that no more items will be added.
+	void Close()
+	{
+		std::lock_guard<std::mutex> lock( m_Mutex );
+		m_Closed = true;
+		m_NotEmpty.notify_all();
+		m_NotFull.notify_all();
+	}
+
+	// Cancels the queue, discarding any queued items and releasing all waiting producers & consumers.
+	void Cancel()
+	{
+		std::lock_guard<std::mutex> lock( m_Mutex );
+		m_Cancelled = true;
+		m_Items.clear();
+		m_NotEmpty.notify_all();
+		m_NotFull.notify_all();
+	}
+
+private:
+	// Queued items.
+	std::deque<T> m_Items;
+
+	// Maximum number of queued items.
+	const size_t m_Capacity;
+
+	// Indicates whether the queue has been closed.
+	bool m_Closed;
+
+	// Indicates whether the queue has been cancelled.
+	bool m_Cancelled;
+
+	// Queue mutex.
+	std::mutex m_Mutex;
+
+	// Signalled when an item is added, or the queue is closed or cancelled.
+	std::condition_variable m_NotEmpty;
+
+	// Signalled when an item is taken, or the queue is closed or cancelled.
+	std::condition_variable m_NotFull;
+};
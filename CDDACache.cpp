@@ -13,6 +13,17 @@ bool CDDACache::GetData( const long sector, CDDAMedia::Data& data )
 	return success;
 }
 
+bool CDDACache::GetData( const long sector, short* data )
+{
+	std::lock_guard<std::mutex> lock( m_Mutex );
+	const auto iter = m_Cache.find( sector );
+	const bool success = ( m_Cache.end() != iter );
+	if ( success ) {
+		std::copy( iter->second.begin(), iter->second.end(), data );
+	}
+	return success;
+}
+
 void CDDACache::SetData( const long sector, const CDDAMedia::Data& data )
 {
 	std::lock_guard<std::mutex> lock( m_Mutex );
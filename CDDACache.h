@@ -14,6 +14,9 @@ public:
 	// Gets CD audio 'data' for the 'sector' index, returning whether the sector data was retrieved.
 	bool GetData( const long sector, CDDAMedia::Data& data );
 
+	// Copies CD audio data for the 'sector' index into the 'data' buffer (which must be large enough to hold a sector), returning whether the sector data was retrieved.
+	bool GetData( const long sector, short* data );
+
 	// Caches the CD audio 'data' for the 'sector' index.
 	void SetData( const long sector, const CDDAMedia::Data& data );
 
@@ -1,10 +1,9 @@
 #include "CDDAExtract.h"
 
 #include "resource.h"
+#include "TrackAnalyser.h"
 #include "Utility.h"
 
-#include "ebur128.h"
-
 #include <iomanip>
 #include <sstream>
 
@@ -416,11 +415,17 @@ void CDDAExtract::EncodeHandler()
 		bool extractJoin = false;
 		m_Settings.GetExtractSettings( extractFolder, extractFilename, extractToLibrary, extractJoin );
 
-		std::vector<ebur128_state*> r128States;
+		// Only loudness analysis is required when extracting.
+		TrackAnalyser::Analysers loudnessOnly;
+		loudnessOnly.Peak = false;
+		loudnessOnly.Silence = false;
+		loudnessOnly.Crossfade = false;
+
+		std::vector<TrackAnalyser::Ptr> analysers;
 		if ( !extractJoin ) {
-			r128States.reserve( trackCount );
+			analysers.reserve( trackCount );
 		}
-		ebur128_state* r128State = nullptr;
+		TrackAnalyser::Ptr analyser;
 
 		bool encoderOK = true;
 		if ( extractJoin ) {
@@ -428,10 +433,8 @@ void CDDAExtract::EncodeHandler()
 			const long channels = m_Tracks.front().Info.GetChannels();
 			const auto bps = m_Tracks.front().Info.GetBitsPerSample();
 			encoderOK = m_Encoder->Open( m_JoinFilename, sampleRate, channels, bps, totalSamples, m_EncoderSettings, {} /*tags*/ );
-			r128State = ebur128_init( static_cast<unsigned int>( channels ), static_cast<unsigned int>( sampleRate ), EBUR128_MODE_I );
-			if ( nullptr != r128State ) {
-				r128States.push_back( r128State );
-			}
+			analyser = std::make_shared<TrackAnalyser>( channels, sampleRate, loudnessOnly );
+			analysers.push_back( analyser );
 		}
 
 		if ( encoderOK ) {
@@ -459,10 +462,8 @@ void CDDAExtract::EncodeHandler()
 					long long samplesEncoded = 0;
 
 					if ( !extractJoin ) {
-						r128State = ebur128_init( static_cast<unsigned int>( channels ), static_cast<unsigned int>( sampleRate ), EBUR128_MODE_I );
-						if ( nullptr != r128State ) {
-							r128States.push_back( r128State );
-						}
+						analyser = std::make_shared<TrackAnalyser>( channels, sampleRate, loudnessOnly );
+						analysers.push_back( analyser );
 					}
 
 					std::wstring filename = extractJoin ? m_JoinFilename : GetOutputFilename( mediaInfo );
@@ -470,7 +471,7 @@ void CDDAExtract::EncodeHandler()
 						if ( extractJoin || m_Encoder->Open( filename, sampleRate, channels, bps, trackSamplesTotal, m_EncoderSettings, m_Library.GetTags( mediaInfo ) ) ) {
 							const long sampleBufferSize = 65536;
 							std::vector<float> sampleBuffer( sampleBufferSize * channels );
-							int r128Error = EBUR128_SUCCESS;
+							bool analysisOK = true;
 							auto sourceIter = data->begin();
 							while ( !Cancelled() && ( data->end() != sourceIter ) ) {
 								auto destIter = sampleBuffer.begin();
@@ -479,8 +480,8 @@ void CDDAExtract::EncodeHandler()
 								}
 								const long sampleCount = static_cast<long>( destIter - sampleBuffer.begin() ) / channels;
 								if ( m_Encoder->Write( &sampleBuffer[ 0 ], sampleCount ) ) {
-									if ( ( nullptr != r128State ) && ( EBUR128_SUCCESS == r128Error ) ) {
-										r128Error = ebur128_add_frames_float( r128State, &sampleBuffer[ 0 ], static_cast<size_t>( sampleCount ) );
+									if ( analysisOK ) {
+										analysisOK = analyser->Add( &sampleBuffer[ 0 ], static_cast<size_t>( sampleCount ) );
 									}
 									samplesEncoded += sampleCount;
 									totalSamplesEncoded += sampleCount;
@@ -504,26 +505,15 @@ void CDDAExtract::EncodeHandler()
 									break;
 								}
 							} else {
-								if ( nullptr != r128State ) {
-									double loudness = 0;
-									if ( EBUR128_SUCCESS == ebur128_loudness_global( r128State, &loudness ) ) {
-										const float trackGain = LOUDNESS_REFERENCE - static_cast<float>( loudness );
-										mediaInfo.SetGainTrack( trackGain );
-									}
+								if ( analyser ) {
+									mediaInfo.SetGainTrack( analyser->GetResults().TrackGain );
 								}
 								WriteTrackTags( filename, mediaInfo );
 
 								encodedMediaList.push_back( MediaInfo( filename ) );
 
 								if ( ++tracksEncoded == trackCount ) {
-									std::optional<float> albumGain;
-									if ( !r128States.empty() ) {
-										double loudness = 0;
-										if ( EBUR128_SUCCESS == ebur128_loudness_global_multiple( &r128States[ 0 ], r128States.size(), &loudness ) ) {
-											albumGain = LOUDNESS_REFERENCE - static_cast<float>( loudness );
-										}
-									}
-									mediaInfo.SetGainAlbum( albumGain );
+									mediaInfo.SetGainAlbum( TrackAnalyser::GetAlbumGain( analysers ) );
 
 									for ( auto& encodedMedia : encodedMediaList ) {
 										WriteAlbumTags( encodedMedia.GetFilename(), mediaInfo );					
@@ -557,12 +547,8 @@ void CDDAExtract::EncodeHandler()
 				MediaInfo::GetCommonInfo( mediaList, joinedMediaInfo );
 				joinedMediaInfo.SetFilename( m_JoinFilename );
 
-				if ( nullptr != r128State ) {
-					double loudness = 0;
-					if ( EBUR128_SUCCESS == ebur128_loudness_global( r128State, &loudness ) ) {
-						const float trackGain = LOUDNESS_REFERENCE - static_cast<float>( loudness );
-						joinedMediaInfo.SetGainTrack( trackGain );
-					}
+				if ( analyser ) {
+					joinedMediaInfo.SetGainTrack( analyser->GetResults().TrackGain );
 				}
 
 				WriteTrackTags( joinedMediaInfo.GetFilename(), joinedMediaInfo );
@@ -579,11 +565,6 @@ void CDDAExtract::EncodeHandler()
 		if ( !encoderOK && !Cancelled() ) {
 			PostMessage( m_hWnd, MSG_EXTRACTERROR, IDS_EXTRACT_ERROR_ENCODER, 0 );
 		}
-
-		for ( const auto& iter : r128States ) {
-			ebur128_state* state = iter;
-			ebur128_destroy( &state );
-		}
 	}
 }
 
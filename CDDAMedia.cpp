@@ -368,6 +368,54 @@ bool CDDAMedia::Read( const HANDLE handle, const long sectorStart, const long se
 	return success;
 }
 
+long CDDAMedia::Read( const HANDLE handle, const long sectorStart, const long sectorCount, const bool useCache, Data& data ) const
+{
+	long sectorsRead = 0;
+	if ( ( nullptr != handle ) && ( sectorCount > 0 ) ) {
+		constexpr size_t kSamplesPerSector = SECTORSIZE / 2;
+		data.resize( static_cast<size_t>( sectorCount ) * kSamplesPerSector );
+
+		// Use any leading sectors that are already cached.
+		if ( useCache ) {
+			while ( ( sectorsRead < sectorCount ) && m_Cache->GetData( sectorStart + sectorsRead, data.data() + sectorsRead * kSamplesPerSector ) ) {
+				++sectorsRead;
+			}
+		}
+
+		// Read the remaining sectors with a single request, reducing the request size if the drive cannot satisfy it.
+		if ( sectorsRead < sectorCount ) {
+			short* buffer = data.data() + sectorsRead * kSamplesPerSector;
+
+			RAW_READ_INFO info = {};
+			info.SectorCount = static_cast<ULONG>( sectorCount - sectorsRead );
+			info.TrackMode = CDDA;
+			info.DiskOffset.QuadPart = ( sectorStart + sectorsRead - PREGAP ) * m_DiskGeometry.BytesPerSector;
+
+			DWORD bufferSize = info.SectorCount * SECTORSIZE;
+			DWORD bytesRead = 0;
+			bool success = ( FALSE != DeviceIoControl( handle, IOCTL_CDROM_RAW_READ, &info, sizeof( RAW_READ_INFO ), buffer, bufferSize, &bytesRead, 0 ) ) && ( bufferSize == bytesRead );
+			while ( !success && ( info.SectorCount >= 2 ) ) {
+				info.SectorCount /= 2;
+				bufferSize = info.SectorCount * SECTORSIZE;
+				success = ( FALSE != DeviceIoControl( handle, IOCTL_CDROM_RAW_READ, &info, sizeof( RAW_READ_INFO ), buffer, bufferSize, &bytesRead, 0 ) ) && ( bufferSize == bytesRead );
+			}
+
+			if ( success ) {
+				if ( useCache ) {
+					for ( ULONG sector = 0; sector < info.SectorCount; sector++ ) {
+						const short* sectorData = buffer + sector * kSamplesPerSector;
+						m_Cache->SetData( sectorStart + sectorsRead + static_cast<long>( sector ), Data( sectorData, sectorData + kSamplesPerSector ) );
+					}
+				}
+				sectorsRead += static_cast<long>( info.SectorCount );
+			}
+		}
+
+		data.resize( static_cast<size_t>( sectorsRead ) * kSamplesPerSector );
+	}
+	return sectorsRead;
+}
+
 bool CDDAMedia::ReadCDText( BlockMap& blocks ) const
 {
 	bool success = false;
@@ -71,6 +71,15 @@ public:
 	// Returns whether any sectors were read successfully.
 	bool Read( const HANDLE handle, const long sectorStart, const long sectorCount, DataMap& data ) const;
 
+	// Reads contiguous CD audio sectors into a single buffer.
+	// 'handle' - CD handle.
+	// 'sectorStart' - start sector index.
+	// 'sectorCount' - the maximum number of sectors to read.
+	// 'useCache' - whether to use (and populate) the sector cache.
+	// 'data' - out, the CD audio data for the sectors that were read.
+	// Returns the number of sectors read.
+	long Read( const HANDLE handle, const long sectorStart, const long sectorCount, const bool useCache, Data& data ) const;
+
 	// Returns the start sector of the CD audio 'track'.
 	long GetStartSector( const long track ) const;
 
@@ -1,10 +1,9 @@
 #include "Converter.h"
 
 #include "resource.h"
+#include "TrackAnalyser.h"
 #include "Utility.h"
 
-#include "ebur128.h"
-
 #include <iomanip>
 #include <sstream>
 
@@ -208,11 +207,11 @@ void Converter::EncodeHandler()
 		bool extractJoin = false;
 		m_Settings.GetExtractSettings( extractFolder, extractFilename, extractToLibrary, extractJoin );
 
-		std::vector<ebur128_state*> r128States;
+		std::vector<TrackAnalyser::Ptr> analysers;
 		if ( !extractJoin ) {
-			r128States.reserve( m_Tracks.size() );
+			analysers.reserve( m_Tracks.size() );
 		}
-		ebur128_state* r128State = nullptr;
+		TrackAnalyser::Ptr analyser;
 
 		long joinChannels = 0;
 		long joinSampleRate = 0;
@@ -223,10 +222,12 @@ void Converter::EncodeHandler()
 				joinSampleRate = decoder->GetSampleRate();
 				const long long totalSamples = static_cast<long long>( totalDuration * joinSampleRate );
 				conversionOK = m_Encoder->Open( m_JoinFilename, joinSampleRate, joinChannels, decoder->GetBPS(), totalSamples, m_EncoderSettings, {} /*tags*/ );
-				r128State = ebur128_init( static_cast<unsigned int>( joinChannels ), static_cast<unsigned int>( joinSampleRate ), EBUR128_MODE_I );
-				if ( nullptr != r128State ) {
-					r128States.push_back( r128State );
-				}
+				TrackAnalyser::Analysers loudnessOnly;
+				loudnessOnly.Peak = false;
+				loudnessOnly.Silence = false;
+				loudnessOnly.Crossfade = false;
+				analyser = std::make_shared<TrackAnalyser>( joinChannels, joinSampleRate, loudnessOnly );
+				analysers.push_back( analyser );
 			} else {
 				conversionOK = false;
 			}
@@ -262,19 +263,18 @@ void Converter::EncodeHandler()
 							std::vector<float> sampleBuffer( sampleCount * channels );
 
 							if ( !extractJoin ) {
-								r128State = ebur128_init( static_cast<unsigned int>( channels ), static_cast<unsigned int>( sampleRate ), EBUR128_MODE_I );
-								if ( nullptr != r128State ) {
-									r128States.push_back( r128State );
-								}
+								// Apply all analysers, so that the results can also be stored for the source file.
+								analyser = std::make_shared<TrackAnalyser>( channels, sampleRate, TrackAnalyser::GetAllAnalysers() );
+								analysers.push_back( analyser );
 							}
 
-							int r128Error = EBUR128_SUCCESS;
+							bool analysisOK = true;
 							bool continueEncoding = true;
 							while ( !Cancelled() && continueEncoding ) {
 								const long samplesRead = decoder->Read( &sampleBuffer[ 0 ], sampleCount );
 								if ( samplesRead > 0 ) {
-									if ( ( nullptr != r128State ) && ( EBUR128_SUCCESS == r128Error ) ) {
-										r128Error = ebur128_add_frames_float( r128State, &sampleBuffer[ 0 ], static_cast<size_t>( samplesRead ) );
+									if ( analysisOK ) {
+										analysisOK = analyser->Add( &sampleBuffer[ 0 ], static_cast<size_t>( samplesRead ) );
 									}
 									continueEncoding = m_Encoder->Write( &sampleBuffer[ 0 ], samplesRead );
 
@@ -295,11 +295,11 @@ void Converter::EncodeHandler()
 							if ( !extractJoin ) {
 								m_Encoder->Close();
 
-								if ( nullptr != r128State ) {
-									double loudness = 0;
-									if ( EBUR128_SUCCESS == ebur128_loudness_global( r128State, &loudness ) ) {
-										const float trackGain = LOUDNESS_REFERENCE - static_cast<float>( loudness );
-										mediaInfo.SetGainTrack( trackGain );
+								if ( analysisOK ) {
+									const TrackAnalyser::Results results = analyser->GetResults();
+									mediaInfo.SetGainTrack( results.TrackGain );
+									if ( !Cancelled() && ( MediaInfo::Source::File == track->Info.GetSource() ) ) {
+										m_Library.SetAnalysis( track->Info, results );
 									}
 								}
 
@@ -332,12 +332,8 @@ void Converter::EncodeHandler()
 					MediaInfo::GetCommonInfo( mediaList, joinedMediaInfo );
 					joinedMediaInfo.SetFilename( m_JoinFilename );
 
-					if ( nullptr != r128State ) {
-						double loudness = 0;
-						if ( EBUR128_SUCCESS == ebur128_loudness_global( r128State, &loudness ) ) {
-							const float trackGain = LOUDNESS_REFERENCE - static_cast<float>( loudness );
-							joinedMediaInfo.SetGainTrack( trackGain );
-						}
+					if ( analyser ) {
+						joinedMediaInfo.SetGainTrack( analyser->GetResults().TrackGain );
 					}
 
 					WriteTrackTags( joinedMediaInfo.GetFilename(), joinedMediaInfo );
@@ -355,14 +351,7 @@ void Converter::EncodeHandler()
 					}
 
 					if ( writeAlbumGain ) {
-						std::optional<float> albumGain;
-						if ( !r128States.empty() ) {
-							double loudness = 0;
-							if ( EBUR128_SUCCESS == ebur128_loudness_global_multiple( &r128States[ 0 ], r128States.size(), &loudness ) ) {
-								albumGain = LOUDNESS_REFERENCE - static_cast<float>( loudness );
-							}
-						}
-
+						const std::optional<float> albumGain = TrackAnalyser::GetAlbumGain( analysers );
 						if ( albumGain.has_value() ) {
 							for ( auto& encodedMedia : encodedMediaList ) {
 								encodedMedia.SetGainAlbum( albumGain );
@@ -377,11 +366,6 @@ void Converter::EncodeHandler()
 				}
 			}
 		}
-		
-		for ( const auto& iter : r128States ) {
-			ebur128_state* state = iter;
-			ebur128_destroy( &state );
-		}
 	}
 
 	if ( !Cancelled() ) {
@@ -0,0 +1,93 @@
+#include "CrossfadeCalculator.h"
+
+#include "TrackAnalyser.h"
+#include "Utility.h"
+
+DWORD WINAPI CrossfadeCalculator::CalculateThreadProc( LPVOID lpParam )
+{
+	CrossfadeCalculator* calculator = reinterpret_cast<CrossfadeCalculator*>( lpParam );
+	if ( nullptr != calculator ) {
+		calculator->Handler();
+	}
+	return 0;
+}
+
+CrossfadeCalculator::CrossfadeCalculator( Library& library, const Handlers& handlers ) :
+	m_Library( library ),
+	m_Handlers( handlers ),
+	m_Queue(),
+	m_Pending(),
+	m_Mutex(),
+	m_StopEvent( CreateEvent( NULL /*attributes*/, TRUE /*manualReset*/, FALSE /*initialState*/, L"" /*name*/ ) ),
+	m_WakeEvent( CreateEvent( NULL /*attributes*/, TRUE /*manualReset*/, FALSE /*initialState*/, L"" /*name*/ ) ),
+	m_Thread( NULL )
+{
+	if ( ( NULL != m_StopEvent ) && ( NULL != m_WakeEvent ) ) {
+		m_Thread = CreateThread( NULL /*attributes*/, 0 /*stackSize*/, CalculateThreadProc, reinterpret_cast<LPVOID>( this ), 0 /*flags*/, NULL /*threadId*/ );
+	}
+}
+
+CrossfadeCalculator::~CrossfadeCalculator()
+{
+	Stop();
+}
+
+void CrossfadeCalculator::Calculate( const Playlist::ItemList& items )
+{
+	std::lock_guard<std::mutex> lock( m_Mutex );
+	if ( NULL != m_Thread ) {
+		for ( const auto& item : items ) {
+			const std::wstring& filename = item.Info.GetFilename();
+			if ( ( MediaInfo::Source::File == item.Info.GetSource() ) && !IsURL( filename ) && m_Pending.insert( filename ).second ) {
+				m_Queue.push_back( item.Info );
+			}
+		}
+		if ( !m_Queue.empty() ) {
+			SetEvent( m_WakeEvent );
+		}
+	}
+}
+
+void CrossfadeCalculator::Stop()
+{
+	if ( NULL != m_Thread ) {
+		SetEvent( m_StopEvent );
+		WaitForSingleObject( m_Thread, INFINITE );
+		CloseHandle( m_StopEvent );
+		m_StopEvent = NULL;
+		CloseHandle( m_WakeEvent );
+		m_WakeEvent = NULL;
+		CloseHandle( m_Thread );
+		m_Thread = NULL;
+	}
+}
+
+void CrossfadeCalculator::Handler()
+{
+	const Decoder::CanContinue canContinue( [ stopEvent = m_StopEvent ] ()
+	{
+		return ( WAIT_OBJECT_0 != WaitForSingleObject( stopEvent, 0 ) );
+	} );
+
+	HANDLE eventHandles[ 2 ] = { m_StopEvent, m_WakeEvent };
+	while ( WaitForMultipleObjects( 2, eventHandles, FALSE /*waitAll*/, INFINITE ) != WAIT_OBJECT_0 ) {
+		std::optional<MediaInfo> mediaInfo;
+		{
+			std::lock_guard<std::mutex> lock( m_Mutex );
+			if ( m_Queue.empty() ) {
+				ResetEvent( m_WakeEvent );
+			} else {
+				mediaInfo = m_Queue.front();
+				m_Queue.pop_front();
+			}
+		}
+
+		if ( mediaInfo.has_value() ) {
+			const std::wstring& filename = mediaInfo->GetFilename();
+			TrackAnalyser::AnalyseFile( *mediaInfo, m_Library, m_Handlers, canContinue );
+
+			std::lock_guard<std::mutex> lock( m_Mutex );
+			m_Pending.erase( filename );
+		}
+	}
+}
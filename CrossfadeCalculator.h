@@ -0,0 +1,62 @@
+#pragma once
+
+#include "stdafx.h"
+
+#include "Handlers.h"
+#include "Library.h"
+#include "Playlist.h"
+
+#include <list>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+
+// Calculates crossfade points in the background, storing them in the media library.
+// As the track analyser applies all analysers in a single pass, this also stores loudness, peak & silence information.
+class CrossfadeCalculator
+{
+public:
+	// 'library' - media library.
+	// 'handlers' - media handlers.
+	CrossfadeCalculator( Library& library, const Handlers& handlers );
+
+	virtual ~CrossfadeCalculator();
+
+	// Calculates crossfade points for the playlist 'items' (skipping any which already have a complete analysis in the library).
+	void Calculate( const Playlist::ItemList& items );
+
+	// Stops any pending crossfade point calculations.
+	void Stop();
+
+private:
+	// Calculation thread procedure.
+	static DWORD WINAPI CalculateThreadProc( LPVOID lpParam );
+
+	// Calculation thread handler.
+	void Handler();
+
+	// Media library.
+	Library& m_Library;
+
+	// Media handlers.
+	const Handlers& m_Handlers;
+
+	// The queue of files for which to calculate crossfade points.
+	std::list<MediaInfo> m_Queue;
+
+	// The filenames which are queued, or currently being calculated.
+	std::set<std::wstring> m_Pending;
+
+	// The mutex for the queue.
+	std::mutex m_Mutex;
+
+	// Handle to stop the calculation thread.
+	HANDLE m_StopEvent;
+
+	// Handle to wake the calculation thread.
+	HANDLE m_WakeEvent;
+
+	// Calculation thread.
+	HANDLE m_Thread;
+};
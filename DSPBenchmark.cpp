@@ -0,0 +1,477 @@
+#include "DSPBenchmark.h"
+
+#include "Equaliser.h"
+#include "Limiter.h"
+#include "SampleProcessing.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <random>
+
+// Channel counts to check & measure (covering both the vectorised & scalar kernel paths).
+constexpr std::array kGainChannels = { 1l, 2l, 3l, 4l, 6l, 8l };
+
+// Buffer sizes to check & measure, in samples per channel (including sizes which are not a multiple of the vector width).
+constexpr std::array kGainFrames = { 147l, 441l, 4096l };
+
+// Preamp applied when checking & measuring the gain kernels, in dB (enough to require clipping).
+constexpr float kGainPreamp = 3.5f;
+
+// Amount of audio to process when measuring throughput, in seconds at 48kHz.
+constexpr long kBenchmarkSeconds = 60;
+
+// Sample rates at which to measure the limiter.
+constexpr std::array kLimiterSampleRates = { 44100l, 96000l, 192000l };
+
+// Number of channels when measuring the limiter.
+constexpr long kLimiterChannels = 2;
+
+// Look-ahead window & release time when measuring the limiter, in milliseconds (the default settings).
+constexpr float kLimiterLookAhead = 5.0f;
+constexpr float kLimiterRelease = 200.0f;
+
+// Gain applied to the limiter test signal, in dB (similar to the gain applied to a quiet track).
+constexpr float kLimiterGain = 10.0f;
+
+// Limiter test signal duration, in seconds.
+constexpr long kLimiterSeconds = 20;
+
+// Sample rate when checking the equaliser frequency response.
+constexpr long kEQResponseSampleRate = 48000;
+
+// Number of channels when checking the equaliser frequency response (covering both a full & a partial group of channels).
+constexpr long kEQResponseChannels = 6;
+
+// Band gain when checking the equaliser frequency response, in dB.
+constexpr float kEQResponseGain = 6.0f;
+
+// Test tone duration when checking the equaliser frequency response, & the amount of output to ignore while the filters settle, in seconds.
+constexpr double kEQResponseDuration = 1.0;
+constexpr double kEQResponseSettle = 0.25;
+
+// Maximum difference allowed between the measured & expected equaliser responses, in dB.
+// At the centre frequency, a peaking filter has exactly the band gain, while the response well outside the band should be almost flat.
+constexpr double kEQCentreTolerance = 0.1;
+constexpr double kEQOffTolerance = 0.5;
+
+// The distance of the off-band test tone from the band centre frequency, in octaves.
+constexpr double kEQOffOctaves = 3.0;
+
+// Sample rate, channel counts, band gain & test signal duration when measuring equaliser performance.
+constexpr long kEQSampleRate = 44100;
+constexpr std::array kEQChannels = { 2l, 6l };
+constexpr float kEQGain = 3.0f;
+constexpr long kEQSeconds = 20;
+
+// Maximum absolute difference allowed between the kernel & reference outputs.
+// The kernel folds the gain & ramp factor into a single multiply, so the output can differ from the separate passes by rounding only.
+constexpr double kGoldenTolerance = 1e-6;
+
+// Returns the ramp factor for a 'frame', treating values outside the range 0 to 1 as 0.
+static float GetRampFactor( const float rampStart, const float rampStep, const long frame )
+{
+	const float factor = rampStart + rampStep * static_cast<float>( frame );
+	return ( ( factor < 0 ) || ( factor > 1.0f ) ) ? 0 : factor;
+}
+
+// Applies gain, a ramp & (optionally) a hard clip as separate passes, in the same way as previously used for output.
+static void ReferenceGainRamp( float* buffer, const long channels, const long frames, const float scale, const float rampStart, const float rampStep, const bool hardClip )
+{
+	const long totalSamples = frames * channels;
+	for ( long sampleIndex = 0; sampleIndex < totalSamples; sampleIndex++ ) {
+		buffer[ sampleIndex ] *= scale;
+	}
+	if ( ( 1.0f != rampStart ) || ( 0 != rampStep ) ) {
+		for ( long frame = 0; frame < frames; frame++ ) {
+			const float factor = GetRampFactor( rampStart, rampStep, frame );
+			for ( long channel = 0; channel < channels; channel++ ) {
+				buffer[ frame * channels + channel ] *= factor;
+			}
+		}
+	}
+	if ( hardClip ) {
+		for ( long sampleIndex = 0; sampleIndex < totalSamples; sampleIndex++ ) {
+			if ( buffer[ sampleIndex ] < -1.0f ) {
+				buffer[ sampleIndex ] = -1.0f;
+			} else if ( buffer[ sampleIndex ] > 1.0f ) {
+				buffer[ sampleIndex ] = 1.0f;
+			}
+		}
+	}
+}
+
+// Mixes 'input' into 'output' with a ramp applied, in the same way as previously used for output.
+static void ReferenceMixRamp( float* output, const float* input, const long channels, const long frames, const float rampStart, const float rampStep )
+{
+	for ( long frame = 0; frame < frames; frame++ ) {
+		const float factor = GetRampFactor( rampStart, rampStep, frame );
+		for ( long channel = 0; channel < channels; channel++ ) {
+			output[ frame * channels + channel ] += input[ frame * channels + channel ] * factor;
+		}
+	}
+}
+
+// Returns the amplitude of a test tone at 'frequency' in the interleaved 'samples', using a least squares fit, ignoring the first 'settleFrames'.
+// 'channels' - number of channels.
+// 'channel' - channel to measure.
+// 'sampleRate' - sample rate.
+static double GetToneAmplitude( const std::vector<float>& samples, const long channels, const long channel, const long sampleRate, const double frequency, const size_t settleFrames )
+{
+	constexpr double kPi = 3.14159265358979323846;
+	const double omega = 2 * kPi * frequency / sampleRate;
+	double ss = 0, sc = 0, cc = 0, ys = 0, yc = 0;
+	const size_t frames = samples.size() / channels;
+	for ( size_t frame = settleFrames; frame < frames; frame++ ) {
+		const double s = sin( omega * static_cast<double>( frame ) );
+		const double c = cos( omega * static_cast<double>( frame ) );
+		const double y = samples[ frame * channels + channel ];
+		ss += s * s;
+		sc += s * c;
+		cc += c * c;
+		ys += y * s;
+		yc += y * c;
+	}
+	double amplitude = 0;
+	const double determinant = ss * cc - sc * sc;
+	if ( 0 != determinant ) {
+		const double a = ( ys * cc - yc * sc ) / determinant;
+		const double b = ( yc * ss - ys * sc ) / determinant;
+		amplitude = sqrt( a * a + b * b );
+	}
+	return amplitude;
+}
+
+// Returns the worst case response, in dB, of the equaliser 'settings' to a test tone at 'frequency', over all channels (relative to the 'expected' response).
+static double GetEQResponse( const Settings::EQ& settings, const double frequency, const double expected )
+{
+	constexpr double kPi = 3.14159265358979323846;
+	constexpr double kAmplitude = 0.25;
+	const size_t frames = static_cast<size_t>( kEQResponseDuration * kEQResponseSampleRate );
+	std::vector<float> samples( frames * kEQResponseChannels );
+	for ( size_t frame = 0; frame < frames; frame++ ) {
+		const float value = static_cast<float>( kAmplitude * sin( 2 * kPi * frequency * static_cast<double>( frame ) / kEQResponseSampleRate ) );
+		std::fill( samples.begin() + frame * kEQResponseChannels, samples.begin() + ( frame + 1 ) * kEQResponseChannels, value );
+	}
+
+	Equaliser equaliser;
+	equaliser.SetSettings( settings );
+	const size_t blockSize = kEQResponseSampleRate / 100;
+	for ( size_t frame = 0; frame < frames; frame += blockSize ) {
+		equaliser.Process( samples.data() + frame * kEQResponseChannels, kEQResponseChannels, kEQResponseSampleRate, std::min<size_t>( blockSize, frames - frame ) );
+	}
+
+	double response = expected;
+	const size_t settleFrames = static_cast<size_t>( kEQResponseSettle * kEQResponseSampleRate );
+	for ( long channel = 0; channel < kEQResponseChannels; channel++ ) {
+		const double amplitude = GetToneAmplitude( samples, kEQResponseChannels, channel, kEQResponseSampleRate, frequency, settleFrames );
+		const double channelResponse = ( amplitude > 0 ) ? ( 20 * log10( amplitude / kAmplitude ) ) : -200.0;
+		if ( std::fabs( channelResponse - expected ) > std::fabs( response - expected ) ) {
+			response = channelResponse;
+		}
+	}
+	return response;
+}
+
+// Returns the maximum absolute difference between 'first' & 'second'.
+static double GetMaxError( const std::vector<float>& first, const std::vector<float>& second )
+{
+	double maxError = 0;
+	for ( size_t index = 0; index < std::min<size_t>( first.size(), second.size() ); index++ ) {
+		maxError = std::max<double>( maxError, std::fabs( static_cast<double>( first[ index ] ) - second[ index ] ) );
+	}
+	return maxError;
+}
+
+DSPBenchmark::DSPBenchmark()
+{
+}
+
+DSPBenchmark::~DSPBenchmark()
+{
+}
+
+bool DSPBenchmark::Run( const std::wstring& outputFilename ) const
+{
+	bool passed = true;
+	GainResults gainResults;
+	for ( const long channels : kGainChannels ) {
+		for ( const long frames : kGainFrames ) {
+			gainResults.push_back( MeasureGain( channels, frames ) );
+			passed = passed && gainResults.back().Passed;
+		}
+	}
+
+	LimiterResults limiterResults;
+	for ( const long sampleRate : kLimiterSampleRates ) {
+		limiterResults.push_back( MeasureLimiter( sampleRate ) );
+	}
+
+	EQResponseResults eqResponseResults;
+	for ( size_t bandIndex = 0; bandIndex < Settings::EQ().Gains.size(); bandIndex++ ) {
+		eqResponseResults.push_back( MeasureEQResponse( bandIndex ) );
+		passed = passed && eqResponseResults.back().Passed;
+	}
+
+	EQResults eqResults;
+	for ( const long channels : kEQChannels ) {
+		for ( long bandCount = 1; bandCount <= static_cast<long>( Settings::EQ().Gains.size() ); bandCount++ ) {
+			eqResults.push_back( MeasureEQ( channels, bandCount ) );
+		}
+	}
+
+	const bool success = IsBenchmarkCSV( outputFilename ) ?
+		WriteCSV( gainResults, limiterResults, eqResponseResults, eqResults, outputFilename ) :
+		WriteJSON( gainResults, limiterResults, eqResponseResults, eqResults, outputFilename );
+	return passed && success;
+}
+
+DSPBenchmark::GainResult DSPBenchmark::MeasureGain( const long channels, const long frames )
+{
+	GainResult result;
+	result.Channels = channels;
+	result.Frames = frames;
+
+	// Full scale noise at twice the clipping level, so that the preamp requires clipping.
+	const size_t sampleCount = static_cast<size_t>( channels * frames );
+	std::vector<float> input( sampleCount );
+	std::mt19937 engine( static_cast<unsigned int>( channels * frames ) );
+	std::uniform_real_distribution<float> dist( -2.0f, 2.0f );
+	for ( auto& sample : input ) {
+		sample = dist( engine );
+	}
+
+	// Check the kernels against the reference implementation, for gain only, gain & clip, and a fade out which completes within the buffer.
+	const float scale = powf( 10.0f, kGainPreamp / 20.0f );
+	const float fadeStep = -1.0f / ( frames / 2 );
+	struct GainCase {
+		float Scale;
+		float RampStart;
+		float RampStep;
+		bool HardClip;
+	};
+	const std::array gainCases = {
+		GainCase{ scale, 1.0f, 0, false },
+		GainCase{ scale, 1.0f, 0, true },
+		GainCase{ scale, 0.75f, fadeStep, true },
+		GainCase{ 1.0f / scale, 1.0f, fadeStep, false }
+	};
+	std::vector<float> kernelOutput( sampleCount );
+	std::vector<float> referenceOutput( sampleCount );
+	for ( const auto& gainCase : gainCases ) {
+		kernelOutput = input;
+		referenceOutput = input;
+		ApplyGainRamp( kernelOutput.data(), static_cast<size_t>( channels ), static_cast<size_t>( frames ), gainCase.Scale, gainCase.RampStart, gainCase.RampStep, gainCase.HardClip );
+		ReferenceGainRamp( referenceOutput.data(), channels, frames, gainCase.Scale, gainCase.RampStart, gainCase.RampStep, gainCase.HardClip );
+		result.MaxError = std::max<double>( result.MaxError, GetMaxError( kernelOutput, referenceOutput ) );
+	}
+
+	// Check the mix kernel, mixing the reversed input into the input, with a fade out.
+	const std::vector<float> mixInput( input.rbegin(), input.rend() );
+	kernelOutput = input;
+	referenceOutput = input;
+	MixRamp( kernelOutput.data(), mixInput.data(), static_cast<size_t>( channels ), static_cast<size_t>( frames ), 0.75f, fadeStep );
+	ReferenceMixRamp( referenceOutput.data(), mixInput.data(), channels, frames, 0.75f, fadeStep );
+	result.MaxError = std::max<double>( result.MaxError, GetMaxError( kernelOutput, referenceOutput ) );
+	result.Passed = ( result.MaxError <= kGoldenTolerance );
+
+	// Measure throughput with gain, clipping & a fade ramp applied, restoring the input for each buffer.
+	// The reference path converts the preamp to a scale factor for each buffer, as was previously the case.
+	const long iterations = std::max<long>( 1l, kBenchmarkSeconds * 48000 / frames );
+	std::vector<float> buffer( sampleCount );
+	LONGLONG startTick = GetBenchmarkTick();
+	for ( long iteration = 0; iteration < iterations; iteration++ ) {
+		std::copy( input.begin(), input.end(), buffer.begin() );
+		const float referenceScale = powf( 10.0f, kGainPreamp / 20.0f );
+		ReferenceGainRamp( buffer.data(), channels, frames, referenceScale, 1.0f, -1.0f / ( 48000 * 10 ), true /*hardClip*/ );
+	}
+	const double referenceSeconds = GetBenchmarkSeconds( startTick, GetBenchmarkTick() );
+
+	startTick = GetBenchmarkTick();
+	for ( long iteration = 0; iteration < iterations; iteration++ ) {
+		std::copy( input.begin(), input.end(), buffer.begin() );
+		ApplyGainRamp( buffer.data(), static_cast<size_t>( channels ), static_cast<size_t>( frames ), scale, 1.0f, -1.0f / ( 48000 * 10 ), true /*hardClip*/ );
+	}
+	const double kernelSeconds = GetBenchmarkSeconds( startTick, GetBenchmarkTick() );
+
+	const double samples = static_cast<double>( sampleCount ) * iterations;
+	result.ReferenceThroughput = ( referenceSeconds > 0 ) ? ( samples / referenceSeconds / 1e6 ) : 0;
+	result.KernelThroughput = ( kernelSeconds > 0 ) ? ( samples / kernelSeconds / 1e6 ) : 0;
+	return result;
+}
+
+DSPBenchmark::LimiterResult DSPBenchmark::MeasureLimiter( const long sampleRate )
+{
+	LimiterResult result;
+	result.SampleRate = sampleRate;
+
+	// Generate the test signal up front, so that only the limiter is timed.
+	// The signal is a pair of tones with a decaying percussive burst every half second, which gives both sustained & transient peaks.
+	constexpr double kPi = 3.14159265358979323846;
+	const size_t frames = static_cast<size_t>( kLimiterSeconds ) * sampleRate;
+	const double gain = pow( 10.0, kLimiterGain / 20.0 );
+	std::vector<float> input( frames * kLimiterChannels );
+	std::mt19937 engine( static_cast<unsigned int>( sampleRate ) );
+	std::uniform_real_distribution<double> dist( -1.0, 1.0 );
+	for ( size_t frame = 0; frame < frames; frame++ ) {
+		const double time = static_cast<double>( frame ) / sampleRate;
+		const double burst = exp( -40.0 * fmod( time, 0.5 ) ) * dist( engine );
+		for ( long channel = 0; channel < kLimiterChannels; channel++ ) {
+			const double tones = 0.3 * sin( 2 * kPi * 220.0 * time ) + 0.2 * sin( 2 * kPi * ( 3300.0 + 100.0 * channel ) * time );
+			const float value = static_cast<float>( gain * ( tones + 0.4 * burst ) );
+			input[ frame * kLimiterChannels + channel ] = value;
+			result.InputPeak = std::max<double>( result.InputPeak, std::fabs( value ) );
+		}
+	}
+
+	// Process in 10ms blocks, in the same way as output.
+	Limiter limiter;
+	limiter.Configure( kLimiterChannels, sampleRate, kLimiterLookAhead, kLimiterRelease );
+	const size_t blockSize = static_cast<size_t>( sampleRate / 100 );
+	const LONGLONG startTick = GetBenchmarkTick();
+	for ( size_t frame = 0; frame < frames; frame += blockSize ) {
+		limiter.Process( input.data() + frame * kLimiterChannels, std::min<size_t>( blockSize, frames - frame ) );
+	}
+	const double seconds = GetBenchmarkSeconds( startTick, GetBenchmarkTick() );
+
+	result.CPUTime = 1000 * seconds / kLimiterSeconds;
+	result.Throughput = ( seconds > 0 ) ? ( kLimiterSeconds / seconds ) : 0;
+	result.ClippedSamples = std::count_if( input.begin(), input.end(), [] ( const float value ) { return std::fabs( value ) >= 1.0f; } );
+	return result;
+}
+
+DSPBenchmark::EQResponseResult DSPBenchmark::MeasureEQResponse( const size_t bandIndex )
+{
+	EQResponseResult result;
+	Settings::EQ settings;
+	settings.Enabled = true;
+	auto band = settings.Gains.begin();
+	std::advance( band, bandIndex );
+	band->second = kEQResponseGain;
+	result.Frequency = static_cast<float>( band->first );
+	result.Gain = kEQResponseGain;
+
+	// Check the response well outside the band, above the band for low frequencies and below the band otherwise.
+	const double offRatio = pow( 2.0, kEQOffOctaves );
+	result.OffFrequency = static_cast<float>( ( result.Frequency < 1000 ) ? ( result.Frequency * offRatio ) : ( result.Frequency / offRatio ) );
+
+	result.CentreResponse = GetEQResponse( settings, result.Frequency, result.Gain );
+	result.OffResponse = GetEQResponse( settings, result.OffFrequency, 0 );
+	result.Passed = ( std::fabs( result.CentreResponse - result.Gain ) <= kEQCentreTolerance ) && ( std::fabs( result.OffResponse ) <= kEQOffTolerance );
+	return result;
+}
+
+DSPBenchmark::EQResult DSPBenchmark::MeasureEQ( const long channels, const long bandCount )
+{
+	EQResult result;
+	result.Channels = channels;
+	result.Bands = bandCount;
+
+	Settings::EQ settings;
+	settings.Enabled = true;
+	settings.Gains.erase( std::next( settings.Gains.begin(), bandCount ), settings.Gains.end() );
+	for ( auto& band : settings.Gains ) {
+		band.second = kEQGain;
+	}
+
+	const size_t frames = static_cast<size_t>( kEQSeconds ) * kEQSampleRate;
+	std::vector<float> samples( frames * channels );
+	std::mt19937 engine( static_cast<unsigned int>( channels * bandCount ) );
+	std::uniform_real_distribution<float> dist( -0.5f, 0.5f );
+	for ( auto& sample : samples ) {
+		sample = dist( engine );
+	}
+
+	// Process in 10ms blocks, in the same way as output.
+	Equaliser equaliser;
+	equaliser.SetSettings( settings );
+	const size_t blockSize = static_cast<size_t>( kEQSampleRate / 100 );
+	const LONGLONG startTick = GetBenchmarkTick();
+	for ( size_t frame = 0; frame < frames; frame += blockSize ) {
+		equaliser.Process( samples.data() + frame * channels, channels, kEQSampleRate, std::min<size_t>( blockSize, frames - frame ) );
+	}
+	const double seconds = GetBenchmarkSeconds( startTick, GetBenchmarkTick() );
+
+	result.CPUTime = 1000 * seconds / kEQSeconds;
+	result.Throughput = ( seconds > 0 ) ? ( kEQSeconds / seconds ) : 0;
+	return result;
+}
+
+bool DSPBenchmark::WriteJSON( const GainResults& gainResults, const LimiterResults& limiterResults, const EQResponseResults& eqResponseResults, const EQResults& eqResults, const std::wstring& outputFilename )
+{
+	nlohmann::json document;
+	for ( const auto& result : gainResults ) {
+		nlohmann::json entry;
+		entry[ "passed" ] = result.Passed;
+		entry[ "max_error" ] = result.MaxError;
+		entry[ "reference_msamples_per_s" ] = result.ReferenceThroughput;
+		entry[ "kernel_msamples_per_s" ] = result.KernelThroughput;
+		entry[ "speedup" ] = ( result.ReferenceThroughput > 0 ) ? ( result.KernelThroughput / result.ReferenceThroughput ) : 0;
+		document[ "gain" ][ std::to_string( result.Channels ) ][ std::to_string( result.Frames ) ] = entry;
+	}
+	for ( const auto& result : limiterResults ) {
+		nlohmann::json entry;
+		entry[ "cpu_ms_per_s" ] = result.CPUTime;
+		entry[ "x_realtime" ] = result.Throughput;
+		entry[ "input_peak" ] = result.InputPeak;
+		entry[ "clipped_samples" ] = result.ClippedSamples;
+		document[ "limiter" ][ std::to_string( result.SampleRate ) ] = entry;
+	}
+	for ( const auto& result : eqResponseResults ) {
+		nlohmann::json entry;
+		entry[ "passed" ] = result.Passed;
+		entry[ "gain_db" ] = result.Gain;
+		entry[ "centre_db" ] = result.CentreResponse;
+		entry[ "off_hz" ] = result.OffFrequency;
+		entry[ "off_db" ] = result.OffResponse;
+		document[ "eq_response" ][ std::to_string( static_cast<int>( result.Frequency ) ) ] = entry;
+	}
+	for ( const auto& result : eqResults ) {
+		nlohmann::json entry;
+		entry[ "cpu_ms_per_s" ] = result.CPUTime;
+		entry[ "cpu_ms_per_s_per_band" ] = result.CPUTime / result.Bands;
+		entry[ "x_realtime" ] = result.Throughput;
+		document[ "eq" ][ std::to_string( result.Channels ) ][ std::to_string( result.Bands ) ] = entry;
+	}
+	return WriteBenchmarkJSON( document, outputFilename );
+}
+
+bool DSPBenchmark::WriteCSV( const GainResults& gainResults, const LimiterResults& limiterResults, const EQResponseResults& eqResponseResults, const EQResults& eqResults, const std::wstring& outputFilename )
+{
+	return WriteBenchmarkCSV( outputFilename, "test,case,metric,value", [ &gainResults, &limiterResults, &eqResponseResults, &eqResults ] ( std::ostream& stream )
+	{
+		const auto writeRow = [ &stream ] ( const std::string& test, const std::string& testCase, const std::string& metric, const double value )
+		{
+			stream << test << "," << testCase << "," << metric << "," << value << std::endl;
+		};
+
+		for ( const auto& result : gainResults ) {
+			const std::string testCase = std::to_string( result.Channels ) + "ch:" + std::to_string( result.Frames );
+			writeRow( "gain", testCase, "passed", result.Passed ? 1.0 : 0.0 );
+			writeRow( "gain", testCase, "max_error", result.MaxError );
+			writeRow( "gain", testCase, "reference_msamples_per_s", result.ReferenceThroughput );
+			writeRow( "gain", testCase, "kernel_msamples_per_s", result.KernelThroughput );
+		}
+		for ( const auto& result : limiterResults ) {
+			const std::string testCase = std::to_string( result.SampleRate );
+			writeRow( "limiter", testCase, "cpu_ms_per_s", result.CPUTime );
+			writeRow( "limiter", testCase, "x_realtime", result.Throughput );
+			writeRow( "limiter", testCase, "input_peak", result.InputPeak );
+			writeRow( "limiter", testCase, "clipped_samples", static_cast<double>( result.ClippedSamples ) );
+		}
+		for ( const auto& result : eqResponseResults ) {
+			const std::string testCase = std::to_string( static_cast<int>( result.Frequency ) );
+			writeRow( "eq_response", testCase, "passed", result.Passed ? 1.0 : 0.0 );
+			writeRow( "eq_response", testCase, "gain_db", result.Gain );
+			writeRow( "eq_response", testCase, "centre_db", result.CentreResponse );
+			writeRow( "eq_response", testCase, "off_hz", result.OffFrequency );
+			writeRow( "eq_response", testCase, "off_db", result.OffResponse );
+		}
+		for ( const auto& result : eqResults ) {
+			const std::string testCase = std::to_string( result.Channels ) + "ch:" + std::to_string( result.Bands );
+			writeRow( "eq", testCase, "cpu_ms_per_s", result.CPUTime );
+			writeRow( "eq", testCase, "cpu_ms_per_s_per_band", result.CPUTime / result.Bands );
+			writeRow( "eq", testCase, "x_realtime", result.Throughput );
+		}
+	} );
+}
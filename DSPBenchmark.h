@@ -0,0 +1,91 @@
+#pragma once
+
+#include "stdafx.h"
+
+#include "BenchmarkUtility.h"
+
+#include <string>
+#include <vector>
+
+// Checks the output of the real-time DSP kernels against reference implementations, and measures their performance.
+class DSPBenchmark
+{
+public:
+	DSPBenchmark();
+
+	virtual ~DSPBenchmark();
+
+	// Runs the benchmark.
+	// 'outputFilename' - results file, written as CSV if the file has a .csv extension, otherwise as JSON.
+	// Returns whether the results were written, and all the output checks passed.
+	bool Run( const std::wstring& outputFilename ) const;
+
+private:
+	// Result for the gain, fade ramp & clip kernels, for a channel count & buffer size.
+	struct GainResult {
+		long Channels = 0;								// Number of channels.
+		long Frames = 0;									// Buffer size, in samples per channel.
+		double ReferenceThroughput = 0;		// Throughput of the separate gain, clip & fade passes, in millions of samples per second.
+		double KernelThroughput = 0;			// Throughput of the single pass kernel, in millions of samples per second.
+		double MaxError = 0;							// Maximum absolute difference between the kernel & reference outputs.
+		bool Passed = false;							// Whether the kernel output matched the reference output.
+	};
+
+	// A list of gain results.
+	using GainResults = std::vector<GainResult>;
+
+	// Result for the look-ahead limiter, at a sample rate.
+	struct LimiterResult {
+		long SampleRate = 0;							// Sample rate.
+		double CPUTime = 0;								// Processing time per second of audio, in milliseconds.
+		double Throughput = 0;						// Throughput, as a multiple of real time.
+		double InputPeak = 0;							// Peak input sample level.
+		long long ClippedSamples = 0;			// Number of output samples at the ceiling (which should be very few, as gain is reduced ahead of each peak).
+	};
+
+	// A list of limiter results.
+	using LimiterResults = std::vector<LimiterResult>;
+
+	// Frequency response result for an equaliser band.
+	struct EQResponseResult {
+		float Frequency = 0;							// Band centre frequency, in Hz.
+		float Gain = 0;										// Band gain, in dB.
+		double CentreResponse = 0;				// Measured response at the band centre frequency, in dB.
+		float OffFrequency = 0;						// Frequency well outside the band, in Hz.
+		double OffResponse = 0;						// Measured response well outside the band, in dB.
+		bool Passed = false;							// Whether the measured responses were as expected.
+	};
+
+	// A list of equaliser frequency response results.
+	using EQResponseResults = std::vector<EQResponseResult>;
+
+	// Performance result for the equaliser, for a channel count & number of bands.
+	struct EQResult {
+		long Channels = 0;								// Number of channels.
+		long Bands = 0;										// Number of bands.
+		double CPUTime = 0;								// Processing time per second of audio, in milliseconds.
+		double Throughput = 0;						// Throughput, as a multiple of real time.
+	};
+
+	// A list of equaliser performance results.
+	using EQResults = std::vector<EQResult>;
+
+	// Checks the gain, fade ramp & clip kernels against the reference implementation, for a number of 'channels' & buffer size in 'frames'.
+	// Also measures the kernels against separate gain, clip & fade passes, in the same way as previously used for output.
+	static GainResult MeasureGain( const long channels, const long frames );
+
+	// Measures the CPU cost of the look-ahead limiter at a 'sampleRate', for a stereo signal which is boosted well above full scale.
+	static LimiterResult MeasureLimiter( const long sampleRate );
+
+	// Measures the equaliser frequency response with a single band of the default EQ settings boosted, at the 'bandIndex'.
+	static EQResponseResult MeasureEQResponse( const size_t bandIndex );
+
+	// Measures the CPU cost of the equaliser for a number of 'channels', using the first 'bandCount' bands of the default EQ settings.
+	static EQResult MeasureEQ( const long channels, const long bandCount );
+
+	// Writes the 'gainResults', 'limiterResults', 'eqResponseResults' & 'eqResults' as JSON to the 'outputFilename', returning whether the file was written.
+	static bool WriteJSON( const GainResults& gainResults, const LimiterResults& limiterResults, const EQResponseResults& eqResponseResults, const EQResults& eqResults, const std::wstring& outputFilename );
+
+	// Writes the 'gainResults', 'limiterResults', 'eqResponseResults' & 'eqResults' as CSV to the 'outputFilename', returning whether the file was written.
+	static bool WriteCSV( const GainResults& gainResults, const LimiterResults& limiterResults, const EQResponseResults& eqResponseResults, const EQResults& eqResults, const std::wstring& outputFilename );
+};
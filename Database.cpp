@@ -2,12 +2,21 @@
 
 #include "Utility.h"
 
+#include <algorithm>
+
+// Maximum number of statements to cache for each thread.
+constexpr size_t kMaxCachedStatements = 64;
+
+thread_local Database::ThreadStatementCaches Database::s_ThreadStatementCaches;
+
 Database::Database( const std::wstring& filename, const Mode mode ) :
 	m_Database( nullptr ),
 	m_Filename( filename ),
 	m_Mode( ( filename.empty() && ( Mode::Disk == mode ) ) ? Mode::Memory : mode ),
 	m_LogMutex(),
-	m_Log()
+	m_Log(),
+	m_StatementCache( std::make_shared<StatementCache>() ),
+	m_TransactionMutex()
 {
 	int result = sqlite3_config( SQLITE_CONFIG_LOG, ErrorLogCallback, this );
 	result = sqlite3_initialize();
@@ -80,6 +89,15 @@ Database::Database( const std::wstring& filename, const Mode mode ) :
 
 Database::~Database()
 {
+	{
+		// Threads which still have cached statements no longer access them once the cache is closed.
+		std::lock_guard<std::mutex> lock( m_StatementCache->Mutex );
+		for ( const auto statements : m_StatementCache->ThreadStatements ) {
+			FinalizeStatements( *statements );
+		}
+		m_StatementCache->ThreadStatements.clear();
+		m_StatementCache->Closed = true;
+	}
 	if ( nullptr != m_Database ) {
 		if ( !m_Filename.empty() && ( Mode::Disk != m_Mode ) ) {
 			// Write out the temporary database to disk.
@@ -128,3 +146,130 @@ void Database::AppendToErrorLog( const int errorCode, const std::string& message
 	std::lock_guard<std::mutex> lock( m_LogMutex );
 	m_Log.push_back( std::make_pair( errorCode, message ) );
 }
+
+int Database::PrepareStatement( const std::string& query, sqlite3_stmt** stmt )
+{
+	int result = SQLITE_MISUSE;
+	if ( nullptr != stmt ) {
+		*stmt = nullptr;
+		{
+			std::lock_guard<std::mutex> lock( m_StatementCache->Mutex );
+			StatementList& statements = s_ThreadStatementCaches.GetStatements( m_StatementCache );
+			const auto statement = std::find_if( statements.begin(), statements.end(), [ &query ] ( const StatementList::value_type& entry )
+			{
+				return query == entry.first;
+			} );
+			if ( statements.end() != statement ) {
+				// Hand out the cached statement, so that it cannot be used again until it has been released.
+				*stmt = statement->second;
+				statements.erase( statement );
+				result = SQLITE_OK;
+			}
+		}
+		if ( nullptr == *stmt ) {
+			result = sqlite3_prepare_v2( m_Database, query.c_str(), -1 /*nByte*/, stmt, nullptr /*tail*/ );
+		}
+	}
+	return result;
+}
+
+void Database::ReleaseStatement( sqlite3_stmt* stmt )
+{
+	if ( nullptr != stmt ) {
+		sqlite3_reset( stmt );
+		sqlite3_clear_bindings( stmt );
+		const char* query = sqlite3_sql( stmt );
+		if ( nullptr != query ) {
+			std::lock_guard<std::mutex> lock( m_StatementCache->Mutex );
+			StatementList& statements = s_ThreadStatementCaches.GetStatements( m_StatementCache );
+			statements.push_front( std::make_pair( std::string( query ), stmt ) );
+			stmt = nullptr;
+			if ( statements.size() > kMaxCachedStatements ) {
+				// Evict the least recently used statement.
+				stmt = statements.back().second;
+				statements.pop_back();
+			}
+		}
+		sqlite3_finalize( stmt );
+	}
+}
+
+void Database::ClearStatementCache()
+{
+	std::lock_guard<std::mutex> lock( m_StatementCache->Mutex );
+	for ( const auto statements : m_StatementCache->ThreadStatements ) {
+		FinalizeStatements( *statements );
+	}
+}
+
+void Database::FinalizeStatements( StatementList& statements )
+{
+	for ( const auto& statement : statements ) {
+		sqlite3_finalize( statement.second );
+	}
+	statements.clear();
+}
+
+Database::ThreadStatementCaches::ThreadStatementCaches() :
+	m_Statements()
+{
+}
+
+Database::ThreadStatementCaches::~ThreadStatementCaches()
+{
+	for ( auto& [ cache, statements ] : m_Statements ) {
+		std::lock_guard<std::mutex> lock( cache->Mutex );
+		if ( !cache->Closed ) {
+			FinalizeStatements( statements );
+			cache->ThreadStatements.erase( &statements );
+		}
+	}
+}
+
+Database::StatementList& Database::ThreadStatementCaches::GetStatements( const std::shared_ptr<StatementCache>& cache )
+{
+	auto statements = m_Statements.find( cache );
+	if ( m_Statements.end() == statements ) {
+		// Discard the statement lists for any closed databases (which have already been finalized).
+		for ( auto iter = m_Statements.begin(); m_Statements.end() != iter; ) {
+			iter = iter->first->Closed ? m_Statements.erase( iter ) : std::next( iter );
+		}
+		statements = m_Statements.insert( { cache, {} } ).first;
+		cache->ThreadStatements.insert( &statements->second );
+	}
+	return statements->second;
+}
+
+Database::Transaction::Transaction( Database& database ) :
+	m_Database( database ),
+	m_Lock( database.m_TransactionMutex ),
+	m_Active( ( nullptr != database.GetDatabase() ) && ( SQLITE_OK == sqlite3_exec( database.GetDatabase(), "BEGIN TRANSACTION;", NULL /*callback*/, NULL /*arg*/, NULL /*errMsg*/ ) ) )
+{
+}
+
+Database::Transaction::~Transaction()
+{
+	Rollback();
+}
+
+bool Database::Transaction::Commit()
+{
+	bool committed = true;
+	if ( m_Active ) {
+		committed = ( SQLITE_OK == sqlite3_exec( m_Database.GetDatabase(), "COMMIT TRANSACTION;", NULL /*callback*/, NULL /*arg*/, NULL /*errMsg*/ ) );
+		if ( committed ) {
+			m_Active = false;
+		} else {
+			Rollback();
+		}
+	}
+	return committed;
+}
+
+void Database::Transaction::Rollback()
+{
+	if ( m_Active ) {
+		sqlite3_exec( m_Database.GetDatabase(), "ROLLBACK TRANSACTION;", NULL /*callback*/, NULL /*arg*/, NULL /*errMsg*/ );
+		m_Active = false;
+	}
+}
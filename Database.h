@@ -4,8 +4,12 @@
 
 #include <sqlite3.h>
 
+#include <atomic>
 #include <list>
+#include <map>
+#include <memory>
 #include <mutex>
+#include <set>
 #include <string>
 
 class Database
@@ -28,7 +32,78 @@ public:
 	// Returns the SQLite database.
 	sqlite3* GetDatabase();
 
+	// Prepares a statement for the 'query', taking it from the calling thread's statement cache if possible.
+	// 'stmt' - out, prepared statement, which should be passed to ReleaseStatement (rather than finalized) when no longer needed.
+	// Returns the SQLite result code.
+	int PrepareStatement( const std::string& query, sqlite3_stmt** stmt );
+
+	// Resets the prepared 'stmt' and returns it to the calling thread's statement cache (a null statement is ignored).
+	void ReleaseStatement( sqlite3_stmt* stmt );
+
+	// Finalizes all cached statements, for all threads (this should be called after changing the database schema).
+	void ClearStatementCache();
+
+	// A write transaction, which is rolled back unless it is committed.
+	// Transactions are serialised, as all threads share the same database connection (transactions must therefore not be nested).
+	class Transaction
+	{
+	public:
+		// 'database' - database on which to begin the transaction.
+		Transaction( Database& database );
+
+		virtual ~Transaction();
+
+		// Commits the transaction, or rolls it back if the commit fails.
+		// Returns whether the writes made since the transaction was begun have been committed
+		// (if the transaction could not be begun, each write has already been committed on its own, so true is returned).
+		bool Commit();
+
+		// Rolls back the transaction.
+		void Rollback();
+
+	private:
+		// Database.
+		Database& m_Database;
+
+		// Holds the transaction mutex for the lifetime of the transaction.
+		std::lock_guard<std::mutex> m_Lock;
+
+		// Whether the transaction is in progress.
+		bool m_Active;
+	};
+
 private:
+	// Cached statements for a thread, paired with their query, with the most recently used statement at the front.
+	using StatementList = std::list<std::pair<std::string, sqlite3_stmt*>>;
+
+	// Prepared statement cache, which is shared between the database and each thread which has cached statements.
+	// The cache outlives the database for as long as any such thread is still running.
+	struct StatementCache {
+		std::mutex Mutex;												// Cache mutex.
+		std::set<StatementList*> ThreadStatements;		// Cached statements for each thread.
+		std::atomic<bool> Closed = false;				// Whether the database has been closed (and all cached statements finalized).
+	};
+
+	// Statement caches for the calling thread, for each database, which finalizes the thread's cached statements when the thread exits.
+	class ThreadStatementCaches
+	{
+	public:
+		ThreadStatementCaches();
+
+		virtual ~ThreadStatementCaches();
+
+		// Returns the calling thread's statements for the 'cache'.
+		// The cache mutex must be held by the caller.
+		StatementList& GetStatements( const std::shared_ptr<StatementCache>& cache );
+
+	private:
+		// Maps a database statement cache to the calling thread's statements.
+		std::map<std::shared_ptr<StatementCache>, StatementList> m_Statements;
+	};
+
+	// Finalizes the 'statements'.
+	static void FinalizeStatements( StatementList& statements );
+
 	// Appends an 'errorCode' & 'message' entry to the error log.
 	void AppendToErrorLog( const int errorCode, const std::string& message );
 
@@ -49,5 +124,14 @@ private:
 
 	// Error log, pairing a SQLite error code with the error description.
 	std::list<std::pair<int,std::string>> m_Log;
+
+	// Prepared statement cache.
+	const std::shared_ptr<StatementCache> m_StatementCache;
+
+	// Serialises transactions.
+	std::mutex m_TransactionMutex;
+
+	// Statement caches for the calling thread.
+	static thread_local ThreadStatementCaches s_ThreadStatementCaches;
 };
 
@@ -1,8 +1,7 @@
 #include "Decoder.h"
 
 #include "Settings.h"
-
-#include "ebur128.h"
+#include "TrackAnalyser.h"
 
 #include <windows.h>
 
@@ -85,39 +84,38 @@ std::optional<float> Decoder::CalculateTrackGain( CanContinue canContinue, const
 			Seek( m_Duration * 0.33f );
 		}
 
-		ebur128_state* r128State = ebur128_init( static_cast<unsigned int>( m_Channels ), static_cast<unsigned int>( m_SampleRate ), EBUR128_MODE_I );
-		if ( nullptr != r128State ) {
-			const long sampleSize = 4096;
-			std::vector<float> buffer( sampleSize * m_Channels );
-			long samplesRead = Read( buffer.data(), sampleSize );
-			int errorState = EBUR128_SUCCESS;
-			while ( ( EBUR128_SUCCESS == errorState ) && ( samplesRead > 0 ) && canContinue() ) {
-				errorState = ebur128_add_frames_float( r128State, buffer.data(), static_cast<size_t>( samplesRead ) );
-				if ( secondsLimit > 0 ) {
-					QueryPerformanceCounter( &perfEnd );
-					const float seconds = static_cast<float>( perfEnd.QuadPart - perfStart.QuadPart ) / perfFreq.QuadPart;
-					if ( seconds >= secondsLimit ) {
-						break;
-					}
+		TrackAnalyser::Analysers analysers;
+		analysers.Peak = false;
+		analysers.Silence = false;
+		analysers.Crossfade = false;
+		TrackAnalyser analyser( m_Channels, m_SampleRate, analysers );
+
+		const long sampleSize = 4096;
+		std::vector<float> buffer( sampleSize * m_Channels );
+		long samplesRead = Read( buffer.data(), sampleSize );
+		bool success = true;
+		while ( success && ( samplesRead > 0 ) && canContinue() ) {
+			success = analyser.Add( buffer.data(), static_cast<size_t>( samplesRead ) );
+			if ( secondsLimit > 0 ) {
+				QueryPerformanceCounter( &perfEnd );
+				const float seconds = static_cast<float>( perfEnd.QuadPart - perfStart.QuadPart ) / perfFreq.QuadPart;
+				if ( seconds >= secondsLimit ) {
+					break;
 				}
-				samplesRead = Read( buffer.data(), sampleSize );
 			}
+			samplesRead = Read( buffer.data(), sampleSize );
+		}
 
-			if ( ( EBUR128_SUCCESS == errorState ) && canContinue() ) {
-				double loudness = 0;
-				errorState = ebur128_loudness_global( r128State, &loudness );
-				if ( EBUR128_SUCCESS == errorState ) {
-					trackGain = LOUDNESS_REFERENCE - static_cast<float>( loudness );
-				}
-			}
-			ebur128_destroy( &r128State );
+		if ( success && canContinue() ) {
+			trackGain = analyser.GetResults().TrackGain;
 		}
 	}
 	return trackGain;
 }
 
-void Decoder::SkipSilence()
+float Decoder::SkipSilence()
 {
+	long long silentSamples = 0;
 	if ( m_Channels > 0 ) {
 		std::vector<float> buffer( m_Channels );
 		bool silence = true;
@@ -125,8 +123,13 @@ void Decoder::SkipSilence()
 			for ( auto sample = buffer.begin(); silence && ( sample != buffer.end() ); sample++ ) {
 				silence = ( 0 == *sample );
 			}
+			if ( silence ) {
+				++silentSamples;
+			}
 		}
 	}
+	const float seconds = ( m_SampleRate > 0 ) ? static_cast<float>( static_cast<double>( silentSamples ) / m_SampleRate ) : 0;
+	return seconds;
 }
 
 bool Decoder::SupportsStreamTitles() const
@@ -138,3 +141,17 @@ std::pair<float /*seconds*/, std::wstring /*title*/> Decoder::GetStreamTitle()
 {
 	return {};
 }
+
+bool Decoder::SupportsSeekIndex() const
+{
+	return false;
+}
+
+SeekIndex::Ptr Decoder::GenerateSeekIndex( CanContinue /*canContinue*/ )
+{
+	return nullptr;
+}
+
+void Decoder::SetSeekIndex( SeekIndex::Ptr /*seekIndex*/ )
+{
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "SeekIndex.h"
+
 #include <functional>
 #include <memory>
 #include <optional>
@@ -49,8 +51,8 @@ public:
 	// 'secondslimit' - number of seconds to devote to calculating an estimate, or 0 to perform a complete calculation.
 	virtual std::optional<float> CalculateTrackGain( CanContinue canContinue, const float secondsLimit = 0 );
 
-	// Skips any leading silence.
-	void SkipSilence();
+	// Skips any leading silence, returning the amount of silence skipped, in seconds.
+	float SkipSilence();
 
 	// Returns whether stream titles are supported.
 	virtual bool SupportsStreamTitles() const;
@@ -58,6 +60,17 @@ public:
 	// Returns the current stream title, and the position (in seconds) at which the title last changed.
 	virtual std::pair<float /*seconds*/, std::wstring /*title*/> GetStreamTitle();
 
+	// Returns whether the decoder can make use of a seek index.
+	virtual bool SupportsSeekIndex() const;
+
+	// Generates a seek index by scanning the stream from the current position.
+	// 'canContinue' - callback which returns whether generation can continue.
+	// Returns the seek index, or nullptr if a seek index is not supported or generation was cancelled.
+	virtual SeekIndex::Ptr GenerateSeekIndex( CanContinue canContinue );
+
+	// Sets the 'seekIndex' to use when seeking.
+	virtual void SetSeekIndex( SeekIndex::Ptr seekIndex );
+
 protected:
 	// Sets the 'duration'.
 	void SetDuration( const float duration );
@@ -305,7 +305,8 @@ bool DecoderBass::SupportsStreamTitles() const
 
 std::pair<float /*seconds*/, std::wstring /*title*/> DecoderBass::GetStreamTitle()
 {
-	return m_StreamTitle;	
+	std::lock_guard<std::mutex> lock( m_StreamTitleMutex );
+	return m_StreamTitle;
 }
 
 void CALLBACK DecoderBass::MetadataSyncProc( HSYNC /*handle*/, DWORD channel, DWORD /*data*/, void *user )
@@ -0,0 +1,570 @@
+#include "DecoderBenchmark.h"
+
+#include "OutputDecoder.h"
+#include "SampleConversion.h"
+#include "Utility.h"
+
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <limits>
+#include <random>
+#include <thread>
+#include <type_traits>
+#include <typeinfo>
+
+// Read block sizes, in samples.
+constexpr std::array kReadBlockSizes = { 256l, 4096l, 65536l };
+
+// The maximum amount of audio to decode from each file when measuring read throughput, in seconds.
+constexpr float kMaxReadSeconds = 60.0f;
+
+// Read block size when measuring whole file decode throughput, in samples.
+constexpr long kDecodeBlockSize = 4096;
+
+// The number of random seeks to measure for each file.
+constexpr int kSeekCount = 10;
+
+// Number of frames in each sample conversion block (the same as a typical AAC frame).
+constexpr size_t kConversionFrames = 1024;
+
+// Number of blocks to convert when measuring sample conversion throughput.
+constexpr size_t kConversionBlocks = 20000;
+
+// Channel counts for which to measure sample conversion.
+constexpr std::array kConversionChannels = { size_t( 2 ), size_t( 6 ) };
+
+// Returns 'count' random samples of type T, covering the full range of the type (or the range -1.0 to +1.0 for floating point types).
+template <typename T>
+static std::vector<T> GenerateConversionInput( const size_t count )
+{
+	std::vector<T> samples( count );
+	std::mt19937_64 engine( 1 );
+	if constexpr ( std::is_floating_point_v<T> ) {
+		std::uniform_real_distribution<T> dist( -1, 1 );
+		for ( auto& sample : samples ) {
+			sample = dist( engine );
+		}
+	} else {
+		std::uniform_int_distribution<int64_t> dist( std::numeric_limits<T>::min(), std::numeric_limits<T>::max() );
+		for ( auto& sample : samples ) {
+			sample = static_cast<T>( dist( engine ) );
+		}
+	}
+	return samples;
+}
+
+// Stall scenarios for the pre-buffering stress test.
+constexpr std::array kStressScenarios = { "steady", "stalls", "starved" };
+
+// Fake decoder sample rate for the pre-buffering stress test.
+constexpr long kStressSampleRate = 44100;
+
+// Fake decoder channels for the pre-buffering stress test.
+constexpr long kStressChannels = 2;
+
+// Fake decoder stream length for the pre-buffering stress test, in frames.
+constexpr long long kStressFrames = 10ll * kStressSampleRate;
+
+// The interval at which the real-time consumer reads from the output decoder (in the same way as an output device callback).
+constexpr std::chrono::milliseconds kStressReadInterval( 10 );
+
+// The probability of each fake decoder read stalling, in the 'stalls' scenario.
+constexpr double kStressStallProbability = 0.1;
+
+// The length of each stall, in the 'stalls' scenario (which pre-buffering should absorb).
+constexpr std::chrono::milliseconds kStressShortStall( 200 );
+
+// The length of the single stall, in the 'starved' scenario (which is longer than the pre-buffer).
+constexpr std::chrono::milliseconds kStressLongStall( 4000 );
+
+// The position of the single stall, in the 'starved' scenario, in frames.
+constexpr long long kStressLongStallFrame = 2ll * kStressSampleRate;
+
+// Memory budget for decode-ahead in the pre-buffering stress test, in bytes.
+constexpr size_t kStressDecodeAheadBudget = 64 * 1024 * 1024;
+
+// Tolerance when checking the fake decoder samples (to allow for decode-ahead storing samples as 24-bit integers).
+constexpr float kStressSampleTolerance = 1e-6f;
+
+// Returns the sample for a 'frame' & 'channel' of the fake decoder stream (a ramp, so that reading out of order can be detected).
+static float GetStressSample( const long long frame, const long channel )
+{
+	return static_cast<float>( ( frame * kStressChannels + channel ) % 65536 ) / 65536.0f - 0.5f;
+}
+
+// Fake decoder for the pre-buffering stress test, which stalls in the same way as a decoder reading from a busy disk or network share.
+class StressDecoder : public Decoder
+{
+public:
+	// 'scenario' - stall scenario ('steady' never stalls, 'stalls' has frequent short stalls, 'starved' has a single stall longer than the pre-buffer).
+	StressDecoder( const std::string& scenario ) :
+		Decoder(),
+		m_Scenario( scenario ),
+		m_Engine( 1 ),
+		m_Position( 0 ),
+		m_Starved( false )
+	{
+		SetDuration( static_cast<float>( static_cast<double>( kStressFrames ) / kStressSampleRate ) );
+		SetSampleRate( kStressSampleRate );
+		SetChannels( kStressChannels );
+		SetBPS( 16 );
+	}
+
+	// Reads sample data.
+	long Read( float* buffer, const long sampleCount ) override
+	{
+		if ( "stalls" == m_Scenario ) {
+			if ( std::uniform_real_distribution<double>( 0, 1 )( m_Engine ) < kStressStallProbability ) {
+				std::this_thread::sleep_for( kStressShortStall );
+			}
+		} else if ( ( "starved" == m_Scenario ) && !m_Starved && ( m_Position >= kStressLongStallFrame ) ) {
+			m_Starved = true;
+			std::this_thread::sleep_for( kStressLongStall );
+		}
+
+		const long samplesToRead = static_cast<long>( std::min<long long>( sampleCount, kStressFrames - m_Position ) );
+		for ( long sample = 0; sample < samplesToRead; sample++, m_Position++ ) {
+			for ( long channel = 0; channel < kStressChannels; channel++ ) {
+				*buffer++ = GetStressSample( m_Position, channel );
+			}
+		}
+		return samplesToRead;
+	}
+
+	// Seeks to a 'position' in the stream, in seconds.
+	float Seek( const float position ) override
+	{
+		m_Position = std::clamp( std::llround( static_cast<double>( position ) * kStressSampleRate ), 0ll, kStressFrames );
+		return static_cast<float>( static_cast<double>( m_Position ) / kStressSampleRate );
+	}
+
+private:
+	// Stall scenario.
+	const std::string m_Scenario;
+
+	// Random engine for stalls.
+	std::mt19937 m_Engine;
+
+	// Current position, in frames.
+	long long m_Position;
+
+	// Indicates whether the single stall in the 'starved' scenario has happened.
+	bool m_Starved;
+};
+
+DecoderBenchmark::DecoderBenchmark( const Handlers& handlers ) :
+	m_Handlers( handlers )
+{
+}
+
+DecoderBenchmark::~DecoderBenchmark()
+{
+}
+
+bool DecoderBenchmark::Run( const std::wstring& folder, const std::wstring& outputFilename ) const
+{
+	MeasurementsMap measurements;
+	const std::vector<std::wstring> files = GetFiles( folder );
+	for ( const auto& filename : files ) {
+		Measure( filename, measurements );
+	}
+
+	const ConversionResults conversionResults = MeasureSampleConversion();
+	bool passed = std::all_of( conversionResults.begin(), conversionResults.end(), [] ( const ConversionResult& result ) { return 0 == result.Mismatches; } );
+
+	StressResults stressResults;
+	for ( const bool decodeAhead : { false, true } ) {
+		for ( const auto scenario : kStressScenarios ) {
+			stressResults.push_back( StressPreBuffer( decodeAhead, scenario ) );
+			passed = passed && stressResults.back().Passed;
+		}
+	}
+
+	const bool success = IsBenchmarkCSV( outputFilename ) ? WriteCSV( measurements, conversionResults, stressResults, outputFilename ) : WriteJSON( measurements, conversionResults, stressResults, outputFilename );
+	return passed && success;
+}
+
+std::vector<std::wstring> DecoderBenchmark::GetFiles( const std::wstring& folder ) const
+{
+	std::vector<std::wstring> files;
+	const std::set<std::wstring> extensions = m_Handlers.GetAllSupportedFileExtensions();
+	std::error_code ec;
+	for ( auto entry = std::filesystem::recursive_directory_iterator( folder, std::filesystem::directory_options::skip_permission_denied, ec ); !ec && ( std::filesystem::recursive_directory_iterator() != entry ); entry.increment( ec ) ) {
+		if ( entry->is_regular_file( ec ) ) {
+			const std::wstring filename = entry->path().wstring();
+			if ( extensions.end() != extensions.find( GetFileExtension( filename ) ) ) {
+				files.push_back( filename );
+			}
+		}
+	}
+	std::sort( files.begin(), files.end() );
+	return files;
+}
+
+void DecoderBenchmark::Measure( const std::wstring& filename, MeasurementsMap& measurements ) const
+{
+	LONGLONG startTick = GetBenchmarkTick();
+	Decoder::Ptr decoder = m_Handlers.OpenDecoder( filename );
+	LONGLONG endTick = GetBenchmarkTick();
+	const long channels = decoder ? decoder->GetChannels() : 0;
+	const long sampleRate = decoder ? decoder->GetSampleRate() : 0;
+	if ( ( channels > 0 ) && ( sampleRate > 0 ) ) {
+		std::string decoderType = typeid( *decoder ).name();
+		if ( const size_t pos = decoderType.rfind( ' ' ); std::string::npos != pos ) {
+			decoderType = decoderType.substr( 1 + pos );
+		}
+		Measurements& results = measurements[ decoderType ];
+		++results.FileCount;
+		results.OpenLatency.push_back( GetBenchmarkMilliseconds( startTick, endTick ) );
+
+		std::vector<float> buffer( kReadBlockSizes.back() * channels );
+		if ( decoder->Read( buffer.data(), 1 ) > 0 ) {
+			results.FirstSampleLatency.push_back( GetBenchmarkMilliseconds( startTick, GetBenchmarkTick() ) );
+		}
+
+		// Sustained read throughput, using a fresh decoder for each block size.
+		for ( const long blockSize : kReadBlockSizes ) {
+			decoder = m_Handlers.OpenDecoder( filename );
+			if ( decoder ) {
+				const long maxSamples = static_cast<long>( kMaxReadSeconds * sampleRate );
+				long totalSamples = 0;
+				startTick = GetBenchmarkTick();
+				long samplesRead = decoder->Read( buffer.data(), blockSize );
+				while ( samplesRead > 0 ) {
+					totalSamples += samplesRead;
+					samplesRead = ( totalSamples < maxSamples ) ? decoder->Read( buffer.data(), blockSize ) : 0;
+				}
+				endTick = GetBenchmarkTick();
+				const double seconds = GetBenchmarkSeconds( startTick, endTick );
+				if ( ( totalSamples > 0 ) && ( seconds > 0 ) ) {
+					results.ReadThroughput[ blockSize ].push_back( static_cast<double>( totalSamples ) / sampleRate / seconds );
+				}
+			}
+		}
+
+		// Whole file decode throughput, in terms of both the file size & the decoded duration.
+		if ( const Decoder::Ptr fileDecoder = m_Handlers.OpenDecoder( filename ); fileDecoder ) {
+			std::error_code ec;
+			const uintmax_t fileSize = std::filesystem::file_size( filename, ec );
+			long long totalSamples = 0;
+			startTick = GetBenchmarkTick();
+			long samplesRead = fileDecoder->Read( buffer.data(), kDecodeBlockSize );
+			while ( samplesRead > 0 ) {
+				totalSamples += samplesRead;
+				samplesRead = fileDecoder->Read( buffer.data(), kDecodeBlockSize );
+			}
+			endTick = GetBenchmarkTick();
+			const double seconds = GetBenchmarkSeconds( startTick, endTick );
+			if ( ( totalSamples > 0 ) && ( seconds > 0 ) ) {
+				if ( !ec && ( fileSize > 0 ) ) {
+					results.DecodeThroughput.push_back( static_cast<double>( fileSize ) / ( 1024 * 1024 ) / seconds );
+				}
+				results.DecodeRealtime.push_back( static_cast<double>( totalSamples ) / sampleRate / seconds );
+			}
+		}
+
+		// Seek latency (including the first read after seeking), at random positions.
+		// The whole file has just been decoded, so the file is equally cached for both plain & indexed seeks, and each set of seeks uses a freshly opened decoder.
+		// The order of the plain & indexed seeks is also alternated for each file, so that neither is consistently measured first.
+		if ( const float duration = decoder ? decoder->GetDuration() : 0; duration > 0 ) {
+			std::mt19937 engine( static_cast<unsigned int>( std::hash<std::wstring>()( filename ) ) );
+			std::uniform_real_distribution<float> dist( 0, duration );
+			std::vector<float> positions( kSeekCount );
+			for ( auto& position : positions ) {
+				position = dist( engine );
+			}
+
+			const auto measureSeeks = [ this, &filename, &buffer, &positions ] ( const SeekIndex::Ptr seekIndex, Values& latencies )
+			{
+				if ( const Decoder::Ptr seekDecoder = m_Handlers.OpenDecoder( filename ); seekDecoder ) {
+					if ( seekIndex ) {
+						seekDecoder->SetSeekIndex( seekIndex );
+					}
+					for ( const float position : positions ) {
+						const LONGLONG seekStartTick = GetBenchmarkTick();
+						seekDecoder->Seek( position );
+						seekDecoder->Read( buffer.data(), 1 );
+						latencies.push_back( GetBenchmarkMilliseconds( seekStartTick, GetBenchmarkTick() ) );
+					}
+				}
+			};
+
+			// Generate a seek index, for decoders which support one.
+			SeekIndex::Ptr seekIndex;
+			if ( decoder->SupportsSeekIndex() ) {
+				startTick = GetBenchmarkTick();
+				seekIndex = decoder->GenerateSeekIndex( nullptr /*canContinue*/ );
+				endTick = GetBenchmarkTick();
+				if ( seekIndex ) {
+					results.SeekIndexGeneration.push_back( GetBenchmarkMilliseconds( startTick, endTick ) );
+				}
+			}
+
+			const bool indexedFirst = ( 0 == ( results.FileCount % 2 ) );
+			if ( seekIndex && indexedFirst ) {
+				measureSeeks( seekIndex, results.IndexedSeekLatency );
+			}
+			measureSeeks( nullptr, results.SeekLatency );
+			if ( seekIndex && !indexedFirst ) {
+				measureSeeks( seekIndex, results.IndexedSeekLatency );
+			}
+		}
+	}
+}
+
+DecoderBenchmark::ConversionResults DecoderBenchmark::MeasureSampleConversion()
+{
+	ConversionResults results;
+	for ( const size_t channels : kConversionChannels ) {
+		const size_t count = channels * kConversionFrames;
+
+		// Interleaved sample formats.
+		results.push_back( MeasureConversion<uint8_t>( "u8", channels, false, Unsigned8ToFloat, [ count ] ( const uint8_t* data, const uint8_t* const*, float* output )
+			{
+				ConvertUnsigned8ToFloat( data, output, count );
+			} ) );
+		results.push_back( MeasureConversion<int16_t>( "s16", channels, false, Signed16ToFloat, [ count ] ( const int16_t* data, const int16_t* const*, float* output )
+			{
+				ConvertSigned16ToFloat( data, output, count );
+			} ) );
+		results.push_back( MeasureConversion<int32_t>( "s32", channels, false, Signed32ToFloat, [ count ] ( const int32_t* data, const int32_t* const*, float* output )
+			{
+				ConvertSigned32ToFloat( data, output, count );
+			} ) );
+		results.push_back( MeasureConversion<int64_t>( "s64", channels, false, Signed64ToFloat, [ count ] ( const int64_t* data, const int64_t* const*, float* output )
+			{
+				ConvertSigned64ToFloat( data, output, count );
+			} ) );
+		results.push_back( MeasureConversion<float>( "flt", channels, false, [] ( const float value ) { return value; }, [ count ] ( const float* data, const float* const*, float* output )
+			{
+				std::copy( data, data + count, output );
+			} ) );
+		results.push_back( MeasureConversion<double>( "dbl", channels, false, [] ( const double value ) { return static_cast<float>( value ); }, [ count ] ( const double* data, const double* const*, float* output )
+			{
+				ConvertDoubleToFloat( data, output, count );
+			} ) );
+
+		// Planar sample formats.
+		results.push_back( MeasureConversion<uint8_t>( "u8p", channels, true, Unsigned8ToFloat, [ channels ] ( const uint8_t*, const uint8_t* const* planes, float* output )
+			{
+				InterleaveUnsigned8ToFloat( planes, channels, kConversionFrames, output );
+			} ) );
+		results.push_back( MeasureConversion<int16_t>( "s16p", channels, true, Signed16ToFloat, [ channels ] ( const int16_t*, const int16_t* const* planes, float* output )
+			{
+				InterleaveSigned16ToFloat( planes, channels, kConversionFrames, output );
+			} ) );
+		results.push_back( MeasureConversion<int32_t>( "s32p", channels, true, Signed32ToFloat, [ channels ] ( const int32_t*, const int32_t* const* planes, float* output )
+			{
+				InterleaveSigned32ToFloat( planes, channels, kConversionFrames, output );
+			} ) );
+		results.push_back( MeasureConversion<int64_t>( "s64p", channels, true, Signed64ToFloat, [ channels ] ( const int64_t*, const int64_t* const* planes, float* output )
+			{
+				InterleaveSigned64ToFloat( planes, channels, kConversionFrames, output );
+			} ) );
+		results.push_back( MeasureConversion<float>( "fltp", channels, true, [] ( const float value ) { return value; }, [ channels ] ( const float*, const float* const* planes, float* output )
+			{
+				InterleaveFloat( planes, channels, kConversionFrames, output );
+			} ) );
+		results.push_back( MeasureConversion<double>( "dblp", channels, true, [] ( const double value ) { return static_cast<float>( value ); }, [ channels ] ( const double*, const double* const* planes, float* output )
+			{
+				InterleaveDoubleToFloat( planes, channels, kConversionFrames, output );
+			} ) );
+	}
+	return results;
+}
+
+template <typename T, typename ConvertSample, typename Kernel>
+DecoderBenchmark::ConversionResult DecoderBenchmark::MeasureConversion( const std::string& format, const size_t channels, const bool planar, ConvertSample convertSample, Kernel kernel )
+{
+	ConversionResult result;
+	result.Format = format;
+	result.Channels = channels;
+
+	const size_t count = channels * kConversionFrames;
+	const std::vector<T> input = GenerateConversionInput<T>( count );
+	std::vector<const T*> planes( channels );
+	for ( size_t channel = 0; channel < channels; channel++ ) {
+		planes[ channel ] = input.data() + channel * kConversionFrames;
+	}
+
+	// The per-sample conversion loop, in the same way as previously used for FFmpeg decoding.
+	std::vector<float> loopOutput;
+	LONGLONG startTick = GetBenchmarkTick();
+	for ( size_t block = 0; block < kConversionBlocks; block++ ) {
+		loopOutput.clear();
+		if ( planar ) {
+			for ( size_t frame = 0; frame < kConversionFrames; frame++ ) {
+				for ( size_t channel = 0; channel < channels; channel++ ) {
+					loopOutput.push_back( convertSample( planes[ channel ][ frame ] ) );
+				}
+			}
+		} else {
+			for ( size_t pos = 0; pos < count; pos++ ) {
+				loopOutput.push_back( convertSample( input[ pos ] ) );
+			}
+		}
+	}
+	const double loopSeconds = GetBenchmarkSeconds( startTick, GetBenchmarkTick() );
+
+	// The conversion kernel, writing into a pre-sized buffer.
+	std::vector<float> kernelOutput;
+	startTick = GetBenchmarkTick();
+	for ( size_t block = 0; block < kConversionBlocks; block++ ) {
+		kernelOutput.clear();
+		kernelOutput.resize( count );
+		kernel( input.data(), planes.data(), kernelOutput.data() );
+	}
+	const double kernelSeconds = GetBenchmarkSeconds( startTick, GetBenchmarkTick() );
+
+	const double samples = static_cast<double>( count ) * kConversionBlocks;
+	result.LoopThroughput = ( loopSeconds > 0 ) ? ( samples / loopSeconds / 1e6 ) : 0;
+	result.KernelThroughput = ( kernelSeconds > 0 ) ? ( samples / kernelSeconds / 1e6 ) : 0;
+	for ( size_t pos = 0; pos < count; pos++ ) {
+		if ( loopOutput[ pos ] != kernelOutput[ pos ] ) {
+			++result.Mismatches;
+		}
+	}
+	return result;
+}
+
+DecoderBenchmark::StressResult DecoderBenchmark::StressPreBuffer( const bool decodeAhead, const std::string& scenario )
+{
+	StressResult result;
+	result.Mode = decodeAhead ? "decode_ahead" : "pre_buffer";
+	result.Scenario = scenario;
+
+	OutputDecoder decoder( std::make_shared<StressDecoder>( scenario ), 0 /*id*/ );
+	const LONGLONG startTick = GetBenchmarkTick();
+	if ( decodeAhead ) {
+		decoder.DecodeAhead( nullptr /*callback*/, std::make_shared<OutputDecoder::DecodeAheadBudget>( kStressDecodeAheadBudget ) );
+	} else {
+		decoder.PreBuffer( nullptr /*callback*/ );
+	}
+	while ( !decoder.IsPreBufferPrimed() ) {
+		std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+	}
+	result.PrimeTime = GetBenchmarkMilliseconds( startTick, GetBenchmarkTick() );
+
+	// Read in real time until the end of the stream, checking that every frame is read exactly once, in order, regardless of underruns.
+	const long blockFrames = static_cast<long>( kStressSampleRate * kStressReadInterval.count() / 1000 );
+	std::vector<float> buffer( static_cast<size_t>( blockFrames ) * kStressChannels );
+	std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now();
+	const std::chrono::steady_clock::time_point timeout = deadline + 3 * std::chrono::milliseconds( 1000 * kStressFrames / kStressSampleRate ) + kStressLongStall;
+	while ( !decoder.HasEnded() && ( std::chrono::steady_clock::now() < timeout ) ) {
+		result.FillLevel.push_back( decoder.GetPreBufferedSeconds() );
+		const LONGLONG readStartTick = GetBenchmarkTick();
+		const long framesRead = decoder.Read( buffer.data(), blockFrames );
+		result.ReadTime.push_back( GetBenchmarkMilliseconds( readStartTick, GetBenchmarkTick() ) );
+
+		const float* samples = buffer.data();
+		for ( long frame = 0; frame < framesRead; frame++, result.Frames++ ) {
+			bool matches = true;
+			for ( long channel = 0; channel < kStressChannels; channel++, samples++ ) {
+				matches = matches && ( std::fabs( *samples - GetStressSample( result.Frames, channel ) ) <= kStressSampleTolerance );
+			}
+			if ( !matches ) {
+				++result.Mismatches;
+			}
+		}
+
+		deadline += kStressReadInterval;
+		std::this_thread::sleep_until( deadline );
+	}
+
+	result.Underruns = decoder.GetUnderrunCount();
+	result.UnderrunFrames = decoder.GetUnderrunSamples();
+	result.Passed = decoder.HasEnded() && ( kStressFrames == result.Frames ) && ( 0 == result.Mismatches );
+	return result;
+}
+
+bool DecoderBenchmark::WriteJSON( const MeasurementsMap& measurements, const ConversionResults& conversionResults, const StressResults& stressResults, const std::wstring& outputFilename )
+{
+	nlohmann::json document;
+	for ( const auto& [ decoderType, results ] : measurements ) {
+		nlohmann::json decoder;
+		decoder[ "files" ] = results.FileCount;
+		decoder[ "open_ms" ] = BenchmarkPercentilesToJSON( results.OpenLatency );
+		decoder[ "first_sample_ms" ] = BenchmarkPercentilesToJSON( results.FirstSampleLatency );
+		decoder[ "seek_ms" ] = BenchmarkPercentilesToJSON( results.SeekLatency );
+		decoder[ "seek_index_ms" ] = BenchmarkPercentilesToJSON( results.SeekIndexGeneration );
+		decoder[ "indexed_seek_ms" ] = BenchmarkPercentilesToJSON( results.IndexedSeekLatency );
+		for ( const auto& [ blockSize, values ] : results.ReadThroughput ) {
+			decoder[ "read_x_realtime" ][ std::to_string( blockSize ) ] = BenchmarkPercentilesToJSON( values );
+		}
+		decoder[ "decode_mb_per_s" ] = BenchmarkPercentilesToJSON( results.DecodeThroughput );
+		decoder[ "decode_x_realtime" ] = BenchmarkPercentilesToJSON( results.DecodeRealtime );
+		document[ decoderType ] = decoder;
+	}
+	for ( const auto& result : conversionResults ) {
+		nlohmann::json entry;
+		entry[ "loop_msamples_per_s" ] = result.LoopThroughput;
+		entry[ "kernel_msamples_per_s" ] = result.KernelThroughput;
+		entry[ "speedup" ] = ( result.LoopThroughput > 0 ) ? ( result.KernelThroughput / result.LoopThroughput ) : 0;
+		entry[ "mismatches" ] = result.Mismatches;
+		document[ "sample_conversion" ][ result.Format ][ std::to_string( result.Channels ) ] = entry;
+	}
+	for ( const auto& result : stressResults ) {
+		nlohmann::json entry;
+		entry[ "passed" ] = result.Passed;
+		entry[ "prime_ms" ] = result.PrimeTime;
+		entry[ "frames" ] = result.Frames;
+		entry[ "underruns" ] = result.Underruns;
+		entry[ "underrun_frames" ] = result.UnderrunFrames;
+		entry[ "mismatches" ] = result.Mismatches;
+		entry[ "fill_seconds" ] = BenchmarkPercentilesToJSON( result.FillLevel );
+		entry[ "read_ms" ] = BenchmarkPercentilesToJSON( result.ReadTime );
+		document[ "pre_buffer_stress" ][ result.Mode ][ result.Scenario ] = entry;
+	}
+	return WriteBenchmarkJSON( document, outputFilename );
+}
+
+bool DecoderBenchmark::WriteCSV( const MeasurementsMap& measurements, const ConversionResults& conversionResults, const StressResults& stressResults, const std::wstring& outputFilename )
+{
+	return WriteBenchmarkCSV( outputFilename, "decoder,metric,block_size," + GetBenchmarkPercentileHeadings(), [ &measurements, &conversionResults, &stressResults ] ( std::ostream& stream )
+	{
+		const auto writeRow = [ &stream ] ( const std::string& decoderType, const std::string& metric, const long blockSize, const Values& values )
+		{
+			stream << decoderType << "," << metric << ",";
+			if ( blockSize > 0 ) {
+				stream << blockSize;
+			}
+			stream << ",";
+			WriteBenchmarkPercentiles( stream, values );
+			stream << std::endl;
+		};
+
+		for ( const auto& [ decoderType, results ] : measurements ) {
+			writeRow( decoderType, "open_ms", 0, results.OpenLatency );
+			writeRow( decoderType, "first_sample_ms", 0, results.FirstSampleLatency );
+			writeRow( decoderType, "seek_ms", 0, results.SeekLatency );
+			writeRow( decoderType, "seek_index_ms", 0, results.SeekIndexGeneration );
+			writeRow( decoderType, "indexed_seek_ms", 0, results.IndexedSeekLatency );
+			for ( const auto& [ blockSize, values ] : results.ReadThroughput ) {
+				writeRow( decoderType, "read_x_realtime", blockSize, values );
+			}
+			writeRow( decoderType, "decode_mb_per_s", kDecodeBlockSize, results.DecodeThroughput );
+			writeRow( decoderType, "decode_x_realtime", kDecodeBlockSize, results.DecodeRealtime );
+		}
+
+		// Sample conversion & stress test results are written with a single value for each of the metrics.
+		for ( const auto& result : conversionResults ) {
+			const std::string name = "sample_conversion:" + result.Format + ":" + std::to_string( result.Channels );
+			writeRow( name, "loop_msamples_per_s", 0, { result.LoopThroughput } );
+			writeRow( name, "kernel_msamples_per_s", 0, { result.KernelThroughput } );
+			writeRow( name, "mismatches", 0, { static_cast<double>( result.Mismatches ) } );
+		}
+		for ( const auto& result : stressResults ) {
+			const std::string name = "pre_buffer_stress:" + result.Mode + ":" + result.Scenario;
+			writeRow( name, "passed", 0, { result.Passed ? 1.0 : 0.0 } );
+			writeRow( name, "prime_ms", 0, { result.PrimeTime } );
+			writeRow( name, "frames", 0, { static_cast<double>( result.Frames ) } );
+			writeRow( name, "underruns", 0, { static_cast<double>( result.Underruns ) } );
+			writeRow( name, "underrun_frames", 0, { static_cast<double>( result.UnderrunFrames ) } );
+			writeRow( name, "mismatches", 0, { static_cast<double>( result.Mismatches ) } );
+			writeRow( name, "fill_seconds", 0, result.FillLevel );
+			writeRow( name, "read_ms", 0, result.ReadTime );
+		}
+	} );
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "stdafx.h"
+
+#include "BenchmarkUtility.h"
+#include "Handlers.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+// Measures decoder performance over a corpus of media files, so that decoder regressions can be caught.
+class DecoderBenchmark
+{
+public:
+	// 'handlers' - media handlers.
+	DecoderBenchmark( const Handlers& handlers );
+
+	virtual ~DecoderBenchmark();
+
+	// Runs the benchmark over all supported files in the 'folder' (including subfolders), followed by the sample conversion microbenchmark & the output decoder pre-buffering stress test.
+	// 'outputFilename' - results file, written as CSV if the file has a .csv extension, otherwise as JSON.
+	// Returns whether the results were written, and the sample conversion & stress test checks passed.
+	bool Run( const std::wstring& folder, const std::wstring& outputFilename ) const;
+
+private:
+	// A list of measurements.
+	using Values = BenchmarkValues;
+
+	// Measurements for a decoder type.
+	struct Measurements {
+		long FileCount = 0;											// Number of files measured.
+		Values OpenLatency;											// Decoder open latency, in milliseconds.
+		Values FirstSampleLatency;							// Time from opening the decoder to reading the first sample, in milliseconds.
+		std::map<long, Values> ReadThroughput;	// Maps a read block size, in samples, to the sustained read throughput (as a multiple of real time).
+		Values DecodeThroughput;								// Whole file decode to floating point throughput, in megabytes of the file per second.
+		Values DecodeRealtime;									// Whole file decode to floating point throughput, as a multiple of real time.
+		Values SeekLatency;											// Seek latency, in milliseconds.
+		Values SeekIndexGeneration;							// Seek index generation time, in milliseconds.
+		Values IndexedSeekLatency;							// Seek latency when using a seek index, in milliseconds.
+	};
+
+	// Maps a decoder type to its measurements.
+	using MeasurementsMap = std::map<std::string, Measurements>;
+
+	// Result for an output decoder pre-buffering stress test case.
+	struct StressResult {
+		std::string Mode;							// Buffering mode.
+		std::string Scenario;					// Decoder stall scenario.
+		double PrimeTime = 0;					// Time taken for the pre-buffer to be primed, in milliseconds.
+		long long Frames = 0;					// Number of frames read by the consumer.
+		long long Underruns = 0;			// Number of reads which could not be fully satisfied from the pre-buffer.
+		long long UnderrunFrames = 0;	// Number of frames which could not be read due to underruns.
+		long long Mismatches = 0;			// Number of frames which were not read in stream order.
+		Values FillLevel;							// Amount of pre-buffered data before each read, in seconds.
+		Values ReadTime;							// Read time, in milliseconds.
+		bool Passed = false;					// Whether the whole stream was read in order.
+	};
+
+	// A list of stress test results.
+	using StressResults = std::vector<StressResult>;
+
+	// Result for a sample conversion format.
+	struct ConversionResult {
+		std::string Format;						// Sample format.
+		size_t Channels = 0;					// Number of channels.
+		double LoopThroughput = 0;		// Throughput of the per-sample conversion loop, in millions of samples per second.
+		double KernelThroughput = 0;	// Throughput of the sample conversion kernel, in millions of samples per second.
+		long long Mismatches = 0;			// Number of samples for which the kernel output differs from the per-sample loop.
+	};
+
+	// A list of sample conversion results.
+	using ConversionResults = std::vector<ConversionResult>;
+
+	// Returns all the supported files in the 'folder' (including subfolders).
+	std::vector<std::wstring> GetFiles( const std::wstring& folder ) const;
+
+	// Measures the decoder performance for the 'filename', adding the results to the 'measurements'.
+	void Measure( const std::wstring& filename, MeasurementsMap& measurements ) const;
+
+	// Measures the sample conversion kernels against the per-sample conversion loop which was previously used for FFmpeg decoding, for each sample format.
+	static ConversionResults MeasureSampleConversion();
+
+	// Measures the sample conversion 'kernel' against the per-sample conversion loop, for a sample 'format' of type T.
+	// 'channels' - number of channels.
+	// 'planar' - whether the sample data is planar (one plane per channel), rather than interleaved.
+	// 'convertSample' - converts a single sample, as in the per-sample conversion loop.
+	// 'kernel' - converts a block of sample data, and is passed the interleaved data, the planes & the output buffer.
+	template <typename T, typename ConvertSample, typename Kernel>
+	static ConversionResult MeasureConversion( const std::string& format, const size_t channels, const bool planar, ConvertSample convertSample, Kernel kernel );
+
+	// Runs a fake decoder, which stalls according to the 'scenario', through output decoder pre-buffering (or decode-ahead) against a real-time consumer.
+	// 'decodeAhead' - whether to use decode-ahead, rather than pre-buffering.
+	static StressResult StressPreBuffer( const bool decodeAhead, const std::string& scenario );
+
+	// Writes the 'measurements', 'conversionResults' & 'stressResults' as JSON to the 'outputFilename', returning whether the file was written.
+	static bool WriteJSON( const MeasurementsMap& measurements, const ConversionResults& conversionResults, const StressResults& stressResults, const std::wstring& outputFilename );
+
+	// Writes the 'measurements', 'conversionResults' & 'stressResults' as CSV to the 'outputFilename', returning whether the file was written.
+	static bool WriteCSV( const MeasurementsMap& measurements, const ConversionResults& conversionResults, const StressResults& stressResults, const std::wstring& outputFilename );
+
+	// Media handlers.
+	const Handlers& m_Handlers;
+};
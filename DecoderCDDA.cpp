@@ -1,7 +1,11 @@
 #include "DecoderCDDA.h"
 
+#include "SampleConversion.h"
 #include "Utility.h"
 
+// The maximum number of sectors to read from the disc at a time (a little over a quarter of a second of audio).
+constexpr long kSectorsPerRead = 20;
+
 DecoderCDDA::DecoderCDDA( const CDDAMedia& cddaMedia, const long track ) :
 	Decoder(),
 	m_CDDAMedia( cddaMedia ),
@@ -30,14 +34,17 @@ DecoderCDDA::~DecoderCDDA()
 long DecoderCDDA::Read( float* buffer, const long sampleCount )
 {
 	long samplesRead = 0;
-	long outputBufPos = 0;
 	while ( samplesRead < sampleCount ) {
 		if ( m_CurrentBufPos < m_Buffer.size() ) {
-			buffer[ outputBufPos++ ] = Signed16ToFloat( m_Buffer[ m_CurrentBufPos++ ] );
-			buffer[ outputBufPos++ ] = Signed16ToFloat( m_Buffer[ m_CurrentBufPos++ ] );
-			++samplesRead;
+			const size_t count = std::min<size_t>( m_Buffer.size() - m_CurrentBufPos, 2 * static_cast<size_t>( sampleCount - samplesRead ) );
+			ConvertSigned16ToFloat( m_Buffer.data() + m_CurrentBufPos, buffer + 2 * samplesRead, count );
+			m_CurrentBufPos += count;
+			samplesRead += static_cast<long>( count / 2 );
 		} else {
-			if ( ( m_CurrentSector < m_SectorEnd ) && ( m_CDDAMedia.Read( m_Handle, m_CurrentSector++, true /*useCache*/, m_Buffer ) ) ) {
+			const long sectorCount = std::min<long>( kSectorsPerRead, m_SectorEnd - m_CurrentSector );
+			const long sectorsRead = ( sectorCount > 0 ) ? m_CDDAMedia.Read( m_Handle, m_CurrentSector, sectorCount, true /*useCache*/, m_Buffer ) : 0;
+			if ( sectorsRead > 0 ) {
+				m_CurrentSector += sectorsRead;
 				m_CurrentBufPos = 0;
 			} else {
 				break;
@@ -1,13 +1,23 @@
 #include "DecoderFFmpeg.h"
 
+#include "SampleConversion.h"
 #include "Utility.h"
 
+#include <sstream>
+
 extern "C"
 {
 #include <libavcodec/avcodec.h>
 #include <libavformat/avformat.h>
 }
 
+// Minimum interval between seek index sync points, in seconds.
+constexpr double kSeekIndexInterval = 1.0;
+
+// The amount of audio to decode (and discard) before the requested position when seeking via the seek index, in seconds.
+// This allows for decoders, such as MP3, which need data from previous frames to decode the first frame correctly.
+constexpr double kSeekIndexPreroll = 0.1;
+
 DecoderFFmpeg::DecoderFFmpeg( const std::wstring& filename ) :
 	Decoder()
 {
@@ -47,6 +57,9 @@ DecoderFFmpeg::DecoderFFmpeg( const std::wstring& filename ) :
 										m_Packet = av_packet_alloc();
 										m_Frame = av_frame_alloc();
 									}
+									if ( long long frameCount = 0; ReadGaplessInfo( frameCount ) ) {
+										m_GaplessFrameCount = frameCount;
+									}
 								}
 							}
 						}
@@ -85,105 +98,73 @@ DecoderFFmpeg::~DecoderFFmpeg()
 
 void DecoderFFmpeg::ConvertSampleData( const AVFrame* frame, std::vector<float>& buffer )
 {
-	if ( nullptr != frame ) {
+	if ( ( nullptr != frame ) && ( frame->channels > 0 ) && ( frame->nb_samples > 0 ) ) {
+		const size_t channels = static_cast<size_t>( frame->channels );
+		const size_t frames = static_cast<size_t>( frame->nb_samples );
+		const size_t count = channels * frames;
+		const size_t offset = buffer.size();
+		buffer.resize( offset + count );
+		float* output = buffer.data() + offset;
+
+		// Planar sample formats have one data pointer per channel.
+		const uint8_t* const* planes = frame->extended_data;
+
 		switch ( frame->format ) {
 			// Non-planar sample formats
 			case AV_SAMPLE_FMT_U8 : {
-				uint8_t* data = frame->data[ 0 ];
-				for ( int pos = 0; pos < frame->channels * frame->nb_samples; pos++ ) {
-					buffer.push_back( Unsigned8ToFloat( data[ pos ] ) );
-				}
+				ConvertUnsigned8ToFloat( frame->data[ 0 ], output, count );
 				break;
 			}
 			case AV_SAMPLE_FMT_S16 : {
-				int16_t* data = reinterpret_cast<int16_t*>( frame->data[ 0 ] );
-				for ( int pos = 0; pos < frame->channels * frame->nb_samples; pos++ ) {
-					buffer.push_back( Signed16ToFloat( data[ pos ] ) );
-				}
+				ConvertSigned16ToFloat( reinterpret_cast<const int16_t*>( frame->data[ 0 ] ), output, count );
 				break;
 			}
 			case AV_SAMPLE_FMT_S32 : {
-				int32_t* data = reinterpret_cast<int32_t*>( frame->data[ 0 ] );
-				for ( int pos = 0; pos < frame->channels * frame->nb_samples; pos++ ) {
-					buffer.push_back( Signed32ToFloat( data[ pos ] ) );
-				}
+				ConvertSigned32ToFloat( reinterpret_cast<const int32_t*>( frame->data[ 0 ] ), output, count );
 				break;
 			}
 			case AV_SAMPLE_FMT_S64 : {
-				int64_t* data = reinterpret_cast<int64_t*>( frame->data[ 0 ] );
-				for ( int pos = 0; pos < frame->channels * frame->nb_samples; pos++ ) {
-					buffer.push_back( Signed64ToFloat( data[ pos ] ) );
-				}
+				ConvertSigned64ToFloat( reinterpret_cast<const int64_t*>( frame->data[ 0 ] ), output, count );
 				break;
 			}
 			case AV_SAMPLE_FMT_FLT : {
-				float* data = reinterpret_cast<float*>( frame->data[ 0 ] );
-				for ( int pos = 0; pos < frame->channels * frame->nb_samples; pos++ ) {
-					buffer.push_back( data[ pos ] );
-				}
+				const float* data = reinterpret_cast<const float*>( frame->data[ 0 ] );
+				std::copy( data, data + count, output );
 				break;
 			}
 			case AV_SAMPLE_FMT_DBL : {
-				double* data = reinterpret_cast<double*>( frame->data[ 0 ] );
-				for ( int pos = 0; pos < frame->channels * frame->nb_samples; pos++ ) {
-					buffer.push_back( static_cast<float>( data[ pos ] ) );
-				}
+				ConvertDoubleToFloat( reinterpret_cast<const double*>( frame->data[ 0 ] ), output, count );
 				break;
 			}
 
 			// Planar sample formats
 			case AV_SAMPLE_FMT_U8P : {
-				for ( int samplePos = 0; samplePos < frame->nb_samples; samplePos++ ) {
-					for ( int channel = 0; channel < frame->channels; channel++ ) {
-						uint8_t* data = frame->data[ channel ];
-						buffer.push_back( Unsigned8ToFloat( data[ samplePos ] ) );
-					}					
-				}
+				InterleaveUnsigned8ToFloat( planes, channels, frames, output );
 				break;
 			}
 			case AV_SAMPLE_FMT_S16P : {
-				for ( int samplePos = 0; samplePos < frame->nb_samples; samplePos++ ) {
-					for ( int channel = 0; channel < frame->channels; channel++ ) {
-						int16_t* data = reinterpret_cast<int16_t*>( frame->data[ channel ] );
-						buffer.push_back( Signed16ToFloat( data[ samplePos ] ) );
-					}					
-				}
+				InterleaveSigned16ToFloat( reinterpret_cast<const int16_t* const*>( planes ), channels, frames, output );
 				break;
 			}
 			case AV_SAMPLE_FMT_S32P : {
-				for ( int samplePos = 0; samplePos < frame->nb_samples; samplePos++ ) {
-					for ( int channel = 0; channel < frame->channels; channel++ ) {
-						int32_t* data = reinterpret_cast<int32_t*>( frame->data[ channel ] );
-						buffer.push_back( Signed32ToFloat( data[ samplePos ] ) );
-					}					
-				}
+				InterleaveSigned32ToFloat( reinterpret_cast<const int32_t* const*>( planes ), channels, frames, output );
 				break;
 			}
 			case AV_SAMPLE_FMT_S64P : {
-				for ( int samplePos = 0; samplePos < frame->nb_samples; samplePos++ ) {
-					for ( int channel = 0; channel < frame->channels; channel++ ) {
-						int64_t* data = reinterpret_cast<int64_t*>( frame->data[ channel ] );
-						buffer.push_back( Signed64ToFloat( data[ samplePos ] ) );
-					}					
-				}
+				InterleaveSigned64ToFloat( reinterpret_cast<const int64_t* const*>( planes ), channels, frames, output );
 				break;
 			}
 			case AV_SAMPLE_FMT_FLTP : {
-				for ( int samplePos = 0; samplePos < frame->nb_samples; samplePos++ ) {
-					for ( int channel = 0; channel < frame->channels; channel++ ) {
-						float* data = reinterpret_cast<float*>( frame->data[ channel ] );
-						buffer.push_back( data[ samplePos ] );
-					}					
-				}
+				InterleaveFloat( reinterpret_cast<const float* const*>( planes ), channels, frames, output );
 				break;
 			}
 			case AV_SAMPLE_FMT_DBLP : {
-				for ( int samplePos = 0; samplePos < frame->nb_samples; samplePos++ ) {
-					for ( int channel = 0; channel < frame->channels; channel++ ) {
-						double* data = reinterpret_cast<double*>( frame->data[ channel ] );
-						buffer.push_back( static_cast<float>( data[ samplePos ] ) );
-					}					
-				}
+				InterleaveDoubleToFloat( reinterpret_cast<const double* const*>( planes ), channels, frames, output );
+				break;
+			}
+			default : {
+				// Unsupported sample format.
+				buffer.resize( offset );
 				break;
 			}
 		}
@@ -221,7 +202,11 @@ long DecoderFFmpeg::Read( float* output, const long sampleCount )
 {
 	long samplesRead = 0;
 	while ( samplesRead < sampleCount ) {
-		if ( m_BufferPosition < m_Buffer.size() ) {
+		if ( ( m_SkipSamples > 0 ) && ( m_BufferPosition < m_Buffer.size() ) ) {
+			const size_t skipSamples = std::min<size_t>( m_SkipSamples, m_Buffer.size() - m_BufferPosition );
+			m_BufferPosition += skipSamples;
+			m_SkipSamples -= skipSamples;
+		} else if ( m_BufferPosition < m_Buffer.size() ) {
 			const long bufferSamples = GetChannels() * std::min<long>( static_cast<long>( m_Buffer.size() - m_BufferPosition ) / GetChannels(), sampleCount - samplesRead );
 			std::copy( m_Buffer.begin() + m_BufferPosition, m_Buffer.begin() + m_BufferPosition + bufferSamples, output );
 			m_BufferPosition += bufferSamples;
@@ -238,6 +223,87 @@ float DecoderFFmpeg::Seek( const float position )
 {
 	m_Buffer.clear();
 	m_BufferPosition = 0;
-	const int64_t ts( position * AV_TIME_BASE );
-	return ( avformat_seek_file( m_FormatContext, -1, INT64_MIN, ts, ts, 0 ) < 0 ) ? 0 : position;
+	m_SkipSamples = 0;
+	float seekPosition = 0;
+	const auto syncPoint = m_SeekIndex ? m_SeekIndex->Find( std::max<double>( 0.0, position - kSeekIndexPreroll ) ) : std::nullopt;
+	if ( syncPoint.has_value() && ( av_seek_frame( m_FormatContext, m_StreamIndex, syncPoint->Offset, AVSEEK_FLAG_BYTE ) >= 0 ) ) {
+		// Jump straight to the sync point, then discard samples up to the requested position.
+		avcodec_flush_buffers( m_DecoderContext );
+		m_SkipSamples = static_cast<size_t>( ( position - syncPoint->Seconds ) * GetSampleRate() ) * static_cast<size_t>( GetChannels() );
+		seekPosition = position;
+	} else {
+		const int64_t ts( position * AV_TIME_BASE );
+		seekPosition = ( avformat_seek_file( m_FormatContext, -1, INT64_MIN, ts, ts, 0 ) < 0 ) ? 0 : position;
+	}
+	return seekPosition;
+}
+
+bool DecoderFFmpeg::SupportsSeekIndex() const
+{
+	return true;
+}
+
+SeekIndex::Ptr DecoderFFmpeg::GenerateSeekIndex( CanContinue canContinue )
+{
+	SeekIndex::Ptr seekIndex;
+	if ( const AVStream* stream = m_FormatContext->streams[ m_StreamIndex ]; nullptr != stream ) {
+		const double timeBase = av_q2d( stream->time_base );
+		const int64_t startTime = ( AV_NOPTS_VALUE != stream->start_time ) ? stream->start_time : 0;
+		SeekIndex::Entries entries;
+		bool cancelled = false;
+		if ( AVPacket* packet = av_packet_alloc(); nullptr != packet ) {
+			// Only the demuxer is needed to locate the sync points, so there is no need to decode anything.
+			while ( !cancelled && ( av_read_frame( m_FormatContext, packet ) >= 0 ) ) {
+				if ( ( m_StreamIndex == packet->stream_index ) && ( packet->pos >= 0 ) && ( AV_NOPTS_VALUE != packet->pts ) && ( AV_PKT_FLAG_KEY & packet->flags ) ) {
+					const double seconds = static_cast<double>( packet->pts - startTime ) * timeBase;
+					if ( entries.empty() || ( seconds >= ( entries.back().Seconds + kSeekIndexInterval ) ) ) {
+						entries.push_back( { seconds, packet->pos } );
+					}
+				}
+				av_packet_unref( packet );
+				cancelled = canContinue && !canContinue();
+			}
+			av_packet_free( &packet );
+		}
+		if ( !cancelled && !entries.empty() ) {
+			seekIndex = std::make_shared<SeekIndex>( entries );
+		}
+		Seek( 0 );
+	}
+	return seekIndex;
+}
+
+void DecoderFFmpeg::SetSeekIndex( SeekIndex::Ptr seekIndex )
+{
+	m_SeekIndex = seekIndex;
+}
+
+std::optional<long long> DecoderFFmpeg::GetGaplessFrameCount() const
+{
+	return m_GaplessFrameCount;
+}
+
+bool DecoderFFmpeg::ReadGaplessInfo( long long& frameCount ) const
+{
+	bool success = false;
+	const AVStream* stream = m_FormatContext->streams[ m_StreamIndex ];
+	const AVDictionaryEntry* entry = av_dict_get( m_FormatContext->metadata, "iTunSMPB", nullptr, 0 );
+	if ( ( nullptr == entry ) && ( nullptr != stream ) ) {
+		entry = av_dict_get( stream->metadata, "iTunSMPB", nullptr, 0 );
+	}
+	if ( ( nullptr != entry ) && ( nullptr != entry->value ) && ( nullptr != stream ) && ( stream->duration > 0 ) && ( GetSampleRate() > 0 ) ) {
+		// The tag value is a list of hexadecimal fields, where the second is the encoder delay, the third is the encoder padding, and the fourth is the frame count.
+		std::istringstream fields( entry->value );
+		unsigned long long reserved = 0, encoderDelay = 0, encoderPadding = 0, frames = 0;
+		fields >> std::hex >> reserved >> encoderDelay >> encoderPadding >> frames;
+		if ( !fields.fail() && ( frames > 0 ) ) {
+			// Ignore the tag if it does not tally with the stream length.
+			const long long streamFrames = static_cast<long long>( 0.5 + stream->duration * av_q2d( stream->time_base ) * GetSampleRate() );
+			success = ( static_cast<long long>( frames ) <= streamFrames );
+			if ( success ) {
+				frameCount = static_cast<long long>( frames );
+			}
+		}
+	}
+	return success;
 }
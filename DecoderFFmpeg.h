@@ -2,6 +2,7 @@
 
 #include "Decoder.h"
 
+#include <optional>
 #include <string>
 
 struct AVCodecContext;
@@ -28,11 +29,31 @@ public:
 	// Returns the new position in seconds.
 	float Seek( const float position ) override;
 
+	// Returns whether the decoder can make use of a seek index.
+	bool SupportsSeekIndex() const override;
+
+	// Generates a seek index by scanning the stream from the current position.
+	// 'canContinue' - callback which returns whether generation can continue.
+	// Returns the seek index, or nullptr if generation was cancelled.
+	SeekIndex::Ptr GenerateSeekIndex( CanContinue canContinue ) override;
+
+	// Sets the 'seekIndex' to use when seeking.
+	void SetSeekIndex( SeekIndex::Ptr seekIndex ) override;
+
+	// Returns the number of frames in the stream excluding encoder padding, if known from the gapless playback information in the file.
+	// FFmpeg already discards any encoder delay, but not the encoder padding from iTunes encoded files.
+	std::optional<long long> GetGaplessFrameCount() const;
+
 private:
+	// Reads the gapless playback information from the iTunes 'iTunSMPB' tag.
+	// 'frameCount' - out, the number of frames excluding encoder delay & padding.
+	// Returns whether the information was read.
+	bool ReadGaplessInfo( long long& frameCount ) const;
+
 	// Deccodes the next chunk of data into the sample buffer, returning whether any data was decoded.
 	bool Decode();
 
-	// Converts data from the 'frame' into the sample 'buffer'.
+	// Converts data from the 'frame', appending it to the sample 'buffer'.
 	static void ConvertSampleData( const AVFrame* frame, std::vector<float>& buffer ); 
 
 	// FFmpeg format context.
@@ -55,4 +76,13 @@ private:
 
 	// Current buffer position.
 	size_t m_BufferPosition = 0;
+
+	// Seek index.
+	SeekIndex::Ptr m_SeekIndex;
+
+	// The number of decoded samples to discard, after seeking to a sync point.
+	size_t m_SkipSamples = 0;
+
+	// The number of frames in the stream excluding encoder padding, if known.
+	std::optional<long long> m_GaplessFrameCount;
 };
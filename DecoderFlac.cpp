@@ -1,26 +1,27 @@
 #include "DecoderFlac.h"
 
+#include "SampleConversion.h"
+
+#include <algorithm>
+#include <array>
+
 DecoderFlac::DecoderFlac( const std::wstring& filename ) :
 	Decoder(),
 	FLAC::Decoder::Stream(),
-	m_FileStream(),
+	m_File( filename, MappedFile::Access::Sequential ),
 	m_FLACFrame(),
-	m_FLACBuffer( nullptr ),
+	m_FrameBuffer(),
 	m_FLACFramePos( 0 ),
 	m_Valid( false )
 {
-	m_FileStream.open( filename, std::ios::binary | std::ios::in );
-	if ( m_FileStream.is_open() ) {
-		if ( init() == FLAC__STREAM_DECODER_INIT_STATUS_OK )	{
-			process_until_end_of_metadata();
-		}
+	if ( init() == FLAC__STREAM_DECODER_INIT_STATUS_OK )	{
+		process_until_end_of_metadata();
 	}
 
 	if ( m_Valid ) {
 		SetBitrate( CalculateBitrate() );
 	} else {
 		finish();
-		m_FileStream.close();
 		throw std::runtime_error( "DecoderFlac could not load file" );
 	}
 }
@@ -28,7 +29,6 @@ DecoderFlac::DecoderFlac( const std::wstring& filename ) :
 DecoderFlac::~DecoderFlac()
 {
 	finish();
-	m_FileStream.close();
 }
 
 long DecoderFlac::Read( float* buffer, const long sampleCount )
@@ -42,12 +42,12 @@ long DecoderFlac::Read( float* buffer, const long sampleCount )
 				break;
 			}
 		}
-		for ( unsigned int channel = 0; channel < m_FLACFrame.header.channels; channel++ ) {
-			buffer[ samplesRead * m_FLACFrame.header.channels + channel ] = 
-					static_cast<float>( m_FLACBuffer[ channel ][ m_FLACFramePos ] ) / ( 1 << ( m_FLACFrame.header.bits_per_sample - 1 ) );
-		}
-		++samplesRead;
-		++m_FLACFramePos;
+		const unsigned int channels = m_FLACFrame.header.channels;
+		const unsigned int frameSamples = std::min<unsigned int>( static_cast<unsigned int>( sampleCount - samplesRead ), m_FLACFrame.header.blocksize - m_FLACFramePos );
+		const float* frameBuffer = m_FrameBuffer.data() + static_cast<size_t>( m_FLACFramePos ) * channels;
+		std::copy( frameBuffer, frameBuffer + static_cast<size_t>( frameSamples ) * channels, buffer + static_cast<size_t>( samplesRead ) * channels );
+		samplesRead += static_cast<long>( frameSamples );
+		m_FLACFramePos += frameSamples;
 	}
 	
 	return samplesRead;
@@ -71,39 +71,31 @@ float DecoderFlac::Seek( const float position )
 std::optional<float> DecoderFlac::CalculateBitrate()
 {
 	std::optional<float> bitrate;
-	if ( const float duration = GetDuration(); ( duration > 0 ) && m_FileStream.good() ) {
-		const auto initial = m_FileStream.tellg();
-
-		m_FileStream.seekg( 0, std::ios_base::end );
-		const long long filesize = m_FileStream.tellg();
-		m_FileStream.seekg( 0, std::ios_base::beg );
-
-		std::vector<char> block( 4 );
-		m_FileStream.read( block.data(), 4 );
-		if ( ( 'f' == block[ 0 ] ) && ( 'L' == block[ 1 ] ) && ( 'a' ==  block[ 2 ] ) && ('C' == block[ 3 ] ) ) {
-			m_FileStream.read( block.data(), 4 );
-			while ( m_FileStream.good() ) {
-				const long long currentPos = m_FileStream.tellg();
-				const unsigned long blockSize = ( static_cast<unsigned char>( block[ 1 ] ) << 16 ) | ( static_cast<unsigned char>( block[ 2 ] ) << 8 ) | static_cast<unsigned char>( block[ 3 ] );
-				if ( ( currentPos + blockSize ) < filesize ) {
+	if ( const float duration = GetDuration(); duration > 0 ) {
+		const uint64_t initial = m_File.GetPosition();
+		const long long filesize = static_cast<long long>( m_File.GetSize() );
+
+		std::array<unsigned char, 4> block = {};
+		if ( m_File.Seek( 0 ) && ( block.size() == m_File.Read( block.data(), block.size() ) ) && ( 'f' == block[ 0 ] ) && ( 'L' == block[ 1 ] ) && ( 'a' ==  block[ 2 ] ) && ('C' == block[ 3 ] ) ) {
+			bool finished = ( block.size() != m_File.Read( block.data(), block.size() ) );
+			while ( !finished ) {
+				const long long currentPos = static_cast<long long>( m_File.GetPosition() );
+				const unsigned long blockSize = ( static_cast<unsigned long>( block[ 1 ] ) << 16 ) | ( static_cast<unsigned long>( block[ 2 ] ) << 8 ) | block[ 3 ];
+				finished = ( ( currentPos + blockSize ) >= filesize );
+				if ( !finished ) {
 					const bool lastBlock = block[ 0 ] & 0x80;
 					if ( lastBlock ) {
 						const long long streamsize = filesize - currentPos - blockSize;
 						bitrate = ( streamsize * 8 ) / ( duration * 1000 );
-						break;
+						finished = true;
+					} else {
+						finished = !m_File.Seek( static_cast<uint64_t>( currentPos ) + blockSize ) || ( block.size() != m_File.Read( block.data(), block.size() ) );
 					}
-				} else {
-					break;
 				}
-				m_FileStream.seekg( blockSize, std::ios_base::cur );
-				m_FileStream.read( block.data(), 4 );
-			};
+			}
 		}
 
-		if ( !m_FileStream.good() ) {
-			m_FileStream.clear();
-		}
-		m_FileStream.seekg( initial );
+		m_File.Seek( initial );
 	}
 	return bitrate;
 }
@@ -111,12 +103,11 @@ std::optional<float> DecoderFlac::CalculateBitrate()
 FLAC__StreamDecoderReadStatus DecoderFlac::read_callback( FLAC__byte buf[], size_t * size )
 {
 	FLAC__StreamDecoderReadStatus status = FLAC__STREAM_DECODER_READ_STATUS_ABORT;
-	if ( m_FileStream.eof() ) {
+	if ( m_File.IsEOF() ) {
 		*size = 0;
 		status = FLAC__STREAM_DECODER_READ_STATUS_END_OF_STREAM;
 	} else {
-		m_FileStream.read( reinterpret_cast<char*>( buf ), *size );
-		*size = static_cast<size_t>( m_FileStream.gcount() );
+		*size = m_File.Read( buf, *size );
 		if ( *size > 0 ) {
 			status = FLAC__STREAM_DECODER_READ_STATUS_CONTINUE;
 		}
@@ -126,44 +117,43 @@ FLAC__StreamDecoderReadStatus DecoderFlac::read_callback( FLAC__byte buf[], size
 
 FLAC__StreamDecoderSeekStatus DecoderFlac::seek_callback( FLAC__uint64 pos )
 {
-	if ( !m_FileStream.good() ) {
-		m_FileStream.clear();
-	}
-	m_FileStream.seekg( pos, std::ios_base::beg );
-	return FLAC__STREAM_DECODER_SEEK_STATUS_OK;
+	return m_File.Seek( pos ) ? FLAC__STREAM_DECODER_SEEK_STATUS_OK : FLAC__STREAM_DECODER_SEEK_STATUS_ERROR;
 }
 
 FLAC__StreamDecoderTellStatus DecoderFlac::tell_callback( FLAC__uint64 * pos )
 {
-	if ( !m_FileStream.good() ) {
-		m_FileStream.clear();
-	}
-	*pos = m_FileStream.tellg();
+	*pos = m_File.GetPosition();
 	return FLAC__STREAM_DECODER_TELL_STATUS_OK;
 }
 
 FLAC__StreamDecoderLengthStatus DecoderFlac::length_callback( FLAC__uint64 * pos )
 {
-	if ( !m_FileStream.good() ) {
-		m_FileStream.clear();
-	}
-	const std::streampos currentPos = m_FileStream.tellg();
-	m_FileStream.seekg( 0, std::ios_base::end );
-	*pos = m_FileStream.tellg();
-	m_FileStream.seekg( currentPos );
+	*pos = m_File.GetSize();
 	return FLAC__STREAM_DECODER_LENGTH_STATUS_OK;
 }
 
 bool DecoderFlac::eof_callback()
 {
-	const bool eof = m_FileStream.eof();
+	const bool eof = m_File.IsEOF();
 	return eof;
 }
 
 FLAC__StreamDecoderWriteStatus DecoderFlac::write_callback( const FLAC__Frame * frame, const FLAC__int32 *const buffer[] )
 {
 	m_FLACFrame = *frame;
-	m_FLACBuffer = const_cast<FLAC__int32**>( buffer );
+
+	// Convert the whole frame up front, rather than sample by sample when reading.
+	const unsigned int channels = frame->header.channels;
+	const unsigned int blocksize = frame->header.blocksize;
+	const unsigned int bps = frame->header.bits_per_sample;
+	if ( ( channels > 0 ) && ( bps > 0 ) && ( bps <= 32 ) ) {
+		const float scale = 1.0f / static_cast<float>( 1ull << ( bps - 1 ) );
+		m_FrameBuffer.resize( static_cast<size_t>( blocksize ) * channels );
+		InterleaveSigned32ToFloat( buffer, channels, blocksize, m_FrameBuffer.data(), scale );
+	} else {
+		m_FLACFrame.header.blocksize = 0;
+		m_FrameBuffer.clear();
+	}
 	return FLAC__STREAM_DECODER_WRITE_STATUS_CONTINUE;
 }
 
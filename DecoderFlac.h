@@ -1,9 +1,9 @@
 #pragma once
 #include "Decoder.h"
+#include "MappedFile.h"
 
 #include "FLAC++\all.h"
 
-#include <fstream>
 #include <vector>
 
 // FLAC decoder
@@ -41,14 +41,14 @@ private:
 	// Calculates the bitrate of the FLAC stream (returns nullopt if the bitrate was not calculated).
 	std::optional<float> CalculateBitrate();
 
-	// Input file stream.
-	std::ifstream m_FileStream;
+	// Input file.
+	MappedFile m_File;
 
 	// Current FLAC frame.
 	FLAC__Frame m_FLACFrame;
 
-	// Current FLAC buffer.
-	FLAC__int32** m_FLACBuffer;
+	// Current FLAC frame, converted to interleaved floating point samples.
+	std::vector<float> m_FrameBuffer;
 
 	// Current FLAC frame position.
 	unsigned int m_FLACFramePos;
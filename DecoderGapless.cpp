@@ -0,0 +1,104 @@
+#include "DecoderGapless.h"
+
+#include <algorithm>
+
+// Maximum number of frames to discard per read, when skipping encoder delay.
+constexpr long kSkipBlockSize = 4096;
+
+DecoderGapless::DecoderGapless( Decoder::Ptr decoder, const long long encoderDelay, const long long totalFrames ) :
+	Decoder(),
+	m_Decoder( decoder ),
+	m_EncoderDelay( std::max<long long>( 0ll, encoderDelay ) ),
+	m_TotalFrames( std::max<long long>( 0ll, totalFrames ) ),
+	m_PendingDelay( m_EncoderDelay ),
+	m_Position( 0 ),
+	m_SkipBuffer()
+{
+	if ( !m_Decoder ) {
+		throw std::runtime_error( "DecoderGapless requires an underlying decoder" );
+	}
+
+	const long sampleRate = m_Decoder->GetSampleRate();
+	SetSampleRate( sampleRate );
+	SetChannels( m_Decoder->GetChannels() );
+	SetBPS( m_Decoder->GetBPS() );
+	SetBitrate( m_Decoder->GetBitrate() );
+	if ( ( m_TotalFrames > 0 ) && ( sampleRate > 0 ) ) {
+		SetDuration( static_cast<float>( static_cast<double>( m_TotalFrames ) / sampleRate ) );
+	} else if ( sampleRate > 0 ) {
+		SetDuration( std::max<float>( 0.0f, m_Decoder->GetDuration() - static_cast<float>( static_cast<double>( m_EncoderDelay ) / sampleRate ) ) );
+	} else {
+		SetDuration( m_Decoder->GetDuration() );
+	}
+}
+
+DecoderGapless::~DecoderGapless()
+{
+}
+
+bool DecoderGapless::SkipEncoderDelay()
+{
+	const long channels = GetChannels();
+	if ( ( m_PendingDelay > 0 ) && ( channels > 0 ) ) {
+		const long blockSize = static_cast<long>( std::min<long long>( m_PendingDelay, kSkipBlockSize ) );
+		m_SkipBuffer.resize( static_cast<size_t>( blockSize ) * static_cast<size_t>( channels ) );
+		long framesRead = 0;
+		do {
+			framesRead = m_Decoder->Read( m_SkipBuffer.data(), static_cast<long>( std::min<long long>( m_PendingDelay, blockSize ) ) );
+			m_PendingDelay -= framesRead;
+		} while ( ( m_PendingDelay > 0 ) && ( framesRead > 0 ) );
+	}
+	return ( 0 == m_PendingDelay );
+}
+
+long DecoderGapless::Read( float* buffer, const long sampleCount )
+{
+	long samplesRead = 0;
+	if ( ( nullptr != buffer ) && ( sampleCount > 0 ) && SkipEncoderDelay() ) {
+		// Encoder padding at the end of the stream is never read.
+		const long samplesToRead = ( m_TotalFrames > 0 ) ? static_cast<long>( std::clamp<long long>( m_TotalFrames - m_Position, 0, sampleCount ) ) : sampleCount;
+		if ( samplesToRead > 0 ) {
+			samplesRead = m_Decoder->Read( buffer, samplesToRead );
+			m_Position += samplesRead;
+		}
+	}
+	return samplesRead;
+}
+
+float DecoderGapless::Seek( const float position )
+{
+	float seekPosition = 0;
+	const long sampleRate = GetSampleRate();
+	if ( sampleRate > 0 ) {
+		const double delaySeconds = static_cast<double>( m_EncoderDelay ) / sampleRate;
+		const double streamPosition = m_Decoder->Seek( static_cast<float>( std::max<float>( 0.0f, position ) + delaySeconds ) );
+		const long long streamFrame = static_cast<long long>( 0.5 + streamPosition * sampleRate );
+
+		// The underlying decoder might not be able to seek past the encoder delay, in which case any remaining delay is discarded on the next read.
+		m_PendingDelay = std::max<long long>( 0ll, m_EncoderDelay - streamFrame );
+		m_Position = std::max<long long>( 0ll, streamFrame - m_EncoderDelay );
+		seekPosition = static_cast<float>( static_cast<double>( m_Position ) / sampleRate );
+	}
+	return seekPosition;
+}
+
+bool DecoderGapless::SupportsSeekIndex() const
+{
+	return m_Decoder->SupportsSeekIndex();
+}
+
+SeekIndex::Ptr DecoderGapless::GenerateSeekIndex( CanContinue canContinue )
+{
+	// The seek index is generated in terms of the underlying stream, which is consistent with how the underlying decoder is sought.
+	SeekIndex::Ptr seekIndex;
+	if ( m_Decoder->SupportsSeekIndex() ) {
+		seekIndex = m_Decoder->GenerateSeekIndex( canContinue );
+		Seek( 0 );
+	}
+	return seekIndex;
+}
+
+void DecoderGapless::SetSeekIndex( SeekIndex::Ptr seekIndex )
+{
+	m_Decoder->SetSeekIndex( seekIndex );
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "Decoder.h"
+
+#include <vector>
+
+// Gapless decoder wrapper, which trims encoder delay from the start of a stream & encoder padding from the end.
+// This is only needed for formats where the underlying decoder does not already trim the stream.
+class DecoderGapless : public Decoder
+{
+public:
+	// 'decoder' - underlying decoder, positioned at the start of the stream.
+	// 'encoderDelay' - number of leading frames to discard.
+	// 'totalFrames' - number of frames in the stream, excluding encoder delay & padding, or zero if the encoder padding is unknown.
+	DecoderGapless( Decoder::Ptr decoder, const long long encoderDelay, const long long totalFrames );
+
+	~DecoderGapless() override;
+
+	// Reads sample data.
+	// 'buffer' - output buffer (floating point format scaled to +/-1.0f).
+	// 'sampleCount' - number of samples to read.
+	// Returns the number of samples read, or zero if the stream has ended.
+	long Read( float* buffer, const long sampleCount ) override;
+
+	// Seeks to a 'position' in the stream, in seconds.
+	// Returns the new position in seconds.
+	float Seek( const float position ) override;
+
+	// Returns whether the decoder can make use of a seek index.
+	bool SupportsSeekIndex() const override;
+
+	// Generates a seek index by scanning the stream from the current position.
+	// 'canContinue' - callback which returns whether generation can continue.
+	// Returns the seek index, or nullptr if a seek index is not supported or generation was cancelled.
+	SeekIndex::Ptr GenerateSeekIndex( CanContinue canContinue ) override;
+
+	// Sets the 'seekIndex' to use when seeking.
+	void SetSeekIndex( SeekIndex::Ptr seekIndex ) override;
+
+private:
+	// Discards any pending encoder delay frames, returning whether all pending frames were discarded.
+	bool SkipEncoderDelay();
+
+	// Underlying decoder.
+	const Decoder::Ptr m_Decoder;
+
+	// Number of leading frames to discard.
+	const long long m_EncoderDelay;
+
+	// Number of frames in the stream, excluding encoder delay & padding, or zero if the encoder padding is unknown.
+	const long long m_TotalFrames;
+
+	// Number of encoder delay frames still to be discarded.
+	long long m_PendingDelay;
+
+	// Current position, in frames, excluding encoder delay.
+	long long m_Position;
+
+	// Buffer for discarded sample data.
+	std::vector<float> m_SkipBuffer;
+};
@@ -51,13 +51,16 @@ DecoderMPC::~DecoderMPC()
 long DecoderMPC::Read( float* destBuffer, const long sampleCount )
 {
 	long samplesRead = 0;
-	const long channels = GetChannels();
+	const size_t channels = static_cast<size_t>( GetChannels() );
 	while ( !m_eos && ( samplesRead < sampleCount ) ) {
 		if ( m_bufferpos < m_buffercount ) {
-			for ( long channel = 0; channel < channels; channel++ ) {
-				*destBuffer++ = m_buffer[ m_bufferpos++ ];
-			}
-			++samplesRead;
+			// Copy as many whole frames from the decoded frame buffer as will fit.
+			const size_t frames = std::min<size_t>( ( m_buffercount - m_bufferpos ) / channels, static_cast<size_t>( sampleCount - samplesRead ) );
+			const size_t count = frames * channels;
+			std::copy( m_buffer.begin() + m_bufferpos, m_buffer.begin() + m_bufferpos + count, destBuffer );
+			destBuffer += count;
+			m_bufferpos += count;
+			samplesRead += static_cast<long>( frames );
 		} else {
 			m_bufferpos = 0;
 			m_buffercount = 0;
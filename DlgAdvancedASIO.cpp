@@ -2,6 +2,7 @@
 
 #include "resource.h"
 #include "Utility.h"
+#include "windowsx.h"
 
 INT_PTR CALLBACK DlgAdvancedASIO::DialogProc( HWND hwnd, UINT message, WPARAM wParam, LPARAM lParam )
 {
@@ -46,6 +47,7 @@ INT_PTR CALLBACK DlgAdvancedASIO::DialogProc( HWND hwnd, UINT message, WPARAM wP
 }
 
 DlgAdvancedASIO::DlgAdvancedASIO( const HINSTANCE instance, const HWND parent, Settings& settings ) :
+	m_hInst( instance ),
 	m_Settings( settings )
 {
 	DialogBoxParam( instance, MAKEINTRESOURCE( IDD_ADVANCED_ASIO ), parent, DialogProc, reinterpret_cast<LPARAM>( this ) );
@@ -66,6 +68,7 @@ void DlgAdvancedASIO::OnInitDialog( const HWND hwnd )
 	SetDlgItemInt( hwnd, IDC_ASIO_LEADIN, static_cast<UINT>( leadIn ), FALSE );
 	CheckRadioButton( hwnd, IDC_ASIO_OUTPUT_DEFAULT, IDC_ASIO_OUTPUT_SOURCE,
 		useDefaultSamplerate ? IDC_ASIO_OUTPUT_DEFAULT : IDC_ASIO_OUTPUT_SOURCE );
+	InitResamplerQuality( hwnd, m_Settings.GetResamplerQuality() );
 }
 
 void DlgAdvancedASIO::SaveSettings( const HWND hwnd )
@@ -87,6 +90,11 @@ void DlgAdvancedASIO::SaveSettings( const HWND hwnd )
 	}
 
 	m_Settings.SetAdvancedASIOSettings( useDefaultSamplerate, defaultSamplerate, leadIn );
+
+	const int selectedQuality = ComboBox_GetCurSel( GetDlgItem( hwnd, IDC_ASIO_RESAMPLER ) );
+	if ( ( selectedQuality >= static_cast<int>( Settings::ResamplerQuality::Disabled ) ) && ( selectedQuality <= static_cast<int>( Settings::ResamplerQuality::High ) ) ) {
+		m_Settings.SetResamplerQuality( static_cast<Settings::ResamplerQuality>( selectedQuality ) );
+	}
 }
 
 void DlgAdvancedASIO::ResetToDefaults( const HWND hwnd )
@@ -101,4 +109,19 @@ void DlgAdvancedASIO::ResetToDefaults( const HWND hwnd )
 	SetDlgItemInt( hwnd, IDC_ASIO_LEADIN, static_cast<UINT>( leadIn ), TRUE /*signed*/ );
 	CheckRadioButton( hwnd, IDC_ASIO_OUTPUT_DEFAULT, IDC_ASIO_OUTPUT_SOURCE,
 		useDefaultSamplerate ? IDC_ASIO_OUTPUT_DEFAULT : IDC_ASIO_OUTPUT_SOURCE );
+	InitResamplerQuality( hwnd, Settings::ResamplerQuality::Disabled );
+}
+
+void DlgAdvancedASIO::InitResamplerQuality( const HWND hwnd, const Settings::ResamplerQuality quality )
+{
+	if ( const HWND hwndQuality = GetDlgItem( hwnd, IDC_ASIO_RESAMPLER ); nullptr != hwndQuality ) {
+		ComboBox_ResetContent( hwndQuality );
+		const int bufSize = 32;
+		WCHAR buf[ bufSize ] = {};
+		for ( const int stringID : { IDS_RESAMPLERQUALITY_DISABLED, IDS_RESAMPLERQUALITY_LOW, IDS_RESAMPLERQUALITY_MEDIUM, IDS_RESAMPLERQUALITY_HIGH } ) {
+			LoadString( m_hInst, stringID, buf, bufSize );
+			ComboBox_AddString( hwndQuality, buf );
+		}
+		ComboBox_SetCurSel( hwndQuality, static_cast<int>( quality ) );
+	}
 }
@@ -2,6 +2,7 @@
 
 #include "resource.h"
 #include "Utility.h"
+#include "windowsx.h"
 
 INT_PTR CALLBACK DlgAdvancedWasapi::DialogProc( HWND hwnd, UINT message, WPARAM wParam, LPARAM lParam )
 {
@@ -46,6 +47,7 @@ INT_PTR CALLBACK DlgAdvancedWasapi::DialogProc( HWND hwnd, UINT message, WPARAM
 }
 
 DlgAdvancedWasapi::DlgAdvancedWasapi( const HINSTANCE instance, const HWND parent, Settings& settings ) :
+	m_hInst( instance ),
 	m_Settings( settings )
 {
 	DialogBoxParam( instance, MAKEINTRESOURCE( IDD_ADVANCED_WASAPI ), parent, DialogProc, reinterpret_cast<LPARAM>( this ) );
@@ -66,6 +68,7 @@ void DlgAdvancedWasapi::OnInitDialog( const HWND hwnd )
 	SetDlgItemInt( hwnd, IDC_WASAPI_LEADIN, static_cast<UINT>( leadIn ), FALSE );
 	CheckRadioButton( hwnd, IDC_WASAPI_OUTPUT_DEFAULT, IDC_WASAPI_OUTPUT_SOURCE,
 		useDeviceDefaultFormat ? IDC_WASAPI_OUTPUT_DEFAULT : IDC_WASAPI_OUTPUT_SOURCE );
+	InitResamplerQuality( hwnd, m_Settings.GetResamplerQuality() );
 }
 
 void DlgAdvancedWasapi::SaveSettings( const HWND hwnd )
@@ -87,6 +90,11 @@ void DlgAdvancedWasapi::SaveSettings( const HWND hwnd )
 	}
 
 	m_Settings.SetAdvancedWasapiExclusiveSettings( useDeviceDefaultFormat, bufferLength, leadIn );
+
+	const int selectedQuality = ComboBox_GetCurSel( GetDlgItem( hwnd, IDC_WASAPI_RESAMPLER ) );
+	if ( ( selectedQuality >= static_cast<int>( Settings::ResamplerQuality::Disabled ) ) && ( selectedQuality <= static_cast<int>( Settings::ResamplerQuality::High ) ) ) {
+		m_Settings.SetResamplerQuality( static_cast<Settings::ResamplerQuality>( selectedQuality ) );
+	}
 }
 
 void DlgAdvancedWasapi::ResetToDefaults( const HWND hwnd )
@@ -101,4 +109,19 @@ void DlgAdvancedWasapi::ResetToDefaults( const HWND hwnd )
 	SetDlgItemInt( hwnd, IDC_WASAPI_LEADIN, static_cast<UINT>( leadIn ), TRUE /*signed*/ );
 	CheckRadioButton( hwnd, IDC_WASAPI_OUTPUT_DEFAULT, IDC_WASAPI_OUTPUT_SOURCE,
 		useDeviceDefaultFormat ? IDC_WASAPI_OUTPUT_DEFAULT : IDC_WASAPI_OUTPUT_SOURCE );
+	InitResamplerQuality( hwnd, Settings::ResamplerQuality::Disabled );
+}
+
+void DlgAdvancedWasapi::InitResamplerQuality( const HWND hwnd, const Settings::ResamplerQuality quality )
+{
+	if ( const HWND hwndQuality = GetDlgItem( hwnd, IDC_WASAPI_RESAMPLER ); nullptr != hwndQuality ) {
+		ComboBox_ResetContent( hwndQuality );
+		const int bufSize = 32;
+		WCHAR buf[ bufSize ] = {};
+		for ( const int stringID : { IDS_RESAMPLERQUALITY_DISABLED, IDS_RESAMPLERQUALITY_LOW, IDS_RESAMPLERQUALITY_MEDIUM, IDS_RESAMPLERQUALITY_HIGH } ) {
+			LoadString( m_hInst, stringID, buf, bufSize );
+			ComboBox_AddString( hwndQuality, buf );
+		}
+		ComboBox_SetCurSel( hwndQuality, static_cast<int>( quality ) );
+	}
 }
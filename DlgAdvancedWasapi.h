@@ -28,6 +28,12 @@ private:
 	// Resets controls to the default state.
 	void ResetToDefaults( const HWND hwnd );
 
+	// Fills the resampler quality list, and selects the 'quality'.
+	void InitResamplerQuality( const HWND hwnd, const Settings::ResamplerQuality quality );
+
+	// Module instance handle.
+	const HINSTANCE m_hInst;
+
 	// Application settings.
 	Settings& m_Settings;
 };
@@ -0,0 +1,284 @@
+#include "Equaliser.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined( _M_X64 ) || defined( _M_IX86 ) || defined( __SSE2__ )
+#define EQUALISER_SSE2
+#include <emmintrin.h>
+#endif
+
+// The time over which coefficient changes are smoothed, in seconds.
+constexpr float kSmoothingTime = 0.02f;
+
+// Bands at or above this proportion of the sample rate are ignored.
+constexpr float kMaxFrequencyRatio = 1.0f / 3;
+
+// Filter state values below this level are flushed to zero, to avoid denormals.
+constexpr float kDenormalThreshold = 1e-15f;
+
+#ifdef EQUALISER_SSE2
+// Loads 'laneCount' (up to 4) consecutive samples, with any unused lanes set to zero.
+static inline __m128 LoadLanes( const float* samples, const size_t laneCount )
+{
+	__m128 lanes;
+	switch ( laneCount ) {
+		case 1 : {
+			lanes = _mm_load_ss( samples );
+			break;
+		}
+		case 2 : {
+			lanes = _mm_castpd_ps( _mm_load_sd( reinterpret_cast<const double*>( samples ) ) );
+			break;
+		}
+		case 3 : {
+			lanes = _mm_movelh_ps( _mm_castpd_ps( _mm_load_sd( reinterpret_cast<const double*>( samples ) ) ), _mm_load_ss( samples + 2 ) );
+			break;
+		}
+		default : {
+			lanes = _mm_loadu_ps( samples );
+			break;
+		}
+	}
+	return lanes;
+}
+
+// Stores 'laneCount' (up to 4) consecutive samples.
+static inline void StoreLanes( float* samples, const size_t laneCount, const __m128 lanes )
+{
+	switch ( laneCount ) {
+		case 1 : {
+			_mm_store_ss( samples, lanes );
+			break;
+		}
+		case 2 : {
+			_mm_store_sd( reinterpret_cast<double*>( samples ), _mm_castps_pd( lanes ) );
+			break;
+		}
+		case 3 : {
+			_mm_store_sd( reinterpret_cast<double*>( samples ), _mm_castps_pd( lanes ) );
+			_mm_store_ss( samples + 2, _mm_movehl_ps( lanes, lanes ) );
+			break;
+		}
+		default : {
+			_mm_storeu_ps( samples, lanes );
+			break;
+		}
+	}
+}
+#endif
+
+Equaliser::Equaliser() :
+	m_PendingMutex(),
+	m_PendingBands(),
+	m_Bands(),
+	m_Current(),
+	m_Target(),
+	m_Step(),
+	m_State1(),
+	m_State2()
+{
+}
+
+Equaliser::~Equaliser()
+{
+}
+
+void Equaliser::SetSettings( const Settings::EQ& eq )
+{
+	std::lock_guard<std::mutex> lock( m_PendingMutex );
+	m_PendingBandCount = 0;
+	for ( auto gain = eq.Gains.begin(); ( eq.Gains.end() != gain ) && ( m_PendingBandCount < kMaxBands ); gain++ ) {
+		m_PendingBands[ m_PendingBandCount++ ] = { static_cast<float>( gain->first ), gain->second };
+	}
+	m_PendingBandwidth = eq.Bandwidth;
+	m_PendingEnabled = eq.Enabled;
+	m_PendingChanged = true;
+}
+
+void Equaliser::Reset()
+{
+	ClearState();
+	m_Current = m_Target;
+	m_SmoothingRemaining = 0;
+}
+
+void Equaliser::ClearState()
+{
+	for ( auto& state : m_State1 ) {
+		state.fill( 0 );
+	}
+	for ( auto& state : m_State2 ) {
+		state.fill( 0 );
+	}
+}
+
+bool Equaliser::IsActive( const std::array<Coefficients, kMaxBands>& coefficients ) const
+{
+	return std::any_of( coefficients.begin(), coefficients.begin() + m_BandCount, [] ( const Coefficients& c ) { return !c.IsIdentity(); } );
+}
+
+Equaliser::Coefficients Equaliser::CalculateCoefficients( const float frequency, const float gain, const float bandwidth, const long sampleRate )
+{
+	Coefficients coefficients;
+	if ( ( 0 != gain ) && ( bandwidth > 0 ) && ( sampleRate > 0 ) && ( frequency > 0 ) && ( frequency < ( kMaxFrequencyRatio * sampleRate ) ) ) {
+		constexpr double kPi = 3.14159265358979323846;
+		const double a = pow( 10.0, gain / 40.0 );
+		const double w0 = 2 * kPi * frequency / sampleRate;
+		const double sinW0 = sin( w0 );
+		const double cosW0 = cos( w0 );
+		const double octaves = bandwidth / 12.0;
+		const double alpha = sinW0 * sinh( log( 2.0 ) / 2 * octaves * w0 / sinW0 );
+		const double a0 = 1 + alpha / a;
+		coefficients.B0 = static_cast<float>( ( 1 + alpha * a ) / a0 );
+		coefficients.B1 = static_cast<float>( ( -2 * cosW0 ) / a0 );
+		coefficients.B2 = static_cast<float>( ( 1 - alpha * a ) / a0 );
+		coefficients.A1 = coefficients.B1;
+		coefficients.A2 = static_cast<float>( ( 1 - alpha / a ) / a0 );
+	}
+	return coefficients;
+}
+
+void Equaliser::UpdateCoefficients( const bool smooth )
+{
+	const bool wasActive = ( m_SmoothingRemaining > 0 ) || IsActive( m_Current );
+
+	for ( size_t band = 0; band < kMaxBands; band++ ) {
+		m_Target[ band ] = ( m_Enabled && ( band < m_BandCount ) ) ? CalculateCoefficients( m_Bands[ band ].Frequency, m_Bands[ band ].Gain, m_Bandwidth, m_SampleRate ) : Coefficients();
+	}
+
+	if ( smooth ) {
+		if ( !wasActive ) {
+			// The filters were bypassed, so any previous state is stale.
+			ClearState();
+		}
+		m_SmoothingRemaining = std::max<size_t>( 1, static_cast<size_t>( kSmoothingTime * m_SampleRate ) );
+		const float scale = 1.0f / m_SmoothingRemaining;
+		for ( size_t band = 0; band < kMaxBands; band++ ) {
+			const Coefficients& current = m_Current[ band ];
+			const Coefficients& target = m_Target[ band ];
+			m_Step[ band ] = { ( target.B0 - current.B0 ) * scale, ( target.B1 - current.B1 ) * scale, ( target.B2 - current.B2 ) * scale, ( target.A1 - current.A1 ) * scale, ( target.A2 - current.A2 ) * scale };
+		}
+	} else {
+		Reset();
+	}
+}
+
+void Equaliser::ProcessGroup( float* buffer, const size_t channels, const size_t channel, const size_t laneCount, const size_t band, const size_t frames )
+{
+	const Coefficients& step = m_Step[ band ];
+	const Coefficients& target = m_Target[ band ];
+	const size_t smoothingFrames = std::min<size_t>( frames, m_SmoothingRemaining );
+	Coefficients c = m_Current[ band ];
+	float* samples = buffer + channel;
+
+#ifdef EQUALISER_SSE2
+	__m128 z1 = _mm_loadu_ps( m_State1[ band ].data() + channel );
+	__m128 z2 = _mm_loadu_ps( m_State2[ band ].data() + channel );
+	const auto processFrame = [ &z1, &z2, laneCount ] ( float* frameSamples, const __m128 b0, const __m128 b1, const __m128 b2, const __m128 a1, const __m128 a2 )
+	{
+		const __m128 x = LoadLanes( frameSamples, laneCount );
+		const __m128 y = _mm_add_ps( _mm_mul_ps( b0, x ), z1 );
+		z1 = _mm_add_ps( _mm_sub_ps( _mm_mul_ps( b1, x ), _mm_mul_ps( a1, y ) ), z2 );
+		z2 = _mm_sub_ps( _mm_mul_ps( b2, x ), _mm_mul_ps( a2, y ) );
+		StoreLanes( frameSamples, laneCount, y );
+	};
+
+	size_t frame = 0;
+	for ( ; frame < smoothingFrames; frame++, samples += channels ) {
+		c = { c.B0 + step.B0, c.B1 + step.B1, c.B2 + step.B2, c.A1 + step.A1, c.A2 + step.A2 };
+		processFrame( samples, _mm_set1_ps( c.B0 ), _mm_set1_ps( c.B1 ), _mm_set1_ps( c.B2 ), _mm_set1_ps( c.A1 ), _mm_set1_ps( c.A2 ) );
+	}
+	if ( frame < frames ) {
+		const __m128 b0 = _mm_set1_ps( target.B0 );
+		const __m128 b1 = _mm_set1_ps( target.B1 );
+		const __m128 b2 = _mm_set1_ps( target.B2 );
+		const __m128 a1 = _mm_set1_ps( target.A1 );
+		const __m128 a2 = _mm_set1_ps( target.A2 );
+		for ( ; frame < frames; frame++, samples += channels ) {
+			processFrame( samples, b0, b1, b2, a1, a2 );
+		}
+	}
+
+	_mm_storeu_ps( m_State1[ band ].data() + channel, z1 );
+	_mm_storeu_ps( m_State2[ band ].data() + channel, z2 );
+#else
+	float* z1 = m_State1[ band ].data() + channel;
+	float* z2 = m_State2[ band ].data() + channel;
+	const auto processFrame = [ z1, z2, laneCount ] ( float* frameSamples, const Coefficients& coefficients )
+	{
+		for ( size_t lane = 0; lane < laneCount; lane++ ) {
+			const float x = frameSamples[ lane ];
+			const float y = coefficients.B0 * x + z1[ lane ];
+			z1[ lane ] = coefficients.B1 * x - coefficients.A1 * y + z2[ lane ];
+			z2[ lane ] = coefficients.B2 * x - coefficients.A2 * y;
+			frameSamples[ lane ] = y;
+		}
+	};
+
+	size_t frame = 0;
+	for ( ; frame < smoothingFrames; frame++, samples += channels ) {
+		c = { c.B0 + step.B0, c.B1 + step.B1, c.B2 + step.B2, c.A1 + step.A1, c.A2 + step.A2 };
+		processFrame( samples, c );
+	}
+	for ( ; frame < frames; frame++, samples += channels ) {
+		processFrame( samples, target );
+	}
+#endif
+}
+
+void Equaliser::Process( float* buffer, const long channels, const long sampleRate, const size_t frames )
+{
+	if ( ( nullptr != buffer ) && ( channels > 0 ) && ( static_cast<size_t>( channels ) <= kMaxChannels ) && ( sampleRate > 0 ) && ( frames > 0 ) ) {
+		bool settingsChanged = false;
+		if ( std::unique_lock<std::mutex> lock( m_PendingMutex, std::try_to_lock ); lock.owns_lock() && m_PendingChanged ) {
+			// Only pick up settings changes when they are not being written, so that the caller is never blocked.
+			settingsChanged = ( m_PendingBandCount != m_BandCount ) || ( m_PendingBandwidth != m_Bandwidth ) || ( m_PendingEnabled != m_Enabled ) ||
+				!std::equal( m_Bands.begin(), m_Bands.begin() + m_BandCount, m_PendingBands.begin(), [] ( const Band& a, const Band& b ) { return ( a.Frequency == b.Frequency ) && ( a.Gain == b.Gain ); } );
+			m_Bands = m_PendingBands;
+			m_BandCount = m_PendingBandCount;
+			m_Bandwidth = m_PendingBandwidth;
+			m_Enabled = m_PendingEnabled;
+			m_PendingChanged = false;
+		}
+
+		if ( ( static_cast<size_t>( channels ) != m_Channels ) || ( sampleRate != m_SampleRate ) ) {
+			m_Channels = static_cast<size_t>( channels );
+			m_SampleRate = sampleRate;
+			UpdateCoefficients( false /*smooth*/ );
+		} else if ( settingsChanged ) {
+			UpdateCoefficients( true /*smooth*/ );
+		}
+
+		if ( ( m_SmoothingRemaining > 0 ) || IsActive( m_Target ) ) {
+			for ( size_t band = 0; band < m_BandCount; band++ ) {
+				for ( size_t channel = 0; channel < m_Channels; channel += 4 ) {
+					ProcessGroup( buffer, m_Channels, channel, std::min<size_t>( 4, m_Channels - channel ), band, frames );
+				}
+			}
+
+			if ( m_SmoothingRemaining > frames ) {
+				for ( size_t band = 0; band < kMaxBands; band++ ) {
+					const Coefficients& step = m_Step[ band ];
+					Coefficients& c = m_Current[ band ];
+					const float count = static_cast<float>( frames );
+					c = { c.B0 + step.B0 * count, c.B1 + step.B1 * count, c.B2 + step.B2 * count, c.A1 + step.A1 * count, c.A2 + step.A2 * count };
+				}
+				m_SmoothingRemaining -= frames;
+			} else {
+				m_Current = m_Target;
+				m_SmoothingRemaining = 0;
+			}
+
+			for ( auto* states : { &m_State1, &m_State2 } ) {
+				for ( auto& state : *states ) {
+					for ( auto& value : state ) {
+						if ( fabsf( value ) < kDenormalThreshold ) {
+							value = 0;
+						}
+					}
+				}
+			}
+		}
+	}
+}
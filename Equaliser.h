@@ -0,0 +1,131 @@
+#pragma once
+
+#include "Settings.h"
+
+#include <array>
+#include <mutex>
+
+// Parametric equaliser, implemented as a cascade of peaking biquad filters (transposed direct form II).
+// Operates in place on interleaved floating point sample data, processing up to 4 channels at a time using SSE2 (where available).
+// Settings can be changed from any thread, with coefficient changes smoothed to avoid clicks.
+// Processing is allocation free.
+class Equaliser
+{
+public:
+	Equaliser();
+
+	virtual ~Equaliser();
+
+	// Sets the EQ settings.
+	void SetSettings( const Settings::EQ& eq );
+
+	// Resets the filter state.
+	void Reset();
+
+	// Applies EQ to interleaved sample data.
+	// 'buffer' - in/out, interleaved sample data.
+	// 'channels' - number of channels.
+	// 'sampleRate' - sample rate.
+	// 'frames' - number of samples per channel.
+	void Process( float* buffer, const long channels, const long sampleRate, const size_t frames );
+
+private:
+	// Maximum number of bands supported.
+	static constexpr size_t kMaxBands = 16;
+
+	// Maximum number of channels supported.
+	static constexpr size_t kMaxChannels = 8;
+
+	// Biquad filter coefficients (normalised so that a0 is 1).
+	struct Coefficients {
+		float B0 = 1.0f;
+		float B1 = 0;
+		float B2 = 0;
+		float A1 = 0;
+		float A2 = 0;
+
+		// Returns whether the coefficients have no effect.
+		bool IsIdentity() const { return ( 1.0f == B0 ) && ( 0 == B1 ) && ( 0 == B2 ) && ( 0 == A1 ) && ( 0 == A2 ); }
+	};
+
+	// EQ band.
+	struct Band {
+		float Frequency = 0;	// Centre frequency, in Hz.
+		float Gain = 0;				// Gain, in dB.
+	};
+
+	// A set of bands.
+	using Bands = std::array<Band, kMaxBands>;
+
+	// Returns the coefficients for a peaking filter.
+	// 'frequency' - centre frequency, in Hz.
+	// 'gain' - gain, in dB.
+	// 'bandwidth' - bandwidth, in semitones.
+	// 'sampleRate' - sample rate.
+	static Coefficients CalculateCoefficients( const float frequency, const float gain, const float bandwidth, const long sampleRate );
+
+	// Returns whether any of the 'coefficients' (for the current bands) have an effect.
+	bool IsActive( const std::array<Coefficients, kMaxBands>& coefficients ) const;
+
+	// Clears the filter state.
+	void ClearState();
+
+	// Calculates the target coefficients from the current settings.
+	// 'smooth' - whether to smoothly change from the current coefficients, otherwise the target coefficients are applied immediately.
+	void UpdateCoefficients( const bool smooth );
+
+	// Applies the 'band' filter to a group of 'laneCount' (up to 4) channels, starting at 'channel'.
+	void ProcessGroup( float* buffer, const size_t channels, const size_t channel, const size_t laneCount, const size_t band, const size_t frames );
+
+	// Guards the pending settings.
+	std::mutex m_PendingMutex;
+
+	// Pending bands, set from any thread.
+	Bands m_PendingBands;
+
+	// Number of pending bands.
+	size_t m_PendingBandCount = 0;
+
+	// Pending bandwidth, in semitones.
+	float m_PendingBandwidth = 0;
+
+	// Whether the pending settings have EQ enabled.
+	bool m_PendingEnabled = false;
+
+	// Whether the pending settings have changed.
+	bool m_PendingChanged = false;
+
+	// Current bands.
+	Bands m_Bands;
+
+	// Number of current bands.
+	size_t m_BandCount = 0;
+
+	// Current bandwidth, in semitones.
+	float m_Bandwidth = 0;
+
+	// Whether EQ is currently enabled.
+	bool m_Enabled = false;
+
+	// Current number of channels.
+	size_t m_Channels = 0;
+
+	// Current sample rate.
+	long m_SampleRate = 0;
+
+	// Current coefficients, per band.
+	std::array<Coefficients, kMaxBands> m_Current;
+
+	// Target coefficients, per band.
+	std::array<Coefficients, kMaxBands> m_Target;
+
+	// Per sample coefficient increments while smoothing, per band.
+	std::array<Coefficients, kMaxBands> m_Step;
+
+	// The number of samples remaining until the target coefficients are reached.
+	size_t m_SmoothingRemaining = 0;
+
+	// Filter state, per band and channel.
+	alignas( 16 ) std::array<std::array<float, kMaxChannels>, kMaxBands> m_State1;
+	alignas( 16 ) std::array<std::array<float, kMaxChannels>, kMaxBands> m_State2;
+};
@@ -0,0 +1,183 @@
+#include "FileReadBenchmark.h"
+
+#include "MappedFile.h"
+#include "Utility.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+
+// Size of the first block read when opening a file (enough to cover the tags for most files), in bytes.
+constexpr size_t kOpenBlockSize = 64 * 1024;
+
+// Read block size when scanning a file, in bytes.
+constexpr size_t kScanBlockSize = 64 * 1024;
+
+// Stream buffer size, in bytes.
+constexpr size_t kStreamBufferSize = 256 * 1024;
+
+// Pass names.
+constexpr char kColdPass[] = "cold";
+constexpr char kWarmPass[] = "warm";
+
+// Returns a checksum of the 'data', so that all of the data is accessed when scanning a file.
+static uint64_t Checksum( const uint8_t* data, const size_t size, uint64_t checksum )
+{
+	for ( size_t index = 0; index < size; index++ ) {
+		checksum = ( checksum * 31 ) + data[ index ];
+	}
+	return checksum;
+}
+
+FileReadBenchmark::FileReadBenchmark( const Handlers& handlers ) :
+	m_Handlers( handlers )
+{
+}
+
+FileReadBenchmark::~FileReadBenchmark()
+{
+}
+
+bool FileReadBenchmark::Run( const std::wstring& folder, const std::wstring& outputFilename ) const
+{
+	MeasurementsMap measurements;
+	const std::vector<std::wstring> files = GetFiles( folder );
+
+	// For the cold pass, alternate the reader type between files, so that neither reader benefits from the other having read a file.
+	for ( size_t index = 0; index < files.size(); index++ ) {
+		const Reader reader = ( 0 == ( index % 2 ) ) ? Reader::Stream : Reader::Mapped;
+		Measure( files[ index ], reader, measurements[ { GetReaderName( reader ), kColdPass } ] );
+	}
+
+	// For the warm pass, every file is measured with both reader types.
+	for ( const auto& filename : files ) {
+		for ( const auto reader : { Reader::Stream, Reader::Mapped } ) {
+			Measure( filename, reader, measurements[ { GetReaderName( reader ), kWarmPass } ] );
+		}
+	}
+
+	bool success = false;
+	if ( !measurements.empty() ) {
+		success = IsBenchmarkCSV( outputFilename ) ? WriteCSV( measurements, outputFilename ) : WriteJSON( measurements, outputFilename );
+	}
+	return success;
+}
+
+std::vector<std::wstring> FileReadBenchmark::GetFiles( const std::wstring& folder ) const
+{
+	std::vector<std::wstring> files;
+	const std::set<std::wstring> extensions = m_Handlers.GetAllSupportedFileExtensions();
+	std::error_code ec;
+	for ( auto entry = std::filesystem::recursive_directory_iterator( folder, std::filesystem::directory_options::skip_permission_denied, ec ); !ec && ( std::filesystem::recursive_directory_iterator() != entry ); entry.increment( ec ) ) {
+		if ( entry->is_regular_file( ec ) ) {
+			const std::wstring filename = entry->path().wstring();
+			if ( extensions.end() != extensions.find( GetFileExtension( filename ) ) ) {
+				files.push_back( filename );
+			}
+		}
+	}
+	std::sort( files.begin(), files.end() );
+	return files;
+}
+
+void FileReadBenchmark::Measure( const std::wstring& filename, const Reader reader, Measurements& measurements )
+{
+	uint64_t checksum = 0;
+	uint64_t bytesRead = 0;
+	double openLatency = 0;
+	double scanLatency = 0;
+	bool success = false;
+	std::vector<uint8_t> buffer( std::max<size_t>( kOpenBlockSize, kScanBlockSize ) );
+
+	if ( Reader::Mapped == reader ) {
+		try {
+			const LONGLONG startTick = GetBenchmarkTick();
+			MappedFile file( filename, MappedFile::Access::Sequential );
+			const size_t openBytes = file.Read( buffer.data(), kOpenBlockSize );
+			openLatency = GetBenchmarkMilliseconds( startTick, GetBenchmarkTick() );
+			checksum = Checksum( buffer.data(), openBytes, checksum );
+
+			// Scan the rest of the file using zero-copy views.
+			bytesRead = openBytes;
+			for ( auto view = file.GetView( bytesRead, kScanBlockSize ); !view.empty(); view = file.GetView( bytesRead, kScanBlockSize ) ) {
+				checksum = Checksum( view.data(), view.size(), checksum );
+				bytesRead += view.size();
+				file.Prefetch( bytesRead + kScanBlockSize, kScanBlockSize );
+			}
+			scanLatency = GetBenchmarkMilliseconds( startTick, GetBenchmarkTick() );
+			success = true;
+		} catch ( const std::runtime_error& ) {
+		}
+	} else {
+		std::vector<char> streamBuffer( kStreamBufferSize );
+		const LONGLONG startTick = GetBenchmarkTick();
+		std::ifstream stream;
+		stream.rdbuf()->pubsetbuf( streamBuffer.data(), static_cast<std::streamsize>( streamBuffer.size() ) );
+		stream.open( filename, std::ios::binary | std::ios::in );
+		if ( stream.is_open() ) {
+			stream.read( reinterpret_cast<char*>( buffer.data() ), kOpenBlockSize );
+			const size_t openBytes = static_cast<size_t>( stream.gcount() );
+			openLatency = GetBenchmarkMilliseconds( startTick, GetBenchmarkTick() );
+			checksum = Checksum( buffer.data(), openBytes, checksum );
+
+			bytesRead = openBytes;
+			while ( stream.good() ) {
+				stream.read( reinterpret_cast<char*>( buffer.data() ), kScanBlockSize );
+				const size_t blockBytes = static_cast<size_t>( stream.gcount() );
+				checksum = Checksum( buffer.data(), blockBytes, checksum );
+				bytesRead += blockBytes;
+			}
+			scanLatency = GetBenchmarkMilliseconds( startTick, GetBenchmarkTick() );
+			success = true;
+		}
+	}
+
+	if ( success ) {
+		measurements.OpenLatency.push_back( openLatency );
+		measurements.ScanLatency.push_back( scanLatency );
+		if ( scanLatency > 0 ) {
+			measurements.ScanThroughput.push_back( ( static_cast<double>( bytesRead ) / ( 1024 * 1024 ) ) / ( scanLatency / 1000 ) );
+		}
+		measurements.Checksum ^= checksum;
+	}
+}
+
+std::string FileReadBenchmark::GetReaderName( const Reader reader )
+{
+	return ( Reader::Mapped == reader ) ? "mapped" : "stream";
+}
+
+bool FileReadBenchmark::WriteJSON( const MeasurementsMap& measurements, const std::wstring& outputFilename )
+{
+	nlohmann::json document;
+	for ( const auto& [ key, results ] : measurements ) {
+		const auto& [ reader, pass ] = key;
+		nlohmann::json entry;
+		entry[ "open_ms" ] = BenchmarkPercentilesToJSON( results.OpenLatency );
+		entry[ "scan_ms" ] = BenchmarkPercentilesToJSON( results.ScanLatency );
+		entry[ "scan_mb_per_s" ] = BenchmarkPercentilesToJSON( results.ScanThroughput );
+		entry[ "checksum" ] = results.Checksum;
+		document[ reader ][ pass ] = entry;
+	}
+	return WriteBenchmarkJSON( document, outputFilename );
+}
+
+bool FileReadBenchmark::WriteCSV( const MeasurementsMap& measurements, const std::wstring& outputFilename )
+{
+	return WriteBenchmarkCSV( outputFilename, "reader,pass,metric," + GetBenchmarkPercentileHeadings(), [ &measurements ] ( std::ostream& stream )
+	{
+		const auto writeRow = [ &stream ] ( const std::string& reader, const std::string& pass, const std::string& metric, const Values& values )
+		{
+			stream << reader << "," << pass << "," << metric << ",";
+			WriteBenchmarkPercentiles( stream, values );
+			stream << std::endl;
+		};
+
+		for ( const auto& [ key, results ] : measurements ) {
+			const auto& [ reader, pass ] = key;
+			writeRow( reader, pass, "open_ms", results.OpenLatency );
+			writeRow( reader, pass, "scan_ms", results.ScanLatency );
+			writeRow( reader, pass, "scan_mb_per_s", results.ScanThroughput );
+		}
+	} );
+}
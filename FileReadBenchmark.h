@@ -0,0 +1,64 @@
+#pragma once
+
+#include "stdafx.h"
+
+#include "BenchmarkUtility.h"
+#include "Handlers.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+// Compares file open & scan times for memory-mapped files against buffered file streams, over a corpus of media files.
+class FileReadBenchmark
+{
+public:
+	// 'handlers' - media handlers.
+	FileReadBenchmark( const Handlers& handlers );
+
+	virtual ~FileReadBenchmark();
+
+	// Runs the benchmark over all supported files in the 'folder' (including subfolders).
+	// 'outputFilename' - results file, written as CSV if the file has a .csv extension, otherwise as JSON.
+	// Returns whether any results were written.
+	bool Run( const std::wstring& folder, const std::wstring& outputFilename ) const;
+
+private:
+	// A list of measurements.
+	using Values = BenchmarkValues;
+
+	// File reader type.
+	enum class Reader {
+		Stream,
+		Mapped
+	};
+
+	// Measurements for a reader type & pass.
+	struct Measurements {
+		Values OpenLatency;			// Time to open the file & read the first block, in milliseconds.
+		Values ScanLatency;			// Time to read the whole file, in milliseconds.
+		Values ScanThroughput;	// Whole file read throughput, in MB/s.
+		uint64_t Checksum = 0;	// Combined checksum of the data read from all files (which is reported, so that the reads cannot be optimised away).
+	};
+
+	// Maps a reader type & pass name to its measurements.
+	using MeasurementsMap = std::map<std::pair<std::string, std::string>, Measurements>;
+
+	// Returns all the supported files in the 'folder' (including subfolders).
+	std::vector<std::wstring> GetFiles( const std::wstring& folder ) const;
+
+	// Measures the open & scan times for the 'filename' using the 'reader', adding the results to the 'measurements'.
+	static void Measure( const std::wstring& filename, const Reader reader, Measurements& measurements );
+
+	// Returns the name of a 'reader' type.
+	static std::string GetReaderName( const Reader reader );
+
+	// Writes the 'measurements' as JSON to the 'outputFilename', returning whether the file was written.
+	static bool WriteJSON( const MeasurementsMap& measurements, const std::wstring& outputFilename );
+
+	// Writes the 'measurements' as CSV to the 'outputFilename', returning whether the file was written.
+	static bool WriteCSV( const MeasurementsMap& measurements, const std::wstring& outputFilename );
+
+	// Media handlers.
+	const Handlers& m_Handlers;
+};
@@ -2,30 +2,19 @@
 
 #include "Utility.h"
 
-#include "ebur128.h"
+// Read block size, in samples per channel.
+constexpr long kReadBlockSize = 4096;
 
-DWORD WINAPI GainCalculator::CalcThreadProc( LPVOID lpParam )
-{
-	GainCalculator* gainCalculator = reinterpret_cast<GainCalculator*>( lpParam );
-	if ( nullptr != gainCalculator ) {
-		gainCalculator->Handler();
-	}
-	return 0;
-}
-
-GainCalculator::GainCalculator( Library& library, const Handlers& handlers ) :
+GainCalculator::GainCalculator( Library& library, const Handlers& handlers, TaskScheduler& scheduler ) :
 	m_Library( library ),
 	m_Handlers( handlers ),
-	m_AlbumQueue(),
+	m_Scheduler( scheduler ),
+	m_Stopped( false ),
+	m_PendingCount( {} ),
+	m_Albums(),
 	m_Mutex(),
-	m_StopEvent( CreateEvent( NULL /*attributes*/, TRUE /*manualReset*/, FALSE /*initialState*/, L"" /*name*/ ) ),
-	m_WakeEvent( CreateEvent( NULL /*attributes*/, TRUE /*manualReset*/, FALSE /*initialState*/, L"" /*name*/ ) ),
-	m_Thread( NULL ),
-	m_PendingCount( {} )
+	m_TaskGroup()
 {
-	if ( ( NULL != m_StopEvent ) && ( NULL != m_WakeEvent ) ) {
-		m_Thread = CreateThread( NULL /*attributes*/, 0 /*stackSize*/, CalcThreadProc, reinterpret_cast<LPVOID>( this ), 0 /*flags*/, NULL /*threadId*/ );
-	}
 }
 
 GainCalculator::~GainCalculator()
@@ -35,186 +24,145 @@ GainCalculator::~GainCalculator()
 
 void GainCalculator::Calculate( const Playlist::ItemList& items )
 {
+	// Calculations resume after a previous stop.
+	m_Stopped = false;
 	if ( !items.empty() ) {
+		// Each track is analysed as a separate task, so that throughput does not depend on how the tracks are distributed across albums.
 		std::lock_guard<std::mutex> lock( m_Mutex );
 		for ( const auto& item : items ) {
-			AddPending( item );
+			if ( const AlbumPtr album = AddPending( item ); album ) {
+				++m_PendingCount;
+				m_Scheduler.Submit( m_TaskGroup, TaskScheduler::Priority::Analysis, [ this, pendingItem = item, album ] () mutable
+				{
+					CalculateTrack( pendingItem, album );
+				} );
+			}
 		}
-		SetEvent( m_WakeEvent );
 	}
 }
 
 void GainCalculator::Stop()
 {
-	if ( NULL != m_Thread ) {
-		SetEvent( m_StopEvent );
-		WaitForSingleObject( m_Thread, INFINITE );
-		CloseHandle( m_StopEvent );
-		m_StopEvent = NULL;
-		CloseHandle( m_WakeEvent );
-		m_WakeEvent = NULL;
-		CloseHandle( m_Thread );
-		m_Thread = NULL;
+	m_Stopped = true;
+	m_TaskGroup.Cancel();
+	{
+		std::lock_guard<std::mutex> lock( m_Mutex );
+		m_Albums.clear();
 	}
+	m_PendingCount = 0;
 }
 
-void GainCalculator::AddPending( const Playlist::Item& item )
+bool GainCalculator::CanContinue() const
+{
+	return !m_Stopped && !m_TaskGroup.IsCancelled();
+}
+
+GainCalculator::AlbumPtr GainCalculator::AddPending( const Playlist::Item& item )
 {
 	const long channels = item.Info.GetChannels();
 	const long samplerate = item.Info.GetSampleRate();
-	const std::wstring& album = item.Info.GetAlbum();
-	const AlbumKey albumKey = { channels, samplerate, album };
-	auto albumIter = m_AlbumQueue.find( albumKey );
-	if ( m_AlbumQueue.end() == albumIter ) {
-		albumIter = m_AlbumQueue.insert( AlbumMap::value_type( albumKey, Playlist::ItemList() ) ).first;
+	const std::wstring& albumName = item.Info.GetAlbum();
+	const AlbumKey albumKey = { channels, samplerate, albumName };
+	auto albumIter = m_Albums.find( albumKey );
+	if ( m_Albums.end() == albumIter ) {
+		const AlbumPtr album = std::make_shared<Album>();
+		album->Key = albumKey;
+		albumIter = m_Albums.insert( AlbumMap::value_type( albumKey, album ) ).first;
 	}
-	if ( m_AlbumQueue.end() != albumIter ) {
-		bool addTrack = true;
-		Playlist::ItemList& itemList = albumIter->second;
-		for ( auto itemIter = itemList.begin(); addTrack && ( itemList.end() != itemIter ); itemIter++ ) {
-			addTrack = ( item.Info.GetFilename() != itemIter->Info.GetFilename() );
-		}
-		if ( addTrack ) {
-			itemList.push_back( item );
-			++m_PendingCount;
+	AlbumPtr album;
+	if ( m_Albums.end() != albumIter ) {
+		if ( albumIter->second->Filenames.insert( item.Info.GetFilename() ).second ) {
+			album = albumIter->second;
+			++album->Remaining;
 		}
 	}
+	return album;
 }
 
-void GainCalculator::Handler()
+void GainCalculator::CalculateTrack( Playlist::Item& item, const AlbumPtr& album )
 {
-	HANDLE eventHandles[ 2 ] = { m_StopEvent, m_WakeEvent };
-	while ( WaitForMultipleObjects( 2, eventHandles, FALSE /*waitAll*/, INFINITE ) != WAIT_OBJECT_0 ) {
-		AlbumKey albumKey = {};
-		Playlist::ItemList pendingItems;
-		{
-			std::lock_guard<std::mutex> lock( m_Mutex );
-			const auto iter = m_AlbumQueue.begin();
-			if ( m_AlbumQueue.end() == iter ) {
-				ResetEvent( m_WakeEvent );
-			} else {
-				albumKey = iter->first;
-				pendingItems = iter->second;
-				m_AlbumQueue.erase( iter );
+	if ( CanContinue() ) {
+		Decoder::Ptr decoder = OpenDecoder( item );
+		if ( decoder ) {
+			const long channels = decoder->GetChannels();
+			const auto analyser = std::make_shared<TrackAnalyser>( channels, decoder->GetSampleRate(), TrackAnalyser::GetAllAnalysers() );
+			std::vector<float> buffer( kReadBlockSize * channels );
+
+			bool success = true;
+			long samplesRead = decoder->Read( &buffer[ 0 ], kReadBlockSize );
+			while ( success && ( samplesRead > 0 ) && CanContinue() ) {
+				success = analyser->Add( &buffer[ 0 ], static_cast<size_t>( samplesRead ) );
+				samplesRead = decoder->Read( &buffer[ 0 ], kReadBlockSize );
 			}
-		}
-
-		if ( !pendingItems.empty() ) {
-			std::mutex itemMutex;
-			std::mutex r128StatesMutex;
+			decoder.reset();
 
-			std::vector<ebur128_state*> r128States;
-			r128States.reserve( pendingItems.size() );
-
-			Decoder::CanContinue canContinue( [ stopEvent = m_StopEvent ] ()
-			{
-				return ( WAIT_OBJECT_0 != WaitForSingleObject( stopEvent, 0 ) );
-			} );
+			if ( success && CanContinue() ) {
+				OnTrackCalculated( item, analyser->GetResults() );
+				std::lock_guard<std::mutex> lock( album->Mutex );
+				album->ProcessedItems.push_back( item );
+				album->Analysers.push_back( analyser );
+			}
+		}
+	}
 
-			// Update track gain for all items.
-			Playlist::ItemList processedItems;
-			const size_t threadCount = std::min<size_t>( pendingItems.size(), std::max<size_t>( 1, std::thread::hardware_concurrency() ) );
-			std::list<std::thread> threads;
-			for ( size_t threadIndex = 0; threadIndex < threadCount; threadIndex++ ) {
-				threads.push_back( std::thread( [ &pendingItems, &processedItems, &itemMutex, &r128States, &r128StatesMutex, canContinue, this ]() 
-				{
-					Playlist::Item item = {};
-					{
-						std::lock_guard<std::mutex> lock( itemMutex );
-						if ( !pendingItems.empty() ) {
-							item = pendingItems.front();
-							pendingItems.pop_front();
-						}
-					}
-
-					while ( 0 != item.ID ) {					
-						Decoder::Ptr decoder = OpenDecoder( item );
-						if ( decoder ) {
-							const unsigned int channels = static_cast<unsigned int>( decoder->GetChannels() );
-							const unsigned long samplerate = static_cast<unsigned long>( decoder->GetSampleRate() );
-							ebur128_state* r128State = ebur128_init( channels, samplerate, EBUR128_MODE_I );
-							if ( nullptr != r128State ) {
-								const long sampleSize = 4096;
-								std::vector<float> buffer( sampleSize * channels );
-
-								int errorState = EBUR128_SUCCESS;
-								long samplesRead = decoder->Read( &buffer[ 0 ], sampleSize );
-								while ( ( EBUR128_SUCCESS == errorState ) && ( samplesRead > 0 ) && canContinue() ) {
-									errorState = ebur128_add_frames_float( r128State, &buffer[ 0 ], static_cast<size_t>( samplesRead ) );
-									samplesRead = decoder->Read( &buffer[ 0 ], sampleSize );
-								}
-								decoder.reset();
-
-								if ( ( EBUR128_SUCCESS == errorState ) && canContinue() ) {
-									double loudness = 0;
-									errorState = ebur128_loudness_global( r128State, &loudness );
-									if ( EBUR128_SUCCESS == errorState ) {
-										const float trackGain = LOUDNESS_REFERENCE - static_cast<float>( loudness );
-										if ( trackGain != item.Info.GetGainTrack() ) {
-											MediaInfo previousMediaInfo( item.Info );
-											item.Info.SetGainTrack( trackGain );
-											m_Library.UpdateMediaTags( previousMediaInfo, item.Info );
-
-											for ( const auto& duplicate : item.Duplicates ) {
-												previousMediaInfo.SetFilename( duplicate );
-												MediaInfo updatedMediaInfo( item.Info );
-												updatedMediaInfo.SetFilename( duplicate );
-												m_Library.UpdateMediaTags( previousMediaInfo, updatedMediaInfo );
-											}
-										}
-										std::lock_guard<std::mutex> itemLock( itemMutex );
-										processedItems.push_back( item );
-										std::lock_guard<std::mutex> lock( r128StatesMutex );
-										r128States.push_back( r128State );
-									}
-								}
-							}
-						}
-
-						item = {};
-						if ( canContinue() ) {
-							std::lock_guard<std::mutex> lock( itemMutex );
-							if ( !pendingItems.empty() ) {
-								item = pendingItems.front();
-								pendingItems.pop_front();
-							}
-						}
-
-						--m_PendingCount;
-					}
-				}	) );
+	// The album gain is finalised by whichever task analyses the last track of the album.
+	// The album is no longer current once finished, so any tracks added to the album afterwards are calculated as a new album.
+	bool albumFinished = false;
+	{
+		std::lock_guard<std::mutex> lock( m_Mutex );
+		albumFinished = ( 0 == --album->Remaining );
+		if ( albumFinished ) {
+			if ( const auto albumIter = m_Albums.find( album->Key ); ( m_Albums.end() != albumIter ) && ( album == albumIter->second ) ) {
+				m_Albums.erase( albumIter );
 			}
-			for ( auto& thread : threads ) {
-				thread.join();
+		}
+	}
+	if ( albumFinished ) {
+		const std::wstring& albumName = std::get< 2 >( album->Key );
+		if ( CanContinue() && !albumName.empty() ) {
+			if ( const auto albumGain = TrackAnalyser::GetAlbumGain( album->Analysers ); albumGain.has_value() ) {
+				OnAlbumCalculated( album->ProcessedItems, *albumGain );
 			}
+		}
+		album->Analysers.clear();
+	}
+
+	--m_PendingCount;
+}
 
-			const std::wstring& album = std::get< 2 >( albumKey );
-			if ( canContinue() && !album.empty() ) {
-				// Update album gain for all items.
-				double loudness = 0;
-				int errorState = ebur128_loudness_global_multiple( &r128States[ 0 ], r128States.size(), &loudness );
-				if ( EBUR128_SUCCESS == errorState ) {
-					const float albumGain = LOUDNESS_REFERENCE - static_cast<float>( loudness );
-					for ( auto item = processedItems.begin(); ( processedItems.end() != item ) && canContinue(); item++ ) {
-						if ( albumGain != item->Info.GetGainAlbum() ) {
-							MediaInfo previousMediaInfo( item->Info );
-							item->Info.SetGainAlbum( albumGain );
-							m_Library.UpdateMediaTags( previousMediaInfo, item->Info );
-
-							for ( const auto& duplicate : item->Duplicates ) {
-								previousMediaInfo.SetFilename( duplicate );
-								MediaInfo updatedMediaInfo( item->Info );
-								updatedMediaInfo.SetFilename( duplicate );
-								m_Library.UpdateMediaTags( previousMediaInfo, updatedMediaInfo );
-							}
-						}
-					}
-				}
+void GainCalculator::OnTrackCalculated( Playlist::Item& item, const TrackAnalyser::Results& results )
+{
+	// Store all analysis results along the way, so that files do not need to be decoded again.
+	m_Library.SetAnalysis( item.Info, results );
+	if ( const auto trackGain = results.TrackGain; trackGain.has_value() ) {
+		if ( trackGain != item.Info.GetGainTrack() ) {
+			MediaInfo previousMediaInfo( item.Info );
+			item.Info.SetGainTrack( trackGain );
+			m_Library.UpdateMediaTags( previousMediaInfo, item.Info );
+
+			for ( const auto& duplicate : item.Duplicates ) {
+				previousMediaInfo.SetFilename( duplicate );
+				MediaInfo updatedMediaInfo( item.Info );
+				updatedMediaInfo.SetFilename( duplicate );
+				m_Library.UpdateMediaTags( previousMediaInfo, updatedMediaInfo );
 			}
+		}
+	}
+}
 
-			for ( const auto& state : r128States ) {
-				ebur128_state* r128State = state;
-				ebur128_destroy( &r128State );
+void GainCalculator::OnAlbumCalculated( Playlist::ItemList& items, const float albumGain )
+{
+	for ( auto item = items.begin(); ( items.end() != item ) && CanContinue(); item++ ) {
+		if ( albumGain != item->Info.GetGainAlbum() ) {
+			MediaInfo previousMediaInfo( item->Info );
+			item->Info.SetGainAlbum( albumGain );
+			m_Library.UpdateMediaTags( previousMediaInfo, item->Info );
+
+			for ( const auto& duplicate : item->Duplicates ) {
+				previousMediaInfo.SetFilename( duplicate );
+				MediaInfo updatedMediaInfo( item->Info );
+				updatedMediaInfo.SetFilename( duplicate );
+				m_Library.UpdateMediaTags( previousMediaInfo, updatedMediaInfo );
 			}
 		}
 	}
@@ -240,15 +188,3 @@ Decoder::Ptr GainCalculator::OpenDecoder( const Playlist::Item& item ) const
 	}
 	return decoder;
 }
-
-std::optional<float> GainCalculator::CalculateTrackGain( const std::wstring& filename, const Handlers& handlers, Decoder::CanContinue canContinue )
-{
-	std::optional<float> gain;
-	if ( ( nullptr != canContinue ) && !IsURL( filename ) ) {
-		const Decoder::Ptr decoder = handlers.OpenDecoder( filename );
-		if ( decoder ) {
-			gain = decoder->CalculateTrackGain( canContinue );
-		}
-	}
-	return gain;
-}
@@ -3,54 +3,77 @@
 #include "Playlist.h"
 #include "Settings.h"
 #include "Decoder.h"
+#include "TaskScheduler.h"
+#include "TrackAnalyser.h"
 
 #include <atomic>
 #include <functional>
+#include <map>
+#include <mutex>
+#include <set>
 #include <tuple>
 
+// Calculates gain values in the background, with track analysis for all albums running in parallel on the task scheduler.
 class GainCalculator
 {
 public:
 	// 'library' - media library.
 	// 'handlers' - media handlers.
-	GainCalculator( Library& library, const Handlers& handlers );
+	// 'scheduler' - task scheduler on which to run track analysis.
+	GainCalculator( Library& library, const Handlers& handlers, TaskScheduler& scheduler = TaskScheduler::GetBackground() );
 
+	// Derived classes must call Stop() on destruction.
 	virtual ~GainCalculator();
 
-	// Calculates track gain for a single file.
-	// 'filename' - media filename.
-	// 'handlers' - media handlers.
-	// 'canContinue' - callback which returns whether the calculation can continue.
-	// Returns the track gain, or nullopt if the calculation failed or was cancelled.
-	static std::optional<float> CalculateTrackGain( const std::wstring& filename, const Handlers& handlers, Decoder::CanContinue canContinue );
-
 	// Calculates gain values for the playlist 'items'.
+	// Items which belong to an album that is still being analysed are added to that album, so that the album gain covers all of its tracks.
 	void Calculate( const Playlist::ItemList& items );
 
-	// Stops any pending gain calculations.
+	// Stops any pending gain calculations (calculations resume with the next call to Calculate).
 	void Stop();
 
 	// Returns the number of gain calculations pending.
 	int GetPendingCount() const;
 
+protected:
+	// Returns a decoder for the 'item', or nullptr if a decoder could not be opened.
+	virtual Decoder::Ptr OpenDecoder( const Playlist::Item& item ) const;
+
+	// Called when the analysis 'results' are available for an 'item', to store the results & update the track gain.
+	virtual void OnTrackCalculated( Playlist::Item& item, const TrackAnalyser::Results& results );
+
+	// Called when the 'albumGain' is available for all the 'items' in an album, to update the album gain.
+	virtual void OnAlbumCalculated( Playlist::ItemList& items, const float albumGain );
+
+	// Returns whether gain calculations can continue.
+	bool CanContinue() const;
+
 private:
 	// Gain album key.
 	typedef std::tuple<long,long,std::wstring> AlbumKey;
 
-	// Associates an album key with a list of items.
-	typedef std::map<AlbumKey,Playlist::ItemList> AlbumMap;
+	// Album state, shared between the track analysis tasks for an album.
+	struct Album {
+		AlbumKey Key;																// Album key.
+		size_t Remaining = 0;												// Number of tracks still to be analysed (guarded by the calculator mutex).
+		std::set<std::wstring> Filenames;						// File names of all the tracks added to the album (guarded by the calculator mutex).
+		Playlist::ItemList ProcessedItems;					// Tracks which have been analysed.
+		std::vector<TrackAnalyser::Ptr> Analysers;	// Track analysers for the processed items.
+		std::mutex Mutex;														// Album state mutex.
+	};
 
-	// Calculation thread procedure.
-	static DWORD WINAPI CalcThreadProc( LPVOID lpParam );
+	// Album state pointer type.
+	using AlbumPtr = std::shared_ptr<Album>;
 
-	// Calculation thread handler.
-	void Handler();
+	// Associates an album key with the album state.
+	typedef std::map<AlbumKey,AlbumPtr> AlbumMap;
 
-	// Adds an 'item' to the queue of pending tasks.
-	void AddPending( const Playlist::Item& item );
+	// Adds an 'item' to the album which is currently being analysed (or to a new album), returning the album, or nullptr if the item has already been added.
+	// The calculator mutex must be held by the caller.
+	AlbumPtr AddPending( const Playlist::Item& item );
 
-	// Returns a decoder for the 'item', or nullptr if a decoder could not be opened.
-	Decoder::Ptr OpenDecoder( const Playlist::Item& item ) const;
+	// Calculates the track gain for an 'item', and the album gain if it is the last track of the 'album' to be analysed.
+	void CalculateTrack( Playlist::Item& item, const AlbumPtr& album );
 
 	// Media library.
 	Library& m_Library;
@@ -58,21 +81,21 @@ private:
 	// Media handlers.
 	const Handlers& m_Handlers;
 
-	// The task queue.
-	AlbumMap m_AlbumQueue;
+	// Task scheduler.
+	TaskScheduler& m_Scheduler;
 
-	// The mutex for the task queue.
-	std::mutex m_Mutex;
+	// Indicates whether gain calculations have been stopped.
+	std::atomic<bool> m_Stopped;
 
-	// Handle to stop the calculation thread.
-	HANDLE m_StopEvent;
+	// Number of gain calculations pending.
+	std::atomic<int> m_PendingCount;
 
-	// Handle to wake the calculation thread.
-	HANDLE m_WakeEvent;
+	// Albums which are currently being analysed.
+	AlbumMap m_Albums;
 
-	// Calculation thread.
-	HANDLE m_Thread;
+	// Album map mutex.
+	std::mutex m_Mutex;
 
-	// Number of gain calculations pending.
-	std::atomic<int> m_PendingCount;
+	// Track analysis tasks.
+	TaskScheduler::Group m_TaskGroup;
 };
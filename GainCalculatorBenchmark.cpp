@@ -0,0 +1,208 @@
+#include "GainCalculatorBenchmark.h"
+
+#include "Database.h"
+#include "GainCalculator.h"
+#include "Library.h"
+#include "TaskScheduler.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <thread>
+
+// Album distributions to measure, as the number of tracks per album (from all singles, through to full albums).
+constexpr std::array kTracksPerAlbum = { 1l, 2l, 12l };
+
+// Total number of tracks for each measurement (which should be a multiple of each album size).
+constexpr long kTrackCount = 48;
+
+// Synthetic track duration, in seconds.
+constexpr float kTrackDuration = 10.0f;
+
+// Synthetic track sample rate.
+constexpr long kSampleRate = 44100;
+
+// Synthetic track channels.
+constexpr long kChannels = 2;
+
+// Interval at which to check whether all calculations have finished, in milliseconds.
+constexpr DWORD kPollInterval = 1;
+
+// Decoder which generates a synthetic track (a tone with added noise), so that measurements do not depend on file I/O or codec performance.
+class SyntheticDecoder : public Decoder
+{
+public:
+	// 'seed' - random seed, so that each track is different.
+	SyntheticDecoder( const uint32_t seed ) :
+		Decoder(),
+		m_Position( 0 ),
+		m_TotalSamples( static_cast<long long>( kTrackDuration * kSampleRate ) ),
+		m_Random( seed ),
+		m_Frequency( 200.0 + ( seed % 16 ) * 100.0 )
+	{
+		SetDuration( kTrackDuration );
+		SetSampleRate( kSampleRate );
+		SetChannels( kChannels );
+		SetBPS( 16 );
+	}
+
+	// Reads sample data.
+	long Read( float* buffer, const long sampleCount ) override
+	{
+		constexpr double kPi = 3.14159265358979323846;
+		const long samplesToRead = static_cast<long>( std::min<long long>( sampleCount, m_TotalSamples - m_Position ) );
+		for ( long sample = 0; sample < samplesToRead; sample++, m_Position++ ) {
+			const float tone = static_cast<float>( 0.25 * sin( 2 * kPi * m_Frequency * static_cast<double>( m_Position ) / kSampleRate ) );
+			for ( long channel = 0; channel < kChannels; channel++ ) {
+				m_Random = m_Random * 1664525u + 1013904223u;
+				const float noise = static_cast<float>( static_cast<int32_t>( m_Random ) ) / 2147483648.0f;
+				*buffer++ = tone + 0.05f * noise;
+			}
+		}
+		return samplesToRead;
+	}
+
+	// Seeks to a 'position' in the stream, in seconds.
+	float Seek( const float position ) override
+	{
+		m_Position = std::clamp( static_cast<long long>( position * kSampleRate ), 0ll, m_TotalSamples );
+		return static_cast<float>( m_Position ) / kSampleRate;
+	}
+
+private:
+	// Current position, in samples per channel.
+	long long m_Position;
+
+	// Total number of samples per channel.
+	const long long m_TotalSamples;
+
+	// Random number generator state.
+	uint32_t m_Random;
+
+	// Tone frequency, in Hz.
+	const double m_Frequency;
+};
+
+// Gain calculator which uses synthetic decoders, and does not store any results.
+class BenchmarkGainCalculator : public GainCalculator
+{
+public:
+	// 'library' - media library.
+	// 'handlers' - media handlers.
+	// 'scheduler' - task scheduler on which to run track analysis.
+	BenchmarkGainCalculator( Library& library, const Handlers& handlers, TaskScheduler& scheduler ) :
+		GainCalculator( library, handlers, scheduler )
+	{
+	}
+
+	~BenchmarkGainCalculator() override
+	{
+		Stop();
+	}
+
+protected:
+	// Returns a synthetic decoder for the 'item'.
+	Decoder::Ptr OpenDecoder( const Playlist::Item& item ) const override
+	{
+		return std::make_shared<SyntheticDecoder>( static_cast<uint32_t>( item.ID ) );
+	}
+
+	// Discards the track analysis results.
+	void OnTrackCalculated( Playlist::Item& /*item*/, const TrackAnalyser::Results& /*results*/ ) override
+	{
+	}
+
+	// Discards the album gain.
+	void OnAlbumCalculated( Playlist::ItemList& /*items*/, const float /*albumGain*/ ) override
+	{
+	}
+};
+
+GainCalculatorBenchmark::GainCalculatorBenchmark( const Handlers& handlers ) :
+	m_Handlers( handlers )
+{
+}
+
+GainCalculatorBenchmark::~GainCalculatorBenchmark()
+{
+}
+
+bool GainCalculatorBenchmark::Run( const std::wstring& outputFilename ) const
+{
+	Measurements measurements;
+	for ( const auto tracksPerAlbum : kTracksPerAlbum ) {
+		for ( const auto threadCount : GetThreadCounts() ) {
+			measurements.push_back( Measure( tracksPerAlbum, threadCount ) );
+		}
+	}
+	const bool success = IsBenchmarkCSV( outputFilename ) ? WriteCSV( measurements, outputFilename ) : WriteJSON( measurements, outputFilename );
+	return success;
+}
+
+std::vector<size_t> GainCalculatorBenchmark::GetThreadCounts()
+{
+	std::vector<size_t> threadCounts;
+	const size_t hardwareThreads = std::max<size_t>( 1, std::thread::hardware_concurrency() );
+	for ( size_t threadCount = 1; threadCount < hardwareThreads; threadCount *= 2 ) {
+		threadCounts.push_back( threadCount );
+	}
+	threadCounts.push_back( hardwareThreads );
+	return threadCounts;
+}
+
+GainCalculatorBenchmark::Measurement GainCalculatorBenchmark::Measure( const long tracksPerAlbum, const size_t threadCount ) const
+{
+	Measurement measurement;
+	measurement.TracksPerAlbum = tracksPerAlbum;
+	measurement.ThreadCount = threadCount;
+
+	Playlist::ItemList items;
+	for ( long track = 0; track < kTrackCount; track++ ) {
+		Playlist::Item item;
+		item.ID = 1 + track;
+		item.Info.SetFilename( L"synthetic" + std::to_wstring( item.ID ) );
+		item.Info.SetAlbum( L"album" + std::to_wstring( track / tracksPerAlbum ) );
+		item.Info.SetSampleRate( kSampleRate );
+		item.Info.SetChannels( kChannels );
+		item.Info.SetDuration( kTrackDuration );
+		items.push_back( item );
+	}
+
+	Database database( {} /*filename*/, Database::Mode::Memory );
+	Library library( database, m_Handlers );
+	TaskScheduler scheduler( threadCount );
+	BenchmarkGainCalculator gainCalculator( library, m_Handlers, scheduler );
+
+	const LONGLONG startTick = GetBenchmarkTick();
+	gainCalculator.Calculate( items );
+	while ( gainCalculator.GetPendingCount() > 0 ) {
+		Sleep( kPollInterval );
+	}
+	const double seconds = GetBenchmarkSeconds( startTick, GetBenchmarkTick() );
+
+	if ( seconds > 0 ) {
+		measurement.TracksPerSecond = kTrackCount / seconds;
+	}
+	return measurement;
+}
+
+bool GainCalculatorBenchmark::WriteJSON( const Measurements& measurements, const std::wstring& outputFilename )
+{
+	nlohmann::json document;
+	for ( const auto& measurement : measurements ) {
+		document[ std::to_string( measurement.TracksPerAlbum ) + "_tracks_per_album" ][ std::to_string( measurement.ThreadCount ) + "_threads" ][ "tracks_per_second" ] = measurement.TracksPerSecond;
+	}
+
+	return WriteBenchmarkJSON( document, outputFilename );
+}
+
+bool GainCalculatorBenchmark::WriteCSV( const Measurements& measurements, const std::wstring& outputFilename )
+{
+	return WriteBenchmarkCSV( outputFilename, "tracks_per_album,threads,tracks_per_second", [ &measurements ] ( std::ostream& stream )
+	{
+		for ( const auto& measurement : measurements ) {
+			stream << measurement.TracksPerAlbum << "," << measurement.ThreadCount << "," << measurement.TracksPerSecond << std::endl;
+		}
+	} );
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "stdafx.h"
+
+#include "BenchmarkUtility.h"
+#include "Handlers.h"
+
+#include <string>
+#include <vector>
+
+// Measures gain calculator throughput against the number of worker threads, using synthetic decoders, for a range of album distributions.
+class GainCalculatorBenchmark
+{
+public:
+	// 'handlers' - media handlers.
+	GainCalculatorBenchmark( const Handlers& handlers );
+
+	virtual ~GainCalculatorBenchmark();
+
+	// Runs the benchmark.
+	// 'outputFilename' - results file, written as CSV if the file has a .csv extension, otherwise as JSON.
+	// Returns whether the results were written.
+	bool Run( const std::wstring& outputFilename ) const;
+
+private:
+	// Measurement for an album distribution & thread count.
+	struct Measurement {
+		long TracksPerAlbum = 0;			// Number of tracks per album.
+		size_t ThreadCount = 0;				// Number of worker threads.
+		double TracksPerSecond = 0;		// Throughput, in tracks per second.
+	};
+
+	// A list of measurements.
+	using Measurements = std::vector<Measurement>;
+
+	// Returns the worker thread counts to measure.
+	static std::vector<size_t> GetThreadCounts();
+
+	// Measures the gain calculator throughput for albums of 'tracksPerAlbum' tracks, using 'threadCount' worker threads.
+	Measurement Measure( const long tracksPerAlbum, const size_t threadCount ) const;
+
+	// Writes the 'measurements' as JSON to the 'outputFilename', returning whether the file was written.
+	static bool WriteJSON( const Measurements& measurements, const std::wstring& outputFilename );
+
+	// Writes the 'measurements' as CSV to the 'outputFilename', returning whether the file was written.
+	static bool WriteCSV( const Measurements& measurements, const std::wstring& outputFilename );
+
+	// Media handlers.
+	const Handlers& m_Handlers;
+};
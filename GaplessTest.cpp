@@ -0,0 +1,374 @@
+#include "GaplessTest.h"
+
+#include "Database.h"
+#include "DecoderGapless.h"
+#include "Handlers.h"
+#include "Library.h"
+#include "Output.h"
+#include "Playlist.h"
+#include "SeekIndexer.h"
+#include "Settings.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <set>
+
+// Read block sizes to check, in frames (from single frames, through to larger than most tracks).
+constexpr std::array kBlockSizes = { 1l, 441l, 4096l, 16384l };
+
+// Encoder delays to check, in frames (none, MP3 decoder delay, and the typical AAC encoder delay).
+constexpr std::array kEncoderDelays = { 0l, 529l, 2112l };
+
+// Encoder paddings to check, in frames.
+constexpr std::array kEncoderPaddings = { 0l, 1l, 1024l };
+
+// Album track lengths, in frames, including tracks which are shorter than a read block and which are not a multiple of any block size.
+constexpr std::array kTrackLengths = { 44117ll, 1ll, 4095ll, 4097ll, 575ll, 22050ll };
+
+// Synthetic album sample rate.
+constexpr long kSampleRate = 44100;
+
+// Synthetic album channels.
+constexpr long kChannels = 2;
+
+// The value of encoder delay & padding samples, which should never be output.
+constexpr float kEncoderSample = 1.0f;
+
+// Returns the sample for a 'frame' & 'channel' of the synthetic album (a tone with added noise, so that every sample is distinct).
+static float GetAlbumSample( const long long frame, const long channel )
+{
+	constexpr double kPi = 3.14159265358979323846;
+	const float tone = static_cast<float>( 0.25 * sin( 2 * kPi * 440.0 * static_cast<double>( frame ) / kSampleRate + channel ) );
+	uint32_t hash = static_cast<uint32_t>( frame * kChannels + channel ) * 2654435761u;
+	hash ^= hash >> 16;
+	const float noise = static_cast<float>( static_cast<int32_t>( hash ) ) / 2147483648.0f;
+	return tone + 0.05f * noise;
+}
+
+// Decoder for a synthetic album track, which has encoder delay & padding in the same way as an encoded file.
+class SyntheticTrackDecoder : public Decoder
+{
+public:
+	// 'albumFrame' - position of the track in the album, in frames.
+	// 'frames' - track length, in frames.
+	// 'encoderDelay' - number of encoder delay frames before the track.
+	// 'encoderPadding' - number of encoder padding frames after the track.
+	SyntheticTrackDecoder( const long long albumFrame, const long long frames, const long encoderDelay, const long encoderPadding ) :
+		Decoder(),
+		m_AlbumFrame( albumFrame ),
+		m_Frames( frames ),
+		m_EncoderDelay( encoderDelay ),
+		m_TotalFrames( encoderDelay + frames + encoderPadding ),
+		m_Position( 0 )
+	{
+		SetDuration( static_cast<float>( static_cast<double>( m_TotalFrames ) / kSampleRate ) );
+		SetSampleRate( kSampleRate );
+		SetChannels( kChannels );
+		SetBPS( 16 );
+	}
+
+	// Reads sample data.
+	long Read( float* buffer, const long sampleCount ) override
+	{
+		const long samplesToRead = static_cast<long>( std::min<long long>( sampleCount, m_TotalFrames - m_Position ) );
+		for ( long sample = 0; sample < samplesToRead; sample++, m_Position++ ) {
+			const long long trackFrame = m_Position - m_EncoderDelay;
+			for ( long channel = 0; channel < kChannels; channel++ ) {
+				*buffer++ = ( ( trackFrame >= 0 ) && ( trackFrame < m_Frames ) ) ? GetAlbumSample( m_AlbumFrame + trackFrame, channel ) : kEncoderSample;
+			}
+		}
+		return samplesToRead;
+	}
+
+	// Seeks to a 'position' in the stream, in seconds.
+	float Seek( const float position ) override
+	{
+		m_Position = std::clamp( std::llround( static_cast<double>( position ) * kSampleRate ), 0ll, m_TotalFrames );
+		return static_cast<float>( static_cast<double>( m_Position ) / kSampleRate );
+	}
+
+private:
+	// Position of the track in the album, in frames.
+	const long long m_AlbumFrame;
+
+	// Track length, in frames.
+	const long long m_Frames;
+
+	// Number of encoder delay frames.
+	const long long m_EncoderDelay;
+
+	// Total number of frames in the stream, including encoder delay & padding.
+	const long long m_TotalFrames;
+
+	// Current position, in frames.
+	long long m_Position;
+};
+
+// Handler which opens the synthetic album tracks, so that they can be played through the output.
+class SyntheticTrackHandler : public Handler
+{
+public:
+	// 'trackStarts' - position of each track in the album, in frames.
+	// 'encoderDelay' - number of encoder delay frames before each track.
+	// 'encoderPadding' - number of encoder padding frames after each track.
+	SyntheticTrackHandler( const std::vector<long long>& trackStarts, const long encoderDelay, const long encoderPadding ) :
+		Handler(),
+		m_TrackStarts( trackStarts ),
+		m_EncoderDelay( encoderDelay ),
+		m_EncoderPadding( encoderPadding )
+	{
+	}
+
+	// Returns the filename of the album 'track'.
+	static std::wstring GetFilename( const size_t track )
+	{
+		return L"track" + std::to_wstring( 1 + track ) + L"." + kFileExtension;
+	}
+
+	std::wstring GetDescription() const override
+	{
+		return L"Gapless test";
+	}
+
+	std::set<std::wstring> GetSupportedFileExtensions() const override
+	{
+		return { kFileExtension };
+	}
+
+	bool GetTags( const std::wstring& /*filename*/, Tags& /*tags*/ ) const override
+	{
+		return false;
+	}
+
+	bool SetTags( const std::wstring& /*filename*/, const Tags& /*tags*/ ) const override
+	{
+		return false;
+	}
+
+	Decoder::Ptr OpenDecoder( const std::wstring& filename ) const override
+	{
+		Decoder::Ptr decoder;
+		for ( size_t track = 0; !decoder && ( track < m_TrackStarts.size() ); track++ ) {
+			if ( GetFilename( track ) == filename ) {
+				const auto trackDecoder = std::make_shared<SyntheticTrackDecoder>( m_TrackStarts[ track ], kTrackLengths[ track ], m_EncoderDelay, m_EncoderPadding );
+				decoder = std::make_shared<DecoderGapless>( trackDecoder, m_EncoderDelay, kTrackLengths[ track ] );
+			}
+		}
+		return decoder;
+	}
+
+	Encoder::Ptr OpenEncoder() const override
+	{
+		return nullptr;
+	}
+
+	bool IsDecoder() const override
+	{
+		return true;
+	}
+
+	bool IsEncoder() const override
+	{
+		return false;
+	}
+
+	bool CanConfigureEncoder() const override
+	{
+		return false;
+	}
+
+	bool ConfigureEncoder( const HINSTANCE /*instance*/, const HWND /*parent*/, std::string& /*settings*/ ) const override
+	{
+		return false;
+	}
+
+	void SettingsChanged( Settings& /*settings*/ ) override
+	{
+	}
+
+private:
+	// File extension for the synthetic album tracks.
+	static constexpr wchar_t kFileExtension[] = L"gaplesstest";
+
+	// Position of each track in the album, in frames.
+	const std::vector<long long> m_TrackStarts;
+
+	// Number of encoder delay frames.
+	const long m_EncoderDelay;
+
+	// Number of encoder padding frames.
+	const long m_EncoderPadding;
+};
+
+GaplessTest::GaplessTest( const HINSTANCE instance ) :
+	m_hInst( instance )
+{
+}
+
+GaplessTest::~GaplessTest()
+{
+}
+
+bool GaplessTest::Run( const std::wstring& outputFilename ) const
+{
+	Results results;
+	bool passed = true;
+	for ( const auto blockSize : kBlockSizes ) {
+		for ( const auto encoderDelay : kEncoderDelays ) {
+			for ( const auto encoderPadding : kEncoderPaddings ) {
+				results.push_back( Check( blockSize, encoderDelay, encoderPadding ) );
+				passed = passed && results.back().Passed;
+			}
+		}
+	}
+
+	const bool success = IsBenchmarkCSV( outputFilename ) ? WriteCSV( results, outputFilename ) : WriteJSON( results, outputFilename );
+	return passed && success;
+}
+
+GaplessTest::Result GaplessTest::Check( const long blockSize, const long encoderDelay, const long encoderPadding ) const
+{
+	Result result;
+	result.BlockSize = blockSize;
+	result.EncoderDelay = encoderDelay;
+	result.EncoderPadding = encoderPadding;
+
+	std::vector<long long> trackStarts;
+	long long albumFrames = 0;
+	for ( const auto trackLength : kTrackLengths ) {
+		trackStarts.push_back( albumFrames );
+		albumFrames += trackLength;
+	}
+
+	Handlers handlers;
+	handlers.AddHandler( std::make_shared<SyntheticTrackHandler>( trackStarts, encoderDelay, encoderPadding ) );
+	Database database( {} /*filename*/, Database::Mode::Memory );
+	Library library( database, handlers );
+	Settings settings( database, library );
+
+	// Read directly from the decoders, without any processing which would alter the output samples.
+	settings.SetOutputSettings( {} /*deviceName*/, Settings::OutputMode::Standard );
+	settings.SetGainSettings( Settings::GainMode::Disabled, Settings::LimitMode::None, 0 /*preamp*/ );
+	long decodeAheadMemoryLimit = 0;
+	bool decodeAhead = false;
+	settings.GetDecodeAheadSettings( decodeAhead, decodeAheadMemoryLimit );
+	settings.SetDecodeAheadSettings( false /*enable*/, decodeAheadMemoryLimit );
+	settings.SetPlaybackSettings( false /*randomPlay*/, false /*repeatTrack*/, false /*repeatPlaylist*/, false /*crossfade*/ );
+	Settings::EQ eq = settings.GetEQSettings();
+	eq.Enabled = false;
+	settings.SetEQSettings( eq );
+
+	const Playlist::Ptr playlist = std::make_shared<Playlist>( library, Playlist::Type::User );
+	Playlist::ItemList items;
+	for ( size_t track = 0; track < kTrackLengths.size(); track++ ) {
+		MediaInfo mediaInfo( SyntheticTrackHandler::GetFilename( track ) );
+		items.push_back( playlist->AddItem( mediaInfo ) );
+	}
+
+	SeekIndexer seekIndexer( library, handlers );
+	Output output( m_hInst, nullptr /*hwnd*/, handlers, settings, seekIndexer );
+
+	// Start decoding the first track in the same way as the output, but without creating an output stream, so that the sample data can be read directly.
+	// The switch to each following track is then made by the output itself, when the current track has no more data.
+	Playlist::Item firstItem = items.front();
+	output.m_Playlist = playlist;
+	output.m_DecoderStream = output.OpenOutputDecoder( firstItem, true /*usePreloadedDecoder*/ );
+	if ( output.m_DecoderStream ) {
+		output.m_CurrentItemDecoding = firstItem;
+		output.m_OutputQueue.Update( [ queueItem = std::make_shared<const Playlist::Item>( firstItem ) ] ( Output::Queue& queue )
+			{
+				queue.push_back( { queueItem, 0, 0 } );
+			}
+		);
+	}
+
+	std::vector<float> buffer( static_cast<size_t>( blockSize * kChannels ) );
+	const DWORD byteCount = static_cast<DWORD>( buffer.size() * 4 );
+	const long long maxReads = albumFrames + static_cast<long long>( kTrackLengths.size() );
+	long framesRead = 0;
+	long long reads = 0;
+	do {
+		framesRead = static_cast<long>( output.ReadSampleData( buffer.data(), byteCount, 0 /*handle*/ ) / ( kChannels * 4 ) );
+		for ( long frame = 0; frame < framesRead; frame++ ) {
+			const long long albumFrame = result.Frames + frame;
+			for ( long channel = 0; channel < kChannels; channel++ ) {
+				if ( ( albumFrame >= albumFrames ) || ( buffer[ static_cast<size_t>( frame * kChannels + channel ) ] != GetAlbumSample( albumFrame, channel ) ) ) {
+					++result.Mismatches;
+				}
+			}
+		}
+		result.Frames += framesRead;
+	} while ( ( framesRead > 0 ) && ( ++reads < maxReads ) );
+	if ( result.Frames < albumFrames ) {
+		result.Mismatches += ( albumFrames - result.Frames ) * kChannels;
+	}
+
+	// Each track should start on exactly the frame following the last frame of the previous track.
+	const auto queue = output.GetOutputQueue();
+	for ( size_t index = 0; index < trackStarts.size(); index++ ) {
+		const Output::Item first = Output::GetQueueItem( *queue, trackStarts[ index ], kSampleRate );
+		if ( ( first.PlaylistItem.ID != items[ index ].ID ) || ( first.StartFrame != trackStarts[ index ] ) || ( 0 != first.Position ) ) {
+			++result.BoundaryErrors;
+		}
+		if ( index > 0 ) {
+			const Output::Item last = Output::GetQueueItem( *queue, trackStarts[ index ] - 1, kSampleRate );
+			if ( last.PlaylistItem.ID != items[ index - 1 ].ID ) {
+				++result.BoundaryErrors;
+			}
+		}
+	}
+	if ( queue->size() != trackStarts.size() ) {
+		++result.BoundaryErrors;
+	}
+
+	// Seeking to the first, middle & last frame of each track should resume at exactly that frame.
+	for ( size_t index = 0; index < trackStarts.size(); index++ ) {
+		const long long trackLength = kTrackLengths[ index ];
+		for ( const long long seekFrame : { 0ll, trackLength / 2, trackLength - 1 } ) {
+			const Decoder::Ptr seekDecoder = handlers.OpenDecoder( SyntheticTrackHandler::GetFilename( index ) );
+			const float position = seekDecoder ? seekDecoder->Seek( static_cast<float>( static_cast<double>( seekFrame ) / kSampleRate ) ) : 0;
+			std::array<float, kChannels> frame = {};
+			bool seekError = !seekDecoder || ( std::llround( static_cast<double>( position ) * kSampleRate ) != seekFrame ) || ( 1 != seekDecoder->Read( frame.data(), 1 ) );
+			for ( long channel = 0; !seekError && ( channel < kChannels ); channel++ ) {
+				seekError = ( frame[ static_cast<size_t>( channel ) ] != GetAlbumSample( trackStarts[ index ] + seekFrame, channel ) );
+			}
+			if ( seekError ) {
+				++result.SeekErrors;
+			}
+		}
+	}
+
+	result.Passed = ( 0 == result.Mismatches ) && ( 0 == result.BoundaryErrors ) && ( 0 == result.SeekErrors ) && ( albumFrames == result.Frames );
+	return result;
+}
+
+bool GaplessTest::WriteJSON( const Results& results, const std::wstring& outputFilename )
+{
+	nlohmann::json document = nlohmann::json::array();
+	for ( const auto& result : results ) {
+		nlohmann::json entry;
+		entry[ "block_size" ] = result.BlockSize;
+		entry[ "encoder_delay" ] = result.EncoderDelay;
+		entry[ "encoder_padding" ] = result.EncoderPadding;
+		entry[ "frames" ] = result.Frames;
+		entry[ "mismatches" ] = result.Mismatches;
+		entry[ "boundary_errors" ] = result.BoundaryErrors;
+		entry[ "seek_errors" ] = result.SeekErrors;
+		entry[ "passed" ] = result.Passed;
+		document.push_back( entry );
+	}
+
+	return WriteBenchmarkJSON( document, outputFilename );
+}
+
+bool GaplessTest::WriteCSV( const Results& results, const std::wstring& outputFilename )
+{
+	return WriteBenchmarkCSV( outputFilename, "block_size,encoder_delay,encoder_padding,frames,mismatches,boundary_errors,seek_errors,passed", [ &results ] ( std::ostream& stream )
+	{
+		for ( const auto& result : results ) {
+			stream << result.BlockSize << "," << result.EncoderDelay << "," << result.EncoderPadding << "," << result.Frames << "," << result.Mismatches << "," << result.BoundaryErrors << "," << result.SeekErrors << "," << ( result.Passed ? "true" : "false" ) << std::endl;
+		}
+	} );
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "stdafx.h"
+
+#include "BenchmarkUtility.h"
+
+#include <string>
+#include <vector>
+
+// Checks that gapless transitions are sample accurate, by splitting a synthetic 'live album' into tracks with encoder delay & padding,
+// then playing the tracks back to back through the output and comparing the joined output (and track boundaries) against the original album.
+class GaplessTest
+{
+public:
+	// 'instance' - module instance handle.
+	GaplessTest( const HINSTANCE instance );
+
+	virtual ~GaplessTest();
+
+	// Runs the test.
+	// 'outputFilename' - results file, written as CSV if the file has a .csv extension, otherwise as JSON.
+	// Returns whether all checks passed and the results were written.
+	bool Run( const std::wstring& outputFilename ) const;
+
+private:
+	// Result for a test case.
+	struct Result {
+		long BlockSize = 0;						// Read block size, in frames.
+		long EncoderDelay = 0;				// Encoder delay for each track, in frames.
+		long EncoderPadding = 0;			// Encoder padding for each track, in frames.
+		long long Frames = 0;					// Number of frames output.
+		long long Mismatches = 0;			// Number of output samples which differ from the original album.
+		long BoundaryErrors = 0;			// Number of track boundaries which were not found at the expected frame.
+		long SeekErrors = 0;					// Number of seeks which did not resume at the expected sample.
+		bool Passed = false;					// Whether all checks passed.
+	};
+
+	// A list of results.
+	using Results = std::vector<Result>;
+
+	// Checks joining the album tracks, reading in blocks of 'blockSize' frames, where each track has an 'encoderDelay' & 'encoderPadding'.
+	// The tracks are joined by the output itself, by reading sample data in the same way as the output stream.
+	Result Check( const long blockSize, const long encoderDelay, const long encoderPadding ) const;
+
+	// Writes the 'results' as JSON to the 'outputFilename', returning whether the file was written.
+	static bool WriteJSON( const Results& results, const std::wstring& outputFilename );
+
+	// Writes the 'results' as CSV to the 'outputFilename', returning whether the file was written.
+	static bool WriteCSV( const Results& results, const std::wstring& outputFilename );
+
+	// Module instance handle.
+	const HINSTANCE m_hInst;
+};
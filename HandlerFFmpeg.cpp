@@ -3,6 +3,7 @@
 #include "resource.h"
 
 #include "DecoderFFmpeg.h"
+#include "DecoderGapless.h"
 #include "Utility.h"
 
 HandlerFFmpeg::HandlerFFmpeg()
@@ -37,7 +38,13 @@ Decoder::Ptr HandlerFFmpeg::OpenDecoder( const std::wstring& filename ) const
 		decoderFFmpeg = new DecoderFFmpeg( filename );
 	} catch ( const std::runtime_error& ) {
 	}
-	const Decoder::Ptr stream( decoderFFmpeg );
+	Decoder::Ptr stream( decoderFFmpeg );
+	if ( nullptr != decoderFFmpeg ) {
+		// Trim any encoder padding, so that consecutive tracks join without a gap.
+		if ( const auto frameCount = decoderFFmpeg->GetGaplessFrameCount(); frameCount.has_value() ) {
+			stream = std::make_shared<DecoderGapless>( stream, 0 /*encoderDelay*/, frameCount.value() );
+		}
+	}
 	return stream;
 }
 
@@ -2,6 +2,7 @@
 
 #include "DecoderFlac.h"
 #include "EncoderFlac.h"
+#include "MappedFile.h"
 
 #include <share/windows_unicode_filenames.h>
 
@@ -10,6 +11,53 @@
 // Amount of padding to add when writing out FLAC files that don't contain any padding.
 constexpr uint32_t kPaddingSize = 1024;
 
+// FLAC I/O read callback for a mapped file.
+static size_t MappedFileRead( void* ptr, size_t size, size_t nmemb, FLAC__IOHandle handle )
+{
+	size_t itemsRead = 0;
+	if ( size > 0 ) {
+		itemsRead = static_cast<MappedFile*>( handle )->Read( ptr, size * nmemb ) / size;
+	}
+	return itemsRead;
+}
+
+// FLAC I/O seek callback for a mapped file.
+static int MappedFileSeek( FLAC__IOHandle handle, FLAC__int64 offset, int whence )
+{
+	MappedFile* file = static_cast<MappedFile*>( handle );
+	FLAC__int64 position = -1;
+	switch ( whence ) {
+		case SEEK_SET : {
+			position = offset;
+			break;
+		}
+		case SEEK_CUR : {
+			position = static_cast<FLAC__int64>( file->GetPosition() ) + offset;
+			break;
+		}
+		case SEEK_END : {
+			position = static_cast<FLAC__int64>( file->GetSize() ) + offset;
+			break;
+		}
+	}
+	return ( ( position >= 0 ) && file->Seek( static_cast<uint64_t>( position ) ) ) ? 0 : -1;
+}
+
+// FLAC I/O tell callback for a mapped file.
+static FLAC__int64 MappedFileTell( FLAC__IOHandle handle )
+{
+	return static_cast<FLAC__int64>( static_cast<MappedFile*>( handle )->GetPosition() );
+}
+
+// FLAC I/O end of file callback for a mapped file.
+static int MappedFileEOF( FLAC__IOHandle handle )
+{
+	return static_cast<MappedFile*>( handle )->IsEOF() ? 1 : 0;
+}
+
+// FLAC I/O callbacks for reading metadata from a mapped file.
+static const FLAC__IOCallbacks kMappedFileCallbacks = { MappedFileRead, nullptr /*write*/, MappedFileSeek, MappedFileTell, MappedFileEOF, nullptr /*close*/ };
+
 HandlerFlac::HandlerFlac() :
 	Handler()
 {
@@ -35,69 +83,76 @@ bool HandlerFlac::GetTags( const std::wstring& filename, Tags& tags ) const
 {
 	bool success = false;
 	tags.clear();
-	flac_internal_set_utf8_filenames( true );
-	FLAC::Metadata::SimpleIterator iterator;
-	if ( iterator.is_valid() &&	iterator.init( WideStringToUTF8( filename ).c_str(), true /*readOnly*/, true /*preserveFileStats*/ ) ) {
-		success = true;
-		do {
-			const FLAC__MetadataType blockType = iterator.get_block_type();
-			if ( FLAC__METADATA_TYPE_VORBIS_COMMENT == blockType ) {
-				FLAC::Metadata::Prototype* block = iterator.get_block();
-				if ( nullptr != block ) {
-					FLAC::Metadata::VorbisComment* vorbisComment = dynamic_cast<FLAC::Metadata::VorbisComment*>( block );
-					if ( ( nullptr != vorbisComment ) && ( vorbisComment->is_valid() ) ) {
-						const unsigned char* vendor = vorbisComment->get_vendor_string();
-						if ( ( nullptr != vendor ) && ( vendor[ 0 ] != 0 ) ) {
-							tags.insert( Tags::value_type( Tag::Version, reinterpret_cast<const char*>( vendor ) ) );
-						}
-						const unsigned int commentCount = vorbisComment->get_num_comments();
-						for ( unsigned int commentIndex = 0; commentIndex < commentCount; commentIndex++ ) {
-							const FLAC::Metadata::VorbisComment::Entry entry = vorbisComment->get_comment( commentIndex );
-							if ( ( entry.is_valid() ) && ( entry.get_field_name_length() != 0 ) && ( entry.get_field_value_length() != 0 ) ) {
-								const char* field = entry.get_field_name();
-								if ( 0 == _stricmp( field, "ARTIST" ) ) {
-									tags.insert( Tags::value_type( Tag::Artist, entry.get_field_value() ) );
-								} else if ( 0 == _stricmp( field, "TITLE" ) ) {
-									tags.insert( Tags::value_type( Tag::Title, entry.get_field_value() ) );
-								} else if ( 0 == _stricmp( field, "ALBUM" ) ) {
-									tags.insert( Tags::value_type( Tag::Album, entry.get_field_value() ) );
-								} else if ( 0 == _stricmp( field, "GENRE" ) ) {
-									tags.insert( Tags::value_type( Tag::Genre, entry.get_field_value() ) );
-								} else if ( ( 0 == _stricmp( field, "YEAR" ) ) || ( 0 == _stricmp( field, "DATE" ) ) ) {
-									tags.insert( Tags::value_type( Tag::Year, entry.get_field_value() ) );
-								} else if ( 0 == _stricmp( field, "COMMENT" ) ) {
-									tags.insert( Tags::value_type( Tag::Comment, entry.get_field_value() ) );
-								} else if ( ( 0 == _stricmp( field, "TRACK" ) ) || ( 0 == _stricmp( field, "TRACKNUMBER" ) ) ) {
-									tags.insert( Tags::value_type( Tag::Track, entry.get_field_value() ) );
-								} else if ( 0 == _stricmp( field, "REPLAYGAIN_TRACK_GAIN" ) ) {
-									tags.insert( Tags::value_type( Tag::GainTrack, entry.get_field_value() ) );
-								} else if ( 0 == _stricmp( field, "REPLAYGAIN_ALBUM_GAIN" ) ) {
-									tags.insert( Tags::value_type( Tag::GainAlbum, entry.get_field_value() ) );
+	try {
+		MappedFile file( filename, MappedFile::Access::Random );
+		FLAC::Metadata::Chain chain;
+		if ( chain.is_valid() && chain.read( &file, kMappedFileCallbacks ) ) {
+			FLAC::Metadata::Iterator iterator;
+			if ( iterator.is_valid() ) {
+				iterator.init( chain );
+				success = true;
+				do {
+					const FLAC__MetadataType blockType = iterator.get_block_type();
+					if ( FLAC__METADATA_TYPE_VORBIS_COMMENT == blockType ) {
+						FLAC::Metadata::Prototype* block = iterator.get_block();
+						if ( nullptr != block ) {
+							FLAC::Metadata::VorbisComment* vorbisComment = dynamic_cast<FLAC::Metadata::VorbisComment*>( block );
+							if ( ( nullptr != vorbisComment ) && ( vorbisComment->is_valid() ) ) {
+								const unsigned char* vendor = vorbisComment->get_vendor_string();
+								if ( ( nullptr != vendor ) && ( vendor[ 0 ] != 0 ) ) {
+									tags.insert( Tags::value_type( Tag::Version, reinterpret_cast<const char*>( vendor ) ) );
+								}
+								const unsigned int commentCount = vorbisComment->get_num_comments();
+								for ( unsigned int commentIndex = 0; commentIndex < commentCount; commentIndex++ ) {
+									const FLAC::Metadata::VorbisComment::Entry entry = vorbisComment->get_comment( commentIndex );
+									if ( ( entry.is_valid() ) && ( entry.get_field_name_length() != 0 ) && ( entry.get_field_value_length() != 0 ) ) {
+										const char* field = entry.get_field_name();
+										if ( 0 == _stricmp( field, "ARTIST" ) ) {
+											tags.insert( Tags::value_type( Tag::Artist, entry.get_field_value() ) );
+										} else if ( 0 == _stricmp( field, "TITLE" ) ) {
+											tags.insert( Tags::value_type( Tag::Title, entry.get_field_value() ) );
+										} else if ( 0 == _stricmp( field, "ALBUM" ) ) {
+											tags.insert( Tags::value_type( Tag::Album, entry.get_field_value() ) );
+										} else if ( 0 == _stricmp( field, "GENRE" ) ) {
+											tags.insert( Tags::value_type( Tag::Genre, entry.get_field_value() ) );
+										} else if ( ( 0 == _stricmp( field, "YEAR" ) ) || ( 0 == _stricmp( field, "DATE" ) ) ) {
+											tags.insert( Tags::value_type( Tag::Year, entry.get_field_value() ) );
+										} else if ( 0 == _stricmp( field, "COMMENT" ) ) {
+											tags.insert( Tags::value_type( Tag::Comment, entry.get_field_value() ) );
+										} else if ( ( 0 == _stricmp( field, "TRACK" ) ) || ( 0 == _stricmp( field, "TRACKNUMBER" ) ) ) {
+											tags.insert( Tags::value_type( Tag::Track, entry.get_field_value() ) );
+										} else if ( 0 == _stricmp( field, "REPLAYGAIN_TRACK_GAIN" ) ) {
+											tags.insert( Tags::value_type( Tag::GainTrack, entry.get_field_value() ) );
+										} else if ( 0 == _stricmp( field, "REPLAYGAIN_ALBUM_GAIN" ) ) {
+											tags.insert( Tags::value_type( Tag::GainAlbum, entry.get_field_value() ) );
+										}
+									}
 								}
 							}
+							delete block;
+							block = nullptr;
 						}
-					}
-					delete block;
-					block = nullptr;
-				}
-			} else if ( FLAC__METADATA_TYPE_PICTURE == blockType ) {
-				FLAC::Metadata::Prototype* block = iterator.get_block();
-				if ( nullptr != block ) {
-					FLAC::Metadata::Picture* picture = dynamic_cast<FLAC::Metadata::Picture*>( block );
-					if ( ( nullptr != picture ) && ( picture->is_valid() ) && ( FLAC__STREAM_METADATA_PICTURE_TYPE_FRONT_COVER == picture->get_type() ) ) {
-						const int dataLength = static_cast<int>( picture->get_data_length() );
-						if ( dataLength > 0 ) {
-							const std::string encodedImage = Base64Encode( reinterpret_cast<const BYTE*>( picture->get_data() ), dataLength );
-							if ( !encodedImage.empty() ) {
-								tags.insert( Tags::value_type( Tag::Artwork, encodedImage ) );
+					} else if ( FLAC__METADATA_TYPE_PICTURE == blockType ) {
+						FLAC::Metadata::Prototype* block = iterator.get_block();
+						if ( nullptr != block ) {
+							FLAC::Metadata::Picture* picture = dynamic_cast<FLAC::Metadata::Picture*>( block );
+							if ( ( nullptr != picture ) && ( picture->is_valid() ) && ( FLAC__STREAM_METADATA_PICTURE_TYPE_FRONT_COVER == picture->get_type() ) ) {
+								const int dataLength = static_cast<int>( picture->get_data_length() );
+								if ( dataLength > 0 ) {
+									const std::string encodedImage = Base64Encode( reinterpret_cast<const BYTE*>( picture->get_data() ), dataLength );
+									if ( !encodedImage.empty() ) {
+										tags.insert( Tags::value_type( Tag::Artwork, encodedImage ) );
+									}
+								}
 							}
+							delete block;
+							block = nullptr;
 						}
 					}
-					delete block;
-					block = nullptr;
-				}
+				} while ( iterator.next() );
 			}
-		} while ( iterator.next() );
+		}
+	} catch ( const std::runtime_error& ) {
 	}
 	return success;
 }
@@ -0,0 +1,148 @@
+#include "IngestBenchmark.h"
+
+#include <algorithm>
+#include <array>
+
+// Number of rows written in each pass.
+constexpr long kRowCount = 2000;
+
+// Number of passes for each database mode & batch size.
+constexpr long kPassCount = 3;
+
+// Batch sizes to measure (a batch size of one is equivalent to writing each file in its own transaction).
+constexpr std::array<size_t, 3> kBatchSizes = { 1, 32, 1024 };
+
+// Database modes to measure.
+constexpr std::array kDatabaseModes = { Database::Mode::Disk, Database::Mode::Memory };
+
+IngestBenchmark::IngestBenchmark( const Handlers& handlers ) :
+	m_Handlers( handlers )
+{
+}
+
+IngestBenchmark::~IngestBenchmark()
+{
+}
+
+bool IngestBenchmark::Run( const std::wstring& outputFilename ) const
+{
+	bool success = true;
+	Measurements measurements;
+	for ( const auto mode : kDatabaseModes ) {
+		for ( const auto batchSize : kBatchSizes ) {
+			Measurement measurement;
+			measurement.Mode = mode;
+			measurement.BatchSize = batchSize;
+			std::vector<double> passes;
+			for ( long pass = 0; success && ( pass < kPassCount ); pass++ ) {
+				long rows = 0;
+				passes.push_back( Measure( mode, batchSize, pass, rows ) );
+				measurement.Rows += rows;
+				success = ( kRowCount == rows );
+			}
+			if ( success ) {
+				std::sort( passes.begin(), passes.end() );
+				measurement.RowsPerSecond = passes[ passes.size() / 2 ];
+				measurements.push_back( measurement );
+			}
+		}
+	}
+	if ( success ) {
+		success = IsBenchmarkCSV( outputFilename ) ? WriteCSV( measurements, outputFilename ) : WriteJSON( measurements, outputFilename );
+	}
+	return success;
+}
+
+double IngestBenchmark::Measure( const Database::Mode mode, const size_t batchSize, const long pass, long& rows ) const
+{
+	double rowsPerSecond = 0;
+	rows = 0;
+	const std::wstring databaseFilename = ( Database::Mode::Disk == mode ) ? GetTempDatabaseFilename() : std::wstring();
+	if ( ( Database::Mode::Memory == mode ) || !databaseFilename.empty() ) {
+		{
+			Database database( databaseFilename, mode );
+			Library library( database, m_Handlers );
+
+			// Generate the batches up front, so that only the writes are timed.
+			std::vector<MediaInfo::List> batches;
+			for ( long index = 0; index < kRowCount; index++ ) {
+				if ( batches.empty() || ( batches.back().size() >= batchSize ) ) {
+					batches.push_back( {} );
+				}
+				batches.back().push_back( GetMediaInfo( pass * kRowCount + index ) );
+			}
+
+			const LONGLONG startTick = GetBenchmarkTick();
+			for ( auto& batch : batches ) {
+				library.AddMediaInfo( batch );
+				rows += static_cast<long>( batch.size() );
+			}
+			const double seconds = GetBenchmarkSeconds( startTick, GetBenchmarkTick() );
+			rowsPerSecond = ( seconds > 0 ) ? ( rows / seconds ) : 0;
+		}
+		if ( !databaseFilename.empty() ) {
+			DeleteFile( databaseFilename.c_str() );
+		}
+	}
+	return rowsPerSecond;
+}
+
+MediaInfo IngestBenchmark::GetMediaInfo( const long index )
+{
+	const long album = index / 12;
+	MediaInfo mediaInfo( L"C:\\Music\\Artist " + std::to_wstring( album / 10 ) + L"\\Album " + std::to_wstring( album ) + L"\\" + std::to_wstring( index ) + L".flac" );
+	mediaInfo.SetFiletime( 132000000000000000ll + index );
+	mediaInfo.SetFilesize( 8000000ll + index );
+	mediaInfo.SetDuration( static_cast<float>( 180 + ( index % 120 ) ) );
+	mediaInfo.SetSampleRate( 44100 );
+	mediaInfo.SetBitsPerSample( 16 );
+	mediaInfo.SetChannels( 2 );
+	mediaInfo.SetArtist( L"Artist " + std::to_wstring( album / 10 ) );
+	mediaInfo.SetTitle( L"Title " + std::to_wstring( index ) );
+	mediaInfo.SetAlbum( L"Album " + std::to_wstring( album ) );
+	mediaInfo.SetTrack( 1 + ( index % 12 ) );
+	return mediaInfo;
+}
+
+std::wstring IngestBenchmark::GetTempDatabaseFilename()
+{
+	std::wstring filename;
+	WCHAR tempPath[ MAX_PATH + 1 ] = {};
+	if ( 0 != GetTempPath( MAX_PATH + 1, tempPath ) ) {
+		WCHAR tempFilename[ MAX_PATH ] = {};
+		if ( 0 != GetTempFileName( tempPath, L"VUP" /*prefix*/, 0 /*unique*/, tempFilename ) ) {
+			filename = tempFilename;
+		}
+	}
+	return filename;
+}
+
+bool IngestBenchmark::WriteJSON( const Measurements& measurements, const std::wstring& outputFilename )
+{
+	nlohmann::json document;
+	for ( const auto& measurement : measurements ) {
+		nlohmann::json entry;
+		entry[ "database" ] = GetModeName( measurement.Mode );
+		entry[ "batch_size" ] = measurement.BatchSize;
+		entry[ "rows" ] = measurement.Rows;
+		entry[ "rows_per_second" ] = measurement.RowsPerSecond;
+		document[ "measurements" ].push_back( entry );
+	}
+
+	return WriteBenchmarkJSON( document, outputFilename );
+}
+
+bool IngestBenchmark::WriteCSV( const Measurements& measurements, const std::wstring& outputFilename )
+{
+	return WriteBenchmarkCSV( outputFilename, "database,batch_size,rows,rows_per_second", [ &measurements ] ( std::ostream& stream )
+	{
+		for ( const auto& measurement : measurements ) {
+			stream << GetModeName( measurement.Mode ) << "," << measurement.BatchSize << "," << measurement.Rows << "," << measurement.RowsPerSecond << std::endl;
+		}
+	} );
+}
+
+std::string IngestBenchmark::GetModeName( const Database::Mode mode )
+{
+	return ( Database::Mode::Memory == mode ) ? "memory" : "disk";
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "stdafx.h"
+
+#include "BenchmarkUtility.h"
+#include "Library.h"
+
+#include <string>
+#include <vector>
+
+// Measures media library ingest throughput for different batch sizes, using synthetic media information written to on-disk & in-memory databases.
+class IngestBenchmark
+{
+public:
+	// 'handlers' - media handlers.
+	IngestBenchmark( const Handlers& handlers );
+
+	virtual ~IngestBenchmark();
+
+	// Runs the benchmark.
+	// 'outputFilename' - results file, written as CSV if the file has a .csv extension, otherwise as JSON.
+	// Returns whether the results were written.
+	bool Run( const std::wstring& outputFilename ) const;
+
+private:
+	// Measurement for a database mode & batch size.
+	struct Measurement {
+		Database::Mode Mode = Database::Mode::Disk;	// Database access mode.
+		size_t BatchSize = 0;												// Number of rows written per transaction.
+		long Rows = 0;															// Number of rows written.
+		double RowsPerSecond = 0;										// Throughput, in rows per second (median of all passes).
+	};
+
+	// A list of measurements.
+	using Measurements = std::vector<Measurement>;
+
+	// Measures the ingest throughput for a single pass, returning the number of rows per second.
+	// 'mode' - database access mode.
+	// 'batchSize' - number of rows to write per transaction.
+	// 'pass' - pass number, used to generate unique filenames.
+	// 'rows' - out, the number of rows written.
+	double Measure( const Database::Mode mode, const size_t batchSize, const long pass, long& rows ) const;
+
+	// Returns synthetic media information for the media 'index'.
+	static MediaInfo GetMediaInfo( const long index );
+
+	// Returns a temporary database file name, or an empty string if a file name could not be generated.
+	static std::wstring GetTempDatabaseFilename();
+
+	// Writes the 'measurements' as JSON to the 'outputFilename', returning whether the file was written.
+	static bool WriteJSON( const Measurements& measurements, const std::wstring& outputFilename );
+
+	// Writes the 'measurements' as CSV to the 'outputFilename', returning whether the file was written.
+	static bool WriteCSV( const Measurements& measurements, const std::wstring& outputFilename );
+
+	// Returns the name of a database 'mode'.
+	static std::string GetModeName( const Database::Mode mode );
+
+	// Media handlers.
+	const Handlers& m_Handlers;
+};
@@ -0,0 +1,83 @@
+#include "LatencyHistogram.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+LatencyHistogram::LatencyHistogram() :
+	m_Count( 0 ),
+	m_Total( 0 ),
+	m_Max( 0 ),
+	m_Buckets()
+{
+}
+
+LatencyHistogram::~LatencyHistogram()
+{
+}
+
+void LatencyHistogram::Record( const uint64_t value )
+{
+	m_Buckets[ GetBucketIndex( value ) ].fetch_add( 1, std::memory_order_relaxed );
+	m_Total.fetch_add( value, std::memory_order_relaxed );
+	m_Count.fetch_add( 1, std::memory_order_relaxed );
+	uint64_t maxValue = m_Max.load( std::memory_order_relaxed );
+	while ( ( value > maxValue ) && !m_Max.compare_exchange_weak( maxValue, value, std::memory_order_relaxed ) ) {
+	}
+}
+
+LatencyHistogram::Snapshot LatencyHistogram::GetSnapshot() const
+{
+	Snapshot snapshot;
+	for ( size_t index = 0; index < kBucketCount; index++ ) {
+		snapshot.Buckets[ index ] = m_Buckets[ index ].load( std::memory_order_relaxed );
+	}
+	snapshot.Count = m_Count.load( std::memory_order_relaxed );
+	snapshot.Total = m_Total.load( std::memory_order_relaxed );
+	snapshot.Max = m_Max.load( std::memory_order_relaxed );
+	return snapshot;
+}
+
+void LatencyHistogram::Reset()
+{
+	for ( auto& bucket : m_Buckets ) {
+		bucket.store( 0, std::memory_order_relaxed );
+	}
+	m_Count.store( 0, std::memory_order_relaxed );
+	m_Total.store( 0, std::memory_order_relaxed );
+	m_Max.store( 0, std::memory_order_relaxed );
+}
+
+uint64_t LatencyHistogram::GetBucketLimit( const size_t index )
+{
+	return uint64_t( 1 ) << std::min<size_t>( index, kBucketCount - 1 );
+}
+
+size_t LatencyHistogram::GetBucketIndex( const uint64_t value )
+{
+	return std::min<size_t>( static_cast<size_t>( std::bit_width( value ) ), kBucketCount - 1 );
+}
+
+double LatencyHistogram::Snapshot::GetMean() const
+{
+	return ( Count > 0 ) ? ( static_cast<double>( Total ) / static_cast<double>( Count ) ) : 0;
+}
+
+uint64_t LatencyHistogram::Snapshot::GetPercentile( const double percentile ) const
+{
+	uint64_t limit = 0;
+	if ( Count > 0 ) {
+		const uint64_t rank = std::max<uint64_t>( 1, static_cast<uint64_t>( std::ceil( std::clamp( percentile, 0.0, 100.0 ) * static_cast<double>( Count ) / 100 ) ) );
+		limit = Max;
+		uint64_t cumulative = 0;
+		bool found = false;
+		for ( size_t index = 0; !found && ( index < ( kBucketCount - 1 ) ); index++ ) {
+			cumulative += Buckets[ index ];
+			found = ( cumulative >= rank );
+			if ( found ) {
+				limit = std::min<uint64_t>( GetBucketLimit( index ), Max );
+			}
+		}
+	}
+	return limit;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Lock-free latency histogram, with power of two buckets in microseconds.
+// Values can be recorded from any thread (including real-time audio threads) without blocking or allocating.
+class LatencyHistogram
+{
+public:
+	// Number of buckets, where bucket 0 holds values under 1us, and bucket N holds values in the range [2^(N-1), 2^N) us.
+	static constexpr size_t kBucketCount = 32;
+
+	// A copy of the histogram state at a point in time.
+	struct Snapshot {
+		uint64_t Count = 0;														// Number of values recorded.
+		uint64_t Total = 0;														// Sum of all values recorded, in microseconds.
+		uint64_t Max = 0;															// Maximum value recorded, in microseconds.
+		std::array<uint64_t, kBucketCount> Buckets = {};	// Number of values recorded in each bucket.
+
+		// Returns the mean value, in microseconds.
+		double GetMean() const;
+
+		// Returns an upper bound for the 'percentile' value (in the range 0-100), in microseconds.
+		uint64_t GetPercentile( const double percentile ) const;
+	};
+
+	LatencyHistogram();
+
+	virtual ~LatencyHistogram();
+
+	// Records a 'value', in microseconds.
+	void Record( const uint64_t value );
+
+	// Returns a snapshot of the histogram.
+	// Values recorded while the snapshot is being taken might only be partially included.
+	Snapshot GetSnapshot() const;
+
+	// Resets the histogram.
+	void Reset();
+
+	// Returns the exclusive upper bound of a bucket 'index', in microseconds.
+	static uint64_t GetBucketLimit( const size_t index );
+
+private:
+	// Returns the bucket index for a 'value'.
+	static size_t GetBucketIndex( const uint64_t value );
+
+	// Number of values recorded.
+	std::atomic<uint64_t> m_Count;
+
+	// Sum of all values recorded.
+	std::atomic<uint64_t> m_Total;
+
+	// Maximum value recorded.
+	std::atomic<uint64_t> m_Max;
+
+	// Bucket counts.
+	std::array<std::atomic<uint64_t>, kBucketCount> m_Buckets;
+};
@@ -3,7 +3,9 @@
 #include "Utility.h"
 #include "VUPlayer.h"
 
+#include <cmath>
 #include <iomanip>
+#include <iterator>
 #include <list>
 #include <sstream>
 
@@ -11,6 +13,7 @@ Library::Library( Database& database, const Handlers& handlers ) :
 	m_Database( database ),
 	m_Handlers( handlers ),
 	m_PendingTags(),
+	m_PendingTagsMutex(),
 	m_LastTagWriteTime( 0 ),
 	m_TagsWritten(),
 	m_TagsWrittenMutex(),
@@ -69,7 +72,11 @@ void Library::UpdateDatabase()
 	UpdateMediaTable();
 	UpdateCDDATable();
 	UpdateArtworkTable();
+	UpdateSeekIndexTable();
+	UpdateAnalysisTable();
+	UpdateFolderTable();
 	CreateIndices();
+	m_Database.ClearStatementCache();
 }
 
 void Library::UpdateMediaTable()
@@ -206,6 +213,37 @@ void Library::UpdateArtworkTable()
 	}
 }
 
+void Library::UpdateSeekIndexTable()
+{
+	sqlite3* database = m_Database.GetDatabase();
+	if ( nullptr != database ) {
+		const std::string seekIndexTableQuery = "CREATE TABLE IF NOT EXISTS SeekIndex(Filename,Filetime,Filesize,Data, PRIMARY KEY(Filename));";
+		sqlite3_exec( database, seekIndexTableQuery.c_str(), NULL /*callback*/, NULL /*arg*/, NULL /*errMsg*/ );
+	}
+}
+
+void Library::UpdateAnalysisTable()
+{
+	sqlite3* database = m_Database.GetDatabase();
+	if ( nullptr != database ) {
+		// Crossfade positions are now stored along with all other analysis results.
+		const std::string dropTableQuery = "DROP TABLE IF EXISTS Crossfade;";
+		sqlite3_exec( database, dropTableQuery.c_str(), NULL /*callback*/, NULL /*arg*/, NULL /*errMsg*/ );
+
+		const std::string analysisTableQuery = "CREATE TABLE IF NOT EXISTS Analysis(Filename,Filetime,Filesize,TrackGain,TruePeak,LeadingSilence,TrailingSilence,CrossfadePosition, PRIMARY KEY(Filename));";
+		sqlite3_exec( database, analysisTableQuery.c_str(), NULL /*callback*/, NULL /*arg*/, NULL /*errMsg*/ );
+	}
+}
+
+void Library::UpdateFolderTable()
+{
+	sqlite3* database = m_Database.GetDatabase();
+	if ( nullptr != database ) {
+		const std::string folderTableQuery = "CREATE TABLE IF NOT EXISTS Folders(Folder,Modified,Entries,Hash, PRIMARY KEY(Folder));";
+		sqlite3_exec( database, folderTableQuery.c_str(), NULL /*callback*/, NULL /*arg*/, NULL /*errMsg*/ );
+	}
+}
+
 void Library::CreateIndices()
 {
 	sqlite3* database = m_Database.GetDatabase();
@@ -223,7 +261,7 @@ bool Library::GetMediaInfo( MediaInfo& mediaInfo, const bool checkFileAttributes
 		MediaInfo info( mediaInfo );
 		const std::string query = ( MediaInfo::Source::CDDA == info.GetSource() ) ? "SELECT * FROM CDDA WHERE CDDB=?1 AND Track=?2;" : "SELECT * FROM Media WHERE Filename=?1;";
 		sqlite3_stmt* stmt = nullptr;
-		success = ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) );
+		success = ( SQLITE_OK == m_Database.PrepareStatement( query, &stmt ) );
 		if ( success ) {
 			success = ( MediaInfo::Source::CDDA == mediaInfo.GetSource() ) ?
 				( ( SQLITE_OK == sqlite3_bind_int( stmt, 1 /*param*/, static_cast<int>( info.GetCDDB() ) ) ) && ( SQLITE_OK == sqlite3_bind_int( stmt, 2 /*param*/, static_cast<int>( info.GetTrack() ) ) ) ) :
@@ -246,13 +284,8 @@ bool Library::GetMediaInfo( MediaInfo& mediaInfo, const bool checkFileAttributes
 				}
 
 				if ( !success && scanMedia && ( MediaInfo::Source::File == info.GetSource() ) ) {
-					success = GetDecoderInfo( info );
+					success = ScanMediaInfo( info );
 					if ( success ) {
-						Tags pendingTags;
-						if ( GetPendingTags( info.GetFilename(), pendingTags ) ) {
-							UpdateMediaInfoFromTags( info, pendingTags );
-						}
-
 						success = UpdateMediaLibrary( info );
 						if ( success && sendNotification ) {
 							VUPlayer* vuplayer = VUPlayer::Get();
@@ -269,7 +302,89 @@ bool Library::GetMediaInfo( MediaInfo& mediaInfo, const bool checkFileAttributes
 					mediaInfo = info;
 				}
 			}
-			sqlite3_finalize( stmt );
+			m_Database.ReleaseStatement( stmt );
+		}
+	}
+	return success;
+}
+
+void Library::GetMediaInfo( MediaInfo::List& mediaList, const bool sendNotification, const bool removeMissing )
+{
+	// Scan any files which do not have a matching entry, making a note of their previous media information.
+	MediaInfo::List scannedMedia;
+	std::list<std::pair<MediaInfo::List::iterator, MediaInfo>> scannedEntries;
+	for ( auto mediaInfo = mediaList.begin(); mediaList.end() != mediaInfo; ) {
+		bool success = GetMediaInfo( *mediaInfo, true /*checkFileAttributes*/, false /*scanMedia*/, false /*sendNotification*/ );
+		if ( !success && ( MediaInfo::Source::File == mediaInfo->GetSource() ) ) {
+			MediaInfo info( *mediaInfo );
+			success = ScanMediaInfo( info );
+			if ( success ) {
+				scannedMedia.push_back( info );
+				scannedEntries.push_back( std::make_pair( mediaInfo, *mediaInfo ) );
+			} else if ( removeMissing ) {
+				RemoveFromLibrary( info );
+			}
+		}
+		mediaInfo = success ? std::next( mediaInfo ) : mediaList.erase( mediaInfo );
+	}
+
+	// Write out the scanned files, and remove any entries which could not be written.
+	MediaInfo::UpdateList updates;
+	const std::vector<bool> updated = UpdateMediaLibrary( scannedMedia );
+	auto scannedInfo = scannedMedia.begin();
+	auto scannedEntry = scannedEntries.begin();
+	for ( const bool success : updated ) {
+		if ( success ) {
+			*scannedEntry->first = *scannedInfo;
+			if ( sendNotification ) {
+				updates.push_back( std::make_pair( scannedEntry->second /*previousInfo*/, *scannedInfo /*updatedInfo*/ ) );
+			}
+		} else {
+			mediaList.erase( scannedEntry->first );
+		}
+		++scannedInfo;
+		++scannedEntry;
+	}
+
+	if ( !updates.empty() ) {
+		VUPlayer* vuplayer = VUPlayer::Get();
+		if ( nullptr != vuplayer ) {
+			vuplayer->OnMediaUpdated( updates );
+		}
+	}
+}
+
+void Library::AddMediaInfo( MediaInfo::List& mediaList, const bool sendNotification )
+{
+	MediaInfo::UpdateList updates;
+	const std::vector<bool> updated = UpdateMediaLibrary( mediaList );
+	auto mediaInfo = mediaList.begin();
+	for ( const bool success : updated ) {
+		if ( success ) {
+			if ( sendNotification ) {
+				updates.push_back( std::make_pair( MediaInfo( mediaInfo->GetFilename() ) /*previousInfo*/, *mediaInfo /*updatedInfo*/ ) );
+			}
+			++mediaInfo;
+		} else {
+			mediaInfo = mediaList.erase( mediaInfo );
+		}
+	}
+
+	if ( !updates.empty() ) {
+		VUPlayer* vuplayer = VUPlayer::Get();
+		if ( nullptr != vuplayer ) {
+			vuplayer->OnMediaUpdated( updates );
+		}
+	}
+}
+
+bool Library::ScanMediaInfo( MediaInfo& mediaInfo )
+{
+	const bool success = GetDecoderInfo( mediaInfo );
+	if ( success ) {
+		Tags pendingTags;
+		if ( GetPendingTags( mediaInfo.GetFilename(), pendingTags ) ) {
+			UpdateMediaInfoFromTags( mediaInfo, pendingTags );
 		}
 	}
 	return success;
@@ -452,137 +567,175 @@ void Library::ExtractMediaInfo( sqlite3_stmt* stmt, MediaInfo& mediaInfo )
 bool Library::UpdateMediaLibrary( const MediaInfo& mediaInfo )
 {
 	bool success = false;
+	sqlite3_stmt* stmt = nullptr;
+	if ( SQLITE_OK == m_Database.PrepareStatement( GetUpdateQuery( mediaInfo.GetSource() ), &stmt ) ) {
+		success = WriteMediaInfo( stmt, mediaInfo );
+		m_Database.ReleaseStatement( stmt );
+	}
+	return success;
+}
 
+std::vector<bool> Library::UpdateMediaLibrary( const MediaInfo::List& mediaList )
+{
+	std::vector<bool> updated;
+	updated.reserve( mediaList.size() );
 	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
+	if ( ( nullptr != database ) && !mediaList.empty() ) {
+		// Use a single transaction, so that the batch is only written through to disk once.
+		Database::Transaction transaction( m_Database );
+		sqlite3_stmt* stmt = nullptr;
+		std::optional<MediaInfo::Source> source;
+		for ( const auto& mediaInfo : mediaList ) {
+			if ( source != mediaInfo.GetSource() ) {
+				// Reuse the prepared statement for all consecutive entries from the same source.
+				m_Database.ReleaseStatement( stmt );
+				source = mediaInfo.GetSource();
+				m_Database.PrepareStatement( GetUpdateQuery( mediaInfo.GetSource() ), &stmt );
+			}
+			updated.push_back( ( nullptr != stmt ) && WriteMediaInfo( stmt, mediaInfo ) );
+		}
+		m_Database.ReleaseStatement( stmt );
+		if ( !transaction.Commit() ) {
+			updated.assign( updated.size(), false );
+		}
+	}
+	updated.resize( mediaList.size(), false );
+	return updated;
+}
 
-		const Columns& columnMap = GetColumns( mediaInfo.GetSource() );
-		const std::string tableName = ( MediaInfo::Source::CDDA == mediaInfo.GetSource() ) ? "CDDA" : "Media";
+std::string Library::GetUpdateQuery( const MediaInfo::Source source ) const
+{
+	const Columns& columnMap = GetColumns( source );
+	const std::string tableName = ( MediaInfo::Source::CDDA == source ) ? "CDDA" : "Media";
+
+	std::string columns = " (";
+	std::string values = " VALUES (";
+	int param = 0;
+	for ( const auto& iter : columnMap ) {
+		columns += iter.first + ",";
+		values += "?" + std::to_string( ++param ) + ",";
+	}
+	columns.back() = ')';
+	values.back() = ')';
+	const std::string query = "REPLACE INTO " + tableName + columns + values + ";";
+	return query;
+}
 
-		std::string columns = " (";
-		std::string values = " VALUES (";
+bool Library::WriteMediaInfo( sqlite3_stmt* stmt, const MediaInfo& mediaInfo )
+{
+	bool success = false;
+	if ( nullptr != stmt ) {
 		int param = 0;
-		for ( const auto& iter : columnMap ) {
-			columns += iter.first + ",";
-			values += "?" + std::to_string( ++param ) + ",";
-		}
-		columns.back() = ')';
-		values.back() = ')';
-		const std::string query = "REPLACE INTO " + tableName + columns + values + ";";
-		sqlite3_stmt* stmt = nullptr;
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			param = 0;
-			for ( const auto& iter : columnMap ) {
-				switch ( iter.second ) {
-					case Column::Album : {
-						sqlite3_bind_text( stmt, ++param, WideStringToUTF8( mediaInfo.GetAlbum() ).c_str(), -1 /*strLen*/, SQLITE_TRANSIENT );
-						break;
-					}
-					case Column::Artist : {
-						sqlite3_bind_text( stmt, ++param, WideStringToUTF8( mediaInfo.GetArtist() ).c_str(), -1 /*strLen*/, SQLITE_TRANSIENT );
-						break;
-					}
-					case Column::BitsPerSample : {
-						const auto bps = mediaInfo.GetBitsPerSample();
-						if ( bps.has_value() ) {
-							sqlite3_bind_int( stmt, ++param, static_cast<int>( bps.value() ) );
-						} else {
-							sqlite3_bind_null( stmt, ++param );
-						}
-						break;
-					}
-					case Column::Channels : {
-						sqlite3_bind_int( stmt, ++param, static_cast<int>( mediaInfo.GetChannels() ) );
-						break;
-					}
-					case Column::Comment : {
-						sqlite3_bind_text( stmt, ++param, WideStringToUTF8( mediaInfo.GetComment() ).c_str(), -1 /*strLen*/, SQLITE_TRANSIENT );
-						break;
-					}
-					case Column::Duration : {
-						sqlite3_bind_double( stmt, ++param, mediaInfo.GetDuration() );
-						break;
-					}
-					case Column::Filename : {
-						sqlite3_bind_text( stmt, ++param, WideStringToUTF8( mediaInfo.GetFilename() ).c_str(), -1 /*strLen*/, SQLITE_TRANSIENT );
-						break;
-					}
-					case Column::Filesize : {
-						sqlite3_bind_int64( stmt, ++param, static_cast<sqlite3_int64>( mediaInfo.GetFilesize() ) );
-						break;
-					}
-					case Column::Filetime : {
-						sqlite3_bind_int64( stmt, ++param, static_cast<sqlite3_int64>( mediaInfo.GetFiletime() ) );
-						break;
-					}
-					case Column::GainAlbum : {
-						const auto gain = mediaInfo.GetGainAlbum();
-						if ( gain.has_value() ) {
-							sqlite3_bind_double( stmt, ++param, gain.value() );
-						} else {
-							sqlite3_bind_null( stmt, ++param );
-						}
-						break;
-					}
-					case Column::GainTrack : {
-						const auto gain = mediaInfo.GetGainTrack();
-						if ( gain.has_value() ) {
-							sqlite3_bind_double( stmt, ++param, gain.value() );
-						} else {
-							sqlite3_bind_null( stmt, ++param );
-						}
-						break;
-					}
-					case Column::Genre : {
-						sqlite3_bind_text( stmt, ++param, WideStringToUTF8( mediaInfo.GetGenre() ).c_str(), -1 /*strLen*/, SQLITE_TRANSIENT );
-						break;
-					}
-					case Column::SampleRate : {
-						sqlite3_bind_int( stmt, ++param, static_cast<int>( mediaInfo.GetSampleRate() ) );
-						break;
-					}
-					case Column::Title : {
-						sqlite3_bind_text( stmt, ++param, WideStringToUTF8( mediaInfo.GetTitle() ).c_str(), -1 /*strLen*/, SQLITE_TRANSIENT );
-						break;
-					}
-					case Column::Track : {
-						sqlite3_bind_int( stmt, ++param, static_cast<int>( mediaInfo.GetTrack() ) );
-						break;
-					}
-					case Column::Version : {
-						sqlite3_bind_text( stmt, ++param, WideStringToUTF8( mediaInfo.GetVersion() ).c_str(), -1 /*strLen*/, SQLITE_TRANSIENT );
-						break;
-					}
-					case Column::Year : {
-						sqlite3_bind_int( stmt, ++param, static_cast<int>( mediaInfo.GetYear() ) );
-						break;
-					}
-					case Column::Artwork : {
-						sqlite3_bind_text( stmt, ++param, WideStringToUTF8( mediaInfo.GetArtworkID() ).c_str(), -1 /*strLen*/, SQLITE_TRANSIENT );
-						break;
+		for ( const auto& iter : GetColumns( mediaInfo.GetSource() ) ) {
+			switch ( iter.second ) {
+				case Column::Album : {
+					sqlite3_bind_text( stmt, ++param, WideStringToUTF8( mediaInfo.GetAlbum() ).c_str(), -1 /*strLen*/, SQLITE_TRANSIENT );
+					break;
+				}
+				case Column::Artist : {
+					sqlite3_bind_text( stmt, ++param, WideStringToUTF8( mediaInfo.GetArtist() ).c_str(), -1 /*strLen*/, SQLITE_TRANSIENT );
+					break;
+				}
+				case Column::BitsPerSample : {
+					const auto bps = mediaInfo.GetBitsPerSample();
+					if ( bps.has_value() ) {
+						sqlite3_bind_int( stmt, ++param, static_cast<int>( bps.value() ) );
+					} else {
+						sqlite3_bind_null( stmt, ++param );
 					}
-					case Column::CDDB : {
-						sqlite3_bind_int( stmt, ++param, static_cast<int>( mediaInfo.GetCDDB() ) );
-						break;
+					break;
+				}
+				case Column::Channels : {
+					sqlite3_bind_int( stmt, ++param, static_cast<int>( mediaInfo.GetChannels() ) );
+					break;
+				}
+				case Column::Comment : {
+					sqlite3_bind_text( stmt, ++param, WideStringToUTF8( mediaInfo.GetComment() ).c_str(), -1 /*strLen*/, SQLITE_TRANSIENT );
+					break;
+				}
+				case Column::Duration : {
+					sqlite3_bind_double( stmt, ++param, mediaInfo.GetDuration() );
+					break;
+				}
+				case Column::Filename : {
+					sqlite3_bind_text( stmt, ++param, WideStringToUTF8( mediaInfo.GetFilename() ).c_str(), -1 /*strLen*/, SQLITE_TRANSIENT );
+					break;
+				}
+				case Column::Filesize : {
+					sqlite3_bind_int64( stmt, ++param, static_cast<sqlite3_int64>( mediaInfo.GetFilesize() ) );
+					break;
+				}
+				case Column::Filetime : {
+					sqlite3_bind_int64( stmt, ++param, static_cast<sqlite3_int64>( mediaInfo.GetFiletime() ) );
+					break;
+				}
+				case Column::GainAlbum : {
+					const auto gain = mediaInfo.GetGainAlbum();
+					if ( gain.has_value() ) {
+						sqlite3_bind_double( stmt, ++param, gain.value() );
+					} else {
+						sqlite3_bind_null( stmt, ++param );
 					}
-					case Column::Bitrate : {
-						const auto bitrate = mediaInfo.GetBitrate();
-						if ( bitrate.has_value() ) {
-							sqlite3_bind_double( stmt, ++param, bitrate.value() );
-						} else {
-							sqlite3_bind_null( stmt, ++param );
-						}
-						break;
+					break;
+				}
+				case Column::GainTrack : {
+					const auto gain = mediaInfo.GetGainTrack();
+					if ( gain.has_value() ) {
+						sqlite3_bind_double( stmt, ++param, gain.value() );
+					} else {
+						sqlite3_bind_null( stmt, ++param );
 					}
-					default : {
-						break;
+					break;
+				}
+				case Column::Genre : {
+					sqlite3_bind_text( stmt, ++param, WideStringToUTF8( mediaInfo.GetGenre() ).c_str(), -1 /*strLen*/, SQLITE_TRANSIENT );
+					break;
+				}
+				case Column::SampleRate : {
+					sqlite3_bind_int( stmt, ++param, static_cast<int>( mediaInfo.GetSampleRate() ) );
+					break;
+				}
+				case Column::Title : {
+					sqlite3_bind_text( stmt, ++param, WideStringToUTF8( mediaInfo.GetTitle() ).c_str(), -1 /*strLen*/, SQLITE_TRANSIENT );
+					break;
+				}
+				case Column::Track : {
+					sqlite3_bind_int( stmt, ++param, static_cast<int>( mediaInfo.GetTrack() ) );
+					break;
+				}
+				case Column::Version : {
+					sqlite3_bind_text( stmt, ++param, WideStringToUTF8( mediaInfo.GetVersion() ).c_str(), -1 /*strLen*/, SQLITE_TRANSIENT );
+					break;
+				}
+				case Column::Year : {
+					sqlite3_bind_int( stmt, ++param, static_cast<int>( mediaInfo.GetYear() ) );
+					break;
+				}
+				case Column::Artwork : {
+					sqlite3_bind_text( stmt, ++param, WideStringToUTF8( mediaInfo.GetArtworkID() ).c_str(), -1 /*strLen*/, SQLITE_TRANSIENT );
+					break;
+				}
+				case Column::CDDB : {
+					sqlite3_bind_int( stmt, ++param, static_cast<int>( mediaInfo.GetCDDB() ) );
+					break;
+				}
+				case Column::Bitrate : {
+					const auto bitrate = mediaInfo.GetBitrate();
+					if ( bitrate.has_value() ) {
+						sqlite3_bind_double( stmt, ++param, bitrate.value() );
+					} else {
+						sqlite3_bind_null( stmt, ++param );
 					}
+					break;
+				}
+				default : {
+					break;
 				}
 			}
-			const int result = sqlite3_step( stmt );
-			success = ( SQLITE_DONE == result );
-			sqlite3_finalize( stmt );
 		}
+		const int result = sqlite3_step( stmt );
+		success = ( SQLITE_DONE == result );
+		sqlite3_reset( stmt );
 	}
 	return success;
 }
@@ -676,7 +829,10 @@ void Library::WriteFileTags( MediaInfo& mediaInfo, const Tags& tags )
 
 		SetRecentlyWrittenTag( filename );
 		if ( m_Handlers.SetTags( filename, allTags ) ) {
-			m_PendingTags.erase( filename );
+			{
+				std::lock_guard<std::mutex> lock( m_PendingTagsMutex );
+				m_PendingTags.erase( filename );
+			}
 			GetDecoderInfo( mediaInfo );
 		} else {
 			AddPendingTags( filename, tags );
@@ -693,12 +849,12 @@ bool Library::AddArtwork( const std::wstring& id, const std::vector<BYTE>& image
 		if ( nullptr != database ) {
 			sqlite3_stmt* stmt = nullptr;
 			const std::string insertQuery = "REPLACE INTO Artwork (ID,Size,Image) VALUES (?1,?2,?3);";
-			if ( SQLITE_OK == sqlite3_prepare_v2( database, insertQuery.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
+			if ( SQLITE_OK == m_Database.PrepareStatement( insertQuery, &stmt ) ) {
 				sqlite3_bind_text( stmt, 1, WideStringToUTF8( id ).c_str(), -1 /*strLen*/, SQLITE_TRANSIENT );
 				sqlite3_bind_int( stmt, 2, static_cast<int>( image.size() ) );
 				sqlite3_bind_blob( stmt, 3, &image[ 0 ], static_cast<int>( image.size() ), SQLITE_STATIC );
 				success = ( SQLITE_DONE == sqlite3_step( stmt ) );
-				sqlite3_finalize( stmt );
+				m_Database.ReleaseStatement( stmt );
 			}
 		}
 	}
@@ -712,7 +868,7 @@ std::wstring Library::FindArtwork( const std::vector<BYTE>& image )
 	if ( nullptr != database ) {
 		std::string query = "SELECT ID,Image FROM Artwork WHERE Size=?1;";
 		sqlite3_stmt* stmt = nullptr;
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
+		if ( SQLITE_OK == m_Database.PrepareStatement( query, &stmt ) ) {
 			if ( SQLITE_OK == sqlite3_bind_int( stmt, 1 /*param*/, static_cast<int>( image.size() ) ) ) {
 				while ( SQLITE_ROW == sqlite3_step( stmt ) ) {
 					const size_t numBytes = static_cast<size_t>( sqlite3_column_bytes( stmt, 1 /*columnIndex*/ ) );
@@ -730,7 +886,7 @@ std::wstring Library::FindArtwork( const std::vector<BYTE>& image )
 					}
 				}
 			}
-			sqlite3_finalize( stmt );
+			m_Database.ReleaseStatement( stmt );
 			stmt = nullptr;
 		}
 	}
@@ -746,7 +902,7 @@ std::vector<BYTE> Library::GetMediaArtwork( const MediaInfo& mediaInfo )
 		if ( nullptr != database ) {
 			const std::string query = "SELECT Image FROM Artwork WHERE ID=?1;";
 			sqlite3_stmt* stmt = nullptr;
-			if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
+			if ( SQLITE_OK == m_Database.PrepareStatement( query, &stmt ) ) {
 				if ( SQLITE_OK == sqlite3_bind_text( stmt, 1 /*param*/, WideStringToUTF8( artworkID ).c_str(), -1 /*strLen*/, SQLITE_TRANSIENT ) ) {
 					if ( SQLITE_ROW == sqlite3_step( stmt ) ) {
 						const size_t numBytes = static_cast<size_t>( sqlite3_column_bytes( stmt, 0 /*columnIndex*/ ) );
@@ -759,7 +915,7 @@ std::vector<BYTE> Library::GetMediaArtwork( const MediaInfo& mediaInfo )
 						}
 					}
 				}
-				sqlite3_finalize( stmt );
+				m_Database.ReleaseStatement( stmt );
 				stmt = nullptr;
 			}
 		}
@@ -793,7 +949,7 @@ std::set<std::wstring> Library::GetArtists()
 	if ( nullptr != database ) {
 		const std::string query = "SELECT DISTINCT Artist FROM Media;";
 		sqlite3_stmt* stmt = nullptr;
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
+		if ( SQLITE_OK == m_Database.PrepareStatement( query, &stmt ) ) {
 			while ( SQLITE_ROW == sqlite3_step( stmt ) ) {
 				const char* text = reinterpret_cast<const char*>( sqlite3_column_text( stmt, 0 /*columnIndex*/ ) );
 				if ( nullptr != text ) {
@@ -803,7 +959,7 @@ std::set<std::wstring> Library::GetArtists()
 					}
 				}
 			}
-			sqlite3_finalize( stmt );
+			m_Database.ReleaseStatement( stmt );
 			stmt = nullptr;
 		}
 	}
@@ -817,7 +973,7 @@ std::set<std::wstring> Library::GetAlbums()
 	if ( nullptr != database ) {
 		const std::string query = "SELECT DISTINCT Album FROM Media;";
 		sqlite3_stmt* stmt = nullptr;
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
+		if ( SQLITE_OK == m_Database.PrepareStatement( query, &stmt ) ) {
 			while ( SQLITE_ROW == sqlite3_step( stmt ) ) {
 				const char* text = reinterpret_cast<const char*>( sqlite3_column_text( stmt, 0 /*columnIndex*/ ) );
 				if ( nullptr != text ) {
@@ -827,7 +983,7 @@ std::set<std::wstring> Library::GetAlbums()
 					}
 				}
 			}
-			sqlite3_finalize( stmt );
+			m_Database.ReleaseStatement( stmt );
 			stmt = nullptr;
 		}
 	}
@@ -841,7 +997,7 @@ std::set<std::wstring> Library::GetAlbums( const std::wstring artist )
 	if ( nullptr != database ) {
 		const std::string query = "SELECT Album FROM Media WHERE Artist=?1;";
 		sqlite3_stmt* stmt = nullptr;
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
+		if ( SQLITE_OK == m_Database.PrepareStatement( query, &stmt ) ) {
 			if ( SQLITE_OK == sqlite3_bind_text( stmt, 1 /*param*/, WideStringToUTF8( artist ).c_str(), -1 /*strLen*/, SQLITE_TRANSIENT ) ) {
 				while ( SQLITE_ROW == sqlite3_step( stmt ) ) {
 					const char* text = reinterpret_cast<const char*>( sqlite3_column_text( stmt, 0 /*columnIndex*/ ) );
@@ -853,7 +1009,7 @@ std::set<std::wstring> Library::GetAlbums( const std::wstring artist )
 					}
 				}
 			}
-			sqlite3_finalize( stmt );
+			m_Database.ReleaseStatement( stmt );
 			stmt = nullptr;
 		}
 	}
@@ -867,7 +1023,7 @@ std::set<std::wstring> Library::GetGenres()
 	if ( nullptr != database ) {
 		const std::string query = "SELECT DISTINCT Genre FROM Media;";
 		sqlite3_stmt* stmt = nullptr;
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
+		if ( SQLITE_OK == m_Database.PrepareStatement( query, &stmt ) ) {
 			while ( SQLITE_ROW == sqlite3_step( stmt ) ) {
 				const char* text = reinterpret_cast<const char*>( sqlite3_column_text( stmt, 0 /*columnIndex*/ ) );
 				if ( nullptr != text ) {
@@ -877,7 +1033,7 @@ std::set<std::wstring> Library::GetGenres()
 					}
 				}
 			}
-			sqlite3_finalize( stmt );
+			m_Database.ReleaseStatement( stmt );
 			stmt = nullptr;
 		}
 	}
@@ -891,14 +1047,14 @@ std::set<long> Library::GetYears()
 	if ( nullptr != database ) {
 		const std::string query = "SELECT DISTINCT Year FROM Media;";
 		sqlite3_stmt* stmt = nullptr;
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
+		if ( SQLITE_OK == m_Database.PrepareStatement( query, &stmt ) ) {
 			while ( SQLITE_ROW == sqlite3_step( stmt ) ) {
 				const long year = static_cast<long>( sqlite3_column_int( stmt, 0 /*columnIndex*/ ) );
 				if ( ( year >= MINYEAR ) && ( year <= MAXYEAR ) ) { 
 					years.insert( year );
 				}
 			}
-			sqlite3_finalize( stmt );
+			m_Database.ReleaseStatement( stmt );
 			stmt = nullptr;
 		}
 	}
@@ -912,7 +1068,7 @@ MediaInfo::List Library::GetMediaByArtist( const std::wstring& artist )
 	if ( nullptr != database ) {
 		const std::string query = "SELECT * FROM Media WHERE Artist=?1 ORDER BY Filename;";
 		sqlite3_stmt* stmt = nullptr;
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
+		if ( SQLITE_OK == m_Database.PrepareStatement( query, &stmt ) ) {
 			if ( SQLITE_OK == sqlite3_bind_text( stmt, 1 /*param*/, WideStringToUTF8( artist ).c_str(), -1 /*strLen*/, SQLITE_TRANSIENT ) ) {
 				while ( SQLITE_ROW == sqlite3_step( stmt ) ) {
 					MediaInfo mediaInfo;
@@ -920,7 +1076,7 @@ MediaInfo::List Library::GetMediaByArtist( const std::wstring& artist )
 					mediaList.push_back( mediaInfo );
 				}
 			}
-			sqlite3_finalize( stmt );
+			m_Database.ReleaseStatement( stmt );
 			stmt = nullptr;
 		}
 	}
@@ -934,7 +1090,7 @@ MediaInfo::List Library::GetMediaByAlbum( const std::wstring& album )
 	if ( nullptr != database ) {
 		const std::string query = "SELECT * FROM Media WHERE Album=?1 ORDER BY Filename;";
 		sqlite3_stmt* stmt = nullptr;
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
+		if ( SQLITE_OK == m_Database.PrepareStatement( query, &stmt ) ) {
 			if ( SQLITE_OK == sqlite3_bind_text( stmt, 1 /*param*/, WideStringToUTF8( album ).c_str(), -1 /*strLen*/, SQLITE_TRANSIENT ) ) {
 				while ( SQLITE_ROW == sqlite3_step( stmt ) ) {
 					MediaInfo mediaInfo;
@@ -942,7 +1098,7 @@ MediaInfo::List Library::GetMediaByAlbum( const std::wstring& album )
 					mediaList.push_back( mediaInfo );
 				}
 			}
-			sqlite3_finalize( stmt );
+			m_Database.ReleaseStatement( stmt );
 			stmt = nullptr;
 		}
 	}
@@ -956,7 +1112,7 @@ MediaInfo::List Library::GetMediaByArtistAndAlbum( const std::wstring& artist, c
 	if ( nullptr != database ) {
 		const std::string query = "SELECT * FROM Media WHERE Artist=?1 AND Album=?2 ORDER BY Filename;";
 		sqlite3_stmt* stmt = nullptr;
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
+		if ( SQLITE_OK == m_Database.PrepareStatement( query, &stmt ) ) {
 			if ( ( SQLITE_OK == sqlite3_bind_text( stmt, 1 /*param*/, WideStringToUTF8( artist ).c_str(), -1 /*strLen*/, SQLITE_TRANSIENT ) ) &&
 					( SQLITE_OK == sqlite3_bind_text( stmt, 2 /*param*/, WideStringToUTF8( album ).c_str(), -1 /*strLen*/, SQLITE_TRANSIENT ) ) ) {
 				while ( SQLITE_ROW == sqlite3_step( stmt ) ) {
@@ -965,7 +1121,7 @@ MediaInfo::List Library::GetMediaByArtistAndAlbum( const std::wstring& artist, c
 					mediaList.push_back( mediaInfo );
 				}
 			}
-			sqlite3_finalize( stmt );
+			m_Database.ReleaseStatement( stmt );
 			stmt = nullptr;
 		}
 	}
@@ -979,7 +1135,7 @@ MediaInfo::List Library::GetMediaByGenre( const std::wstring& genre )
 	if ( nullptr != database ) {
 		const std::string query = "SELECT * FROM Media WHERE Genre=?1 ORDER BY Filename;";
 		sqlite3_stmt* stmt = nullptr;
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
+		if ( SQLITE_OK == m_Database.PrepareStatement( query, &stmt ) ) {
 			if ( SQLITE_OK == sqlite3_bind_text( stmt, 1 /*param*/, WideStringToUTF8( genre ).c_str(), -1 /*strLen*/, SQLITE_TRANSIENT ) ) {
 				while ( SQLITE_ROW == sqlite3_step( stmt ) ) {
 					MediaInfo mediaInfo;
@@ -987,7 +1143,7 @@ MediaInfo::List Library::GetMediaByGenre( const std::wstring& genre )
 					mediaList.push_back( mediaInfo );
 				}
 			}
-			sqlite3_finalize( stmt );
+			m_Database.ReleaseStatement( stmt );
 			stmt = nullptr;
 		}
 	}
@@ -1002,7 +1158,7 @@ MediaInfo::List Library::GetMediaByYear( const long year )
 		if ( nullptr != database ) {
 			const std::string query = "SELECT * FROM Media WHERE Year=?1 ORDER BY Filename;";
 			sqlite3_stmt* stmt = nullptr;
-			if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
+			if ( SQLITE_OK == m_Database.PrepareStatement( query, &stmt ) ) {
 				if ( SQLITE_OK == sqlite3_bind_int( stmt, 1 /*param*/, static_cast<int>( year ) ) ) {
 					while ( SQLITE_ROW == sqlite3_step( stmt ) ) {
 						MediaInfo mediaInfo;
@@ -1010,7 +1166,7 @@ MediaInfo::List Library::GetMediaByYear( const long year )
 						mediaList.push_back( mediaInfo );
 					}
 				}
-				sqlite3_finalize( stmt );
+				m_Database.ReleaseStatement( stmt );
 				stmt = nullptr;
 			}
 		}
@@ -1025,13 +1181,13 @@ MediaInfo::List Library::GetAllMedia()
 	if ( nullptr != database ) {
 		const std::string query = "SELECT * FROM Media ORDER BY Filename;";
 		sqlite3_stmt* stmt = nullptr;
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
+		if ( SQLITE_OK == m_Database.PrepareStatement( query, &stmt ) ) {
 			while ( SQLITE_ROW == sqlite3_step( stmt ) ) {
 				MediaInfo mediaInfo;
 				ExtractMediaInfo( stmt, mediaInfo );
 				mediaList.push_back( mediaInfo );
 			}
-			sqlite3_finalize( stmt );
+			m_Database.ReleaseStatement( stmt );
 			stmt = nullptr;
 		}
 	}
@@ -1045,13 +1201,13 @@ MediaInfo::List Library::GetStreams()
 	if ( nullptr != database ) {
 		const std::string query = "SELECT * FROM Media WHERE Filename LIKE 'http:%' OR Filename LIKE 'https:%' OR Filename LIKE 'ftp:%' ORDER BY Filename COLLATE NOCASE;";
 		sqlite3_stmt* stmt = nullptr;
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
+		if ( SQLITE_OK == m_Database.PrepareStatement( query, &stmt ) ) {
 			while ( SQLITE_ROW == sqlite3_step( stmt ) ) {
 				MediaInfo mediaInfo;
 				ExtractMediaInfo( stmt, mediaInfo );
 				mediaList.push_back( mediaInfo );
 			}
-			sqlite3_finalize( stmt );
+			m_Database.ReleaseStatement( stmt );
 			stmt = nullptr;
 		}
 	}
@@ -1065,10 +1221,10 @@ bool Library::GetArtistExists( const std::wstring& artist )
 	if ( nullptr != database ) {
 		const std::string query = "SELECT 1 FROM Media WHERE EXISTS( SELECT 1 FROM Media WHERE Artist=?1 );";
 		sqlite3_stmt* stmt = nullptr;
-		exists = ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) &&
+		exists = ( SQLITE_OK == m_Database.PrepareStatement( query, &stmt ) ) &&
 				( SQLITE_OK == sqlite3_bind_text( stmt, 1 /*param*/, WideStringToUTF8( artist ).c_str(), -1 /*strLen*/, SQLITE_TRANSIENT ) ) &&
 				( SQLITE_ROW == sqlite3_step( stmt ) );
-		sqlite3_finalize( stmt );
+		m_Database.ReleaseStatement( stmt );
 	}
 	return exists;
 }
@@ -1080,10 +1236,10 @@ bool Library::GetAlbumExists( const std::wstring& album )
 	if ( nullptr != database ) {
 		const std::string query = "SELECT 1 FROM Media WHERE EXISTS( SELECT 1 FROM Media WHERE Album=?1 );";
 		sqlite3_stmt* stmt = nullptr;
-		exists = ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) &&
+		exists = ( SQLITE_OK == m_Database.PrepareStatement( query, &stmt ) ) &&
 				( SQLITE_OK == sqlite3_bind_text( stmt, 1 /*param*/, WideStringToUTF8( album ).c_str(), -1 /*strLen*/, SQLITE_TRANSIENT ) ) &&
 				( SQLITE_ROW == sqlite3_step( stmt ) );
-		sqlite3_finalize( stmt );
+		m_Database.ReleaseStatement( stmt );
 	}
 	return exists;
 }
@@ -1095,11 +1251,11 @@ bool Library::GetArtistAndAlbumExists( const std::wstring& artist, const std::ws
 	if ( nullptr != database ) {
 		const std::string query = "SELECT 1 FROM Media WHERE EXISTS( SELECT 1 FROM Media WHERE Artist=?1 AND Album=?2 );";
 		sqlite3_stmt* stmt = nullptr;
-		exists = ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) &&
+		exists = ( SQLITE_OK == m_Database.PrepareStatement( query, &stmt ) ) &&
 				( SQLITE_OK == sqlite3_bind_text( stmt, 1 /*param*/, WideStringToUTF8( artist ).c_str(), -1 /*strLen*/, SQLITE_TRANSIENT ) ) &&
 				( SQLITE_OK == sqlite3_bind_text( stmt, 2 /*param*/, WideStringToUTF8( album ).c_str(), -1 /*strLen*/, SQLITE_TRANSIENT ) ) &&
 				( SQLITE_ROW == sqlite3_step( stmt ) );
-		sqlite3_finalize( stmt );
+		m_Database.ReleaseStatement( stmt );
 	}
 	return exists;
 }
@@ -1111,10 +1267,10 @@ bool Library::GetGenreExists( const std::wstring& genre )
 	if ( nullptr != database ) {
 		const std::string query = "SELECT 1 FROM Media WHERE EXISTS( SELECT 1 FROM Media WHERE Genre=?1 );";
 		sqlite3_stmt* stmt = nullptr;
-		exists = ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) &&
+		exists = ( SQLITE_OK == m_Database.PrepareStatement( query, &stmt ) ) &&
 				( SQLITE_OK == sqlite3_bind_text( stmt, 1 /*param*/, WideStringToUTF8( genre ).c_str(), -1 /*strLen*/, SQLITE_TRANSIENT ) ) &&
 				( SQLITE_ROW == sqlite3_step( stmt ) );
-		sqlite3_finalize( stmt );
+		m_Database.ReleaseStatement( stmt );
 	}
 	return exists;
 }
@@ -1127,10 +1283,10 @@ bool Library::GetYearExists( const long year )
 		if ( nullptr != database ) {
 			const std::string query = "SELECT 1 FROM Media WHERE EXISTS( SELECT 1 FROM Media WHERE Year=?1 );";
 			sqlite3_stmt* stmt = nullptr;
-			exists = ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) &&
+			exists = ( SQLITE_OK == m_Database.PrepareStatement( query, &stmt ) ) &&
 					( SQLITE_OK == sqlite3_bind_int( stmt, 1 /*param*/, static_cast<int>( year ) ) ) &&
 					( SQLITE_ROW == sqlite3_step( stmt ) );
-			sqlite3_finalize( stmt );
+			m_Database.ReleaseStatement( stmt );
 		}
 	}
 	return exists;
@@ -1144,17 +1300,228 @@ bool Library::RemoveFromLibrary( const MediaInfo& mediaInfo )
 	if ( ( nullptr != database ) && !filename.empty() && ( MediaInfo::Source::File == mediaInfo.GetSource() ) ) {
 		const std::string query = "DELETE FROM Media WHERE Filename=?1;";
 		sqlite3_stmt* stmt = nullptr;
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
+		if ( SQLITE_OK == m_Database.PrepareStatement( query, &stmt ) ) {
 			if ( SQLITE_OK == sqlite3_bind_text( stmt, 1 /*param*/, WideStringToUTF8( filename ).c_str(), -1 /*strLen*/, SQLITE_TRANSIENT ) ) {
 				// Should be a maximum of one entry.
 				removed = ( SQLITE_DONE == sqlite3_step( stmt ) );
 			}
-			sqlite3_finalize( stmt );
+			m_Database.ReleaseStatement( stmt );
+		}
+
+		const std::string seekIndexQuery = "DELETE FROM SeekIndex WHERE Filename=?1;";
+		if ( SQLITE_OK == m_Database.PrepareStatement( seekIndexQuery, &stmt ) ) {
+			if ( SQLITE_OK == sqlite3_bind_text( stmt, 1 /*param*/, WideStringToUTF8( filename ).c_str(), -1 /*strLen*/, SQLITE_TRANSIENT ) ) {
+				sqlite3_step( stmt );
+			}
+			m_Database.ReleaseStatement( stmt );
+		}
+
+		const std::string analysisQuery = "DELETE FROM Analysis WHERE Filename=?1;";
+		if ( SQLITE_OK == m_Database.PrepareStatement( analysisQuery, &stmt ) ) {
+			if ( SQLITE_OK == sqlite3_bind_text( stmt, 1 /*param*/, WideStringToUTF8( filename ).c_str(), -1 /*strLen*/, SQLITE_TRANSIENT ) ) {
+				sqlite3_step( stmt );
+			}
+			m_Database.ReleaseStatement( stmt );
 		}
 	}
 	return removed;
 }
 
+SeekIndex::Ptr Library::GetSeekIndex( const MediaInfo& mediaInfo, bool& indexable )
+{
+	SeekIndex::Ptr seekIndex;
+	indexable = true;
+	sqlite3* database = m_Database.GetDatabase();
+	const std::wstring& filename = mediaInfo.GetFilename();
+	if ( ( nullptr != database ) && !filename.empty() && ( MediaInfo::Source::File == mediaInfo.GetSource() ) ) {
+		const std::string query = "SELECT Data FROM SeekIndex WHERE Filename=?1 AND Filetime=?2 AND Filesize=?3;";
+		sqlite3_stmt* stmt = nullptr;
+		if ( SQLITE_OK == m_Database.PrepareStatement( query, &stmt ) ) {
+			if ( ( SQLITE_OK == sqlite3_bind_text( stmt, 1 /*param*/, WideStringToUTF8( filename ).c_str(), -1 /*strLen*/, SQLITE_TRANSIENT ) ) &&
+					( SQLITE_OK == sqlite3_bind_int64( stmt, 2 /*param*/, static_cast<sqlite3_int64>( mediaInfo.GetFiletime() ) ) ) &&
+					( SQLITE_OK == sqlite3_bind_int64( stmt, 3 /*param*/, static_cast<sqlite3_int64>( mediaInfo.GetFilesize() ) ) ) ) {
+				if ( SQLITE_ROW == sqlite3_step( stmt ) ) {
+					// A file which is not indexable is stored without any seek index data.
+					const size_t numBytes = static_cast<size_t>( sqlite3_column_bytes( stmt, 0 /*columnIndex*/ ) );
+					indexable = ( SQLITE_NULL != sqlite3_column_type( stmt, 0 /*columnIndex*/ ) );
+					if ( numBytes > 0 ) {
+						const BYTE* bytes = static_cast<const BYTE*>( sqlite3_column_blob( stmt, 0 /*columnIndex*/ ) );
+						if ( nullptr != bytes ) {
+							if ( const auto index = std::make_shared<SeekIndex>( std::vector<BYTE>( bytes, bytes + numBytes ) ); !index->IsEmpty() ) {
+								seekIndex = index;
+							}
+						}
+					}
+				}
+			}
+			m_Database.ReleaseStatement( stmt );
+		}
+	}
+	return seekIndex;
+}
+
+bool Library::SetSeekIndex( const MediaInfo& mediaInfo, const SeekIndex& seekIndex )
+{
+	bool success = false;
+	sqlite3* database = m_Database.GetDatabase();
+	const std::wstring& filename = mediaInfo.GetFilename();
+	const std::vector<BYTE> data = seekIndex.GetData();
+	if ( ( nullptr != database ) && !filename.empty() && !data.empty() && ( MediaInfo::Source::File == mediaInfo.GetSource() ) ) {
+		const std::string query = "REPLACE INTO SeekIndex (Filename,Filetime,Filesize,Data) VALUES (?1,?2,?3,?4);";
+		sqlite3_stmt* stmt = nullptr;
+		if ( SQLITE_OK == m_Database.PrepareStatement( query, &stmt ) ) {
+			sqlite3_bind_text( stmt, 1, WideStringToUTF8( filename ).c_str(), -1 /*strLen*/, SQLITE_TRANSIENT );
+			sqlite3_bind_int64( stmt, 2, static_cast<sqlite3_int64>( mediaInfo.GetFiletime() ) );
+			sqlite3_bind_int64( stmt, 3, static_cast<sqlite3_int64>( mediaInfo.GetFilesize() ) );
+			sqlite3_bind_blob( stmt, 4, data.data(), static_cast<int>( data.size() ), SQLITE_STATIC );
+			success = ( SQLITE_DONE == sqlite3_step( stmt ) );
+			m_Database.ReleaseStatement( stmt );
+		}
+	}
+	return success;
+}
+
+bool Library::SetSeekIndexUnavailable( const MediaInfo& mediaInfo )
+{
+	bool success = false;
+	sqlite3* database = m_Database.GetDatabase();
+	const std::wstring& filename = mediaInfo.GetFilename();
+	if ( ( nullptr != database ) && !filename.empty() && ( MediaInfo::Source::File == mediaInfo.GetSource() ) ) {
+		const std::string query = "REPLACE INTO SeekIndex (Filename,Filetime,Filesize,Data) VALUES (?1,?2,?3,NULL);";
+		sqlite3_stmt* stmt = nullptr;
+		if ( SQLITE_OK == m_Database.PrepareStatement( query, &stmt ) ) {
+			sqlite3_bind_text( stmt, 1, WideStringToUTF8( filename ).c_str(), -1 /*strLen*/, SQLITE_TRANSIENT );
+			sqlite3_bind_int64( stmt, 2, static_cast<sqlite3_int64>( mediaInfo.GetFiletime() ) );
+			sqlite3_bind_int64( stmt, 3, static_cast<sqlite3_int64>( mediaInfo.GetFilesize() ) );
+			success = ( SQLITE_DONE == sqlite3_step( stmt ) );
+			m_Database.ReleaseStatement( stmt );
+		}
+	}
+	return success;
+}
+
+std::optional<TrackAnalyser::Results> Library::GetAnalysis( const MediaInfo& mediaInfo )
+{
+	std::optional<TrackAnalyser::Results> results;
+	sqlite3* database = m_Database.GetDatabase();
+	const std::wstring& filename = mediaInfo.GetFilename();
+	if ( ( nullptr != database ) && !filename.empty() && ( MediaInfo::Source::File == mediaInfo.GetSource() ) ) {
+		const std::string query = "SELECT TrackGain,TruePeak,LeadingSilence,TrailingSilence,CrossfadePosition FROM Analysis WHERE Filename=?1 AND Filetime=?2 AND Filesize=?3;";
+		sqlite3_stmt* stmt = nullptr;
+		if ( SQLITE_OK == m_Database.PrepareStatement( query, &stmt ) ) {
+			if ( ( SQLITE_OK == sqlite3_bind_text( stmt, 1 /*param*/, WideStringToUTF8( filename ).c_str(), -1 /*strLen*/, SQLITE_TRANSIENT ) ) &&
+					( SQLITE_OK == sqlite3_bind_int64( stmt, 2 /*param*/, static_cast<sqlite3_int64>( mediaInfo.GetFiletime() ) ) ) &&
+					( SQLITE_OK == sqlite3_bind_int64( stmt, 3 /*param*/, static_cast<sqlite3_int64>( mediaInfo.GetFilesize() ) ) ) ) {
+				if ( SQLITE_ROW == sqlite3_step( stmt ) ) {
+					const auto getValue = [ stmt ] ( const int columnIndex ) -> std::optional<float>
+					{
+						std::optional<float> value;
+						if ( SQLITE_NULL != sqlite3_column_type( stmt, columnIndex ) ) {
+							value = static_cast<float>( sqlite3_column_double( stmt, columnIndex ) );
+						}
+						return value;
+					};
+					results = TrackAnalyser::Results();
+					results->TrackGain = getValue( 0 );
+					results->TruePeak = getValue( 1 );
+					results->LeadingSilence = getValue( 2 );
+					results->TrailingSilence = getValue( 3 );
+					results->CrossfadePosition = getValue( 4 );
+				}
+			}
+			m_Database.ReleaseStatement( stmt );
+		}
+	}
+	return results;
+}
+
+bool Library::SetAnalysis( const MediaInfo& mediaInfo, const TrackAnalyser::Results& results )
+{
+	bool success = false;
+	sqlite3* database = m_Database.GetDatabase();
+	const std::wstring& filename = mediaInfo.GetFilename();
+	if ( ( nullptr != database ) && !filename.empty() && ( MediaInfo::Source::File == mediaInfo.GetSource() ) ) {
+		TrackAnalyser::Results mergedResults( results );
+		if ( const auto previousResults = GetAnalysis( mediaInfo ); previousResults.has_value() ) {
+			mergedResults.Merge( *previousResults );
+		}
+
+		const std::string query = "REPLACE INTO Analysis (Filename,Filetime,Filesize,TrackGain,TruePeak,LeadingSilence,TrailingSilence,CrossfadePosition) VALUES (?1,?2,?3,?4,?5,?6,?7,?8);";
+		sqlite3_stmt* stmt = nullptr;
+		if ( SQLITE_OK == m_Database.PrepareStatement( query, &stmt ) ) {
+			const auto bindValue = [ stmt ] ( const int param, const std::optional<float>& value )
+			{
+				if ( value.has_value() && std::isfinite( *value ) ) {
+					sqlite3_bind_double( stmt, param, *value );
+				} else {
+					sqlite3_bind_null( stmt, param );
+				}
+			};
+			sqlite3_bind_text( stmt, 1, WideStringToUTF8( filename ).c_str(), -1 /*strLen*/, SQLITE_TRANSIENT );
+			sqlite3_bind_int64( stmt, 2, static_cast<sqlite3_int64>( mediaInfo.GetFiletime() ) );
+			sqlite3_bind_int64( stmt, 3, static_cast<sqlite3_int64>( mediaInfo.GetFilesize() ) );
+			bindValue( 4, mergedResults.TrackGain );
+			bindValue( 5, mergedResults.TruePeak );
+			bindValue( 6, mergedResults.LeadingSilence );
+			bindValue( 7, mergedResults.TrailingSilence );
+			bindValue( 8, mergedResults.CrossfadePosition );
+			success = ( SQLITE_DONE == sqlite3_step( stmt ) );
+			m_Database.ReleaseStatement( stmt );
+		}
+	}
+	return success;
+}
+
+Library::FolderFingerprints Library::GetFolderFingerprints()
+{
+	FolderFingerprints fingerprints;
+	sqlite3* database = m_Database.GetDatabase();
+	if ( nullptr != database ) {
+		const std::string query = "SELECT Folder,Modified,Entries,Hash FROM Folders;";
+		sqlite3_stmt* stmt = nullptr;
+		if ( SQLITE_OK == m_Database.PrepareStatement( query, &stmt ) ) {
+			while ( SQLITE_ROW == sqlite3_step( stmt ) ) {
+				if ( const char* text = reinterpret_cast<const char*>( sqlite3_column_text( stmt, 0 /*columnIndex*/ ) ); nullptr != text ) {
+					FolderFingerprint fingerprint;
+					fingerprint.Modified = static_cast<long long>( sqlite3_column_int64( stmt, 1 /*columnIndex*/ ) );
+					fingerprint.Entries = static_cast<long long>( sqlite3_column_int64( stmt, 2 /*columnIndex*/ ) );
+					fingerprint.Hash = static_cast<long long>( sqlite3_column_int64( stmt, 3 /*columnIndex*/ ) );
+					fingerprints.insert( FolderFingerprints::value_type( UTF8ToWideString( text ), fingerprint ) );
+				}
+			}
+			m_Database.ReleaseStatement( stmt );
+		}
+	}
+	return fingerprints;
+}
+
+bool Library::SetFolderFingerprints( const FolderFingerprints& fingerprints )
+{
+	bool success = false;
+	sqlite3* database = m_Database.GetDatabase();
+	if ( nullptr != database ) {
+		// Use a single transaction, so that the previous fingerprints are only replaced if all the new fingerprints are written.
+		Database::Transaction transaction( m_Database );
+		success = ( SQLITE_OK == sqlite3_exec( database, "DELETE FROM Folders;", NULL /*callback*/, NULL /*arg*/, NULL /*errMsg*/ ) );
+		if ( success ) {
+			const std::string query = "INSERT INTO Folders (Folder,Modified,Entries,Hash) VALUES (?1,?2,?3,?4);";
+			sqlite3_stmt* stmt = nullptr;
+			success = ( SQLITE_OK == m_Database.PrepareStatement( query, &stmt ) );
+			for ( auto fingerprint = fingerprints.begin(); success && ( fingerprints.end() != fingerprint ); fingerprint++ ) {
+				success = ( SQLITE_OK == sqlite3_bind_text( stmt, 1 /*param*/, WideStringToUTF8( fingerprint->first ).c_str(), -1 /*strLen*/, SQLITE_TRANSIENT ) ) &&
+					( SQLITE_OK == sqlite3_bind_int64( stmt, 2 /*param*/, static_cast<sqlite3_int64>( fingerprint->second.Modified ) ) ) &&
+					( SQLITE_OK == sqlite3_bind_int64( stmt, 3 /*param*/, static_cast<sqlite3_int64>( fingerprint->second.Entries ) ) ) &&
+					( SQLITE_OK == sqlite3_bind_int64( stmt, 4 /*param*/, static_cast<sqlite3_int64>( fingerprint->second.Hash ) ) ) &&
+					( SQLITE_DONE == sqlite3_step( stmt ) );
+				sqlite3_reset( stmt );
+			}
+			m_Database.ReleaseStatement( stmt );
+		}
+		success = success && transaction.Commit();
+	}
+	return success;
+}
+
 const Library::Columns& Library::GetColumns( const MediaInfo::Source source ) const
 {
 	const Columns& columns = ( MediaInfo::Source::CDDA == source ) ? m_CDDAColumns : m_MediaColumns;
@@ -1242,6 +1609,7 @@ void Library::UpdateMediaInfoFromTags( MediaInfo& mediaInfo, const Tags& tags )
 
 void Library::AddPendingTags( const std::wstring& filename, const Tags& tags )
 {
+	std::lock_guard<std::mutex> lock( m_PendingTagsMutex );
 	auto tagIter = m_PendingTags.find( filename );
 	if ( m_PendingTags.end() != tagIter ) {
 		Tags& pendingTags = tagIter->second;
@@ -1256,6 +1624,7 @@ void Library::AddPendingTags( const std::wstring& filename, const Tags& tags )
 bool Library::GetPendingTags( const std::wstring& filename, Tags& tags ) const
 {
 	tags.clear();
+	std::lock_guard<std::mutex> lock( m_PendingTagsMutex );
 	const auto tagIter = m_PendingTags.find( filename );
 	if ( m_PendingTags.end() != tagIter ) {
 		tags = tagIter->second;
@@ -1291,7 +1660,7 @@ bool Library::UpdateTrackGain( const MediaInfo& previousInfo, const MediaInfo& u
 				"UPDATE CDDA SET GainTrack=?1 WHERE CDDB=?2 AND Track=?3;" :
 				"UPDATE Media SET GainTrack=?1 WHERE Filename=?2;";
 			sqlite3_stmt* stmt = nullptr;
-			updated = ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) );
+			updated = ( SQLITE_OK == m_Database.PrepareStatement( query, &stmt ) );
 			if ( updated ) {
 				const auto gain = updatedInfo.GetGainTrack();
 				updated = gain.has_value() ? ( SQLITE_OK == sqlite3_bind_double( stmt, 1 /*param*/, gain.value() ) ) : ( SQLITE_OK == sqlite3_bind_null( stmt, 1 /*param*/ ) );
@@ -1306,7 +1675,7 @@ bool Library::UpdateTrackGain( const MediaInfo& previousInfo, const MediaInfo& u
 						updated = ( SQLITE_DONE == sqlite3_step( stmt ) );
 					}
 				}
-				sqlite3_finalize( stmt );
+				m_Database.ReleaseStatement( stmt );
 			}
 		}
 	}
@@ -3,7 +3,11 @@
 #include "Database.h"
 #include "Handlers.h"
 #include "MediaInfo.h"
+#include "SeekIndex.h"
+#include "TrackAnalyser.h"
 
+#include <map>
+#include <optional>
 #include <vector>
 
 // Media library
@@ -53,6 +57,22 @@ public:
 	// Returns true if media information was returned.
 	bool GetMediaInfo( MediaInfo& mediaInfo, const bool checkFileAttributes = true, const bool scanMedia = true, const bool sendNotification = true, const bool removeMissing = false );
 
+	// Gets media information for a batch of files, scanning any file which does not have a matching entry (and writing the scanned information to the library using a single transaction).
+	// 'mediaList' - in/out, media information containing the filenames to query, from which any entries for which no media information was found are removed.
+	// 'sendNotification' - whether to notify the main app of any changed media information (using a single notification for the batch).
+	// 'removeMissing' - whether to remove media information from the library for any files which cannot be opened.
+	void GetMediaInfo( MediaInfo::List& mediaList, const bool sendNotification = true, const bool removeMissing = false );
+
+	// Adds (or replaces) media information in the library, using a single transaction.
+	// 'mediaList' - in/out, media information to write, from which any entries which could not be written are removed.
+	// 'sendNotification' - whether to notify the main app of the written media information (using a single notification for the batch).
+	void AddMediaInfo( MediaInfo::List& mediaList, const bool sendNotification = false );
+
+	// Scans the file specified in 'mediaInfo' for media information, including any pending tags, without updating the library.
+	// 'mediaInfo' - in/out, media information containing the filename to scan.
+	// Returns true if the file was successfully opened by a decoder.
+	bool ScanMediaInfo( MediaInfo& mediaInfo );
+
 	// Updates media information and writes out tag information to file.
 	// 'previousMediaInfo' - previous media information.
 	// 'updatedMediaInfo' - updated media information.
@@ -143,6 +163,44 @@ public:
 	// Returns whether there has been a recent attempt to write the tags for the 'filename'.
 	bool HasRecentlyWrittenTag( const std::wstring& filename ) const;
 
+	// Returns the seek index for the 'mediaInfo', or nullptr if there is no seek index matching the file time & size.
+	// 'indexable' - out, false if the file (with a matching file time & size) has been marked as not indexable.
+	SeekIndex::Ptr GetSeekIndex( const MediaInfo& mediaInfo, bool& indexable );
+
+	// Stores the 'seekIndex' for the 'mediaInfo', returning whether the library was updated.
+	bool SetSeekIndex( const MediaInfo& mediaInfo, const SeekIndex& seekIndex );
+
+	// Marks the 'mediaInfo' as not indexable (until its file time or size changes), returning whether the library was updated.
+	bool SetSeekIndexUnavailable( const MediaInfo& mediaInfo );
+
+	// Returns the track analysis results for the 'mediaInfo', or nullopt if there are no results matching the file time & size.
+	std::optional<TrackAnalyser::Results> GetAnalysis( const MediaInfo& mediaInfo );
+
+	// Stores the analysis 'results' for the 'mediaInfo' (retaining any previously stored results which are not available), returning whether the library was updated.
+	bool SetAnalysis( const MediaInfo& mediaInfo, const TrackAnalyser::Results& results );
+
+	// Fingerprint of a folder listing, recorded by the library scanner.
+	struct FolderFingerprint {
+		long long Modified = 0;		// Last modified time of the folder.
+		long long Entries = 0;		// Number of files & subfolders in the folder.
+		long long Hash = 0;				// Hash of the names of the files & subfolders in the folder, along with the file times & sizes.
+
+		bool operator==( const FolderFingerprint& other ) const
+		{
+			return ( Modified == other.Modified ) && ( Entries == other.Entries ) && ( Hash == other.Hash );
+		}
+	};
+
+	// Maps a folder name to its fingerprint.
+	using FolderFingerprints = std::map<std::wstring, FolderFingerprint>;
+
+	// Returns the folder fingerprints recorded by the last library scan.
+	FolderFingerprints GetFolderFingerprints();
+
+	// Replaces all recorded folder fingerprints with the 'fingerprints', using a single transaction.
+	// Returns whether the library was updated.
+	bool SetFolderFingerprints( const FolderFingerprints& fingerprints );
+
 private:
 	// Media library columns.
 	typedef std::map<std::string,Column> Columns;
@@ -162,6 +220,15 @@ private:
 	// Updates the artwork table if necessary.
 	void UpdateArtworkTable();
 
+	// Updates the seek index table if necessary.
+	void UpdateSeekIndexTable();
+
+	// Updates the analysis table if necessary.
+	void UpdateAnalysisTable();
+
+	// Updates the folder table if necessary.
+	void UpdateFolderTable();
+
 	// Creates indices if necessary.
 	void CreateIndices();
 
@@ -178,6 +245,18 @@ private:
 	// Returns true if the library was updated.
 	bool UpdateMediaLibrary( const MediaInfo& mediaInfo );
 
+	// Updates the media library using a single transaction.
+	// 'mediaList' - media information.
+	// Returns a flag for each entry in the 'mediaList', indicating whether the library was updated.
+	std::vector<bool> UpdateMediaLibrary( const MediaInfo::List& mediaList );
+
+	// Returns the query with which to update the media library table for the 'source'.
+	std::string GetUpdateQuery( const MediaInfo::Source source ) const;
+
+	// Binds the 'mediaInfo' to the prepared update 'stmt', and executes the statement.
+	// Returns true if the library was updated.
+	bool WriteMediaInfo( sqlite3_stmt* stmt, const MediaInfo& mediaInfo );
+
 	// Writes out tag information to file.
 	// 'mediaInfo' - in/out, media information which will be modified if tags are successfully written.
 	// 'tags' - tags to write.
@@ -220,6 +299,9 @@ private:
 	// Tag information waiting to be written.
 	FileTags m_PendingTags;
 
+	// Mutex for the tag information waiting to be written (which is read by library scanner threads).
+	mutable std::mutex m_PendingTagsMutex;
+
 	// The time that the last attempt was made to write tags.
 	long long m_LastTagWriteTime;
 
@@ -0,0 +1,146 @@
+#include "LibraryBenchmark.h"
+
+#include "Utility.h"
+
+#include <algorithm>
+#include <cstdint>
+
+// Number of synthetic entries in the media table.
+constexpr long kMediaCount = 200000;
+
+// Number of lookups in each pass.
+constexpr long kLookupCount = 100000;
+
+// Number of passes for each statement cache mode (passes alternate between modes, so that neither mode benefits from the SQLite page cache being warmed by the other).
+constexpr long kPassCount = 5;
+
+// Seed for the lookup order.
+constexpr uint32_t kRandomSeed = 1974;
+
+LibraryBenchmark::LibraryBenchmark( const Handlers& handlers ) :
+	m_Handlers( handlers )
+{
+}
+
+LibraryBenchmark::~LibraryBenchmark()
+{
+}
+
+bool LibraryBenchmark::Run( const std::wstring& outputFilename ) const
+{
+	bool success = false;
+	Database database( {} /*filename*/, Database::Mode::Memory );
+	Library library( database, m_Handlers );
+	if ( Populate( database ) ) {
+		// The first measurement is without the statement cache, and the second is with the statement cache.
+		Measurements measurements( 2 );
+		measurements.back().Cached = true;
+		std::vector<std::vector<double>> passes( measurements.size() );
+		for ( long pass = 0; pass < kPassCount; pass++ ) {
+			for ( size_t index = 0; index < measurements.size(); index++ ) {
+				Measurement& measurement = measurements[ index ];
+				measurement.Lookups += kLookupCount;
+				passes[ index ].push_back( Measure( database, library, measurement.Cached, measurement.Found ) );
+			}
+		}
+		for ( size_t index = 0; index < measurements.size(); index++ ) {
+			std::vector<double>& values = passes[ index ];
+			std::sort( values.begin(), values.end() );
+			measurements[ index ].LookupsPerSecond = values[ values.size() / 2 ];
+		}
+		success = IsBenchmarkCSV( outputFilename ) ? WriteCSV( measurements, outputFilename ) : WriteJSON( measurements, outputFilename );
+	}
+	return success;
+}
+
+bool LibraryBenchmark::Populate( Database& database )
+{
+	bool success = false;
+	sqlite3* db = database.GetDatabase();
+	if ( nullptr != db ) {
+		Database::Transaction transaction( database );
+		const std::string query = "REPLACE INTO Media (Filename,Filetime,Filesize,Duration,Artist,Title,Album,Track) VALUES (?1,?2,?3,?4,?5,?6,?7,?8);";
+		sqlite3_stmt* stmt = nullptr;
+		if ( SQLITE_OK == database.PrepareStatement( query, &stmt ) ) {
+			success = true;
+			for ( long index = 0; success && ( index < kMediaCount ); index++ ) {
+				const long album = index / 12;
+				success =
+					( SQLITE_OK == sqlite3_bind_text( stmt, 1 /*param*/, WideStringToUTF8( GetFilename( index ) ).c_str(), -1 /*strLen*/, SQLITE_TRANSIENT ) ) &&
+					( SQLITE_OK == sqlite3_bind_int64( stmt, 2 /*param*/, 132000000000000000ll + index ) ) &&
+					( SQLITE_OK == sqlite3_bind_int64( stmt, 3 /*param*/, 8000000ll + index ) ) &&
+					( SQLITE_OK == sqlite3_bind_double( stmt, 4 /*param*/, 180.0 + ( index % 120 ) ) ) &&
+					( SQLITE_OK == sqlite3_bind_text( stmt, 5 /*param*/, ( "Artist " + std::to_string( album / 10 ) ).c_str(), -1 /*strLen*/, SQLITE_TRANSIENT ) ) &&
+					( SQLITE_OK == sqlite3_bind_text( stmt, 6 /*param*/, ( "Title " + std::to_string( index ) ).c_str(), -1 /*strLen*/, SQLITE_TRANSIENT ) ) &&
+					( SQLITE_OK == sqlite3_bind_text( stmt, 7 /*param*/, ( "Album " + std::to_string( album ) ).c_str(), -1 /*strLen*/, SQLITE_TRANSIENT ) ) &&
+					( SQLITE_OK == sqlite3_bind_int( stmt, 8 /*param*/, 1 + ( index % 12 ) ) ) &&
+					( SQLITE_DONE == sqlite3_step( stmt ) ) &&
+					( SQLITE_OK == sqlite3_reset( stmt ) );
+			}
+			database.ReleaseStatement( stmt );
+		}
+		success = success && transaction.Commit();
+	}
+	return success;
+}
+
+std::wstring LibraryBenchmark::GetFilename( const long index )
+{
+	return L"C:\\Music\\Artist " + std::to_wstring( index / 120 ) + L"\\Album " + std::to_wstring( index / 12 ) + L"\\" + std::to_wstring( index ) + L".flac";
+}
+
+double LibraryBenchmark::Measure( Database& database, Library& library, const bool cached, long& found )
+{
+	// Generate the lookup filenames up front, so that only the lookups are timed.
+	std::vector<std::wstring> filenames;
+	filenames.reserve( kLookupCount );
+	uint32_t random = kRandomSeed;
+	for ( long lookup = 0; lookup < kLookupCount; lookup++ ) {
+		random = random * 1664525u + 1013904223u;
+		filenames.push_back( GetFilename( static_cast<long>( random % kMediaCount ) ) );
+	}
+
+	const LONGLONG startTick = GetBenchmarkTick();
+	for ( const auto& filename : filenames ) {
+		if ( !cached ) {
+			// Emulate preparing & finalizing the statement for every lookup.
+			database.ClearStatementCache();
+		}
+		MediaInfo mediaInfo( filename );
+		if ( library.GetMediaInfo( mediaInfo, false /*checkFileAttributes*/, false /*scanMedia*/, false /*sendNotification*/ ) ) {
+			++found;
+		}
+	}
+	const double seconds = GetBenchmarkSeconds( startTick, GetBenchmarkTick() );
+	return ( seconds > 0 ) ? ( kLookupCount / seconds ) : 0;
+}
+
+bool LibraryBenchmark::WriteJSON( const Measurements& measurements, const std::wstring& outputFilename )
+{
+	nlohmann::json document;
+	for ( const auto& measurement : measurements ) {
+		nlohmann::json entry;
+		entry[ "lookups" ] = measurement.Lookups;
+		entry[ "found" ] = measurement.Found;
+		entry[ "lookups_per_second" ] = measurement.LookupsPerSecond;
+		document[ GetModeName( measurement.Cached ) ] = entry;
+	}
+	document[ "media_count" ] = kMediaCount;
+
+	return WriteBenchmarkJSON( document, outputFilename );
+}
+
+bool LibraryBenchmark::WriteCSV( const Measurements& measurements, const std::wstring& outputFilename )
+{
+	return WriteBenchmarkCSV( outputFilename, "statements,media_count,lookups,found,lookups_per_second", [ &measurements ] ( std::ostream& stream )
+	{
+		for ( const auto& measurement : measurements ) {
+			stream << GetModeName( measurement.Cached ) << "," << kMediaCount << "," << measurement.Lookups << "," << measurement.Found << "," << measurement.LookupsPerSecond << std::endl;
+		}
+	} );
+}
+
+std::string LibraryBenchmark::GetModeName( const bool cached )
+{
+	return cached ? "cached" : "uncached";
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "stdafx.h"
+
+#include "BenchmarkUtility.h"
+#include "Library.h"
+
+#include <string>
+#include <vector>
+
+// Measures media library lookup throughput, with and without the prepared statement cache, using a synthetic media table.
+class LibraryBenchmark
+{
+public:
+	// 'handlers' - media handlers.
+	LibraryBenchmark( const Handlers& handlers );
+
+	virtual ~LibraryBenchmark();
+
+	// Runs the benchmark.
+	// 'outputFilename' - results file, written as CSV if the file has a .csv extension, otherwise as JSON.
+	// Returns whether the results were written.
+	bool Run( const std::wstring& outputFilename ) const;
+
+private:
+	// Measurement for a statement cache mode.
+	struct Measurement {
+		bool Cached = false;					// Whether the prepared statement cache was used.
+		long Lookups = 0;							// Number of lookups.
+		long Found = 0;								// Number of lookups which found the media.
+		double LookupsPerSecond = 0;	// Throughput, in lookups per second (median of all passes).
+	};
+
+	// A list of measurements.
+	using Measurements = std::vector<Measurement>;
+
+	// Populates the media table in the 'database' with synthetic entries, returning whether the table was populated.
+	static bool Populate( Database& database );
+
+	// Returns the synthetic filename for the media 'index'.
+	static std::wstring GetFilename( const long index );
+
+	// Measures the lookup throughput for a single pass over the 'library', returning the number of lookups per second.
+	// 'database' - database containing the 'library'.
+	// 'cached' - whether to use the prepared statement cache.
+	// 'found' - out, the number of lookups which found the media.
+	static double Measure( Database& database, Library& library, const bool cached, long& found );
+
+	// Writes the 'measurements' as JSON to the 'outputFilename', returning whether the file was written.
+	static bool WriteJSON( const Measurements& measurements, const std::wstring& outputFilename );
+
+	// Writes the 'measurements' as CSV to the 'outputFilename', returning whether the file was written.
+	static bool WriteCSV( const Measurements& measurements, const std::wstring& outputFilename );
+
+	// Returns the name of a statement cache mode.
+	static std::string GetModeName( const bool cached );
+
+	// Media handlers.
+	const Handlers& m_Handlers;
+};
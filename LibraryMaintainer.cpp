@@ -3,22 +3,11 @@
 #include "Utility.h"
 #include "VUPlayer.h"
 
-DWORD WINAPI LibraryMaintainer::MaintainerThreadProc( LPVOID lpParam )
-{
-	LibraryMaintainer* maintainer = static_cast<LibraryMaintainer*>( lpParam );
-	if ( nullptr != maintainer ) {
-		CoInitializeEx( NULL /*reserved*/, COINIT_APARTMENTTHREADED );
-		maintainer->Handler();
-		CoUninitialize();
-	}
-	return 0;
-}
-
 LibraryMaintainer::LibraryMaintainer( const HINSTANCE instance, Library& library, Handlers& handlers ) :
 	m_Library( library ),
 	m_SupportedFileExtensions(),
 	m_StopEvent( CreateEvent( NULL /*attributes*/, TRUE /*manualReset*/, FALSE /*initialState*/, L"" /*name*/ ) ),
-	m_Thread( nullptr ),
+	m_TaskGroup(),
 	m_Status(),
 	m_StatusMutex(),
 	m_StatusScanningComputer(),
@@ -44,24 +33,20 @@ LibraryMaintainer::~LibraryMaintainer()
 	CloseHandle( m_StopEvent );
 }
 
-void LibraryMaintainer::Start( FileAddedCallback callback )
+void LibraryMaintainer::Start( FileAddedCallback callback, const bool quick )
 {
 	Stop();
 	m_FileAddedCallback = callback;
-	m_Thread = CreateThread( NULL /*attributes*/, 0 /*stackSize*/, MaintainerThreadProc, reinterpret_cast<LPVOID>( this ), 0 /*flags*/, NULL /*threadId*/ );
-	if ( nullptr != m_Thread ) {
-		SetThreadPriority( m_Thread, THREAD_PRIORITY_LOWEST );
-	}
+	TaskScheduler::GetBackground().Submit( m_TaskGroup, TaskScheduler::Priority::Library, [ this, quick ] ()
+	{
+		Handler( quick );
+	} );
 }
 
 void LibraryMaintainer::Stop()
 {
-	if ( nullptr != m_Thread ) {
-		SetEvent( m_StopEvent );
-		WaitForSingleObject( m_Thread, INFINITE );
-		CloseHandle( m_Thread );
-		m_Thread = nullptr;
-	}
+	SetEvent( m_StopEvent );
+	m_TaskGroup.Cancel();
 	ResetEvent( m_StopEvent );
 	SetStatus( {} );
 	m_FileAddedCallback = nullptr;
@@ -69,7 +54,7 @@ void LibraryMaintainer::Stop()
 
 bool LibraryMaintainer::IsActive() const
 {
-	return ( nullptr != m_Thread ) && ( WAIT_OBJECT_0 != WaitForSingleObject( m_Thread, 0 ) );
+	return ( m_TaskGroup.GetCount() > 0 );
 }
 
 std::wstring LibraryMaintainer::GetStatus() const
@@ -84,50 +69,31 @@ void LibraryMaintainer::SetStatus( const std::wstring& status )
 	m_Status = status;
 }
 
-void LibraryMaintainer::Handler()
+void LibraryMaintainer::Handler( const bool quick )
 {
-	std::set<std::filesystem::path> allFiles;
-
-	// Scan all drives for supported file types.
 	std::wstring initialStatus = m_StatusScanningComputer;
 	WideStringReplace( initialStatus, L"%", std::to_wstring( 0 ) );
 	SetStatus( initialStatus );
-	const auto drives = GetRootDrives();
-	for ( const auto& drive : drives ) {
-		ScanFolder( drive, allFiles );
-	}
 
-	if ( WAIT_OBJECT_0 != WaitForSingleObject( m_StopEvent, 0 ) ) {
-		// Make a note of existing library files (excluding streams), and merge in any that were not found in the folder scan.
-		std::set<std::filesystem::path> existingFiles;
-		const auto allMedia = m_Library.GetAllMedia();
-		for ( const auto& mediaInfo : allMedia ) {
-			if ( const auto& filename = mediaInfo.GetFilename(); !IsURL( filename ) ) {
-				existingFiles.insert( mediaInfo.GetFilename() );
-				allFiles.insert( filename );
-			}
+	// Scan all drives for supported file types, and refresh library information for all the files (as well as any existing library files which were not found).
+	// A quick scan skips any folders which have not been modified since the last scan.
+	LibraryScanner scanner( m_Library, m_SupportedFileExtensions );
+	scanner.Run( GetRootDrives(), quick, m_StopEvent, m_FileAddedCallback, [ this ] ( const LibraryScanner::Progress& progress )
+	{
+		std::wstring status;
+		if ( progress.Enumerating ) {
+			status = m_StatusScanningComputer;
+			WideStringReplace( status, L"%", std::to_wstring( progress.Found ) );
+		} else {
+			status = m_StatusUpdatingLibrary;
+			WideStringReplace( status, L"%1", std::to_wstring( progress.Processed ) );
+			WideStringReplace( status, L"%2", std::to_wstring( progress.Found ) );
 		}
-
-		// Refresh library information for all the files.
-		if ( WAIT_OBJECT_0 != WaitForSingleObject( m_StopEvent, 0 ) ) {
-			size_t current = 0;
-			size_t total = allFiles.size();
-			for ( auto path = allFiles.begin(); ( WAIT_OBJECT_0 != WaitForSingleObject( m_StopEvent, 0 ) ) && ( allFiles.end() != path ); ++path ) {
-				std::wstring status = m_StatusUpdatingLibrary;
-				WideStringReplace( status, L"%1", std::to_wstring( ++current ) );
-				WideStringReplace( status, L"%2", std::to_wstring( total ) );
-				status += L" - " + TruncatePath( *path );
-				SetStatus( status );
-
-				MediaInfo mediaInfo( path->c_str() );
-				if ( m_Library.GetMediaInfo( mediaInfo, true /*checkFileAttributes*/, true /*scanMedia*/, true /*sendNotification*/, true /*removeMissing*/ ) ) {
-					if ( ( nullptr != m_FileAddedCallback ) && ( existingFiles.end() == existingFiles.find( *path ) ) ) {
-						m_FileAddedCallback( *path );						
-					}
-				}
-			}
+		if ( !progress.CurrentFile.empty() ) {
+			status += L" - " + TruncatePath( progress.CurrentFile );
 		}
-	}
+		SetStatus( status );
+	} );
 
 	SetStatus( {} );
 }
@@ -154,44 +120,6 @@ std::set<std::wstring> LibraryMaintainer::GetRootDrives()
 	return drives;
 }
 
-void LibraryMaintainer::ScanFolder( const std::filesystem::path& folder, std::set<std::filesystem::path>& mediaFiles )
-{
-	const FINDEX_INFO_LEVELS levels = FindExInfoBasic;
-	const FINDEX_SEARCH_OPS searchOp = FindExSearchNameMatch;
-	const DWORD flags = FIND_FIRST_EX_LARGE_FETCH;
-	WIN32_FIND_DATA findData = {};
-	std::filesystem::path path = folder / L"*.*";
-	const HANDLE handle = FindFirstFileEx( path.c_str(), levels, &findData, searchOp, nullptr /*filter*/, flags );
-	if ( INVALID_HANDLE_VALUE != handle ) {
-		BOOL found = TRUE;
-		while ( found && ( WAIT_OBJECT_0 != WaitForSingleObject( m_StopEvent, 0 ) ) ) {
-			if ( !( ( findData.dwFileAttributes & FILE_ATTRIBUTE_HIDDEN ) || ( findData.dwFileAttributes & FILE_ATTRIBUTE_SYSTEM ) ) ) {
-				if ( findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY ) {
-					if ( ( findData.cFileName[ 0 ] != '.' ) ) {
-						path = folder / findData.cFileName;
-						ScanFolder( path, mediaFiles );
-					}
-				} else if ( IsSupportedFileType( findData.cFileName ) ) {
-					path = folder / findData.cFileName;
-					mediaFiles.insert( path );
-
-					std::wstring status = m_StatusScanningComputer;
-					WideStringReplace( status, L"%", std::to_wstring( mediaFiles.size() ) );
-					status += L" - " + TruncatePath( path );
-					SetStatus( status );			
-				}
-			}
-			found = FindNextFile( handle, &findData );
-		}
-		FindClose( handle );
-	}
-}
-
-bool LibraryMaintainer::IsSupportedFileType( const std::wstring& filename ) const
-{
-	return m_SupportedFileExtensions.end() != m_SupportedFileExtensions.find( GetFileExtension( filename ) );
-}
-
 std::wstring LibraryMaintainer::TruncatePath( const std::filesystem::path& path )
 {
 	static constexpr size_t maxPathLength = 50;
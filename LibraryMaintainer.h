@@ -4,6 +4,8 @@
 #include <filesystem>
 
 #include "Library.h"
+#include "LibraryScanner.h"
+#include "TaskScheduler.h"
 
 // Library maintainer.
 class LibraryMaintainer
@@ -17,10 +19,11 @@ public:
 	virtual ~LibraryMaintainer();
 
 	// A callback for when a new 'file' is added to the library. 
-	using FileAddedCallback = std::function<void( const std::filesystem::path& file )>;
+	using FileAddedCallback = LibraryScanner::FileAddedCallback;
 
 	// Starts library maintenance, using the 'callback'.
-	void Start( FileAddedCallback callback );
+	// 'quick' - whether to skip folders which have not been modified since the last library maintenance.
+	void Start( FileAddedCallback callback, const bool quick = false );
 
 	// Stops library maintenance.
 	void Stop();
@@ -32,24 +35,16 @@ public:
 	std::wstring GetStatus() const;
 
 private:
-	// Thread procedure.
-	static DWORD WINAPI MaintainerThreadProc( LPVOID lpParam );
-
 	// Truncates the 'path' for display purposes.
 	static std::wstring TruncatePath( const std::filesystem::path& path );
 
-	// Maintenance thread handler.
-	void Handler();
+	// Maintenance task handler, which runs the scan (with each folder enumerated as a separate task).
+	// 'quick' - whether to skip folders which have not been modified since the last library maintenance.
+	void Handler( const bool quick );
 
 	// Returns the root drive names.
 	std::set<std::wstring> GetRootDrives();
 
-	// Recursively scans the 'folder' and adds any supported file types to 'mediaFiles'.
-	void ScanFolder( const std::filesystem::path& folder, std::set<std::filesystem::path>& mediaFiles );
-
-	// Returns whether the 'filename' is a supported media file type.
-	bool IsSupportedFileType( const std::wstring& filename ) const;
-
 	// Sets the current 'status'.
 	void SetStatus( const std::wstring& status );
 
@@ -59,8 +54,8 @@ private:
 	// Stop event handle.
 	HANDLE m_StopEvent;
 
-	// Thread handle.
-	HANDLE m_Thread;
+	// Maintenance task.
+	TaskScheduler::Group m_TaskGroup;
 
 	// Current status.
 	std::wstring m_Status;
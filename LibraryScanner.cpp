@@ -0,0 +1,536 @@
+#include "LibraryScanner.h"
+
+#include "Utility.h"
+
+#include <algorithm>
+
+// Maximum number of files waiting to be compared.
+constexpr size_t kCompareQueueCapacity = 4096;
+
+// Maximum number of files waiting to be probed.
+constexpr size_t kProbeQueueCapacity = 256;
+
+// Maximum number of probed files waiting to be written.
+constexpr size_t kWriteQueueCapacity = 256;
+
+// Number of probed files to write to the library as a single batch.
+constexpr size_t kWriteBatchSize = 64;
+
+// Number of comparison & write stage tasks.
+constexpr size_t kCompareWriteStages = 2;
+
+// Interval at which the calling thread checks whether the stage tasks have all started, in milliseconds.
+constexpr DWORD kStageStartInterval = 10;
+
+// Maximum number of concurrent probes on a local device.
+constexpr size_t kMaxLocalDeviceProbes = 4;
+
+// Maximum number of concurrent probes on a network device (for which probes are mostly waiting on network latency).
+constexpr size_t kMaxRemoteDeviceProbes = 16;
+
+// Interval at which progress is reported, in milliseconds.
+constexpr DWORD kProgressInterval = 250;
+
+// FNV-1a offset basis, used to hash folder entries.
+constexpr unsigned long long kHashOffsetBasis = 14695981039346656037ull;
+
+// FNV-1a prime, used to hash folder entries.
+constexpr unsigned long long kHashPrime = 1099511628211ull;
+
+LibraryScanner::LibraryScanner( Library& library, const std::set<std::wstring>& supportedFileExtensions, TaskScheduler& scheduler ) :
+	m_Library( library ),
+	m_SupportedFileExtensions( supportedFileExtensions ),
+	m_Scheduler( scheduler ),
+	m_EnumerateGroup(),
+	m_StageGroup(),
+	m_StartedStages( 0 ),
+	m_LibraryFiles(),
+	m_Quick( false ),
+	m_PreviousFingerprints(),
+	m_PreviousSubfolders(),
+	m_Fingerprints(),
+	m_UnchangedFolders(),
+	m_FingerprintMutex(),
+	m_CompareQueue( kCompareQueueCapacity ),
+	m_ProbeQueue( kProbeQueueCapacity ),
+	m_WriteQueue( kWriteQueueCapacity ),
+	m_ActiveEnumerators( 0 ),
+	m_ActiveProbes( 0 ),
+	m_Cancelled( false ),
+	m_Found( 0 ),
+	m_Processed( 0 ),
+	m_Enumerating( true ),
+	m_Finished( false ),
+	m_CurrentFile(),
+	m_CurrentFileMutex(),
+	m_Devices(),
+	m_DeviceMutex(),
+	m_DeviceReleased(),
+	m_FileAddedCallback( nullptr )
+{
+}
+
+LibraryScanner::~LibraryScanner()
+{
+}
+
+void LibraryScanner::Run( const std::set<std::wstring>& rootFolders, const bool quick, const HANDLE stopEvent, FileAddedCallback fileAddedCallback, ProgressCallback progressCallback )
+{
+	m_FileAddedCallback = fileAddedCallback;
+	m_Quick = quick;
+
+	// Make a note of existing library files (excluding streams).
+	const MediaInfo::List allMedia = m_Library.GetAllMedia();
+	for ( const auto& mediaInfo : allMedia ) {
+		if ( const auto& filename = mediaInfo.GetFilename(); !IsURL( filename ) ) {
+			m_LibraryFiles.insert( LibraryFiles::value_type( filename, FileAttributes( mediaInfo.GetFiletime(), mediaInfo.GetFilesize() ) ) );
+		}
+	}
+
+	// Make a note of the folders from the previous scan, and (for a quick scan, which walks the previous subfolders of any unmodified folders) their subfolders.
+	m_PreviousFingerprints = m_Library.GetFolderFingerprints();
+	if ( m_Quick ) {
+		for ( const auto& fingerprint : m_PreviousFingerprints ) {
+			const std::filesystem::path folder( fingerprint.first );
+			if ( const std::filesystem::path parent = folder.parent_path(); parent != folder ) {
+				m_PreviousSubfolders[ parent.native() ].push_back( fingerprint.first );
+			}
+		}
+	}
+
+	// Start the pipeline stages, from the last stage to the first.
+	// The stage tasks leave one worker for folder enumeration (or, when called from a worker thread, this thread helps with enumeration instead).
+	const size_t workerCount = m_Scheduler.GetThreadCount();
+	const size_t probeCount = ( workerCount > ( kCompareWriteStages + 1 ) ) ? ( workerCount - kCompareWriteStages - 1 ) : 1;
+	m_ActiveProbes = probeCount;
+	SubmitStage( &LibraryScanner::WriteHandler );
+	for ( size_t probe = 0; probe < probeCount; probe++ ) {
+		SubmitStage( &LibraryScanner::ProbeHandler );
+	}
+	SubmitStage( &LibraryScanner::CompareHandler );
+
+	// Wait for the stage tasks to start before submitting any folders, as enumeration tasks waiting on a full comparison queue would otherwise be able to occupy the workers needed by the comparison stage.
+	const size_t stageCount = probeCount + kCompareWriteStages;
+	bool stopped = false;
+	while ( !stopped && ( m_StartedStages < stageCount ) ) {
+		stopped = ( WAIT_OBJECT_0 == WaitForSingleObject( stopEvent, kStageStartInterval ) );
+	}
+	if ( stopped ) {
+		Cancel();
+	}
+
+	// The enumeration count is held while the root folders are submitted, so that the comparison queue is not closed before the last root folder has been submitted.
+	++m_ActiveEnumerators;
+	for ( auto rootFolder = rootFolders.begin(); !stopped && ( rootFolders.end() != rootFolder ); rootFolder++ ) {
+		SubmitFolder( *rootFolder, std::nullopt, true /*rootFolder*/ );
+	}
+	FinishEnumeration();
+
+	// Report progress until the last stage has finished, or until stopped, helping with folder enumeration in between if this is a worker thread.
+	bool finished = stopped;
+	ULONGLONG lastProgress = 0;
+	while ( !finished ) {
+		const bool enumerated = m_Scheduler.RunPendingTask( m_EnumerateGroup );
+		finished = ( WAIT_OBJECT_0 == WaitForSingleObject( stopEvent, enumerated ? 0 : kProgressInterval ) );
+		if ( finished ) {
+			Cancel();
+		} else {
+			finished = m_Finished;
+			if ( const ULONGLONG now = GetTickCount64(); progressCallback && ( finished || ( ( now - lastProgress ) >= kProgressInterval ) ) ) {
+				progressCallback( GetProgress() );
+				lastProgress = now;
+			}
+		}
+	}
+
+	m_EnumerateGroup.Wait();
+	m_StageGroup.Wait();
+
+	// Only record the folder fingerprints for a complete scan, so that a cancelled scan does not cause changed folders to be skipped.
+	if ( !m_Cancelled && ( m_Fingerprints != m_PreviousFingerprints ) ) {
+		m_Library.SetFolderFingerprints( m_Fingerprints );
+	}
+}
+
+void LibraryScanner::SubmitStage( void ( LibraryScanner::*handler )() )
+{
+	m_Scheduler.Submit( m_StageGroup, TaskScheduler::Priority::Library, [ this, handler ] ()
+	{
+		++m_StartedStages;
+		( this->*handler )();
+	} );
+}
+
+void LibraryScanner::SubmitFolder( const std::filesystem::path& folder, const std::optional<long long>& modified, const bool rootFolder )
+{
+	// The count is incremented before submitting, and a folder task only finishes after submitting its subfolders, so the count cannot reach zero until all folders have been enumerated.
+	++m_ActiveEnumerators;
+	m_Scheduler.Submit( m_EnumerateGroup, TaskScheduler::Priority::Library, [ this, folder, modified, rootFolder ] ()
+	{
+		std::optional<long long> folderModified = modified;
+		if ( rootFolder ) {
+			WIN32_FILE_ATTRIBUTE_DATA attributes = {};
+			if ( FALSE != GetFileAttributesEx( folder.c_str(), GetFileExInfoStandard, &attributes ) ) {
+				folderModified = GetFiletime( attributes.ftLastWriteTime );
+			}
+		}
+		EnumerateFolder( folder, folderModified );
+		FinishEnumeration();
+	} );
+}
+
+void LibraryScanner::FinishEnumeration()
+{
+	// The last enumeration task to finish closes the comparison queue.
+	if ( 0 == --m_ActiveEnumerators ) {
+		m_Enumerating = false;
+		m_CompareQueue.Close();
+	}
+}
+
+bool LibraryScanner::EnumerateFolder( const std::filesystem::path& folder, const std::optional<long long>& modified )
+{
+	bool success = !m_Cancelled;
+	if ( success ) {
+		// A folder's modified time changes whenever an entry is added, removed or renamed, so a quick scan does not need to list a folder if its modified time matches the stored fingerprint.
+		// Changes to the contents of existing files do not change the modified time of the folder, and are left to a full scan.
+		const auto previous = m_PreviousFingerprints.find( folder.native() );
+		if ( m_Quick && modified.has_value() && ( m_PreviousFingerprints.end() != previous ) && ( *modified == previous->second.Modified ) ) {
+			success = SkipFolder( folder, previous->second );
+		} else {
+			success = ListFolder( folder, modified, ( m_PreviousFingerprints.end() != previous ) ? std::make_optional( previous->second ) : std::nullopt );
+		}
+	}
+	return success;
+}
+
+bool LibraryScanner::ListFolder( const std::filesystem::path& folder, const std::optional<long long>& modified, const std::optional<Library::FolderFingerprint>& previous )
+{
+	bool success = true;
+	const FINDEX_INFO_LEVELS levels = FindExInfoBasic;
+	const FINDEX_SEARCH_OPS searchOp = FindExSearchNameMatch;
+	const DWORD flags = FIND_FIRST_EX_LARGE_FETCH;
+	WIN32_FIND_DATA findData = {};
+	const std::filesystem::path path = folder / L"*.*";
+	const HANDLE handle = FindFirstFileEx( path.c_str(), levels, &findData, searchOp, nullptr /*filter*/, flags );
+	if ( INVALID_HANDLE_VALUE != handle ) {
+		// Supported files are held back until the listing is complete, so that they are only passed on if the listing has changed.
+		std::vector<Candidate> files;
+		std::vector<std::pair<std::filesystem::path, long long>> subfolders;
+		Library::FolderFingerprint fingerprint;
+		fingerprint.Modified = modified.value_or( 0 );
+		unsigned long long hash = 0;
+		BOOL found = TRUE;
+		while ( found && success ) {
+			if ( findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY ) {
+				if ( IsScannedFolder( findData.dwFileAttributes ) && ( findData.cFileName[ 0 ] != '.' ) ) {
+					subfolders.push_back( std::make_pair( folder / findData.cFileName, GetFiletime( findData.ftLastWriteTime ) ) );
+					++fingerprint.Entries;
+					hash += GetEntryHash( findData.cFileName, std::nullopt );
+				}
+			} else if ( !( ( findData.dwFileAttributes & FILE_ATTRIBUTE_HIDDEN ) || ( findData.dwFileAttributes & FILE_ATTRIBUTE_SYSTEM ) ) ) {
+				// The file time & size are taken from the find data, so that enumerated files do not need to be opened to check whether they have changed.
+				const FileAttributes attributes( GetFiletime( findData.ftLastWriteTime ), GetFilesize( findData.nFileSizeHigh, findData.nFileSizeLow ) );
+				++fingerprint.Entries;
+				hash += GetEntryHash( findData.cFileName, attributes );
+				if ( IsSupportedFileType( findData.cFileName ) ) {
+					Candidate candidate;
+					candidate.Filename = folder / findData.cFileName;
+					candidate.Attributes = attributes;
+					files.push_back( candidate );
+				}
+			}
+			success = !m_Cancelled;
+			found = success && FindNextFile( handle, &findData );
+		}
+		FindClose( handle );
+
+		// The hash is the sum of the entry hashes, so that it does not depend on the listing order.
+		fingerprint.Hash = static_cast<long long>( hash );
+		const bool unchanged = m_Quick && previous.has_value() && ( previous->Entries == fingerprint.Entries ) && ( previous->Hash == fingerprint.Hash );
+		if ( success ) {
+			AddFingerprint( folder, fingerprint, unchanged );
+		}
+		if ( !unchanged ) {
+			for ( auto file = files.begin(); success && ( files.end() != file ); file++ ) {
+				++m_Found;
+				SetCurrentFile( file->Filename );
+				success = m_CompareQueue.Push( *file );
+			}
+		}
+		for ( auto subfolder = subfolders.begin(); success && ( subfolders.end() != subfolder ); subfolder++ ) {
+			SubmitFolder( subfolder->first, subfolder->second, false /*rootFolder*/ );
+			success = !m_Cancelled;
+		}
+	}
+	return success;
+}
+
+bool LibraryScanner::SkipFolder( const std::filesystem::path& folder, const Library::FolderFingerprint& previous )
+{
+	AddFingerprint( folder, previous, true /*unchanged*/ );
+
+	// Subfolders are checked individually, as their modified times do not affect the modified time of this folder.
+	bool success = true;
+	if ( const auto subfolders = m_PreviousSubfolders.find( folder.native() ); m_PreviousSubfolders.end() != subfolders ) {
+		for ( auto subfolder = subfolders->second.begin(); success && ( subfolders->second.end() != subfolder ); subfolder++ ) {
+			WIN32_FILE_ATTRIBUTE_DATA attributes = {};
+			if ( ( FALSE != GetFileAttributesEx( subfolder->c_str(), GetFileExInfoStandard, &attributes ) ) && IsScannedFolder( attributes.dwFileAttributes ) ) {
+				SubmitFolder( *subfolder, GetFiletime( attributes.ftLastWriteTime ), false /*rootFolder*/ );
+			}
+			success = !m_Cancelled;
+		}
+	}
+	return success;
+}
+
+void LibraryScanner::AddFingerprint( const std::filesystem::path& folder, const Library::FolderFingerprint& fingerprint, const bool unchanged )
+{
+	std::lock_guard<std::mutex> lock( m_FingerprintMutex );
+	m_Fingerprints.insert( Library::FolderFingerprints::value_type( folder.native(), fingerprint ) );
+	if ( unchanged ) {
+		m_UnchangedFolders.insert( folder.native() );
+	}
+}
+
+void LibraryScanner::CompareHandler()
+{
+	bool success = true;
+	Candidate candidate;
+	while ( success && m_CompareQueue.Pop( candidate ) ) {
+		success = Compare( candidate );
+	}
+	if ( success && !m_Cancelled ) {
+		CompareRemaining();
+	}
+	m_ProbeQueue.Close();
+}
+
+bool LibraryScanner::Compare( Candidate& candidate )
+{
+	if ( const auto libraryFile = m_LibraryFiles.find( candidate.Filename ); m_LibraryFiles.end() != libraryFile ) {
+		candidate.LibraryAttributes = libraryFile->second;
+		m_LibraryFiles.erase( libraryFile );
+	}
+	bool success = true;
+	if ( candidate.Attributes.has_value() && ( candidate.Attributes == candidate.LibraryAttributes ) ) {
+		++m_Processed;
+	} else {
+		success = m_ProbeQueue.Push( candidate );
+	}
+	return success;
+}
+
+bool LibraryScanner::CompareRemaining()
+{
+	// The attributes of the remaining files are checked by the probe stage, so that they are read in parallel (and subject to the device limits).
+	// Enumeration has finished by this point, so the unchanged folders are no longer being modified.
+	// Library files are sorted by name, so the folder lookup is only repeated when the folder prefix of the file name changes.
+	bool success = true;
+	std::optional<std::wstring> previousPrefix;
+	bool unchangedFolder = false;
+	for ( auto libraryFile = m_LibraryFiles.begin(); success && ( m_LibraryFiles.end() != libraryFile ); libraryFile = m_LibraryFiles.erase( libraryFile ) ) {
+		const std::wstring& filename = libraryFile->first;
+		const size_t prefixLength = filename.find_last_of( L"\\/" );
+		if ( !previousPrefix.has_value() || ( std::wstring::npos == prefixLength ) || ( 0 != previousPrefix->compare( 0, std::wstring::npos, filename, 0, prefixLength ) ) ) {
+			previousPrefix = filename.substr( 0, prefixLength );
+			unchangedFolder = ( m_UnchangedFolders.end() != m_UnchangedFolders.find( std::filesystem::path( filename ).parent_path().native() ) );
+		}
+		if ( !unchangedFolder ) {
+			Candidate candidate;
+			candidate.Filename = libraryFile->first;
+			candidate.LibraryAttributes = libraryFile->second;
+			++m_Found;
+			success = m_ProbeQueue.Push( candidate );
+		}
+	}
+	return success;
+}
+
+void LibraryScanner::ProbeHandler()
+{
+	bool success = true;
+	Candidate candidate;
+	while ( success && m_ProbeQueue.Pop( candidate ) ) {
+		std::wstring root;
+		success = AcquireDevice( candidate.Filename, root );
+		if ( success ) {
+			SetCurrentFile( candidate.Filename );
+			bool unchanged = false;
+			if ( !candidate.Attributes.has_value() ) {
+				WIN32_FILE_ATTRIBUTE_DATA attributes = {};
+				if ( FALSE != GetFileAttributesEx( candidate.Filename.c_str(), GetFileExInfoStandard, &attributes ) ) {
+					candidate.Attributes = FileAttributes( GetFiletime( attributes.ftLastWriteTime ), GetFilesize( attributes.nFileSizeHigh, attributes.nFileSizeLow ) );
+					unchanged = ( candidate.Attributes == candidate.LibraryAttributes );
+				}
+			}
+			Probed probed;
+			bool scanned = false;
+			if ( !unchanged ) {
+				probed.Info = MediaInfo( candidate.Filename );
+				probed.InLibrary = candidate.LibraryAttributes.has_value();
+				scanned = m_Library.ScanMediaInfo( probed.Info );
+			}
+			ReleaseDevice( root );
+
+			if ( scanned ) {
+				success = m_WriteQueue.Push( probed );
+			} else {
+				if ( !unchanged && candidate.LibraryAttributes.has_value() ) {
+					m_Library.RemoveFromLibrary( MediaInfo( candidate.Filename ) );
+				}
+				++m_Processed;
+			}
+		}
+	}
+	// The last probe task to finish closes the write queue.
+	if ( 0 == --m_ActiveProbes ) {
+		m_WriteQueue.Close();
+	}
+}
+
+void LibraryScanner::WriteHandler()
+{
+	std::vector<Probed> batch;
+	batch.reserve( kWriteBatchSize );
+	Probed probed;
+	while ( m_WriteQueue.Pop( probed ) ) {
+		batch.push_back( probed );
+		if ( batch.size() >= kWriteBatchSize ) {
+			Write( batch );
+		}
+	}
+	// Any files which have already been probed are written out, even if the pipeline was cancelled.
+	Write( batch );
+	m_Finished = true;
+}
+
+void LibraryScanner::Write( std::vector<Probed>& batch )
+{
+	if ( !batch.empty() ) {
+		MediaInfo::List mediaList;
+		std::set<std::wstring> newFiles;
+		for ( const auto& probed : batch ) {
+			mediaList.push_back( probed.Info );
+			if ( !probed.InLibrary ) {
+				newFiles.insert( probed.Info.GetFilename() );
+			}
+		}
+		m_Library.AddMediaInfo( mediaList, true /*sendNotification*/ );
+		if ( m_FileAddedCallback ) {
+			for ( const auto& mediaInfo : mediaList ) {
+				if ( newFiles.end() != newFiles.find( mediaInfo.GetFilename() ) ) {
+					m_FileAddedCallback( mediaInfo.GetFilename() );
+				}
+			}
+		}
+		m_Processed += batch.size();
+		batch.clear();
+	}
+}
+
+bool LibraryScanner::AcquireDevice( const std::wstring& filename, std::wstring& root )
+{
+	root = std::filesystem::path( filename ).root_path();
+	bool knownDevice = false;
+	{
+		std::lock_guard<std::mutex> lock( m_DeviceMutex );
+		knownDevice = ( m_Devices.end() != m_Devices.find( root ) );
+	}
+	if ( !knownDevice ) {
+		// The drive type is checked without holding the lock, as this can be slow for network devices.
+		const UINT driveType = GetDriveType( root.c_str() );
+		const bool localDevice = ( DRIVE_FIXED == driveType ) || ( DRIVE_REMOVABLE == driveType ) || ( DRIVE_CDROM == driveType ) || ( DRIVE_RAMDISK == driveType );
+		Device device;
+		device.Limit = localDevice ? kMaxLocalDeviceProbes : kMaxRemoteDeviceProbes;
+		std::lock_guard<std::mutex> lock( m_DeviceMutex );
+		m_Devices.insert( Devices::value_type( root, device ) );
+	}
+
+	std::unique_lock<std::mutex> lock( m_DeviceMutex );
+	Device& device = m_Devices[ root ];
+	m_DeviceReleased.wait( lock, [ this, &device ] () { return m_Cancelled || ( device.Active < device.Limit ); } );
+	const bool acquired = !m_Cancelled;
+	if ( acquired ) {
+		++device.Active;
+	}
+	return acquired;
+}
+
+void LibraryScanner::ReleaseDevice( const std::wstring& root )
+{
+	{
+		std::lock_guard<std::mutex> lock( m_DeviceMutex );
+		if ( const auto device = m_Devices.find( root ); ( m_Devices.end() != device ) && ( device->second.Active > 0 ) ) {
+			--device->second.Active;
+		}
+	}
+	m_DeviceReleased.notify_all();
+}
+
+void LibraryScanner::Cancel()
+{
+	{
+		std::lock_guard<std::mutex> lock( m_DeviceMutex );
+		m_Cancelled = true;
+	}
+	m_DeviceReleased.notify_all();
+	m_CompareQueue.Cancel();
+	m_ProbeQueue.Cancel();
+	m_WriteQueue.Cancel();
+}
+
+bool LibraryScanner::IsSupportedFileType( const std::wstring& filename ) const
+{
+	return m_SupportedFileExtensions.end() != m_SupportedFileExtensions.find( GetFileExtension( filename ) );
+}
+
+bool LibraryScanner::IsScannedFolder( const DWORD attributes )
+{
+	return ( attributes & FILE_ATTRIBUTE_DIRECTORY ) && !( ( attributes & FILE_ATTRIBUTE_HIDDEN ) || ( attributes & FILE_ATTRIBUTE_SYSTEM ) );
+}
+
+unsigned long long LibraryScanner::GetEntryHash( const std::wstring& name, const std::optional<FileAttributes>& attributes )
+{
+	unsigned long long hash = kHashOffsetBasis;
+	const auto addBytes = [ &hash ] ( const void* data, const size_t size )
+	{
+		const BYTE* bytes = static_cast<const BYTE*>( data );
+		for ( size_t index = 0; index < size; index++ ) {
+			hash = ( hash ^ bytes[ index ] ) * kHashPrime;
+		}
+	};
+	addBytes( name.data(), name.size() * sizeof( wchar_t ) );
+	if ( attributes.has_value() ) {
+		addBytes( &attributes->first, sizeof( attributes->first ) );
+		addBytes( &attributes->second, sizeof( attributes->second ) );
+	}
+	return hash;
+}
+
+void LibraryScanner::SetCurrentFile( const std::filesystem::path& filename )
+{
+	std::lock_guard<std::mutex> lock( m_CurrentFileMutex );
+	m_CurrentFile = filename;
+}
+
+LibraryScanner::Progress LibraryScanner::GetProgress() const
+{
+	Progress progress;
+	progress.Enumerating = m_Enumerating;
+	progress.Found = m_Found;
+	progress.Processed = m_Processed;
+	std::lock_guard<std::mutex> lock( m_CurrentFileMutex );
+	progress.CurrentFile = m_CurrentFile;
+	return progress;
+}
+
+long long LibraryScanner::GetFiletime( const FILETIME& filetime )
+{
+	return ( static_cast<long long>( filetime.dwHighDateTime ) << 32 ) + filetime.dwLowDateTime;
+}
+
+long long LibraryScanner::GetFilesize( const DWORD high, const DWORD low )
+{
+	return ( static_cast<long long>( high ) << 32 ) + low;
+}
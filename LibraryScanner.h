@@ -0,0 +1,259 @@
+#pragma once
+
+#include "stdafx.h"
+
+#include "BoundedQueue.h"
+#include "Library.h"
+#include "TaskScheduler.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+#include <vector>
+
+// Refreshes the media library using a pipeline of stages, connected by bounded queues, which all run as scheduler tasks:
+// - folder enumeration, using a task for each folder;
+// - comparison of file times & sizes against the library, using a single task;
+// - decoder & tag probes of new or changed files, using several tasks (with a limit on the number of concurrent probes for each device);
+// - batched library writes, using a single task.
+// The comparison, probe & write tasks each wait on their queue for the whole scan, so they are limited to one less than the number of workers,
+// and are all started before any folders are submitted, so that enumeration tasks waiting on a full queue can never hold up the stages which drain it.
+// The fingerprint of each folder listing is recorded, so that a quick scan can skip any folders which have not changed since the last scan.
+class LibraryScanner
+{
+public:
+	// A callback for when a new 'file' is added to the library.
+	using FileAddedCallback = std::function<void( const std::filesystem::path& file )>;
+
+	// Scan progress.
+	struct Progress {
+		bool Enumerating = true;					// Whether folders are still being enumerated.
+		size_t Found = 0;									// Number of files found so far (including any library files which were not enumerated).
+		size_t Processed = 0;							// Number of files which have been compared, and probed if necessary.
+		std::filesystem::path CurrentFile;	// The file most recently enumerated or probed.
+	};
+
+	// A callback for reporting the scan 'progress'.
+	using ProgressCallback = std::function<void( const Progress& progress )>;
+
+	// 'library' - media library.
+	// 'supportedFileExtensions' - supported media file extensions, in lower case.
+	// 'scheduler' - task scheduler used to run the pipeline stages (which should have at least four worker threads, as the application schedulers do).
+	LibraryScanner( Library& library, const std::set<std::wstring>& supportedFileExtensions, TaskScheduler& scheduler = TaskScheduler::GetBackground() );
+
+	virtual ~LibraryScanner();
+
+	// Scans the 'rootFolders' for supported files, and refreshes the library with any new or changed files (as well as any library files which were not found).
+	// Returns when the scan has finished, or when the 'stopEvent' is set.
+	// If called from one of the scheduler's worker threads, the calling thread helps with folder enumeration.
+	// 'quick' - whether to skip folders which have not been modified since the last scan (in which case changes to the contents of existing files in those folders are not detected).
+	// 'fileAddedCallback' - called, from a pipeline task, for each new file added to the library.
+	// 'progressCallback' - called periodically, from the calling thread, with the scan progress.
+	void Run( const std::set<std::wstring>& rootFolders, const bool quick, const HANDLE stopEvent, FileAddedCallback fileAddedCallback, ProgressCallback progressCallback );
+
+private:
+	// Last modified time & size of a file.
+	using FileAttributes = std::pair<long long, long long>;
+
+	// A file which is passed along the pipeline.
+	struct Candidate {
+		std::wstring Filename;														// File name.
+		std::optional<FileAttributes> Attributes;					// File time & size, if known.
+		std::optional<FileAttributes> LibraryAttributes;	// File time & size of the library entry, if the file is in the library.
+	};
+
+	// A probed file, ready to be written to the library.
+	struct Probed {
+		MediaInfo Info;							// Media information.
+		bool InLibrary = false;			// Whether the file has an existing library entry.
+	};
+
+	// Maps a library file name to its file time & size.
+	using LibraryFiles = std::map<std::wstring, FileAttributes>;
+
+	// Maps a folder name to its subfolder names.
+	using Subfolders = std::map<std::wstring, std::vector<std::wstring>>;
+
+	// Probe concurrency for a device.
+	struct Device {
+		size_t Active = 0;					// Number of active probes.
+		size_t Limit = 0;						// Maximum number of concurrent probes.
+	};
+
+	// Maps a device root to its probe concurrency.
+	using Devices = std::map<std::wstring, Device>;
+
+	// Submits a comparison, probe or write stage task, which runs the 'handler'.
+	void SubmitStage( void ( LibraryScanner::*handler )() );
+
+	// Submits an enumeration stage task for the 'folder' (its subfolders are submitted as separate tasks).
+	// 'modified' - last modified time of the folder, if known.
+	// 'rootFolder' - whether this is a root folder, in which case the modified time is read by the task.
+	void SubmitFolder( const std::filesystem::path& folder, const std::optional<long long>& modified, const bool rootFolder );
+
+	// Decrements the enumeration count, closing the comparison queue once all folders have been enumerated.
+	void FinishEnumeration();
+
+	// Scans the 'folder', passing any supported files to the comparison stage, and submits its subfolders.
+	// 'modified' - last modified time of the folder, if known.
+	// Returns false if the scan was cancelled.
+	bool EnumerateFolder( const std::filesystem::path& folder, const std::optional<long long>& modified );
+
+	// Lists the 'folder', passing any supported files to the comparison stage (unless this is a quick scan and the listing matches the 'previous' fingerprint), then submits its subfolders.
+	// 'modified' - last modified time of the folder, if known.
+	// Returns false if the scan was cancelled.
+	bool ListFolder( const std::filesystem::path& folder, const std::optional<long long>& modified, const std::optional<Library::FolderFingerprint>& previous );
+
+	// Skips listing the unmodified 'folder', retaining its 'previous' fingerprint, and submits the subfolders from the previous scan.
+	// Returns false if the scan was cancelled.
+	bool SkipFolder( const std::filesystem::path& folder, const Library::FolderFingerprint& previous );
+
+	// Records the 'fingerprint' for the 'folder', and whether the folder is 'unchanged' since the previous scan.
+	void AddFingerprint( const std::filesystem::path& folder, const Library::FolderFingerprint& fingerprint, const bool unchanged );
+
+	// Comparison stage handler.
+	void CompareHandler();
+
+	// Passes an enumerated 'candidate' to the probe stage if it is new or has changed, otherwise marks it as processed.
+	// Returns false if the pipeline was cancelled.
+	bool Compare( Candidate& candidate );
+
+	// Passes any library files which were not enumerated to the probe stage (which checks whether they have changed or are missing).
+	// For a quick scan, library files in unchanged folders are skipped.
+	// Returns false if the pipeline was cancelled.
+	bool CompareRemaining();
+
+	// Probe stage handler.
+	void ProbeHandler();
+
+	// Write stage handler.
+	void WriteHandler();
+
+	// Writes a 'batch' of probed files to the library.
+	void Write( std::vector<Probed>& batch );
+
+	// Waits until a probe can be started on the device for the 'filename'.
+	// 'root' - out, device root, which should be passed to ReleaseDevice when the probe has finished.
+	// Returns false if the pipeline was cancelled.
+	bool AcquireDevice( const std::wstring& filename, std::wstring& root );
+
+	// Releases a probe on the device with the 'root'.
+	void ReleaseDevice( const std::wstring& root );
+
+	// Cancels the pipeline.
+	void Cancel();
+
+	// Returns whether the 'filename' is a supported media file type.
+	bool IsSupportedFileType( const std::wstring& filename ) const;
+
+	// Returns whether a folder with the file 'attributes' should be scanned.
+	static bool IsScannedFolder( const DWORD attributes );
+
+	// Returns the hash of a folder entry, from its 'name' and, for files, its 'attributes'.
+	static unsigned long long GetEntryHash( const std::wstring& name, const std::optional<FileAttributes>& attributes );
+
+	// Sets the file most recently enumerated or probed.
+	void SetCurrentFile( const std::filesystem::path& filename );
+
+	// Returns the current progress.
+	Progress GetProgress() const;
+
+	// Returns the file time from a 'filetime'.
+	static long long GetFiletime( const FILETIME& filetime );
+
+	// Returns the file size from the 'high' & 'low' parts.
+	static long long GetFilesize( const DWORD high, const DWORD low );
+
+	// Media library.
+	Library& m_Library;
+
+	// Supported media file extensions.
+	const std::set<std::wstring>& m_SupportedFileExtensions;
+
+	// Task scheduler used to run the pipeline stages.
+	TaskScheduler& m_Scheduler;
+
+	// Folder enumeration tasks.
+	TaskScheduler::Group m_EnumerateGroup;
+
+	// Comparison, probe & write stage tasks.
+	TaskScheduler::Group m_StageGroup;
+
+	// Number of comparison, probe & write stage tasks which have started.
+	std::atomic<size_t> m_StartedStages;
+
+	// Existing library files, which are removed from the map once they have been enumerated.
+	LibraryFiles m_LibraryFiles;
+
+	// Indicates whether this is a quick scan.
+	bool m_Quick;
+
+	// Folder fingerprints from the previous scan.
+	Library::FolderFingerprints m_PreviousFingerprints;
+
+	// Subfolders from the previous scan.
+	Subfolders m_PreviousSubfolders;
+
+	// Folder fingerprints from this scan.
+	Library::FolderFingerprints m_Fingerprints;
+
+	// Folders which are unchanged since the previous scan (only used for a quick scan).
+	std::set<std::wstring> m_UnchangedFolders;
+
+	// Folder fingerprint mutex.
+	std::mutex m_FingerprintMutex;
+
+	// Files waiting to be compared.
+	BoundedQueue<Candidate> m_CompareQueue;
+
+	// Files waiting to be probed.
+	BoundedQueue<Candidate> m_ProbeQueue;
+
+	// Files waiting to be written.
+	BoundedQueue<Probed> m_WriteQueue;
+
+	// Number of folder enumeration tasks which are queued or running.
+	std::atomic<size_t> m_ActiveEnumerators;
+
+	// Number of probe tasks still running.
+	std::atomic<size_t> m_ActiveProbes;
+
+	// Indicates whether the pipeline has been cancelled.
+	std::atomic<bool> m_Cancelled;
+
+	// Number of files found.
+	std::atomic<size_t> m_Found;
+
+	// Number of files processed.
+	std::atomic<size_t> m_Processed;
+
+	// Indicates whether folders are still being enumerated.
+	std::atomic<bool> m_Enumerating;
+
+	// Indicates whether all stages have finished.
+	std::atomic<bool> m_Finished;
+
+	// The file most recently enumerated or probed.
+	std::filesystem::path m_CurrentFile;
+
+	// Current file mutex.
+	mutable std::mutex m_CurrentFileMutex;
+
+	// Probe concurrency for each device.
+	Devices m_Devices;
+
+	// Device mutex.
+	std::mutex m_DeviceMutex;
+
+	// Signalled when a device probe is released, or the pipeline is cancelled.
+	std::condition_variable m_DeviceReleased;
+
+	// A callback for when a new file is added to the library.
+	FileAddedCallback m_FileAddedCallback;
+};
@@ -0,0 +1,185 @@
+#include "Limiter.h"
+
+#include <algorithm>
+#include <cmath>
+
+// Output ceiling.
+constexpr float kCeiling = 1.0f;
+
+// Maximum supported sample rate.
+constexpr long kMaxSampleRate = 384000;
+
+// Minimum & maximum look-ahead window, in milliseconds.
+constexpr float kMinLookAhead = 1.0f;
+constexpr float kMaxLookAhead = 20.0f;
+
+// Minimum & maximum release time, in milliseconds.
+constexpr float kMinRelease = 10.0f;
+constexpr float kMaxRelease = 1000.0f;
+
+// Maximum look-ahead window, in samples.
+constexpr size_t kMaxWindowLength = static_cast<size_t>( kMaxSampleRate * kMaxLookAhead / 1000 );
+
+// Number of samples by which the interpolated peaks lag the most recent input sample.
+constexpr size_t kInterpolationDelay = 3;
+
+// Lanczos kernel size.
+constexpr double kLanczosSize = 4.0;
+
+// Returns the normalised sinc of 'x'.
+static double Sinc( const double x )
+{
+	constexpr double kPi = 3.14159265358979323846;
+	return ( 0 == x ) ? 1.0 : ( sin( kPi * x ) / ( kPi * x ) );
+}
+
+Limiter::Limiter() :
+	m_Coefficients(),
+	m_History( kMaxChannels * kInterpolationTaps ),
+	m_Delay( kMaxChannels * ( kMaxWindowLength + kInterpolationDelay ) ),
+	m_MinimumGain( 1 + kMaxWindowLength ),
+	m_MinimumIndex( 1 + kMaxWindowLength ),
+	m_SmoothedGain( kMaxWindowLength )
+{
+	// Lanczos interpolation coefficients for each point between the middle pair of history samples.
+	for ( size_t point = 0; point < kInterpolatedPoints; point++ ) {
+		const double fraction = static_cast<double>( 1 + point ) / ( 1 + kInterpolatedPoints );
+		auto& coefficients = m_Coefficients[ point ];
+		double sum = 0;
+		for ( size_t tap = 0; tap < kInterpolationTaps; tap++ ) {
+			const double x = static_cast<double>( tap ) - ( kInterpolationTaps / 2 - 1 ) - fraction;
+			const double coefficient = Sinc( x ) * Sinc( x / kLanczosSize );
+			coefficients[ tap ] = static_cast<float>( coefficient );
+			sum += coefficient;
+		}
+		for ( auto& coefficient : coefficients ) {
+			coefficient = static_cast<float>( coefficient / sum );
+		}
+	}
+}
+
+Limiter::~Limiter()
+{
+}
+
+std::pair<float, float> Limiter::GetLookAheadRange()
+{
+	return { kMinLookAhead, kMaxLookAhead };
+}
+
+std::pair<float, float> Limiter::GetReleaseRange()
+{
+	return { kMinRelease, kMaxRelease };
+}
+
+void Limiter::Configure( const long channels, const long sampleRate, const float lookAhead, const float release )
+{
+	if ( ( static_cast<size_t>( channels ) != m_Channels ) || ( sampleRate != m_SampleRate ) || ( lookAhead != m_LookAhead ) || ( release != m_Release ) ) {
+		m_Channels = static_cast<size_t>( std::max<long>( 0l, channels ) );
+		m_SampleRate = sampleRate;
+		m_LookAhead = lookAhead;
+		m_Release = release;
+		m_Configured = ( channels > 0 ) && ( m_Channels <= kMaxChannels ) && ( sampleRate > 0 ) && ( sampleRate <= kMaxSampleRate );
+		if ( m_Configured ) {
+			const float lookAheadSeconds = std::clamp( lookAhead, kMinLookAhead, kMaxLookAhead ) / 1000;
+			const float releaseSeconds = std::clamp( release, kMinRelease, kMaxRelease ) / 1000;
+			m_WindowLength = std::clamp<size_t>( static_cast<size_t>( lookAheadSeconds * sampleRate ), 1, kMaxWindowLength );
+			m_DelayLength = m_WindowLength + kInterpolationDelay;
+			m_ReleaseCoefficient = static_cast<float>( exp( -1.0 / ( releaseSeconds * sampleRate ) ) );
+		}
+		Reset();
+	}
+}
+
+void Limiter::Reset()
+{
+	if ( m_Configured ) {
+		std::fill( m_History.begin(), m_History.end(), 0.0f );
+		std::fill( m_Delay.begin(), m_Delay.begin() + m_DelayLength * m_Channels, 0.0f );
+		std::fill( m_SmoothedGain.begin(), m_SmoothedGain.begin() + m_WindowLength, 1.0f );
+		m_SmoothedSum = static_cast<double>( m_WindowLength );
+		m_SampleIndex = 0;
+		m_DelayPosition = 0;
+		m_MinimumHead = 0;
+		m_MinimumSize = 0;
+		m_SmoothedPosition = 0;
+		m_Envelope = 1.0f;
+		m_PreviousTarget = 1.0f;
+	}
+}
+
+float Limiter::GetTruePeak() const
+{
+	float peak = 0;
+	for ( size_t channel = 0; channel < m_Channels; channel++ ) {
+		const float* history = m_History.data() + channel * kInterpolationTaps;
+		peak = std::max<float>( peak, fabsf( history[ kInterpolationTaps / 2 - 1 ] ) );
+		for ( const auto& coefficients : m_Coefficients ) {
+			float value = 0;
+			for ( size_t tap = 0; tap < kInterpolationTaps; tap++ ) {
+				value += coefficients[ tap ] * history[ tap ];
+			}
+			peak = std::max<float>( peak, fabsf( value ) );
+		}
+	}
+	return peak;
+}
+
+void Limiter::Process( float* buffer, const size_t frames )
+{
+	if ( m_Configured ) {
+		const size_t minimumCapacity = m_MinimumGain.size();
+		for ( size_t frame = 0; frame < frames; frame++ ) {
+			float* samples = buffer + frame * m_Channels;
+
+			for ( size_t channel = 0; channel < m_Channels; channel++ ) {
+				float* history = m_History.data() + channel * kInterpolationTaps;
+				std::copy( history + 1, history + kInterpolationTaps, history );
+				history[ kInterpolationTaps - 1 ] = samples[ channel ];
+			}
+
+			// Each interpolated peak lies between two samples, so the gain target applies to both of them.
+			const float peak = GetTruePeak();
+			const float target = ( peak > kCeiling ) ? ( kCeiling / peak ) : 1.0f;
+			const float sampleTarget = std::min<float>( target, m_PreviousTarget );
+			m_PreviousTarget = target;
+
+			// Sliding minimum of the gain targets over the look-ahead window.
+			while ( ( m_MinimumSize > 0 ) && ( m_MinimumGain[ ( m_MinimumHead + m_MinimumSize - 1 ) % minimumCapacity ] >= sampleTarget ) ) {
+				--m_MinimumSize;
+			}
+			const size_t tail = ( m_MinimumHead + m_MinimumSize ) % minimumCapacity;
+			m_MinimumGain[ tail ] = sampleTarget;
+			m_MinimumIndex[ tail ] = m_SampleIndex;
+			++m_MinimumSize;
+			if ( ( m_MinimumIndex[ m_MinimumHead ] + static_cast<long long>( m_WindowLength ) ) <= m_SampleIndex ) {
+				m_MinimumHead = ( m_MinimumHead + 1 ) % minimumCapacity;
+				--m_MinimumSize;
+			}
+			const float minimum = m_MinimumGain[ m_MinimumHead ];
+
+			// Attack instantly, release exponentially.
+			m_Envelope = ( minimum < m_Envelope ) ? minimum : ( minimum + ( m_Envelope - minimum ) * m_ReleaseCoefficient );
+
+			// Averaging over the look-ahead window smooths the attack, while never exceeding the target for the delayed sample.
+			m_SmoothedSum += m_Envelope - m_SmoothedGain[ m_SmoothedPosition ];
+			m_SmoothedGain[ m_SmoothedPosition ] = m_Envelope;
+			m_SmoothedPosition = ( m_SmoothedPosition + 1 ) % m_WindowLength;
+			const float gain = static_cast<float>( m_SmoothedSum / m_WindowLength );
+
+			float* delay = m_Delay.data() + m_DelayPosition * m_Channels;
+			for ( size_t channel = 0; channel < m_Channels; channel++ ) {
+				const float output = delay[ channel ] * gain;
+				delay[ channel ] = samples[ channel ];
+				samples[ channel ] = std::clamp( output, -kCeiling, kCeiling );
+			}
+			m_DelayPosition = ( m_DelayPosition + 1 ) % m_DelayLength;
+			++m_SampleIndex;
+		}
+	} else {
+		const size_t count = frames * m_Channels;
+		for ( size_t i = 0; i < count; i++ ) {
+			buffer[ i ] = std::clamp( buffer[ i ], -kCeiling, kCeiling );
+		}
+	}
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// Look-ahead limiter with true peak detection, which operates in place on interleaved floating point sample data.
+// Peaks are detected on a 4x oversampled signal, and gain reduction is linked across channels.
+// Output is delayed by the look-ahead window, so that gain reduction can be applied smoothly before each peak.
+// All buffers are allocated on construction, so that processing is allocation free.
+class Limiter
+{
+public:
+	Limiter();
+
+	virtual ~Limiter();
+
+	// Limiters can be moved (but not copied) without any allocation.
+	Limiter( Limiter&& ) = default;
+	Limiter& operator=( Limiter&& ) = default;
+
+	// Configures the limiter, resetting its state if any of the parameters have changed.
+	// 'channels' - number of channels.
+	// 'sampleRate' - sample rate.
+	// 'lookAhead' - look-ahead window, in milliseconds.
+	// 'release' - release time, in milliseconds.
+	void Configure( const long channels, const long sampleRate, const float lookAhead, const float release );
+
+	// Resets the limiter state.
+	void Reset();
+
+	// Applies the limiter to interleaved sample data.
+	// 'buffer' - in/out, interleaved sample data.
+	// 'frames' - number of samples per channel.
+	// If the limiter could not be configured, the sample data is hard clipped instead.
+	void Process( float* buffer, const size_t frames );
+
+	// Returns the minimum & maximum look-ahead window, in milliseconds.
+	static std::pair<float, float> GetLookAheadRange();
+
+	// Returns the minimum & maximum release time, in milliseconds.
+	static std::pair<float, float> GetReleaseRange();
+
+private:
+	// Maximum number of channels supported.
+	static constexpr size_t kMaxChannels = 8;
+
+	// Number of history samples (per channel) used for true peak interpolation.
+	static constexpr size_t kInterpolationTaps = 8;
+
+	// Number of interpolated points between each pair of samples (for 4x oversampling).
+	static constexpr size_t kInterpolatedPoints = 3;
+
+	// Returns the true peak level for the current interpolation history.
+	float GetTruePeak() const;
+
+	// Interpolation coefficients, for each interpolated point.
+	std::array<std::array<float, kInterpolationTaps>, kInterpolatedPoints> m_Coefficients;
+
+	// Interpolation history, per channel (oldest sample first).
+	std::vector<float> m_History;
+
+	// Delay line, interleaved.
+	std::vector<float> m_Delay;
+
+	// Sliding minimum gain values, as a circular monotonic queue.
+	std::vector<float> m_MinimumGain;
+
+	// Sample index for each entry in the sliding minimum queue.
+	std::vector<long long> m_MinimumIndex;
+
+	// Smoothed gain values, as a circular buffer, which are averaged to give the applied gain.
+	std::vector<float> m_SmoothedGain;
+
+	// Number of channels.
+	size_t m_Channels = 0;
+
+	// Sample rate.
+	long m_SampleRate = 0;
+
+	// Look-ahead window, in milliseconds.
+	float m_LookAhead = 0;
+
+	// Release time, in milliseconds.
+	float m_Release = 0;
+
+	// Look-ahead window, in samples.
+	size_t m_WindowLength = 0;
+
+	// Delay line length, in samples.
+	size_t m_DelayLength = 0;
+
+	// Release coefficient, per sample.
+	float m_ReleaseCoefficient = 0;
+
+	// Whether the limiter has been successfully configured.
+	bool m_Configured = false;
+
+	// Index of the next input sample.
+	long long m_SampleIndex = 0;
+
+	// Current delay line position.
+	size_t m_DelayPosition = 0;
+
+	// Sliding minimum queue head & size.
+	size_t m_MinimumHead = 0;
+	size_t m_MinimumSize = 0;
+
+	// Current smoothed gain buffer position.
+	size_t m_SmoothedPosition = 0;
+
+	// Sum of the smoothed gain buffer.
+	double m_SmoothedSum = 0;
+
+	// The current smoothed gain (prior to averaging).
+	float m_Envelope = 1.0f;
+
+	// The gain target for the previous sample.
+	float m_PreviousTarget = 1.0f;
+};
@@ -0,0 +1,200 @@
+#include "MappedFile.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+// Maximum view size on 32-bit builds, in bytes.
+constexpr uint64_t kViewWindowSize = 32 * 1024 * 1024;
+
+// Amount of data to prefetch ahead of the current position when reading sequentially, in bytes.
+constexpr size_t kReadAheadSize = 1024 * 1024;
+
+// Returns the granularity for view offsets.
+static uint64_t GetAllocationGranularity()
+{
+	static const uint64_t s_Granularity = [] ()
+	{
+		SYSTEM_INFO systemInfo = {};
+		GetSystemInfo( &systemInfo );
+		return static_cast<uint64_t>( systemInfo.dwAllocationGranularity );
+	}();
+	return s_Granularity;
+}
+
+// Returns the maximum view size, in bytes (on 64-bit builds there is plenty of address space to map the whole file).
+static uint64_t GetMaxViewSize()
+{
+	return ( sizeof( void* ) >= 8 ) ? ( std::numeric_limits<uint64_t>::max )() : kViewWindowSize;
+}
+
+// Returns the PrefetchVirtualMemory function, or nullptr if it is not available (prior to Windows 8).
+static decltype( &PrefetchVirtualMemory ) GetPrefetchFunction()
+{
+	static const auto s_PrefetchFunction = reinterpret_cast<decltype( &PrefetchVirtualMemory )>( GetProcAddress( GetModuleHandle( L"kernel32.dll" ), "PrefetchVirtualMemory" ) );
+	return s_PrefetchFunction;
+}
+
+// Copies 'size' bytes from a mapped view 'source' to 'destination', returning false if the data could not be paged in (e.g. the file was on a network drive which has been disconnected).
+static bool CopyFromView( void* destination, const void* source, const size_t size )
+{
+	bool success = true;
+	__try {
+		std::memcpy( destination, source, size );
+	} __except ( ( EXCEPTION_IN_PAGE_ERROR == GetExceptionCode() ) ? EXCEPTION_EXECUTE_HANDLER : EXCEPTION_CONTINUE_SEARCH ) {
+		success = false;
+	}
+	return success;
+}
+
+MappedFile::MappedFile( const std::wstring& filename, const Access access ) :
+	m_File( INVALID_HANDLE_VALUE ),
+	m_Mapping( NULL ),
+	m_Size( 0 ),
+	m_Access( access ),
+	m_View( nullptr ),
+	m_ViewOffset( 0 ),
+	m_ViewSize( 0 ),
+	m_Position( 0 ),
+	m_PrefetchPosition( 0 )
+{
+	// The access pattern also hints at how the system file cache should read ahead.
+	const DWORD flags = FILE_ATTRIBUTE_NORMAL | ( ( Access::Sequential == m_Access ) ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_FLAG_RANDOM_ACCESS );
+	m_File = CreateFile( filename.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL /*security*/, OPEN_EXISTING, flags, NULL /*template*/ );
+	bool success = false;
+	if ( INVALID_HANDLE_VALUE != m_File ) {
+		LARGE_INTEGER fileSize = {};
+		if ( FALSE != GetFileSizeEx( m_File, &fileSize ) ) {
+			m_Size = static_cast<uint64_t>( fileSize.QuadPart );
+			if ( 0 == m_Size ) {
+				// An empty file cannot be mapped, but is otherwise valid.
+				success = true;
+			} else {
+				m_Mapping = CreateFileMapping( m_File, NULL /*security*/, PAGE_READONLY, 0 /*maxSizeHigh*/, 0 /*maxSizeLow*/, NULL /*name*/ );
+				success = ( NULL != m_Mapping ) && MapView( 0 /*offset*/, 1 /*size*/ );
+			}
+		}
+	}
+
+	if ( !success ) {
+		UnmapView();
+		if ( NULL != m_Mapping ) {
+			CloseHandle( m_Mapping );
+		}
+		if ( INVALID_HANDLE_VALUE != m_File ) {
+			CloseHandle( m_File );
+		}
+		throw std::runtime_error( "MappedFile could not map file" );
+	}
+}
+
+MappedFile::~MappedFile()
+{
+	UnmapView();
+	if ( NULL != m_Mapping ) {
+		CloseHandle( m_Mapping );
+	}
+	CloseHandle( m_File );
+}
+
+uint64_t MappedFile::GetSize() const
+{
+	return m_Size;
+}
+
+std::span<const uint8_t> MappedFile::GetView( const uint64_t offset, const size_t size )
+{
+	std::span<const uint8_t> view;
+	if ( ( offset < m_Size ) && ( size > 0 ) && MapView( offset, size ) ) {
+		const size_t viewOffset = static_cast<size_t>( offset - m_ViewOffset );
+		view = std::span<const uint8_t>( m_View + viewOffset, std::min<size_t>( size, m_ViewSize - viewOffset ) );
+	}
+	return view;
+}
+
+size_t MappedFile::Read( void* buffer, const size_t size )
+{
+	if ( ( Access::Sequential == m_Access ) && ( ( m_Position + kReadAheadSize / 2 ) > m_PrefetchPosition ) && ( m_Position < m_Size ) ) {
+		m_PrefetchPosition = m_Position + kReadAheadSize;
+		Prefetch( m_Position, kReadAheadSize );
+	}
+
+	size_t bytesRead = 0;
+	uint8_t* output = static_cast<uint8_t*>( buffer );
+	bool finished = ( nullptr == output );
+	while ( !finished && ( bytesRead < size ) ) {
+		const auto view = GetView( m_Position, size - bytesRead );
+		if ( view.empty() || !CopyFromView( output + bytesRead, view.data(), view.size() ) ) {
+			finished = true;
+		} else {
+			bytesRead += view.size();
+			m_Position += view.size();
+		}
+	}
+	return bytesRead;
+}
+
+uint64_t MappedFile::GetPosition() const
+{
+	return m_Position;
+}
+
+bool MappedFile::Seek( const uint64_t position )
+{
+	const bool success = ( position <= m_Size );
+	if ( success ) {
+		m_Position = position;
+		if ( position < m_PrefetchPosition ) {
+			m_PrefetchPosition = position;
+		}
+	}
+	return success;
+}
+
+bool MappedFile::IsEOF() const
+{
+	return ( m_Position >= m_Size );
+}
+
+void MappedFile::Prefetch( const uint64_t offset, const size_t size )
+{
+	if ( const auto prefetch = GetPrefetchFunction(); ( nullptr != prefetch ) && ( nullptr != m_View ) ) {
+		const uint64_t start = std::max<uint64_t>( offset, m_ViewOffset );
+		const uint64_t end = std::min<uint64_t>( offset + size, m_ViewOffset + m_ViewSize );
+		if ( start < end ) {
+			WIN32_MEMORY_RANGE_ENTRY range = {};
+			range.VirtualAddress = const_cast<uint8_t*>( m_View + static_cast<size_t>( start - m_ViewOffset ) );
+			range.NumberOfBytes = static_cast<SIZE_T>( end - start );
+			prefetch( GetCurrentProcess(), 1 /*numberOfEntries*/, &range, 0 /*flags*/ );
+		}
+	}
+}
+
+bool MappedFile::MapView( const uint64_t offset, const size_t size )
+{
+	const uint64_t end = ( offset < m_Size ) ? ( offset + std::min<uint64_t>( size, m_Size - offset ) ) : offset;
+	const bool mapped = ( nullptr != m_View ) && ( offset >= m_ViewOffset ) && ( end <= ( m_ViewOffset + m_ViewSize ) );
+	if ( !mapped && ( NULL != m_Mapping ) && ( offset < m_Size ) ) {
+		// Map a new view, starting at the allocation granularity boundary preceding the offset.
+		UnmapView();
+		const uint64_t viewOffset = offset - ( offset % GetAllocationGranularity() );
+		const uint64_t viewSize = std::min<uint64_t>( m_Size - viewOffset, GetMaxViewSize() );
+		m_View = static_cast<const uint8_t*>( MapViewOfFile( m_Mapping, FILE_MAP_READ, static_cast<DWORD>( viewOffset >> 32 ), static_cast<DWORD>( viewOffset & 0xffffffff ), static_cast<SIZE_T>( viewSize ) ) );
+		if ( nullptr != m_View ) {
+			m_ViewOffset = viewOffset;
+			m_ViewSize = static_cast<size_t>( viewSize );
+		}
+	}
+	return ( nullptr != m_View ) && ( offset >= m_ViewOffset ) && ( offset < ( m_ViewOffset + m_ViewSize ) );
+}
+
+void MappedFile::UnmapView()
+{
+	if ( nullptr != m_View ) {
+		UnmapViewOfFile( m_View );
+		m_View = nullptr;
+		m_ViewOffset = 0;
+		m_ViewSize = 0;
+	}
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "stdafx.h"
+
+#include <cstdint>
+#include <span>
+#include <string>
+
+// Read-only memory-mapped file, which provides zero-copy views of the file contents, as well as stream-like reads.
+// On 64-bit builds the whole file is mapped, otherwise a window onto the file is mapped on demand, to conserve address space.
+class MappedFile
+{
+public:
+	// File access pattern, used as a read-ahead hint.
+	enum class Access {
+		Sequential,		// The file is mostly read from start to end (e.g. when decoding), so data ahead of the current position is prefetched.
+		Random				// The file is read at scattered positions (e.g. when reading tags).
+	};
+
+	// 'filename' - file name.
+	// 'access' - file access pattern.
+	// Throws a std::runtime_error exception if the file could not be opened.
+	MappedFile( const std::wstring& filename, const Access access = Access::Sequential );
+
+	virtual ~MappedFile();
+
+	MappedFile( const MappedFile& ) = delete;
+	MappedFile& operator=( const MappedFile& ) = delete;
+
+	// Returns the file size, in bytes.
+	uint64_t GetSize() const;
+
+	// Returns a zero-copy view of up to 'size' bytes at an 'offset' in the file.
+	// The view is shorter than requested at the end of the file, or if the request is larger than the maximum view size.
+	// The view is only valid until the next call to GetView or Read.
+	// Note that accessing a view can raise an EXCEPTION_IN_PAGE_ERROR structured exception if the file becomes unavailable, which Read guards against.
+	std::span<const uint8_t> GetView( const uint64_t offset, const size_t size );
+
+	// Reads up to 'size' bytes from the current position into the 'buffer', and advances the current position.
+	// Returns the number of bytes read.
+	size_t Read( void* buffer, const size_t size );
+
+	// Returns the current position, in bytes.
+	uint64_t GetPosition() const;
+
+	// Sets the current 'position', in bytes, returning whether the position is within the file (a position at the end of the file is allowed).
+	bool Seek( const uint64_t position );
+
+	// Returns whether the current position is at the end of the file.
+	bool IsEOF() const;
+
+	// Hints that 'size' bytes at an 'offset' in the file will be needed soon, so that they can be read ahead of time.
+	// Only the part of the range which is currently mapped is prefetched.
+	void Prefetch( const uint64_t offset, const size_t size );
+
+private:
+	// Ensures that the range of 'size' bytes at an 'offset' is mapped (or as much of it as will fit in a view), returning whether any of the range is mapped.
+	bool MapView( const uint64_t offset, const size_t size );
+
+	// Unmaps the current view.
+	void UnmapView();
+
+	// File handle.
+	HANDLE m_File;
+
+	// File mapping handle (null for an empty file).
+	HANDLE m_Mapping;
+
+	// File size, in bytes.
+	uint64_t m_Size;
+
+	// File access pattern.
+	const Access m_Access;
+
+	// Current view.
+	const uint8_t* m_View;
+
+	// File offset of the current view.
+	uint64_t m_ViewOffset;
+
+	// Size of the current view, in bytes.
+	size_t m_ViewSize;
+
+	// Current position, in bytes.
+	uint64_t m_Position;
+
+	// File offset up to which data has been prefetched, when reading sequentially.
+	uint64_t m_PrefetchPosition;
+};
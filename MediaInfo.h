@@ -22,6 +22,9 @@ public:
 	// A list of media information.
 	typedef std::list<MediaInfo> List;
 
+	// A list of media information updates, pairing the previous media information with the updated media information.
+	typedef std::list<std::pair<MediaInfo,MediaInfo>> UpdateList;
+
 	// Source types.
 	enum class Source {
 		File,
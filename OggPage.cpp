@@ -14,39 +14,56 @@ uint32_t OggPage::MaximumContentSize = 255 * 255;
 OggPage::OggPage( std::fstream& stream ) :
 	m_Header(),
 	m_Content()
+{
+	const bool ok = stream.good() && ReadPage( [ &stream ] ( uint8_t* buffer, const size_t size )
+		{
+			stream.read( reinterpret_cast<char*>( buffer ), static_cast<std::streamsize>( size ) );
+			return stream.good();
+		} );
+	if ( !ok ) {
+		throw std::runtime_error( "Could not construct Ogg page from stream." );
+	}
+}
+
+OggPage::OggPage( MappedFile& file ) :
+	m_Header(),
+	m_Content()
+{
+	const bool ok = ReadPage( [ &file ] ( uint8_t* buffer, const size_t size )
+		{
+			return ( size == file.Read( buffer, size ) );
+		} );
+	if ( !ok ) {
+		throw std::runtime_error( "Could not construct Ogg page from file." );
+	}
+}
+
+bool OggPage::ReadPage( Reader reader )
 {
 	bool ok = false;
-	if ( stream.good() ) {
-		// Read the page header and do some basic checks.
-		m_Header.resize( 27 + 255 );
-		stream.read( reinterpret_cast<char*>( &m_Header[ 0 ] ), 27 );
-		if ( stream.good() && ( 0 == memcmp( &m_Header[ 0 ], "OggS", 4 ) ) && ( 0 == m_Header[ 4 ] ) ) {
-			const uint8_t segmentCount = m_Header[ 26 ];
-			if ( segmentCount > 0 ) {
-				stream.read( reinterpret_cast<char*>( &m_Header[ 27 ] ), segmentCount );
+
+	// Read the page header and do some basic checks.
+	m_Header.resize( 27 + 255 );
+	if ( reader( &m_Header[ 0 ], 27 ) && ( 0 == memcmp( &m_Header[ 0 ], "OggS", 4 ) ) && ( 0 == m_Header[ 4 ] ) ) {
+		const uint8_t segmentCount = m_Header[ 26 ];
+		if ( ( 0 == segmentCount ) || reader( &m_Header[ 27 ], segmentCount ) ) {
+			// Append the segment table to the header.
+			m_Header.resize( 27 + segmentCount );
+			uint32_t contentSize = 0;
+			auto segment = m_Header.begin() + 27;
+			while ( m_Header.end() != segment ) {
+				contentSize += *segment++;
 			}
-			if ( stream.good() ) {
-				// Append the segment table to the header.
-				m_Header.resize( 27 + segmentCount );
-				uint32_t contentSize = 0;
-				auto segment = m_Header.begin() + 27;
-				while ( m_Header.end() != segment ) {
-					contentSize += *segment++;
-				}
-				if ( contentSize > 0 ) {
-					// Read the packet data.
-					m_Content.resize( contentSize );
-					stream.read( reinterpret_cast<char*>( &m_Content[ 0 ] ), contentSize );
-				}
-				if ( stream.good() ) {
-					ok = CheckCRC();
-				}
+			if ( contentSize > 0 ) {
+				// Read the packet data.
+				m_Content.resize( contentSize );
+			}
+			if ( ( 0 == contentSize ) || reader( &m_Content[ 0 ], contentSize ) ) {
+				ok = CheckCRC();
 			}
 		}
 	}
-	if ( !ok ) {
-		throw std::runtime_error( "Could not construct Ogg page from stream." );
-	}
+	return ok;
 }
 
 OggPage::OggPage( const bool isContinued, const uint32_t serial, const uint32_t sequence, std::vector<uint8_t>& content ) :
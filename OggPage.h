@@ -1,6 +1,9 @@
 #pragma once
 
+#include "MappedFile.h"
+
 #include <fstream>
+#include <functional>
 #include <vector>
 
 // Encapsulates an Ogg page.
@@ -13,6 +16,12 @@ public:
 	// On successful construction, the stream will be positioned at the next page boundary.
 	OggPage( std::fstream& stream );
 
+	// 'file' - input file.
+	// Throws a std::runtime_error exception if a valid page could not be constructed from the file.
+	// The file, on input, is required to be positioned on a page boundary.
+	// On successful construction, the file will be positioned at the next page boundary.
+	OggPage( MappedFile& file );
+
 	// 'isContinued' - indicates whether the page is continued from a previous page.
 	// 'serial' - serial number (should be non-zero).
 	// 'sequence' - sequence number (should be non-zero).
@@ -87,6 +96,12 @@ public:
 	bool Write( std::ofstream& stream ) const;
 
 private:
+	// Reads 'size' bytes into the 'buffer', returning whether all bytes were read.
+	using Reader = std::function<bool( uint8_t* buffer, const size_t size )>;
+
+	// Reads the page using the 'reader', returning whether a valid page was read.
+	bool ReadPage( Reader reader );
+
 	// Calculates and stores the checksum.
 	void CalculateCRC();
 
@@ -82,6 +82,8 @@ void OptionsLoudness::OnInit( const HWND hwnd )
 	ComboBox_AddString( hwndClip, buf );
 	LoadString( GetInstanceHandle(), IDS_CLIPPREVENT_SOFTLIMIT, buf, bufSize );
 	ComboBox_AddString( hwndClip, buf );
+	LoadString( GetInstanceHandle(), IDS_CLIPPREVENT_LOOKAHEAD, buf, bufSize );
+	ComboBox_AddString( hwndClip, buf );
 	switch ( limitMode ) {
 		case Settings::LimitMode::None : {
 			ComboBox_SetCurSel( hwndClip, 0 );
@@ -95,6 +97,10 @@ void OptionsLoudness::OnInit( const HWND hwnd )
 			ComboBox_SetCurSel( hwndClip, 2 );
 			break;
 		}
+		case Settings::LimitMode::LookAhead : {
+			ComboBox_SetCurSel( hwndClip, 3 );
+			break;
+		}
 	}
 }
 
@@ -133,6 +139,10 @@ void OptionsLoudness::OnSave( const HWND hwnd )
 			limitMode = Settings::LimitMode::Soft;
 			break;
 		}
+		case 3 : {
+			limitMode = Settings::LimitMode::LookAhead;
+			break;
+		}
 	}
 	GetSettings().SetGainSettings( gainMode, limitMode, preamp );
 }
@@ -209,6 +219,10 @@ void OptionsLoudness::OnCommand( const HWND hwnd, const WPARAM wParam, const LPA
 						ComboBox_SetCurSel( GetDlgItem( hwnd, IDC_OPTIONS_GAIN_CLIP ), 2 );
 						break;
 					}
+					case Settings::LimitMode::LookAhead : {
+						ComboBox_SetCurSel( GetDlgItem( hwnd, IDC_OPTIONS_GAIN_CLIP ), 3 );
+						break;
+					}
 				}
 				const BOOL enable = ( Settings::GainMode::Disabled != gainMode );
 				EnableWindow( GetDlgItem( hwnd, IDC_OPTIONS_GAIN_OPTIONSGROUP ), enable );
@@ -11,15 +11,21 @@ static const uint32_t s_MaxCommentSize = 125829120;
 
 OpusComment::OpusComment( const std::wstring& filename, const bool readonly ) :
 	m_Filename( filename ),
-	m_Stream( filename, ( readonly ? ( std::ios::in | std::ios::binary ) : ( std::ios::in | std::ios::out | std::ios::binary ) ), _SH_DENYWR ),
+	m_Stream(),
 	m_OriginalPages(),
 	m_Vendor(),
 	m_Comments(),
 	m_BinaryData()
 {
+	if ( !readonly ) {
+		// The stream is only needed for writing out modified comments.
+		m_Stream.open( filename, std::ios::in | std::ios::out | std::ios::binary, _SH_DENYWR );
+	}
+
 	bool readComments = false;
 	try {
-		const OggPage header( m_Stream );
+		MappedFile file( filename, MappedFile::Access::Random );
+		const OggPage header( file );
 		if ( IsOpusHeader( header ) ) {
 		 	const uint32_t serial = header.GetSerialNumber();
 			const uint32_t sequence = header.GetSequenceNumber();
@@ -27,8 +33,8 @@ OpusComment::OpusComment( const std::wstring& filename, const bool readonly ) :
 			std::vector<uint8_t> vorbisComment;
 			bool valid = true;
 			while ( valid && !readComments ) {
-				const long long streamPos = m_Stream.tellg();
-				const OggPage page( m_Stream );
+				const long long streamPos = static_cast<long long>( file.GetPosition() );
+				const OggPage page( file );
 				if ( page.GetSerialNumber() == serial ) {
 					if ( page.GetSequenceNumber() != ++nextSequence ) {
 						// Treat a gap in page sequence numbers as an error.
@@ -110,7 +116,7 @@ OpusComment::OpusComment( const std::wstring& filename, const bool readonly ) :
 	} catch ( const std::runtime_error& ) {
 	}
 
-	if ( !readComments ) {
+	if ( !readComments || ( !readonly && !m_Stream.is_open() ) ) {
 		throw std::runtime_error( "Could not read Opus comments." );	
 	}
 }
@@ -84,7 +84,7 @@ private:
 	// Opus file name.
 	std::wstring m_Filename;
 
-	// Opus stream.
+	// Opus stream, for writing out modified comments (only opened when not read only).
 	std::fstream m_Stream;
 
 	// Original Opus comment page(s), keyed by the file offset to the start of the page.
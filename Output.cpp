@@ -1,16 +1,22 @@
 #include "Output.h"
 
-#include "GainCalculator.h"
+#include "SampleProcessing.h"
+
+#include "TrackAnalyser.h"
 #include "Utility.h"
 #include "VUPlayer.h"
 
+#include "json.hpp"
 #include "opus.h"
 
 #include "bassasio.h"
 #include "bassmix.h"
 #include "basswasapi.h"
 
+#include <algorithm>
 #include <cmath>
+#include <fstream>
+#include <thread>
 
 // Output buffer length, in seconds.
 constexpr float s_BufferLength = 1.5f;
@@ -30,9 +36,6 @@ constexpr float s_GainMax = 20.0f;
 // Fade out duration, in seconds.
 constexpr float s_FadeOutDuration = 5.0f;
 
-// The relative volume at which to set the crossfade position on a track.
-constexpr float s_CrossfadeVolume = 0.3f;
-
 // The fade to next duration, in seconds.
 constexpr float s_FadeToNextDuration = 3.0f;
 
@@ -45,6 +48,18 @@ constexpr DWORD s_StopFadeDuration = 20;
 // Maximum number of playlist items to skip when trying to switch decoder streams.
 constexpr size_t s_MaxSkipItems = 20;
 
+// Maximum amount of time to wait for a decoder to pre-buffer some initial data when starting playback.
+constexpr std::chrono::milliseconds s_PreBufferPrimeTimeout( 5000 );
+
+// The interval at which to check whether a decoder has pre-buffered some initial data when starting playback.
+constexpr std::chrono::milliseconds s_PreBufferPrimeInterval( 5 );
+
+// The interval at which the preload decoder thread checks for a new current item, in milliseconds.
+constexpr DWORD s_PreloadPollInterval = 20;
+
+// Initial capacity of each output queue snapshot, so that queueing the next item does not normally need to allocate on the audio thread.
+constexpr size_t s_OutputQueueReserve = 64;
+
 // Define to output debug timing for slow StreamProc calls.
 #undef STREAMPROC_TIMING
 
@@ -59,18 +74,30 @@ DWORD CALLBACK Output::StreamProc( HSTREAM handle, void *buf, DWORD length, void
 		QueryPerformanceCounter( &perfCount1 );
 #endif
 
+		const Clock::time_point startTime = Clock::now();
+		const DWORD bytesRequested = length;
 		float* sampleBuffer = static_cast<float*>( buf );
 		bytesRead = output->ApplyLeadIn( sampleBuffer, length, handle );
 		length -= bytesRead;
 		if ( length > 0 ) {
 			sampleBuffer += bytesRead / 4;
-			bytesRead += output->ReadSampleData( sampleBuffer, length, handle );
+			bytesRead += output->ReadOutputData( sampleBuffer, length, handle );
 			if ( 0 == bytesRead ) {
 				bytesRead = BASS_STREAMPROC_END;
 				output->SetOutputStreamFinished( true );
 			}
 		}
 
+		if ( Settings::OutputMode::WASAPIExclusive == output->m_OutputMode ) {
+			// The output device is fed by the WASAPI callback, so only the time spent is recorded here.
+			output->m_AudioPathCounters.StreamProcTime.Record( GetElapsedMicroseconds( startTime ) );
+		} else {
+			// A short read is only expected when there is no decoder stream to follow on from the current one.
+			const DWORD bytesDelivered = ( BASS_STREAMPROC_END == bytesRead ) ? 0 : bytesRead;
+			const bool underrun = ( bytesDelivered < bytesRequested ) && output->m_DecoderStream;
+			output->RecordCallback( output->m_AudioPathCounters.StreamProcTime, startTime, bytesRequested, bytesDelivered, underrun );
+		}
+
 #ifdef STREAMPROC_TIMING
 		QueryPerformanceCounter( &perfCount2 );
 		const float msec = 1000 * static_cast<float>( perfCount2.QuadPart - perfCount1.QuadPart ) / perfFreq.QuadPart;
@@ -94,6 +121,7 @@ DWORD CALLBACK Output::WasapiProc( void *buffer, DWORD length, void *user )
 				std::fill( sampleBuffer, sampleBuffer + length / 4, 0.0f );
 			}
 		} else {
+			const Clock::time_point startTime = Clock::now();
 			bytesRead = BASS_ChannelGetData( output->m_MixerStream, buffer, length );
 			if ( 0 == bytesRead ) {
 				if ( 0 == BASS_WASAPI_GetData( nullptr, BASS_DATA_AVAILABLE ) ) {
@@ -102,6 +130,10 @@ DWORD CALLBACK Output::WasapiProc( void *buffer, DWORD length, void *user )
 					output->SetOutputStreamFinished( true );
 				}
 			}
+
+			const DWORD bytesDelivered = ( ( BASS_STREAMPROC_END == bytesRead ) || ( static_cast<DWORD>( -1 ) == bytesRead ) ) ? 0 : bytesRead;
+			const bool underrun = ( bytesDelivered < length ) && ( BASS_STREAMPROC_END != bytesRead );
+			output->RecordCallback( output->m_AudioPathCounters.WasapiProcTime, startTime, length, bytesDelivered, underrun );
 		}
 	}
 	return bytesRead;
@@ -177,24 +209,25 @@ DWORD WINAPI Output::PreloadDecoderProc( LPVOID lpParam )
 	return 0;
 }
 
-Output::Output( const HINSTANCE instance, const HWND hwnd, const Handlers& handlers, Settings& settings ) :
+Output::Output( const HINSTANCE instance, const HWND hwnd, const Handlers& handlers, Settings& settings, SeekIndexer& seekIndexer ) :
 	m_hInst( instance ),
 	m_Parent( hwnd ),
 	m_Handlers( handlers ),
 	m_Settings( settings ),
+	m_SeekIndexer( seekIndexer ),
 	m_Playlist(),
 	m_CurrentItemDecoding( {} ),
 	m_SoftClipStateDecoding(),
+	m_LimiterDecoding(),
 	m_DecoderStream(),
 	m_DecoderSampleRate( 0 ),
 	m_OutputStream( 0 ),
 	m_MixerStream( 0 ),
 	m_PlaylistMutex(),
-	m_QueueMutex(),
 	m_Volume( 1.0f ),
 	m_Pitch( 1.0f ),
 	m_Balance( 0 ),
-	m_OutputQueue(),
+	m_OutputQueue( [] ( Queue& queue ) { queue.reserve( s_OutputQueueReserve ); } ),
 	m_RestartItemID( 0 ),
 	m_RandomPlay( false ),
 	m_RepeatTrack( false ),
@@ -204,6 +237,8 @@ Output::Output( const HINSTANCE instance, const HWND hwnd, const Handlers& handl
 	m_GainMode( Settings::GainMode::Disabled ),
 	m_LimitMode( Settings::LimitMode::None ),
 	m_GainPreamp( 0 ),
+	m_LimiterLookAhead( 0 ),
+	m_LimiterRelease( 0 ),
 	m_RetainStopAtTrackEnd( m_Settings.GetRetainStopAtTrackEnd() ),
 	m_StopAtTrackEnd( m_RetainStopAtTrackEnd ? m_Settings.GetStopAtTrackEnd() : false ),
 	m_Muted( false ),
@@ -211,7 +246,9 @@ Output::Output( const HINSTANCE instance, const HWND hwnd, const Handlers& handl
 	m_FadeToNext( false ),
 	m_SwitchToNext( false ),
 	m_FadeOutStartPosition( 0 ),
-	m_LastTransitionPosition( 0 ),
+	m_LastTransitionFrame( 0 ),
+	m_DecodedFrames( 0 ),
+	m_UnderrunPadding(),
 	m_CrossfadePosition( 0 ),
 	m_CrossfadeItem( {} ),
 	m_CrossfadeThread( nullptr ),
@@ -226,10 +263,13 @@ Output::Output( const HINSTANCE instance, const HWND hwnd, const Handlers& handl
 	m_CurrentItemCrossfading( {} ),
 	m_CrossfadingItemID( 0 ),
 	m_SoftClipStateCrossfading(),
+	m_LimiterCrossfading(),
+	m_CrossfadingBuffer(),
+	m_GainScale( 0, 1.0f ),
 	m_CrossfadeSeekOffset( 0 ),
 	m_GainEstimateMap(),
 	m_CurrentEQ( m_Settings.GetEQSettings() ),
-	m_FX(),
+	m_Equaliser(),
 	m_EQEnabled( m_CurrentEQ.Enabled ),
 	m_EQPreamp( m_CurrentEQ.Preamp ),
 	m_OutputMode( Settings::OutputMode::Standard ),
@@ -240,17 +280,41 @@ Output::Output( const HINSTANCE instance, const HWND hwnd, const Handlers& handl
 	m_OutputStreamFinished( false ),
 	m_MixerStreamHasEndSync( false ),
 	m_LeadInSeconds( 0 ),
-	m_PreloadedDecoder( {} ),
+	m_Resampler(),
+	m_PreloadWindow(),
+	m_PreloadedDecoders(),
 	m_PreloadedDecoderMutex(),
+	m_PreloadWindowSize( 0 ),
+	m_PreloadShuffleCandidates( 0 ),
+	m_PreloadMemoryLimit( 0 ),
+	m_PreloadItemID( 0 ),
+	m_PreloadCounters(),
+	m_DecodeAhead( false ),
+	m_DecodeAheadBudget( std::make_shared<OutputDecoder::DecodeAheadBudget>( 0 /*limit*/ ) ),
+	m_BufferedDecoder(),
+	m_BufferedDecoderID( 0 ),
+	m_BufferedDecoderMutex(),
+	m_AudioPathCounters(),
 	m_StreamTitleQueue(),
-	m_StreamTitleMutex(),
 	m_OnPlaylistChangeCallback( nullptr ),
 	m_OnPreBufferFinishedCallback( [ this ] ( const long id )
 		{
 			if ( id != m_CrossfadingItemID ) {
-				std::lock_guard<std::mutex> lock( m_PreloadedDecoderMutex );
-				if ( m_PreloadedDecoder.decoder ) {
-					m_PreloadedDecoder.decoder->PreBuffer( m_OnPreBufferFinishedCallback );
+				// Only the highest priority item in the prefetch window is pre-buffered.
+				OutputDecoderPtr decoder;
+				{
+					std::lock_guard<std::mutex> lock( m_PreloadedDecoderMutex );
+					if ( !m_PreloadWindow.empty() ) {
+						if ( const auto preloaded = FindPreloadedDecoder( m_PreloadWindow.front() ); m_PreloadedDecoders.end() != preloaded ) {
+							decoder = preloaded->decoder;
+						}
+					}
+				}
+				// Pre-buffering is started without holding the mutex, as the playback thread also takes the mutex when switching decoders.
+				if ( decoder ) {
+					// A decoder which is not yet playing is held to the per decoder memory limit.
+					decoder->SetMemoryLimit( m_PreloadMemoryLimit );
+					StartPreBuffer( *decoder );
 				}
 			}
 		}
@@ -266,6 +330,9 @@ Output::Output( const HINSTANCE instance, const HWND hwnd, const Handlers& handl
 	}
 
 	m_Settings.GetGainSettings( m_GainMode, m_LimitMode, m_GainPreamp );
+	m_Settings.GetLimiterSettings( m_LimiterLookAhead, m_LimiterRelease );
+	m_Equaliser.SetSettings( m_CurrentEQ );
+	UpdatePreloadSettings();
 	bool crossfade = false;
 	m_Settings.GetPlaybackSettings( m_RandomPlay, m_RepeatTrack, m_RepeatPlaylist, crossfade );
 	m_Crossfade = crossfade;
@@ -295,7 +362,13 @@ Output::~Output()
 
 bool Output::Play( const long playlistID, const float seek )
 {
-	Stop();
+	// When decoding ahead, keep the current decoder for seeks within the same item, so that seeks within the buffered range are immediate.
+	OutputDecoderPtr currentDecoder;
+	if ( m_DecodeAhead && ( playlistID > 0 ) && ( playlistID == m_CurrentItemDecoding.ID ) ) {
+		currentDecoder = m_DecoderStream;
+	}
+
+	StopOutput();
 
 	Playlist::Item item( { playlistID, MediaInfo() } );
 	if ( ( 0 == item.ID ) && m_Playlist ) {
@@ -306,7 +379,7 @@ bool Output::Play( const long playlistID, const float seek )
 	}
 
 	if ( m_Playlist && m_Playlist->GetItem( item ) ) {
-		m_DecoderStream = OpenOutputDecoder( item );
+		m_DecoderStream = currentDecoder ? currentDecoder : OpenOutputDecoder( item, true /*usePreloadedDecoder*/ );
 		if ( m_DecoderStream ) {
 
 			const DWORD outputBufferSize = static_cast<DWORD>( 1000 * ( ( ( MediaInfo::Source::CDDA ) == item.Info.GetSource() ) ? ( 2 * s_BufferLength ) : s_BufferLength ) );
@@ -320,45 +393,48 @@ bool Output::Play( const long playlistID, const float seek )
 			m_DecoderSampleRate = m_DecoderStream->GetSampleRate();
 			const DWORD freq = static_cast<DWORD>( m_DecoderSampleRate );
 			float seekPosition = seek;
-			if ( 0.0f != seekPosition ) {
+			if ( ( 0.0f != seekPosition ) || currentDecoder ) {
 				if ( seekPosition < 0 ) {
 					seekPosition = item.Info.GetDuration() + seekPosition;
 					if ( seekPosition < 0 ) {
 						seekPosition = 0;
 					}
 				}
-				seekPosition = m_DecoderStream->Seek( seekPosition );
+				seekPosition = SeekDecoder( *m_DecoderStream, seekPosition );
 			} else if ( GetCrossfade() ) {
-				m_DecoderStream->SkipSilence();
+				SkipSilence( item, *m_DecoderStream );
 			}
 
-			if ( ( Settings::OutputMode::Standard != m_OutputMode ) && !IsURL( item.Info.GetFilename() ) ) {
-				m_DecoderStream->PreBuffer( m_OnPreBufferFinishedCallback );
+			if ( UsePreBuffer( item ) ) {
+				StartPreBuffer( *m_DecoderStream );
+				WaitForPreBuffer( *m_DecoderStream );
 			}
 
 			if ( CreateOutputStream( item.Info ) ) {
 				m_CurrentItemDecoding = item;
+				SetBufferedDecoder( m_DecoderStream, item.ID );
 				UpdateOutputVolume();
-				if ( 1.0f != m_Pitch ) {
+				if ( ( 1.0f != m_Pitch ) && !m_Resampler ) {
 					BASS_ChannelSetAttribute( m_OutputStream, BASS_ATTRIB_FREQ, freq * m_Pitch );
 				}
 				if ( 0 != m_Balance ) {
 					BASS_ChannelSetAttribute( m_OutputStream, BASS_ATTRIB_PAN, m_Balance );
 				}
-				UpdateEQ( m_CurrentEQ );
 
 				State state = StartOutput();
 				if ( State::Playing == state ) {
-					Queue queue = GetOutputQueue();
-					queue.push_back( { item, 0, seekPosition } );
-					SetOutputQueue( queue );
+					m_OutputQueue.Update( [ queueItem = std::make_shared<const Playlist::Item>( item ), seekPosition ] ( Queue& queue )
+						{
+							queue.push_back( { queueItem, seekPosition, 0 } );
+						}
+					);
 					if ( GetCrossfade() ) {
 						CalculateCrossfadePoint( item, seekPosition );
 					}
 					StartLoudnessPrecalcThread();
-					PreloadNextDecoder( item );
+					RequestPreloadWindow( item.ID );
 				} else {
-					Stop();
+					StopOutput();
 				}
 			}
 		}
@@ -368,6 +444,12 @@ bool Output::Play( const long playlistID, const float seek )
 }
 
 void Output::Stop()
+{
+	StopOutput();
+	ClearPreloadedDecoders();
+}
+
+void Output::StopOutput()
 {
 	if ( 0 != m_OutputStream ) {
 		if ( Settings::OutputMode::Standard == m_OutputMode ) {
@@ -414,31 +496,43 @@ void Output::Stop()
 		}
 	}
 
-	m_FX.clear();
+	m_Resampler.reset();
+	m_Equaliser.Reset();
 	m_DecoderSampleRate = 0;
 	m_DecoderStream.reset();
 	m_CrossfadingStream.reset();
 	m_CurrentItemDecoding = {};
+	SetBufferedDecoder( nullptr, 0 );
 	m_SoftClipStateDecoding.clear();
+	m_LimiterDecoding.Reset();
 	m_CurrentItemCrossfading = {};
 	m_CrossfadingItemID = m_CurrentItemCrossfading.ID;
 	m_SoftClipStateCrossfading.clear();
+	m_LimiterCrossfading.Reset();
 	m_RestartItemID = 0;
-	SetOutputQueue( {} );
+	m_OutputQueue.Update( [] ( Queue& queue )
+		{
+			queue.clear();
+		}
+	);
 	m_FadeOut = false;
 	m_FadeToNext = false;
 	m_SwitchToNext = false;
 	m_FadeOutStartPosition = 0;
-	m_LastTransitionPosition = 0;
+	m_LastTransitionFrame = 0;
+	m_DecodedFrames = 0;
+	m_UnderrunPadding.Store( {} );
 	m_WASAPIFailed = false;
 	m_WASAPIPaused = false;
 	m_OutputStreamFinished = false;
 	m_MixerStreamHasEndSync = false;
 	StopCrossfadeThread();
 	StopLoudnessPrecalcThread();
-	std::lock_guard<std::mutex> lock( m_PreloadedDecoderMutex );
-	m_PreloadedDecoder = {};
-	SetStreamTitleQueue( {} );
+	m_StreamTitleQueue.Update( [] ( StreamTitleQueue& queue )
+		{
+			queue.clear();
+		}
+	);
 }
 
 void Output::Pause()
@@ -484,12 +578,7 @@ void Output::Previous( const bool forcePrevious, const float seek )
 			if ( forcePrevious || ( outputItem.Position < s_PreviousTrackCutoff ) ) {
 				Playlist::Item previousItem = {};
 				if ( GetRandomPlay() ) {
-					std::lock_guard<std::mutex> lock( m_PreloadedDecoderMutex );
-					if ( ( m_PreloadedDecoder.item.ID > 0 ) && ( m_PreloadedDecoder.item.ID != currentItem.ID ) && m_Playlist->ContainsItem( { m_PreloadedDecoder.item } ) ) {
-						previousItem = m_PreloadedDecoder.item;
-					} else {
-						previousItem = m_Playlist->GetRandomItem( currentItem );
-					}
+					previousItem = m_Playlist->GetRandomItem( currentItem );
 				} else {
 					m_Playlist->GetPreviousItem( currentItem, previousItem );
 				}
@@ -511,12 +600,7 @@ void Output::Next()
 		const Playlist::Item currentItem = outputItem.PlaylistItem;
 		Playlist::Item nextItem = {};
 		if ( GetRandomPlay() ) {
-			std::lock_guard<std::mutex> lock( m_PreloadedDecoderMutex );
-			if ( ( m_PreloadedDecoder.item.ID > 0 ) && ( m_PreloadedDecoder.item.ID != currentItem.ID ) && m_Playlist->ContainsItem( { m_PreloadedDecoder.item } ) ) {
-				nextItem = m_PreloadedDecoder.item;
-			} else {
-				nextItem = m_Playlist->GetRandomItem( currentItem );
-			}
+			nextItem = m_Playlist->GetRandomItem( currentItem );
 		} else {
 			m_Playlist->GetNextItem( currentItem, nextItem );
 		}
@@ -530,7 +614,10 @@ void Output::Play( const Playlist::Ptr playlist, const long startID, const float
 {
 	Stop();
 	if ( m_Playlist != playlist ) {
-		m_Playlist = playlist;
+		{
+			std::lock_guard<std::mutex> lock( m_PlaylistMutex );
+			m_Playlist = playlist;
+		}
 		if ( nullptr != m_OnPlaylistChangeCallback ) {
 			m_OnPlaylistChangeCallback( m_Playlist );
 		}
@@ -604,18 +691,11 @@ Output::Item Output::GetCurrentPlaying()
 	Item currentItem = {};
 	const State state = GetState();
 	if ( State::Stopped != state ) {
+		currentItem = GetQueueItem( *GetOutputQueue(), GetOutputFrame(), m_DecoderSampleRate );
 		const float seconds = GetOutputPosition();
-		const Queue queue = GetOutputQueue();
-		for ( auto iter = queue.rbegin(); iter != queue.rend(); iter++ ) {
-			const Item& item = *iter;
-			if ( item.Position <= seconds ) {
-				currentItem.PlaylistItem = item.PlaylistItem;
-				currentItem.Position = seconds - item.Position + item.InitialSeek;
-				break;
-			}
-		}
+		UpdateStreamTitleQueue( seconds );
 		const auto streamTitleQueue = GetStreamTitleQueue();
-		for ( auto iter = streamTitleQueue.rbegin(); iter != streamTitleQueue.rend(); iter++ ) {
+		for ( auto iter = streamTitleQueue->rbegin(); iter != streamTitleQueue->rend(); iter++ ) {
 			const auto& [ titlePosition, title ] = *iter;
 			if ( titlePosition <= seconds ) {
 				currentItem.StreamTitle = title;
@@ -626,10 +706,34 @@ Output::Item Output::GetCurrentPlaying()
 	return currentItem;
 }
 
+Output::Item Output::GetQueueItem( const Queue& queue, const long long frame, const long sampleRate )
+{
+	Item queueItem = {};
+	if ( sampleRate > 0 ) {
+		for ( auto iter = queue.rbegin(); iter != queue.rend(); iter++ ) {
+			const QueueItem& item = *iter;
+			if ( item.StartFrame <= frame ) {
+				queueItem.PlaylistItem = *item.PlaylistItem;
+				queueItem.InitialSeek = item.InitialSeek;
+				queueItem.StartFrame = item.StartFrame;
+				queueItem.Position = static_cast<float>( static_cast<double>( frame - item.StartFrame ) / sampleRate + item.InitialSeek );
+				break;
+			}
+		}
+	}
+	return queueItem;
+}
+
 DWORD Output::ReadSampleData( float* buffer, const DWORD byteCount, HSTREAM handle )
 {
+	const Clock::time_point startTime = Clock::now();
+
 	// Read sample data into the output buffer.
 	DWORD bytesRead = 0;
+
+	// Number of sample frames by which the decoder stream has underrun, which are padded with silence.
+	long underrunFrames = 0;
+
 	if ( ( nullptr != buffer ) && ( byteCount > 0 ) && m_DecoderStream ) {
 		const long channels = m_DecoderStream->GetChannels();
 		if ( channels > 0 ) {
@@ -648,11 +752,10 @@ DWORD Output::ReadSampleData( float* buffer, const DWORD byteCount, HSTREAM hand
 						// Ensure we don't read past the crossfade point.
 						const long sampleRate = m_DecoderStream->GetSampleRate();
 						if ( sampleRate > 0 ) {
-							const float trackPos = GetDecodePosition() - m_LastTransitionPosition - m_LeadInSeconds;
-							const float secondsTillCrossfade = crossfadePosition - trackPos;
-							const long samplesTillCrossfade = static_cast<long>( secondsTillCrossfade * sampleRate );
-							if ( samplesTillCrossfade < samplesToRead ) {
-								samplesToRead = samplesTillCrossfade;
+							const long long crossfadeFrame = static_cast<long long>( static_cast<double>( crossfadePosition ) * sampleRate );
+							const long long framesTillCrossfade = crossfadeFrame - ( m_DecodedFrames - m_LastTransitionFrame );
+							if ( framesTillCrossfade < samplesToRead ) {
+								samplesToRead = static_cast<long>( framesTillCrossfade );
 								if ( samplesToRead <= 0 ) {
 									samplesToRead = 0;
 									// Hold on the the decoder, and indicate its fade out position.
@@ -661,6 +764,8 @@ DWORD Output::ReadSampleData( float* buffer, const DWORD byteCount, HSTREAM hand
 									m_CurrentItemCrossfading = m_CurrentItemDecoding;
 									m_CrossfadingItemID = m_CurrentItemCrossfading.ID;
 									m_SoftClipStateCrossfading = m_SoftClipStateDecoding;
+									std::swap( m_LimiterCrossfading, m_LimiterDecoding );
+									m_LimiterDecoding.Reset();
 								}
 							}
 						}
@@ -675,25 +780,22 @@ DWORD Output::ReadSampleData( float* buffer, const DWORD byteCount, HSTREAM hand
 				m_CurrentItemCrossfading.ID = s_ItemIsFadingToNext;
 				m_CrossfadingItemID = m_CurrentItemCrossfading.ID;
 				m_SoftClipStateCrossfading = m_SoftClipStateDecoding;
+				std::swap( m_LimiterCrossfading, m_LimiterDecoding );
+				m_LimiterDecoding.Reset();
 			}
 
-			bytesRead = static_cast<DWORD>( m_DecoderStream->Read( buffer, samplesToRead ) * channels * 4 );
-		}
-
-		if ( m_DecoderStream->SupportsStreamTitles() ) {
-			auto streamTitleQueue = GetStreamTitleQueue();
-			const auto [ seconds, displayTitle ] = m_DecoderStream->GetStreamTitle();
-			if ( m_StreamTitleQueue.empty() || ( seconds != m_StreamTitleQueue.back().first ) ) {
-				streamTitleQueue.push_back( { seconds, displayTitle } );
-				SetStreamTitleQueue( streamTitleQueue );
+			const long samplesRead = ReadDecoder( *m_DecoderStream, buffer, samplesToRead );
+			bytesRead = static_cast<DWORD>( samplesRead * channels * 4 );
+			if ( ( samplesRead < samplesToRead ) && !m_DecoderStream->HasEnded() ) {
+				// The decoder stream has not ended, so hold on to it rather than switching to the next decoder stream.
+				underrunFrames = samplesToRead - samplesRead;
 			}
 		}
 	}
 
 	// Check if we need to switch to the next decoder stream.
-	if ( 0 == bytesRead ) {
+	if ( ( 0 == bytesRead ) && ( 0 == underrunFrames ) ) {
 		SetCrossfadePosition( 0 );
-		m_LastTransitionPosition = 0;
 
 		if ( ( GetStopAtTrackEnd() && ( m_CrossfadingItemID != s_ItemIsFadingToNext ) ) || GetFadeOut() ) {
 			// Set a sync on the output stream, so that the states can be toggled when playback actually finishes.
@@ -702,25 +804,38 @@ DWORD Output::ReadSampleData( float* buffer, const DWORD byteCount, HSTREAM hand
 		} else if ( m_DecoderStream && ( 0 != BASS_ChannelGetPosition( m_OutputStream, BASS_POS_DECODE ) ) && !IsURL( m_CurrentItemDecoding.Info.GetFilename() ) ) {
 			// Create a stream from the next playlist item, but not if there has been an error starting playback, or if the previous or next stream is a URL.
 			Playlist::Item nextItem = m_CurrentItemDecoding;
-			auto nextDecoder = GetNextDecoder( nextItem );
+			PlaylistItemPtr queueItem;
+			auto nextDecoder = GetNextDecoder( nextItem, queueItem );
 			if ( nextDecoder && !IsURL( nextItem.Info.GetFilename() ) ) {
 				EstimateGain( nextItem );
+				if ( queueItem && ( queueItem->Info.GetGainTrack() != nextItem.Info.GetGainTrack() ) ) {
+					// The gain has been estimated since the queue item was made (which is far more costly than copying the item).
+					queueItem = std::make_shared<const Playlist::Item>( nextItem );
+				}
 				const long channels = m_DecoderStream->GetChannels();
 				const long sampleRate = m_DecoderStream->GetSampleRate();
 				if ( ( nextDecoder->GetChannels() == channels ) && ( nextDecoder->GetSampleRate() == sampleRate ) ) {
 					if ( GetCrossfade() || GetFadeToNext() ) {
-						nextDecoder->SkipSilence();
+						SkipSilence( nextItem, *nextDecoder );
 					}
 
 					const long sampleCount = static_cast<long>( byteCount ) / ( channels * 4 );
-					bytesRead = static_cast<DWORD>( nextDecoder->Read( buffer, sampleCount ) * channels * 4 );
-					if ( bytesRead > 0 ) {
-						m_LastTransitionPosition = GetDecodePosition() - m_LeadInSeconds;
-						Queue queue = GetOutputQueue();
-						queue.push_back( { nextItem, m_LastTransitionPosition } );
-						SetOutputQueue( queue );
-
-						if ( GetCrossfade() && ( 0 != bytesRead ) ) {
+					const long samplesRead = ReadDecoder( *nextDecoder, buffer, sampleCount );
+					bytesRead = static_cast<DWORD>( samplesRead * channels * 4 );
+					if ( ( samplesRead < sampleCount ) && !nextDecoder->HasEnded() ) {
+						// The next decoder stream has not pre-buffered enough data yet, but can still be switched to.
+						underrunFrames = sampleCount - samplesRead;
+					}
+					if ( ( bytesRead > 0 ) || ( underrunFrames > 0 ) ) {
+						// The next item starts at exactly the frame following the last frame of the previous item.
+						m_LastTransitionFrame = m_DecodedFrames;
+						m_OutputQueue.Update( [ &queueItem, startFrame = m_LastTransitionFrame ] ( Queue& queue )
+							{
+								queue.push_back( { queueItem, 0, startFrame } );
+							}
+						);
+
+						if ( GetCrossfade() ) {
 							CalculateCrossfadePoint( nextItem );
 						}
 					} else {
@@ -732,8 +847,9 @@ DWORD Output::ReadSampleData( float* buffer, const DWORD byteCount, HSTREAM hand
 
 			m_DecoderStream = nextDecoder;
 			m_CurrentItemDecoding = nextItem;
+			SetBufferedDecoder( m_DecoderStream, nextItem.ID );
 
-			if ( ( 0 == bytesRead ) && ( nextItem.ID > 0 ) ) {
+			if ( ( 0 == bytesRead ) && ( 0 == underrunFrames ) && ( nextItem.ID > 0 ) ) {
 				// Signal that playback should be restarted from the next playlist item.
 				m_RestartItemID = nextItem.ID;
 				SetEndSync( handle );
@@ -744,15 +860,42 @@ DWORD Output::ReadSampleData( float* buffer, const DWORD byteCount, HSTREAM hand
 					m_CurrentItemCrossfading = {};
 					m_CrossfadingItemID = m_CurrentItemCrossfading.ID;
 					m_SoftClipStateCrossfading.clear();
+					m_LimiterCrossfading.Reset();
 				}
 			}
 		}
 	}
 
+	// Determine the fade out ramp for the currently decoding track, if necessary.
+	float fadeOutRampStart = 1.0f;
+	float fadeOutRampStep = 0;
+	if ( ( GetFadeOut() || GetFadeToNext() ) && ( 0 != bytesRead ) && ( m_FadeOutStartPosition > 0 ) && m_DecoderStream ) {
+		const float currentPos = GetDecodePosition();
+		const long channels = m_DecoderStream->GetChannels();
+		const long samplerate = m_DecoderStream->GetSampleRate();
+		if ( ( currentPos > m_FadeOutStartPosition ) && ( channels > 0 ) && ( samplerate > 0 ) ) {
+			if ( ( currentPos - m_FadeOutStartPosition ) > GetFadeOutDuration() ) {
+				bytesRead = 0;
+				underrunFrames = 0;
+				// Set a sync on the output stream, so that the 'fade out' state can be toggled when playback actually finishes.
+				m_RestartItemID = {};
+				SetEndSync( handle );
+			} else {
+				const float fadeOutEndPosition = m_FadeOutStartPosition + GetFadeOutDuration();
+				fadeOutRampStart = ( fadeOutEndPosition - currentPos ) / GetFadeOutDuration();
+				fadeOutRampStep = -1.0f / ( samplerate * GetFadeOutDuration() );
+
+				if ( GetFadeToNext() && ( currentPos > ( m_FadeOutStartPosition + GetFadeToNextDuration() ) ) ) {
+					m_SwitchToNext = true;
+				}
+			}
+		}		
+	}
+
 	if ( 0 != bytesRead ) {
 		const long currentDecodingChannels = m_CurrentItemDecoding.Info.GetChannels();
 		if ( currentDecodingChannels > 0 ) {
-			ApplyGain( buffer, static_cast<long>( bytesRead / ( currentDecodingChannels * 4 ) ), m_CurrentItemDecoding, m_SoftClipStateDecoding );
+			ApplyGain( buffer, static_cast<long>( bytesRead / ( currentDecodingChannels * 4 ) ), m_CurrentItemDecoding, m_SoftClipStateDecoding, m_LimiterDecoding, fadeOutRampStart, fadeOutRampStep );
 		}
 
 		std::lock_guard<std::mutex> crossfadingStreamLock( m_CrossfadingStreamMutex );
@@ -762,98 +905,78 @@ DWORD Output::ReadSampleData( float* buffer, const DWORD byteCount, HSTREAM hand
 			const long samplerate = m_CurrentItemCrossfading.Info.GetSampleRate();
 			if ( ( channels > 0 ) && ( samplerate > 0 ) ) {
 				const long samplesToRead = static_cast<long>( bytesRead ) / ( channels * 4 );
-				std::vector<float> crossfadingBuffer( bytesRead / 4 );
-				const long crossfadingBytesRead = m_CrossfadingStream->Read( crossfadingBuffer.data(), samplesToRead ) * channels * 4;
-				ApplyGain( crossfadingBuffer.data(), crossfadingBytesRead / ( channels * 4 ), m_CurrentItemCrossfading, m_SoftClipStateCrossfading );
+				if ( m_CrossfadingBuffer.size() < ( bytesRead / 4 ) ) {
+					m_CrossfadingBuffer.resize( bytesRead / 4 );
+				}
+				const long crossfadingBytesRead = ReadDecoder( *m_CrossfadingStream, m_CrossfadingBuffer.data(), samplesToRead ) * channels * 4;
 				if ( crossfadingBytesRead <= static_cast<long>( bytesRead ) ) {
-					long crossfadingSamplesRead = crossfadingBytesRead / ( channels * 4 );
+					const long crossfadingSamplesRead = crossfadingBytesRead / ( channels * 4 );
+					float rampStart = 1.0f;
+					float rampStep = 0;
+
+					// An underrun on the crossfading stream is skipped over, rather than finishing the crossfade early.
+					bool crossfadingFinished = ( 0 == crossfadingSamplesRead ) && m_CrossfadingStream->HasEnded();
 
 					if ( s_ItemIsFadingToNext == m_CurrentItemCrossfading.ID ) {
 						// Fade to next track.
 						const float currentPos = GetDecodePosition();
-						if ( ( currentPos > m_FadeOutStartPosition ) && ( channels > 0 ) && ( samplerate > 0 ) ) {
+						if ( currentPos > m_FadeOutStartPosition ) {
 							if ( ( currentPos - m_FadeOutStartPosition ) > GetFadeOutDuration() ) {
-								crossfadingSamplesRead = 0;
+								crossfadingFinished = true;
 							} else {
 								const float fadeOutEndPosition = m_FadeOutStartPosition + GetFadeOutDuration();
-								for ( long sampleIndex = 0; sampleIndex < crossfadingSamplesRead; sampleIndex++ ) {
-									const float pos = static_cast<float>( sampleIndex ) / samplerate;			
-									float scale = static_cast<float>( fadeOutEndPosition - currentPos - pos ) / GetFadeOutDuration();
-									if ( ( scale < 0 ) || ( scale > 1.0f ) ) {
-										scale = 0;
-									}
-									for ( long channel = 0; channel < channels; channel++ ) {
-										crossfadingBuffer[ sampleIndex * channels + channel ] *= scale;
-									}
-								}
+								rampStart = ( fadeOutEndPosition - currentPos ) / GetFadeOutDuration();
+								rampStep = -1.0f / ( samplerate * GetFadeOutDuration() );
 							}
 						}
 					} else {
 						// Crossfade.
-						const float trackPos = GetDecodePosition() - m_LastTransitionPosition - m_LeadInSeconds;
-						if ( ( crossfadingBytesRead > 0 ) && ( trackPos < GetFadeOutDuration() ) ) {				
-							for ( long sampleIndex = 0; sampleIndex < crossfadingSamplesRead; sampleIndex++ ) {
-								const float pos = static_cast<float>( sampleIndex ) / samplerate;			
-								float scale = static_cast<float>( GetFadeOutDuration() - trackPos - pos ) / GetFadeOutDuration();
-								if ( ( scale < 0 ) || ( scale > 1.0f ) ) {
-									scale = 0;
-								}
-								for ( long channel = 0; channel < channels; channel++ ) {
-									crossfadingBuffer[ sampleIndex * channels + channel ] *= scale;
-								}
-							}
+						const float trackPos = static_cast<float>( static_cast<double>( m_DecodedFrames - m_LastTransitionFrame ) / samplerate );
+						if ( trackPos < GetFadeOutDuration() ) {
+							rampStart = ( GetFadeOutDuration() - trackPos ) / GetFadeOutDuration();
+							rampStep = -1.0f / ( samplerate * GetFadeOutDuration() );
 						} else {
-							crossfadingSamplesRead = 0;
+							crossfadingFinished = true;
 						}
 					}
 
-					if ( 0 == crossfadingSamplesRead ) {
+					if ( crossfadingFinished ) {
 						m_CrossfadingStream.reset();
 						m_CurrentItemCrossfading = {};
 						m_CrossfadingItemID = m_CurrentItemCrossfading.ID;
 						m_SoftClipStateCrossfading.clear();
-					} else {
-						for ( long sample = 0; sample < crossfadingSamplesRead * channels; sample++ ) {
-							buffer[ sample ] += crossfadingBuffer[ sample ];
-						}
+						m_LimiterCrossfading.Reset();
+					} else if ( crossfadingSamplesRead > 0 ) {
+						ApplyGain( m_CrossfadingBuffer.data(), crossfadingSamplesRead, m_CurrentItemCrossfading, m_SoftClipStateCrossfading, m_LimiterCrossfading, rampStart, rampStep );
+						// Any fade out on the currently decoding track also applies to the crossfading stream.
+						MixRamp( buffer, m_CrossfadingBuffer.data(), static_cast<size_t>( channels ), static_cast<size_t>( crossfadingSamplesRead ), fadeOutRampStart, fadeOutRampStep );
 					}
 				}
 			}
 		}
 	}
 
-	// Apply fade out on the currently decoding track, if necessary.
-	if ( ( GetFadeOut() || GetFadeToNext() ) && ( 0 != bytesRead ) && ( m_FadeOutStartPosition > 0 ) && m_DecoderStream ) {
-		const float currentPos = GetDecodePosition();
-		const long channels = m_DecoderStream->GetChannels();
-		const long samplerate = m_DecoderStream->GetSampleRate();
-		if ( ( currentPos > m_FadeOutStartPosition ) && ( channels > 0 ) && ( samplerate > 0 ) ) {
-			if ( ( currentPos - m_FadeOutStartPosition ) > GetFadeOutDuration() ) {
-				bytesRead = 0;
-				// Set a sync on the output stream, so that the 'fade out' state can be toggled when playback actually finishes.
-				m_RestartItemID = {};
-				SetEndSync( handle );
-			} else {
-				const long sampleCount = static_cast<long>( bytesRead ) / ( channels * 4 );
-				const float fadeOutEndPosition = m_FadeOutStartPosition + GetFadeOutDuration();
-				for ( long sampleIndex = 0; sampleIndex < sampleCount; sampleIndex++ ) {
-					const float pos = static_cast<float>( sampleIndex ) / samplerate;			
-					float scale = static_cast<float>( fadeOutEndPosition - currentPos - pos ) / GetFadeOutDuration();
-					if ( ( scale < 0 ) || ( scale > 1.0f ) ) {
-						scale = 0;
-					}
-					for ( long channel = 0; channel < channels; channel++ ) {
-						buffer[ sampleIndex * channels + channel ] *= scale;
-					}
-				}
+	if ( 0 != bytesRead ) {
+		// Apply EQ to the final output, so that it behaves the same for all output modes.
+		const long channels = m_CurrentItemDecoding.Info.GetChannels();
+		if ( channels > 0 ) {
+			m_Equaliser.Process( buffer, channels, m_CurrentItemDecoding.Info.GetSampleRate(), bytesRead / ( channels * 4 ) );
+		}
 
-				if ( GetFadeToNext() && ( currentPos > ( m_FadeOutStartPosition + GetFadeToNextDuration() ) ) ) {
-					m_SwitchToNext = true;
-				}
-			}
-		}		
+		if ( const long decoderChannels = m_DecoderStream ? m_DecoderStream->GetChannels() : 0; decoderChannels > 0 ) {
+			m_DecodedFrames += static_cast<long long>( bytesRead / ( decoderChannels * 4 ) );
+		}
+	}
+
+	if ( const long decoderChannels = m_DecoderStream ? m_DecoderStream->GetChannels() : 0; ( underrunFrames > 0 ) && ( decoderChannels > 0 ) ) {
+		// Pad any decoder underrun with silence, which does not form part of the decoded output timeline.
+		float* padding = buffer + bytesRead / 4;
+		std::fill( padding, padding + static_cast<size_t>( underrunFrames ) * decoderChannels, 0.0f );
+		bytesRead += static_cast<DWORD>( underrunFrames * decoderChannels * 4 );
+		AddUnderrunPadding( underrunFrames );
 	}
 
+	m_AudioPathCounters.ReadSampleDataTime.Record( GetElapsedMicroseconds( startTime ) );
 	return bytesRead;
 }
 
@@ -873,6 +996,18 @@ void Output::SetVolume( const float volume )
 	}
 }
 
+DWORD Output::ReadOutputData( float* buffer, const DWORD byteCount, HSTREAM handle )
+{
+	DWORD bytesRead = 0;
+	if ( m_Resampler ) {
+		const DWORD frameSize = static_cast<DWORD>( m_Resampler->GetChannels() ) * 4;
+		bytesRead = static_cast<DWORD>( m_Resampler->Read( buffer, byteCount / frameSize ) ) * frameSize;
+	} else {
+		bytesRead = ReadSampleData( buffer, byteCount, handle );
+	}
+	return bytesRead;
+}
+
 float Output::GetPitch() const
 {
 	return m_Pitch;
@@ -890,7 +1025,9 @@ void Output::SetPitch( const float pitch )
 	if ( pitchValue != m_Pitch ) {
 		m_Pitch = pitchValue;
 		const long sampleRate = m_DecoderSampleRate;
-		if ( ( 0 != sampleRate ) && ( 0 != m_OutputStream ) ) {
+		if ( m_Resampler ) {
+			m_Resampler->SetPitch( m_Pitch );
+		} else if ( ( 0 != sampleRate ) && ( 0 != m_OutputStream ) ) {
 			BASS_ChannelSetAttribute( m_OutputStream, BASS_ATTRIB_FREQ, sampleRate * m_Pitch );
 		}
 	}
@@ -1042,8 +1179,7 @@ void Output::SetRandomPlay( const bool enabled )
 		if ( m_RandomPlay ) {
 			m_RepeatTrack = m_RepeatPlaylist = false;
 		}
-		std::lock_guard<std::mutex> lock( m_PreloadedDecoderMutex );
-		m_PreloadedDecoder = {};
+		ClearPreloadedDecoders();
 	}
 }
 
@@ -1083,11 +1219,11 @@ void Output::SetCrossfade( const bool enabled )
 	m_Crossfade = enabled;
 	if ( m_Crossfade ) {
 		if ( GetState() != State::Stopped ) {
-			const Queue queue = GetOutputQueue();
-			auto iter = queue.rbegin();
-			if ( queue.rend() != iter ) {
-				const Item item = *iter;
-				CalculateCrossfadePoint( item.PlaylistItem, item.InitialSeek );
+			const auto queue = GetOutputQueue();
+			auto iter = queue->rbegin();
+			if ( queue->rend() != iter ) {
+				const QueueItem& item = *iter;
+				CalculateCrossfadePoint( *item.PlaylistItem, item.InitialSeek );
 			}
 		}
 	} else {
@@ -1107,18 +1243,29 @@ bool Output::OnUpdatedMedia( const MediaInfo& mediaInfo )
 			changed = true;
 		}
 	} else {
-		const Item currentPlaying = GetCurrentPlaying();
-		Queue queue = GetOutputQueue();
-		for ( auto& iter : queue ) {
-			if ( iter.PlaylistItem.Info.GetFilename() == mediaInfo.GetFilename() ) {
-				iter.PlaylistItem.Info = mediaInfo;
-				if ( currentPlaying.PlaylistItem.ID == iter.PlaylistItem.ID ) {
-					changed = true;
+		// Only publish a new output queue snapshot if the media is in the queue.
+		const auto outputQueue = GetOutputQueue();
+		const bool queued = std::any_of( outputQueue->begin(), outputQueue->end(), [ &mediaInfo ] ( const QueueItem& item )
+			{
+				return item.PlaylistItem->Info.GetFilename() == mediaInfo.GetFilename();
+			}
+		);
+		if ( queued ) {
+			const Item currentPlaying = GetCurrentPlaying();
+			m_OutputQueue.Update( [ &mediaInfo, &currentPlaying, &changed ] ( Queue& queue )
+				{
+					for ( auto& iter : queue ) {
+						if ( iter.PlaylistItem->Info.GetFilename() == mediaInfo.GetFilename() ) {
+							auto updatedItem = std::make_shared<Playlist::Item>( *iter.PlaylistItem );
+							updatedItem->Info = mediaInfo;
+							iter.PlaylistItem = updatedItem;
+							if ( currentPlaying.PlaylistItem.ID == iter.PlaylistItem->ID ) {
+								changed = true;
+							}
+						}
+					}
 				}
-			}
-		}
-		if ( changed ) {
-			SetOutputQueue( queue );
+			);
 		}
 	}
 	return changed;
@@ -1202,6 +1349,8 @@ void Output::SettingsChanged()
 	Settings::LimitMode limitMode = Settings::LimitMode::None;
 	float gainPreamp = 0;
 	m_Settings.GetGainSettings( gainMode, limitMode, gainPreamp );
+	m_Settings.GetLimiterSettings( m_LimiterLookAhead, m_LimiterRelease );
+	UpdatePreloadSettings();
 	if ( ( gainMode != m_GainMode ) || ( limitMode != m_LimitMode ) || ( gainPreamp != m_GainPreamp ) ) {
 		m_GainMode = gainMode;
 		m_LimitMode = limitMode;
@@ -1277,6 +1426,12 @@ void Output::EstimateGain( Playlist::Item& item )
 				gain = trackGain;
 			}
 		}
+		if ( !gain.has_value() && m_Playlist ) {
+			if ( const auto results = m_Playlist->GetLibrary().GetAnalysis( item.Info ); results.has_value() && results->TrackGain.has_value() ) {
+				gain = results->TrackGain;
+				item.Info.SetGainTrack( gain );
+			}
+		}
 		if ( !gain.has_value() ) {
 			const auto estimateIter = m_GainEstimateMap.find( item.ID );
 			if ( m_GainEstimateMap.end() != estimateIter ) {
@@ -1293,6 +1448,23 @@ void Output::EstimateGain( Playlist::Item& item )
 	}
 }
 
+void Output::SkipSilence( const Playlist::Item& item, OutputDecoder& decoder )
+{
+	std::optional<float> leadingSilence;
+	if ( m_Playlist && !IsURL( item.Info.GetFilename() ) ) {
+		if ( const auto results = m_Playlist->GetLibrary().GetAnalysis( item.Info ); results.has_value() ) {
+			leadingSilence = results->LeadingSilence;
+		}
+	}
+	if ( leadingSilence.has_value() ) {
+		if ( *leadingSilence > 0 ) {
+			SeekDecoder( decoder, *leadingSilence );
+		}
+	} else {
+		decoder.SkipSilence();
+	}
+}
+
 void Output::CalculateCrossfadePoint( const Playlist::Item& item, const float seekOffset )
 {
 	StopCrossfadeThread();
@@ -1304,76 +1476,65 @@ void Output::CalculateCrossfadePoint( const Playlist::Item& item, const float se
 
 void Output::CalculateCrossfadeHandler()
 {
-	const auto decoder = IsURL( m_CrossfadeItem.Info.GetFilename() ) ? nullptr : OpenDecoder( m_CrossfadeItem );
-	if ( decoder ) {
-		const float duration = decoder->GetDuration();
-		const long channels = decoder->GetChannels();
-		const long samplerate = decoder->GetSampleRate();
-		if ( ( duration > 0 ) && ( channels > 0 ) && ( samplerate > 0 ) ) {
-			if ( 0.0f == m_CrossfadeSeekOffset ) {
-				decoder->SkipSilence();
-			}
-
-			float position = 0;
-			if ( m_CrossfadeSeekOffset > 0 ) {
-				position = decoder->Seek( m_CrossfadeSeekOffset );
-			}
-			float crossfadePosition = 0;
-
-			int64_t cumulativeCount = 0;
-			double cumulativeTotal = 0;
-			double cumulativeRMS = 0;
-
-			const double crossfadeRMSRatio = s_CrossfadeVolume;
-			const long windowSize = samplerate / 10;
-			std::vector<float> buffer( windowSize * channels );
-
-			while ( WAIT_OBJECT_0 != WaitForSingleObject( m_CrossfadeStopEvent, 0 ) ) {
-				long sampleCount = decoder->Read( buffer.data(), windowSize );
-				if ( sampleCount > 0 ) {
-					auto sampleIter = buffer.begin();
-					double windowTotal = 0;
-					for ( long sampleIndex = 0; sampleIndex < sampleCount; sampleIndex++ ) {
-						for ( long channel = 0; channel < channels; channel++, sampleIter++, cumulativeCount++ ) {
-							const double value = *sampleIter * *sampleIter;
-							windowTotal += value;
-							cumulativeTotal += value;
-						}
-					}
+	const Decoder::CanContinue canContinue( [ stopEvent = m_CrossfadeStopEvent ] ()
+	{
+		return ( WAIT_OBJECT_0 != WaitForSingleObject( stopEvent, 0 ) );
+	} );
 
-					const double windowRMS = sqrt( windowTotal / ( sampleCount * channels ) );
-					cumulativeRMS = sqrt( cumulativeTotal / cumulativeCount );
-					position += static_cast<float>( sampleCount ) / samplerate;
+	// Crossfade positions are relative to the end of any leading silence, which is only skipped when playing from the start of a track.
+	std::optional<float> crossfadePosition;
+	Library& library = m_Playlist->GetLibrary();
+	if ( const auto results = library.GetAnalysis( m_CrossfadeItem.Info ); results.has_value() && results->CrossfadePosition.has_value() && results->LeadingSilence.has_value() ) {
+		const float position = ( m_CrossfadeSeekOffset > 0 ) ? ( *results->LeadingSilence + *results->CrossfadePosition ) : *results->CrossfadePosition;
+		if ( ( 0.0f == m_CrossfadeSeekOffset ) || ( position > m_CrossfadeSeekOffset ) ) {
+			crossfadePosition = position;
+		}
+	}
 
-					if ( windowRMS > cumulativeRMS ) {
-						crossfadePosition = position;
-					} else if ( ( cumulativeRMS > 0 ) && ( ( windowRMS / cumulativeRMS ) > crossfadeRMSRatio ) ) {
-						crossfadePosition = position;
-					}
-				} else {
-					break;
+	if ( !crossfadePosition.has_value() ) {
+		const auto decoder = IsURL( m_CrossfadeItem.Info.GetFilename() ) ? nullptr : OpenDecoder( m_CrossfadeItem );
+		if ( decoder && ( decoder->GetDuration() > 0 ) ) {
+			if ( 0.0f == m_CrossfadeSeekOffset ) {
+				// Apply all analysers, so that the file does not need to be decoded again for any other purpose.
+				if ( const auto results = TrackAnalyser::Analyse( *decoder, TrackAnalyser::GetAllAnalysers(), canContinue ); results.has_value() ) {
+					crossfadePosition = results->CrossfadePosition;
+					library.SetAnalysis( m_CrossfadeItem.Info, *results );
+				}
+			} else {
+				TrackAnalyser::Analysers analysers;
+				analysers.Loudness = false;
+				analysers.Peak = false;
+				analysers.Silence = false;
+				const float position = decoder->Seek( m_CrossfadeSeekOffset );
+				if ( const auto results = TrackAnalyser::Analyse( *decoder, analysers, canContinue ); results.has_value() && results->CrossfadePosition.has_value() ) {
+					crossfadePosition = position + results->LeadingSilence.value_or( 0 ) + *results->CrossfadePosition;
 				}
 			}
-			if ( WAIT_OBJECT_0 != WaitForSingleObject( m_CrossfadeStopEvent, 0 ) ) {
-				SetCrossfadePosition( crossfadePosition - m_CrossfadeSeekOffset );
+		}
+	}
 
-				Playlist::Item nextItem = {};
-				{
-					std::lock_guard<std::mutex> lock( m_PreloadedDecoderMutex );
-					nextItem = m_PreloadedDecoder.item;
-				}
-				if ( MediaInfo::Source::CDDA == nextItem.Info.GetSource() ) {
-					// Pre-cache some CD audio data for the next track, to prevent glitches when crossfading.
-					if ( const auto nextDecoder = OpenDecoder( nextItem ); nextDecoder ) {
-						const long kSamplesToRead = 10 * nextDecoder->GetSampleRate();
-						long totalSamplesRead = 0;
-						while ( WAIT_OBJECT_0 != WaitForSingleObject( m_CrossfadeStopEvent, 0 ) ) {
-							const long samplesRead = nextDecoder->Read( buffer.data(), windowSize );
-							totalSamplesRead += samplesRead;
-							if ( ( totalSamplesRead >= kSamplesToRead ) || ( samplesRead <= 0 ) ) {
-								break;
-							}
-						}
+	if ( crossfadePosition.has_value() && canContinue() ) {
+		SetCrossfadePosition( *crossfadePosition - m_CrossfadeSeekOffset );
+
+		Playlist::Item nextItem = {};
+		{
+			std::lock_guard<std::mutex> lock( m_PreloadedDecoderMutex );
+			if ( !m_PreloadWindow.empty() ) {
+				nextItem = m_PreloadWindow.front();
+			}
+		}
+		if ( MediaInfo::Source::CDDA == nextItem.Info.GetSource() ) {
+			// Pre-cache some CD audio data for the next track, to prevent glitches when crossfading.
+			if ( const auto nextDecoder = OpenDecoder( nextItem ); nextDecoder ) {
+				const long kSamplesToRead = 10 * nextDecoder->GetSampleRate();
+				const long blockSize = nextDecoder->GetSampleRate() / 10;
+				std::vector<float> buffer( blockSize * nextDecoder->GetChannels() );
+				long totalSamplesRead = 0;
+				while ( canContinue() ) {
+					const long samplesRead = nextDecoder->Read( buffer.data(), blockSize );
+					totalSamplesRead += samplesRead;
+					if ( ( totalSamplesRead >= kSamplesToRead ) || ( samplesRead <= 0 ) ) {
+						break;
 					}
 				}
 			}
@@ -1453,6 +1614,7 @@ void Output::ToggleFadeToNext()
 			m_CurrentItemCrossfading = {};
 			m_CrossfadingItemID = m_CurrentItemCrossfading.ID;
 			m_SoftClipStateCrossfading.clear();
+			m_LimiterCrossfading.Reset();
 		}
 	}
 }
@@ -1462,11 +1624,11 @@ bool Output::GetFadeToNext() const
 	return m_FadeToNext;
 }
 
-void Output::ApplyGain( float* buffer, const long sampleCount, const Playlist::Item& item, std::vector<float>& softClipState )
+void Output::ApplyGain( float* buffer, const long sampleCount, const Playlist::Item& item, std::vector<float>& softClipState, Limiter& limiter, const float rampStart, const float rampStep )
 {
 	const bool eqEnabled = m_EQEnabled;
 	const long channels = item.Info.GetChannels();
-	if ( ( 0 != sampleCount ) && ( channels > 0 ) && ( ( Settings::GainMode::Disabled != m_GainMode ) || eqEnabled ) ) {
+	if ( ( sampleCount > 0 ) && ( channels > 0 ) ) {
 		float preamp = eqEnabled ? m_EQPreamp : 0;
 
 		if ( Settings::GainMode::Disabled != m_GainMode ) {
@@ -1487,48 +1649,35 @@ void Output::ApplyGain( float* buffer, const long sampleCount, const Playlist::I
 			}
 		}
 
-		if ( 0 != preamp ) {
-			const float scale = powf( 10.0f, preamp / 20.0f );
-			const long totalSamples = sampleCount * channels;
-			for ( long sampleIndex = 0; sampleIndex < totalSamples; sampleIndex++ ) {
-				buffer[ sampleIndex ] *= scale;
-			}
-			switch ( m_LimitMode ) {
-				case Settings::LimitMode::Hard : {
-					for ( long sampleIndex = 0; sampleIndex < totalSamples; sampleIndex++ ) {
-						if ( buffer[ sampleIndex ] < -1.0f ) {
-							buffer[ sampleIndex ] = -1.0f;
-						} else if ( buffer[ sampleIndex ] > 1.0f ) {
-							buffer[ sampleIndex ] = 1.0f;
-						}
-					}
-					break;
-				}
-				case Settings::LimitMode::Soft : {
-					if ( softClipState.size() != static_cast<size_t>( channels ) ) {
-						softClipState.resize( channels, 0 );
-					}
-					opus_pcm_soft_clip( buffer, sampleCount, channels, softClipState.data() );
-					break;
-				}
-				default : {
-					break;
-				}
+		if ( preamp != m_GainScale.first ) {
+			m_GainScale = { preamp, powf( 10.0f, preamp / 20.0f ) };
+		}
+		const float scale = m_GainScale.second;
+
+		// Apply gain, fade ramp & hard clip (if necessary) in a single pass.
+		const bool hardClip = ( 0 != preamp ) && ( Settings::LimitMode::Hard == m_LimitMode );
+		if ( ( 1.0f != scale ) || ( 1.0f != rampStart ) || ( 0 != rampStep ) || hardClip ) {
+			ApplyGainRamp( buffer, static_cast<size_t>( channels ), static_cast<size_t>( sampleCount ), scale, rampStart, rampStep, hardClip );
+		}
+
+		if ( ( 0 != preamp ) && ( Settings::LimitMode::Soft == m_LimitMode ) ) {
+			if ( softClipState.size() != static_cast<size_t>( channels ) ) {
+				softClipState.resize( channels, 0 );
 			}
+			opus_pcm_soft_clip( buffer, sampleCount, channels, softClipState.data() );
 		}
-	}
-}
 
-Output::Queue Output::GetOutputQueue()
-{
-	std::lock_guard<std::mutex> lock( m_QueueMutex );
-	return m_OutputQueue;
+		// The look-ahead limiter delays its output, so it is applied regardless of the preamp to avoid discontinuities when the preamp changes.
+		if ( Settings::LimitMode::LookAhead == m_LimitMode ) {
+			limiter.Configure( channels, item.Info.GetSampleRate(), m_LimiterLookAhead, m_LimiterRelease );
+			limiter.Process( buffer, static_cast<size_t>( sampleCount ) );
+		}
+	}
 }
 
-void Output::SetOutputQueue( const Queue& queue )
+SharedSnapshot<Output::Queue>::Ptr Output::GetOutputQueue() const
 {
-	std::lock_guard<std::mutex> lock( m_QueueMutex );
-	m_OutputQueue = queue;
+	return m_OutputQueue.Get();
 }
 
 float Output::GetPitchRange() const
@@ -1541,56 +1690,8 @@ void Output::UpdateEQ( const Settings::EQ& eq )
 {
 	m_EQEnabled = eq.Enabled;
 	m_EQPreamp = eq.Preamp;
-
 	m_CurrentEQ = eq;
-	if ( 0 != m_OutputStream ) {
-		if ( eq.Enabled ) {	
-			if ( m_FX.empty() ) {
-				// Add FX to current output stream.
-				BASS_DX8_PARAMEQ params = {};
-				params.fBandwidth = eq.Bandwidth;
-				for ( const auto& setting : eq.Gains ) {
-					const int freq = setting.first;
-					const HFX fx = BASS_ChannelSetFX( m_OutputStream, BASS_FX_DX8_PARAMEQ, 100 /*priority*/ );
-					if ( 0 != fx ) {
-						params.fCenter = static_cast<float>( freq );
-						params.fGain = setting.second;
-						BASS_FXSetParameters( fx, &params );
-
-						BASS_FXGetParameters( fx, &params );
-						if ( static_cast<int>( params.fCenter ) != freq ) {
-							// The centre frequency was too high for the stream, so remove the FX.
-							BASS_ChannelRemoveFX( m_OutputStream, fx );
-						} else {
-							m_FX.push_back( fx );
-						}
-					}
-				}
-			} else {
-				// Modify FX on the current output stream.
-				for ( const auto& fx : m_FX ) {
-					BASS_DX8_PARAMEQ params = {};
-					if ( BASS_FXGetParameters( fx, &params ) ) {
-						const int freq = static_cast<int>( params.fCenter );
-						const auto setting = eq.Gains.find( freq );
-						if ( eq.Gains.end() != setting ) {
-							const float gain = setting->second;
-							if ( gain != params.fGain ) {
-								params.fGain = gain;
-								BASS_FXSetParameters( fx, &params );
-							}
-						}
-					}
-				}
-			}
-		} else {
-			// Disable EQ.
-			for ( const auto& fx : m_FX ) {
-				BASS_ChannelRemoveFX( m_OutputStream, fx );
-			}
-			m_FX.clear();
-		}
-	}
+	m_Equaliser.SetSettings( eq );
 }
 
 Decoder::Ptr Output::OpenDecoder( Playlist::Item& item )
@@ -1604,31 +1705,64 @@ Decoder::Ptr Output::OpenDecoder( Playlist::Item& item )
 		}
 	}
 	if ( decoder ) {
-		m_Playlist->GetLibrary().UpdateMediaInfoFromDecoder( item.Info, *decoder );
+		Library& library = m_Playlist->GetLibrary();
+		library.UpdateMediaInfoFromDecoder( item.Info, *decoder );
+		if ( decoder->SupportsSeekIndex() ) {
+			bool indexable = true;
+			if ( const SeekIndex::Ptr seekIndex = library.GetSeekIndex( item.Info, indexable ); seekIndex ) {
+				decoder->SetSeekIndex( seekIndex );
+			} else if ( indexable ) {
+				m_SeekIndexer.Add( item.Info );
+			}
+		}
 	}
 	return decoder;
 }
 
-Output::OutputDecoderPtr Output::OpenOutputDecoder( Playlist::Item& item, const bool usePreloadedDecoder )
+Output::OutputDecoderPtr Output::OpenOutputDecoder( Playlist::Item& item, const bool usePreloadedDecoder, PlaylistItemPtr* preloadedItem )
 {
 	OutputDecoderPtr outputDecoder;
 	if ( usePreloadedDecoder ) {
-		std::lock_guard<std::mutex> lock( m_PreloadedDecoderMutex );
-		if ( m_PreloadedDecoder.decoder && ( m_PreloadedDecoder.item.Info.GetFilename() == item.Info.GetFilename() ) && ( m_PreloadedDecoder.item.Info.GetFiletime() == item.Info.GetFiletime() ) ) {
-			outputDecoder = m_PreloadedDecoder.decoder;
-			m_PreloadedDecoder.decoder.reset();
-			m_PreloadedDecoder.item = {};
-			if ( ( Settings::OutputMode::Standard != m_OutputMode ) && !IsURL( item.Info.GetFilename() ) ) {
-				// Ensure pre-buffering has started (in case the pre-buffer finished callback was not received for the previous decoder).
-				outputDecoder->PreBuffer( m_OnPreBufferFinishedCallback );
+		{
+			std::lock_guard<std::mutex> lock( m_PreloadedDecoderMutex );
+			if ( const auto preloaded = FindPreloadedDecoder( item ); m_PreloadedDecoders.end() != preloaded ) {
+				outputDecoder = preloaded->decoder;
+				if ( nullptr != preloadedItem ) {
+					*preloadedItem = preloaded->item;
+				}
+				m_PreloadedDecoders.erase( preloaded );
 			}
 		}
+		if ( outputDecoder ) {
+			// The playing decoder is only held to the shared decode-ahead memory ceiling.
+			outputDecoder->SetMemoryLimit( 0 );
+		}
+		if ( outputDecoder && UsePreBuffer( item ) ) {
+			// Ensure pre-buffering has started (in case the pre-buffer finished callback was not received for the previous decoder).
+			// This is done without holding the mutex, as the pre-buffer finished callback can start pre-buffering for the same decoder.
+			StartPreBuffer( *outputDecoder );
+		}
+		if ( outputDecoder ) {
+			++m_PreloadCounters.Hits;
+		} else {
+			++m_PreloadCounters.Misses;
+		}
 	}
 	if ( !outputDecoder ) {
+		const Clock::time_point startTime = Clock::now();
 		try {
 			outputDecoder = std::make_shared<OutputDecoder>( OpenDecoder( item ), item.ID );
 		} catch ( const std::runtime_error& ) {
 		}
+		const uint64_t openTime = GetElapsedMicroseconds( startTime );
+		m_AudioPathCounters.DecoderOpenTime.Record( openTime );
+		if ( usePreloadedDecoder ) {
+			// Only decoders opened on the playback path are included in the preload open time.
+			m_PreloadCounters.TotalOpenTime += openTime;
+			uint64_t maxOpenTime = m_PreloadCounters.MaxOpenTime.load();
+			while ( ( openTime > maxOpenTime ) && !m_PreloadCounters.MaxOpenTime.compare_exchange_weak( maxOpenTime, openTime ) ) {
+			}
+		}
 	}
 	return outputDecoder;
 }
@@ -1675,8 +1809,14 @@ Output::State Output::StartOutput()
 
 float Output::GetDecodePosition() const
 {
-	const QWORD bytesPos = BASS_ChannelGetPosition( m_OutputStream, BASS_POS_DECODE );
-	const float seconds = static_cast<float>( BASS_ChannelBytes2Seconds( m_OutputStream, bytesPos ) );
+	float seconds = 0;
+	const long long inputFramesRead = m_Resampler ? m_Resampler->GetInputFramesRead() : 0;
+	if ( inputFramesRead > 0 ) {
+		seconds = m_LeadInSeconds + static_cast<float>( static_cast<double>( inputFramesRead ) / m_Resampler->GetInputRate() );
+	} else {
+		const QWORD bytesPos = BASS_ChannelGetPosition( m_OutputStream, BASS_POS_DECODE );
+		seconds = static_cast<float>( BASS_ChannelBytes2Seconds( m_OutputStream, bytesPos ) );
+	}
 	return seconds;
 }
 
@@ -1692,7 +1832,7 @@ float Output::GetOutputPosition() const
 		case Settings::OutputMode::WASAPIExclusive :
 		case Settings::OutputMode::ASIO : {
 			const QWORD bytePos = BASS_Mixer_ChannelGetPosition( m_OutputStream, BASS_POS_BYTE );
-			seconds = static_cast<float>( BASS_ChannelBytes2Seconds( m_OutputStream, bytePos ) ) - m_LeadInSeconds;
+			seconds = GetOutputStreamSeconds( bytePos ) - m_LeadInSeconds;
 			if ( seconds < 0 ) {
 				seconds = 0;
 			}
@@ -1702,6 +1842,104 @@ float Output::GetOutputPosition() const
 	return seconds;
 }
 
+long long Output::GetOutputFrame() const
+{
+	long long frame = 0;
+	BASS_CHANNELINFO info = {};
+	if ( ( TRUE == BASS_ChannelGetInfo( m_OutputStream, &info ) ) && ( info.chans > 0 ) ) {
+		const long long frameSize = static_cast<long long>( info.chans ) * 4;
+		switch ( m_OutputMode ) {
+			case Settings::OutputMode::Standard : {
+				// The output stream runs at the decoder sample rate, with no lead-in.
+				frame = static_cast<long long>( BASS_ChannelGetPosition( m_OutputStream, BASS_POS_BYTE ) ) / frameSize;
+				break;
+			}
+			case Settings::OutputMode::WASAPIExclusive :
+			case Settings::OutputMode::ASIO : {
+				// Discount the lead-in (which is padded in the same way as when applying the lead-in), then map back to the decoder sample rate if resampling.
+				const long long leadInFrames = static_cast<long long>( 0.5f + m_LeadInSeconds * info.freq );
+				const long long outputFrame = static_cast<long long>( BASS_Mixer_ChannelGetPosition( m_OutputStream, BASS_POS_BYTE ) ) / frameSize - leadInFrames;
+				if ( outputFrame > 0 ) {
+					frame = m_Resampler ? static_cast<long long>( m_Resampler->GetInputPosition( outputFrame ) ) : outputFrame;
+				}
+				break;
+			}
+		}
+	}
+	frame -= GetUnderrunPaddingFrames( frame );
+	return std::max<long long>( 0ll, frame );
+}
+
+void Output::AddUnderrunPadding( const long frames )
+{
+	UnderrunPadding padding = m_UnderrunPadding.Load();
+	const long long outputFrame = m_DecodedFrames + padding.TotalFrames;
+	UnderrunPadding::Run* lastRun = ( padding.Count > 0 ) ? &padding.Runs[ ( padding.Count - 1 ) % UnderrunPadding::kMaxRuns ] : nullptr;
+	if ( ( nullptr != lastRun ) && ( ( lastRun->OutputFrame + lastRun->Frames ) == outputFrame ) ) {
+		// Extend the previous run of silence if the decoder stream is still underrunning.
+		lastRun->Frames += frames;
+	} else {
+		padding.Runs[ padding.Count % UnderrunPadding::kMaxRuns ] = { outputFrame, frames };
+		++padding.Count;
+	}
+	padding.TotalFrames += frames;
+	m_UnderrunPadding.Store( padding );
+}
+
+long long Output::GetUnderrunPaddingFrames( const long long outputFrame ) const
+{
+	const UnderrunPadding padding = m_UnderrunPadding.Load();
+	long long paddingFrames = padding.TotalFrames;
+	const size_t runCount = std::min<size_t>( padding.Count, UnderrunPadding::kMaxRuns );
+	for ( size_t index = 0; index < runCount; index++ ) {
+		// Work back from the most recent run of silence, to find the run at (or before) the output frame.
+		const UnderrunPadding::Run& run = padding.Runs[ ( padding.Count - 1 - index ) % UnderrunPadding::kMaxRuns ];
+		paddingFrames -= run.Frames;
+		if ( run.OutputFrame <= outputFrame ) {
+			paddingFrames += std::min<long long>( run.Frames, outputFrame - run.OutputFrame );
+			break;
+		}
+	}
+	return paddingFrames;
+}
+
+void Output::WaitForPreBuffer( const OutputDecoder& decoder ) const
+{
+	const Clock::time_point startTime = Clock::now();
+	while ( !decoder.IsPreBufferPrimed() && ( ( Clock::now() - startTime ) < s_PreBufferPrimeTimeout ) ) {
+		std::this_thread::sleep_for( s_PreBufferPrimeInterval );
+	}
+}
+
+float Output::GetOutputStreamSeconds( const QWORD bytePos ) const
+{
+	float seconds = static_cast<float>( BASS_ChannelBytes2Seconds( m_OutputStream, bytePos ) );
+	if ( m_Resampler && ( seconds > m_LeadInSeconds ) ) {
+		const long long frameSize = static_cast<long long>( m_Resampler->GetChannels() ) * 4;
+		const long long leadInFrames = static_cast<long long>( 0.5f + m_LeadInSeconds * m_Resampler->GetOutputRate() );
+		const long long outputFrame = static_cast<long long>( bytePos ) / frameSize - leadInFrames;
+		seconds = m_LeadInSeconds + static_cast<float>( m_Resampler->GetInputPosition( outputFrame ) / m_Resampler->GetInputRate() );
+	}
+	return seconds;
+}
+
+DWORD Output::CreateResampler( const DWORD inputRate, const DWORD outputRate, const DWORD channels )
+{
+	DWORD streamRate = inputRate;
+	m_Resampler.reset();
+	const Settings::ResamplerQuality quality = m_Settings.GetResamplerQuality();
+	if ( ( Settings::ResamplerQuality::Disabled != quality ) && ( outputRate > 0 ) ) {
+		const long frameSize = static_cast<long>( channels ) * 4;
+		Resampler::Reader reader = [ this, frameSize ] ( float* buffer, const size_t frames ) -> size_t
+		{
+			return ReadSampleData( buffer, static_cast<DWORD>( frames * frameSize ), m_OutputStream ) / frameSize;
+		};
+		m_Resampler = std::make_unique<Resampler>( static_cast<long>( channels ), static_cast<long>( inputRate ), static_cast<long>( outputRate ), m_Pitch, quality, reader );
+		streamRate = outputRate;
+	}
+	return streamRate;
+}
+
 LONGLONG Output::GetTick()
 {
 	LARGE_INTEGER count;
@@ -1804,7 +2042,8 @@ bool Output::CreateOutputStream( const MediaInfo& mediaInfo )
 						success = ( 0 != m_MixerStream );
 						if ( success ) {
 							flags = BASS_SAMPLE_FLOAT | BASS_STREAM_DECODE;
-							m_OutputStream = BASS_StreamCreate( samplerate, channels, flags, StreamProc, this );
+							const DWORD streamRate = CreateResampler( samplerate, outputSamplerate, channels );
+							m_OutputStream = BASS_StreamCreate( streamRate, channels, flags, StreamProc, this );
 							success = ( 0 != m_OutputStream );
 							if ( success ) {
 								flags = BASS_MIXER_CHAN_BUFFER;
@@ -1824,6 +2063,7 @@ bool Output::CreateOutputStream( const MediaInfo& mediaInfo )
 								BASS_StreamFree( m_MixerStream );
 								m_MixerStream = 0;
 							}
+							m_Resampler.reset();
 						}
 					}
 
@@ -1865,7 +2105,8 @@ bool Output::CreateOutputStream( const MediaInfo& mediaInfo )
 						success = ( 0 != m_MixerStream );
 						if ( success ) {
 							flags = BASS_SAMPLE_FLOAT | BASS_STREAM_DECODE;
-							m_OutputStream = BASS_StreamCreate( samplerate, channels, flags, StreamProc, this );
+							const DWORD streamRate = CreateResampler( samplerate, static_cast<DWORD>( outputSamplerate ), channels );
+							m_OutputStream = BASS_StreamCreate( streamRate, channels, flags, StreamProc, this );
 							success = ( 0 != m_OutputStream );
 							if ( success ) {
 								flags = BASS_MIXER_CHAN_BUFFER;
@@ -1891,6 +2132,7 @@ bool Output::CreateOutputStream( const MediaInfo& mediaInfo )
 								BASS_StreamFree( m_MixerStream );
 								m_MixerStream = 0;
 							}
+							m_Resampler.reset();
 						}
 					}
 
@@ -1994,7 +2236,9 @@ void Output::LoudnessPrecalcHandler()
 				m_Playlist->GetLibrary().GetMediaInfo( item->Info, false /*checkFileAttributes*/, false /*scanMedia*/, false /*sendNotification*/ );
 				gain = item->Info.GetGainTrack();
 				if ( !gain.has_value() ) {
-					gain = GainCalculator::CalculateTrackGain( item->Info.GetFilename(), m_Handlers, canContinue );
+					if ( const auto results = TrackAnalyser::AnalyseFile( item->Info, m_Playlist->GetLibrary(), m_Handlers, canContinue ); results.has_value() ) {
+						gain = results->TrackGain;
+					}
 					if ( gain.has_value() ) {
 						const MediaInfo previousMediaInfo( item->Info );
 						item->Info.SetGainTrack( gain );
@@ -2050,22 +2294,18 @@ void Output::SetOutputStreamFinished( const bool finished )
 	m_OutputStreamFinished = finished;
 }
 
-Output::OutputDecoderPtr Output::GetNextDecoder( Playlist::Item& item )
+Output::OutputDecoderPtr Output::GetNextDecoder( Playlist::Item& item, PlaylistItemPtr& queueItem )
 {
 	OutputDecoderPtr nextDecoder;
 	Playlist::Item nextItem = item;
 	item = {};
+	queueItem.reset();
 	std::lock_guard<std::mutex> playlistLock( m_PlaylistMutex );
 	if ( m_Playlist ) {
 		size_t skip = 0;
 		while ( !nextDecoder && ( nextItem.ID > 0 ) && ( skip++ < s_MaxSkipItems ) ) {
 			if ( GetRandomPlay() ) {
-				std::lock_guard<std::mutex> preloadLock( m_PreloadedDecoderMutex );
-				if ( ( m_PreloadedDecoder.item.ID > 0 ) && ( m_Playlist->ContainsItem( m_PreloadedDecoder.item ) ) ) {
-					nextItem = m_PreloadedDecoder.item;
-				} else {
-					nextItem = m_Playlist->GetRandomItem( nextItem );
-				}
+				nextItem = m_Playlist->GetRandomItem( nextItem );
 			} else if ( GetRepeatTrack() ) {
 				nextItem = m_CurrentItemDecoding;
 			} else {
@@ -2074,10 +2314,13 @@ Output::OutputDecoderPtr Output::GetNextDecoder( Playlist::Item& item )
 				m_Playlist->GetNextItem( currentItem, nextItem, GetRepeatPlaylist() /*wrap*/ );
 			}
 			if ( nextItem.ID > 0 ) {
-				nextDecoder = OpenOutputDecoder( nextItem, true /*usePreloadedDecoder*/ );
+				PlaylistItemPtr preloadedItem;
+				nextDecoder = OpenOutputDecoder( nextItem, true /*usePreloadedDecoder*/, &preloadedItem );
 				if ( nextDecoder ) {
 					item = nextItem;
-					PreloadNextDecoder( item );
+					// The preloaded item is only shared if it is the same playlist entry (a preloaded decoder is matched on the file alone).
+					queueItem = ( preloadedItem && ( preloadedItem->ID == item.ID ) ) ? preloadedItem : std::make_shared<const Playlist::Item>( item );
+					RequestPreloadWindow( item.ID );
 				}
 			}
 		}
@@ -2107,48 +2350,389 @@ void Output::StopPreloadDecoderThread()
 void Output::PreloadDecoderHandler()
 {
 	const HANDLE handles[ 2 ] = { m_PreloadDecoderStopEvent, m_PreloadDecoderWakeEvent };
-	while ( WaitForMultipleObjects( 2, handles, FALSE /*waitAll*/, INFINITE ) != WAIT_OBJECT_0 ) {
-		std::lock_guard<std::mutex> lock( m_PreloadedDecoderMutex );
-		const std::wstring& filename = m_PreloadedDecoder.itemToPreload.Info.GetFilename();
-		m_PreloadedDecoder.decoder = IsURL( filename ) ? nullptr : OpenOutputDecoder( m_PreloadedDecoder.itemToPreload );
-		if ( m_PreloadedDecoder.decoder ) {
-			m_PreloadedDecoder.item = m_PreloadedDecoder.itemToPreload;
-		} else {
-			m_PreloadedDecoder.item = {};
+	while ( WaitForMultipleObjects( 2, handles, FALSE /*waitAll*/, s_PreloadPollInterval ) != WAIT_OBJECT_0 ) {
+		// The prefetch window is calculated here, rather than on the playback thread which requested it.
+		if ( const long itemID = m_PreloadItemID.exchange( 0 ); itemID > 0 ) {
+			UpdatePreloadWindow( itemID );
+		}
+		if ( WAIT_OBJECT_0 != WaitForSingleObject( m_PreloadDecoderWakeEvent, 0 ) ) {
+			continue;
+		}
+
+		Playlist::ItemList window;
+		PreloadedDecoders evicted;
+		{
+			std::lock_guard<std::mutex> lock( m_PreloadedDecoderMutex );
+			window = m_PreloadWindow;
+			ResetEvent( m_PreloadDecoderWakeEvent );
+			UpdatePreloadedDecoders( evicted );
+		}
+		evicted.clear();
+
+		// Open decoders for the items in priority order, starting over if the window changes.
+		// Decoders are opened without holding the mutex, so that the playback thread is never blocked waiting for a decoder to open.
+		for ( auto item = window.begin(); ( window.end() != item ) && ( 0 == m_PreloadItemID ) && ( WAIT_TIMEOUT == WaitForMultipleObjects( 2, handles, FALSE /*waitAll*/, 0 ) ); item++ ) {
+			bool preloaded = false;
+			{
+				std::lock_guard<std::mutex> lock( m_PreloadedDecoderMutex );
+				preloaded = ( m_PreloadedDecoders.end() != FindPreloadedDecoder( *item ) );
+			}
+			if ( !preloaded && !IsURL( item->Info.GetFilename() ) ) {
+				Playlist::Item preloadItem = *item;
+				const Clock::time_point startTime = Clock::now();
+				const OutputDecoderPtr decoder = OpenOutputDecoder( preloadItem );
+				m_PreloadCounters.TotalPreloadTime += GetElapsedMicroseconds( startTime );
+				++m_PreloadCounters.Preloads;
+				if ( decoder ) {
+					{
+						std::lock_guard<std::mutex> lock( m_PreloadedDecoderMutex );
+						m_PreloadedDecoders.push_back( { std::make_shared<const Playlist::Item>( preloadItem ), decoder } );
+						UpdatePreloadedDecoders( evicted );
+					}
+					evicted.clear();
+				}
+			}
 		}
-		m_PreloadedDecoder.itemToPreload = {};
-		ResetEvent( m_PreloadDecoderWakeEvent );
 	}
 }
 
-void Output::PreloadNextDecoder( const Playlist::Item& item )
+void Output::RequestPreloadWindow( const long itemID )
 {
-	if ( m_Playlist ) {
-		Playlist::Item preloadItem;
+	m_PreloadItemID = itemID;
+}
+
+void Output::UpdatePreloadWindow( const long itemID )
+{
+	Playlist::Ptr playlist;
+	{
+		std::lock_guard<std::mutex> playlistLock( m_PlaylistMutex );
+		playlist = m_Playlist;
+	}
+	Playlist::Item item( { itemID, MediaInfo() } );
+	if ( playlist && playlist->GetItem( item ) ) {
+		Playlist::ItemList window;
 		if ( GetRandomPlay() ) {
-			preloadItem = m_Playlist->GetRandomItem( item );
+			// The previous & next items are both chosen from the upcoming random play items.
+			window = playlist->GetRandomCandidates( item, m_PreloadShuffleCandidates );
 		} else if ( GetRepeatTrack() ) {
-			preloadItem = item;
-		} else if ( !GetRandomPlay() ) {
-			m_Playlist->GetNextItem( item, preloadItem, GetRepeatPlaylist() /*wrap*/ );
+			window.push_back( item );
+		} else {
+			Playlist::Item nextItem = {};
+			playlist->GetNextItem( item, nextItem, GetRepeatPlaylist() /*wrap*/ );
+			if ( nextItem.ID > 0 ) {
+				window.push_back( nextItem );
+			}
+			Playlist::Item previousItem = {};
+			playlist->GetPreviousItem( item, previousItem );
+			if ( ( previousItem.ID > 0 ) && ( previousItem.ID != item.ID ) && ( previousItem.ID != nextItem.ID ) ) {
+				window.push_back( previousItem );
+			}
+
+			// Fill any remaining space in the window with the items following the next item.
+			while ( ( nextItem.ID > 0 ) && ( window.size() < m_PreloadWindowSize ) ) {
+				Playlist::Item followingItem = {};
+				playlist->GetNextItem( nextItem, followingItem, GetRepeatPlaylist() /*wrap*/ );
+				const bool inWindow = ( item.ID == followingItem.ID ) || ( window.end() != std::find_if( window.begin(), window.end(), [ id = followingItem.ID ] ( const Playlist::Item& windowItem ) { return id == windowItem.ID; } ) );
+				nextItem = inWindow ? Playlist::Item() : followingItem;
+				if ( nextItem.ID > 0 ) {
+					window.push_back( nextItem );
+				}
+			}
+		}
+		if ( window.size() > m_PreloadWindowSize ) {
+			window.resize( m_PreloadWindowSize );
 		}
 
 		std::lock_guard<std::mutex> lock( m_PreloadedDecoderMutex );
-		m_PreloadedDecoder.itemToPreload = preloadItem;
+		m_PreloadWindow = window;
 		SetEvent( m_PreloadDecoderWakeEvent );
 	}
 }
 
-std::vector<std::pair<float /*seconds*/,std::wstring /*title*/>> Output::GetStreamTitleQueue()
+void Output::UpdatePreloadSettings()
+{
+	long windowSize = 0;
+	long shuffleCandidates = 0;
+	long memoryLimit = 0;
+	m_Settings.GetPreloadSettings( windowSize, shuffleCandidates, memoryLimit );
+	m_PreloadWindowSize = static_cast<size_t>( windowSize );
+	m_PreloadShuffleCandidates = static_cast<size_t>( shuffleCandidates );
+	m_PreloadMemoryLimit = static_cast<size_t>( memoryLimit ) * 1024 * 1024;
+
+	bool decodeAhead = false;
+	long decodeAheadMemoryLimit = 0;
+	m_Settings.GetDecodeAheadSettings( decodeAhead, decodeAheadMemoryLimit );
+	m_DecodeAhead = decodeAhead;
+	m_DecodeAheadBudget->SetLimit( static_cast<size_t>( decodeAheadMemoryLimit ) * 1024 * 1024 );
+}
+
+void Output::ClearPreloadedDecoders()
+{
+	PreloadedDecoders released;
+	{
+		std::lock_guard<std::mutex> lock( m_PreloadedDecoderMutex );
+		m_PreloadItemID = 0;
+		m_PreloadWindow.clear();
+		released.swap( m_PreloadedDecoders );
+	}
+}
+
+Output::PreloadedDecoders::iterator Output::FindPreloadedDecoder( const Playlist::Item& item )
+{
+	return std::find_if( m_PreloadedDecoders.begin(), m_PreloadedDecoders.end(), [ &item ] ( const PreloadedDecoder& preloaded )
+		{
+			return ( preloaded.item->Info.GetFilename() == item.Info.GetFilename() ) && ( preloaded.item->Info.GetFiletime() == item.Info.GetFiletime() );
+		} );
+}
+
+void Output::UpdatePreloadedDecoders( PreloadedDecoders& evicted )
+{
+	for ( auto item = m_PreloadWindow.rbegin(); m_PreloadWindow.rend() != item; item++ ) {
+		if ( const auto preloaded = FindPreloadedDecoder( *item ); m_PreloadedDecoders.end() != preloaded ) {
+			m_PreloadedDecoders.splice( m_PreloadedDecoders.end(), m_PreloadedDecoders, preloaded );
+		}
+	}
+	while ( m_PreloadedDecoders.size() > m_PreloadWindowSize ) {
+		evicted.splice( evicted.end(), m_PreloadedDecoders, m_PreloadedDecoders.begin() );
+		++m_PreloadCounters.Evictions;
+	}
+}
+
+float Output::GetPreBufferSeconds( const OutputDecoder& decoder ) const
+{
+	float seconds = OutputDecoder::kDefaultPreBufferSeconds;
+	const long sampleRate = decoder.GetSampleRate();
+	const long channels = decoder.GetChannels();
+	if ( ( sampleRate > 0 ) && ( channels > 0 ) ) {
+		const double bytesPerSecond = static_cast<double>( sampleRate ) * channels * sizeof( float );
+		seconds = std::min<float>( seconds, static_cast<float>( static_cast<double>( m_PreloadMemoryLimit.load() ) / bytesPerSecond ) );
+	}
+	return seconds;
+}
+
+bool Output::UsePreBuffer( const Playlist::Item& item ) const
+{
+	// Streams are always read directly in standard output mode, unless decoding ahead.
+	return ( m_DecodeAhead || ( Settings::OutputMode::Standard != m_OutputMode ) ) && !IsURL( item.Info.GetFilename() );
+}
+
+void Output::StartPreBuffer( OutputDecoder& decoder )
+{
+	if ( m_DecodeAhead ) {
+		decoder.DecodeAhead( m_OnPreBufferFinishedCallback, m_DecodeAheadBudget );
+	} else {
+		decoder.PreBuffer( m_OnPreBufferFinishedCallback, GetPreBufferSeconds( decoder ) );
+	}
+}
+
+void Output::SetBufferedDecoder( const OutputDecoderPtr& decoder, const long id )
+{
+	std::lock_guard<std::mutex> lock( m_BufferedDecoderMutex );
+	m_BufferedDecoder = decoder;
+	m_BufferedDecoderID = id;
+}
+
+std::optional<std::pair<float, float>> Output::GetBufferedRange( const long id )
+{
+	OutputDecoderPtr decoder;
+	{
+		std::lock_guard<std::mutex> lock( m_BufferedDecoderMutex );
+		if ( id == m_BufferedDecoderID ) {
+			decoder = m_BufferedDecoder.lock();
+		}
+	}
+	if ( !decoder ) {
+		std::lock_guard<std::mutex> lock( m_PreloadedDecoderMutex );
+		const auto preloaded = std::find_if( m_PreloadedDecoders.begin(), m_PreloadedDecoders.end(), [ id ] ( const PreloadedDecoder& entry )
+			{
+				return id == entry.item->ID;
+			}
+		);
+		if ( m_PreloadedDecoders.end() != preloaded ) {
+			decoder = preloaded->decoder;
+		}
+	}
+	return decoder ? decoder->GetBufferedRange() : std::nullopt;
+}
+
+Output::PreloadMetrics Output::GetPreloadMetrics()
+{
+	PreloadMetrics metrics;
+	metrics.Hits = m_PreloadCounters.Hits.load();
+	metrics.Misses = m_PreloadCounters.Misses.load();
+	metrics.Evictions = m_PreloadCounters.Evictions.load();
+	{
+		std::lock_guard<std::mutex> lock( m_PreloadedDecoderMutex );
+		metrics.PreloadedCount = m_PreloadedDecoders.size();
+	}
+	if ( metrics.Misses > 0 ) {
+		metrics.AverageOpenTime = static_cast<double>( m_PreloadCounters.TotalOpenTime.load() ) / metrics.Misses / 1e6;
+	}
+	metrics.MaxOpenTime = static_cast<double>( m_PreloadCounters.MaxOpenTime.load() ) / 1e6;
+	if ( const uint64_t preloads = m_PreloadCounters.Preloads.load(); preloads > 0 ) {
+		metrics.AveragePreloadTime = static_cast<double>( m_PreloadCounters.TotalPreloadTime.load() ) / preloads / 1e6;
+	}
+	return metrics;
+}
+
+Output::AudioPathMetrics Output::GetAudioPathMetrics() const
+{
+	AudioPathMetrics metrics;
+	metrics.Callbacks = m_AudioPathCounters.Callbacks.load();
+	metrics.BytesRequested = m_AudioPathCounters.BytesRequested.load();
+	metrics.BytesDelivered = m_AudioPathCounters.BytesDelivered.load();
+	metrics.Underruns = m_AudioPathCounters.Underruns.load();
+	metrics.DecoderUnderruns = m_AudioPathCounters.DecoderUnderruns.load();
+	metrics.StreamProcTime = m_AudioPathCounters.StreamProcTime.GetSnapshot();
+	metrics.WasapiProcTime = m_AudioPathCounters.WasapiProcTime.GetSnapshot();
+	metrics.ReadSampleDataTime = m_AudioPathCounters.ReadSampleDataTime.GetSnapshot();
+	metrics.DecoderReadTime = m_AudioPathCounters.DecoderReadTime.GetSnapshot();
+	metrics.DecoderOpenTime = m_AudioPathCounters.DecoderOpenTime.GetSnapshot();
+	metrics.DecoderSeekTime = m_AudioPathCounters.DecoderSeekTime.GetSnapshot();
+	return metrics;
+}
+
+void Output::ResetAudioPathMetrics()
+{
+	m_AudioPathCounters.Callbacks = 0;
+	m_AudioPathCounters.BytesRequested = 0;
+	m_AudioPathCounters.BytesDelivered = 0;
+	m_AudioPathCounters.Underruns = 0;
+	m_AudioPathCounters.DecoderUnderruns = 0;
+	m_AudioPathCounters.StreamProcTime.Reset();
+	m_AudioPathCounters.WasapiProcTime.Reset();
+	m_AudioPathCounters.ReadSampleDataTime.Reset();
+	m_AudioPathCounters.DecoderReadTime.Reset();
+	m_AudioPathCounters.DecoderOpenTime.Reset();
+	m_AudioPathCounters.DecoderSeekTime.Reset();
+}
+
+bool Output::SaveAudioPathMetrics( const std::wstring& filename ) const
+{
+	using namespace nlohmann;
+
+	const auto toJSON = [] ( const LatencyHistogram::Snapshot& snapshot ) -> json
+	{
+		json histogram;
+		histogram[ "count" ] = snapshot.Count;
+		histogram[ "mean_us" ] = snapshot.GetMean();
+		histogram[ "p50_us" ] = snapshot.GetPercentile( 50 );
+		histogram[ "p99_us" ] = snapshot.GetPercentile( 99 );
+		histogram[ "max_us" ] = snapshot.Max;
+		json buckets = json::array();
+		for ( size_t index = 0; index < snapshot.Buckets.size(); index++ ) {
+			if ( snapshot.Buckets[ index ] > 0 ) {
+				json bucket;
+				bucket[ "limit_us" ] = LatencyHistogram::GetBucketLimit( index );
+				bucket[ "count" ] = snapshot.Buckets[ index ];
+				buckets.push_back( bucket );
+			}
+		}
+		histogram[ "buckets" ] = buckets;
+		return histogram;
+	};
+
+	const AudioPathMetrics metrics = GetAudioPathMetrics();
+	json document;
+	switch ( m_OutputMode ) {
+		case Settings::OutputMode::Standard : {
+			document[ "output_mode" ] = "standard";
+			break;
+		}
+		case Settings::OutputMode::WASAPIExclusive : {
+			document[ "output_mode" ] = "wasapi";
+			break;
+		}
+		case Settings::OutputMode::ASIO : {
+			document[ "output_mode" ] = "asio";
+			break;
+		}
+	}
+	document[ "callbacks" ] = metrics.Callbacks;
+	document[ "bytes_requested" ] = metrics.BytesRequested;
+	document[ "bytes_delivered" ] = metrics.BytesDelivered;
+	document[ "underruns" ] = metrics.Underruns;
+	document[ "decoder_underruns" ] = metrics.DecoderUnderruns;
+	document[ "stream_proc_time" ] = toJSON( metrics.StreamProcTime );
+	document[ "wasapi_proc_time" ] = toJSON( metrics.WasapiProcTime );
+	document[ "read_sample_data_time" ] = toJSON( metrics.ReadSampleDataTime );
+	document[ "decoder_read_time" ] = toJSON( metrics.DecoderReadTime );
+	document[ "decoder_open_time" ] = toJSON( metrics.DecoderOpenTime );
+	document[ "decoder_seek_time" ] = toJSON( metrics.DecoderSeekTime );
+
+	std::ofstream stream( filename, std::ios::out | std::ios::trunc );
+	if ( stream.is_open() ) {
+		stream << document.dump( 2 ) << std::endl;
+	}
+	return stream.good();
+}
+
+long Output::ReadDecoder( OutputDecoder& decoder, float* buffer, const long sampleCount )
+{
+	const long long underruns = decoder.GetUnderrunCount();
+	const Clock::time_point startTime = Clock::now();
+	const long samplesRead = decoder.Read( buffer, sampleCount );
+	m_AudioPathCounters.DecoderReadTime.Record( GetElapsedMicroseconds( startTime ) );
+	if ( const long long newUnderruns = decoder.GetUnderrunCount() - underruns; newUnderruns > 0 ) {
+		m_AudioPathCounters.DecoderUnderruns += static_cast<uint64_t>( newUnderruns );
+	}
+	return samplesRead;
+}
+
+float Output::SeekDecoder( OutputDecoder& decoder, const float position )
+{
+	const Clock::time_point startTime = Clock::now();
+	const float seekPosition = decoder.Seek( position );
+	m_AudioPathCounters.DecoderSeekTime.Record( GetElapsedMicroseconds( startTime ) );
+	return seekPosition;
+}
+
+void Output::RecordCallback( LatencyHistogram& histogram, const Clock::time_point startTime, const DWORD bytesRequested, const DWORD bytesDelivered, const bool underrun )
+{
+	histogram.Record( GetElapsedMicroseconds( startTime ) );
+	m_AudioPathCounters.Callbacks.fetch_add( 1, std::memory_order_relaxed );
+	m_AudioPathCounters.BytesRequested.fetch_add( bytesRequested, std::memory_order_relaxed );
+	m_AudioPathCounters.BytesDelivered.fetch_add( bytesDelivered, std::memory_order_relaxed );
+	if ( underrun ) {
+		m_AudioPathCounters.Underruns.fetch_add( 1, std::memory_order_relaxed );
+	}
+}
+
+uint64_t Output::GetElapsedMicroseconds( const Clock::time_point startTime )
+{
+	return static_cast<uint64_t>( std::chrono::duration_cast<std::chrono::microseconds>( Clock::now() - startTime ).count() );
+}
+
+SharedSnapshot<Output::StreamTitleQueue>::Ptr Output::GetStreamTitleQueue() const
 {
-	std::lock_guard<std::mutex> lock( m_StreamTitleMutex );
-	return m_StreamTitleQueue;
+	return m_StreamTitleQueue.Get();
 }
 
-void Output::SetStreamTitleQueue( const std::vector<std::pair<float /*seconds*/,std::wstring /*title*/>>& queue )
+void Output::UpdateStreamTitleQueue( const float seconds )
 {
-	std::lock_guard<std::mutex> lock( m_StreamTitleMutex );
-	m_StreamTitleQueue = queue;
+	OutputDecoderPtr decoder;
+	{
+		std::lock_guard<std::mutex> lock( m_BufferedDecoderMutex );
+		decoder = m_BufferedDecoder.lock();
+	}
+	if ( decoder && decoder->SupportsStreamTitles() ) {
+		const auto streamTitle = decoder->GetStreamTitle();
+		if ( const auto streamTitleQueue = GetStreamTitleQueue(); streamTitleQueue->empty() || ( streamTitle.first != streamTitleQueue->back().first ) ) {
+			m_StreamTitleQueue.Update( [ &streamTitle, seconds ] ( StreamTitleQueue& queue )
+				{
+					if ( queue.empty() || ( streamTitle.first != queue.back().first ) ) {
+						// Titles before the one which is current at the output position are no longer needed.
+						auto current = queue.begin();
+						for ( auto iter = queue.begin(); ( queue.end() != iter ) && ( iter->first <= seconds ); iter++ ) {
+							current = iter;
+						}
+						queue.erase( queue.begin(), current );
+						queue.push_back( streamTitle );
+					}
+				}
+			);
+		}
+	}
 }
 
 void Output::SetPlaylistChangeCallback( PlaylistChangeCallback callback )
@@ -3,13 +3,24 @@
 #include "stdafx.h"
 
 #include "bass.h"
+#include "Equaliser.h"
 #include "Handlers.h"
+#include "LatencyHistogram.h"
+#include "Limiter.h"
 #include "OutputDecoder.h"
 #include "Playlist.h"
+#include "Resampler.h"
+#include "SeekIndexer.h"
+#include "SeqLock.h"
 #include "Settings.h"
+#include "SharedSnapshot.h"
 
+#include <array>
 #include <atomic>
+#include <chrono>
 #include <functional>
+#include <list>
+#include <memory>
 
 // Message ID for signalling that playback needs to be restarted from a playlist item ID (wParam).
 static const UINT MSG_RESTARTPLAYBACK = WM_APP + 191;
@@ -22,7 +33,8 @@ public:
 	// 'hwnd' - main window handle.
 	// 'handlers' - the available handlers.
 	// 'settings' - application settings.
-	Output( const HINSTANCE instance, const HWND hwnd, const Handlers& handlers, Settings& settings );
+	// 'seekIndexer' - seek index generator.
+	Output( const HINSTANCE instance, const HWND hwnd, const Handlers& handlers, Settings& settings, SeekIndexer& seekIndexer );
 
 	virtual ~Output();
 
@@ -39,8 +51,28 @@ public:
 		float Position;								// Position in seconds.
 		float InitialSeek;						// Initial seek time for the item.
 		std::wstring StreamTitle;			// Current stream title.
+		long long StartFrame;					// Position of the start of the item in the decoded output timeline, in sample frames.
 	};
 
+	// Shared, immutable playlist item.
+	using PlaylistItemPtr = std::shared_ptr<const Playlist::Item>;
+
+	// Output queue item.
+	// The playlist item is shared, so that publishing the queue from the audio thread does not copy or allocate playlist items.
+	struct QueueItem {
+		PlaylistItemPtr PlaylistItem;	// Playlist item.
+		float InitialSeek;						// Initial seek time for the item.
+		long long StartFrame;					// Position of the start of the item in the decoded output timeline, in sample frames.
+	};
+
+	// Output queue, in the order in which items were decoded.
+	using Queue = std::vector<QueueItem>;
+
+	// Returns the item in the output 'queue' which is playing at a 'frame' position in the decoded output timeline, with the item position filled in.
+	// 'sampleRate' - sample rate of the decoded output timeline.
+	// Returns an empty item if no item is playing at the frame position.
+	static Item GetQueueItem( const Queue& queue, const long long frame, const long sampleRate );
+
 	// Maps a device ID to its description.
 	using Devices = std::map<int,std::wstring>;
 
@@ -81,6 +113,49 @@ public:
 	// Returns the currently playing item.
 	Item GetCurrentPlaying();
 
+	// Decoder preload metrics.
+	struct PreloadMetrics {
+		uint64_t Hits = 0;								// Number of times a preloaded decoder was used for playback.
+		uint64_t Misses = 0;							// Number of times a decoder had to be opened for playback, as it had not been preloaded.
+		uint64_t Evictions = 0;						// Number of preloaded decoders evicted from the prefetch window.
+		size_t PreloadedCount = 0;				// Number of decoders currently preloaded.
+		double AverageOpenTime = 0;				// Average time taken to open a decoder for playback (on a miss), in seconds.
+		double MaxOpenTime = 0;						// Maximum time taken to open a decoder for playback (on a miss), in seconds.
+		double AveragePreloadTime = 0;		// Average time taken to open a decoder in the background, in seconds.
+	};
+
+	// Returns the decoder preload metrics.
+	PreloadMetrics GetPreloadMetrics();
+
+	// Returns the range of the playlist item 'id' which is buffered in memory by decode-ahead, as start & end positions in seconds.
+	// Returns nullopt if decode-ahead is not in use for the item.
+	std::optional<std::pair<float, float>> GetBufferedRange( const long id );
+
+	// Audio path metrics, for diagnosing dropouts.
+	struct AudioPathMetrics {
+		uint64_t Callbacks = 0;													// Number of output device callbacks.
+		uint64_t BytesRequested = 0;										// Total number of bytes requested by output callbacks.
+		uint64_t BytesDelivered = 0;										// Total number of bytes delivered by output callbacks.
+		uint64_t Underruns = 0;													// Number of output callbacks which delivered fewer bytes than requested (other than at the end of playback).
+		uint64_t DecoderUnderruns = 0;									// Number of decoder reads which could not be fully satisfied from the pre-buffer.
+		LatencyHistogram::Snapshot StreamProcTime;			// Time spent in the stream callback.
+		LatencyHistogram::Snapshot WasapiProcTime;			// Time spent in the WASAPI callback.
+		LatencyHistogram::Snapshot ReadSampleDataTime;	// Time spent reading & processing sample data.
+		LatencyHistogram::Snapshot DecoderReadTime;			// Time spent blocked reading from decoders.
+		LatencyHistogram::Snapshot DecoderOpenTime;			// Time taken to open decoders.
+		LatencyHistogram::Snapshot DecoderSeekTime;			// Time taken to seek decoders.
+	};
+
+	// Returns the audio path metrics.
+	AudioPathMetrics GetAudioPathMetrics() const;
+
+	// Resets the audio path metrics.
+	void ResetAudioPathMetrics();
+
+	// Writes the audio path metrics to 'filename', as JSON.
+	// Returns whether the file was written.
+	bool SaveAudioPathMetrics( const std::wstring& filename ) const;
+
 	// Returns the volume level in the range 0.0 (silent) to 1.0 (full volume).
 	float GetVolume() const;
 
@@ -196,25 +271,72 @@ public:
 	void SetPlaylistChangeCallback( PlaylistChangeCallback callback );
 
 private:
-	// Output queue.
-	using Queue = std::vector<Item>;
+	// Allows the gapless test to drive the output decoding path directly.
+	friend class GaplessTest;
 
 	// Maps a playlist item ID to a gain estimate.
 	using GainEstimateMap = std::map<long, std::optional<float>>;
 
-	// A list of FX.
-	using FXList = std::list<HFX>;
-
 	// Buffered output decoder shared pointer.
 	using OutputDecoderPtr =  std::shared_ptr<OutputDecoder>;
 
+	// Stream titles, associated with their start times.
+	using StreamTitleQueue = std::vector<std::pair<float /*seconds*/,std::wstring /*title*/>>;
+
 	// Preloaded decoder information.
 	struct PreloadedDecoder {
-		Playlist::Item		itemToPreload = {};			// Item to preload.
-		Playlist::Item		item = {};								// Preloaded item.
+		PlaylistItemPtr		item = {};								// Preloaded item.
 		OutputDecoderPtr	decoder = {};						// Preloaded decoder.
 	};
 
+	// Preloaded decoders, in least to most recently used order.
+	using PreloadedDecoders = std::list<PreloadedDecoder>;
+
+	// Clock used for decoder open time measurements.
+	using Clock = std::chrono::steady_clock;
+
+	// Silence which has been output due to decoder underruns, so that output positions can be mapped back to the decoded output timeline.
+	struct UnderrunPadding {
+		// A run of silence, starting at an output frame position (which includes any previous runs of silence).
+		struct Run {
+			long long OutputFrame = 0;
+			long long Frames = 0;
+		};
+
+		// Maximum number of runs of silence to retain (older runs are folded into the total).
+		static constexpr size_t kMaxRuns = 32;
+
+		std::array<Run, kMaxRuns> Runs = {};	// Most recent runs of silence, as a circular buffer.
+		size_t Count = 0;											// Total number of runs of silence.
+		long long TotalFrames = 0;						// Total number of frames of silence.
+	};
+
+	// Decoder preload counters.
+	struct PreloadCounters {
+		std::atomic<uint64_t> Hits = 0;
+		std::atomic<uint64_t> Misses = 0;
+		std::atomic<uint64_t> Evictions = 0;
+		std::atomic<uint64_t> TotalOpenTime = 0;		// In microseconds.
+		std::atomic<uint64_t> MaxOpenTime = 0;			// In microseconds.
+		std::atomic<uint64_t> Preloads = 0;
+		std::atomic<uint64_t> TotalPreloadTime = 0;	// In microseconds.
+	};
+
+	// Audio path counters & histograms.
+	struct AudioPathCounters {
+		std::atomic<uint64_t> Callbacks = 0;
+		std::atomic<uint64_t> BytesRequested = 0;
+		std::atomic<uint64_t> BytesDelivered = 0;
+		std::atomic<uint64_t> Underruns = 0;
+		std::atomic<uint64_t> DecoderUnderruns = 0;
+		LatencyHistogram StreamProcTime;
+		LatencyHistogram WasapiProcTime;
+		LatencyHistogram ReadSampleDataTime;
+		LatencyHistogram DecoderReadTime;
+		LatencyHistogram DecoderOpenTime;
+		LatencyHistogram DecoderSeekTime;
+	};
+
 	// BASS stream callback.
 	static DWORD CALLBACK StreamProc( HSTREAM handle, void *buf, DWORD len, void *user );
 
@@ -255,6 +377,13 @@ private:
 	// Returns the number of bytes read.
 	DWORD ReadSampleData( float* buffer, const DWORD byteCount, HSTREAM handle );
 
+	// Reads output sample data, via the resampler when one is in use.
+	// 'buffer' - output buffer.
+	// 'byteCount' - number of bytes to read.
+	// 'handle' - stream handle.
+	// Returns the number of bytes read.
+	DWORD ReadOutputData( float* buffer, const DWORD byteCount, HSTREAM handle );
+
 	// Called when playback has ended.
 	void OnSyncEnd();
 
@@ -264,7 +393,7 @@ private:
 	// Background thread handler for precalculating loudness values for tracks in the current playlist.
 	void LoudnessPrecalcHandler();
 
-	// Background thread handler for preloading the next decoder.
+	// Background thread handler for preloading the decoders in the prefetch window.
 	void PreloadDecoderHandler();
 
 	// Initialises the BASS system;
@@ -273,6 +402,9 @@ private:
 	// Estimates the gain for a playlist 'item' if necessary.
 	void EstimateGain( Playlist::Item& item );
 
+	// Skips any leading silence on the 'decoder' for a playlist 'item', using the library analysis if available.
+	void SkipSilence( const Playlist::Item& item, OutputDecoder& decoder );
+
 	// Calculates the crossfade point for the 'item'.
 	// 'seekOffset' - indicates the initial seek position of 'item', in seconds.
 	void CalculateCrossfadePoint( const Playlist::Item& item, const float seekOffset = 0.0f );
@@ -286,21 +418,20 @@ private:
 	// Sets the crossfade 'position' for the current track, in seconds.
 	void SetCrossfadePosition( const float position );
 
-	// Applies gain (and EQ preamp) to an output 'buffer' containing 'sampleCount' samples, using 'item' information and 'softClipState'.
-	void ApplyGain( float* buffer, const long sampleCount, const Playlist::Item& item, std::vector<float>& softClipState );
-
-	// Gets the output queue.
-	Queue GetOutputQueue();
+	// Applies gain (and EQ preamp) to an output 'buffer' containing 'sampleCount' samples, using 'item' information, 'softClipState' and 'limiter'.
+	// 'rampStart' & 'rampStep' - fade ramp to apply in the same pass (see SampleProcessing.h).
+	void ApplyGain( float* buffer, const long sampleCount, const Playlist::Item& item, std::vector<float>& softClipState, Limiter& limiter, const float rampStart = 1.0f, const float rampStep = 0 );
 
-	// Sets the output 'queue'.
-	void SetOutputQueue( const Queue& queue );
+	// Gets the current output queue snapshot.
+	SharedSnapshot<Queue>::Ptr GetOutputQueue() const;
 
 	// Returns a decoder for the 'item' (and updates the item if necessary), or nullptr if a decoder could not be opened.
 	Decoder::Ptr OpenDecoder( Playlist::Item& item );
 
 	// Returns an output decoder for the 'item'.
 	// 'usePreloadedDecoder' - whether to use the preloaded decoder (when available).
-	OutputDecoderPtr OpenOutputDecoder( Playlist::Item& item, const bool usePreloadedDecoder = false );
+	// 'preloadedItem' - out, the item as it was preloaded, if the preloaded decoder was used (optional).
+	OutputDecoderPtr OpenOutputDecoder( Playlist::Item& item, const bool usePreloadedDecoder = false, PlaylistItemPtr* preloadedItem = nullptr );
 
 	// Starts the output and returns the output state.
 	State StartOutput();
@@ -311,6 +442,26 @@ private:
 	// Gets the current output position, in seconds.
 	float GetOutputPosition() const;
 
+	// Gets the current output position in the decoded output timeline, in sample frames.
+	long long GetOutputFrame() const;
+
+	// Records a number of 'frames' of silence which have been output, at the end of the decoded output timeline, due to a decoder underrun.
+	void AddUnderrunPadding( const long frames );
+
+	// Returns the number of frames of silence which have been output due to decoder underruns, before an 'outputFrame' position.
+	long long GetUnderrunPaddingFrames( const long long outputFrame ) const;
+
+	// Waits (for a limited time) until the 'decoder' has pre-buffered enough data for playback to start.
+	void WaitForPreBuffer( const OutputDecoder& decoder ) const;
+
+	// Converts a 'bytePos' on the BASS output stream to a position in seconds, accounting for the resampler when one is in use.
+	float GetOutputStreamSeconds( const QWORD bytePos ) const;
+
+	// Creates the resampler, if enabled, for converting from the 'inputRate' to the 'outputRate'.
+	// 'channels' - number of channels.
+	// Returns the sample rate at which the BASS output stream should be created.
+	DWORD CreateResampler( const DWORD inputRate, const DWORD outputRate, const DWORD channels );
+
 	// Creates the BASS output stream (and mixer stream, if necessary) based on the 'mediaInfo' and the current output mode/device.
 	// Returns whether the stream(s) were created successfully.
 	bool CreateOutputStream( const MediaInfo& mediaInfo );
@@ -345,7 +496,8 @@ private:
 
 	// Returns the next decoder on from the 'item', or nullptr if a decoder could not be opened.
 	// Updates 'item' with the next playlist item on success, resets 'item' on failure.
-	OutputDecoderPtr GetNextDecoder( Playlist::Item& item );
+	// 'queueItem' - out, a shared copy of the next playlist item for the output queue, which is made when the decoder is preloaded (where possible).
+	OutputDecoderPtr GetNextDecoder( Playlist::Item& item, PlaylistItemPtr& queueItem );
 
 	// Starts the preload decoder thread.
 	void StartPreloadDecoderThread();
@@ -353,14 +505,71 @@ private:
 	// Stops the preload decoder thread.
 	void StopPreloadDecoderThread();
 
-	// Preloads the next decoder on from the current 'item'.
-	void PreloadNextDecoder( const Playlist::Item& item );
+	// Requests an update of the prefetch window around the current item with the 'itemID', which is made on the preload decoder thread.
+	// This does not block or allocate, so can be called from the playback thread.
+	void RequestPreloadWindow( const long itemID );
+
+	// Updates the prefetch window around the current item with the 'itemID' (the next & previous items, or the upcoming random play items), and wakes the preload decoder thread.
+	// Only called on the preload decoder thread.
+	void UpdatePreloadWindow( const long itemID );
 
-	// Gets the stream title queue.
-	std::vector<std::pair<float /*seconds*/,std::wstring /*title*/>> GetStreamTitleQueue();
+	// Updates the decoder preload settings.
+	void UpdatePreloadSettings();
 
-	// Sets the stream title 'queue'.
-	void SetStreamTitleQueue( const std::vector<std::pair<float /*seconds*/,std::wstring /*title*/>>& queue );
+	// Releases all preloaded decoders, and clears the prefetch window.
+	void ClearPreloadedDecoders();
+
+	// Returns the preloaded decoder for the 'item', or the end of the preloaded decoders if the item has not been preloaded.
+	// The preloaded decoder mutex must be held by the caller.
+	PreloadedDecoders::iterator FindPreloadedDecoder( const Playlist::Item& item );
+
+	// Marks the preloaded decoders for items in the prefetch window as the most recently used (in priority order), then evicts the least recently used decoders which do not fit in the window.
+	// 'evicted' - out, the evicted decoders, which should be released by the caller after releasing the mutex (as a decoder which is pre-buffering might be waiting on the mutex).
+	// The preloaded decoder mutex must be held by the caller.
+	void UpdatePreloadedDecoders( PreloadedDecoders& evicted );
+
+	// Returns the pre-buffer length to use for a 'decoder', in seconds, so that the per decoder memory limit is not exceeded.
+	float GetPreBufferSeconds( const OutputDecoder& decoder ) const;
+
+	// Returns whether the 'item' should be pre-buffered (or decoded ahead).
+	bool UsePreBuffer( const Playlist::Item& item ) const;
+
+	// Starts pre-buffering a 'decoder', or decoding the whole stream ahead into memory when decode-ahead is enabled.
+	void StartPreBuffer( OutputDecoder& decoder );
+
+	// Sets the current 'decoder' for the playlist item 'id', whose buffered range can be queried from other threads.
+	void SetBufferedDecoder( const OutputDecoderPtr& decoder, const long id );
+
+	// Stops playback, without releasing any preloaded decoders.
+	void StopOutput();
+
+	// Reads sample data from a 'decoder', recording the time spent blocked & any pre-buffer underruns in the audio path metrics.
+	// 'buffer' - output buffer.
+	// 'sampleCount' - number of samples to read.
+	// Returns the number of samples read.
+	long ReadDecoder( OutputDecoder& decoder, float* buffer, const long sampleCount );
+
+	// Seeks a 'decoder' to a 'position', in seconds, recording the seek time in the audio path metrics.
+	// Returns the new position in seconds.
+	float SeekDecoder( OutputDecoder& decoder, const float position );
+
+	// Records an output callback in the audio path metrics.
+	// 'histogram' - histogram in which to record the callback time.
+	// 'startTime' - callback start time.
+	// 'bytesRequested' - number of bytes requested by the callback.
+	// 'bytesDelivered' - number of bytes delivered by the callback.
+	// 'underrun' - whether the callback delivered fewer bytes than were needed.
+	void RecordCallback( LatencyHistogram& histogram, const Clock::time_point startTime, const DWORD bytesRequested, const DWORD bytesDelivered, const bool underrun );
+
+	// Returns the time elapsed since 'startTime', in microseconds.
+	static uint64_t GetElapsedMicroseconds( const Clock::time_point startTime );
+
+	// Gets the current stream title queue snapshot.
+	SharedSnapshot<StreamTitleQueue>::Ptr GetStreamTitleQueue() const;
+
+	// Publishes any new stream title from the buffered decoder, removing titles which are no longer current at the output position in 'seconds'.
+	// This is called when querying the current playing item, rather than from the output callback, as publishing a title allocates.
+	void UpdateStreamTitleQueue( const float seconds );
 
 	// Sets the synchronizer which is called when the current output 'stream' ends.
 	void SetEndSync( const HSTREAM stream );
@@ -377,6 +586,9 @@ private:
 	// Application settings.
 	Settings& m_Settings;
 
+	// Seek index generator.
+	SeekIndexer& m_SeekIndexer;
+
 	// The current playlist.
 	Playlist::Ptr m_Playlist;
 
@@ -386,6 +598,9 @@ private:
 	// The soft-clip state for the currently decoding item.
 	std::vector<float> m_SoftClipStateDecoding;
 
+	// The look-ahead limiter for the currently decoding item.
+	Limiter m_LimiterDecoding;
+
 	// The currently decoding stream.
 	OutputDecoderPtr m_DecoderStream;
 
@@ -401,9 +616,6 @@ private:
 	// Playlist mutex.
 	std::mutex m_PlaylistMutex;
 
-	// Output queue mutex.
-	std::mutex m_QueueMutex;
-
 	// Volume level in the range 0.0 (silent) to 1.0 (full volume).
 	float m_Volume;
 
@@ -414,7 +626,7 @@ private:
 	float m_Balance;
 
 	// The queue of output items, with their start times, in the output stream.
-	Queue m_OutputQueue;
+	SharedSnapshot<Queue> m_OutputQueue;
 
 	// Playlist item ID to restart playback from, if stream playback has ended.
 	long m_RestartItemID;
@@ -443,6 +655,12 @@ private:
 	// Gain preamp in dB.
 	float m_GainPreamp;
 
+	// Look-ahead limiter window, in milliseconds.
+	float m_LimiterLookAhead;
+
+	// Look-ahead limiter release time, in milliseconds.
+	float m_LimiterRelease;
+
 	// Indicates whether the 'stop at track end' setting should be reset when playback ends.
 	bool m_RetainStopAtTrackEnd;
 
@@ -464,8 +682,14 @@ private:
 	// Position in the output stream when fade out was started, in seconds.
 	float m_FadeOutStartPosition;
 
-	// Position of the last transition in the output stream, in seconds.
-	float m_LastTransitionPosition;
+	// Position of the last transition in the decoded output timeline, in sample frames.
+	long long m_LastTransitionFrame;
+
+	// Total number of sample frames decoded for output, which forms the decoded output timeline.
+	long long m_DecodedFrames;
+
+	// Silence which has been output due to decoder underruns (written only by the playback thread).
+	SeqLock<UnderrunPadding> m_UnderrunPadding;
 
 	// Crossfade position for the current track, in seconds.
 	float m_CrossfadePosition;
@@ -485,7 +709,7 @@ private:
 	// Event handle for terminating the loudness precalculation thread.
 	HANDLE m_LoudnessPrecalcStopEvent;
 
-	// The thread for preloading the next decoder.
+	// The thread for preloading the decoders in the prefetch window.
 	HANDLE m_PreloadDecoderThread;
 
 	// Event handle for terminating the preload decoder thread.
@@ -509,6 +733,15 @@ private:
 	// The soft-clip state for the currently crossfading item.
 	std::vector<float> m_SoftClipStateCrossfading;
 
+	// The look-ahead limiter for the currently crossfading item.
+	Limiter m_LimiterCrossfading;
+
+	// Sample buffer for the currently crossfading item.
+	std::vector<float> m_CrossfadingBuffer;
+
+	// The most recently applied gain in dB, paired with the corresponding scale factor.
+	std::pair<float, float> m_GainScale;
+
 	// Indicates an offset to subtract from the crossfade calculation, in seconds.
 	float m_CrossfadeSeekOffset;
 
@@ -518,8 +751,8 @@ private:
 	// Current EQ settings.
 	Settings::EQ m_CurrentEQ;
 
-	// EQ FX handles.
-	FXList m_FX;
+	// Equaliser, applied to the final output.
+	Equaliser m_Equaliser;
 
 	// Indicates whether EQ is enabled.
 	bool m_EQEnabled;
@@ -551,17 +784,53 @@ private:
 	// When starting playback in non-standard output mode, the lead-in length before passing through actual sample data.
 	float m_LeadInSeconds;
 
-	// A preloaded decoder, which can be used to minimize the delay when switching streams.
-	PreloadedDecoder m_PreloadedDecoder;
+	// Resampler used in non-standard output modes (when enabled), for sample rate conversion & pitch control.
+	std::unique_ptr<Resampler> m_Resampler;
+
+	// The prefetch window, as the items to preload in priority order.
+	Playlist::ItemList m_PreloadWindow;
 
-	// A mutex for the preloaded decoder.
+	// Preloaded decoders, which can be used to minimize the delay when switching streams.
+	PreloadedDecoders m_PreloadedDecoders;
+
+	// A mutex for the prefetch window & preloaded decoders.
 	std::mutex m_PreloadedDecoderMutex;
 
-	// The queue of stream titles, associated with their start times.
-	std::vector<std::pair<float /*seconds*/,std::wstring /*title*/>> m_StreamTitleQueue;
+	// Maximum number of preloaded decoders.
+	std::atomic<size_t> m_PreloadWindowSize;
+
+	// Number of upcoming items to preload when random play is enabled.
+	std::atomic<size_t> m_PreloadShuffleCandidates;
+
+	// Maximum pre-buffer memory per decoder (including decode-ahead memory for preloaded decoders), in bytes.
+	std::atomic<size_t> m_PreloadMemoryLimit;
 
-	// Stream title queue mutex.
-	std::mutex m_StreamTitleMutex;
+	// ID of the current item for which the prefetch window should be updated, or zero if there is no pending update.
+	std::atomic<long> m_PreloadItemID;
+
+	// Decoder preload counters.
+	PreloadCounters m_PreloadCounters;
+
+	// Indicates whether decode-ahead is enabled.
+	std::atomic_bool m_DecodeAhead;
+
+	// Memory budget shared by all decoders which are decoding ahead.
+	const OutputDecoder::DecodeAheadBudgetPtr m_DecodeAheadBudget;
+
+	// The current decoder, for querying the buffered range.
+	std::weak_ptr<OutputDecoder> m_BufferedDecoder;
+
+	// The playlist item ID of the current decoder.
+	long m_BufferedDecoderID;
+
+	// Current decoder & playlist item ID mutex.
+	std::mutex m_BufferedDecoderMutex;
+
+	// Audio path counters & histograms.
+	AudioPathCounters m_AudioPathCounters;
+
+	// The queue of stream titles, associated with their start times.
+	SharedSnapshot<StreamTitleQueue> m_StreamTitleQueue;
 
 	// Callback function for when the output playlist changes.
 	PlaylistChangeCallback m_OnPlaylistChangeCallback;
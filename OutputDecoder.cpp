@@ -1,15 +1,77 @@
 #include "OutputDecoder.h"
 
-// Pre-buffer read queue size.
-constexpr size_t kQueueSize = 5;
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 
-// The (maximum) number of seconds stored in each pre-buffer slot.
-constexpr float kSecondsPerSlot = 0.5f;
+// The (maximum) number of seconds decoded by the pre-buffering thread in each pass.
+constexpr float kSecondsPerChunk = 0.1f;
+
+// Minimum pre-buffer length, in seconds.
+constexpr float kMinPreBufferSeconds = 2 * kSecondsPerChunk;
+
+// The interval for which the pre-buffering thread sleeps when the pre-buffer is full.
+constexpr std::chrono::milliseconds kPreBufferFullInterval( 10 );
+
+// The (maximum) number of seconds in each decode-ahead block.
+constexpr float kSecondsPerBlock = 1.0f;
+
+// The number of seconds of played data to retain when discarding decode-ahead blocks, so that short backward seeks remain immediate.
+constexpr float kRetainPlayedSeconds = 10.0f;
+
+// The interval for which the decode-ahead thread sleeps when the memory ceiling has been reached.
+constexpr std::chrono::milliseconds kDecodeAheadFullInterval( 50 );
+
+// The interval at which to check whether the decode-ahead thread has serviced a seek request.
+constexpr std::chrono::milliseconds kSeekRequestInterval( 1 );
+
+// Indicates that there is no pending seek request.
+constexpr long long kNoSeekRequest = -1;
+
+// Number of decode-ahead block slots, in addition to those needed for the stream duration (which also allows for inaccurate durations).
+constexpr size_t kExtraBlockSlots = 64;
+
+// Number of bytes per decode-ahead sample.
+constexpr size_t kBytesPerSample = 3;
+
+// Maximum 24-bit integer sample value.
+constexpr float kInt24Max = 8388607.0f;
+
+OutputDecoder::DecodeAheadBudget::DecodeAheadBudget( const size_t limit ) :
+	m_Limit( limit ),
+	m_Used( 0 )
+{
+}
+
+void OutputDecoder::DecodeAheadBudget::SetLimit( const size_t limit )
+{
+	m_Limit = limit;
+}
+
+bool OutputDecoder::DecodeAheadBudget::Reserve( const size_t bytes, const bool force )
+{
+	size_t used = m_Used.load();
+	bool reserved = false;
+	while ( !reserved && ( force || ( ( used + bytes ) <= m_Limit.load() ) ) ) {
+		reserved = m_Used.compare_exchange_weak( used, used + bytes );
+	}
+	return reserved;
+}
+
+void OutputDecoder::DecodeAheadBudget::Release( const size_t bytes )
+{
+	m_Used -= bytes;
+}
+
+size_t OutputDecoder::DecodeAheadBudget::GetUsed() const
+{
+	return m_Used;
+}
 
 OutputDecoder::OutputDecoder( Decoder::Ptr decoder, const long id ) :
 	m_Decoder( decoder ),
-	m_ID( id ),
-	m_Channels( decoder ? decoder->GetChannels() : 0 )
+	m_Channels( decoder ? decoder->GetChannels() : 0 ),
+	m_ID( id )
 {
 	if ( m_Channels <= 0 ) {
 		throw std::runtime_error( "Unable to create output decoder" );
@@ -19,52 +81,92 @@ OutputDecoder::OutputDecoder( Decoder::Ptr decoder, const long id ) :
 OutputDecoder::~OutputDecoder()
 {
 	StopPreBufferThread();
-	if ( nullptr != m_SemaphoreInput ) {
-		CloseHandle( m_SemaphoreInput );
-	}
-	if ( nullptr != m_SemaphoreOutput ) {
-		CloseHandle( m_SemaphoreOutput );
-	}
+	ClearBlocks();
 }
 
 long OutputDecoder::Read( float* buffer, const long sampleCount )
 {
 	long samplesRead = 0;
-	if ( m_UsePreBuffer ) {
-		while ( ( samplesRead < sampleCount ) && !m_DecoderFinished ) {
-			const long readBufferSize = ( nullptr != m_ReadBuffer ) ? static_cast<long>( m_ReadBuffer->size() ) : 0;
-			if ( m_ReadBufferOffset < readBufferSize ) {
-				const long samplesToRead = std::min<long>( sampleCount - samplesRead, ( readBufferSize - m_ReadBufferOffset ) / m_Channels );
-				std::copy( m_ReadBuffer->data() + m_ReadBufferOffset, m_ReadBuffer->data() + m_ReadBufferOffset + samplesToRead * m_Channels, buffer + samplesRead * m_Channels );
-				m_ReadBufferOffset += samplesToRead * m_Channels;
-				samplesRead += samplesToRead;
+	if ( m_UsePreBuffer || m_UseDecodeAhead ) {
+		// Check whether decoding has finished before reading, as all sample data is buffered before the decoder finished flag is set.
+		const bool decoderFinished = m_DecoderFinished;
+		const bool primed = decoderFinished || m_PreBufferPrimed;
+		if ( primed ) {
+			if ( m_UsePreBuffer ) {
+				const size_t channels = static_cast<size_t>( m_Channels );
+				const size_t samplesAvailable = std::min<size_t>( static_cast<size_t>( sampleCount ) * channels, m_RingBuffer.GetReadAvailable() / channels * channels );
+				samplesRead = static_cast<long>( m_RingBuffer.Read( buffer, samplesAvailable ) / channels );
 			} else {
-				WaitForSingleObject( m_SemaphoreOutput, INFINITE );
-				std::lock_guard<std::mutex> lock( m_BufferMutex );
-				if ( m_ReadQueue.empty() ) {
-					m_DecoderFinished = true;
-				} else {
-					m_ReadBuffer = m_ReadQueue.front();
-					m_ReadBufferOffset = 0;
-					m_ReadQueue.pop();
-				}
-				ReleaseSemaphore( m_SemaphoreInput, 1, nullptr );
+				samplesRead = ReadBlocks( buffer, sampleCount );
 			}
 		}
-	} else {
-		samplesRead = m_Decoder->Read( buffer, sampleCount );
+		if ( samplesRead < sampleCount ) {
+			if ( decoderFinished ) {
+				m_Ended = true;
+			} else if ( primed ) {
+				// Pre-buffer underrun, return a short read rather than waiting for the decoder.
+				++m_UnderrunCount;
+				m_UnderrunSamples += sampleCount - samplesRead;
+			}
+		}
+	} else if ( std::unique_lock<std::mutex> lock( m_StartMutex, std::try_to_lock ); lock.owns_lock() ) {
+		// If pre-buffering is being started on another thread, return no data (the next read will be from the pre-buffer).
+		if ( !m_UsePreBuffer && !m_UseDecodeAhead ) {
+			samplesRead = m_Decoder->Read( buffer, sampleCount );
+			if ( samplesRead > 0 ) {
+				m_DecoderPosition += samplesRead;
+			}
+			m_Ended = ( samplesRead < sampleCount );
+		}
 	}
 	return samplesRead;
 }
 
+bool OutputDecoder::HasEnded() const
+{
+	return m_Ended;
+}
+
 float OutputDecoder::Seek( const float position )
 {
-	if ( m_UsePreBuffer ) {
-		StopPreBufferThread();
-	}
-	const float result = m_Decoder->Seek( position );
-	if ( m_UsePreBuffer ) {
-		StartPreBufferThread();
+	float result = position;
+	m_Ended = false;
+	if ( m_UseDecodeAhead ) {
+		// Seeks within the buffered range do not need to touch the decoder.
+		// Blocks which are retained for reading can be sought to immediately, otherwise the decode-ahead thread (which discards blocks) services the seek.
+		const long sampleRate = m_Decoder->GetSampleRate();
+		const long long frame = std::llround( static_cast<double>( position ) * sampleRate );
+		bool buffered = SeekBlocks( frame, m_RetainIndex.load( std::memory_order_relaxed ) );
+		if ( !buffered ) {
+			m_SeekBuffered = false;
+			m_SeekRequest.store( frame, std::memory_order_release );
+			while ( ( kNoSeekRequest != m_SeekRequest.load( std::memory_order_acquire ) ) && m_DecodeAheadRunning.load( std::memory_order_acquire ) ) {
+				std::this_thread::sleep_for( kSeekRequestInterval );
+			}
+			if ( kNoSeekRequest != m_SeekRequest.load( std::memory_order_acquire ) ) {
+				// The decode-ahead thread finished without servicing the request, so no other thread is accessing the blocks.
+				StopPreBufferThread();
+				m_SeekRequest = kNoSeekRequest;
+				buffered = SeekBlocks( frame, m_BlockHead.load( std::memory_order_relaxed ) );
+			} else {
+				buffered = m_SeekBuffered.load( std::memory_order_acquire );
+			}
+		}
+		if ( !buffered ) {
+			StopPreBufferThread();
+			ClearBlocks();
+			result = m_Decoder->Seek( position );
+			StartDecodeAheadThread( std::llround( static_cast<double>( result ) * sampleRate ) );
+		}
+	} else {
+		if ( m_UsePreBuffer ) {
+			StopPreBufferThread();
+		}
+		result = m_Decoder->Seek( position );
+		m_DecoderPosition = std::llround( static_cast<double>( result ) * m_Decoder->GetSampleRate() );
+		if ( m_UsePreBuffer ) {
+			StartPreBufferThread();
+		}
 	}
 	return result;
 }
@@ -89,16 +191,23 @@ std::optional<float> OutputDecoder::GetBitrate() const
 	return m_Decoder->GetBitrate();
 }
 
-void OutputDecoder::SkipSilence()
+float OutputDecoder::SkipSilence()
 {
-	if ( m_UsePreBuffer ) {
+	m_Ended = false;
+	if ( m_UsePreBuffer || m_UseDecodeAhead ) {
 		StopPreBufferThread();
+		ClearBlocks();
 		m_Decoder->Seek( 0 );
+		m_DecoderPosition = 0;
 	}
-	m_Decoder->SkipSilence();
+	const float seconds = m_Decoder->SkipSilence();
+	m_DecoderPosition += std::llround( static_cast<double>( seconds ) * m_Decoder->GetSampleRate() );
 	if ( m_UsePreBuffer ) {
 		StartPreBufferThread();
+	} else if ( m_UseDecodeAhead ) {
+		StartDecodeAheadThread( m_DecoderPosition );
 	}
+	return seconds;
 }
 
 bool OutputDecoder::SupportsStreamTitles() const
@@ -111,62 +220,131 @@ std::pair<float /*seconds*/, std::wstring /*title*/> OutputDecoder::GetStreamTit
 	return m_Decoder->GetStreamTitle();
 }
 
-void OutputDecoder::PreBuffer( PreBufferFinishedCallback callback )
+void OutputDecoder::PreBuffer( PreBufferFinishedCallback callback, const float bufferSeconds )
 {
-	if ( !m_UsePreBuffer ) {
-		m_SemaphoreOutput = CreateSemaphore( nullptr /*attributes*/, 0 /*initial*/, kQueueSize /*maximum*/, L"" );
-		m_SemaphoreInput = CreateSemaphore( nullptr /*attributes*/, kQueueSize /*initial*/, kQueueSize /*maximum*/, L"" );
-		m_UsePreBuffer = ( nullptr != m_SemaphoreOutput ) && ( nullptr != m_SemaphoreInput );
-		if ( m_UsePreBuffer ) {
+	std::lock_guard<std::mutex> lock( m_StartMutex );
+	if ( !m_UsePreBuffer && !m_UseDecodeAhead ) {
+		m_PreBufferSeconds = std::max<float>( bufferSeconds, kMinPreBufferSeconds );
+		const size_t capacity = static_cast<size_t>( m_Decoder->GetSampleRate() * m_PreBufferSeconds ) * m_Channels;
+		if ( capacity > 0 ) {
+			m_RingBuffer.Reset( capacity );
 			m_PreBufferFinishedCallback = callback;
 			StartPreBufferThread();
+			// Only switch reads over to the pre-buffer once it has been set up.
+			m_UsePreBuffer = true;
+		}
+	}
+}
+
+void OutputDecoder::DecodeAhead( PreBufferFinishedCallback callback, DecodeAheadBudgetPtr budget )
+{
+	std::lock_guard<std::mutex> lock( m_StartMutex );
+	if ( !m_UsePreBuffer && !m_UseDecodeAhead && budget && ( m_Decoder->GetSampleRate() > 0 ) ) {
+		const float duration = std::max<float>( 0, m_Decoder->GetDuration() );
+		m_Blocks.resize( static_cast<size_t>( duration / kSecondsPerBlock ) + kExtraBlockSlots );
+		m_Budget = budget;
+		m_PreBufferFinishedCallback = callback;
+		StartDecodeAheadThread( m_DecoderPosition );
+		// Only switch reads over to the decode-ahead blocks once decoding has been set up.
+		m_UseDecodeAhead = true;
+	}
+}
+
+void OutputDecoder::SetMemoryLimit( const size_t limit )
+{
+	m_MemoryLimit = limit;
+}
+
+std::optional<std::pair<float, float>> OutputDecoder::GetBufferedRange()
+{
+	std::optional<std::pair<float, float>> range;
+	if ( m_UseDecodeAhead ) {
+		const double sampleRate = static_cast<double>( m_Decoder->GetSampleRate() );
+		const long long startFrame = m_BufferedStartFrame;
+		const long long endFrame = m_BufferedEndFrame;
+		if ( endFrame > startFrame ) {
+			range = { static_cast<float>( static_cast<double>( startFrame ) / sampleRate ), static_cast<float>( static_cast<double>( endFrame ) / sampleRate ) };
+		}
+	}
+	return range;
+}
+
+float OutputDecoder::GetPreBufferedSeconds() const
+{
+	const long sampleRate = m_Decoder->GetSampleRate();
+	float seconds = ( m_UsePreBuffer && ( sampleRate > 0 ) ) ? ( static_cast<float>( m_RingBuffer.GetReadAvailable() / m_Channels ) / sampleRate ) : 0;
+	if ( m_UseDecodeAhead && ( sampleRate > 0 ) ) {
+		const long long endFrame = m_BufferedEndFrame;
+		if ( endFrame > m_BufferedStartFrame ) {
+			seconds = static_cast<float>( static_cast<double>( std::max<long long>( 0ll, endFrame - m_ReadFrame ) ) / sampleRate );
 		}
 	}
+	return seconds;
+}
+
+float OutputDecoder::GetPreBufferSeconds() const
+{
+	return m_UsePreBuffer ? m_PreBufferSeconds : 0;
+}
+
+bool OutputDecoder::IsPreBufferPrimed() const
+{
+	return ( !m_UsePreBuffer && !m_UseDecodeAhead ) || m_PreBufferPrimed;
+}
+
+long long OutputDecoder::GetUnderrunCount() const
+{
+	return m_UnderrunCount;
+}
+
+long long OutputDecoder::GetUnderrunSamples() const
+{
+	return m_UnderrunSamples;
 }
 
 void OutputDecoder::StartPreBufferThread()
 {
 	m_StopPreBuffering = false;
+	m_PreBufferPrimed = false;
 	m_DecoderFinished = false;
-	m_ReadQueue = {};
-	m_ReadBuffer = nullptr;
-	m_ReadBufferOffset = 0;
+	m_RingBuffer.Clear();
 
 	m_BufferThread = std::thread( [ this ] ()
 		{
-			// Create a 'circular' buffer containing a fixed number of write slots, which the read queue will point to.
-			// This buffer needs to be two slots wider than the read queue because:
-			// 1. When the writer wraps around, it will (re)acquire the initial read slot, before being held.
-			// 2. When the writer is then released, it will immediately acquire the next read slot, before being held.
-			constexpr size_t kSlotCount = 2 + kQueueSize;
-			m_BufferSlots.resize( kSlotCount );
-			size_t slotIndex = 0;
-
-			const long bufferSamples = static_cast<long>( m_Decoder->GetSampleRate() * kSecondsPerSlot );
-			bool finished = false;
-			while ( !finished ) {
-				auto& buffer = m_BufferSlots[ slotIndex ];
-				slotIndex = ( 1 + slotIndex ) % kSlotCount;
-
-				buffer.resize( bufferSamples * m_Channels );
-				const long samplesRead = m_Decoder->Read( buffer.data(), bufferSamples );
-				buffer.resize( samplesRead * m_Channels );
-
-				WaitForSingleObject( m_SemaphoreInput, INFINITE );
-				std::lock_guard<std::mutex> lock( m_BufferMutex );
-				if ( m_StopPreBuffering ) {
-					finished = true;
-					m_ReadQueue = {};
-				} else if ( buffer.empty() ) {
-					finished = true;
-					if ( m_PreBufferFinishedCallback ) {
-						m_PreBufferFinishedCallback( m_ID );
+			const long chunkSamples = std::max<long>( 1l, static_cast<long>( m_Decoder->GetSampleRate() * kSecondsPerChunk ) );
+			std::vector<float> chunk( chunkSamples * m_Channels );
+
+			while ( !m_StopPreBuffering ) {
+				const long samplesRead = m_Decoder->Read( chunk.data(), chunkSamples );
+				if ( samplesRead <= 0 ) {
+					break;
+				}
+
+				const size_t samplesToWrite = static_cast<size_t>( samplesRead ) * m_Channels;
+				size_t samplesWritten = 0;
+				while ( !m_StopPreBuffering ) {
+					samplesWritten += m_RingBuffer.Write( chunk.data() + samplesWritten, samplesToWrite - samplesWritten );
+					if ( samplesWritten < samplesToWrite ) {
+						m_PreBufferPrimed = true;
+						std::this_thread::sleep_for( kPreBufferFullInterval );
+					} else {
+						break;
 					}
-				} else {
-					m_ReadQueue.push( &buffer );
 				}
-				ReleaseSemaphore( m_SemaphoreOutput, 1, nullptr );
+
+				if ( !m_PreBufferPrimed && ( m_RingBuffer.GetReadAvailable() >= static_cast<size_t>( chunkSamples * m_Channels ) ) ) {
+					m_PreBufferPrimed = true;
+				}
 			}
+
+			if ( !m_StopPreBuffering ) {
+				m_DecoderFinished = true;
+				if ( m_PreBufferFinishedCallback ) {
+					m_PreBufferFinishedCallback( m_ID );
+				}
+			}
+
+			m_PreBufferPrimed = true;
 		}
 	);
 }
@@ -175,11 +353,224 @@ void OutputDecoder::StopPreBufferThread()
 {
 	if ( m_BufferThread.joinable() ) {
 		m_StopPreBuffering = true;
-		ReleaseSemaphore( m_SemaphoreInput, 1, nullptr );
 		m_BufferThread.join();
+	}
+}
 
-		while ( WAIT_OBJECT_0 == WaitForSingleObject( m_SemaphoreOutput, 0 ) ) {}
-		while ( WAIT_OBJECT_0 == WaitForSingleObject( m_SemaphoreInput, 0 ) ) {}
-		ReleaseSemaphore( m_SemaphoreInput, kQueueSize, nullptr );
+void OutputDecoder::StartDecodeAheadThread( const long long startFrame )
+{
+	m_StopPreBuffering = false;
+	m_PreBufferPrimed = false;
+	m_DecoderFinished = false;
+	m_ReadFrame = startFrame;
+	m_BufferedStartFrame = startFrame;
+	m_BufferedEndFrame = startFrame;
+	m_DecodeAheadRunning = true;
+
+	m_BufferThread = std::thread( [ this, startFrame ] ()
+		{
+			const long sampleRate = m_Decoder->GetSampleRate();
+			const long blockFrames = std::max<long>( 1l, static_cast<long>( sampleRate * kSecondsPerBlock ) );
+			const size_t blockBytes = static_cast<size_t>( blockFrames ) * m_Channels * kBytesPerSample;
+			const long long minimumAheadFrames = static_cast<long long>( sampleRate * kDefaultPreBufferSeconds );
+			std::vector<float> samples( static_cast<size_t>( blockFrames ) * m_Channels );
+			long long nextFrame = startFrame;
+			bool finished = false;
+
+			while ( !m_StopPreBuffering && !finished ) {
+				ServiceSeekRequest();
+
+				// Always allow a minimum amount of data ahead of the read position, so that playback can continue once the memory ceiling has been reached.
+				const long long readFrame = m_ReadFrame.load( std::memory_order_acquire );
+				const bool force = ( ( nextFrame - readFrame ) < minimumAheadFrames );
+				const auto canReserve = [ this, blockBytes, force ] ()
+				{
+					const size_t limit = m_MemoryLimit;
+					const bool slotAvailable = ( m_BlockTail.load( std::memory_order_relaxed ) - m_BlockHead.load( std::memory_order_relaxed ) ) < m_Blocks.size();
+					const bool withinLimit = force || ( 0 == limit ) || ( ( m_BlockBytes + blockBytes ) <= limit );
+					return slotAvailable && withinLimit && m_Budget->Reserve( blockBytes, force );
+				};
+				const bool reserved = canReserve() || ( DiscardPlayedBlocks( blockBytes ) && canReserve() );
+				if ( reserved ) {
+					const long framesRead = m_Decoder->Read( samples.data(), blockFrames );
+					if ( framesRead > 0 ) {
+						// The block is written to a free slot, and then published to the reading thread.
+						const size_t tail = m_BlockTail.load( std::memory_order_relaxed );
+						Block& block = m_Blocks[ tail % m_Blocks.size() ];
+						block = PackBlock( samples.data(), framesRead, nextFrame );
+						m_Budget->Release( blockBytes - block.Data.size() );
+						m_BlockBytes += block.Data.size();
+						nextFrame += framesRead;
+						m_BlockTail.store( tail + 1, std::memory_order_release );
+						m_BufferedEndFrame = nextFrame;
+						m_PreBufferPrimed = true;
+					} else {
+						m_Budget->Release( blockBytes );
+						finished = true;
+					}
+				} else {
+					m_PreBufferPrimed = true;
+					std::this_thread::sleep_for( kDecodeAheadFullInterval );
+				}
+			}
+
+			if ( finished && !m_StopPreBuffering ) {
+				m_DecoderFinished = true;
+				if ( m_PreBufferFinishedCallback ) {
+					m_PreBufferFinishedCallback( m_ID );
+				}
+			}
+
+			m_PreBufferPrimed = true;
+
+			// Any seek request made after this point is serviced by the reading thread.
+			ServiceSeekRequest();
+			m_DecodeAheadRunning.store( false, std::memory_order_release );
+		}
+	);
+}
+
+long OutputDecoder::ReadBlocks( float* buffer, const long sampleCount )
+{
+	long samplesRead = 0;
+	const size_t tail = m_BlockTail.load( std::memory_order_acquire );
+	long long readFrame = m_ReadFrame.load( std::memory_order_relaxed );
+	while ( ( samplesRead < sampleCount ) && ( m_ReadIndex < tail ) ) {
+		const Block& block = m_Blocks[ m_ReadIndex % m_Blocks.size() ];
+		const long long offset = readFrame - block.StartFrame;
+		if ( ( offset >= 0 ) && ( offset < block.Frames ) ) {
+			const long frames = static_cast<long>( std::min<long long>( sampleCount - samplesRead, block.Frames - offset ) );
+			UnpackBlock( block, static_cast<long>( offset ), frames, buffer + static_cast<size_t>( samplesRead ) * m_Channels );
+			samplesRead += frames;
+			readFrame += frames;
+		} else {
+			++m_ReadIndex;
+		}
+	}
+	m_ReadFrame.store( readFrame, std::memory_order_release );
+
+	// Allow blocks which were played a while ago to be discarded by the decode-ahead thread.
+	const long long retainFrames = static_cast<long long>( m_Decoder->GetSampleRate() * kRetainPlayedSeconds );
+	size_t retainIndex = m_RetainIndex.load( std::memory_order_relaxed );
+	while ( ( retainIndex < m_ReadIndex ) && ( ( m_Blocks[ retainIndex % m_Blocks.size() ].StartFrame + m_Blocks[ retainIndex % m_Blocks.size() ].Frames + retainFrames ) <= readFrame ) ) {
+		++retainIndex;
+	}
+	m_RetainIndex.store( retainIndex, std::memory_order_release );
+	return samplesRead;
+}
+
+bool OutputDecoder::SeekBlocks( const long long frame, const size_t firstIndex )
+{
+	bool buffered = false;
+	const size_t tail = m_BlockTail.load( std::memory_order_acquire );
+	if ( firstIndex < tail ) {
+		const Block& lastBlock = m_Blocks[ ( tail - 1 ) % m_Blocks.size() ];
+		if ( ( frame >= m_Blocks[ firstIndex % m_Blocks.size() ].StartFrame ) && ( frame <= ( lastBlock.StartFrame + lastBlock.Frames ) ) ) {
+			// Find the last block which starts at or before the frame (blocks are contiguous, but not necessarily the same length).
+			size_t first = firstIndex;
+			size_t last = tail - 1;
+			while ( first < last ) {
+				const size_t middle = first + ( last - first + 1 ) / 2;
+				if ( m_Blocks[ middle % m_Blocks.size() ].StartFrame <= frame ) {
+					first = middle;
+				} else {
+					last = middle - 1;
+				}
+			}
+			m_ReadIndex = first;
+			m_ReadFrame.store( frame, std::memory_order_release );
+			if ( first < m_RetainIndex.load( std::memory_order_relaxed ) ) {
+				m_RetainIndex.store( first, std::memory_order_release );
+			}
+			buffered = true;
+		}
+	}
+	return buffered;
+}
+
+void OutputDecoder::ServiceSeekRequest()
+{
+	if ( const long long frame = m_SeekRequest.load( std::memory_order_acquire ); kNoSeekRequest != frame ) {
+		m_SeekBuffered.store( SeekBlocks( frame, m_BlockHead.load( std::memory_order_relaxed ) ), std::memory_order_relaxed );
+		m_SeekRequest.store( kNoSeekRequest, std::memory_order_release );
+	}
+}
+
+bool OutputDecoder::DiscardPlayedBlocks( const size_t bytes )
+{
+	const size_t retainIndex = m_RetainIndex.load( std::memory_order_acquire );
+	size_t head = m_BlockHead.load( std::memory_order_relaxed );
+	size_t bytesReleased = 0;
+	while ( ( bytesReleased < bytes ) && ( head < retainIndex ) ) {
+		Block& block = m_Blocks[ head % m_Blocks.size() ];
+		bytesReleased += block.Data.size();
+		std::vector<uint8_t>().swap( block.Data );
+		++head;
+	}
+	if ( head != m_BlockHead.load( std::memory_order_relaxed ) ) {
+		m_BlockHead.store( head, std::memory_order_release );
+		m_BufferedStartFrame = ( head < m_BlockTail.load( std::memory_order_relaxed ) ) ? m_Blocks[ head % m_Blocks.size() ].StartFrame : m_BufferedEndFrame.load();
+	}
+	m_BlockBytes -= bytesReleased;
+	if ( m_Budget && ( bytesReleased > 0 ) ) {
+		m_Budget->Release( bytesReleased );
+	}
+	return ( bytesReleased > 0 );
+}
+
+void OutputDecoder::ClearBlocks()
+{
+	size_t bytesReleased = 0;
+	for ( auto& block : m_Blocks ) {
+		bytesReleased += block.Data.size();
+		block = Block();
+	}
+	m_BlockHead = 0;
+	m_BlockTail = 0;
+	m_RetainIndex = 0;
+	m_ReadIndex = 0;
+	m_BufferedStartFrame = 0;
+	m_BufferedEndFrame = 0;
+	m_BlockBytes -= bytesReleased;
+	if ( m_Budget && ( bytesReleased > 0 ) ) {
+		m_Budget->Release( bytesReleased );
+	}
+}
+
+OutputDecoder::Block OutputDecoder::PackBlock( const float* samples, const long frames, const long long startFrame ) const
+{
+	const size_t sampleCount = static_cast<size_t>( frames ) * m_Channels;
+
+	// Samples which exceed full scale are preserved by scaling the whole block.
+	float peak = 0;
+	for ( size_t index = 0; index < sampleCount; index++ ) {
+		peak = std::max<float>( peak, std::fabs( samples[ index ] ) );
+	}
+
+	Block block;
+	block.StartFrame = startFrame;
+	block.Frames = frames;
+	block.Scale = std::max<float>( 1.0f, peak );
+	block.Data.resize( sampleCount * kBytesPerSample );
+
+	const float scale = kInt24Max / block.Scale;
+	uint8_t* output = block.Data.data();
+	for ( size_t index = 0; index < sampleCount; index++, output += kBytesPerSample ) {
+		const int32_t value = static_cast<int32_t>( std::lround( std::clamp( samples[ index ] * scale, -kInt24Max, kInt24Max ) ) );
+		output[ 0 ] = static_cast<uint8_t>( value & 0xff );
+		output[ 1 ] = static_cast<uint8_t>( ( value >> 8 ) & 0xff );
+		output[ 2 ] = static_cast<uint8_t>( ( value >> 16 ) & 0xff );
+	}
+	return block;
+}
+
+void OutputDecoder::UnpackBlock( const Block& block, const long offset, const long frames, float* buffer ) const
+{
+	const float scale = block.Scale / kInt24Max;
+	const size_t sampleCount = static_cast<size_t>( frames ) * m_Channels;
+	const uint8_t* input = block.Data.data() + static_cast<size_t>( offset ) * m_Channels * kBytesPerSample;
+	for ( size_t index = 0; index < sampleCount; index++, input += kBytesPerSample ) {
+		const int32_t value = ( static_cast<int32_t>( input[ 0 ] ) | ( static_cast<int32_t>( input[ 1 ] ) << 8 ) | ( static_cast<int32_t>( input[ 2 ] ) << 16 ) ) ^ 0x800000;
+		buffer[ index ] = static_cast<float>( value - 0x800000 ) * scale;
 	}
 }
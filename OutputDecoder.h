@@ -4,12 +4,14 @@
 
 #include "Decoder.h"
 #include "Playlist.h"
+#include "RingBuffer.h"
 
-#include <array>
+#include <atomic>
 #include <functional>
+#include <memory>
 #include <mutex>
-#include <queue>
 #include <thread>
+#include <vector>
 
 // Buffered output decoder wrapper.
 class OutputDecoder
@@ -24,12 +26,50 @@ public:
 	// Callback function for when the output decoder has finished pre-buffering the playlist item ID.
 	using PreBufferFinishedCallback = std::function<void( const long /*ID*/ )>;
 
+	// Default pre-buffer length, in seconds.
+	static constexpr float kDefaultPreBufferSeconds = 2.5f;
+
+	// Memory budget for decode-ahead buffering, which can be shared between output decoders.
+	class DecodeAheadBudget
+	{
+	public:
+		// 'limit' - memory ceiling, in bytes.
+		DecodeAheadBudget( const size_t limit );
+
+		// Sets the memory ceiling, in bytes.
+		void SetLimit( const size_t limit );
+
+		// Reserves 'bytes' from the budget, returning whether the reservation was made.
+		// 'force' - whether to make the reservation even if the memory ceiling would be exceeded.
+		bool Reserve( const size_t bytes, const bool force );
+
+		// Releases 'bytes' back to the budget.
+		void Release( const size_t bytes );
+
+		// Returns the amount of memory in use, in bytes.
+		size_t GetUsed() const;
+
+	private:
+		// Memory ceiling, in bytes.
+		std::atomic<size_t> m_Limit;
+
+		// Memory in use, in bytes.
+		std::atomic<size_t> m_Used;
+	};
+
+	// Shared decode-ahead memory budget.
+	using DecodeAheadBudgetPtr = std::shared_ptr<DecodeAheadBudget>;
+
 	// Reads sample data.
 	// 'buffer' - output buffer (floating point format scaled to +/-1.0f).
 	// 'sampleCount' - number of samples to read.
-	// Returns the number of samples read, or zero if the stream has ended.
+	// Returns the number of samples read, which is less than requested at the end of the stream, or when pre-buffering if the pre-buffered data has run out.
+	// When pre-buffering, this call never blocks, and any shortfall in pre-buffered data is counted as an underrun (use HasEnded to tell an underrun from the end of the stream).
 	long Read( float* buffer, const long sampleCount );
 
+	// Returns whether a read has reached the end of the stream (a short read which is not at the end of the stream is a pre-buffer underrun).
+	bool HasEnded() const;
+
 	// Seeks to a 'position' in the stream, in seconds.
 	// Returns the new position in seconds.
 	float Seek( const float position );
@@ -46,8 +86,8 @@ public:
 	// Returns the bitrate in kbps (if relevant).
 	std::optional<float> GetBitrate() const;
 
-	// Skips any leading silence.
-	void SkipSilence();
+	// Skips any leading silence, returning the amount of silence skipped, in seconds.
+	float SkipSilence();
 
 	// Returns whether stream titles are supported.
 	bool SupportsStreamTitles() const;
@@ -57,15 +97,81 @@ public:
 
 	// Starts pre-buffering sample data - all subsequent reads will be pre-buffered.
 	// 'callback' - called when the output decoder has finished pre-buffering.
-	void PreBuffer( PreBufferFinishedCallback callback );
+	// 'bufferSeconds' - pre-buffer length, in seconds.
+	// Can be called from any thread, and does not wait for the pre-buffer to fill (reads return no data until the pre-buffer has been primed).
+	void PreBuffer( PreBufferFinishedCallback callback, const float bufferSeconds = kDefaultPreBufferSeconds );
+
+	// Starts decoding the whole stream ahead into memory - all subsequent reads are from the in-memory buffer, and seeks within the buffered range are immediate.
+	// 'callback' - called when the whole stream has been decoded.
+	// 'budget' - memory budget for the decoded sample data.
+	// Sample data is held as 24-bit integers with a scale factor per block, and blocks which have already been played are discarded when the memory ceiling is reached.
+	// Has no effect if the output decoder is already pre-buffering. Can be called from any thread, and does not wait for any data to be decoded.
+	void DecodeAhead( PreBufferFinishedCallback callback, DecodeAheadBudgetPtr budget );
+
+	// Sets a memory limit for the decode-ahead blocks held by this decoder, in bytes, in addition to the shared memory budget (zero for no limit).
+	// Can be called from any thread, and blocks which have already been decoded are not discarded if the limit is lowered.
+	void SetMemoryLimit( const size_t limit );
+
+	// Returns the range of the stream which is buffered in memory, as start & end positions in seconds, or nullopt if decode-ahead is not in use.
+	std::optional<std::pair<float, float>> GetBufferedRange();
+
+	// Returns the amount of pre-buffered sample data, in seconds.
+	float GetPreBufferedSeconds() const;
+
+	// Returns the pre-buffer length, in seconds (or zero if pre-buffering is not in use).
+	float GetPreBufferSeconds() const;
+
+	// Returns whether enough data has been pre-buffered (or decoded ahead) for reading to start, or true if the stream is being read directly.
+	bool IsPreBufferPrimed() const;
+
+	// Returns the number of reads which could not be fully satisfied from the pre-buffer.
+	long long GetUnderrunCount() const;
+
+	// Returns the total number of samples which could not be read due to pre-buffer underruns.
+	long long GetUnderrunSamples() const;
 
 private:
+	// A block of decoded sample data.
+	struct Block {
+		long long StartFrame = 0;		// Position of the block in the stream, in sample frames.
+		long Frames = 0;						// Number of sample frames in the block.
+		float Scale = 1.0f;					// Scale factor for converting samples back to floating point.
+		std::vector<uint8_t> Data;	// Sample data, as packed 24-bit integers.
+	};
+
 	// Starts the pre-buffering thread.
 	void StartPreBufferThread();
 
-	// Stops the pre-buffering thread.
+	// Stops the pre-buffering (or decode-ahead) thread.
 	void StopPreBufferThread();
 
+	// Starts the decode-ahead thread, from a 'startFrame' position in the stream.
+	void StartDecodeAheadThread( const long long startFrame );
+
+	// Reads up to 'sampleCount' samples from the decode-ahead blocks into the 'buffer', returning the number of samples read.
+	// Only called on the reading thread.
+	long ReadBlocks( float* buffer, const long sampleCount );
+
+	// Moves the read position to the 'frame', if it is within the decode-ahead blocks starting from the 'firstIndex' block, returning whether the frame is buffered.
+	// Called on the reading thread for blocks which are retained for reading, otherwise on the decode-ahead thread (while the reading thread waits for the seek request to be serviced).
+	bool SeekBlocks( const long long frame, const size_t firstIndex );
+
+	// Services any pending seek request, on the decode-ahead thread.
+	void ServiceSeekRequest();
+
+	// Discards blocks which have already been played (and which are no longer retained for reading), until at least 'bytes' have been released to the budget (if possible).
+	// Only called on the decode-ahead thread. Returns whether any blocks were discarded.
+	bool DiscardPlayedBlocks( const size_t bytes );
+
+	// Discards all decode-ahead blocks, which must only be called when the decode-ahead thread is not running.
+	void ClearBlocks();
+
+	// Returns a block containing a number of 'frames' from the 'samples', starting at a 'startFrame' position in the stream.
+	Block PackBlock( const float* samples, const long frames, const long long startFrame ) const;
+
+	// Converts a number of 'frames' from the 'block', starting at an 'offset' frame in the block, into the 'buffer'.
+	void UnpackBlock( const Block& block, const long offset, const long frames, float* buffer ) const;
+
 	// Decoder.
 	const Decoder::Ptr m_Decoder;
 
@@ -76,38 +182,88 @@ private:
 	const long m_ID;
 
 	// Indicates whether to use pre-buffering.
-	bool m_UsePreBuffer = false;
+	std::atomic_bool m_UsePreBuffer = false;
 
-	// Pre-buffer output semaphore.
-	HANDLE m_SemaphoreOutput = nullptr;
+	// Pre-buffer length, in seconds.
+	float m_PreBufferSeconds = 0;
 
-	// Pre-buffer input semaphore.
-	HANDLE m_SemaphoreInput = nullptr;
+	// Pre-buffered sample data.
+	RingBuffer m_RingBuffer;
 
 	// Pre-buffer thread.
 	std::thread m_BufferThread;
 
-	// Pre-buffer mutex.
-	std::mutex m_BufferMutex;
-
 	// Indicates whether the pre-buffering thread should stop.
 	std::atomic_bool m_StopPreBuffering = false;
 
+	// Indicates whether the pre-buffering thread has buffered enough data for reading to start.
+	std::atomic_bool m_PreBufferPrimed = false;
+
 	// Indicates whether decoding has finished.
-	bool m_DecoderFinished = false;
+	std::atomic_bool m_DecoderFinished = false;
 
 	// Callback function for when the output decoder has finished pre-buffering.
 	PreBufferFinishedCallback m_PreBufferFinishedCallback = nullptr;
 
-	// Pre-buffered sample data.
-	std::vector<std::vector<float>> m_BufferSlots;
+	// Number of reads which could not be fully satisfied from the pre-buffer.
+	std::atomic<long long> m_UnderrunCount = 0;
+
+	// Number of samples which could not be read due to pre-buffer underruns.
+	std::atomic<long long> m_UnderrunSamples = 0;
+
+	// Indicates whether a read has reached the end of the stream (only accessed by the reading thread).
+	bool m_Ended = false;
+
+	// Serialises starting pre-buffering (or decode-ahead) with reading directly from the decoder, as pre-buffering can be started from another thread.
+	std::mutex m_StartMutex;
+
+	// Position of the underlying decoder when reading directly, in sample frames.
+	long long m_DecoderPosition = 0;
+
+	// Indicates whether to use decode-ahead.
+	std::atomic_bool m_UseDecodeAhead = false;
+
+	// Decode-ahead memory budget.
+	DecodeAheadBudgetPtr m_Budget;
+
+	// Memory limit for the decode-ahead blocks held by this decoder, in bytes (zero for no limit).
+	std::atomic<size_t> m_MemoryLimit = 0;
+
+	// Memory held by the decode-ahead blocks, in bytes.
+	std::atomic<size_t> m_BlockBytes = 0;
+
+	// Decode-ahead block slots, used as a single producer (decode-ahead thread) & single consumer (reading thread) ring.
+	// The slots are allocated before the decode-ahead thread is started, and blocks are identified by an ever increasing index (the slot being the index modulo the number of slots).
+	std::vector<Block> m_Blocks;
+
+	// Index of the first block which has not been discarded (only written by the decode-ahead thread).
+	std::atomic<size_t> m_BlockHead = 0;
+
+	// Index following the last block which has been decoded (only written by the decode-ahead thread, which publishes each block by incrementing the index).
+	std::atomic<size_t> m_BlockTail = 0;
+
+	// Index of the first block which is retained for reading (written by the reading thread, or by the decode-ahead thread when servicing a seek request).
+	// The decode-ahead thread only discards blocks before this index, so the reading thread can read or seek within the following blocks without any locking.
+	std::atomic<size_t> m_RetainIndex = 0;
+
+	// Index of the block containing the read position (only accessed by the reading thread, or by the decode-ahead thread when servicing a seek request).
+	size_t m_ReadIndex = 0;
+
+	// Current decode-ahead read position, in sample frames.
+	std::atomic<long long> m_ReadFrame = 0;
+
+	// Start of the buffered range, in sample frames.
+	std::atomic<long long> m_BufferedStartFrame = 0;
+
+	// End of the buffered range, in sample frames.
+	std::atomic<long long> m_BufferedEndFrame = 0;
 
-	// Read buffer queue.
-	std::queue<std::vector<float>*> m_ReadQueue;
+	// Pending seek request position, in sample frames, for a seek outside the blocks retained for reading (or -1 if there is no pending request).
+	std::atomic<long long> m_SeekRequest = -1;
 
-	// Current read buffer.
-	std::vector<float>* m_ReadBuffer = nullptr;
+	// Indicates whether the last seek request was within the buffered range.
+	std::atomic_bool m_SeekBuffered = false;
 
-	// Current read buffer offset.
-	long m_ReadBufferOffset = 0;
+	// Indicates whether the decode-ahead thread is running (and so will service seek requests).
+	std::atomic_bool m_DecodeAheadRunning = false;
 };
@@ -3,9 +3,12 @@
 #include "Utility.h"
 #include "VUPlayer.h"
 
+#include <algorithm>
 #include <array>
 #include <filesystem>
 #include <fstream>
+#include <iterator>
+#include <set>
 
 // Next available playlist item ID.
 long Playlist::s_NextItemID = 0;
@@ -13,16 +16,8 @@ long Playlist::s_NextItemID = 0;
 // Supported playlist file extensions.
 constexpr std::array s_SupportedExtensions { L"vpl", L"m3u", L"m3u8", L"pls" };
 
-DWORD WINAPI Playlist::PendingThreadProc( LPVOID lpParam )
-{
-	Playlist* playlist = reinterpret_cast<Playlist*>( lpParam );
-	if ( nullptr != playlist ) {
-		CoInitializeEx( NULL /*reserved*/, COINIT_APARTMENTTHREADED );
-		playlist->OnPendingThreadHandler();
-		CoUninitialize();
-	}
-	return 0;
-}
+// Maximum number of pending files to add as a single batch (each batch uses a single library transaction & notification).
+constexpr size_t kPendingBatchSize = 32;
 
 Playlist::Playlist( Library& library, const std::string& id, const Type& type ) :
 	m_ID( id ),
@@ -31,10 +26,8 @@ Playlist::Playlist( Library& library, const std::string& id, const Type& type )
 	m_Pending(),
 	m_MutexPlaylist(),
 	m_MutexPending(),
-	m_PendingThread( NULL ),
-	m_PendingStopEvent( NULL ),
-	m_PendingWakeEvent( NULL ),
-	m_RestartPendingThread( false ),
+	m_PendingTaskActive( false ),
+	m_PendingTaskGroup(),
 	m_Library( library ),
 	m_SortColumn( ( Type::Folder == type ) ? Column::Filepath : Column::_Undefined ),
 	m_SortAscending( ( Type::Folder == type ) ? true : false ),
@@ -58,8 +51,7 @@ Playlist::Playlist( Library& library, const Type& type, const bool mergeDuplicat
 
 Playlist::~Playlist()
 {
-	StopPendingThread();
-	CloseHandles();
+	StopPendingTask();
 }
 
 const std::string& Playlist::GetID() const
@@ -218,6 +210,20 @@ Playlist::Item Playlist::GetRandomItem( const Item& currentItem )
 	return result;
 }
 
+Playlist::ItemList Playlist::GetRandomCandidates( const Item& currentItem, const size_t count )
+{
+	ItemList candidates;
+	std::lock_guard<std::mutex> shuffleLock( m_MutexShuffled );
+	for ( auto item = m_ShuffledPlaylist.begin(); ( m_ShuffledPlaylist.end() != item ) && ( candidates.size() < count ); item++ ) {
+		// Skip over items in the same way as GetRandomItem.
+		const Item& previousItem = candidates.empty() ? currentItem : candidates.back();
+		if ( ( previousItem.ID != item->ID ) && ContainsItem( *item ) ) {
+			candidates.push_back( *item );
+		}
+	}
+	return candidates;
+}
+
 Playlist::Item Playlist::AddItem( const MediaInfo& mediaInfo )
 {
 	int position = 0;
@@ -271,61 +277,62 @@ Playlist::Item Playlist::AddItem( const MediaInfo& mediaInfo, int& position, boo
 	return item;
 }
 
-void Playlist::AddPending( const std::wstring& filename, const bool startPendingThread )
+void Playlist::AddPending( const std::wstring& filename, const bool startPendingTask )
 {
 	{
 		std::lock_guard<std::mutex> lock( m_MutexPending );
 		m_Pending.push_back( filename );
 	}
-	if ( startPendingThread ) {
-		StartPendingThread();
+	if ( startPendingTask ) {
+		StartPendingTask();
 	}
 }
 
-void Playlist::OnPendingThreadHandler()
+void Playlist::OnPendingTaskHandler()
 {
-	m_RestartPendingThread = false;
-	const DWORD timeout = 10 * 1000 /*msec*/;
-	HANDLE eventHandles[ 2 ] = { m_PendingStopEvent, m_PendingWakeEvent };
-
-	while ( WaitForMultipleObjects( 2, eventHandles, FALSE /*waitAll*/, timeout ) != WAIT_OBJECT_0 ) {
-		std::wstring filename;
+	bool finished = false;
+	while ( !finished ) {
+		std::list<std::wstring> filenames;
 		{
 			std::lock_guard<std::mutex> lock( m_MutexPending );
-			if ( m_Pending.empty() ) {
-				if ( WAIT_OBJECT_0 == WaitForSingleObject( m_PendingWakeEvent, 0 ) ) {
-					// Hang around for additional pending files.
-					ResetEvent( m_PendingWakeEvent );
-				} else {
-					// We've timed out, so self-terminate and signal that the thread should be restarted.
-					m_RestartPendingThread = true;
-					break;
-				}
+			if ( m_Pending.empty() || m_PendingTaskGroup.IsCancelled() ) {
+				m_PendingTaskActive = false;
+				finished = true;
 			} else {
-				filename = m_Pending.front();
-				m_Pending.pop_front();
+				auto batchEnd = m_Pending.begin();
+				std::advance( batchEnd, std::min<size_t>( kPendingBatchSize, m_Pending.size() ) );
+				filenames.splice( filenames.end(), m_Pending, m_Pending.begin(), batchEnd );
 			}
 		}
 
-		if ( !filename.empty() ) {
-			bool addItem = true;
+		if ( !filenames.empty() ) {
 			const Type type = GetType();
-			if ( ( Type::All == type ) || ( Type::Favourites == type ) || ( Type::Folder == type ) || ( Type::Streams == type ) ) {
-				addItem = !ContainsFilename( filename );
+			const bool uniqueFilenames = ( Type::All == type ) || ( Type::Favourites == type ) || ( Type::Folder == type ) || ( Type::Streams == type );
+			std::set<std::wstring> batchFilenames;
+			MediaInfo::List mediaList;
+			for ( const auto& filename : filenames ) {
+				if ( !filename.empty() ) {
+					bool addItem = true;
+					if ( uniqueFilenames ) {
+						addItem = batchFilenames.insert( filename ).second && !ContainsFilename( filename );
+					}
+					if ( addItem ) {
+						mediaList.push_back( MediaInfo( filename ) );
+					}
+				}
 			}
-			if ( addItem ) {
-				MediaInfo mediaInfo( filename );
-				if ( m_Library.GetMediaInfo( mediaInfo ) ) {
-					int position = 0;
-					bool addedAsDuplicate = false;
-					const Item item = AddItem( mediaInfo, position, addedAsDuplicate );
-					VUPlayer* vuplayer = VUPlayer::Get();
-					if ( nullptr != vuplayer ) {
-						if ( addedAsDuplicate ) {
-							vuplayer->OnPlaylistItemUpdated( this, item );
-						} else {
-							vuplayer->OnPlaylistItemAdded( this, item, position );
-						}
+
+			m_Library.GetMediaInfo( mediaList );
+			for ( const auto& mediaInfo : mediaList ) {
+				int position = 0;
+				bool addedAsDuplicate = false;
+				const Item item = AddItem( mediaInfo, position, addedAsDuplicate );
+				VUPlayer* vuplayer = VUPlayer::Get();
+				if ( nullptr != vuplayer ) {
+					if ( addedAsDuplicate ) {
+						vuplayer->OnPlaylistItemUpdated( this, item );
+					} else {
+						vuplayer->OnPlaylistItemAdded( this, item, position );
 					}
 				}
 			}
@@ -333,33 +340,23 @@ void Playlist::OnPendingThreadHandler()
 	}
 }
 
-void Playlist::StartPendingThread()
+void Playlist::StartPendingTask()
 {
 	std::lock_guard<std::mutex> lock( m_MutexPending );
-	if ( nullptr != m_PendingThread ) {
-		if ( m_RestartPendingThread ) {
-			WaitForSingleObject( m_PendingThread, INFINITE );
-			CloseHandles();
-			m_RestartPendingThread = false;
-		}
-	}
-
-	if ( nullptr == m_PendingThread ) {
-		m_PendingStopEvent = CreateEvent( NULL /*attributes*/, TRUE /*manualReset*/, FALSE /*initialState*/, L"" /*name*/ );
-		m_PendingWakeEvent = CreateEvent( NULL /*attributes*/, TRUE /*manualReset*/, FALSE /*initialState*/, L"" /*name*/ );
-		m_PendingThread = CreateThread( NULL /*attributes*/, 0 /*stackSize*/, PendingThreadProc, reinterpret_cast<LPVOID>( this ), 0 /*flags*/, NULL /*threadId*/ );
+	if ( !m_PendingTaskActive && !m_Pending.empty() ) {
+		m_PendingTaskActive = true;
+		TaskScheduler::Get().Submit( m_PendingTaskGroup, TaskScheduler::Priority::UI, [ this ] ()
+		{
+			OnPendingTaskHandler();
+		} );
 	}
-
-	SetEvent( m_PendingWakeEvent );
 }
 
-void Playlist::StopPendingThread()
+void Playlist::StopPendingTask()
 {
-	if ( nullptr != m_PendingThread ) {
-		SetEvent( m_PendingStopEvent );
-		WaitForSingleObject( m_PendingThread, INFINITE );
-		CloseHandles();
-	}
+	m_PendingTaskGroup.Cancel();
+	std::lock_guard<std::mutex> lock( m_MutexPending );
+	m_PendingTaskActive = false;
 }
 
 Library& Playlist::GetLibrary()
@@ -790,22 +787,6 @@ void Playlist::SplitDuplicates()
 	}
 }
 
-void Playlist::CloseHandles()
-{
-	if ( nullptr != m_PendingStopEvent ) {
-		CloseHandle( m_PendingStopEvent );
-		m_PendingStopEvent = nullptr;
-	}
-	if ( nullptr != m_PendingWakeEvent ) {
-		CloseHandle( m_PendingWakeEvent );
-		m_PendingWakeEvent = nullptr;
-	}
-	if ( nullptr != m_PendingThread ) {
-		CloseHandle( m_PendingThread );
-		m_PendingThread = nullptr;
-	}
-}
-
 void Playlist::UpdateItem( const Item& item )
 {
 	std::lock_guard<std::mutex> lock( m_MutexPlaylist );
@@ -818,7 +799,7 @@ void Playlist::UpdateItem( const Item& item )
 	}
 }
 
-bool Playlist::AddPlaylist( const std::wstring& filename, const bool startPendingThread )
+bool Playlist::AddPlaylist( const std::wstring& filename, const bool startPendingTask )
 {
 	bool added = false;
 	const std::wstring fileExt = GetFileExtension( filename );
@@ -829,8 +810,8 @@ bool Playlist::AddPlaylist( const std::wstring& filename, const bool startPendin
 	} else if ( L"pls" == fileExt ) {
 		added = AddPLS( filename );
 	}
-	if ( added && startPendingThread ) {
-		StartPendingThread();
+	if ( added && startPendingTask ) {
+		StartPendingTask();
 	}
 	return added;
 }
@@ -847,7 +828,7 @@ bool Playlist::AddVPL( const std::wstring& filename )
 			const size_t delimiter = line.find_first_of( 0x01 );
 			if ( std::string::npos != delimiter ) {
 				const std::string name = line.substr( 0 /*offset*/, delimiter /*count*/ );			
-				AddPending( AnsiCodePageToWideString( name ), false /*startPendingThread*/ );
+				AddPending( AnsiCodePageToWideString( name ), false /*startPendingTask*/ );
 				added = true;
 			}
 		} while ( !stream.eof() );
@@ -871,7 +852,7 @@ bool Playlist::AddM3U( const std::wstring& filename )
 				const std::wstring filenameEntry = UTF8ToWideString( line );
 				if ( ( filenameEntry.size() > 0 ) && ( '#' != filenameEntry.front() ) ) {
 					if ( IsURL( filenameEntry ) ) {
-						AddPending( filenameEntry, false /*startPendingThread*/ );
+						AddPending( filenameEntry, false /*startPendingTask*/ );
 						added = true;
 					} else {
 						std::filesystem::path filePath = std::filesystem::path( filenameEntry ).lexically_normal();
@@ -879,7 +860,7 @@ bool Playlist::AddM3U( const std::wstring& filename )
 							filePath = playlistPath / filePath;
 						}
 						if ( std::filesystem::exists( filePath ) ) {
-							AddPending( filePath, false /*startPendingThread*/ );
+							AddPending( filePath, false /*startPendingTask*/ );
 							added = true;
 						}
 					}
@@ -909,7 +890,7 @@ bool Playlist::AddPLS( const std::wstring& filename )
 				if ( !name.empty() ) {
 					const std::wstring filenameEntry = UTF8ToWideString( name );
 					if ( IsURL( filenameEntry ) ) {
-						AddPending( filenameEntry, false /*startPendingThread*/ );
+						AddPending( filenameEntry, false /*startPendingTask*/ );
 						added = true;
 					} else {
 						std::filesystem::path filePath = std::filesystem::path( filenameEntry ).lexically_normal();
@@ -917,7 +898,7 @@ bool Playlist::AddPLS( const std::wstring& filename )
 							filePath = playlistPath / filePath;
 						}
 						if ( std::filesystem::exists( filePath ) ) {
-							AddPending( filePath, false /*startPendingThread*/ );
+							AddPending( filePath, false /*startPendingTask*/ );
 							added = true;
 						}
 					}
@@ -3,6 +3,7 @@
 #include "stdafx.h"
 
 #include "Library.h"
+#include "TaskScheduler.h"
 
 #include <atomic>
 #include <list>
@@ -141,6 +142,12 @@ public:
 	// 'currentItem' - the current item.
 	Item GetRandomItem( const Item& currentItem );
 
+	// Returns the items which subsequent calls to GetRandomItem will return (without affecting the random order), so that they can be preloaded.
+	// 'currentItem' - the current item.
+	// 'count' - maximum number of items to return.
+	// Fewer items are returned when the remaining random order is shorter than the 'count', as the next order is not determined until it is needed.
+	ItemList GetRandomCandidates( const Item& currentItem, const size_t count );
+
 	// Adds 'mediaInfo' to the playlist, returning the added item.
 	Item AddItem( const MediaInfo& mediaInfo );
 
@@ -150,19 +157,19 @@ public:
 	Item AddItem( const MediaInfo& mediaInfo, int& position, bool& addedAsDuplicate );
 
 	// Adds 'filename' to the list of pending files to be added to the playlist.
-	// 'startPendingThread' - whether to start the background thread to process pending files.
-	void AddPending( const std::wstring& filename, const bool startPendingThread = true );
+	// 'startPendingTask' - whether to start the background task to process pending files.
+	void AddPending( const std::wstring& filename, const bool startPendingTask = true );
 
 	// Adds a playlist 'filename' to this playlist.
-	// 'startPendingThread' - whether to start the background thread to process pending files.
+	// 'startPendingTask' - whether to start the background task to process pending files.
 	// Returns whether any pending files were added to this playlist.
-	bool AddPlaylist( const std::wstring& filename, const bool startPendingThread = true );
+	bool AddPlaylist( const std::wstring& filename, const bool startPendingTask = true );
 
-	// Starts the thread for adding pending files to the playlist.
-	void StartPendingThread();
+	// Starts the background task for adding pending files to the playlist.
+	void StartPendingTask();
 
-	// Stops the thread for adding pending files to the playlist.
-	void StopPendingThread();
+	// Stops the background task for adding pending files to the playlist.
+	void StopPendingTask();
 
 	// Returns the media library.
 	Library& GetLibrary();
@@ -223,9 +230,6 @@ public:
 	bool ContainsItem( const Item& item );
 
 private:
-	// Pending file thread proc.
-	static DWORD WINAPI PendingThreadProc( LPVOID lpParam );
-
 	// Returns true if 'item1' is less than 'item2' when comparing by 'column' type.
 	static bool LessThan( const Item& item1, const Item& item2, const Column column );
 
@@ -235,8 +239,8 @@ private:
 	// Next available playlist item ID.
 	static long s_NextItemID;
 
-	// Thread handler for processing the list of pending files.
-	void OnPendingThreadHandler();
+	// Task handler for processing the list of pending files.
+	void OnPendingTaskHandler();
 
 	// Returns whether the playlist contains 'filename'.
 	bool ContainsFilename( const std::wstring& filename );
@@ -247,9 +251,6 @@ private:
 	// Splits out any duplicates into separate items.
 	void SplitDuplicates();
 
-	// Closes the thread and event handles.
-	void CloseHandles();
-
 	// Adds a VPL playlist 'filename' to this playlist.
 	// Returns whether any pending files were added to this playlist.
 	bool AddVPL( const std::wstring& filename );
@@ -280,17 +281,11 @@ private:
 	// Pending files mutex.
 	std::mutex m_MutexPending;
 
-	// The thread for adding pending files to the playlist.
-	HANDLE m_PendingThread;
-
-	// Event handle for terminating the pending file thread.
-	HANDLE m_PendingStopEvent;
-
-	// Event handle for waking the pending file thread.
-	HANDLE m_PendingWakeEvent;
+	// Indicates whether the task for adding pending files to the playlist is queued or running.
+	bool m_PendingTaskActive;
 
-	// Indicates whether the pending files thread should be restarted.
-	std::atomic<bool> m_RestartPendingThread;
+	// The task for adding pending files to the playlist.
+	TaskScheduler::Group m_PendingTaskGroup;
 
 	// Media library.
 	Library& m_Library;
@@ -0,0 +1,339 @@
+#include "Resampler.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined( _M_X64 ) || defined( _M_IX86 ) || defined( __SSE2__ )
+#define RESAMPLER_SSE2
+#include <emmintrin.h>
+#endif
+
+// Number of filter phases (coefficients are linearly interpolated between phases).
+constexpr size_t kPhases = 256;
+
+// Number of input frames to read at a time.
+constexpr size_t kInputBlock = 1024;
+
+// The time over which conversion ratio changes are ramped, in seconds.
+constexpr double kRampTime = 0.05;
+
+// Filter parameters for a resampling quality.
+struct FilterParameters {
+	size_t Taps;			// Number of filter taps (a multiple of 4).
+	double Beta;			// Kaiser window beta.
+	double Passband;	// Filter passband, relative to the lower Nyquist frequency.
+};
+
+// Returns the filter parameters for a resampling 'quality'.
+static FilterParameters GetFilterParameters( const Settings::ResamplerQuality quality )
+{
+	FilterParameters parameters = { 16, 7.0, 0.9 };
+	switch ( quality ) {
+		case Settings::ResamplerQuality::Low : {
+			parameters = { 8, 5.0, 0.8 };
+			break;
+		}
+		case Settings::ResamplerQuality::High : {
+			parameters = { 32, 9.0, 0.95 };
+			break;
+		}
+		default : {
+			break;
+		}
+	}
+	return parameters;
+}
+
+// Returns the zeroth order modified Bessel function of the first kind, for 'x'.
+static double BesselI0( const double x )
+{
+	double sum = 1.0;
+	double term = 1.0;
+	for ( int k = 1; ( k < 50 ) && ( term > ( sum * 1e-12 ) ); k++ ) {
+		const double factor = x / ( 2 * k );
+		term *= factor * factor;
+		sum += term;
+	}
+	return sum;
+}
+
+// Returns the dot product of 'a' and 'b', where 'count' is a multiple of 4.
+static inline float DotProduct( const float* a, const float* b, const size_t count )
+{
+#ifdef RESAMPLER_SSE2
+	__m128 sum = _mm_setzero_ps();
+	for ( size_t i = 0; i < count; i += 4 ) {
+		sum = _mm_add_ps( sum, _mm_mul_ps( _mm_loadu_ps( a + i ), _mm_loadu_ps( b + i ) ) );
+	}
+	sum = _mm_add_ps( sum, _mm_movehl_ps( sum, sum ) );
+	sum = _mm_add_ss( sum, _mm_shuffle_ps( sum, sum, 1 ) );
+	return _mm_cvtss_f32( sum );
+#else
+	float sum = 0;
+	for ( size_t i = 0; i < count; i++ ) {
+		sum += a[ i ] * b[ i ];
+	}
+	return sum;
+#endif
+}
+
+Resampler::Resampler( const long channels, const long inputRate, const long outputRate, const float pitch, const Settings::ResamplerQuality quality, Reader reader ) :
+	m_Channels( static_cast<size_t>( std::max<long>( 1l, channels ) ) ),
+	m_InputRate( std::max<long>( 1l, inputRate ) ),
+	m_OutputRate( std::max<long>( 1l, outputRate ) ),
+	m_Taps( GetFilterParameters( quality ).Taps ),
+	m_Beta( GetFilterParameters( quality ).Beta ),
+	m_Passband( GetFilterParameters( quality ).Passband ),
+	m_Reader( reader ),
+	m_Table(),
+	m_PendingMutex(),
+	m_PendingTable(),
+	m_Input( m_Channels, std::vector<float>( kInputBlock + 4 * m_Taps ) ),
+	m_InputInterleaved( kInputBlock * m_Channels ),
+	m_Coefficients( m_Taps ),
+	m_Checkpoints()
+{
+	m_Ratio = m_TargetRatio = m_PendingRatio = GetRatio( pitch );
+	m_Cutoff = m_PendingCutoff = GetCutoff( m_Ratio );
+	CalculateTable( m_Cutoff, m_Table );
+
+	// Start with enough silence before the first input frame to fill the filter history.
+	m_Available = m_Taps / 2 - 1;
+	m_Position = static_cast<double>( m_Available );
+
+	m_Checkpoints[ 0 ].Store( { 0, 0, 0.0 } );
+	m_CheckpointCount = 1;
+}
+
+Resampler::~Resampler()
+{
+}
+
+long Resampler::GetChannels() const
+{
+	return static_cast<long>( m_Channels );
+}
+
+long Resampler::GetInputRate() const
+{
+	return m_InputRate;
+}
+
+long Resampler::GetOutputRate() const
+{
+	return m_OutputRate;
+}
+
+long long Resampler::GetInputFramesRead() const
+{
+	return m_InputFramesRead;
+}
+
+double Resampler::GetRatio( const float pitch ) const
+{
+	return static_cast<double>( m_InputRate ) * std::max<float>( pitch, 0.01f ) / m_OutputRate;
+}
+
+double Resampler::GetCutoff( const double ratio ) const
+{
+	return m_Passband * std::min<double>( 1.0, 1.0 / ratio );
+}
+
+void Resampler::CalculateTable( const double cutoff, std::vector<float>& table ) const
+{
+	constexpr double kPi = 3.14159265358979323846;
+	const size_t halfTaps = m_Taps / 2;
+	const double besselBeta = BesselI0( m_Beta );
+	table.resize( 2 * kPhases * m_Taps );
+	std::vector<double> phase( m_Taps );
+	std::vector<double> nextPhase( m_Taps );
+	const auto calculatePhase = [ this, cutoff, halfTaps, besselBeta ] ( const size_t index, std::vector<double>& coefficients )
+	{
+		const double fraction = static_cast<double>( index ) / kPhases;
+		double sum = 0;
+		for ( size_t tap = 0; tap < m_Taps; tap++ ) {
+			const double x = static_cast<double>( tap ) - ( halfTaps - 1 ) - fraction;
+			const double u = x / halfTaps;
+			const double window = ( fabs( u ) < 1.0 ) ? ( BesselI0( m_Beta * sqrt( 1.0 - u * u ) ) / besselBeta ) : 0;
+			const double sinc = ( 0 == x ) ? 1.0 : ( sin( kPi * cutoff * x ) / ( kPi * cutoff * x ) );
+			coefficients[ tap ] = window * sinc;
+			sum += coefficients[ tap ];
+		}
+		for ( auto& coefficient : coefficients ) {
+			coefficient /= sum;
+		}
+	};
+
+	calculatePhase( 0, phase );
+	for ( size_t index = 0; index < kPhases; index++ ) {
+		calculatePhase( index + 1, nextPhase );
+		float* coefficients = table.data() + 2 * index * m_Taps;
+		float* differences = coefficients + m_Taps;
+		for ( size_t tap = 0; tap < m_Taps; tap++ ) {
+			coefficients[ tap ] = static_cast<float>( phase[ tap ] );
+			differences[ tap ] = static_cast<float>( nextPhase[ tap ] - phase[ tap ] );
+		}
+		phase.swap( nextPhase );
+	}
+}
+
+void Resampler::SetPitch( const float pitch )
+{
+	const double ratio = GetRatio( pitch );
+	const double cutoff = GetCutoff( ratio );
+	std::lock_guard<std::mutex> lock( m_PendingMutex );
+	if ( cutoff != m_PendingCutoff ) {
+		// Filter table calculation is relatively expensive, so it is done here rather than when reading.
+		CalculateTable( cutoff, m_PendingTable );
+		m_PendingCutoff = cutoff;
+	}
+	m_PendingRatio = ratio;
+	m_PendingChanged = true;
+}
+
+bool Resampler::Fill()
+{
+	// Discard any input which precedes the filter history for the current position.
+	const size_t historyFrames = m_Taps / 2 - 1;
+	const size_t discard = std::min<size_t>( m_Available, static_cast<size_t>( m_Position ) - historyFrames );
+	if ( discard > 0 ) {
+		for ( auto& input : m_Input ) {
+			std::copy( input.begin() + discard, input.begin() + m_Available, input.begin() );
+		}
+		m_Available -= discard;
+		m_Position -= static_cast<double>( discard );
+		m_Discarded += static_cast<long long>( discard );
+	}
+
+	bool success = false;
+	if ( !m_Ended ) {
+		const size_t framesRead = m_Reader ? std::min<size_t>( kInputBlock, m_Reader( m_InputInterleaved.data(), kInputBlock ) ) : 0;
+		if ( framesRead > 0 ) {
+			for ( size_t channel = 0; channel < m_Channels; channel++ ) {
+				float* input = m_Input[ channel ].data() + m_Available;
+				const float* interleaved = m_InputInterleaved.data() + channel;
+				for ( size_t frame = 0; frame < framesRead; frame++, interleaved += m_Channels ) {
+					input[ frame ] = *interleaved;
+				}
+			}
+			m_Available += framesRead;
+			m_InputFramesRead += static_cast<long long>( framesRead );
+		} else {
+			// Flush the final input frames through the filter, by following them with silence.
+			for ( auto& input : m_Input ) {
+				std::fill( input.begin() + m_Available, input.begin() + m_Available + m_Taps / 2 + 1, 0.0f );
+			}
+			m_Available += m_Taps / 2 + 1;
+			m_Ended = true;
+		}
+		success = true;
+	}
+	return success;
+}
+
+size_t Resampler::Read( float* output, const size_t frames )
+{
+	if ( std::unique_lock<std::mutex> lock( m_PendingMutex, std::try_to_lock ); lock.owns_lock() && m_PendingChanged ) {
+		// Only pick up pitch changes when they are not being written, so that the caller is never blocked.
+		if ( m_PendingCutoff != m_Cutoff ) {
+			m_Table.swap( m_PendingTable );
+			m_Cutoff = m_PendingCutoff;
+		}
+		m_TargetRatio = m_PendingRatio;
+		m_RampRemaining = std::max<size_t>( 1, static_cast<size_t>( kRampTime * m_OutputRate ) );
+		m_RatioStep = ( m_TargetRatio - m_Ratio ) / m_RampRemaining;
+		m_PendingChanged = false;
+	}
+
+	const size_t halfTaps = m_Taps / 2;
+	size_t framesRead = 0;
+	while ( framesRead < frames ) {
+		const size_t index = static_cast<size_t>( m_Position );
+		if ( ( index + halfTaps ) >= m_Available ) {
+			if ( Fill() ) {
+				continue;
+			} else {
+				break;
+			}
+		}
+
+		const double fraction = m_Position - static_cast<double>( index );
+		if ( ( 0 == fraction ) && ( 1.0 == m_Ratio ) && ( 0 == m_RampRemaining ) ) {
+			// Pass through any input which does not need resampling.
+			const size_t count = std::min<size_t>( frames - framesRead, m_Available - halfTaps - index );
+			for ( size_t channel = 0; channel < m_Channels; channel++ ) {
+				const float* input = m_Input[ channel ].data() + index;
+				float* channelOutput = output + framesRead * m_Channels + channel;
+				for ( size_t frame = 0; frame < count; frame++, channelOutput += m_Channels ) {
+					*channelOutput = input[ frame ];
+				}
+			}
+			m_Position += static_cast<double>( count );
+			framesRead += count;
+		} else {
+			// Interpolate the filter coefficients between the two nearest phases.
+			const double phase = fraction * kPhases;
+			const size_t phaseIndex = std::min<size_t>( kPhases - 1, static_cast<size_t>( phase ) );
+			const float phaseFraction = static_cast<float>( phase - static_cast<double>( phaseIndex ) );
+			const float* coefficients = m_Table.data() + 2 * phaseIndex * m_Taps;
+			const float* differences = coefficients + m_Taps;
+			size_t tap = 0;
+#ifdef RESAMPLER_SSE2
+			const __m128 phaseFraction4 = _mm_set1_ps( phaseFraction );
+			for ( ; tap < m_Taps; tap += 4 ) {
+				_mm_storeu_ps( m_Coefficients.data() + tap, _mm_add_ps( _mm_loadu_ps( coefficients + tap ), _mm_mul_ps( _mm_loadu_ps( differences + tap ), phaseFraction4 ) ) );
+			}
+#endif
+			for ( ; tap < m_Taps; tap++ ) {
+				m_Coefficients[ tap ] = coefficients[ tap ] + differences[ tap ] * phaseFraction;
+			}
+
+			float* frameOutput = output + framesRead * m_Channels;
+			for ( size_t channel = 0; channel < m_Channels; channel++ ) {
+				frameOutput[ channel ] = DotProduct( m_Coefficients.data(), m_Input[ channel ].data() + index + 1 - halfTaps, m_Taps );
+			}
+
+			m_Position += m_Ratio;
+			if ( m_RampRemaining > 0 ) {
+				m_Ratio = ( 0 == --m_RampRemaining ) ? m_TargetRatio : ( m_Ratio + m_RatioStep );
+			}
+			++framesRead;
+		}
+	}
+
+	m_OutputFrames += static_cast<long long>( framesRead );
+	const double inputPosition = static_cast<double>( m_Discarded ) + m_Position - static_cast<double>( halfTaps - 1 );
+	const long long checkpointIndex = m_CheckpointCount.load( std::memory_order_relaxed );
+	m_Checkpoints[ static_cast<size_t>( checkpointIndex ) % kCheckpoints ].Store( { checkpointIndex, m_OutputFrames, inputPosition } );
+	m_CheckpointCount.store( 1 + checkpointIndex, std::memory_order_release );
+
+	return framesRead;
+}
+
+double Resampler::GetInputPosition( const long long outputFrame ) const
+{
+	const long long count = m_CheckpointCount.load( std::memory_order_acquire );
+	double inputPosition = 0;
+	Checkpoint previous = {};
+	bool found = false;
+	for ( long long index = std::max<long long>( 0, count - static_cast<long long>( kCheckpoints ) ); index < count; index++ ) {
+		const Checkpoint checkpoint = m_Checkpoints[ static_cast<size_t>( index ) % kCheckpoints ].Load();
+		if ( checkpoint.Index != index ) {
+			// The checkpoint has since been overwritten by a newer one.
+			continue;
+		}
+		if ( !found || ( outputFrame >= checkpoint.OutputFrame ) ) {
+			inputPosition = checkpoint.InputPosition;
+		} else {
+			if ( ( outputFrame > previous.OutputFrame ) && ( checkpoint.OutputFrame > previous.OutputFrame ) ) {
+				// Interpolate between the checkpoints either side of the output position.
+				const double fraction = static_cast<double>( outputFrame - previous.OutputFrame ) / static_cast<double>( checkpoint.OutputFrame - previous.OutputFrame );
+				inputPosition = previous.InputPosition + fraction * ( checkpoint.InputPosition - previous.InputPosition );
+			}
+			break;
+		}
+		previous = checkpoint;
+		found = true;
+	}
+	return inputPosition;
+}
@@ -0,0 +1,167 @@
+#pragma once
+
+#include "SeqLock.h"
+#include "Settings.h"
+
+#include <array>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+// Polyphase windowed-sinc resampler, which converts interleaved floating point sample data from an input to an output sample rate.
+// The conversion ratio can also be scaled by a pitch factor, which can be changed continuously (ratio changes are ramped to avoid zipper noise).
+// Dot products use SSE2 (where available), and all buffers are allocated on construction, so that reading is allocation free.
+class Resampler
+{
+public:
+	// Callback which reads up to 'frames' of interleaved input sample data into the 'buffer', returning the number of frames read (zero at end of stream).
+	using Reader = std::function<size_t( float* buffer, const size_t frames )>;
+
+	// 'channels' - number of channels.
+	// 'inputRate' - input sample rate.
+	// 'outputRate' - output sample rate.
+	// 'pitch' - initial pitch factor (1.0 for no change).
+	// 'quality' - resampling quality.
+	// 'reader' - input sample data reader.
+	Resampler( const long channels, const long inputRate, const long outputRate, const float pitch, const Settings::ResamplerQuality quality, Reader reader );
+
+	virtual ~Resampler();
+
+	// Sets the 'pitch' factor (1.0 for no change).
+	// This can be called from any thread.
+	void SetPitch( const float pitch );
+
+	// Reads resampled output.
+	// 'output' - interleaved output sample data.
+	// 'frames' - number of samples per channel to read.
+	// Returns the number of samples per channel read, which is only less than 'frames' at the end of the input stream.
+	size_t Read( float* output, const size_t frames );
+
+	// Returns the number of channels.
+	long GetChannels() const;
+
+	// Returns the input sample rate.
+	long GetInputRate() const;
+
+	// Returns the output sample rate.
+	long GetOutputRate() const;
+
+	// Returns the total number of input frames read.
+	long long GetInputFramesRead() const;
+
+	// Returns the input position, in frames, which corresponds to an 'outputFrame' position (for a recently read output frame).
+	double GetInputPosition( const long long outputFrame ) const;
+
+private:
+	// An output frame position, paired with the corresponding input position.
+	struct Checkpoint {
+		long long Index;				// Checkpoint sequence number (so that readers can detect a checkpoint which has been overwritten).
+		long long OutputFrame;	// Output frame position.
+		double InputPosition;		// Corresponding input position.
+	};
+
+	// Number of checkpoints to retain for mapping output positions to input positions.
+	static constexpr size_t kCheckpoints = 256;
+
+	// Returns the ratio of input to output frames, for a 'pitch' factor.
+	double GetRatio( const float pitch ) const;
+
+	// Returns the filter cutoff, relative to the input Nyquist frequency, for a conversion 'ratio'.
+	double GetCutoff( const double ratio ) const;
+
+	// Calculates the filter 'table' for a 'cutoff'.
+	void CalculateTable( const double cutoff, std::vector<float>& table ) const;
+
+	// Discards input which is no longer required, and reads more input.
+	// Returns false if there is no more input.
+	bool Fill();
+
+	// Number of channels.
+	const size_t m_Channels;
+
+	// Input sample rate.
+	const long m_InputRate;
+
+	// Output sample rate.
+	const long m_OutputRate;
+
+	// Number of filter taps.
+	const size_t m_Taps;
+
+	// Kaiser window beta.
+	const double m_Beta;
+
+	// Filter passband, relative to the lower Nyquist frequency.
+	const double m_Passband;
+
+	// Input sample data reader.
+	Reader m_Reader;
+
+	// Filter table, containing coefficients for each phase followed by the differences to the next phase.
+	std::vector<float> m_Table;
+
+	// Filter table cutoff.
+	double m_Cutoff = 0;
+
+	// Guards the pending pitch & filter table.
+	std::mutex m_PendingMutex;
+
+	// Pending filter table.
+	std::vector<float> m_PendingTable;
+
+	// Pending filter table cutoff.
+	double m_PendingCutoff = 0;
+
+	// Pending conversion ratio.
+	double m_PendingRatio = 0;
+
+	// Whether the pending pitch has changed.
+	bool m_PendingChanged = false;
+
+	// Current conversion ratio (input frames per output frame).
+	double m_Ratio = 0;
+
+	// Target conversion ratio.
+	double m_TargetRatio = 0;
+
+	// Conversion ratio increment per output frame, while ramping.
+	double m_RatioStep = 0;
+
+	// The number of output frames remaining until the target conversion ratio is reached.
+	size_t m_RampRemaining = 0;
+
+	// Planar input buffers, per channel.
+	std::vector<std::vector<float>> m_Input;
+
+	// Interleaved input buffer.
+	std::vector<float> m_InputInterleaved;
+
+	// Interpolated filter coefficients for the current output frame.
+	std::vector<float> m_Coefficients;
+
+	// Number of valid frames in the planar input buffers.
+	size_t m_Available = 0;
+
+	// Current position in the planar input buffers.
+	double m_Position = 0;
+
+	// Number of input frames discarded from the start of the planar input buffers.
+	long long m_Discarded = 0;
+
+	// Whether the end of the input stream has been reached.
+	bool m_Ended = false;
+
+	// Total number of input frames read.
+	std::atomic<long long> m_InputFramesRead = 0;
+
+	// Total number of output frames read.
+	long long m_OutputFrames = 0;
+
+	// Recent checkpoints, as a circular buffer.
+	// Checkpoints are published by the reading thread & read from any thread without locking, so that the reading thread is never blocked.
+	std::array<SeqLock<Checkpoint>, kCheckpoints> m_Checkpoints;
+
+	// Total number of checkpoints published.
+	std::atomic<long long> m_CheckpointCount = 0;
+};
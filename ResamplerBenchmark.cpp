@@ -0,0 +1,179 @@
+#include "ResamplerBenchmark.h"
+
+#include "Resampler.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+// Quality levels to measure.
+constexpr std::array kQualities = { Settings::ResamplerQuality::Low, Settings::ResamplerQuality::Medium, Settings::ResamplerQuality::High };
+
+// Sample rate conversions to measure (input rate, output rate).
+constexpr std::array kConversions = { std::make_pair( 44100l, 48000l ), std::make_pair( 48000l, 44100l ), std::make_pair( 44100l, 96000l ), std::make_pair( 96000l, 44100l ) };
+
+// Number of channels.
+constexpr long kChannels = 2;
+
+// Test tone frequency, in Hz.
+constexpr double kToneFrequency = 1000.0;
+
+// Test tone amplitude.
+constexpr double kToneAmplitude = 0.5;
+
+// Test tone duration, in seconds.
+constexpr double kToneDuration = 10.0;
+
+// Amount of output to ignore at the start & end when measuring THD+N, in seconds.
+constexpr double kSettleDuration = 0.1;
+
+// Output block size, in samples per channel.
+constexpr size_t kBlockSize = 4096;
+
+ResamplerBenchmark::ResamplerBenchmark()
+{
+}
+
+ResamplerBenchmark::~ResamplerBenchmark()
+{
+}
+
+bool ResamplerBenchmark::Run( const std::wstring& outputFilename ) const
+{
+	Measurements measurements;
+	for ( const auto quality : kQualities ) {
+		for ( const auto& [ inputRate, outputRate ] : kConversions ) {
+			measurements.push_back( Measure( quality, inputRate, outputRate ) );
+		}
+	}
+	const bool success = IsBenchmarkCSV( outputFilename ) ? WriteCSV( measurements, outputFilename ) : WriteJSON( measurements, outputFilename );
+	return success;
+}
+
+ResamplerBenchmark::Measurement ResamplerBenchmark::Measure( const Settings::ResamplerQuality quality, const long inputRate, const long outputRate )
+{
+	Measurement measurement;
+	switch ( quality ) {
+		case Settings::ResamplerQuality::Low : {
+			measurement.Quality = "low";
+			break;
+		}
+		case Settings::ResamplerQuality::Medium : {
+			measurement.Quality = "medium";
+			break;
+		}
+		case Settings::ResamplerQuality::High : {
+			measurement.Quality = "high";
+			break;
+		}
+		default : {
+			break;
+		}
+	}
+	measurement.InputRate = inputRate;
+	measurement.OutputRate = outputRate;
+
+	// Generate the test tone up front, so that only the resampler is timed.
+	constexpr double kPi = 3.14159265358979323846;
+	const size_t inputFrames = static_cast<size_t>( kToneDuration * inputRate );
+	std::vector<float> input( inputFrames * kChannels );
+	for ( size_t frame = 0; frame < inputFrames; frame++ ) {
+		const float value = static_cast<float>( kToneAmplitude * sin( 2 * kPi * kToneFrequency * static_cast<double>( frame ) / inputRate ) );
+		for ( long channel = 0; channel < kChannels; channel++ ) {
+			input[ frame * kChannels + channel ] = value;
+		}
+	}
+
+	size_t inputPosition = 0;
+	Resampler::Reader reader = [ &input, &inputPosition, inputFrames ] ( float* buffer, const size_t frames ) -> size_t
+	{
+		const size_t framesRead = std::min<size_t>( frames, inputFrames - inputPosition );
+		std::copy( input.begin() + inputPosition * kChannels, input.begin() + ( inputPosition + framesRead ) * kChannels, buffer );
+		inputPosition += framesRead;
+		return framesRead;
+	};
+	Resampler resampler( kChannels, inputRate, outputRate, 1.0f /*pitch*/, quality, reader );
+
+	std::vector<float> output( static_cast<size_t>( ( kToneDuration + 1 ) * outputRate ) * kChannels );
+	size_t outputFrames = 0;
+	const LONGLONG startTick = GetBenchmarkTick();
+	size_t framesRead = 0;
+	do {
+		const size_t framesToRead = std::min<size_t>( kBlockSize, output.size() / kChannels - outputFrames );
+		framesRead = resampler.Read( output.data() + outputFrames * kChannels, framesToRead );
+		outputFrames += framesRead;
+	} while ( framesRead > 0 );
+	const double seconds = GetBenchmarkSeconds( startTick, GetBenchmarkTick() );
+
+	if ( seconds > 0 ) {
+		measurement.Throughput = kToneDuration / seconds;
+	}
+	output.resize( outputFrames * kChannels );
+	measurement.THDN = CalculateTHDN( output, kChannels, outputRate, kToneFrequency );
+	return measurement;
+}
+
+double ResamplerBenchmark::CalculateTHDN( const std::vector<float>& samples, const long channels, const long sampleRate, const double frequency )
+{
+	double thdn = 0;
+	const size_t settleFrames = static_cast<size_t>( kSettleDuration * sampleRate );
+	const size_t frames = samples.size() / channels;
+	if ( frames > 2 * settleFrames ) {
+		// Least squares fit of a sinusoid at the test tone frequency.
+		constexpr double kPi = 3.14159265358979323846;
+		const double omega = 2 * kPi * frequency / sampleRate;
+		double ss = 0, sc = 0, cc = 0, ys = 0, yc = 0;
+		for ( size_t frame = settleFrames; frame < frames - settleFrames; frame++ ) {
+			const double s = sin( omega * static_cast<double>( frame ) );
+			const double c = cos( omega * static_cast<double>( frame ) );
+			const double y = samples[ frame * channels ];
+			ss += s * s;
+			sc += s * c;
+			cc += c * c;
+			ys += y * s;
+			yc += y * c;
+		}
+		const double determinant = ss * cc - sc * sc;
+		if ( 0 != determinant ) {
+			const double a = ( ys * cc - yc * sc ) / determinant;
+			const double b = ( yc * ss - ys * sc ) / determinant;
+
+			// The residual is everything other than the test tone.
+			double signal = 0;
+			double residual = 0;
+			for ( size_t frame = settleFrames; frame < frames - settleFrames; frame++ ) {
+				const double fit = a * sin( omega * static_cast<double>( frame ) ) + b * cos( omega * static_cast<double>( frame ) );
+				const double error = samples[ frame * channels ] - fit;
+				signal += fit * fit;
+				residual += error * error;
+			}
+			if ( ( signal > 0 ) && ( residual > 0 ) ) {
+				thdn = 10 * log10( residual / signal );
+			}
+		}
+	}
+	return thdn;
+}
+
+bool ResamplerBenchmark::WriteJSON( const Measurements& measurements, const std::wstring& outputFilename )
+{
+	nlohmann::json document;
+	for ( const auto& measurement : measurements ) {
+		nlohmann::json conversion;
+		conversion[ "x_realtime" ] = measurement.Throughput;
+		conversion[ "thdn_db" ] = measurement.THDN;
+		document[ measurement.Quality ][ std::to_string( measurement.InputRate ) + "-" + std::to_string( measurement.OutputRate ) ] = conversion;
+	}
+
+	return WriteBenchmarkJSON( document, outputFilename );
+}
+
+bool ResamplerBenchmark::WriteCSV( const Measurements& measurements, const std::wstring& outputFilename )
+{
+	return WriteBenchmarkCSV( outputFilename, "quality,input_rate,output_rate,x_realtime,thdn_db", [ &measurements ] ( std::ostream& stream )
+	{
+		for ( const auto& measurement : measurements ) {
+			stream << measurement.Quality << "," << measurement.InputRate << "," << measurement.OutputRate << "," << measurement.Throughput << "," << measurement.THDN << std::endl;
+		}
+	} );
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "stdafx.h"
+
+#include "BenchmarkUtility.h"
+#include "Settings.h"
+
+#include <string>
+#include <vector>
+
+// Measures resampler performance & quality, for each quality level over a set of common sample rate conversions.
+class ResamplerBenchmark
+{
+public:
+	ResamplerBenchmark();
+
+	virtual ~ResamplerBenchmark();
+
+	// Runs the benchmark.
+	// 'outputFilename' - results file, written as CSV if the file has a .csv extension, otherwise as JSON.
+	// Returns whether the results were written.
+	bool Run( const std::wstring& outputFilename ) const;
+
+private:
+	// Measurement for a quality level & sample rate conversion.
+	struct Measurement {
+		std::string Quality;				// Quality level.
+		long InputRate = 0;					// Input sample rate.
+		long OutputRate = 0;				// Output sample rate.
+		double Throughput = 0;			// Throughput, as a multiple of real time.
+		double THDN = 0;						// Total harmonic distortion plus noise, in dB relative to the test tone.
+	};
+
+	// A list of measurements.
+	using Measurements = std::vector<Measurement>;
+
+	// Measures the resampler for a 'quality' level, converting from the 'inputRate' to the 'outputRate'.
+	static Measurement Measure( const Settings::ResamplerQuality quality, const long inputRate, const long outputRate );
+
+	// Returns the THD+N, in dB, of a test tone at 'frequency' in the interleaved 'samples' (using the first channel only).
+	// 'channels' - number of channels.
+	// 'sampleRate' - sample rate.
+	static double CalculateTHDN( const std::vector<float>& samples, const long channels, const long sampleRate, const double frequency );
+
+	// Writes the 'measurements' as JSON to the 'outputFilename', returning whether the file was written.
+	static bool WriteJSON( const Measurements& measurements, const std::wstring& outputFilename );
+
+	// Writes the 'measurements' as CSV to the 'outputFilename', returning whether the file was written.
+	static bool WriteCSV( const Measurements& measurements, const std::wstring& outputFilename );
+};
@@ -0,0 +1,75 @@
+#include "RingBuffer.h"
+
+#include <algorithm>
+
+RingBuffer::RingBuffer( const size_t capacity ) :
+	m_Buffer( capacity ),
+	m_WriteIndex( 0 ),
+	m_ReadIndex( 0 )
+{
+}
+
+RingBuffer::~RingBuffer()
+{
+}
+
+void RingBuffer::Reset( const size_t capacity )
+{
+	m_Buffer.resize( capacity );
+	Clear();
+}
+
+void RingBuffer::Clear()
+{
+	m_WriteIndex.store( 0, std::memory_order_relaxed );
+	m_ReadIndex.store( 0, std::memory_order_release );
+}
+
+size_t RingBuffer::Write( const float* buffer, const size_t count )
+{
+	const size_t capacity = m_Buffer.size();
+	const size_t writeIndex = m_WriteIndex.load( std::memory_order_relaxed );
+	const size_t readIndex = m_ReadIndex.load( std::memory_order_acquire );
+	const size_t samplesToWrite = std::min<size_t>( count, capacity - ( writeIndex - readIndex ) );
+	if ( samplesToWrite > 0 ) {
+		const size_t offset = writeIndex % capacity;
+		const size_t firstPart = std::min<size_t>( samplesToWrite, capacity - offset );
+		std::copy( buffer, buffer + firstPart, m_Buffer.data() + offset );
+		std::copy( buffer + firstPart, buffer + samplesToWrite, m_Buffer.data() );
+		m_WriteIndex.store( writeIndex + samplesToWrite, std::memory_order_release );
+	}
+	return samplesToWrite;
+}
+
+size_t RingBuffer::Read( float* buffer, const size_t count )
+{
+	const size_t capacity = m_Buffer.size();
+	const size_t readIndex = m_ReadIndex.load( std::memory_order_relaxed );
+	const size_t writeIndex = m_WriteIndex.load( std::memory_order_acquire );
+	const size_t samplesToRead = std::min<size_t>( count, writeIndex - readIndex );
+	if ( samplesToRead > 0 ) {
+		const size_t offset = readIndex % capacity;
+		const size_t firstPart = std::min<size_t>( samplesToRead, capacity - offset );
+		std::copy( m_Buffer.data() + offset, m_Buffer.data() + offset + firstPart, buffer );
+		std::copy( m_Buffer.data(), m_Buffer.data() + samplesToRead - firstPart, buffer + firstPart );
+		m_ReadIndex.store( readIndex + samplesToRead, std::memory_order_release );
+	}
+	return samplesToRead;
+}
+
+size_t RingBuffer::GetReadAvailable() const
+{
+	const size_t readIndex = m_ReadIndex.load( std::memory_order_acquire );
+	const size_t writeIndex = m_WriteIndex.load( std::memory_order_acquire );
+	return writeIndex - readIndex;
+}
+
+size_t RingBuffer::GetWriteAvailable() const
+{
+	return m_Buffer.size() - GetReadAvailable();
+}
+
+size_t RingBuffer::GetCapacity() const
+{
+	return m_Buffer.size();
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+#ifdef _MSC_VER
+#pragma warning( push )
+#pragma warning( disable : 4324 ) // Structure was padded due to alignment specifier.
+#endif
+
+// Lock-free single producer, single consumer sample ring buffer.
+// Write() must only be called from the producer thread, and Read() must only be called from the consumer thread.
+// Neither call takes a lock or waits.
+class RingBuffer
+{
+public:
+	// 'capacity' - maximum number of samples that can be held.
+	explicit RingBuffer( const size_t capacity = 0 );
+
+	virtual ~RingBuffer();
+
+	// Resizes the buffer to hold 'capacity' samples, and discards any buffered samples.
+	// Must not be called concurrently with Read() or Write().
+	void Reset( const size_t capacity );
+
+	// Discards any buffered samples.
+	// Must not be called concurrently with Read() or Write().
+	void Clear();
+
+	// Writes samples to the buffer (producer thread only).
+	// 'buffer' - input samples.
+	// 'count' - number of samples to write.
+	// Returns the number of samples written, which is less than 'count' if the buffer is full.
+	size_t Write( const float* buffer, const size_t count );
+
+	// Reads samples from the buffer (consumer thread only).
+	// 'buffer' - output samples.
+	// 'count' - maximum number of samples to read.
+	// Returns the number of samples read, which is less than 'count' if the buffer is empty.
+	size_t Read( float* buffer, const size_t count );
+
+	// Returns the number of samples available to read.
+	size_t GetReadAvailable() const;
+
+	// Returns the number of samples that can be written.
+	size_t GetWriteAvailable() const;
+
+	// Returns the buffer capacity, in samples.
+	size_t GetCapacity() const;
+
+private:
+	// Assumed cache line size, used to keep the read & write indices apart.
+	static constexpr size_t kCacheLineSize = 64;
+
+	// Sample data.
+	std::vector<float> m_Buffer;
+
+	// Total number of samples written (only modified by the producer).
+	alignas( kCacheLineSize ) std::atomic<size_t> m_WriteIndex;
+
+	// Total number of samples read (only modified by the consumer).
+	alignas( kCacheLineSize ) std::atomic<size_t> m_ReadIndex;
+};
+
+#ifdef _MSC_VER
+#pragma warning( pop )
+#endif
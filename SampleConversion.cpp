@@ -0,0 +1,191 @@
+#include "SampleConversion.h"
+
+#if defined( _M_X64 ) || defined( _M_IX86 ) || defined( __SSE2__ )
+#define SAMPLECONVERSION_SSE2
+#include <emmintrin.h>
+#endif
+
+// Scale factor for signed 16-bit samples.
+constexpr float kScale16 = 1.0f / 0x8000;
+
+// Scale factor for signed 64-bit samples.
+constexpr float kScale64 = 1.0f / 0x8000000000000000ull;
+
+// Scale factor for unsigned 8-bit samples.
+constexpr float kScale8 = 1.0f / 0x80;
+
+// Interleaves planar sample data, using 'convert' to convert each sample.
+template <typename T, typename F>
+static void InterleavePlanes( const T* const* planes, const size_t channels, const size_t frames, float* output, const size_t startFrame, F convert )
+{
+	for ( size_t channel = 0; channel < channels; channel++ ) {
+		const T* input = planes[ channel ];
+		float* channelOutput = output + channel;
+		for ( size_t frame = startFrame; frame < frames; frame++ ) {
+			channelOutput[ frame * channels ] = convert( input[ frame ] );
+		}
+	}
+}
+
+#ifdef SAMPLECONVERSION_SSE2
+// Converts 4 signed 16-bit samples, in the low half of 'samples', to floating point.
+static inline __m128 Signed16x4ToFloat( const __m128i samples, const __m128 scale )
+{
+	return _mm_mul_ps( _mm_cvtepi32_ps( _mm_srai_epi32( _mm_unpacklo_epi16( samples, samples ), 16 ) ), scale );
+}
+#endif
+
+void ConvertUnsigned8ToFloat( const uint8_t* input, float* output, const size_t count )
+{
+	for ( size_t i = 0; i < count; i++ ) {
+		output[ i ] = static_cast<float>( static_cast<int>( input[ i ] ) - 0x80 ) * kScale8;
+	}
+}
+
+void ConvertSigned16ToFloat( const int16_t* input, float* output, const size_t count )
+{
+	size_t i = 0;
+#ifdef SAMPLECONVERSION_SSE2
+	const __m128 scale = _mm_set1_ps( kScale16 );
+	for ( ; ( i + 8 ) <= count; i += 8 ) {
+		const __m128i samples = _mm_loadu_si128( reinterpret_cast<const __m128i*>( input + i ) );
+		_mm_storeu_ps( output + i, Signed16x4ToFloat( samples, scale ) );
+		_mm_storeu_ps( output + i + 4, Signed16x4ToFloat( _mm_unpackhi_epi64( samples, samples ), scale ) );
+	}
+#endif
+	for ( ; i < count; i++ ) {
+		output[ i ] = static_cast<float>( input[ i ] ) * kScale16;
+	}
+}
+
+void ConvertSigned32ToFloat( const int32_t* input, float* output, const size_t count, const float scale )
+{
+	size_t i = 0;
+#ifdef SAMPLECONVERSION_SSE2
+	const __m128 scale4 = _mm_set1_ps( scale );
+	for ( ; ( i + 8 ) <= count; i += 8 ) {
+		const __m128i samples1 = _mm_loadu_si128( reinterpret_cast<const __m128i*>( input + i ) );
+		const __m128i samples2 = _mm_loadu_si128( reinterpret_cast<const __m128i*>( input + i + 4 ) );
+		_mm_storeu_ps( output + i, _mm_mul_ps( _mm_cvtepi32_ps( samples1 ), scale4 ) );
+		_mm_storeu_ps( output + i + 4, _mm_mul_ps( _mm_cvtepi32_ps( samples2 ), scale4 ) );
+	}
+#endif
+	for ( ; i < count; i++ ) {
+		output[ i ] = static_cast<float>( input[ i ] ) * scale;
+	}
+}
+
+void ConvertSigned64ToFloat( const int64_t* input, float* output, const size_t count )
+{
+	for ( size_t i = 0; i < count; i++ ) {
+		output[ i ] = static_cast<float>( input[ i ] ) * kScale64;
+	}
+}
+
+void ConvertDoubleToFloat( const double* input, float* output, const size_t count )
+{
+	size_t i = 0;
+#ifdef SAMPLECONVERSION_SSE2
+	for ( ; ( i + 4 ) <= count; i += 4 ) {
+		const __m128 lo = _mm_cvtpd_ps( _mm_loadu_pd( input + i ) );
+		const __m128 hi = _mm_cvtpd_ps( _mm_loadu_pd( input + i + 2 ) );
+		_mm_storeu_ps( output + i, _mm_movelh_ps( lo, hi ) );
+	}
+#endif
+	for ( ; i < count; i++ ) {
+		output[ i ] = static_cast<float>( input[ i ] );
+	}
+}
+
+void InterleaveUnsigned8ToFloat( const uint8_t* const* planes, const size_t channels, const size_t frames, float* output )
+{
+	if ( 1 == channels ) {
+		ConvertUnsigned8ToFloat( planes[ 0 ], output, frames );
+	} else {
+		InterleavePlanes( planes, channels, frames, output, 0, [] ( const uint8_t value ) { return static_cast<float>( static_cast<int>( value ) - 0x80 ) * kScale8; } );
+	}
+}
+
+void InterleaveSigned16ToFloat( const int16_t* const* planes, const size_t channels, const size_t frames, float* output )
+{
+	if ( 1 == channels ) {
+		ConvertSigned16ToFloat( planes[ 0 ], output, frames );
+	} else {
+		size_t frame = 0;
+#ifdef SAMPLECONVERSION_SSE2
+		if ( 2 == channels ) {
+			const __m128 scale = _mm_set1_ps( kScale16 );
+			const int16_t* left = planes[ 0 ];
+			const int16_t* right = planes[ 1 ];
+			for ( ; ( frame + 4 ) <= frames; frame += 4 ) {
+				const __m128 l = Signed16x4ToFloat( _mm_loadl_epi64( reinterpret_cast<const __m128i*>( left + frame ) ), scale );
+				const __m128 r = Signed16x4ToFloat( _mm_loadl_epi64( reinterpret_cast<const __m128i*>( right + frame ) ), scale );
+				_mm_storeu_ps( output + frame * 2, _mm_unpacklo_ps( l, r ) );
+				_mm_storeu_ps( output + frame * 2 + 4, _mm_unpackhi_ps( l, r ) );
+			}
+		}
+#endif
+		InterleavePlanes( planes, channels, frames, output, frame, [] ( const int16_t value ) { return static_cast<float>( value ) * kScale16; } );
+	}
+}
+
+void InterleaveSigned32ToFloat( const int32_t* const* planes, const size_t channels, const size_t frames, float* output, const float scale )
+{
+	if ( 1 == channels ) {
+		ConvertSigned32ToFloat( planes[ 0 ], output, frames, scale );
+	} else {
+		size_t frame = 0;
+#ifdef SAMPLECONVERSION_SSE2
+		if ( 2 == channels ) {
+			const __m128 scale4 = _mm_set1_ps( scale );
+			const int32_t* left = planes[ 0 ];
+			const int32_t* right = planes[ 1 ];
+			for ( ; ( frame + 4 ) <= frames; frame += 4 ) {
+				const __m128 l = _mm_mul_ps( _mm_cvtepi32_ps( _mm_loadu_si128( reinterpret_cast<const __m128i*>( left + frame ) ) ), scale4 );
+				const __m128 r = _mm_mul_ps( _mm_cvtepi32_ps( _mm_loadu_si128( reinterpret_cast<const __m128i*>( right + frame ) ) ), scale4 );
+				_mm_storeu_ps( output + frame * 2, _mm_unpacklo_ps( l, r ) );
+				_mm_storeu_ps( output + frame * 2 + 4, _mm_unpackhi_ps( l, r ) );
+			}
+		}
+#endif
+		InterleavePlanes( planes, channels, frames, output, frame, [ scale ] ( const int32_t value ) { return static_cast<float>( value ) * scale; } );
+	}
+}
+
+void InterleaveSigned64ToFloat( const int64_t* const* planes, const size_t channels, const size_t frames, float* output )
+{
+	InterleavePlanes( planes, channels, frames, output, 0, [] ( const int64_t value ) { return static_cast<float>( value ) * kScale64; } );
+}
+
+void InterleaveFloat( const float* const* planes, const size_t channels, const size_t frames, float* output )
+{
+	size_t frame = 0;
+	if ( 1 == channels ) {
+		const float* input = planes[ 0 ];
+		for ( ; frame < frames; frame++ ) {
+			output[ frame ] = input[ frame ];
+		}
+	}
+#ifdef SAMPLECONVERSION_SSE2
+	else if ( 2 == channels ) {
+		const float* left = planes[ 0 ];
+		const float* right = planes[ 1 ];
+		for ( ; ( frame + 4 ) <= frames; frame += 4 ) {
+			const __m128 l = _mm_loadu_ps( left + frame );
+			const __m128 r = _mm_loadu_ps( right + frame );
+			_mm_storeu_ps( output + frame * 2, _mm_unpacklo_ps( l, r ) );
+			_mm_storeu_ps( output + frame * 2 + 4, _mm_unpackhi_ps( l, r ) );
+		}
+	}
+#endif
+	InterleavePlanes( planes, channels, frames, output, frame, [] ( const float value ) { return value; } );
+}
+
+void InterleaveDoubleToFloat( const double* const* planes, const size_t channels, const size_t frames, float* output )
+{
+	if ( 1 == channels ) {
+		ConvertDoubleToFloat( planes[ 0 ], output, frames );
+	} else {
+		InterleavePlanes( planes, channels, frames, output, 0, [] ( const double value ) { return static_cast<float>( value ); } );
+	}
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Sample conversion kernels, which convert integer (or double precision) sample data to floating point samples in the range -1.0 to +1.0.
+// Output buffers must be pre-sized by the caller to hold the converted samples.
+// SSE2 implementations are used where available, with scalar implementations otherwise.
+
+// Converts 'count' unsigned 8-bit samples from 'input' into 'output'.
+void ConvertUnsigned8ToFloat( const uint8_t* input, float* output, const size_t count );
+
+// Converts 'count' signed 16-bit samples from 'input' into 'output'.
+void ConvertSigned16ToFloat( const int16_t* input, float* output, const size_t count );
+
+// Converts 'count' signed 32-bit samples from 'input' into 'output'.
+// 'scale' - multiplier to apply to each sample (e.g. 1/(2^23) for 24-bit samples stored in 32-bit values).
+void ConvertSigned32ToFloat( const int32_t* input, float* output, const size_t count, const float scale = 1.0f / 0x80000000ul );
+
+// Converts 'count' signed 64-bit samples from 'input' into 'output'.
+void ConvertSigned64ToFloat( const int64_t* input, float* output, const size_t count );
+
+// Converts 'count' double precision samples from 'input' into 'output'.
+void ConvertDoubleToFloat( const double* input, float* output, const size_t count );
+
+// Interleaves planar unsigned 8-bit sample data.
+// 'planes' - input sample data, one plane per channel.
+// 'channels' - number of channels.
+// 'frames' - number of samples per channel.
+// 'output' - interleaved output, which must hold 'channels' * 'frames' samples.
+void InterleaveUnsigned8ToFloat( const uint8_t* const* planes, const size_t channels, const size_t frames, float* output );
+
+// Interleaves planar signed 16-bit sample data.
+// 'planes' - input sample data, one plane per channel.
+// 'channels' - number of channels.
+// 'frames' - number of samples per channel.
+// 'output' - interleaved output, which must hold 'channels' * 'frames' samples.
+void InterleaveSigned16ToFloat( const int16_t* const* planes, const size_t channels, const size_t frames, float* output );
+
+// Interleaves planar signed 32-bit sample data.
+// 'planes' - input sample data, one plane per channel.
+// 'channels' - number of channels.
+// 'frames' - number of samples per channel.
+// 'output' - interleaved output, which must hold 'channels' * 'frames' samples.
+// 'scale' - multiplier to apply to each sample (e.g. 1/(2^23) for 24-bit samples stored in 32-bit values).
+void InterleaveSigned32ToFloat( const int32_t* const* planes, const size_t channels, const size_t frames, float* output, const float scale = 1.0f / 0x80000000ul );
+
+// Interleaves planar signed 64-bit sample data.
+// 'planes' - input sample data, one plane per channel.
+// 'channels' - number of channels.
+// 'frames' - number of samples per channel.
+// 'output' - interleaved output, which must hold 'channels' * 'frames' samples.
+void InterleaveSigned64ToFloat( const int64_t* const* planes, const size_t channels, const size_t frames, float* output );
+
+// Interleaves planar floating point sample data.
+// 'planes' - input sample data, one plane per channel.
+// 'channels' - number of channels.
+// 'frames' - number of samples per channel.
+// 'output' - interleaved output, which must hold 'channels' * 'frames' samples.
+void InterleaveFloat( const float* const* planes, const size_t channels, const size_t frames, float* output );
+
+// Interleaves planar double precision sample data.
+// 'planes' - input sample data, one plane per channel.
+// 'channels' - number of channels.
+// 'frames' - number of samples per channel.
+// 'output' - interleaved output, which must hold 'channels' * 'frames' samples.
+void InterleaveDoubleToFloat( const double* const* planes, const size_t channels, const size_t frames, float* output );
@@ -0,0 +1,109 @@
+#include "SampleProcessing.h"
+
+#if defined( _M_X64 ) || defined( _M_IX86 ) || defined( __SSE2__ )
+#define SAMPLEPROCESSING_SSE2
+#include <emmintrin.h>
+#endif
+
+// Returns the ramp factor, treating values outside the range 0 to 1 as 0.
+static inline float RampFactor( const float ramp )
+{
+	return ( ( ramp < 0 ) || ( ramp > 1.0f ) ) ? 0 : ramp;
+}
+
+#ifdef SAMPLEPROCESSING_SSE2
+// Returns the ramp factors, treating values outside the range 0 to 1 as 0.
+static inline __m128 RampFactor( const __m128 ramp )
+{
+	const __m128 inRange = _mm_and_ps( _mm_cmpge_ps( ramp, _mm_setzero_ps() ), _mm_cmple_ps( ramp, _mm_set1_ps( 1.0f ) ) );
+	return _mm_and_ps( ramp, inRange );
+}
+#endif
+
+// Calls 'vectorOp( sampleIndex, factors )' for groups of 4 samples, and 'scalarOp( sampleIndex, factor )' for any remaining samples, where the factors are the ramp factors for each sample.
+// The ramp factor for each frame is calculated directly from the frame index, so the vector & scalar paths produce identical results.
+template <typename V, typename S>
+static void ForEachRampedSample( const size_t channels, const size_t frames, const float rampStart, const float rampStep, V vectorOp, S scalarOp )
+{
+	size_t frame = 0;
+#ifdef SAMPLEPROCESSING_SSE2
+	const __m128 start = _mm_set1_ps( rampStart );
+	const __m128 step = _mm_set1_ps( rampStep );
+	if ( ( 1 == channels ) || ( 2 == channels ) || ( 4 == channels ) ) {
+		// Each group of 4 samples spans one or more whole frames.
+		const size_t framesPerGroup = 4 / channels;
+		__m128 frameIndex = ( 1 == channels ) ? _mm_setr_ps( 0, 1.0f, 2.0f, 3.0f ) : ( ( 2 == channels ) ? _mm_setr_ps( 0, 0, 1.0f, 1.0f ) : _mm_setzero_ps() );
+		const __m128 frameIncrement = _mm_set1_ps( static_cast<float>( framesPerGroup ) );
+		for ( ; ( frame + framesPerGroup ) <= frames; frame += framesPerGroup ) {
+			vectorOp( frame * channels, RampFactor( _mm_add_ps( start, _mm_mul_ps( step, frameIndex ) ) ) );
+			frameIndex = _mm_add_ps( frameIndex, frameIncrement );
+		}
+	} else if ( channels > 4 ) {
+		// Each frame spans one or more groups of 4 samples.
+		for ( ; frame < frames; frame++ ) {
+			const float factor = RampFactor( rampStart + rampStep * static_cast<float>( frame ) );
+			const __m128 factors = _mm_set1_ps( factor );
+			size_t channel = 0;
+			for ( ; ( channel + 4 ) <= channels; channel += 4 ) {
+				vectorOp( frame * channels + channel, factors );
+			}
+			for ( ; channel < channels; channel++ ) {
+				scalarOp( frame * channels + channel, factor );
+			}
+		}
+	}
+#else
+	static_cast<void>( vectorOp );
+#endif
+	for ( ; frame < frames; frame++ ) {
+		const float factor = RampFactor( rampStart + rampStep * static_cast<float>( frame ) );
+		for ( size_t channel = 0; channel < channels; channel++ ) {
+			scalarOp( frame * channels + channel, factor );
+		}
+	}
+}
+
+void ApplyGainRamp( float* buffer, const size_t channels, const size_t frames, const float scale, const float rampStart, const float rampStep, const bool hardClip )
+{
+#ifdef SAMPLEPROCESSING_SSE2
+	const __m128 scale4 = _mm_set1_ps( scale );
+	const __m128 min4 = _mm_set1_ps( -1.0f );
+	const __m128 max4 = _mm_set1_ps( 1.0f );
+	const auto vectorOp = [ buffer, scale4, min4, max4, hardClip ] ( const size_t index, const __m128 factors )
+	{
+		__m128 samples = _mm_mul_ps( _mm_loadu_ps( buffer + index ), _mm_mul_ps( scale4, factors ) );
+		if ( hardClip ) {
+			samples = _mm_min_ps( _mm_max_ps( samples, min4 ), max4 );
+		}
+		_mm_storeu_ps( buffer + index, samples );
+	};
+#else
+	const auto vectorOp = [] ( const size_t, const float ) {};
+#endif
+	const auto scalarOp = [ buffer, scale, hardClip ] ( const size_t index, const float factor )
+	{
+		float sample = buffer[ index ] * ( scale * factor );
+		if ( hardClip ) {
+			sample = ( sample < -1.0f ) ? -1.0f : ( ( sample > 1.0f ) ? 1.0f : sample );
+		}
+		buffer[ index ] = sample;
+	};
+	ForEachRampedSample( channels, frames, rampStart, rampStep, vectorOp, scalarOp );
+}
+
+void MixRamp( float* output, const float* input, const size_t channels, const size_t frames, const float rampStart, const float rampStep )
+{
+#ifdef SAMPLEPROCESSING_SSE2
+	const auto vectorOp = [ output, input ] ( const size_t index, const __m128 factors )
+	{
+		_mm_storeu_ps( output + index, _mm_add_ps( _mm_loadu_ps( output + index ), _mm_mul_ps( _mm_loadu_ps( input + index ), factors ) ) );
+	};
+#else
+	const auto vectorOp = [] ( const size_t, const float ) {};
+#endif
+	const auto scalarOp = [ output, input ] ( const size_t index, const float factor )
+	{
+		output[ index ] += input[ index ] * factor;
+	};
+	ForEachRampedSample( channels, frames, rampStart, rampStep, vectorOp, scalarOp );
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+
+// Sample processing kernels, which operate in place on interleaved floating point sample data with any number of channels.
+// SSE2 implementations are used where available, with scalar implementations otherwise.
+// A ramp is a per-frame scale factor which changes linearly from 'rampStart' (for the first frame) by 'rampStep' for each subsequent frame.
+// Ramp factors outside the range 0 to 1 are treated as 0 (so that a completed fade out results in silence).
+
+// Applies gain, a ramp and (optionally) a hard clip to interleaved sample data, in a single pass.
+// 'buffer' - in/out, interleaved sample data.
+// 'channels' - number of channels.
+// 'frames' - number of samples per channel.
+// 'scale' - gain scale factor.
+// 'rampStart' - ramp factor for the first frame.
+// 'rampStep' - ramp factor increment per frame.
+// 'hardClip' - whether to clip the output to the range -1.0 to +1.0.
+void ApplyGainRamp( float* buffer, const size_t channels, const size_t frames, const float scale, const float rampStart, const float rampStep, const bool hardClip );
+
+// Mixes interleaved sample data from 'input' into 'output', applying a ramp to the 'input'.
+// 'output' - in/out, interleaved sample data.
+// 'input' - interleaved sample data to mix in.
+// 'channels' - number of channels.
+// 'frames' - number of samples per channel.
+// 'rampStart' - ramp factor for the first frame.
+// 'rampStep' - ramp factor increment per frame.
+void MixRamp( float* output, const float* input, const size_t channels, const size_t frames, const float rampStart, const float rampStep );
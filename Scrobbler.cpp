@@ -290,7 +290,7 @@ void Scrobbler::ReadCachedScrobbles()
 		// Read in the remaining cached scrobbles.
 		sqlite3_stmt* stmt = nullptr;
 		const std::string selectQuery = "SELECT Timestamp, Artist, Title, Album, Track, Duration FROM Scrobbles;";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, selectQuery.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
+		if ( SQLITE_OK == m_Database.PrepareStatement( selectQuery, &stmt ) ) {
 			while ( SQLITE_ROW == sqlite3_step( stmt ) ) {
 				const time_t timestamp = sqlite3_column_int64( stmt, 0 /*columnIndex*/ );
 				TrackInfo info = {};
@@ -312,7 +312,7 @@ void Scrobbler::ReadCachedScrobbles()
 					m_PendingScrobbles.insert( PendingScrobbles::value_type( timestamp, info ) );
 				}
 			}
-			sqlite3_finalize( stmt );
+			m_Database.ReleaseStatement( stmt );
 			stmt = nullptr;
 		}
 	}
@@ -356,6 +356,7 @@ void Scrobbler::SaveCachedScrobbles()
 					const std::string dropTableQuery = "DROP TABLE Scrobbles;";
 					sqlite3_exec( database, dropTableQuery.c_str(), NULL /*callback*/, NULL /*arg*/, NULL /*errMsg*/ );
 					sqlite3_exec( database, scrobblerTableQuery.c_str(), NULL /*callback*/, NULL /*arg*/, NULL /*errMsg*/ );
+					m_Database.ClearStatementCache();
 				}
 			}
 
@@ -384,7 +385,7 @@ void Scrobbler::SaveCachedScrobbles()
 
 				// Insert any pending scrobbles that are not already cached.
 				const std::string insertQuery = "INSERT OR IGNORE INTO Scrobbles (Timestamp,Artist,Title,Album,Track,Duration) VALUES (?1,?2,?3,?4,?5,?6);";
-				if ( SQLITE_OK == sqlite3_prepare_v2( database, insertQuery.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
+				if ( SQLITE_OK == m_Database.PrepareStatement( insertQuery, &stmt ) ) {
 					for ( const auto& scrobble : m_PendingScrobbles ) {
 						const time_t timestamp = scrobble.first;
 						const TrackInfo& info = scrobble.second;
@@ -397,7 +398,7 @@ void Scrobbler::SaveCachedScrobbles()
 						sqlite3_step( stmt );
 						sqlite3_reset( stmt );
 					}
-					sqlite3_finalize( stmt );
+					m_Database.ReleaseStatement( stmt );
 					stmt = nullptr;
 				}
 			}
@@ -412,13 +413,13 @@ void Scrobbler::RemovePendingScrobbles( const Timestamps& timestamps )
 		if ( nullptr != database ) {
 			sqlite3_stmt* stmt = nullptr;
 			const std::string dropQuery = "DELETE FROM Scrobbles WHERE Timestamp == ?1;";
-			if ( SQLITE_OK == sqlite3_prepare_v2( database, dropQuery.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
+			if ( SQLITE_OK == m_Database.PrepareStatement( dropQuery, &stmt ) ) {
 				for ( const auto& timestamp : timestamps ) {
 					sqlite3_bind_int64( stmt, 1, timestamp );
 					sqlite3_step( stmt );
 					sqlite3_reset( stmt );
 				}
-				sqlite3_finalize( stmt );
+				m_Database.ReleaseStatement( stmt );
 				stmt = nullptr;
 			}
 		}
@@ -0,0 +1,52 @@
+#include "SeekIndex.h"
+
+#include <algorithm>
+
+SeekIndex::SeekIndex( const Entries& entries ) :
+	m_Entries( entries )
+{
+}
+
+SeekIndex::SeekIndex( const std::vector<BYTE>& data ) :
+	m_Entries( data.size() / sizeof( Entry ) )
+{
+	if ( !m_Entries.empty() ) {
+		memcpy( m_Entries.data(), data.data(), m_Entries.size() * sizeof( Entry ) );
+	}
+}
+
+SeekIndex::~SeekIndex()
+{
+}
+
+std::optional<SeekIndex::Entry> SeekIndex::Find( const double seconds ) const
+{
+	std::optional<Entry> entry;
+	const auto iter = std::upper_bound( m_Entries.begin(), m_Entries.end(), seconds, [] ( const double position, const Entry& syncPoint )
+	{
+		return position < syncPoint.Seconds;
+	} );
+	if ( m_Entries.begin() != iter ) {
+		entry = *std::prev( iter );
+	}
+	return entry;
+}
+
+bool SeekIndex::IsEmpty() const
+{
+	return m_Entries.empty();
+}
+
+const SeekIndex::Entries& SeekIndex::GetEntries() const
+{
+	return m_Entries;
+}
+
+std::vector<BYTE> SeekIndex::GetData() const
+{
+	std::vector<BYTE> data( m_Entries.size() * sizeof( Entry ) );
+	if ( !data.empty() ) {
+		memcpy( data.data(), m_Entries.data(), data.size() );
+	}
+	return data;
+}
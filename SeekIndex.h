@@ -0,0 +1,48 @@
+#pragma once
+
+#include "stdafx.h"
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+// Maps stream positions to the byte offsets of sync points, so that a decoder can seek directly to the nearest sync point.
+class SeekIndex
+{
+public:
+	// Seek index shared pointer type.
+	using Ptr = std::shared_ptr<const SeekIndex>;
+
+	// A sync point.
+	struct Entry {
+		double Seconds = 0;		// Stream position, in seconds.
+		long long Offset = 0;	// Byte offset in the file.
+	};
+
+	// A list of sync points, in increasing stream position order.
+	using Entries = std::vector<Entry>;
+
+	// 'entries' - sync points, in increasing stream position order.
+	SeekIndex( const Entries& entries );
+
+	// 'data' - seek index data, as returned by GetData.
+	SeekIndex( const std::vector<BYTE>& data );
+
+	virtual ~SeekIndex();
+
+	// Returns the sync point at or immediately before the 'seconds' position, or nullopt if there is no such sync point.
+	std::optional<Entry> Find( const double seconds ) const;
+
+	// Returns whether the index contains any sync points.
+	bool IsEmpty() const;
+
+	// Returns the sync points.
+	const Entries& GetEntries() const;
+
+	// Returns the seek index as data, for persisting to the media library.
+	std::vector<BYTE> GetData() const;
+
+private:
+	// Sync points.
+	Entries m_Entries;
+};
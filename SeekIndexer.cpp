@@ -0,0 +1,76 @@
+#include "SeekIndexer.h"
+
+#include "Utility.h"
+
+// The minimum duration of a file for which to generate a seek index, in seconds.
+constexpr float kMinDuration = 300.0f;
+
+SeekIndexer::SeekIndexer( Library& library, const Handlers& handlers, TaskScheduler& scheduler ) :
+	m_Library( library ),
+	m_Handlers( handlers ),
+	m_Scheduler( scheduler ),
+	m_Stopped( false ),
+	m_Pending(),
+	m_Mutex(),
+	m_TaskGroup()
+{
+}
+
+SeekIndexer::~SeekIndexer()
+{
+	Stop();
+}
+
+void SeekIndexer::Add( const MediaInfo& mediaInfo )
+{
+	const std::wstring& filename = mediaInfo.GetFilename();
+	if ( ( MediaInfo::Source::File == mediaInfo.GetSource() ) && !IsURL( filename ) && ( mediaInfo.GetDuration() >= kMinDuration ) ) {
+		std::lock_guard<std::mutex> lock( m_Mutex );
+		if ( !m_Stopped && m_Pending.insert( filename ).second ) {
+			m_Scheduler.Submit( m_TaskGroup, TaskScheduler::Priority::Analysis, [ this, mediaInfo ] ()
+			{
+				Index( mediaInfo );
+			} );
+		}
+	}
+}
+
+void SeekIndexer::Stop()
+{
+	// The stopped flag is set under the lock, so that no further tasks can be submitted once the group has been cancelled.
+	{
+		std::lock_guard<std::mutex> lock( m_Mutex );
+		m_Stopped = true;
+	}
+	m_TaskGroup.Cancel();
+}
+
+bool SeekIndexer::CanContinue() const
+{
+	return !m_Stopped && !m_TaskGroup.IsCancelled();
+}
+
+void SeekIndexer::Index( const MediaInfo& mediaInfo )
+{
+	const std::wstring& filename = mediaInfo.GetFilename();
+	bool indexable = true;
+	if ( CanContinue() && !m_Library.GetSeekIndex( mediaInfo, indexable ) && indexable ) {
+		// Files which cannot be indexed are marked as such (until the file changes), so that they are not reopened & scanned each time they are played.
+		// Files which cannot be opened are not marked, as the failure might only be temporary.
+		if ( const Decoder::Ptr decoder = m_Handlers.OpenDecoder( filename ); decoder ) {
+			const Decoder::CanContinue canContinue( [ this ] ()
+			{
+				return CanContinue();
+			} );
+			const SeekIndex::Ptr seekIndex = decoder->SupportsSeekIndex() ? decoder->GenerateSeekIndex( canContinue ) : nullptr;
+			if ( seekIndex ) {
+				m_Library.SetSeekIndex( mediaInfo, *seekIndex );
+			} else if ( CanContinue() ) {
+				m_Library.SetSeekIndexUnavailable( mediaInfo );
+			}
+		}
+	}
+
+	std::lock_guard<std::mutex> lock( m_Mutex );
+	m_Pending.erase( filename );
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "stdafx.h"
+
+#include "Handlers.h"
+#include "Library.h"
+#include "MediaInfo.h"
+#include "TaskScheduler.h"
+
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <string>
+
+// Generates seek indices in the background, storing them in the media library.
+class SeekIndexer
+{
+public:
+	// 'library' - media library.
+	// 'handlers' - media handlers.
+	// 'scheduler' - task scheduler on which to generate the seek indices.
+	SeekIndexer( Library& library, const Handlers& handlers, TaskScheduler& scheduler = TaskScheduler::GetBackground() );
+
+	virtual ~SeekIndexer();
+
+	// Adds the 'mediaInfo' to the queue of files for which to generate a seek index (if the file is long enough to benefit from one).
+	void Add( const MediaInfo& mediaInfo );
+
+	// Stops any pending seek index generation.
+	void Stop();
+
+private:
+	// Generates a seek index for the 'mediaInfo', or marks the file as not indexable if the decoder cannot generate one.
+	void Index( const MediaInfo& mediaInfo );
+
+	// Returns whether seek index generation can continue.
+	bool CanContinue() const;
+
+	// Media library.
+	Library& m_Library;
+
+	// Media handlers.
+	const Handlers& m_Handlers;
+
+	// Task scheduler.
+	TaskScheduler& m_Scheduler;
+
+	// Indicates whether seek index generation has been stopped.
+	std::atomic<bool> m_Stopped;
+
+	// The filenames which are queued, or currently being indexed.
+	std::set<std::wstring> m_Pending;
+
+	// The mutex for the pending filenames.
+	std::mutex m_Mutex;
+
+	// Seek index tasks.
+	TaskScheduler::Group m_TaskGroup;
+};
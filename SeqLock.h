@@ -0,0 +1,80 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// Publishes a small, trivially copyable value from a single writer to any number of readers, using a sequence lock.
+// The writer never blocks, and readers never take a lock (a reader which overlaps with a write simply retries).
+// The value is held as atomic words, so that concurrent reads & writes of the value itself are well defined.
+template <typename T>
+class SeqLock
+{
+	static_assert( std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>, "SeqLock value must be trivially copyable" );
+
+public:
+	SeqLock() :
+		m_Sequence( 0 ),
+		m_Words()
+	{
+		Store( T() );
+	}
+
+	virtual ~SeqLock()
+	{
+	}
+
+	SeqLock( const SeqLock& ) = delete;
+	SeqLock& operator=( const SeqLock& ) = delete;
+
+	// Publishes the 'value' (there must only be one writer at a time).
+	void Store( const T& value )
+	{
+		Words words = {};
+		std::memcpy( words.data(), &value, sizeof( T ) );
+
+		// An odd sequence number indicates that a write is in progress.
+		const uint64_t sequence = m_Sequence.load( std::memory_order_relaxed );
+		m_Sequence.store( sequence + 1, std::memory_order_relaxed );
+		std::atomic_thread_fence( std::memory_order_release );
+		for ( size_t index = 0; index < kWordCount; index++ ) {
+			m_Words[ index ].store( words[ index ], std::memory_order_relaxed );
+		}
+		m_Sequence.store( sequence + 2, std::memory_order_release );
+	}
+
+	// Returns the most recently published value.
+	T Load() const
+	{
+		Words words = {};
+		uint64_t before = 0;
+		uint64_t after = 0;
+		do {
+			before = m_Sequence.load( std::memory_order_acquire );
+			for ( size_t index = 0; index < kWordCount; index++ ) {
+				words[ index ] = m_Words[ index ].load( std::memory_order_relaxed );
+			}
+			std::atomic_thread_fence( std::memory_order_acquire );
+			after = m_Sequence.load( std::memory_order_relaxed );
+		} while ( ( before & 1 ) || ( before != after ) );
+
+		T value;
+		std::memcpy( &value, words.data(), sizeof( T ) );
+		return value;
+	}
+
+private:
+	// Number of words required to hold the value.
+	static constexpr size_t kWordCount = ( sizeof( T ) + sizeof( uint64_t ) - 1 ) / sizeof( uint64_t );
+
+	// Value storage, as plain words.
+	using Words = std::array<uint64_t, kWordCount>;
+
+	// Sequence number, which is odd while a write is in progress.
+	std::atomic<uint64_t> m_Sequence;
+
+	// Value storage.
+	std::array<std::atomic<uint64_t>, kWordCount> m_Words;
+};
@@ -1,12 +1,17 @@
 #include "Settings.h"
 
+#include "Limiter.h"
 #include "Utility.h"
 #include "VUMeter.h"
 #include "VUPlayer.h"
 
 #include "json.hpp"
 
+#include <algorithm>
 #include <array>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
 
 // Pitch ranges
 const Settings::PitchRangeMap Settings::s_PitchRanges = {
@@ -25,18 +30,353 @@ const Settings::ButtonSizeMap Settings::s_ButtonSizes = {
 // Default conversion/extraction filename format.
 static const wchar_t s_DefaultExtractFilename[] = L"%A\\%D\\%N - %T";
 
+// Default maximum number of decoders to preload.
+constexpr long kPreloadWindowSizeDefault = 4;
+
+// Default number of upcoming items to preload when random play is enabled.
+constexpr long kPreloadShuffleCandidatesDefault = 2;
+
+// Allowed range for the preload window size & number of shuffle candidates.
+constexpr long kPreloadCountMinimum = 1;
+constexpr long kPreloadCountMaximum = 16;
+
+// Default maximum pre-buffer memory per decoder, in MB.
+constexpr long kPreloadMemoryLimitDefault = 16;
+
+// Allowed range for the maximum pre-buffer memory per decoder, in MB.
+constexpr long kPreloadMemoryLimitMinimum = 1;
+constexpr long kPreloadMemoryLimitMaximum = 256;
+
+// Default decode-ahead memory ceiling, in MB.
+constexpr long kDecodeAheadMemoryLimitDefault = 512;
+
+// Allowed range for the decode-ahead memory ceiling, in MB.
+constexpr long kDecodeAheadMemoryLimitMinimum = 32;
+constexpr long kDecodeAheadMemoryLimitMaximum = 1024;
+
+// Interval at which changed settings are written to the database, in milliseconds.
+constexpr DWORD kFlushInterval = 5000;
+
 Settings::Settings( Database& database, Library& library, const std::string& settings ) :
 	m_Database( database ),
-	m_Library( library )
+	m_Library( library ),
+	m_Values(),
+	m_PersistedValues(),
+	m_PersistedVersion( 0 ),
+	m_FlushMutex(),
+	m_FlushThread( nullptr ),
+	m_FlushStopEvent( CreateEvent( NULL /*attributes*/, TRUE /*manualReset*/, FALSE /*initialState*/, L"" /*name*/ ) )
 {
 	UpdateDatabase();
 	if ( !settings.empty() ) {
 		ImportSettings( settings );
 	}
+	LoadValues();
+	StartFlushThread();
 }
 
 Settings::~Settings()
 {
+	StopFlushThread();
+	Flush();
+	CloseHandle( m_FlushStopEvent );
+}
+
+Settings::Value::Value() :
+	m_Type( SQLITE_NULL ),
+	m_Integer( 0 ),
+	m_Float( 0 ),
+	m_Bytes()
+{
+}
+
+int Settings::Value::GetType() const
+{
+	return m_Type;
+}
+
+int Settings::Value::GetInt() const
+{
+	return static_cast<int>( m_Integer );
+}
+
+long long Settings::Value::GetInt64() const
+{
+	return m_Integer;
+}
+
+double Settings::Value::GetDouble() const
+{
+	return m_Float;
+}
+
+const unsigned char* Settings::Value::GetText() const
+{
+	return ( SQLITE_NULL == m_Type ) ? nullptr : reinterpret_cast<const unsigned char*>( m_Bytes.c_str() );
+}
+
+const void* Settings::Value::GetBlob() const
+{
+	return m_Bytes.empty() ? nullptr : m_Bytes.data();
+}
+
+int Settings::Value::GetBytes() const
+{
+	return static_cast<int>( m_Bytes.size() );
+}
+
+void Settings::Value::SetInt( const int value )
+{
+	SetInt64( value );
+}
+
+void Settings::Value::SetInt64( const long long value )
+{
+	m_Type = SQLITE_INTEGER;
+	m_Integer = value;
+	m_Float = static_cast<double>( value );
+	m_Bytes = std::to_string( value );
+}
+
+void Settings::Value::SetDouble( const double value )
+{
+	m_Type = SQLITE_FLOAT;
+	m_Float = value;
+	constexpr double kMinInteger = static_cast<double>( ( std::numeric_limits<long long>::min )() );
+	constexpr double kMaxInteger = static_cast<double>( ( std::numeric_limits<long long>::max )() );
+	if ( std::isnan( value ) ) {
+		m_Integer = 0;
+	} else if ( value <= kMinInteger ) {
+		m_Integer = ( std::numeric_limits<long long>::min )();
+	} else if ( value >= kMaxInteger ) {
+		m_Integer = ( std::numeric_limits<long long>::max )();
+	} else {
+		m_Integer = static_cast<long long>( value );
+	}
+	// Format the text representation in the same way as SQLite.
+	char text[ 32 ] = {};
+	sqlite3_snprintf( static_cast<int>( std::size( text ) ), text, "%!.15g", value );
+	m_Bytes = text;
+}
+
+void Settings::Value::SetText( const std::string& value )
+{
+	m_Type = SQLITE_TEXT;
+	m_Bytes = value;
+	m_Integer = std::strtoll( m_Bytes.c_str(), nullptr /*end*/, 10 /*base*/ );
+	m_Float = std::strtod( m_Bytes.c_str(), nullptr /*end*/ );
+}
+
+void Settings::Value::SetBlob( const void* data, const int bytes )
+{
+	m_Type = SQLITE_BLOB;
+	m_Bytes.assign( static_cast<const char*>( data ), ( nullptr != data ) ? std::max<int>( 0, bytes ) : 0 );
+	m_Integer = std::strtoll( m_Bytes.c_str(), nullptr /*end*/, 10 /*base*/ );
+	m_Float = std::strtod( m_Bytes.c_str(), nullptr /*end*/ );
+}
+
+int Settings::Value::Bind( sqlite3_stmt* stmt, const int index ) const
+{
+	int result = SQLITE_MISUSE;
+	switch ( m_Type ) {
+		case SQLITE_INTEGER : {
+			result = sqlite3_bind_int64( stmt, index, m_Integer );
+			break;
+		}
+		case SQLITE_FLOAT : {
+			result = sqlite3_bind_double( stmt, index, m_Float );
+			break;
+		}
+		case SQLITE_TEXT : {
+			result = sqlite3_bind_text( stmt, index, m_Bytes.c_str(), static_cast<int>( m_Bytes.size() ), SQLITE_TRANSIENT );
+			break;
+		}
+		case SQLITE_BLOB : {
+			result = sqlite3_bind_blob( stmt, index, m_Bytes.data(), static_cast<int>( m_Bytes.size() ), SQLITE_TRANSIENT );
+			break;
+		}
+		default : {
+			result = sqlite3_bind_null( stmt, index );
+			break;
+		}
+	}
+	return result;
+}
+
+bool Settings::Value::operator==( const Value& other ) const
+{
+	return ( m_Type == other.m_Type ) && ( m_Bytes == other.m_Bytes ) && ( m_Integer == other.m_Integer ) && ( std::isnan( m_Float ) ? std::isnan( other.m_Float ) : ( m_Float == other.m_Float ) );
+}
+
+Settings::Values::Values() :
+	m_Mutex(),
+	m_Values(),
+	m_Version( 0 ),
+	m_Snapshot(),
+	m_SnapshotVersion( 0 )
+{
+}
+
+Settings::Values::~Values()
+{
+}
+
+Settings::Values::Ptr Settings::Values::Get() const
+{
+	// The lock is only taken if the settings have changed since the snapshot was last published.
+	// A thread which has changed a setting always sees its own change, as the version is incremented before the setter returns.
+	if ( m_Version.load() != m_SnapshotVersion.load() ) {
+		std::lock_guard<std::mutex> lock( m_Mutex );
+		Publish();
+	}
+	return m_Snapshot.Get();
+}
+
+Settings::Values::Ptr Settings::Values::Get( uint64_t& version ) const
+{
+	std::lock_guard<std::mutex> lock( m_Mutex );
+	Publish();
+	version = m_SnapshotVersion.load();
+	return m_Snapshot.Get();
+}
+
+uint64_t Settings::Values::Set( ValueMap values )
+{
+	std::lock_guard<std::mutex> lock( m_Mutex );
+	m_Values = std::move( values );
+	++m_Version;
+	Publish();
+	return m_Version.load();
+}
+
+uint64_t Settings::Values::GetVersion() const
+{
+	return m_Version.load();
+}
+
+void Settings::Values::Publish() const
+{
+	if ( const uint64_t version = m_Version.load(); version != m_SnapshotVersion.load() ) {
+		m_Snapshot.Set( m_Values );
+		m_SnapshotVersion.store( version );
+	}
+}
+
+void Settings::LoadValues()
+{
+	ValueMap values;
+	sqlite3* database = m_Database.GetDatabase();
+	if ( nullptr != database ) {
+		sqlite3_stmt* stmt = nullptr;
+		const std::string query = "SELECT Setting, Value FROM Settings;";
+		if ( SQLITE_OK == m_Database.PrepareStatement( query, &stmt ) ) {
+			while ( SQLITE_ROW == sqlite3_step( stmt ) ) {
+				const unsigned char* name = sqlite3_column_text( stmt, 0 /*columnIndex*/ );
+				if ( nullptr != name ) {
+					Value value;
+					switch ( sqlite3_column_type( stmt, 1 /*columnIndex*/ ) ) {
+						case SQLITE_INTEGER : {
+							value.SetInt64( sqlite3_column_int64( stmt, 1 /*columnIndex*/ ) );
+							break;
+						}
+						case SQLITE_FLOAT : {
+							value.SetDouble( sqlite3_column_double( stmt, 1 /*columnIndex*/ ) );
+							break;
+						}
+						case SQLITE_TEXT : {
+							const unsigned char* text = sqlite3_column_text( stmt, 1 /*columnIndex*/ );
+							const int bytes = sqlite3_column_bytes( stmt, 1 /*columnIndex*/ );
+							value.SetText( ( nullptr != text ) ? std::string( reinterpret_cast<const char*>( text ), bytes ) : std::string() );
+							break;
+						}
+						case SQLITE_BLOB : {
+							const void* blob = sqlite3_column_blob( stmt, 1 /*columnIndex*/ );
+							const int bytes = sqlite3_column_bytes( stmt, 1 /*columnIndex*/ );
+							value.SetBlob( blob, bytes );
+							break;
+						}
+						default : {
+							break;
+						}
+					}
+					values.insert( ValueMap::value_type( reinterpret_cast<const char*>( name ), value ) );
+				}
+			}
+			m_Database.ReleaseStatement( stmt );
+		}
+	}
+
+	std::lock_guard<std::mutex> lock( m_FlushMutex );
+	m_PersistedValues = values;
+	m_PersistedVersion = m_Values.Set( std::move( values ) );
+}
+
+void Settings::Flush()
+{
+	std::lock_guard<std::mutex> lock( m_FlushMutex );
+	if ( m_Values.GetVersion() != m_PersistedVersion ) {
+		// A snapshot of the settings is written, so that the settings lock is not held while writing to the database.
+		uint64_t version = 0;
+		const Values::Ptr values = m_Values.Get( version );
+		bool success = false;
+		sqlite3* database = m_Database.GetDatabase();
+		if ( nullptr != database ) {
+			sqlite3_stmt* stmt = nullptr;
+			const std::string query = "REPLACE INTO Settings (Setting,Value) VALUES (?1,?2);";
+			if ( SQLITE_OK == m_Database.PrepareStatement( query, &stmt ) ) {
+				Database::Transaction transaction( m_Database );
+				success = true;
+				for ( auto setting = values->begin(); success && ( values->end() != setting ); setting++ ) {
+					const auto& [ name, value ] = *setting;
+					if ( const auto persisted = m_PersistedValues.find( name ); ( m_PersistedValues.end() == persisted ) || !( persisted->second == value ) ) {
+						success = ( SQLITE_OK == sqlite3_bind_text( stmt, 1, name.c_str(), -1 /*strLen*/, SQLITE_STATIC ) ) &&
+							( SQLITE_OK == value.Bind( stmt, 2 ) ) &&
+							( SQLITE_DONE == sqlite3_step( stmt ) );
+						sqlite3_reset( stmt );
+					}
+				}
+				m_Database.ReleaseStatement( stmt );
+				success = success && transaction.Commit();
+			}
+		}
+		// The persisted settings are only updated once they have been written, so that a failed write is retried by the next flush.
+		if ( success ) {
+			m_PersistedValues = *values;
+			m_PersistedVersion = version;
+		}
+	}
+}
+
+void Settings::StartFlushThread()
+{
+	StopFlushThread();
+	ResetEvent( m_FlushStopEvent );
+	m_FlushThread = CreateThread( NULL /*attributes*/, 0 /*stackSize*/, FlushThreadProc, this /*param*/, 0 /*flags*/, NULL /*threadId*/ );
+}
+
+void Settings::StopFlushThread()
+{
+	if ( nullptr != m_FlushThread ) {
+		SetEvent( m_FlushStopEvent );
+		WaitForSingleObject( m_FlushThread, INFINITE );
+		CloseHandle( m_FlushThread );
+		m_FlushThread = nullptr;
+	}
+}
+
+DWORD WINAPI Settings::FlushThreadProc( LPVOID lParam )
+{
+	if ( Settings* settings = static_cast<Settings*>( lParam ); nullptr != settings ) {
+		settings->FlushThreadHandler();
+	}
+	return 0;
+}
+
+void Settings::FlushThreadHandler()
+{
+	while ( WAIT_TIMEOUT == WaitForSingleObject( m_FlushStopEvent, kFlushInterval ) ) {
+		Flush();
+	}
 }
 
 void Settings::UpdateDatabase()
@@ -46,6 +386,7 @@ void Settings::UpdateDatabase()
 	UpdatePlaylistsTable();
 	UpdateHotkeysTable();
 	UpdateFontSettings();
+	m_Database.ClearStatementCache();
 }
 
 void Settings::UpdateSettingsTable()
@@ -258,22 +599,22 @@ void Settings::UpdateFontSettings()
 			// Get the pixel count per logical inch which applies to logfont blobs in the settings table.
 			sqlite3_stmt* stmt = nullptr;
 			std::string query = "SELECT Value FROM Settings WHERE Setting='LogPixels';";
-			if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
+			if ( SQLITE_OK == m_Database.PrepareStatement( query, &stmt ) ) {
 				if ( SQLITE_ROW == sqlite3_step( stmt ) ) {
 					settingsLogPixels = sqlite3_column_int( stmt, 0 /*columnIndex*/ );
 				}
-				sqlite3_finalize( stmt );
+				m_Database.ReleaseStatement( stmt );
 			}
 
 			// Set the pixel count per logical inch which applies to logfont blobs in the settings table.
 			query = "REPLACE INTO Settings (Setting,Value) VALUES (?1,?2);";
 			stmt = nullptr;
-			if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
+			if ( SQLITE_OK == m_Database.PrepareStatement( query, &stmt ) ) {
 				sqlite3_bind_text( stmt, 1, "LogPixels", -1 /*strLen*/, SQLITE_STATIC );
 				sqlite3_bind_int( stmt, 2, currentLogPixels );
 				sqlite3_step( stmt );
 				sqlite3_reset( stmt );
-				sqlite3_finalize( stmt );
+				m_Database.ReleaseStatement( stmt );
 			}
 
 			if ( ( settingsLogPixels != currentLogPixels ) && ( settingsLogPixels > 0 ) ) {
@@ -283,7 +624,7 @@ void Settings::UpdateFontSettings()
 				std::map<std::string,LOGFONT> fontSettingsToUpdate;
 				stmt = nullptr;
 				query = "SELECT Value FROM Settings WHERE Setting = ?1;";
-				if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
+				if ( SQLITE_OK == m_Database.PrepareStatement( query, &stmt ) ) {
 					for ( const auto& setting : allFontSettings ) {
 						sqlite3_bind_text( stmt, 1, setting, -1 /*strLen*/, SQLITE_STATIC );
 						if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
@@ -296,20 +637,20 @@ void Settings::UpdateFontSettings()
 						}
 						sqlite3_reset( stmt );
 					}
-					sqlite3_finalize( stmt );
+					m_Database.ReleaseStatement( stmt );
 				}
 
 				// Update settings table with DPI scaled logfont blobs.
 				stmt = nullptr;
 				query = "REPLACE INTO Settings (Setting,Value) VALUES (?1,?2);";
-				if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
+				if ( SQLITE_OK == m_Database.PrepareStatement( query, &stmt ) ) {
 					for ( const auto& setting : fontSettingsToUpdate ) {
 						sqlite3_bind_text( stmt, 1, setting.first.c_str(), -1 /*strLen*/, SQLITE_STATIC );
 						sqlite3_bind_blob( stmt, 2, &setting.second, sizeof( LOGFONT ), SQLITE_STATIC );
 						sqlite3_step( stmt );
 						sqlite3_reset( stmt );
 					}
-					sqlite3_finalize( stmt );
+					m_Database.ReleaseStatement( stmt );
 				}
 			}
 		}
@@ -323,7 +664,7 @@ void Settings::GetPlaylistSettings( PlaylistColumns& columns, bool& showStatusIc
 	if ( nullptr != database ) {
 		std::string query = "SELECT * FROM PlaylistColumns ORDER BY rowid ASC;";
 		sqlite3_stmt* stmt = nullptr;
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
+		if ( SQLITE_OK == m_Database.PrepareStatement( query, &stmt ) ) {
 			while ( SQLITE_ROW == sqlite3_step( stmt ) ) {
 				PlaylistColumn playlistColumn;
 				const int columnCount = sqlite3_column_count( stmt );
@@ -337,65 +678,36 @@ void Settings::GetPlaylistSettings( PlaylistColumns& columns, bool& showStatusIc
 				}
 				columns.push_back( playlistColumn );
 			}
-			sqlite3_finalize( stmt );
+			m_Database.ReleaseStatement( stmt );
 		}
+	}
 
-		stmt = nullptr;
-		query = "SELECT Value FROM Settings WHERE Setting='ListFont';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				const int bytes = sqlite3_column_bytes( stmt, 0 /*columnIndex*/ );
-				if ( sizeof( LOGFONT ) == bytes ) {
-					font = *reinterpret_cast<const LOGFONT*>( sqlite3_column_blob( stmt, 0 /*columnIndex*/ ) );
-				}
-			}
-			sqlite3_finalize( stmt );
+	const auto values = m_Values.Get();
+	if ( const auto setting = values->find( "ListFont" ); values->end() != setting ) {
+		const int bytes = setting->second.GetBytes();
+		if ( sizeof( LOGFONT ) == bytes ) {
+			font = *reinterpret_cast<const LOGFONT*>( setting->second.GetBlob() );
 		}
+	}
 
-		stmt = nullptr;
-		query = "SELECT Value FROM Settings WHERE Setting='ListFontColour';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				fontColour = static_cast<COLORREF>( sqlite3_column_int( stmt, 0 /*columnIndex*/ ) );
-			}
-			sqlite3_finalize( stmt );
-		}
+	if ( const auto setting = values->find( "ListFontColour" ); values->end() != setting ) {
+		fontColour = static_cast<COLORREF>( setting->second.GetInt() );
+	}
 
-		stmt = nullptr;
-		query = "SELECT Value FROM Settings WHERE Setting='ListBackgroundColour';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				backgroundColour = static_cast<COLORREF>( sqlite3_column_int( stmt, 0 /*columnIndex*/ ) );
-			}
-			sqlite3_finalize( stmt );
-		}
+	if ( const auto setting = values->find( "ListBackgroundColour" ); values->end() != setting ) {
+		backgroundColour = static_cast<COLORREF>( setting->second.GetInt() );
+	}
 
-		stmt = nullptr;
-		query = "SELECT Value FROM Settings WHERE Setting='ListHighlightColour';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				highlightColour = static_cast<COLORREF>( sqlite3_column_int( stmt, 0 /*columnIndex*/ ) );
-			}
-			sqlite3_finalize( stmt );
-		}
+	if ( const auto setting = values->find( "ListHighlightColour" ); values->end() != setting ) {
+		highlightColour = static_cast<COLORREF>( setting->second.GetInt() );
+	}
 
-		stmt = nullptr;
-		query = "SELECT Value FROM Settings WHERE Setting='ListStatusIconColour';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				statusIconColour = static_cast<COLORREF>( sqlite3_column_int( stmt, 0 /*columnIndex*/ ) );
-			}
-			sqlite3_finalize( stmt );
-		}
+	if ( const auto setting = values->find( "ListStatusIconColour" ); values->end() != setting ) {
+		statusIconColour = static_cast<COLORREF>( setting->second.GetInt() );
+	}
 
-		stmt = nullptr;
-		query = "SELECT Value FROM Settings WHERE Setting='ListStatusIconEnable';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				showStatusIcon = ( 0 != sqlite3_column_int( stmt, 0 /*columnIndex*/ ) );
-			}
-			sqlite3_finalize( stmt );
-		}
+	if ( const auto setting = values->find( "ListStatusIconEnable" ); values->end() != setting ) {
+		showStatusIcon = ( 0 != setting->second.GetInt() );
 	}
 }
 
@@ -407,236 +719,93 @@ void Settings::SetPlaylistSettings( const PlaylistColumns& columns, const bool s
 		const std::string clearTableQuery = "DELETE FROM PlaylistColumns;";
 		sqlite3_exec( database, clearTableQuery.c_str(), NULL /*callback*/, NULL /*arg*/, NULL /*errMsg*/ );
 
-		std::string insertQuery = "INSERT INTO PlaylistColumns (Col,Width) VALUES (?1,?2);";
+		const std::string insertQuery = "INSERT INTO PlaylistColumns (Col,Width) VALUES (?1,?2);";
 		sqlite3_stmt* stmt = nullptr;
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, insertQuery.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
+		if ( SQLITE_OK == m_Database.PrepareStatement( insertQuery, &stmt ) ) {
 			for ( const auto& columnIter : columns ) {
 				sqlite3_bind_int( stmt, 1, columnIter.ID );
 				sqlite3_bind_int( stmt, 2, columnIter.Width );
 				sqlite3_step( stmt );
 				sqlite3_reset( stmt );
 			}
-			sqlite3_finalize( stmt );
-			stmt = nullptr;
-		}
-
-		insertQuery = "REPLACE INTO Settings (Setting,Value) VALUES (?1,?2);";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, insertQuery.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			sqlite3_bind_text( stmt, 1, "ListFont", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_blob( stmt, 2, &font, sizeof( LOGFONT ), SQLITE_STATIC );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-
-			sqlite3_bind_text( stmt, 1, "ListFontColour", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, static_cast<int>( fontColour ) );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-
-			sqlite3_bind_text( stmt, 1, "ListBackgroundColour", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, static_cast<int>( backgroundColour ) );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-
-			sqlite3_bind_text( stmt, 1, "ListHighlightColour", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, static_cast<int>( highlightColour ) );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-
-			sqlite3_bind_text( stmt, 1, "ListStatusIconColour", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, static_cast<int>( statusIconColour ) );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-
-			sqlite3_bind_text( stmt, 1, "ListStatusIconEnable", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, static_cast<int>( showStatusIcon ) );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-
-			sqlite3_finalize( stmt );
-			stmt = nullptr;
+			m_Database.ReleaseStatement( stmt );
 		}
 	}
+
+	m_Values.Update( [ & ] ( ValueMap& values )
+	{
+		values[ "ListFont" ].SetBlob( &font, sizeof( LOGFONT ) );
+		values[ "ListFontColour" ].SetInt( static_cast<int>( fontColour ) );
+		values[ "ListBackgroundColour" ].SetInt( static_cast<int>( backgroundColour ) );
+		values[ "ListHighlightColour" ].SetInt( static_cast<int>( highlightColour ) );
+		values[ "ListStatusIconColour" ].SetInt( static_cast<int>( statusIconColour ) );
+		values[ "ListStatusIconEnable" ].SetInt( static_cast<int>( showStatusIcon ) );
+	} );
 }
 
 void Settings::GetTreeSettings( LOGFONT& font, COLORREF& fontColour, COLORREF& backgroundColour, COLORREF& highlightColour, COLORREF& iconColour,
 		bool& showFavourites, bool& showStreams, bool& showAllTracks, bool& showArtists, bool& showAlbums, bool& showGenres, bool& showYears )
 {
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		sqlite3_stmt* stmt = nullptr;
-		std::string query = "SELECT Value FROM Settings WHERE Setting='TreeFont';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				const int bytes = sqlite3_column_bytes( stmt, 0 /*columnIndex*/ );
-				if ( sizeof( LOGFONT ) == bytes ) {
-					font = *reinterpret_cast<const LOGFONT*>( sqlite3_column_blob( stmt, 0 /*columnIndex*/ ) );
-				}
-			}
-			sqlite3_finalize( stmt );
-		}
-		stmt = nullptr;
-		query = "SELECT Value FROM Settings WHERE Setting='TreeFontColour';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				fontColour = static_cast<COLORREF>( sqlite3_column_int( stmt, 0 /*columnIndex*/ ) );
-			}
-			sqlite3_finalize( stmt );
-		}
-		stmt = nullptr;
-		query = "SELECT Value FROM Settings WHERE Setting='TreeBackgroundColour';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				backgroundColour = static_cast<COLORREF>( sqlite3_column_int( stmt, 0 /*columnIndex*/ ) );
-			}
-			sqlite3_finalize( stmt );
-		}
-		stmt = nullptr;
-		query = "SELECT Value FROM Settings WHERE Setting='TreeHighlightColour';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				highlightColour = static_cast<COLORREF>( sqlite3_column_int( stmt, 0 /*columnIndex*/ ) );
-			}
-			sqlite3_finalize( stmt );
-		}
-		stmt = nullptr;
-		query = "SELECT Value FROM Settings WHERE Setting='TreeIconColour';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				iconColour = static_cast<COLORREF>( sqlite3_column_int( stmt, 0 /*columnIndex*/ ) );
-			}
-			sqlite3_finalize( stmt );
-		}
-		stmt = nullptr;
-		query = "SELECT Value FROM Settings WHERE Setting='TreeFavourites';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				showFavourites = ( 0 != sqlite3_column_int( stmt, 0 /*columnIndex*/ ) );
-			}
-			sqlite3_finalize( stmt );
-		}
-		stmt = nullptr;
-		query = "SELECT Value FROM Settings WHERE Setting='TreeStreams';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				showStreams = ( 0 != sqlite3_column_int( stmt, 0 /*columnIndex*/ ) );
-			}
-			sqlite3_finalize( stmt );
-		}
-		stmt = nullptr;
-		query = "SELECT Value FROM Settings WHERE Setting='TreeAllTracks';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				showAllTracks = ( 0 != sqlite3_column_int( stmt, 0 /*columnIndex*/ ) );
-			}
-			sqlite3_finalize( stmt );
-		}
-		stmt = nullptr;
-		query = "SELECT Value FROM Settings WHERE Setting='TreeArtists';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				showArtists = ( 0 != sqlite3_column_int( stmt, 0 /*columnIndex*/ ) );
-			}
-			sqlite3_finalize( stmt );
-		}
-		stmt = nullptr;
-		query = "SELECT Value FROM Settings WHERE Setting='TreeAlbums';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				showAlbums = ( 0 != sqlite3_column_int( stmt, 0 /*columnIndex*/ ) );
-			}
-			sqlite3_finalize( stmt );
-		}
-		stmt = nullptr;
-		query = "SELECT Value FROM Settings WHERE Setting='TreeGenres';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				showGenres = ( 0 != sqlite3_column_int( stmt, 0 /*columnIndex*/ ) );
-			}
-			sqlite3_finalize( stmt );
-		}
-		stmt = nullptr;
-		query = "SELECT Value FROM Settings WHERE Setting='TreeYears';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				showYears = ( 0 != sqlite3_column_int( stmt, 0 /*columnIndex*/ ) );
-			}
-			sqlite3_finalize( stmt );
+	const auto values = m_Values.Get();
+	if ( const auto setting = values->find( "TreeFont" ); values->end() != setting ) {
+		const int bytes = setting->second.GetBytes();
+		if ( sizeof( LOGFONT ) == bytes ) {
+			font = *reinterpret_cast<const LOGFONT*>( setting->second.GetBlob() );
 		}
 	}
+	if ( const auto setting = values->find( "TreeFontColour" ); values->end() != setting ) {
+		fontColour = static_cast<COLORREF>( setting->second.GetInt() );
+	}
+	if ( const auto setting = values->find( "TreeBackgroundColour" ); values->end() != setting ) {
+		backgroundColour = static_cast<COLORREF>( setting->second.GetInt() );
+	}
+	if ( const auto setting = values->find( "TreeHighlightColour" ); values->end() != setting ) {
+		highlightColour = static_cast<COLORREF>( setting->second.GetInt() );
+	}
+	if ( const auto setting = values->find( "TreeIconColour" ); values->end() != setting ) {
+		iconColour = static_cast<COLORREF>( setting->second.GetInt() );
+	}
+	if ( const auto setting = values->find( "TreeFavourites" ); values->end() != setting ) {
+		showFavourites = ( 0 != setting->second.GetInt() );
+	}
+	if ( const auto setting = values->find( "TreeStreams" ); values->end() != setting ) {
+		showStreams = ( 0 != setting->second.GetInt() );
+	}
+	if ( const auto setting = values->find( "TreeAllTracks" ); values->end() != setting ) {
+		showAllTracks = ( 0 != setting->second.GetInt() );
+	}
+	if ( const auto setting = values->find( "TreeArtists" ); values->end() != setting ) {
+		showArtists = ( 0 != setting->second.GetInt() );
+	}
+	if ( const auto setting = values->find( "TreeAlbums" ); values->end() != setting ) {
+		showAlbums = ( 0 != setting->second.GetInt() );
+	}
+	if ( const auto setting = values->find( "TreeGenres" ); values->end() != setting ) {
+		showGenres = ( 0 != setting->second.GetInt() );
+	}
+	if ( const auto setting = values->find( "TreeYears" ); values->end() != setting ) {
+		showYears = ( 0 != setting->second.GetInt() );
+	}
 }
 
 void Settings::SetTreeSettings( const LOGFONT& font, const COLORREF fontColour, const COLORREF backgroundColour, const COLORREF highlightColour, const COLORREF iconColour,
 		const bool showFavourites, const bool showStreams, const bool showAllTracks, const bool showArtists, const bool showAlbums, const bool showGenres, const bool showYears )
 {
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		sqlite3_stmt* stmt = nullptr;
-		std::string insertQuery = "REPLACE INTO Settings (Setting,Value) VALUES (?1,?2);";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, insertQuery.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			sqlite3_bind_text( stmt, 1, "TreeFont", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_blob( stmt, 2, &font, sizeof( LOGFONT ), SQLITE_STATIC );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-
-			sqlite3_bind_text( stmt, 1, "TreeFontColour", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, static_cast<int>( fontColour ) );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-
-			sqlite3_bind_text( stmt, 1, "TreeBackgroundColour", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, static_cast<int>( backgroundColour ) );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-
-			sqlite3_bind_text( stmt, 1, "TreeHighlightColour", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, static_cast<int>( highlightColour ) );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-
-			sqlite3_bind_text( stmt, 1, "TreeIconColour", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, static_cast<int>( iconColour ) );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-
-			sqlite3_bind_text( stmt, 1, "TreeFavourites", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, static_cast<int>( showFavourites ) );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-
-			sqlite3_bind_text( stmt, 1, "TreeStreams", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, static_cast<int>( showStreams ) );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-
-			sqlite3_bind_text( stmt, 1, "TreeAllTracks", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, static_cast<int>( showAllTracks ) );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-
-			sqlite3_bind_text( stmt, 1, "TreeArtists", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, static_cast<int>( showArtists ) );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-
-			sqlite3_bind_text( stmt, 1, "TreeAlbums", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, static_cast<int>( showAlbums ) );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-
-			sqlite3_bind_text( stmt, 1, "TreeGenres", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, static_cast<int>( showGenres ) );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-
-			sqlite3_bind_text( stmt, 1, "TreeYears", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, static_cast<int>( showYears ) );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-
-			sqlite3_finalize( stmt );
-			stmt = nullptr;
-		}
-	}
+	m_Values.Update( [ & ] ( ValueMap& values )
+	{
+		values[ "TreeFont" ].SetBlob( &font, sizeof( LOGFONT ) );
+		values[ "TreeFontColour" ].SetInt( static_cast<int>( fontColour ) );
+		values[ "TreeBackgroundColour" ].SetInt( static_cast<int>( backgroundColour ) );
+		values[ "TreeHighlightColour" ].SetInt( static_cast<int>( highlightColour ) );
+		values[ "TreeIconColour" ].SetInt( static_cast<int>( iconColour ) );
+		values[ "TreeFavourites" ].SetInt( static_cast<int>( showFavourites ) );
+		values[ "TreeStreams" ].SetInt( static_cast<int>( showStreams ) );
+		values[ "TreeAllTracks" ].SetInt( static_cast<int>( showAllTracks ) );
+		values[ "TreeArtists" ].SetInt( static_cast<int>( showArtists ) );
+		values[ "TreeAlbums" ].SetInt( static_cast<int>( showAlbums ) );
+		values[ "TreeGenres" ].SetInt( static_cast<int>( showGenres ) );
+		values[ "TreeYears" ].SetInt( static_cast<int>( showYears ) );
+	} );
 }
 
 Playlists Settings::GetPlaylists()
@@ -646,7 +815,7 @@ Playlists Settings::GetPlaylists()
 	if ( nullptr != database ) {
 		const std::string query = "SELECT * FROM Playlists;";
 		sqlite3_stmt* stmt = nullptr;
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
+		if ( SQLITE_OK == m_Database.PrepareStatement( query, &stmt ) ) {
 			while ( SQLITE_ROW == sqlite3_step( stmt ) ) {
 				std::string playlistID;
 				std::wstring playlistName;
@@ -672,7 +841,7 @@ Playlists Settings::GetPlaylists()
 					playlists.push_back( playlist );
 				}
 			}
-			sqlite3_finalize( stmt );
+			m_Database.ReleaseStatement( stmt );
 		}
 	}
 	return playlists;
@@ -696,7 +865,7 @@ void Settings::ReadPlaylistFiles( Playlist& playlist )
 			query += "\" ORDER BY rowid ASC;";
 
 			sqlite3_stmt* stmt = nullptr;
-			if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
+			if ( SQLITE_OK == m_Database.PrepareStatement( query, &stmt ) ) {
 				while ( SQLITE_ROW == sqlite3_step( stmt ) ) {
 					bool pending = false;
 					std::wstring filename;
@@ -714,18 +883,18 @@ void Settings::ReadPlaylistFiles( Playlist& playlist )
 					}
 					if ( !filename.empty() ) {
 						if ( pending ) {
-							playlist.AddPending( filename, false /*startPendingThread*/ );
+							playlist.AddPending( filename, false /*startPendingTask*/ );
 						} else {
 							MediaInfo mediaInfo( filename );
 							if ( m_Library.GetMediaInfo( mediaInfo, false /*checkFileAttributes*/, false /*scanMedia*/ ) ) {
 								playlist.AddItem( mediaInfo );
 							} else {
-								playlist.AddPending( filename, false /*startPendingThread*/ );
+								playlist.AddPending( filename, false /*startPendingTask*/ );
 							}
 						}
 					}
 				}
-				sqlite3_finalize( stmt );
+				m_Database.ReleaseStatement( stmt );
 			}
 		}
 	}
@@ -748,14 +917,15 @@ void Settings::RemovePlaylist( const Playlist& playlist )
 		if ( IsValidGUID( playlistID ) ) {
 			const std::string dropFilesTableQuery = "DROP TABLE \"" + playlistID + "\";";
 			sqlite3_exec( database, dropFilesTableQuery.c_str(), NULL /*callback*/, NULL /*arg*/, NULL /*errMsg*/ );
+			m_Database.ClearStatementCache();
 
 			const std::string removePlaylistQuery = "DELETE FROM Playlists WHERE ID = ?1;";
 			sqlite3_stmt* stmt = nullptr;
-			if ( SQLITE_OK == sqlite3_prepare_v2( database, removePlaylistQuery.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
+			if ( SQLITE_OK == m_Database.PrepareStatement( removePlaylistQuery, &stmt ) ) {
 				if ( SQLITE_OK == sqlite3_bind_text( stmt, 1 /*param*/, playlistID.c_str(), -1 /*strLen*/, SQLITE_STATIC ) ) {
 					sqlite3_step( stmt );
 				}
-				sqlite3_finalize( stmt );
+				m_Database.ReleaseStatement( stmt );
 			}
 		}
 	}
@@ -769,16 +939,17 @@ void Settings::SavePlaylist( Playlist& playlist )
 		if ( IsValidGUID( playlistID ) || ( Playlist::Type::Favourites == playlist.GetType() ) ) {
 			UpdatePlaylistTable( playlistID );
 
+			// Replace the playlist contents in a single transaction.
+			Database::Transaction transaction( m_Database );
 			std::string clearTableQuery = "DELETE FROM \"";
 			clearTableQuery += playlistID + "\";";
 			sqlite3_exec( database, clearTableQuery.c_str(), NULL /*callback*/, NULL /*arg*/, NULL /*errMsg*/ );
 
-			sqlite3_exec( database, "BEGIN TRANSACTION;", NULL /*callback*/, NULL /*arg*/, NULL /*errMsg*/ );
 			std::string insertFileQuery = "INSERT INTO \"";
 			insertFileQuery += playlistID;
 			insertFileQuery += "\" (File, Pending) VALUES (?1,?2);";
 			sqlite3_stmt* stmt = nullptr;
-			if ( SQLITE_OK == sqlite3_prepare_v2( database, insertFileQuery.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
+			if ( SQLITE_OK == m_Database.PrepareStatement( insertFileQuery, &stmt ) ) {
 				bool pending = false;
 				const Playlist::ItemList itemList = playlist.GetItems();
 				for ( const auto& iter : itemList ) {
@@ -801,20 +972,20 @@ void Settings::SavePlaylist( Playlist& playlist )
 						sqlite3_reset( stmt );
 					}
 				}
-				sqlite3_finalize( stmt );
+				m_Database.ReleaseStatement( stmt );
 			}
-			sqlite3_exec( database, "END TRANSACTION;", NULL /*callback*/, NULL /*arg*/, NULL /*errMsg*/ );
+			transaction.Commit();
 
 			if ( Playlist::Type::Favourites != playlist.GetType() ) {
 				const std::string insertPlaylistQuery = "REPLACE INTO Playlists (ID,Name) VALUES (?1,?2);";
 				const std::string playlistName = WideStringToUTF8( playlist.GetName() );
 				stmt = nullptr;
-				if ( SQLITE_OK == sqlite3_prepare_v2( database, insertPlaylistQuery.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
+				if ( SQLITE_OK == m_Database.PrepareStatement( insertPlaylistQuery, &stmt ) ) {
 					if ( ( SQLITE_OK == sqlite3_bind_text( stmt, 1 /*param*/, playlistID.c_str(), -1 /*strLen*/, SQLITE_STATIC ) ) &&
 							( SQLITE_OK == sqlite3_bind_text( stmt, 2 /*param*/, playlistName.c_str(), -1 /*strLen*/, SQLITE_STATIC ) ) ) {
 						sqlite3_step( stmt );
 					}
-					sqlite3_finalize( stmt );
+					m_Database.ReleaseStatement( stmt );
 				}
 			}
 		}
@@ -824,18 +995,11 @@ void Settings::SavePlaylist( Playlist& playlist )
 std::filesystem::path Settings::GetDefaultArtwork()
 {
 	std::filesystem::path artwork;
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		sqlite3_stmt* stmt = nullptr;
-		const std::string query = "SELECT Value FROM Settings WHERE Setting='DefaultArtwork';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				const unsigned char* text = sqlite3_column_text( stmt, 0 /*columnIndex*/ );
-				if ( nullptr != text ) {
-					artwork = UTF8ToWideString( reinterpret_cast<const char*>( text ) );
-				}
-			}
-			sqlite3_finalize( stmt );
+	const auto values = m_Values.Get();
+	if ( const auto setting = values->find( "DefaultArtwork" ); values->end() != setting ) {
+		const unsigned char* text = setting->second.GetText();
+		if ( nullptr != text ) {
+			artwork = UTF8ToWideString( reinterpret_cast<const char*>( text ) );
 		}
 	}
 	return artwork;
@@ -843,100 +1007,56 @@ std::filesystem::path Settings::GetDefaultArtwork()
 
 void Settings::SetDefaultArtwork( const std::filesystem::path& artwork )
 {
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		sqlite3_stmt* stmt = nullptr;
-		const std::string query = "REPLACE INTO Settings (Setting,Value) VALUES (?1,?2);";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			sqlite3_bind_text( stmt, 1, "DefaultArtwork", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_text( stmt, 2, WideStringToUTF8( artwork ).c_str(), -1 /*strLen*/, SQLITE_TRANSIENT );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-			sqlite3_finalize( stmt );
-			stmt = nullptr;
-		}
-	}
+	m_Values.Update( [ & ] ( ValueMap& values )
+	{
+		values[ "DefaultArtwork" ].SetText( WideStringToUTF8( artwork ) );
+	} );
 }
 
 COLORREF Settings::GetOscilloscopeColour()
 {
 	COLORREF colour = {};
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		sqlite3_stmt* stmt = nullptr;
-		const std::string query = "SELECT Value FROM Settings WHERE Setting='OscilloscopeColour';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( SQLITE_ROW == sqlite3_step( stmt ) ) {
-				colour = static_cast<COLORREF>( sqlite3_column_int( stmt, 0 /*columnIndex*/ ) );
-			}
-			sqlite3_finalize( stmt );
-		}
+	const auto values = m_Values.Get();
+	if ( const auto setting = values->find( "OscilloscopeColour" ); values->end() != setting ) {
+		colour = static_cast<COLORREF>( setting->second.GetInt() );
 	}
 	return colour;
 }
 
 void Settings::SetOscilloscopeColour( const COLORREF colour )
 {
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		const std::string query = "REPLACE INTO Settings (Setting,Value) VALUES (?1,?2);";
-		sqlite3_stmt* stmt = nullptr;
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			sqlite3_bind_text( stmt, 1, "OscilloscopeColour", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, static_cast<int>( colour ) );
-			sqlite3_step( stmt );
-			sqlite3_finalize( stmt );
-		}
-	}
+	m_Values.Update( [ & ] ( ValueMap& values )
+	{
+		values[ "OscilloscopeColour" ].SetInt( static_cast<int>( colour ) );
+	} );
 }
 
 COLORREF Settings::GetOscilloscopeBackground()
 {
 	COLORREF colour = 0xffffffff;
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		sqlite3_stmt* stmt = nullptr;
-		const std::string query = "SELECT Value FROM Settings WHERE Setting='OscilloscopeBackground';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( SQLITE_ROW == sqlite3_step( stmt ) ) {
-				colour = static_cast<COLORREF>( sqlite3_column_int( stmt, 0 /*columnIndex*/ ) );
-			}
-			sqlite3_finalize( stmt );
-		}
+	const auto values = m_Values.Get();
+	if ( const auto setting = values->find( "OscilloscopeBackground" ); values->end() != setting ) {
+		colour = static_cast<COLORREF>( setting->second.GetInt() );
 	}
 	return colour;
 }
 
 void Settings::SetOscilloscopeBackground( const COLORREF colour )
 {
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		const std::string query = "REPLACE INTO Settings (Setting,Value) VALUES (?1,?2);";
-		sqlite3_stmt* stmt = nullptr;
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			sqlite3_bind_text( stmt, 1, "OscilloscopeBackground", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, static_cast<int>( colour ) );
-			sqlite3_step( stmt );
-			sqlite3_finalize( stmt );
-		}
-	}
+	m_Values.Update( [ & ] ( ValueMap& values )
+	{
+		values[ "OscilloscopeBackground" ].SetInt( static_cast<int>( colour ) );
+	} );
 }
 
 float Settings::GetOscilloscopeWeight()
 {
 	float weight = 2.0f;
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		sqlite3_stmt* stmt = nullptr;
-		const std::string query = "SELECT Value FROM Settings WHERE Setting='OscilloscopeWeight';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( SQLITE_ROW == sqlite3_step( stmt ) ) {
-				const float value = static_cast<float>( sqlite3_column_double( stmt, 0 /*columnIndex*/ ) );
-				if ( ( value >= 0.5f ) && ( value <= 5.0f ) ) {
-					weight = value;
-				}
-			}
-			sqlite3_finalize( stmt );
+	const auto values = m_Values.Get();
+	if ( const auto setting = values->find( "OscilloscopeWeight" ); values->end() != setting ) {
+		const float value = static_cast<float>( setting->second.GetDouble() );
+		if ( ( value >= 0.5f ) && ( value <= 5.0f ) ) {
+			weight = value;
 		}
 	}
 	return weight;
@@ -944,38 +1064,24 @@ float Settings::GetOscilloscopeWeight()
 
 void Settings::SetOscilloscopeWeight( const float weight )
 {
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		const std::string query = "REPLACE INTO Settings (Setting,Value) VALUES (?1,?2);";
-		sqlite3_stmt* stmt = nullptr;
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			sqlite3_bind_text( stmt, 1, "OscilloscopeWeight", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_double( stmt, 2, weight );
-			sqlite3_step( stmt );
-			sqlite3_finalize( stmt );
-		}
-	}
+	m_Values.Update( [ & ] ( ValueMap& values )
+	{
+		values[ "OscilloscopeWeight" ].SetDouble( weight );
+	} );
 }
 
 float Settings::GetVUMeterDecay()
 {
 	float decay = VUMeterDecayNormal;
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		sqlite3_stmt* stmt = nullptr;
-		const std::string query = "SELECT Value FROM Settings WHERE Setting='VUMeterDecay';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( SQLITE_ROW == sqlite3_step( stmt ) ) {
-				const float value = static_cast<float>( sqlite3_column_double( stmt, 0 /*columnIndex*/ ) );
-				if ( value < VUMeterDecayMinimum ) {
-					decay = VUMeterDecayMinimum;
-				} else if ( value > VUMeterDecayMaximum ) {
-					decay = VUMeterDecayMaximum;
-				} else {
-					decay = value;
-				}
-			}
-			sqlite3_finalize( stmt );
+	const auto values = m_Values.Get();
+	if ( const auto setting = values->find( "VUMeterDecay" ); values->end() != setting ) {
+		const float value = static_cast<float>( setting->second.GetDouble() );
+		if ( value < VUMeterDecayMinimum ) {
+			decay = VUMeterDecayMinimum;
+		} else if ( value > VUMeterDecayMaximum ) {
+			decay = VUMeterDecayMaximum;
+		} else {
+			decay = value;
 		}
 	}
 	return decay;
@@ -983,17 +1089,10 @@ float Settings::GetVUMeterDecay()
 
 void Settings::SetVUMeterDecay( const float decay )
 {
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		const std::string query = "REPLACE INTO Settings (Setting,Value) VALUES (?1,?2);";
-		sqlite3_stmt* stmt = nullptr;
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			sqlite3_bind_text( stmt, 1, "VUMeterDecay", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_double( stmt, 2, decay );
-			sqlite3_step( stmt );
-			sqlite3_finalize( stmt );
-		}
-	}
+	m_Values.Update( [ & ] ( ValueMap& values )
+	{
+		values[ "VUMeterDecay" ].SetDouble( decay );
+	} );
 }
 
 void Settings::GetSpectrumAnalyserSettings( COLORREF& base, COLORREF& peak, COLORREF& background )
@@ -1001,64 +1100,28 @@ void Settings::GetSpectrumAnalyserSettings( COLORREF& base, COLORREF& peak, COLO
 	base = RGB( 0 /*red*/, 122 /*green*/, 217 /*blue*/ );
 	peak = RGB( 0xff /*red*/, 0xff /*green*/, 0xff /*blue*/ );
 	background = RGB( 0x00 /*red*/, 0x00 /*green*/, 0x00 /*blue*/ );
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		sqlite3_stmt* stmt = nullptr;
-		std::string query = "SELECT Value FROM Settings WHERE Setting='SpectrumAnalyserBase';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				base = static_cast<COLORREF>( sqlite3_column_int( stmt, 0 /*columnIndex*/ ) );
-			}
-			sqlite3_finalize( stmt );
-			stmt = nullptr;
-		}
+	const auto values = m_Values.Get();
+	if ( const auto setting = values->find( "SpectrumAnalyserBase" ); values->end() != setting ) {
+		base = static_cast<COLORREF>( setting->second.GetInt() );
+	}
 
-		query = "SELECT Value FROM Settings WHERE Setting='SpectrumAnalyserPeak';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				peak = static_cast<COLORREF>( sqlite3_column_int( stmt, 0 /*columnIndex*/ ) );
-			}
-			sqlite3_finalize( stmt );
-			stmt = nullptr;
-		}
+	if ( const auto setting = values->find( "SpectrumAnalyserPeak" ); values->end() != setting ) {
+		peak = static_cast<COLORREF>( setting->second.GetInt() );
+	}
 
-		query = "SELECT Value FROM Settings WHERE Setting='SpectrumAnalyserBackground';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				background = static_cast<COLORREF>( sqlite3_column_int( stmt, 0 /*columnIndex*/ ) );
-			}
-			sqlite3_finalize( stmt );
-			stmt = nullptr;
-		}
+	if ( const auto setting = values->find( "SpectrumAnalyserBackground" ); values->end() != setting ) {
+		background = static_cast<COLORREF>( setting->second.GetInt() );
 	}
 }
 
 void Settings::SetSpectrumAnalyserSettings( const COLORREF& base, const COLORREF& peak, const COLORREF& background )
 {
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		const std::string query = "REPLACE INTO Settings (Setting,Value) VALUES (?1,?2);";
-		sqlite3_stmt* stmt = nullptr;
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			sqlite3_bind_text( stmt, 1, "SpectrumAnalyserBase", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, static_cast<int>( base ) );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-
-			sqlite3_bind_text( stmt, 1, "SpectrumAnalyserPeak", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, static_cast<int>( peak ) );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-
-			sqlite3_bind_text( stmt, 1, "SpectrumAnalyserBackground", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, static_cast<int>( background ) );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-
-			sqlite3_finalize( stmt );
-			stmt = nullptr;
-		}
-	}
+	m_Values.Update( [ & ] ( ValueMap& values )
+	{
+		values[ "SpectrumAnalyserBase" ].SetInt( static_cast<int>( base ) );
+		values[ "SpectrumAnalyserPeak" ].SetInt( static_cast<int>( peak ) );
+		values[ "SpectrumAnalyserBackground" ].SetInt( static_cast<int>( background ) );
+	} );
 }
 
 void Settings::GetPeakMeterSettings( COLORREF& base, COLORREF& peak, COLORREF& background )
@@ -1066,271 +1129,128 @@ void Settings::GetPeakMeterSettings( COLORREF& base, COLORREF& peak, COLORREF& b
 	base = RGB( 0 /*red*/, 122 /*green*/, 217 /*blue*/ );
 	peak = RGB( 0xff /*red*/, 0xff /*green*/, 0xff /*blue*/ );
 	background = RGB( 0 /*red*/, 0 /*green*/, 0 /*blue*/ );
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		sqlite3_stmt* stmt = nullptr;
-		std::string query = "SELECT Value FROM Settings WHERE Setting='PeakMeterBase';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				base = static_cast<COLORREF>( sqlite3_column_int( stmt, 0 /*columnIndex*/ ) );
-			}
-			sqlite3_finalize( stmt );
-			stmt = nullptr;
-		}
+	const auto values = m_Values.Get();
+	if ( const auto setting = values->find( "PeakMeterBase" ); values->end() != setting ) {
+		base = static_cast<COLORREF>( setting->second.GetInt() );
+	}
 
-		query = "SELECT Value FROM Settings WHERE Setting='PeakMeterPeak';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				peak = static_cast<COLORREF>( sqlite3_column_int( stmt, 0 /*columnIndex*/ ) );
-			}
-			sqlite3_finalize( stmt );
-			stmt = nullptr;
-		}
+	if ( const auto setting = values->find( "PeakMeterPeak" ); values->end() != setting ) {
+		peak = static_cast<COLORREF>( setting->second.GetInt() );
+	}
 
-		query = "SELECT Value FROM Settings WHERE Setting='PeakMeterBackground';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				background = static_cast<COLORREF>( sqlite3_column_int( stmt, 0 /*columnIndex*/ ) );
-			}
-			sqlite3_finalize( stmt );
-			stmt = nullptr;
-		}
+	if ( const auto setting = values->find( "PeakMeterBackground" ); values->end() != setting ) {
+		background = static_cast<COLORREF>( setting->second.GetInt() );
 	}
 }
 
 void Settings::SetPeakMeterSettings( const COLORREF& base, const COLORREF& peak, const COLORREF& background )
 {
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		const std::string query = "REPLACE INTO Settings (Setting,Value) VALUES (?1,?2);";
-		sqlite3_stmt* stmt = nullptr;
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			sqlite3_bind_text( stmt, 1, "PeakMeterBase", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, static_cast<int>( base ) );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-
-			sqlite3_bind_text( stmt, 1, "PeakMeterPeak", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, static_cast<int>( peak ) );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-
-			sqlite3_bind_text( stmt, 1, "PeakMeterBackground", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, static_cast<int>( background ) );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-
-			sqlite3_finalize( stmt );
-			stmt = nullptr;
-		}
-	}
+	m_Values.Update( [ & ] ( ValueMap& values )
+	{
+		values[ "PeakMeterBase" ].SetInt( static_cast<int>( base ) );
+		values[ "PeakMeterPeak" ].SetInt( static_cast<int>( peak ) );
+		values[ "PeakMeterBackground" ].SetInt( static_cast<int>( background ) );
+	} );
 }
 
 void Settings::GetStartupPosition( int& x, int& y, int& width, int& height, bool& maximised, bool& minimised )
 {
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		sqlite3_stmt* stmt = nullptr;
-		std::string query = "SELECT Value FROM Settings WHERE Setting='StartupX';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( SQLITE_ROW == sqlite3_step( stmt ) ) {
-				x = sqlite3_column_int( stmt, 0 /*columnIndex*/ );
-			}
-			sqlite3_finalize( stmt );
-		}
-		stmt = nullptr;
-		query = "SELECT Value FROM Settings WHERE Setting='StartupY';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( SQLITE_ROW == sqlite3_step( stmt ) ) {
-				y = sqlite3_column_int( stmt, 0 /*columnIndex*/ );
-			}
-			sqlite3_finalize( stmt );
-		}
-		stmt = nullptr;
-		query = "SELECT Value FROM Settings WHERE Setting='StartupWidth';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( SQLITE_ROW == sqlite3_step( stmt ) ) {
-				width = sqlite3_column_int( stmt, 0 /*columnIndex*/ );
-			}
-			sqlite3_finalize( stmt );
-		}
-		stmt = nullptr;
-		query = "SELECT Value FROM Settings WHERE Setting='StartupHeight';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( SQLITE_ROW == sqlite3_step( stmt ) ) {
-				height = sqlite3_column_int( stmt, 0 /*columnIndex*/ );
-			}
-			sqlite3_finalize( stmt );
-		}
-		stmt = nullptr;
-		query = "SELECT Value FROM Settings WHERE Setting='StartupMaximised';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( SQLITE_ROW == sqlite3_step( stmt ) ) {
-				maximised = ( 0 != sqlite3_column_int( stmt, 0 /*columnIndex*/ ) );
-			}
-			sqlite3_finalize( stmt );
-		}
-		stmt = nullptr;
-		query = "SELECT Value FROM Settings WHERE Setting='StartupMinimised';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( SQLITE_ROW == sqlite3_step( stmt ) ) {
-				minimised = ( 0 != sqlite3_column_int( stmt, 0 /*columnIndex*/ ) );
-			}
-			sqlite3_finalize( stmt );
-		}
+	const auto values = m_Values.Get();
+	if ( const auto setting = values->find( "StartupX" ); values->end() != setting ) {
+		x = setting->second.GetInt();
+	}
+	if ( const auto setting = values->find( "StartupY" ); values->end() != setting ) {
+		y = setting->second.GetInt();
+	}
+	if ( const auto setting = values->find( "StartupWidth" ); values->end() != setting ) {
+		width = setting->second.GetInt();
+	}
+	if ( const auto setting = values->find( "StartupHeight" ); values->end() != setting ) {
+		height = setting->second.GetInt();
+	}
+	if ( const auto setting = values->find( "StartupMaximised" ); values->end() != setting ) {
+		maximised = ( 0 != setting->second.GetInt() );
+	}
+	if ( const auto setting = values->find( "StartupMinimised" ); values->end() != setting ) {
+		minimised = ( 0 != setting->second.GetInt() );
 	}
 }
 
 void Settings::SetStartupPosition( const int x, const int y, const int width, const int height, const bool maximised, const bool minimised )
 {
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		const std::string query = "REPLACE INTO Settings (Setting,Value) VALUES (?1,?2);";
-		sqlite3_stmt* stmt = nullptr;
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			sqlite3_bind_text( stmt, 1, "StartupX", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, x );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-			sqlite3_bind_text( stmt, 1, "StartupY", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, y );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-			sqlite3_bind_text( stmt, 1, "StartupWidth", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, width );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-			sqlite3_bind_text( stmt, 1, "StartupHeight", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, height );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-			sqlite3_bind_text( stmt, 1, "StartupMaximised", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, maximised );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-			sqlite3_bind_text( stmt, 1, "StartupMinimised", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, minimised );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-			sqlite3_finalize( stmt );
-		}
-	}
+	m_Values.Update( [ & ] ( ValueMap& values )
+	{
+		values[ "StartupX" ].SetInt( x );
+		values[ "StartupY" ].SetInt( y );
+		values[ "StartupWidth" ].SetInt( width );
+		values[ "StartupHeight" ].SetInt( height );
+		values[ "StartupMaximised" ].SetInt( maximised );
+		values[ "StartupMinimised" ].SetInt( minimised );
+	} );
 }
 
 int Settings::GetVisualID()
 {
 	int visualID = 0;
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		sqlite3_stmt* stmt = nullptr;
-		const std::string query = "SELECT Value FROM Settings WHERE Setting='VisualID';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( SQLITE_ROW == sqlite3_step( stmt ) ) {
-				visualID = sqlite3_column_int( stmt, 0 /*columnIndex*/ );
-			}
-			sqlite3_finalize( stmt );
-		}
+	const auto values = m_Values.Get();
+	if ( const auto setting = values->find( "VisualID" ); values->end() != setting ) {
+		visualID = setting->second.GetInt();
 	}
 	return visualID;
 }
 
 void Settings::SetVisualID( const int visualID )
 {
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		const std::string query = "REPLACE INTO Settings (Setting,Value) VALUES (?1,?2);";
-		sqlite3_stmt* stmt = nullptr;
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			sqlite3_bind_text( stmt, 1, "VisualID", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, visualID );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-			sqlite3_finalize( stmt );
-		}
-	}
+	m_Values.Update( [ & ] ( ValueMap& values )
+	{
+		values[ "VisualID" ].SetInt( visualID );
+	} );
 }
 
 int Settings::GetSplitWidth()
 {
 	int width = 0;
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		sqlite3_stmt* stmt = nullptr;
-		const std::string query = "SELECT Value FROM Settings WHERE Setting='SplitWidth';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( SQLITE_ROW == sqlite3_step( stmt ) ) {
-				width = sqlite3_column_int( stmt, 0 /*columnIndex*/ );
-			}
-			sqlite3_finalize( stmt );
-		}
+	const auto values = m_Values.Get();
+	if ( const auto setting = values->find( "SplitWidth" ); values->end() != setting ) {
+		width = setting->second.GetInt();
 	}
 	return width;
 }
 
 void Settings::SetSplitWidth( const int width )
 {
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		const std::string query = "REPLACE INTO Settings (Setting,Value) VALUES (?1,?2);";
-		sqlite3_stmt* stmt = nullptr;
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			sqlite3_bind_text( stmt, 1, "SplitWidth", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, width );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-			sqlite3_finalize( stmt );
-		}
-	}
+	m_Values.Update( [ & ] ( ValueMap& values )
+	{
+		values[ "SplitWidth" ].SetInt( width );
+	} );
 }
 
 float Settings::GetVolume()
 {
 	float volume = 1.0f;
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		sqlite3_stmt* stmt = nullptr;
-		const std::string query = "SELECT Value FROM Settings WHERE Setting='Volume';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( SQLITE_ROW == sqlite3_step( stmt ) ) {
-				volume = static_cast<float>( sqlite3_column_double( stmt, 0 /*columnIndex*/ ) );
-			}
-			sqlite3_finalize( stmt );
-		}
+	const auto values = m_Values.Get();
+	if ( const auto setting = values->find( "Volume" ); values->end() != setting ) {
+		volume = static_cast<float>( setting->second.GetDouble() );
 	}
 	return volume;
 }
 
 void Settings::SetVolume( const float volume )
 {
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		const std::string query = "REPLACE INTO Settings (Setting,Value) VALUES (?1,?2);";
-		sqlite3_stmt* stmt = nullptr;
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			sqlite3_bind_text( stmt, 1, "Volume", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_double( stmt, 2, volume );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-			sqlite3_finalize( stmt );
-		}
-	}
+	m_Values.Update( [ & ] ( ValueMap& values )
+	{
+		values[ "Volume" ].SetDouble( volume );
+	} );
 }
 
 std::wstring Settings::GetStartupPlaylist()
 {
 	std::wstring playlist;
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		sqlite3_stmt* stmt = nullptr;
-		const std::string query = "SELECT Value FROM Settings WHERE Setting='StartupPlaylist';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( SQLITE_ROW == sqlite3_step( stmt ) ) {
-				const char* text = reinterpret_cast<const char*>( sqlite3_column_text( stmt, 0 /*columnIndex*/ ) );
-				if ( nullptr != text ) {
-					playlist = UTF8ToWideString( text );
-				}
-			}
-			sqlite3_finalize( stmt );
+	const auto values = m_Values.Get();
+	if ( const auto setting = values->find( "StartupPlaylist" ); values->end() != setting ) {
+		const char* text = reinterpret_cast<const char*>( setting->second.GetText() );
+		if ( nullptr != text ) {
+			playlist = UTF8ToWideString( text );
 		}
 	}
 	return playlist;
@@ -1338,35 +1258,20 @@ std::wstring Settings::GetStartupPlaylist()
 
 void Settings::SetStartupPlaylist( const std::wstring& playlist )
 {
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		const std::string query = "REPLACE INTO Settings (Setting,Value) VALUES (?1,?2);";
-		sqlite3_stmt* stmt = nullptr;
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			sqlite3_bind_text( stmt, 1, "StartupPlaylist", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_text( stmt, 2, WideStringToUTF8( playlist ).c_str(), -1 /*strLen*/, SQLITE_TRANSIENT );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-			sqlite3_finalize( stmt );
-		}
-	}
+	m_Values.Update( [ & ] ( ValueMap& values )
+	{
+		values[ "StartupPlaylist" ].SetText( WideStringToUTF8( playlist ) );
+	} );
 }
 
 std::wstring Settings::GetStartupFilename()
 {
 	std::wstring filename;
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		sqlite3_stmt* stmt = nullptr;
-		const std::string query = "SELECT Value FROM Settings WHERE Setting='StartupFilename';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( SQLITE_ROW == sqlite3_step( stmt ) ) {
-				const char* text = reinterpret_cast<const char*>( sqlite3_column_text( stmt, 0 /*columnIndex*/ ) );
-				if ( nullptr != text ) {
-					filename = UTF8ToWideString( text );
-				}
-			}
-			sqlite3_finalize( stmt );
+	const auto values = m_Values.Get();
+	if ( const auto setting = values->find( "StartupFilename" ); values->end() != setting ) {
+		const char* text = reinterpret_cast<const char*>( setting->second.GetText() );
+		if ( nullptr != text ) {
+			filename = UTF8ToWideString( text );
 		}
 	}
 	return filename;
@@ -1374,132 +1279,64 @@ std::wstring Settings::GetStartupFilename()
 
 void Settings::SetStartupFilename( const std::wstring& filename )
 {
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		const std::string query = "REPLACE INTO Settings (Setting,Value) VALUES (?1,?2);";
-		sqlite3_stmt* stmt = nullptr;
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			sqlite3_bind_text( stmt, 1, "StartupFilename", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_text( stmt, 2, WideStringToUTF8( filename ).c_str(), -1 /*strLen*/, SQLITE_TRANSIENT );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-			sqlite3_finalize( stmt );
-		}
-	}
+	m_Values.Update( [ & ] ( ValueMap& values )
+	{
+		values[ "StartupFilename" ].SetText( WideStringToUTF8( filename ) );
+	} );
 }
 
 void Settings::GetCounterSettings( LOGFONT& font, COLORREF& fontColour, bool& showRemaining )
 {
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		sqlite3_stmt* stmt = nullptr;
-		std::string query = "SELECT Value FROM Settings WHERE Setting='CounterFont';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				const int bytes = sqlite3_column_bytes( stmt, 0 /*columnIndex*/ );
-				if ( sizeof( LOGFONT ) == bytes ) {
-					font = *reinterpret_cast<const LOGFONT*>( sqlite3_column_blob( stmt, 0 /*columnIndex*/ ) );
-				}
-			}
-			sqlite3_finalize( stmt );
+	const auto values = m_Values.Get();
+	if ( const auto setting = values->find( "CounterFont" ); values->end() != setting ) {
+		const int bytes = setting->second.GetBytes();
+		if ( sizeof( LOGFONT ) == bytes ) {
+			font = *reinterpret_cast<const LOGFONT*>( setting->second.GetBlob() );
 		}
+	}
 
-		stmt = nullptr;
-		query = "SELECT Value FROM Settings WHERE Setting='CounterFontColour';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				fontColour = static_cast<COLORREF>( sqlite3_column_int( stmt, 0 /*columnIndex*/ ) );
-			}
-			sqlite3_finalize( stmt );
-		}
+	if ( const auto setting = values->find( "CounterFontColour" ); values->end() != setting ) {
+		fontColour = static_cast<COLORREF>( setting->second.GetInt() );
+	}
 
-		stmt = nullptr;
-		query = "SELECT Value FROM Settings WHERE Setting='CounterRemaining';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				showRemaining = ( 0 != sqlite3_column_int( stmt, 0 /*columnIndex*/ ) );
-			}
-			sqlite3_finalize( stmt );
-		}
+	if ( const auto setting = values->find( "CounterRemaining" ); values->end() != setting ) {
+		showRemaining = ( 0 != setting->second.GetInt() );
 	}
 }
 
 void Settings::SetCounterSettings( const LOGFONT& font, const COLORREF fontColour, const bool showRemaining )
 {
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		sqlite3_stmt* stmt = nullptr;
-		const std::string query = "REPLACE INTO Settings (Setting,Value) VALUES (?1,?2);";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			sqlite3_bind_text( stmt, 1, "CounterFont", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_blob( stmt, 2, &font, sizeof( LOGFONT ), SQLITE_STATIC );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-
-			sqlite3_bind_text( stmt, 1, "CounterFontColour", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, static_cast<int>( fontColour ) );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-
-			sqlite3_bind_text( stmt, 1, "CounterRemaining", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, showRemaining ? 1 : 0 );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-
-			sqlite3_finalize( stmt );
-			stmt = nullptr;
-		}
-	}
+	m_Values.Update( [ & ] ( ValueMap& values )
+	{
+		values[ "CounterFont" ].SetBlob( &font, sizeof( LOGFONT ) );
+		values[ "CounterFontColour" ].SetInt( static_cast<int>( fontColour ) );
+		values[ "CounterRemaining" ].SetInt( showRemaining ? 1 : 0 );
+	} );
 }
 
 void Settings::GetOutputSettings( std::wstring& deviceName, OutputMode& mode )
 {
 	deviceName.clear();
 	mode = OutputMode::Standard;
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		sqlite3_stmt* stmt = nullptr;
-		std::string query = "SELECT Value FROM Settings WHERE Setting='OutputDevice';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( SQLITE_ROW == sqlite3_step( stmt ) ) {
-				const char* text = reinterpret_cast<const char*>( sqlite3_column_text( stmt, 0 /*columnIndex*/ ) );
-				if ( nullptr != text ) {
-					deviceName = UTF8ToWideString( text );
-				}
-			}
-			sqlite3_finalize( stmt );
-		}
-		stmt = nullptr;
-		query = "SELECT Value FROM Settings WHERE Setting='OutputMode';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				mode = static_cast<OutputMode>( sqlite3_column_int( stmt, 0 /*columnIndex*/ ) );
-			}
-			sqlite3_finalize( stmt );
+	const auto values = m_Values.Get();
+	if ( const auto setting = values->find( "OutputDevice" ); values->end() != setting ) {
+		const char* text = reinterpret_cast<const char*>( setting->second.GetText() );
+		if ( nullptr != text ) {
+			deviceName = UTF8ToWideString( text );
 		}
 	}
+	if ( const auto setting = values->find( "OutputMode" ); values->end() != setting ) {
+		mode = static_cast<OutputMode>( setting->second.GetInt() );
+	}
 }
 
 void Settings::SetOutputSettings( const std::wstring& deviceName, const OutputMode mode )
 {
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		const std::string query = "REPLACE INTO Settings (Setting,Value) VALUES (?1,?2);";
-		sqlite3_stmt* stmt = nullptr;
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			sqlite3_bind_text( stmt, 1, "OutputDevice", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_text( stmt, 2, WideStringToUTF8( deviceName ).c_str(), -1 /*strLen*/, SQLITE_TRANSIENT );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-
-			sqlite3_bind_text( stmt, 1, "OutputMode", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, static_cast<int>( mode ) );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-
-			sqlite3_finalize( stmt );
-		}
-	}
+	m_Values.Update( [ & ] ( ValueMap& values )
+	{
+		values[ "OutputDevice" ].SetText( WideStringToUTF8( deviceName ) );
+		values[ "OutputMode" ].SetInt( static_cast<int>( mode ) );
+	} );
 }
 
 void Settings::GetDefaultMODSettings( long long& mod, long long& mtm, long long& s3m, long long& xm, long long& it )
@@ -1516,162 +1353,191 @@ void Settings::GetDefaultMODSettings( long long& mod, long long& mtm, long long&
 void Settings::GetMODSettings( long long& mod, long long& mtm, long long& s3m, long long& xm, long long& it )
 {
 	GetDefaultMODSettings( mod, mtm, s3m, xm, it );
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		sqlite3_stmt* stmt = nullptr;
-		std::string query = "SELECT Value FROM Settings WHERE Setting='MOD';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				mod = sqlite3_column_int64( stmt, 0 /*columnIndex*/ );
-			}
-			sqlite3_finalize( stmt );
-		}
-		stmt = nullptr;
-		query = "SELECT Value FROM Settings WHERE Setting='MTM';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				mtm = sqlite3_column_int64( stmt, 0 /*columnIndex*/ );
-			}
-			sqlite3_finalize( stmt );
-		}
-		stmt = nullptr;
-		query = "SELECT Value FROM Settings WHERE Setting='S3M';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				s3m = sqlite3_column_int64( stmt, 0 /*columnIndex*/ );
-			}
-			sqlite3_finalize( stmt );
-		}
-		stmt = nullptr;
-		query = "SELECT Value FROM Settings WHERE Setting='XM';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				xm = sqlite3_column_int64( stmt, 0 /*columnIndex*/ );
-			}
-			sqlite3_finalize( stmt );
+	const auto values = m_Values.Get();
+	if ( const auto setting = values->find( "MOD" ); values->end() != setting ) {
+		mod = setting->second.GetInt64();
+	}
+	if ( const auto setting = values->find( "MTM" ); values->end() != setting ) {
+		mtm = setting->second.GetInt64();
+	}
+	if ( const auto setting = values->find( "S3M" ); values->end() != setting ) {
+		s3m = setting->second.GetInt64();
+	}
+	if ( const auto setting = values->find( "XM" ); values->end() != setting ) {
+		xm = setting->second.GetInt64();
+	}
+	if ( const auto setting = values->find( "IT" ); values->end() != setting ) {
+		it = setting->second.GetInt64();
+	}
+}
+
+void Settings::SetMODSettings( const long long mod, const long long mtm, const long long s3m, const long long xm, const long long it )
+{
+	m_Values.Update( [ & ] ( ValueMap& values )
+	{
+		values[ "MOD" ].SetInt64( mod );
+		values[ "MTM" ].SetInt64( mtm );
+		values[ "S3M" ].SetInt64( s3m );
+		values[ "XM" ].SetInt64( xm );
+		values[ "IT" ].SetInt64( it );
+	} );
+}
+
+void Settings::GetDefaultGainSettings( GainMode& gainMode, LimitMode& limitMode, float& preamp )
+{
+	gainMode = GainMode::Disabled;
+	limitMode = LimitMode::Soft;
+	preamp = 4.0f;
+}
+
+void Settings::GetGainSettings( GainMode& gainMode, LimitMode& limitMode, float& preamp )
+{
+	GetDefaultGainSettings( gainMode, limitMode, preamp );
+	const auto values = m_Values.Get();
+	if ( const auto setting = values->find( "GainMode" ); values->end() != setting ) {
+		const int value = setting->second.GetInt();
+		if ( ( value >= static_cast<int>( GainMode::Disabled ) ) && ( value <= static_cast<int>( GainMode::Album ) ) ) {
+			gainMode = static_cast<GainMode>( value );
 		}
-		stmt = nullptr;
-		query = "SELECT Value FROM Settings WHERE Setting='IT';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				it = sqlite3_column_int64( stmt, 0 /*columnIndex*/ );
-			}
-			sqlite3_finalize( stmt );
+	}
+	if ( const auto setting = values->find( "GainPreamp" ); values->end() != setting ) {
+		preamp = static_cast<float>( setting->second.GetDouble() );
+	}
+	if ( const auto setting = values->find( "GainLimit" ); values->end() != setting ) {
+		const int value = setting->second.GetInt();
+		if ( ( value >= static_cast<int>( LimitMode::None ) ) && ( value <= static_cast<int>( LimitMode::LookAhead ) ) ) {
+			limitMode = static_cast<LimitMode>( value );
 		}
 	}
 }
 
-void Settings::SetMODSettings( const long long mod, const long long mtm, const long long s3m, const long long xm, const long long it )
+void Settings::SetGainSettings( const GainMode gainMode, const LimitMode limitMode, const float preamp )
 {
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		sqlite3_stmt* stmt = nullptr;
-		const std::string query = "REPLACE INTO Settings (Setting,Value) VALUES (?1,?2);";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			sqlite3_bind_text( stmt, 1, "MOD", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int64( stmt, 2, mod );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-
-			sqlite3_bind_text( stmt, 1, "MTM", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int64( stmt, 2, mtm );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-
-			sqlite3_bind_text( stmt, 1, "S3M", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int64( stmt, 2, s3m );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-
-			sqlite3_bind_text( stmt, 1, "XM", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int64( stmt, 2, xm );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-
-			sqlite3_bind_text( stmt, 1, "IT", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int64( stmt, 2, it );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
+	m_Values.Update( [ & ] ( ValueMap& values )
+	{
+		values[ "GainMode" ].SetInt( static_cast<int>( gainMode ) );
+		values[ "GainPreamp" ].SetDouble( preamp );
+		values[ "GainLimit" ].SetInt( static_cast<int>( limitMode ) );
+	} );
+}
+
+void Settings::GetDefaultLimiterSettings( float& lookAhead, float& release )
+{
+	lookAhead = 5.0f;
+	release = 200.0f;
+}
+
+void Settings::GetLimiterSettings( float& lookAhead, float& release )
+{
+	GetDefaultLimiterSettings( lookAhead, release );
+	const auto values = m_Values.Get();
+	if ( const auto setting = values->find( "LimiterLookAhead" ); values->end() != setting ) {
+		const auto [ minLookAhead, maxLookAhead ] = Limiter::GetLookAheadRange();
+		const float value = static_cast<float>( setting->second.GetDouble() );
+		if ( ( value >= minLookAhead ) && ( value <= maxLookAhead ) ) {
+			lookAhead = value;
+		}
+	}
+	if ( const auto setting = values->find( "LimiterRelease" ); values->end() != setting ) {
+		const auto [ minRelease, maxRelease ] = Limiter::GetReleaseRange();
+		const float value = static_cast<float>( setting->second.GetDouble() );
+		if ( ( value >= minRelease ) && ( value <= maxRelease ) ) {
+			release = value;
+		}
+	}
+}
 
-			sqlite3_finalize( stmt );
-			stmt = nullptr;
+void Settings::SetLimiterSettings( const float lookAhead, const float release )
+{
+	m_Values.Update( [ & ] ( ValueMap& values )
+	{
+		values[ "LimiterLookAhead" ].SetDouble( lookAhead );
+		values[ "LimiterRelease" ].SetDouble( release );
+	} );
+}
+
+Settings::ResamplerQuality Settings::GetResamplerQuality()
+{
+	ResamplerQuality quality = ResamplerQuality::Disabled;
+	const auto values = m_Values.Get();
+	if ( const auto setting = values->find( "ResamplerQuality" ); values->end() != setting ) {
+		const int value = setting->second.GetInt();
+		if ( ( value >= static_cast<int>( ResamplerQuality::Disabled ) ) && ( value <= static_cast<int>( ResamplerQuality::High ) ) ) {
+			quality = static_cast<ResamplerQuality>( value );
 		}
 	}
+	return quality;
 }
 
-void Settings::GetDefaultGainSettings( GainMode& gainMode, LimitMode& limitMode, float& preamp )
+void Settings::SetResamplerQuality( const ResamplerQuality quality )
 {
-	gainMode = GainMode::Disabled;
-	limitMode = LimitMode::Soft;
-	preamp = 4.0f;
+	m_Values.Update( [ & ] ( ValueMap& values )
+	{
+		values[ "ResamplerQuality" ].SetInt( static_cast<int>( quality ) );
+	} );
 }
 
-void Settings::GetGainSettings( GainMode& gainMode, LimitMode& limitMode, float& preamp )
+void Settings::GetPreloadSettings( long& windowSize, long& shuffleCandidates, long& memoryLimit )
 {
-	GetDefaultGainSettings( gainMode, limitMode, preamp );
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		sqlite3_stmt* stmt = nullptr;
-		std::string query = "SELECT Value FROM Settings WHERE Setting='GainMode';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				const int value = sqlite3_column_int( stmt, 0 /*columnIndex*/ );
-				if ( ( value >= static_cast<int>( GainMode::Disabled ) ) && ( value <= static_cast<int>( GainMode::Album ) ) ) {
-					gainMode = static_cast<GainMode>( value );
-				}
-			}
-			sqlite3_finalize( stmt );
+	windowSize = kPreloadWindowSizeDefault;
+	shuffleCandidates = kPreloadShuffleCandidatesDefault;
+	memoryLimit = kPreloadMemoryLimitDefault;
+	const auto values = m_Values.Get();
+	if ( const auto setting = values->find( "PreloadWindowSize" ); values->end() != setting ) {
+		const long value = static_cast<long>( setting->second.GetInt() );
+		if ( ( value >= kPreloadCountMinimum ) && ( value <= kPreloadCountMaximum ) ) {
+			windowSize = value;
 		}
-		stmt = nullptr;
-		query = "SELECT Value FROM Settings WHERE Setting='GainPreamp';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				preamp = static_cast<float>( sqlite3_column_double( stmt, 0 /*columnIndex*/ ) );
-			}
-			sqlite3_finalize( stmt );
+	}
+	if ( const auto setting = values->find( "PreloadShuffleCandidates" ); values->end() != setting ) {
+		const long value = static_cast<long>( setting->second.GetInt() );
+		if ( ( value >= kPreloadCountMinimum ) && ( value <= kPreloadCountMaximum ) ) {
+			shuffleCandidates = value;
 		}
-		stmt = nullptr;
-		query = "SELECT Value FROM Settings WHERE Setting='GainLimit';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				const int value = sqlite3_column_int( stmt, 0 /*columnIndex*/ );
-				if ( ( value >= static_cast<int>( LimitMode::None ) ) && ( value <= static_cast<int>( LimitMode::Soft ) ) ) {
-					limitMode = static_cast<LimitMode>( value );
-				}
-			}
-			sqlite3_finalize( stmt );
+	}
+	if ( const auto setting = values->find( "PreloadMemoryLimit" ); values->end() != setting ) {
+		const long value = static_cast<long>( setting->second.GetInt() );
+		if ( ( value >= kPreloadMemoryLimitMinimum ) && ( value <= kPreloadMemoryLimitMaximum ) ) {
+			memoryLimit = value;
 		}
 	}
 }
 
-void Settings::SetGainSettings( const GainMode gainMode, const LimitMode limitMode, const float preamp )
+void Settings::SetPreloadSettings( const long windowSize, const long shuffleCandidates, const long memoryLimit )
 {
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		sqlite3_stmt* stmt = nullptr;
-		const std::string query = "REPLACE INTO Settings (Setting,Value) VALUES (?1,?2);";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			sqlite3_bind_text( stmt, 1, "GainMode", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, static_cast<int>( gainMode ) );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-
-			sqlite3_bind_text( stmt, 1, "GainPreamp", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_double( stmt, 2, preamp );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-
-			sqlite3_bind_text( stmt, 1, "GainLimit", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, static_cast<int>( limitMode ) );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
+	m_Values.Update( [ & ] ( ValueMap& values )
+	{
+		values[ "PreloadWindowSize" ].SetInt( std::clamp( windowSize, kPreloadCountMinimum, kPreloadCountMaximum ) );
+		values[ "PreloadShuffleCandidates" ].SetInt( std::clamp( shuffleCandidates, kPreloadCountMinimum, kPreloadCountMaximum ) );
+		values[ "PreloadMemoryLimit" ].SetInt( std::clamp( memoryLimit, kPreloadMemoryLimitMinimum, kPreloadMemoryLimitMaximum ) );
+	} );
+}
 
-			sqlite3_finalize( stmt );
-			stmt = nullptr;
+void Settings::GetDecodeAheadSettings( bool& enable, long& memoryLimit )
+{
+	enable = false;
+	memoryLimit = kDecodeAheadMemoryLimitDefault;
+	const auto values = m_Values.Get();
+	if ( const auto setting = values->find( "DecodeAheadEnable" ); values->end() != setting ) {
+		enable = ( 0 != setting->second.GetInt() );
+	}
+	if ( const auto setting = values->find( "DecodeAheadMemoryLimit" ); values->end() != setting ) {
+		const long value = static_cast<long>( setting->second.GetInt() );
+		if ( ( value >= kDecodeAheadMemoryLimitMinimum ) && ( value <= kDecodeAheadMemoryLimitMaximum ) ) {
+			memoryLimit = value;
 		}
 	}
 }
 
+void Settings::SetDecodeAheadSettings( const bool enable, const long memoryLimit )
+{
+	m_Values.Update( [ & ] ( ValueMap& values )
+	{
+		values[ "DecodeAheadEnable" ].SetInt( enable ? 1 : 0 );
+		values[ "DecodeAheadMemoryLimit" ].SetInt( std::clamp( memoryLimit, kDecodeAheadMemoryLimitMinimum, kDecodeAheadMemoryLimitMaximum ) );
+	} );
+}
+
 void Settings::GetSystraySettings( bool& enable, bool& minimise, SystrayCommand& singleClick, SystrayCommand& doubleClick, SystrayCommand& tripleClick, SystrayCommand& quadClick )
 {
 	enable = false;
@@ -1680,112 +1546,50 @@ void Settings::GetSystraySettings( bool& enable, bool& minimise, SystrayCommand&
 	doubleClick = SystrayCommand::None;
 	tripleClick = SystrayCommand::None;
 	quadClick = SystrayCommand::None;
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		sqlite3_stmt* stmt = nullptr;
-		std::string query = "SELECT Value FROM Settings WHERE Setting='SysTrayEnable';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				enable = ( 0 != sqlite3_column_int( stmt, 0 /*columnIndex*/ ) );
-			}
-			sqlite3_finalize( stmt );
-		}
-		stmt = nullptr;
-		query = "SELECT Value FROM Settings WHERE Setting='SysTrayMinimise';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				minimise = ( 0 != sqlite3_column_int( stmt, 0 /*columnIndex*/ ) );
-			}
-			sqlite3_finalize( stmt );
-		}
-		stmt = nullptr;
-		query = "SELECT Value FROM Settings WHERE Setting='SysTraySingleClick';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				const int value = sqlite3_column_int( stmt, 0 /*columnIndex*/ );
-				if ( ( value >= static_cast<int>( SystrayCommand::None ) ) && ( value <= static_cast<int>( SystrayCommand::ShowHide ) ) ) {
-					singleClick = static_cast<SystrayCommand>( value );
-				}
-			}
-			sqlite3_finalize( stmt );
+	const auto values = m_Values.Get();
+	if ( const auto setting = values->find( "SysTrayEnable" ); values->end() != setting ) {
+		enable = ( 0 != setting->second.GetInt() );
+	}
+	if ( const auto setting = values->find( "SysTrayMinimise" ); values->end() != setting ) {
+		minimise = ( 0 != setting->second.GetInt() );
+	}
+	if ( const auto setting = values->find( "SysTraySingleClick" ); values->end() != setting ) {
+		const int value = setting->second.GetInt();
+		if ( ( value >= static_cast<int>( SystrayCommand::None ) ) && ( value <= static_cast<int>( SystrayCommand::ShowHide ) ) ) {
+			singleClick = static_cast<SystrayCommand>( value );
 		}
-		stmt = nullptr;
-		query = "SELECT Value FROM Settings WHERE Setting='SysTrayDoubleClick';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				const int value = sqlite3_column_int( stmt, 0 /*columnIndex*/ );
-				if ( ( value >= static_cast<int>( SystrayCommand::None ) ) && ( value <= static_cast<int>( SystrayCommand::ShowHide ) ) ) {
-					doubleClick = static_cast<SystrayCommand>( value );
-				}
-			}
-			sqlite3_finalize( stmt );
+	}
+	if ( const auto setting = values->find( "SysTrayDoubleClick" ); values->end() != setting ) {
+		const int value = setting->second.GetInt();
+		if ( ( value >= static_cast<int>( SystrayCommand::None ) ) && ( value <= static_cast<int>( SystrayCommand::ShowHide ) ) ) {
+			doubleClick = static_cast<SystrayCommand>( value );
 		}
-		stmt = nullptr;
-		query = "SELECT Value FROM Settings WHERE Setting='SysTrayTripleClick';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				const int value = sqlite3_column_int( stmt, 0 /*columnIndex*/ );
-				if ( ( value >= static_cast<int>( SystrayCommand::None ) ) && ( value <= static_cast<int>( SystrayCommand::ShowHide ) ) ) {
-					tripleClick = static_cast<SystrayCommand>( value );
-				}
-			}
-			sqlite3_finalize( stmt );
+	}
+	if ( const auto setting = values->find( "SysTrayTripleClick" ); values->end() != setting ) {
+		const int value = setting->second.GetInt();
+		if ( ( value >= static_cast<int>( SystrayCommand::None ) ) && ( value <= static_cast<int>( SystrayCommand::ShowHide ) ) ) {
+			tripleClick = static_cast<SystrayCommand>( value );
 		}
-		stmt = nullptr;
-		query = "SELECT Value FROM Settings WHERE Setting='SysTrayQuadrupleClick';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				const int value = sqlite3_column_int( stmt, 0 /*columnIndex*/ );
-				if ( ( value >= static_cast<int>( SystrayCommand::None ) ) && ( value <= static_cast<int>( SystrayCommand::ShowHide ) ) ) {
-					quadClick = static_cast<SystrayCommand>( value );
-				}
-			}
-			sqlite3_finalize( stmt );
+	}
+	if ( const auto setting = values->find( "SysTrayQuadrupleClick" ); values->end() != setting ) {
+		const int value = setting->second.GetInt();
+		if ( ( value >= static_cast<int>( SystrayCommand::None ) ) && ( value <= static_cast<int>( SystrayCommand::ShowHide ) ) ) {
+			quadClick = static_cast<SystrayCommand>( value );
 		}
 	}
 }
 
 void Settings::SetSystraySettings( const bool enable, const bool minimise, const SystrayCommand singleClick, const SystrayCommand doubleClick, const SystrayCommand tripleClick, const SystrayCommand quadClick )
 {
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		sqlite3_stmt* stmt = nullptr;
-		const std::string query = "REPLACE INTO Settings (Setting,Value) VALUES (?1,?2);";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			sqlite3_bind_text( stmt, 1, "SysTrayEnable", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, enable );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-
-			sqlite3_bind_text( stmt, 1, "SysTrayMinimise", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, minimise );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-
-			sqlite3_bind_text( stmt, 1, "SysTraySingleClick", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, static_cast<int>( singleClick ) );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-
-			sqlite3_bind_text( stmt, 1, "SysTrayDoubleClick", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, static_cast<int>( doubleClick ) );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-
-			sqlite3_bind_text( stmt, 1, "SysTrayTripleClick", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, static_cast<int>( tripleClick ) );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-
-			sqlite3_bind_text( stmt, 1, "SysTrayQuadrupleClick", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, static_cast<int>( quadClick ) );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-
-			sqlite3_finalize( stmt );
-			stmt = nullptr;
-		}
-	}
+	m_Values.Update( [ & ] ( ValueMap& values )
+	{
+		values[ "SysTrayEnable" ].SetInt( enable );
+		values[ "SysTrayMinimise" ].SetInt( minimise );
+		values[ "SysTraySingleClick" ].SetInt( static_cast<int>( singleClick ) );
+		values[ "SysTrayDoubleClick" ].SetInt( static_cast<int>( doubleClick ) );
+		values[ "SysTrayTripleClick" ].SetInt( static_cast<int>( tripleClick ) );
+		values[ "SysTrayQuadrupleClick" ].SetInt( static_cast<int>( quadClick ) );
+	} );
 }
 
 void Settings::GetPlaybackSettings( bool& randomPlay, bool& repeatTrack, bool& repeatPlaylist, bool& crossfade )
@@ -1794,40 +1598,18 @@ void Settings::GetPlaybackSettings( bool& randomPlay, bool& repeatTrack, bool& r
 	repeatTrack = false;
 	repeatPlaylist = false;
 	crossfade = false;
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		sqlite3_stmt* stmt = nullptr;
-		std::string query = "SELECT Value FROM Settings WHERE Setting='RandomPlay';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				randomPlay = ( 0 != sqlite3_column_int( stmt, 0 /*columnIndex*/ ) );
-			}
-			sqlite3_finalize( stmt );
-		}
-		stmt = nullptr;
-		query = "SELECT Value FROM Settings WHERE Setting='RepeatTrack';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				repeatTrack = ( 0 != sqlite3_column_int( stmt, 0 /*columnIndex*/ ) );
-			}
-			sqlite3_finalize( stmt );
-		}
-		stmt = nullptr;
-		query = "SELECT Value FROM Settings WHERE Setting='RepeatPlaylist';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				repeatPlaylist = ( 0 != sqlite3_column_int( stmt, 0 /*columnIndex*/ ) );
-			}
-			sqlite3_finalize( stmt );
-		}
-		stmt = nullptr;
-		query = "SELECT Value FROM Settings WHERE Setting='Crossfade';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				crossfade = ( 0 != sqlite3_column_int( stmt, 0 /*columnIndex*/ ) );
-			}
-			sqlite3_finalize( stmt );
-		}
+	const auto values = m_Values.Get();
+	if ( const auto setting = values->find( "RandomPlay" ); values->end() != setting ) {
+		randomPlay = ( 0 != setting->second.GetInt() );
+	}
+	if ( const auto setting = values->find( "RepeatTrack" ); values->end() != setting ) {
+		repeatTrack = ( 0 != setting->second.GetInt() );
+	}
+	if ( const auto setting = values->find( "RepeatPlaylist" ); values->end() != setting ) {
+		repeatPlaylist = ( 0 != setting->second.GetInt() );
+	}
+	if ( const auto setting = values->find( "Crossfade" ); values->end() != setting ) {
+		crossfade = ( 0 != setting->second.GetInt() );
 	}
 	if ( randomPlay ) {
 		repeatTrack = repeatPlaylist = false;
@@ -1840,55 +1622,31 @@ void Settings::GetPlaybackSettings( bool& randomPlay, bool& repeatTrack, bool& r
 
 void Settings::SetPlaybackSettings( const bool randomPlay, const bool repeatTrack, const bool repeatPlaylist, const bool crossfade )
 {
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		sqlite3_stmt* stmt = nullptr;
-		const std::string query = "REPLACE INTO Settings (Setting,Value) VALUES (?1,?2);";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			sqlite3_bind_text( stmt, 1, "RandomPlay", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, randomPlay );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-
-			sqlite3_bind_text( stmt, 1, "RepeatTrack", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, repeatTrack );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-
-			sqlite3_bind_text( stmt, 1, "RepeatPlaylist", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, repeatPlaylist );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-
-			sqlite3_bind_text( stmt, 1, "Crossfade", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, crossfade );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-
-			sqlite3_finalize( stmt );
-			stmt = nullptr;
-		}
-	}
+	m_Values.Update( [ & ] ( ValueMap& values )
+	{
+		values[ "RandomPlay" ].SetInt( randomPlay );
+		values[ "RepeatTrack" ].SetInt( repeatTrack );
+		values[ "RepeatPlaylist" ].SetInt( repeatPlaylist );
+		values[ "Crossfade" ].SetInt( crossfade );
+	} );
 }
 
 void Settings::GetHotkeySettings( bool& enable, HotkeyList& hotkeys )
 {
 	enable = false;
 	hotkeys.clear();
+	{
+		const auto values = m_Values.Get();
+		if ( const auto setting = values->find( "EnableHotkeys" ); values->end() != setting ) {
+			enable = ( 0 != setting->second.GetInt() );
+		}
+	}
+
 	sqlite3* database = m_Database.GetDatabase();
 	if ( nullptr != database ) {
 		sqlite3_stmt* stmt = nullptr;
-		std::string query = "SELECT Value FROM Settings WHERE Setting='EnableHotkeys';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				enable = ( 0 != sqlite3_column_int( stmt, 0 /*columnIndex*/ ) );
-			}
-			sqlite3_finalize( stmt );
-		}
-
-		stmt = nullptr;
-		query = "SELECT * FROM Hotkeys;";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
+		const std::string query = "SELECT * FROM Hotkeys;";
+		if ( SQLITE_OK == m_Database.PrepareStatement( query, &stmt ) ) {
 			while ( SQLITE_ROW == sqlite3_step( stmt ) ) {
 				Hotkey hotkey = {};
 				const int columnCount = sqlite3_column_count( stmt );
@@ -1915,33 +1673,27 @@ void Settings::GetHotkeySettings( bool& enable, HotkeyList& hotkeys )
 					hotkeys.push_back( hotkey );
 				}
 			}
-			sqlite3_finalize( stmt );
+			m_Database.ReleaseStatement( stmt );
 		}
 	}
 }
 
 void Settings::SetHotkeySettings( const bool enable, const HotkeyList& hotkeys )
 {
+	m_Values.Update( [ & ] ( ValueMap& values )
+	{
+		values[ "EnableHotkeys" ].SetInt( enable );
+	} );
+
 	sqlite3* database = m_Database.GetDatabase();
 	if ( nullptr != database ) {
-		sqlite3_stmt* stmt = nullptr;
-		std::string query = "REPLACE INTO Settings (Setting,Value) VALUES (?1,?2);";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			sqlite3_bind_text( stmt, 1, "EnableHotkeys", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, enable );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-			sqlite3_finalize( stmt );
-			stmt = nullptr;
-		}
-
-		query = "DELETE FROM Hotkeys;";
+		std::string query = "DELETE FROM Hotkeys;";
 		sqlite3_exec( database, query.c_str(), NULL /*callback*/, NULL /*arg*/, NULL /*errMsg*/ );
 		
 		if ( !hotkeys.empty() ) {
-			stmt = nullptr;
+			sqlite3_stmt* stmt = nullptr;
 			query = "INSERT INTO Hotkeys (ID,Hotkey,Alt,Ctrl,Shift,Keyname) VALUES (?1,?2,?3,?4,?5,?6);";
-			if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
+			if ( SQLITE_OK == m_Database.PrepareStatement( query, &stmt ) ) {
 				for ( const auto& hotkey : hotkeys ) {
 					sqlite3_bind_int( stmt, 1, hotkey.ID );
 					sqlite3_bind_int( stmt, 2, hotkey.Code );
@@ -1952,7 +1704,7 @@ void Settings::SetHotkeySettings( const bool enable, const HotkeyList& hotkeys )
 					sqlite3_step( stmt );
 					sqlite3_reset( stmt );
 				}
-				sqlite3_finalize( stmt );
+				m_Database.ReleaseStatement( stmt );
 				stmt = nullptr;
 			}
 		}
@@ -1962,18 +1714,11 @@ void Settings::SetHotkeySettings( const bool enable, const HotkeyList& hotkeys )
 Settings::PitchRange Settings::GetPitchRange()
 {
 	PitchRange range = PitchRange::Small;
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		sqlite3_stmt* stmt = nullptr;
-		const std::string query = "SELECT Value FROM Settings WHERE Setting='PitchRange';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( SQLITE_ROW == sqlite3_step( stmt ) ) {
-				const int value = sqlite3_column_int( stmt, 0 /*columnIndex*/ );
-				if ( ( value >= static_cast<int>( PitchRange::Small ) ) && ( value <= static_cast<int>( PitchRange::Large ) ) ) {
-					range = static_cast<PitchRange>( value );
-				}
-			}
-			sqlite3_finalize( stmt );
+	const auto values = m_Values.Get();
+	if ( const auto setting = values->find( "PitchRange" ); values->end() != setting ) {
+		const int value = setting->second.GetInt();
+		if ( ( value >= static_cast<int>( PitchRange::Small ) ) && ( value <= static_cast<int>( PitchRange::Large ) ) ) {
+			range = static_cast<PitchRange>( value );
 		}
 	}
 	return range;
@@ -1981,17 +1726,10 @@ Settings::PitchRange Settings::GetPitchRange()
 
 void Settings::SetPitchRange( const PitchRange range )
 {
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		const std::string query = "REPLACE INTO Settings (Setting,Value) VALUES (?1,?2);";
-		sqlite3_stmt* stmt = nullptr;
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			sqlite3_bind_text( stmt, 1, "PitchRange", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, static_cast<int>( range ) );
-			sqlite3_step( stmt );
-			sqlite3_finalize( stmt );
-		}
-	}
+	m_Values.Update( [ & ] ( ValueMap& values )
+	{
+		values[ "PitchRange" ].SetInt( static_cast<int>( range ) );
+	} );
 }
 
 Settings::PitchRangeMap Settings::GetPitchRangeOptions() const
@@ -2002,33 +1740,19 @@ Settings::PitchRangeMap Settings::GetPitchRangeOptions() const
 int Settings::GetOutputControlType()
 {
 	int type = 0;
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		sqlite3_stmt* stmt = nullptr;
-		const std::string query = "SELECT Value FROM Settings WHERE Setting='OutputControlType';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( SQLITE_ROW == sqlite3_step( stmt ) ) {
-				type = sqlite3_column_int( stmt, 0 /*columnIndex*/ );
-			}
-			sqlite3_finalize( stmt );
-		}
+	const auto values = m_Values.Get();
+	if ( const auto setting = values->find( "OutputControlType" ); values->end() != setting ) {
+		type = setting->second.GetInt();
 	}
 	return type;
 }
 
 void Settings::SetOutputControlType( const int type )
 {
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		const std::string query = "REPLACE INTO Settings (Setting,Value) VALUES (?1,?2);";
-		sqlite3_stmt* stmt = nullptr;
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			sqlite3_bind_text( stmt, 1, "OutputControlType", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, type );
-			sqlite3_step( stmt );
-			sqlite3_finalize( stmt );
-		}
-	}
+	m_Values.Update( [ & ] ( ValueMap& values )
+	{
+		values[ "OutputControlType" ].SetInt( type );
+	} );
 }
 
 void Settings::GetExtractSettings( std::wstring& folder, std::wstring& filename, bool& addToLibrary, bool& joinTracks )
@@ -2037,47 +1761,25 @@ void Settings::GetExtractSettings( std::wstring& folder, std::wstring& filename,
 	filename.clear();
 	addToLibrary = true;
 	joinTracks = false;
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		sqlite3_stmt* stmt = nullptr;
-		std::string query = "SELECT Value FROM Settings WHERE Setting='ExtractFolder';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				const unsigned char* text = sqlite3_column_text( stmt, 0 /*columnIndex*/ );
-				if ( nullptr != text ) {
-					folder = UTF8ToWideString( reinterpret_cast<const char*>( text ) );
-				}
-			}
-			sqlite3_finalize( stmt );
-		}
-		stmt = nullptr;
-		query = "SELECT Value FROM Settings WHERE Setting='ExtractFilename';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				const unsigned char* text = sqlite3_column_text( stmt, 0 /*columnIndex*/ );
-				if ( nullptr != text ) {
-					filename = UTF8ToWideString( reinterpret_cast<const char*>( text ) );
-				}
-			}
-			sqlite3_finalize( stmt );
+	const auto values = m_Values.Get();
+	if ( const auto setting = values->find( "ExtractFolder" ); values->end() != setting ) {
+		const unsigned char* text = setting->second.GetText();
+		if ( nullptr != text ) {
+			folder = UTF8ToWideString( reinterpret_cast<const char*>( text ) );
 		}
-		stmt = nullptr;
-		query = "SELECT Value FROM Settings WHERE Setting='ExtractToLibrary';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				addToLibrary = ( 0 != sqlite3_column_int( stmt, 0 /*columnIndex*/ ) );
-			}
-			sqlite3_finalize( stmt );
-		}
-		stmt = nullptr;
-		query = "SELECT Value FROM Settings WHERE Setting='ExtractJoin';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				joinTracks = ( 0 != sqlite3_column_int( stmt, 0 /*columnIndex*/ ) );
-			}
-			sqlite3_finalize( stmt );
+	}
+	if ( const auto setting = values->find( "ExtractFilename" ); values->end() != setting ) {
+		const unsigned char* text = setting->second.GetText();
+		if ( nullptr != text ) {
+			filename = UTF8ToWideString( reinterpret_cast<const char*>( text ) );
 		}
 	}
+	if ( const auto setting = values->find( "ExtractToLibrary" ); values->end() != setting ) {
+		addToLibrary = ( 0 != setting->second.GetInt() );
+	}
+	if ( const auto setting = values->find( "ExtractJoin" ); values->end() != setting ) {
+		joinTracks = ( 0 != setting->second.GetInt() );
+	}
 	if ( folder.empty() || !FolderExists( folder ) ) {
 		PWSTR path = nullptr;
 		HRESULT hr = SHGetKnownFolderPath( FOLDERID_Music, KF_FLAG_DEFAULT, NULL /*token*/, &path );
@@ -2093,108 +1795,54 @@ void Settings::GetExtractSettings( std::wstring& folder, std::wstring& filename,
 
 void Settings::SetExtractSettings( const std::wstring& folder, const std::wstring& filename, const bool addToLibrary, const bool joinTracks )
 {
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		sqlite3_stmt* stmt = nullptr;
-		const std::string query = "REPLACE INTO Settings (Setting,Value) VALUES (?1,?2);";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			sqlite3_bind_text( stmt, 1, "ExtractFolder", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_text( stmt, 2, WideStringToUTF8( folder ).c_str(), -1 /*strLen*/, SQLITE_TRANSIENT );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-
-			sqlite3_bind_text( stmt, 1, "ExtractFilename", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_text( stmt, 2, WideStringToUTF8( filename ).c_str(), -1 /*strLen*/, SQLITE_TRANSIENT );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-
-			sqlite3_bind_text( stmt, 1, "ExtractToLibrary", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, addToLibrary );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-
-			sqlite3_bind_text( stmt, 1, "ExtractJoin", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, joinTracks );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-
-			sqlite3_finalize( stmt );
-			stmt = nullptr;
-		}
-	}
+	m_Values.Update( [ & ] ( ValueMap& values )
+	{
+		values[ "ExtractFolder" ].SetText( WideStringToUTF8( folder ) );
+		values[ "ExtractFilename" ].SetText( WideStringToUTF8( filename ) );
+		values[ "ExtractToLibrary" ].SetInt( addToLibrary );
+		values[ "ExtractJoin" ].SetInt( joinTracks );
+	} );
 }
 
 Settings::EQ Settings::GetEQSettings()
 {
 	EQ eq;
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		sqlite3_stmt* stmt = nullptr;
-		std::string query = "SELECT Value FROM Settings WHERE Setting='EQVisible';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				eq.Visible = ( 0 != sqlite3_column_int( stmt, 0 /*columnIndex*/ ) );
-			}
-			sqlite3_finalize( stmt );
-		}
+	const auto values = m_Values.Get();
+	if ( const auto setting = values->find( "EQVisible" ); values->end() != setting ) {
+		eq.Visible = ( 0 != setting->second.GetInt() );
+	}
 
-		stmt = nullptr;
-		query = "SELECT Value FROM Settings WHERE Setting='EQX';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				eq.X = sqlite3_column_int( stmt, 0 /*columnIndex*/ );
-			}
-			sqlite3_finalize( stmt );
-		}
+	if ( const auto setting = values->find( "EQX" ); values->end() != setting ) {
+		eq.X = setting->second.GetInt();
+	}
 
-		stmt = nullptr;
-		query = "SELECT Value FROM Settings WHERE Setting='EQY';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				eq.Y = sqlite3_column_int( stmt, 0 /*columnIndex*/ );
-			}
-			sqlite3_finalize( stmt );
-		}
+	if ( const auto setting = values->find( "EQY" ); values->end() != setting ) {
+		eq.Y = setting->second.GetInt();
+	}
 
-		stmt = nullptr;
-		query = "SELECT Value FROM Settings WHERE Setting='EQEnable';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				eq.Enabled = ( 0 != sqlite3_column_int( stmt, 0 /*columnIndex*/ ) );
-			}
-			sqlite3_finalize( stmt );
-		}
+	if ( const auto setting = values->find( "EQEnable" ); values->end() != setting ) {
+		eq.Enabled = ( 0 != setting->second.GetInt() );
+	}
 
-		stmt = nullptr;
-		query = "SELECT Value FROM Settings WHERE Setting='EQPreamp';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				float preamp = static_cast<float>( sqlite3_column_double( stmt, 0 /*columnIndex*/ ) );
-				if ( preamp < EQ::MinGain ) {
-					preamp = EQ::MinGain;
-				} else if ( preamp > EQ::MaxGain ) {
-					preamp = EQ::MaxGain;
-				}
-				eq.Preamp = preamp;
-			}
-			sqlite3_finalize( stmt );
+	if ( const auto setting = values->find( "EQPreamp" ); values->end() != setting ) {
+		float preamp = static_cast<float>( setting->second.GetDouble() );
+		if ( preamp < EQ::MinGain ) {
+			preamp = EQ::MinGain;
+		} else if ( preamp > EQ::MaxGain ) {
+			preamp = EQ::MaxGain;
 		}
+		eq.Preamp = preamp;
+	}
 
-		for ( auto& gainIter : eq.Gains ) {
-			stmt = nullptr;
-			query = "SELECT Value FROM Settings WHERE Setting='EQ" + std::to_string( gainIter.first ) + "';";
-			if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-				if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-					float gain = static_cast<float>( sqlite3_column_double( stmt, 0 /*columnIndex*/ ) );
-					if ( gain < EQ::MinGain ) {
-						gain = EQ::MinGain;
-					} else if ( gain > EQ::MaxGain ) {
-						gain = EQ::MaxGain;
-					}
-					gainIter.second = gain;
-				}
-				sqlite3_finalize( stmt );
+	for ( auto& gainIter : eq.Gains ) {
+		if ( const auto setting = values->find( "EQ" + std::to_string( gainIter.first ) ); values->end() != setting ) {
+			float gain = static_cast<float>( setting->second.GetDouble() );
+			if ( gain < EQ::MinGain ) {
+				gain = EQ::MinGain;
+			} else if ( gain > EQ::MaxGain ) {
+				gain = EQ::MaxGain;
 			}
+			gainIter.second = gain;
 		}
 	}
 	return eq;
@@ -2202,66 +1850,29 @@ Settings::EQ Settings::GetEQSettings()
 
 void Settings::SetEQSettings( const EQ& eq )
 {
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		sqlite3_stmt* stmt = nullptr;
-		const std::string query = "REPLACE INTO Settings (Setting,Value) VALUES (?1,?2);";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			sqlite3_bind_text( stmt, 1, "EQVisible", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, eq.Visible );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-
-			sqlite3_bind_text( stmt, 1, "EQX", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, eq.X );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-
-			sqlite3_bind_text( stmt, 1, "EQY", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, eq.Y );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-
-			sqlite3_bind_text( stmt, 1, "EQEnable", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, eq.Enabled );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-
-			sqlite3_bind_text( stmt, 1, "EQPreamp", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_double( stmt, 2, eq.Preamp );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-
-			for ( auto& gainIter : eq.Gains ) {
-				const std::string setting = "EQ" + std::to_string( gainIter.first );
-				const float gain = gainIter.second;
-				sqlite3_bind_text( stmt, 1, setting.c_str(), -1 /*strLen*/, SQLITE_STATIC );
-				sqlite3_bind_double( stmt, 2, gain );
-				sqlite3_step( stmt );
-				sqlite3_reset( stmt );
-			}
-
-			sqlite3_finalize( stmt );
-			stmt = nullptr;
+	m_Values.Update( [ & ] ( ValueMap& values )
+	{
+		values[ "EQVisible" ].SetInt( eq.Visible );
+		values[ "EQX" ].SetInt( eq.X );
+		values[ "EQY" ].SetInt( eq.Y );
+		values[ "EQEnable" ].SetInt( eq.Enabled );
+		values[ "EQPreamp" ].SetDouble( eq.Preamp );
+		for ( auto& gainIter : eq.Gains ) {
+			const std::string setting = "EQ" + std::to_string( gainIter.first );
+			const float gain = gainIter.second;
+			values[ setting ].SetDouble( gain );
 		}
-	}
+	} );
 }
 
 std::wstring Settings::GetEncoder()
 {
 	std::wstring encoderName;
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		sqlite3_stmt* stmt = nullptr;
-		const std::string query = "SELECT Value FROM Settings WHERE Setting='Encoder';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				const unsigned char* text = sqlite3_column_text( stmt, 0 /*columnIndex*/ );
-				if ( nullptr != text ) {
-					encoderName = UTF8ToWideString( reinterpret_cast<const char*>( text ) );
-				}
-			}
-			sqlite3_finalize( stmt );
+	const auto values = m_Values.Get();
+	if ( const auto setting = values->find( "Encoder" ); values->end() != setting ) {
+		const unsigned char* text = setting->second.GetText();
+		if ( nullptr != text ) {
+			encoderName = UTF8ToWideString( reinterpret_cast<const char*>( text ) );
 		}
 	}
 	return encoderName;
@@ -2269,39 +1880,21 @@ std::wstring Settings::GetEncoder()
 
 void Settings::SetEncoder( const std::wstring& encoder )
 {
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		sqlite3_stmt* stmt = nullptr;
-		const std::string query = "REPLACE INTO Settings (Setting,Value) VALUES (?1,?2);";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			sqlite3_bind_text( stmt, 1, "Encoder", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_text( stmt, 2, WideStringToUTF8( encoder ).c_str(), -1 /*strLen*/, SQLITE_TRANSIENT );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-			sqlite3_finalize( stmt );
-			stmt = nullptr;
-		}
-	}
+	m_Values.Update( [ & ] ( ValueMap& values )
+	{
+		values[ "Encoder" ].SetText( WideStringToUTF8( encoder ) );
+	} );
 }
 
 std::string Settings::GetEncoderSettings( const std::wstring& encoder )
 {
 	std::string settings;
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		const std::string settingName = WideStringToUTF8( L"Encoder_" + encoder );
-		sqlite3_stmt* stmt = nullptr;
-		const std::string query = "SELECT Value FROM Settings WHERE Setting=?1;";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( SQLITE_OK == sqlite3_bind_text( stmt, 1 /*param*/, settingName.c_str(), -1 /*strLen*/, SQLITE_STATIC ) ) {
-				if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-					const unsigned char* text = sqlite3_column_text( stmt, 0 /*columnIndex*/ );
-					if ( nullptr != text ) {
-						settings = reinterpret_cast<const char*>( text );
-					}
-				}
-			}
-			sqlite3_finalize( stmt );
+	const auto values = m_Values.Get();
+	const std::string settingName = WideStringToUTF8( L"Encoder_" + encoder );
+	if ( const auto setting = values->find( settingName ); values->end() != setting ) {
+		const unsigned char* text = setting->second.GetText();
+		if ( nullptr != text ) {
+			settings = reinterpret_cast<const char*>( text );
 		}
 	}
 	return settings;
@@ -2309,37 +1902,21 @@ std::string Settings::GetEncoderSettings( const std::wstring& encoder )
 
 void Settings::SetEncoderSettings( const std::wstring& encoder, const std::string& settings )
 {
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		const std::string settingName = WideStringToUTF8( L"Encoder_" + encoder );
-		sqlite3_stmt* stmt = nullptr;
-		const std::string query = "REPLACE INTO Settings (Setting,Value) VALUES (?1,?2);";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			sqlite3_bind_text( stmt, 1, settingName.c_str(), -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_text( stmt, 2, settings.c_str(), -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-			sqlite3_finalize( stmt );
-			stmt = nullptr;
-		}
-	}
+	const std::string settingName = WideStringToUTF8( L"Encoder_" + encoder );
+	m_Values.Update( [ & ] ( ValueMap& values )
+	{
+		values[ settingName ].SetText( settings );
+	} );
 }
 
 std::wstring Settings::GetSoundFont()
 {
 	std::wstring soundFont;
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		sqlite3_stmt* stmt = nullptr;
-		const std::string query = "SELECT Value FROM Settings WHERE Setting='SoundFont';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				const unsigned char* text = sqlite3_column_text( stmt, 0 /*columnIndex*/ );
-				if ( nullptr != text ) {
-					soundFont = UTF8ToWideString( reinterpret_cast<const char*>( text ) );
-				}
-			}
-			sqlite3_finalize( stmt );
+	const auto values = m_Values.Get();
+	if ( const auto setting = values->find( "SoundFont" ); values->end() != setting ) {
+		const unsigned char* text = setting->second.GetText();
+		if ( nullptr != text ) {
+			soundFont = UTF8ToWideString( reinterpret_cast<const char*>( text ) );
 		}
 	}
 	return soundFont;
@@ -2347,105 +1924,58 @@ std::wstring Settings::GetSoundFont()
 
 void Settings::SetSoundFont( const std::wstring& filename )
 {
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		sqlite3_stmt* stmt = nullptr;
-		const std::string query = "REPLACE INTO Settings (Setting,Value) VALUES (?1,?2);";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			sqlite3_bind_text( stmt, 1, "SoundFont", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_text( stmt, 2, WideStringToUTF8( filename ).c_str(), -1 /*strLen*/, SQLITE_TRANSIENT );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-			sqlite3_finalize( stmt );
-			stmt = nullptr;
-		}
-	}
+	m_Values.Update( [ & ] ( ValueMap& values )
+	{
+		values[ "SoundFont" ].SetText( WideStringToUTF8( filename ) );
+	} );
 }
 
 bool Settings::GetToolbarEnabled( const int toolbarID )
 {
 	bool enabled = true;
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		sqlite3_stmt* stmt = nullptr;
-		const std::string idString = "Toolbar" + std::to_string( toolbarID );
-		const std::string query = "SELECT Value FROM Settings WHERE Setting='" + idString + "';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				enabled = ( 0 != sqlite3_column_int( stmt, 0 /*columnIndex*/ ) );
-			}
-			sqlite3_finalize( stmt );
-		}
+	const auto values = m_Values.Get();
+	const std::string idString = "Toolbar" + std::to_string( toolbarID );
+	if ( const auto setting = values->find( idString ); values->end() != setting ) {
+		enabled = ( 0 != setting->second.GetInt() );
 	}
 	return enabled;
 }
 
 void Settings::SetToolbarEnabled( const int toolbarID, const bool enabled )
 {
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		sqlite3_stmt* stmt = nullptr;
-		const std::string idString = "Toolbar" + std::to_string( toolbarID );
-		const std::string query = "REPLACE INTO Settings (Setting,Value) VALUES (?1,?2);";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			sqlite3_bind_text( stmt, 1, idString.c_str(), -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, enabled );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-			sqlite3_finalize( stmt );
-			stmt = nullptr;
-		}
-	}
+	const std::string idString = "Toolbar" + std::to_string( toolbarID );
+	m_Values.Update( [ & ] ( ValueMap& values )
+	{
+		values[ idString ].SetInt( enabled );
+	} );
 }
 
 bool Settings::GetMergeDuplicates()
 {
 	bool mergeDuplicates = false;
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		sqlite3_stmt* stmt = nullptr;
-		const std::string query = "SELECT Value FROM Settings WHERE Setting='HideDuplicates';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( SQLITE_ROW == sqlite3_step( stmt ) ) {
-				mergeDuplicates = ( 0 != sqlite3_column_int( stmt, 0 /*columnIndex*/ ) );
-			}
-			sqlite3_finalize( stmt );
-		}
+	const auto values = m_Values.Get();
+	if ( const auto setting = values->find( "HideDuplicates" ); values->end() != setting ) {
+		mergeDuplicates = ( 0 != setting->second.GetInt() );
 	}
 	return mergeDuplicates;
 }
 
 void Settings::SetMergeDuplicates( const bool mergeDuplicates )
 {
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		const std::string query = "REPLACE INTO Settings (Setting,Value) VALUES (?1,?2);";
-		sqlite3_stmt* stmt = nullptr;
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			sqlite3_bind_text( stmt, 1, "HideDuplicates", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, mergeDuplicates );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-			sqlite3_finalize( stmt );
-		}
-	}
+	m_Values.Update( [ & ] ( ValueMap& values )
+	{
+		values[ "HideDuplicates" ].SetInt( mergeDuplicates );
+	} );
 }
 
 std::wstring Settings::GetLastFolder( const std::string& folderType )
 {
 	std::wstring lastFolder;
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		sqlite3_stmt* stmt = nullptr;
-		const std::string query = "SELECT Value FROM Settings WHERE Setting='Folder" + folderType + "';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				const unsigned char* text = sqlite3_column_text( stmt, 0 /*columnIndex*/ );
-				if ( nullptr != text ) {
-					lastFolder = UTF8ToWideString( reinterpret_cast<const char*>( text ) );
-				}
-			}
-			sqlite3_finalize( stmt );
+	const auto values = m_Values.Get();
+	if ( const auto setting = values->find( "Folder" + folderType ); values->end() != setting ) {
+		const unsigned char* text = setting->second.GetText();
+		if ( nullptr != text ) {
+			lastFolder = UTF8ToWideString( reinterpret_cast<const char*>( text ) );
 		}
 	}
 	if ( !lastFolder.empty() ) {
@@ -2461,76 +1991,45 @@ std::wstring Settings::GetLastFolder( const std::string& folderType )
 
 void Settings::SetLastFolder( const std::string& folderType, const std::wstring& folder )
 {
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		sqlite3_stmt* stmt = nullptr;
-		const std::string query = "REPLACE INTO Settings (Setting,Value) VALUES (?1,?2);";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			const std::string folderSetting = "Folder" + folderType;
-			sqlite3_bind_text( stmt, 1, folderSetting.c_str(), -1 /*strLen*/, SQLITE_STATIC );
-			std::string folderValue = WideStringToUTF8( folder );
-			if ( !folderValue.empty() ) {
-				if ( ( folderValue.back() == '\\'  ) || ( folderValue.back() == '/' ) ) {
-					folderValue.pop_back();
-				}
+	m_Values.Update( [ & ] ( ValueMap& values )
+	{
+		const std::string folderSetting = "Folder" + folderType;
+		std::string folderValue = WideStringToUTF8( folder );
+		if ( !folderValue.empty() ) {
+			if ( ( folderValue.back() == '\\'  ) || ( folderValue.back() == '/' ) ) {
+				folderValue.pop_back();
 			}
-			sqlite3_bind_text( stmt, 2, folderValue.c_str(), -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-			sqlite3_finalize( stmt );
-			stmt = nullptr;
 		}
-	}
+		values[ folderSetting ].SetText( folderValue );
+	} );
 }
 
 bool Settings::GetScrobblerEnabled()
 {
 	bool enabled = false;
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		sqlite3_stmt* stmt = nullptr;
-		const std::string query = "SELECT Value FROM Settings WHERE Setting='ScrobblerEnable';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( SQLITE_ROW == sqlite3_step( stmt ) ) {
-				enabled = ( 0 != sqlite3_column_int( stmt, 0 /*columnIndex*/ ) );
-			}
-			sqlite3_finalize( stmt );
-		}
+	const auto values = m_Values.Get();
+	if ( const auto setting = values->find( "ScrobblerEnable" ); values->end() != setting ) {
+		enabled = ( 0 != setting->second.GetInt() );
 	}
 	return enabled;
 }
 
 void Settings::SetScrobblerEnabled( const bool enabled )
 {
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		const std::string query = "REPLACE INTO Settings (Setting,Value) VALUES (?1,?2);";
-		sqlite3_stmt* stmt = nullptr;
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			sqlite3_bind_text( stmt, 1, "ScrobblerEnable", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, enabled );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-			sqlite3_finalize( stmt );
-		}
-	}
+	m_Values.Update( [ & ] ( ValueMap& values )
+	{
+		values[ "ScrobblerEnable" ].SetInt( enabled );
+	} );
 }
 
 std::string Settings::GetScrobblerKey()
 {
 	std::string key;
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		sqlite3_stmt* stmt = nullptr;
-		const std::string query = "SELECT Value FROM Settings WHERE Setting='ScrobblerKey';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				const unsigned char* text = sqlite3_column_text( stmt, 0 /*columnIndex*/ );
-				if ( nullptr != text ) {
-					key = reinterpret_cast<const char*>( text );
-				}
-			}
-			sqlite3_finalize( stmt );
+	const auto values = m_Values.Get();
+	if ( const auto setting = values->find( "ScrobblerKey" ); values->end() != setting ) {
+		const unsigned char* text = setting->second.GetText();
+		if ( nullptr != text ) {
+			key = reinterpret_cast<const char*>( text );
 		}
 	}
 	std::string decryptedKey;
@@ -2549,62 +2048,38 @@ std::string Settings::GetScrobblerKey()
 
 void Settings::SetScrobblerKey( const std::string& key )
 {
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		std::string encryptedKey;
-		if ( !key.empty() ) {
-			// Encrypt key for storage.
-			DATA_BLOB dataIn = { static_cast<DWORD>( key.size() ), const_cast<BYTE*>( reinterpret_cast<const BYTE*>( key.c_str() ) ) };
-			DATA_BLOB dataOut = {};
-			if ( CryptProtectData( &dataIn, nullptr /*dataDesc*/, nullptr /*entropy*/, nullptr /*reserved*/, nullptr /*prompt*/, 0 /*flags*/, &dataOut ) ) {
-				encryptedKey = Base64Encode( dataOut.pbData, dataOut.cbData );
-				LocalFree( dataOut.pbData );
-			}
-		}
-		sqlite3_stmt* stmt = nullptr;
-		const std::string query = "REPLACE INTO Settings (Setting,Value) VALUES (?1,?2);";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			sqlite3_bind_text( stmt, 1, "ScrobblerKey", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_text( stmt, 2, encryptedKey.c_str(), -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-			sqlite3_finalize( stmt );
-			stmt = nullptr;
+	std::string encryptedKey;
+	if ( !key.empty() ) {
+		// Encrypt key for storage.
+		DATA_BLOB dataIn = { static_cast<DWORD>( key.size() ), const_cast<BYTE*>( reinterpret_cast<const BYTE*>( key.c_str() ) ) };
+		DATA_BLOB dataOut = {};
+		if ( CryptProtectData( &dataIn, nullptr /*dataDesc*/, nullptr /*entropy*/, nullptr /*reserved*/, nullptr /*prompt*/, 0 /*flags*/, &dataOut ) ) {
+			encryptedKey = Base64Encode( dataOut.pbData, dataOut.cbData );
+			LocalFree( dataOut.pbData );
 		}
 	}
+	m_Values.Update( [ & ] ( ValueMap& values )
+	{
+		values[ "ScrobblerKey" ].SetText( encryptedKey );
+	} );
 }
 
 bool Settings::GetMusicBrainzEnabled()
 {
 	bool enabled = true;
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		sqlite3_stmt* stmt = nullptr;
-		const std::string query = "SELECT Value FROM Settings WHERE Setting='MusicBrainzEnable';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( SQLITE_ROW == sqlite3_step( stmt ) ) {
-				enabled = ( 0 != sqlite3_column_int( stmt, 0 /*columnIndex*/ ) );
-			}
-			sqlite3_finalize( stmt );
-		}
+	const auto values = m_Values.Get();
+	if ( const auto setting = values->find( "MusicBrainzEnable" ); values->end() != setting ) {
+		enabled = ( 0 != setting->second.GetInt() );
 	}
 	return enabled;
 }
 
 void Settings::SetMusicBrainzEnabled( const bool enabled )
 {
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		const std::string query = "REPLACE INTO Settings (Setting,Value) VALUES (?1,?2);";
-		sqlite3_stmt* stmt = nullptr;
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			sqlite3_bind_text( stmt, 1, "MusicBrainzEnable", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, enabled );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-			sqlite3_finalize( stmt );
-		}
-	}
+	m_Values.Update( [ & ] ( ValueMap& values )
+	{
+		values[ "MusicBrainzEnable" ].SetInt( enabled );
+	} );
 }
 
 void Settings::ExportSettings( std::string& output )
@@ -2612,6 +2087,7 @@ void Settings::ExportSettings( std::string& output )
 	using namespace nlohmann;
 
 	output.clear();
+	Flush();
 	sqlite3* database = m_Database.GetDatabase();
 	if ( nullptr != database ) {
 		json document;
@@ -2619,7 +2095,7 @@ void Settings::ExportSettings( std::string& output )
 		// Settings table.
 		sqlite3_stmt* stmt = nullptr;
 		std::string query = "SELECT Setting, Value FROM Settings ORDER BY Setting ASC;";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
+		if ( SQLITE_OK == m_Database.PrepareStatement( query, &stmt ) ) {
 			json settings;
 			while ( SQLITE_ROW == sqlite3_step( stmt ) ) {
 				const unsigned char* text = sqlite3_column_text( stmt, 0 /*columnIndex*/ );
@@ -2689,7 +2165,7 @@ void Settings::ExportSettings( std::string& output )
 					}
 				}
 			}
-			sqlite3_finalize( stmt );
+			m_Database.ReleaseStatement( stmt );
 			stmt = nullptr;
 			if ( !settings.empty() ) {
 				document[ "Settings" ] = settings;
@@ -2698,7 +2174,7 @@ void Settings::ExportSettings( std::string& output )
 
 		// PlaylistColumns table.
 		query = "SELECT Col,Width FROM PlaylistColumns ORDER BY rowid ASC;";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
+		if ( SQLITE_OK == m_Database.PrepareStatement( query, &stmt ) ) {
 			json columns;
 			while ( SQLITE_ROW == sqlite3_step( stmt ) ) {
 				const int col = sqlite3_column_int( stmt, 0 /*columnIndex*/ );
@@ -2710,7 +2186,7 @@ void Settings::ExportSettings( std::string& output )
 					columns.push_back( column );
 				}
 			}
-			sqlite3_finalize( stmt );
+			m_Database.ReleaseStatement( stmt );
 			stmt = nullptr;
 			if ( columns.size() > 0 ) {
 				document[ "PlaylistColumns" ] = columns;
@@ -2719,7 +2195,7 @@ void Settings::ExportSettings( std::string& output )
 
 		// Hotkeys table.
 		query = "SELECT ID,Hotkey,Alt,Ctrl,Shift FROM Hotkeys;";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
+		if ( SQLITE_OK == m_Database.PrepareStatement( query, &stmt ) ) {
 			json hotkeys;
 			while ( SQLITE_ROW == sqlite3_step( stmt ) ) {
 				const int id = sqlite3_column_int( stmt, 0 /*columnIndex*/ );
@@ -2737,7 +2213,7 @@ void Settings::ExportSettings( std::string& output )
 					hotkeys.push_back( entry );
 				}
 			}
-			sqlite3_finalize( stmt );
+			m_Database.ReleaseStatement( stmt );
 			stmt = nullptr;
 			if ( hotkeys.size() > 0 ) {
 				document[ "Hotkeys" ] = hotkeys;
@@ -2761,7 +2237,7 @@ void Settings::ImportSettings( const std::string& input )
 			if ( ( document.end() != settings ) && settings->is_object() ) {
 				sqlite3_stmt* stmt = nullptr;
 				const std::string query = "REPLACE INTO Settings (Setting,Value) VALUES (?1,?2);";
-				if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
+				if ( SQLITE_OK == m_Database.PrepareStatement( query, &stmt ) ) {
 					for ( const auto& [ name, value ] : settings->items() ) {
 						if ( value.is_number_float() ) {
 							sqlite3_bind_text( stmt, 1, name.c_str(), -1 /*strLen*/, SQLITE_STATIC );
@@ -2822,7 +2298,7 @@ void Settings::ImportSettings( const std::string& input )
 							}
 						}
 					}
-					sqlite3_finalize( stmt );
+					m_Database.ReleaseStatement( stmt );
 					stmt = nullptr;
 				}
 			}
@@ -2834,7 +2310,7 @@ void Settings::ImportSettings( const std::string& input )
 				std::string query = "DELETE FROM PlaylistColumns;";
 				sqlite3_exec( database, query.c_str(), NULL /*callback*/, NULL /*arg*/, NULL /*errMsg*/ );
 				query = "INSERT INTO PlaylistColumns (Col,Width) VALUES (?1,?2);";
-				if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
+				if ( SQLITE_OK == m_Database.PrepareStatement( query, &stmt ) ) {
 					for ( const auto& column : *columns ) {
 						if ( column.is_object() ) {
 							const auto col = column.find( "Col" );
@@ -2849,7 +2325,7 @@ void Settings::ImportSettings( const std::string& input )
 							}
 						}
 					}
-					sqlite3_finalize( stmt );
+					m_Database.ReleaseStatement( stmt );
 					stmt = nullptr;
 				}
 			}
@@ -2861,7 +2337,7 @@ void Settings::ImportSettings( const std::string& input )
 				std::string query = "DELETE FROM Hotkeys;";
 				sqlite3_exec( database, query.c_str(), NULL /*callback*/, NULL /*arg*/, NULL /*errMsg*/ );
 				query = "INSERT INTO Hotkeys (ID,Hotkey,Alt,Ctrl,Shift) VALUES (?1,?2,?3,?4,?5);";
-				if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
+				if ( SQLITE_OK == m_Database.PrepareStatement( query, &stmt ) ) {
 					for ( const auto& entry : *hotkeys ) {
 						if ( entry.is_object() ) {
 							const auto id = entry.find( "ID" );
@@ -2881,7 +2357,7 @@ void Settings::ImportSettings( const std::string& input )
 							}
 						}
 					}
-					sqlite3_finalize( stmt );
+					m_Database.ReleaseStatement( stmt );
 					stmt = nullptr;
 				}
 			}
@@ -2904,61 +2380,26 @@ void Settings::GetAdvancedWasapiExclusiveSettings( bool& useDeviceDefaultFormat,
 	int maxBufferLength = 0;
 	int maxLeadIn = 0;
 	GetDefaultAdvancedWasapiExclusiveSettings( useDeviceDefaultFormat, bufferLength, leadIn, maxBufferLength, maxLeadIn );
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		sqlite3_stmt* stmt = nullptr;
-		std::string query = "SELECT Value FROM Settings WHERE Setting='WasapiExclusiveUseDeviceFormat';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				useDeviceDefaultFormat = ( 0 != sqlite3_column_int( stmt, 0 /*columnIndex*/ ) );
-			}
-			sqlite3_finalize( stmt );
-		}
-		stmt = nullptr;
-		query = "SELECT Value FROM Settings WHERE Setting='WasapiExclusiveBufferLength';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				bufferLength = std::clamp( sqlite3_column_int( stmt, 0 /*columnIndex*/ ), 0, maxBufferLength );
-			}
-			sqlite3_finalize( stmt );
-		}
-		stmt = nullptr;
-		query = "SELECT Value FROM Settings WHERE Setting='WasapiExclusiveLeadIn';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				leadIn = std::clamp( sqlite3_column_int( stmt, 0 /*columnIndex*/ ), 0, maxLeadIn );
-			}
-			sqlite3_finalize( stmt );
-		}
+	const auto values = m_Values.Get();
+	if ( const auto setting = values->find( "WasapiExclusiveUseDeviceFormat" ); values->end() != setting ) {
+		useDeviceDefaultFormat = ( 0 != setting->second.GetInt() );
+	}
+	if ( const auto setting = values->find( "WasapiExclusiveBufferLength" ); values->end() != setting ) {
+		bufferLength = std::clamp( setting->second.GetInt(), 0, maxBufferLength );
+	}
+	if ( const auto setting = values->find( "WasapiExclusiveLeadIn" ); values->end() != setting ) {
+		leadIn = std::clamp( setting->second.GetInt(), 0, maxLeadIn );
 	}
 }
 
 void Settings::SetAdvancedWasapiExclusiveSettings( const bool useDeviceDefaultFormat, const int bufferLength, const int leadIn )
 {
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		sqlite3_stmt* stmt = nullptr;
-		const std::string query = "REPLACE INTO Settings (Setting,Value) VALUES (?1,?2);";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			sqlite3_bind_text( stmt, 1, "WasapiExclusiveUseDeviceFormat", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, useDeviceDefaultFormat );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-
-			sqlite3_bind_text( stmt, 1, "WasapiExclusiveBufferLength", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, bufferLength );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-
-			sqlite3_bind_text( stmt, 1, "WasapiExclusiveLeadIn", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, leadIn );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-
-			sqlite3_finalize( stmt );
-			stmt = nullptr;
-		}
-	}
+	m_Values.Update( [ & ] ( ValueMap& values )
+	{
+		values[ "WasapiExclusiveUseDeviceFormat" ].SetInt( useDeviceDefaultFormat );
+		values[ "WasapiExclusiveBufferLength" ].SetInt( bufferLength );
+		values[ "WasapiExclusiveLeadIn" ].SetInt( leadIn );
+	} );
 }
 
 void Settings::GetDefaultAdvancedASIOSettings( bool& useDefaultSamplerate, int& defaultSamplerate, int& leadIn, int& maxDefaultSamplerate, int& maxLeadIn )
@@ -2975,78 +2416,36 @@ void Settings::GetAdvancedASIOSettings( bool& useDefaultSamplerate, int& default
 	int maxDefaultSamplerate = 0;
 	int maxLeadIn = 0;
 	GetDefaultAdvancedASIOSettings( useDefaultSamplerate, defaultSamplerate, leadIn, maxDefaultSamplerate, maxLeadIn );
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		sqlite3_stmt* stmt = nullptr;
-		std::string query = "SELECT Value FROM Settings WHERE Setting='ASIOUseDefaultSamplerate';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				useDefaultSamplerate = ( 0 != sqlite3_column_int( stmt, 0 /*columnIndex*/ ) );
-			}
-			sqlite3_finalize( stmt );
-		}
-		stmt = nullptr;
-		query = "SELECT Value FROM Settings WHERE Setting='ASIODefaultSamplerate';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				defaultSamplerate = std::clamp( sqlite3_column_int( stmt, 0 /*columnIndex*/ ), 0, maxDefaultSamplerate );
-			}
-			sqlite3_finalize( stmt );
-		}
-		stmt = nullptr;
-		query = "SELECT Value FROM Settings WHERE Setting='ASIOLeadIn';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				leadIn = std::clamp( sqlite3_column_int( stmt, 0 /*columnIndex*/ ), 0, maxLeadIn );
-			}
-			sqlite3_finalize( stmt );
-		}
+	const auto values = m_Values.Get();
+	if ( const auto setting = values->find( "ASIOUseDefaultSamplerate" ); values->end() != setting ) {
+		useDefaultSamplerate = ( 0 != setting->second.GetInt() );
+	}
+	if ( const auto setting = values->find( "ASIODefaultSamplerate" ); values->end() != setting ) {
+		defaultSamplerate = std::clamp( setting->second.GetInt(), 0, maxDefaultSamplerate );
+	}
+	if ( const auto setting = values->find( "ASIOLeadIn" ); values->end() != setting ) {
+		leadIn = std::clamp( setting->second.GetInt(), 0, maxLeadIn );
 	}
 }
 
 void Settings::SetAdvancedASIOSettings( const bool useDefaultSamplerate, const int defaultSamplerate, const int leadIn )
 {
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		sqlite3_stmt* stmt = nullptr;
-		const std::string query = "REPLACE INTO Settings (Setting,Value) VALUES (?1,?2);";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			sqlite3_bind_text( stmt, 1, "ASIOUseDefaultSamplerate", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, useDefaultSamplerate );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-
-			sqlite3_bind_text( stmt, 1, "ASIODefaultSamplerate", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, defaultSamplerate );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-
-			sqlite3_bind_text( stmt, 1, "ASIOLeadIn", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, leadIn );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-
-			sqlite3_finalize( stmt );
-			stmt = nullptr;
-		}
-	}
+	m_Values.Update( [ & ] ( ValueMap& values )
+	{
+		values[ "ASIOUseDefaultSamplerate" ].SetInt( useDefaultSamplerate );
+		values[ "ASIODefaultSamplerate" ].SetInt( defaultSamplerate );
+		values[ "ASIOLeadIn" ].SetInt( leadIn );
+	} );
 }
 
 Settings::ToolbarSize Settings::GetToolbarSize()
 {
 	ToolbarSize size = ToolbarSize::Small;
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		sqlite3_stmt* stmt = nullptr;
-		const std::string query = "SELECT Value FROM Settings WHERE Setting='ToolbarSize';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( SQLITE_ROW == sqlite3_step( stmt ) ) {
-				const int value = sqlite3_column_int( stmt, 0 /*columnIndex*/ );
-				if ( ( value >= static_cast<int>( ToolbarSize::Small ) ) && ( value <= static_cast<int>( ToolbarSize::Large ) ) ) {
-					size = static_cast<ToolbarSize>( value );
-				}
-			}
-			sqlite3_finalize( stmt );
+	const auto values = m_Values.Get();
+	if ( const auto setting = values->find( "ToolbarSize" ); values->end() != setting ) {
+		const int value = setting->second.GetInt();
+		if ( ( value >= static_cast<int>( ToolbarSize::Small ) ) && ( value <= static_cast<int>( ToolbarSize::Large ) ) ) {
+			size = static_cast<ToolbarSize>( value );
 		}
 	}
 	return size;
@@ -3054,17 +2453,10 @@ Settings::ToolbarSize Settings::GetToolbarSize()
 
 void Settings::SetToolbarSize( const ToolbarSize size )
 {
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		const std::string query = "REPLACE INTO Settings (Setting,Value) VALUES (?1,?2);";
-		sqlite3_stmt* stmt = nullptr;
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			sqlite3_bind_text( stmt, 1, "ToolbarSize", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, static_cast<int>( size ) );
-			sqlite3_step( stmt );
-			sqlite3_finalize( stmt );
-		}
-	}
+	m_Values.Update( [ & ] ( ValueMap& values )
+	{
+		values[ "ToolbarSize" ].SetInt( static_cast<int>( size ) );
+	} );
 }
 
 int Settings::GetToolbarButtonSize( const ToolbarSize size )
@@ -3079,296 +2471,154 @@ int Settings::GetToolbarButtonSize( const ToolbarSize size )
 
 void Settings::GetToolbarColours( COLORREF& buttonColour, COLORREF& backgroundColour )
 {
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		sqlite3_stmt* stmt = nullptr;
-		std::string query = "SELECT Value FROM Settings WHERE Setting='ToolbarButtonColour';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				buttonColour = static_cast<COLORREF>( sqlite3_column_int( stmt, 0 /*columnIndex*/ ) );
-			}
-			sqlite3_finalize( stmt );
-		}
+	const auto values = m_Values.Get();
+	if ( const auto setting = values->find( "ToolbarButtonColour" ); values->end() != setting ) {
+		buttonColour = static_cast<COLORREF>( setting->second.GetInt() );
+	}
 
-		stmt = nullptr;
-		query = "SELECT Value FROM Settings WHERE Setting='ToolbarBackgroundColour';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( ( SQLITE_ROW == sqlite3_step( stmt ) ) && ( 1 == sqlite3_column_count( stmt ) ) ) {
-				backgroundColour = static_cast<COLORREF>( sqlite3_column_int( stmt, 0 /*columnIndex*/ ) );
-			}
-			sqlite3_finalize( stmt );
-		}
+	if ( const auto setting = values->find( "ToolbarBackgroundColour" ); values->end() != setting ) {
+		backgroundColour = static_cast<COLORREF>( setting->second.GetInt() );
 	}
 }
 
 void Settings::SetToolbarColours( const COLORREF buttonColour, const COLORREF backgroundColour )
 {
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		sqlite3_stmt* stmt = nullptr;
-		const std::string query = "REPLACE INTO Settings (Setting,Value) VALUES (?1,?2);";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			sqlite3_bind_text( stmt, 1, "ToolbarButtonColour", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, buttonColour );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-
-			sqlite3_bind_text( stmt, 1, "ToolbarBackgroundColour", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, backgroundColour );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-
-			sqlite3_finalize( stmt );
-			stmt = nullptr;
-		}
-	}
+	m_Values.Update( [ & ] ( ValueMap& values )
+	{
+		values[ "ToolbarButtonColour" ].SetInt( buttonColour );
+		values[ "ToolbarBackgroundColour" ].SetInt( backgroundColour );
+	} );
 }
 
 bool Settings::GetHardwareAccelerationEnabled()
 {
 	bool enabled = true;
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		sqlite3_stmt* stmt = nullptr;
-		const std::string query = "SELECT Value FROM Settings WHERE Setting='VisualHardwareAcceleration';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( SQLITE_ROW == sqlite3_step( stmt ) ) {
-				enabled = ( 0 != sqlite3_column_int( stmt, 0 /*columnIndex*/ ) );
-			}
-			sqlite3_finalize( stmt );
-		}
+	const auto values = m_Values.Get();
+	if ( const auto setting = values->find( "VisualHardwareAcceleration" ); values->end() != setting ) {
+		enabled = ( 0 != setting->second.GetInt() );
 	}
 	return enabled;
 }
 
 void Settings::SetHardwareAccelerationEnabled( const bool enabled )
 {
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		const std::string query = "REPLACE INTO Settings (Setting,Value) VALUES (?1,?2);";
-		sqlite3_stmt* stmt = nullptr;
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			sqlite3_bind_text( stmt, 1, "VisualHardwareAcceleration", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, enabled );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-			sqlite3_finalize( stmt );
-		}
-	}
+	m_Values.Update( [ & ] ( ValueMap& values )
+	{
+		values[ "VisualHardwareAcceleration" ].SetInt( enabled );
+	} );
 }
 
 bool Settings::GetAlwaysOnTop()
 {
 	bool alwaysOnTop = false;
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		sqlite3_stmt* stmt = nullptr;
-		const std::string query = "SELECT Value FROM Settings WHERE Setting='AlwaysOnTop';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( SQLITE_ROW == sqlite3_step( stmt ) ) {
-				alwaysOnTop = ( 0 != sqlite3_column_int( stmt, 0 /*columnIndex*/ ) );
-			}
-			sqlite3_finalize( stmt );
-		}
+	const auto values = m_Values.Get();
+	if ( const auto setting = values->find( "AlwaysOnTop" ); values->end() != setting ) {
+		alwaysOnTop = ( 0 != setting->second.GetInt() );
 	}
 	return alwaysOnTop;
 }
 
 void Settings::SetAlwaysOnTop( const bool alwaysOnTop )
 {
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		const std::string query = "REPLACE INTO Settings (Setting,Value) VALUES (?1,?2);";
-		sqlite3_stmt* stmt = nullptr;
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			sqlite3_bind_text( stmt, 1, "AlwaysOnTop", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, alwaysOnTop );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-			sqlite3_finalize( stmt );
-		}
-	}
+	m_Values.Update( [ & ] ( ValueMap& values )
+	{
+		values[ "AlwaysOnTop" ].SetInt( alwaysOnTop );
+	} );
 }
 
 bool Settings::GetRetainStopAtTrackEnd()
 {
 	bool retain = false;
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		sqlite3_stmt* stmt = nullptr;
-		const std::string query = "SELECT Value FROM Settings WHERE Setting='RetainStopAtTrackEnd';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( SQLITE_ROW == sqlite3_step( stmt ) ) {
-				retain = ( 0 != sqlite3_column_int( stmt, 0 /*columnIndex*/ ) );
-			}
-			sqlite3_finalize( stmt );
-		}
+	const auto values = m_Values.Get();
+	if ( const auto setting = values->find( "RetainStopAtTrackEnd" ); values->end() != setting ) {
+		retain = ( 0 != setting->second.GetInt() );
 	}
 	return retain;
 }
 
 void Settings::SetRetainStopAtTrackEnd( const bool retain )
 {
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		const std::string query = "REPLACE INTO Settings (Setting,Value) VALUES (?1,?2);";
-		sqlite3_stmt* stmt = nullptr;
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			sqlite3_bind_text( stmt, 1, "RetainStopAtTrackEnd", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, retain );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-			sqlite3_finalize( stmt );
-		}
-	}
+	m_Values.Update( [ & ] ( ValueMap& values )
+	{
+		values[ "RetainStopAtTrackEnd" ].SetInt( retain );
+	} );
 }
 
 bool Settings::GetStopAtTrackEnd()
 {
 	bool enabled = false;
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		sqlite3_stmt* stmt = nullptr;
-		const std::string query = "SELECT Value FROM Settings WHERE Setting='StopAtTrackEnd';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( SQLITE_ROW == sqlite3_step( stmt ) ) {
-				enabled = ( 0 != sqlite3_column_int( stmt, 0 /*columnIndex*/ ) );
-			}
-			sqlite3_finalize( stmt );
-		}
+	const auto values = m_Values.Get();
+	if ( const auto setting = values->find( "StopAtTrackEnd" ); values->end() != setting ) {
+		enabled = ( 0 != setting->second.GetInt() );
 	}
 	return enabled;
 }
 
 void Settings::SetStopAtTrackEnd( const bool enabled )
 {
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		const std::string query = "REPLACE INTO Settings (Setting,Value) VALUES (?1,?2);";
-		sqlite3_stmt* stmt = nullptr;
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			sqlite3_bind_text( stmt, 1, "StopAtTrackEnd", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, enabled );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-			sqlite3_finalize( stmt );
-		}
-	}
+	m_Values.Update( [ & ] ( ValueMap& values )
+	{
+		values[ "StopAtTrackEnd" ].SetInt( enabled );
+	} );
 }
 
 bool Settings::GetRetainPitchBalance()
 {
 	bool retain = false;
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		sqlite3_stmt* stmt = nullptr;
-		const std::string query = "SELECT Value FROM Settings WHERE Setting='RetainPitchBalance';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( SQLITE_ROW == sqlite3_step( stmt ) ) {
-				retain = ( 0 != sqlite3_column_int( stmt, 0 /*columnIndex*/ ) );
-			}
-			sqlite3_finalize( stmt );
-		}
+	const auto values = m_Values.Get();
+	if ( const auto setting = values->find( "RetainPitchBalance" ); values->end() != setting ) {
+		retain = ( 0 != setting->second.GetInt() );
 	}
 	return retain;
 }
 
 void Settings::SetRetainPitchBalance( const bool retain )
 {
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		const std::string query = "REPLACE INTO Settings (Setting,Value) VALUES (?1,?2);";
-		sqlite3_stmt* stmt = nullptr;
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			sqlite3_bind_text( stmt, 1, "RetainPitchBalance", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, retain );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-			sqlite3_finalize( stmt );
-		}
-	}
+	m_Values.Update( [ & ] ( ValueMap& values )
+	{
+		values[ "RetainPitchBalance" ].SetInt( retain );
+	} );
 }
 
 std::pair<float /*pitch*/, float /*balance*/> Settings::GetPitchBalance()
 {
 	auto setting = std::make_pair( 1.0f, 0.0f );
 	auto& [ pitch, balance ] = setting;
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		sqlite3_stmt* stmt = nullptr;
-		std::string query = "SELECT Value FROM Settings WHERE Setting='Pitch';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( SQLITE_ROW == sqlite3_step( stmt ) ) {
-				pitch = static_cast<float>( sqlite3_column_double( stmt, 0 /*columnIndex*/ ) );
-			}
-			sqlite3_finalize( stmt );
-		}
-		stmt = nullptr;
-		query = "SELECT Value FROM Settings WHERE Setting='Balance';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( SQLITE_ROW == sqlite3_step( stmt ) ) {
-				balance = static_cast<float>( sqlite3_column_double( stmt, 0 /*columnIndex*/ ) );
-			}
-			sqlite3_finalize( stmt );
-		}
+	const auto values = m_Values.Get();
+	if ( const auto setting = values->find( "Pitch" ); values->end() != setting ) {
+		pitch = static_cast<float>( setting->second.GetDouble() );
+	}
+	if ( const auto setting = values->find( "Balance" ); values->end() != setting ) {
+		balance = static_cast<float>( setting->second.GetDouble() );
 	}
 	return setting;
 }
 
 void Settings::SetPitchBalance( const float pitch, const float balance )
 {
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		const std::string query = "REPLACE INTO Settings (Setting,Value) VALUES (?1,?2);";
-		sqlite3_stmt* stmt = nullptr;
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			sqlite3_bind_text( stmt, 1, "Pitch", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_double( stmt, 2, pitch );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-
-			sqlite3_bind_text( stmt, 1, "Balance", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_double( stmt, 2, balance );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-
-			sqlite3_finalize( stmt );
-			stmt = nullptr;
-		}
-	}
+	m_Values.Update( [ & ] ( ValueMap& values )
+	{
+		values[ "Pitch" ].SetDouble( pitch );
+		values[ "Balance" ].SetDouble( balance );
+	} );
 }
 
 int Settings::GetLastOptionsPage()
 {
 	int index = 0;
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		sqlite3_stmt* stmt = nullptr;
-		const std::string query = "SELECT Value FROM Settings WHERE Setting='OptionsPage';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( SQLITE_ROW == sqlite3_step( stmt ) ) {
-				index = sqlite3_column_int( stmt, 0 /*columnIndex*/ );
-			}
-			sqlite3_finalize( stmt );
-		}
+	const auto values = m_Values.Get();
+	if ( const auto setting = values->find( "OptionsPage" ); values->end() != setting ) {
+		index = setting->second.GetInt();
 	}
 	return index;
 }
 
 void Settings::SetLastOptionsPage( const int index )
 {
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		const std::string query = "REPLACE INTO Settings (Setting,Value) VALUES (?1,?2);";
-		sqlite3_stmt* stmt = nullptr;
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			sqlite3_bind_text( stmt, 1, "OptionsPage", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, index );
-			sqlite3_step( stmt );
-			sqlite3_reset( stmt );
-			sqlite3_finalize( stmt );
-		}
-	}
+	m_Values.Update( [ & ] ( ValueMap& values )
+	{
+		values[ "OptionsPage" ].SetInt( index );
+	} );
 }
 
 COLORREF Settings::GetTaskbarButtonColour()
@@ -3376,31 +2626,17 @@ COLORREF Settings::GetTaskbarButtonColour()
 	constexpr COLORREF kDefaultColour = RGB( 55, 165, 255 );
 
 	COLORREF colour = kDefaultColour;
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		sqlite3_stmt* stmt = nullptr;
-		const std::string query = "SELECT Value FROM Settings WHERE Setting='TaskbarButtonColour';";
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			if ( SQLITE_ROW == sqlite3_step( stmt ) ) {
-				colour = static_cast<COLORREF>( sqlite3_column_int( stmt, 0 /*columnIndex*/ ) );
-			}
-			sqlite3_finalize( stmt );
-		}
+	const auto values = m_Values.Get();
+	if ( const auto setting = values->find( "TaskbarButtonColour" ); values->end() != setting ) {
+		colour = static_cast<COLORREF>( setting->second.GetInt() );
 	}
 	return colour;
 }
 
 void Settings::SetTaskbarButtonColour( const COLORREF colour )
 {
-	sqlite3* database = m_Database.GetDatabase();
-	if ( nullptr != database ) {
-		const std::string query = "REPLACE INTO Settings (Setting,Value) VALUES (?1,?2);";
-		sqlite3_stmt* stmt = nullptr;
-		if ( SQLITE_OK == sqlite3_prepare_v2( database, query.c_str(), -1 /*nByte*/, &stmt, nullptr /*tail*/ ) ) {
-			sqlite3_bind_text( stmt, 1, "TaskbarButtonColour", -1 /*strLen*/, SQLITE_STATIC );
-			sqlite3_bind_int( stmt, 2, static_cast<int>( colour ) );
-			sqlite3_step( stmt );
-			sqlite3_finalize( stmt );
-		}
-	}
+	m_Values.Update( [ & ] ( ValueMap& values )
+	{
+		values[ "TaskbarButtonColour" ].SetInt( static_cast<int>( colour ) );
+	} );
 }
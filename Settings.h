@@ -1,11 +1,17 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <filesystem>
 #include <list>
+#include <map>
+#include <mutex>
+#include <string>
 
 #include "Database.h"
 #include "Library.h"
 #include "Playlist.h"
+#include "SharedSnapshot.h"
 
 // MOD music fadeout flag.
 static const DWORD VUPLAYER_MUSIC_FADEOUT = 0x80000000;
@@ -55,7 +61,16 @@ public:
 	enum class LimitMode {
 		None,
 		Hard,
-		Soft
+		Soft,
+		LookAhead
+	};
+
+	// Output resampler quality.
+	enum class ResamplerQuality {
+		Disabled,
+		Low,
+		Medium,
+		High
 	};
 
 	// Notification area icon click commands.
@@ -360,6 +375,49 @@ public:
 	// 'preamp' - preamp in dB.
 	void SetGainSettings( const GainMode gainMode, const LimitMode limitMode, const float preamp );
 
+	// Gets default look-ahead limiter settings.
+	// 'lookAhead' - out, look-ahead window in milliseconds.
+	// 'release' - out, release time in milliseconds.
+	void GetDefaultLimiterSettings( float& lookAhead, float& release );
+
+	// Gets look-ahead limiter settings.
+	// 'lookAhead' - out, look-ahead window in milliseconds.
+	// 'release' - out, release time in milliseconds.
+	void GetLimiterSettings( float& lookAhead, float& release );
+
+	// Sets look-ahead limiter settings.
+	// 'lookAhead' - look-ahead window in milliseconds.
+	// 'release' - release time in milliseconds.
+	void SetLimiterSettings( const float lookAhead, const float release );
+
+	// Returns the output resampler quality (which applies to WASAPI exclusive & ASIO output modes).
+	ResamplerQuality GetResamplerQuality();
+
+	// Sets the output resampler 'quality' (which applies to WASAPI exclusive & ASIO output modes).
+	void SetResamplerQuality( const ResamplerQuality quality );
+
+	// Gets decoder preload settings.
+	// 'windowSize' - out, maximum number of decoders to preload.
+	// 'shuffleCandidates' - out, number of upcoming items to preload when random play is enabled.
+	// 'memoryLimit' - out, maximum pre-buffer memory per decoder (which also limits decode-ahead memory for preloaded decoders), in MB.
+	void GetPreloadSettings( long& windowSize, long& shuffleCandidates, long& memoryLimit );
+
+	// Sets decoder preload settings.
+	// 'windowSize' - maximum number of decoders to preload.
+	// 'shuffleCandidates' - number of upcoming items to preload when random play is enabled.
+	// 'memoryLimit' - maximum pre-buffer memory per decoder (which also limits decode-ahead memory for preloaded decoders), in MB.
+	void SetPreloadSettings( const long windowSize, const long shuffleCandidates, const long memoryLimit );
+
+	// Gets decode-ahead settings.
+	// 'enable' - out, whether the current & next tracks are decoded in full into memory (for local files).
+	// 'memoryLimit' - out, memory ceiling for decoded sample data, in MB.
+	void GetDecodeAheadSettings( bool& enable, long& memoryLimit );
+
+	// Sets decode-ahead settings.
+	// 'enable' - whether the current & next tracks are decoded in full into memory (for local files).
+	// 'memoryLimit' - memory ceiling for decoded sample data, in MB.
+	void SetDecodeAheadSettings( const bool enable, const long memoryLimit );
+
 	// Gets notification area settings.
 	// 'enable' - out, whether the notification area icon is shown.
 	// 'minimise' - out, whether to minimise to the notification area.
@@ -590,6 +648,146 @@ public:
 	void SetTaskbarButtonColour( const COLORREF colour );
 
 private:
+	// A settings table value, which can be read as a different type using the same conversions as SQLite.
+	class Value
+	{
+	public:
+		Value();
+
+		// Returns the SQLite fundamental datatype of the value.
+		int GetType() const;
+
+		// Returns the value as a 32-bit integer.
+		int GetInt() const;
+
+		// Returns the value as a 64-bit integer.
+		long long GetInt64() const;
+
+		// Returns the value as a floating point number.
+		double GetDouble() const;
+
+		// Returns the value as null terminated UTF-8 text (or nullptr if the value is null).
+		const unsigned char* GetText() const;
+
+		// Returns the value as a blob (or nullptr if the value is null or empty).
+		const void* GetBlob() const;
+
+		// Returns the size of the value, in bytes, when read as text or as a blob.
+		int GetBytes() const;
+
+		// Sets a 32-bit integer 'value'.
+		void SetInt( const int value );
+
+		// Sets a 64-bit integer 'value'.
+		void SetInt64( const long long value );
+
+		// Sets a floating point 'value'.
+		void SetDouble( const double value );
+
+		// Sets a UTF-8 text 'value'.
+		void SetText( const std::string& value );
+
+		// Sets a blob value from the 'data' of size 'bytes'.
+		void SetBlob( const void* data, const int bytes );
+
+		// Binds the value to the parameter 'index' of the 'stmt'.
+		// Returns the SQLite result code.
+		int Bind( sqlite3_stmt* stmt, const int index ) const;
+
+		// Returns whether the value is the same as the 'other' value.
+		bool operator==( const Value& other ) const;
+
+	private:
+		// SQLite fundamental datatype.
+		int m_Type;
+
+		// Value as an integer.
+		long long m_Integer;
+
+		// Value as a floating point number.
+		double m_Float;
+
+		// Value as text or a blob.
+		std::string m_Bytes;
+	};
+
+	// Maps a setting name to its value.
+	using ValueMap = std::map<std::string, Value, std::less<>>;
+
+	// In-memory settings, which are changed in place under a lock (so that changing a setting does not copy all the settings).
+	// Readers are given an immutable snapshot of the settings, without taking the lock.
+	// The snapshot is only republished when the settings are next read after they have changed, so that a batch of changes only copies the settings once.
+	class Values
+	{
+	public:
+		// Immutable settings snapshot, which remains valid for as long as it is held.
+		using Ptr = SharedSnapshot<ValueMap>::Ptr;
+
+		Values();
+
+		virtual ~Values();
+
+		// Returns the current settings snapshot.
+		Ptr Get() const;
+
+		// Returns the current settings snapshot.
+		// 'version' - out, the version of the settings snapshot.
+		Ptr Get( uint64_t& version ) const;
+
+		// Changes the settings in place, using the 'modifier' (which is passed a ValueMap& to modify).
+		template <typename Modifier>
+		void Update( Modifier modifier )
+		{
+			std::lock_guard<std::mutex> lock( m_Mutex );
+			modifier( m_Values );
+			++m_Version;
+		}
+
+		// Replaces the settings with the 'values', returning the new version.
+		uint64_t Set( ValueMap values );
+
+		// Returns the settings version, which is incremented each time the settings are changed.
+		uint64_t GetVersion() const;
+
+	private:
+		// Publishes the settings as the current snapshot, if they have changed since the snapshot was last published.
+		// The settings mutex must be held by the caller.
+		void Publish() const;
+
+		// Settings mutex.
+		mutable std::mutex m_Mutex;
+
+		// Settings.
+		ValueMap m_Values;
+
+		// Settings version.
+		std::atomic<uint64_t> m_Version;
+
+		// Settings snapshot.
+		mutable SharedSnapshot<ValueMap> m_Snapshot;
+
+		// Version of the settings snapshot.
+		mutable std::atomic<uint64_t> m_SnapshotVersion;
+	};
+
+	// Loads the in-memory settings from the settings table.
+	void LoadValues();
+
+	// Writes any changed in-memory settings to the settings table, using a single transaction.
+	void Flush();
+
+	// Starts the write-behind thread.
+	void StartFlushThread();
+
+	// Stops the write-behind thread.
+	void StopFlushThread();
+
+	// Write-behind thread procedure.
+	static DWORD WINAPI FlushThreadProc( LPVOID lParam );
+
+	// Periodically writes any changed in-memory settings to the settings table, until the stop event is set.
+	void FlushThreadHandler();
+
 	// Updates the database to the current version if necessary.
 	void UpdateDatabase();
 
@@ -626,6 +824,24 @@ private:
 	// Media library.
 	Library& m_Library;
 
+	// In-memory settings, which are read without accessing the database.
+	Values m_Values;
+
+	// Settings as last written to (or read from) the settings table.
+	ValueMap m_PersistedValues;
+
+	// In-memory settings version which matches the persisted settings.
+	uint64_t m_PersistedVersion;
+
+	// Serialises loading & writing the settings table.
+	std::mutex m_FlushMutex;
+
+	// Write-behind thread.
+	HANDLE m_FlushThread;
+
+	// Write-behind thread stop event.
+	HANDLE m_FlushStopEvent;
+
 	// Pitch ranges.
 	static const PitchRangeMap s_PitchRanges;
 
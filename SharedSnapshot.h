@@ -0,0 +1,220 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+// Publishes immutable snapshots of a value, in the style of read-copy-update.
+// Readers obtain the current snapshot without taking a lock, allocating or copying the value, and a snapshot remains valid for as long as the reader holds on to it.
+// Writers are serialised, and modify a copy of the current value in spare storage, which is then published as the new snapshot.
+// Each storage slot has a count of the readers which have pinned it, and a slot is only reused once it has been replaced as the current snapshot and has no readers.
+// Snapshots must not be held on to beyond the lifetime of the SharedSnapshot object.
+template <typename T>
+class SharedSnapshot
+{
+private:
+	// Snapshot storage slot.
+	struct Slot {
+		T Value = {};											// Snapshot value.
+		std::atomic<size_t> Pins = 0;			// Number of readers holding on to the snapshot.
+	};
+
+public:
+	// Snapshot pointer type, which pins the snapshot storage until the pointer is released.
+	class Ptr
+	{
+	public:
+		Ptr() :
+			m_Slot( nullptr )
+		{
+		}
+
+		Ptr( const Ptr& other ) :
+			m_Slot( other.m_Slot )
+		{
+			if ( nullptr != m_Slot ) {
+				// The slot is already pinned by the other pointer, so cannot be reused while the count is incremented.
+				m_Slot->Pins.fetch_add( 1, std::memory_order_relaxed );
+			}
+		}
+
+		Ptr( Ptr&& other ) noexcept :
+			m_Slot( other.m_Slot )
+		{
+			other.m_Slot = nullptr;
+		}
+
+		Ptr& operator=( Ptr other ) noexcept
+		{
+			std::swap( m_Slot, other.m_Slot );
+			return *this;
+		}
+
+		~Ptr()
+		{
+			if ( nullptr != m_Slot ) {
+				// Releases the reader's accesses of the value to the writer, which acquires the count before reusing the slot.
+				m_Slot->Pins.fetch_sub( 1, std::memory_order_release );
+			}
+		}
+
+		const T& operator*() const
+		{
+			return m_Slot->Value;
+		}
+
+		const T* operator->() const
+		{
+			return &m_Slot->Value;
+		}
+
+		const T* get() const
+		{
+			return ( nullptr != m_Slot ) ? &m_Slot->Value : nullptr;
+		}
+
+		explicit operator bool() const
+		{
+			return nullptr != m_Slot;
+		}
+
+	private:
+		friend class SharedSnapshot;
+
+		// 'slot' - storage slot, which has already been pinned by the caller.
+		explicit Ptr( Slot* slot ) :
+			m_Slot( slot )
+		{
+		}
+
+		// Pinned storage slot.
+		Slot* m_Slot;
+	};
+
+	// Function for initialising new snapshot storage (e.g. to reserve capacity, so that publishing an update does not need to allocate).
+	using Initialiser = std::function<void( T& )>;
+
+	// 'initialiser' - called for each new storage slot (optional).
+	explicit SharedSnapshot( Initialiser initialiser = nullptr ) :
+		m_Current( nullptr ),
+		m_Slots(),
+		m_Initialiser( initialiser ),
+		m_Version( 0 ),
+		m_WriterMutex()
+	{
+		for ( size_t index = 0; index < kInitialSlots; index++ ) {
+			AddSlot();
+		}
+		m_Current.store( m_Slots.front().get() );
+	}
+
+	virtual ~SharedSnapshot()
+	{
+	}
+
+	SharedSnapshot( const SharedSnapshot& ) = delete;
+	SharedSnapshot& operator=( const SharedSnapshot& ) = delete;
+
+	// Returns the current snapshot.
+	Ptr Get() const
+	{
+		// The slot is pinned and then checked to still be the current snapshot, otherwise a writer might already have seen no readers and reused the slot.
+		// Both the pin and the check are sequentially consistent, to pair with the writer publishing a slot and then checking the pins of the previous slot.
+		Slot* slot = m_Current.load( std::memory_order_seq_cst );
+		while ( true ) {
+			slot->Pins.fetch_add( 1, std::memory_order_seq_cst );
+			Slot* current = m_Current.load( std::memory_order_seq_cst );
+			if ( current == slot ) {
+				break;
+			}
+			slot->Pins.fetch_sub( 1, std::memory_order_release );
+			slot = current;
+		}
+		return Ptr( slot );
+	}
+
+	// Returns the snapshot version, which is incremented each time a snapshot is published (so that readers can cheaply check for changes).
+	uint64_t GetVersion() const
+	{
+		return m_Version.load();
+	}
+
+	// Publishes a snapshot containing the 'value'.
+	void Set( const T& value )
+	{
+		std::lock_guard<std::mutex> lock( m_WriterMutex );
+		Slot* slot = GetSpareSlot();
+		slot->Value = value;
+		Publish( slot );
+	}
+
+	// Publishes a snapshot containing the current value, as changed by the 'modifier' (which is passed a T& to modify).
+	template <typename Modifier>
+	void Update( Modifier modifier )
+	{
+		std::lock_guard<std::mutex> lock( m_WriterMutex );
+		Slot* slot = GetSpareSlot();
+		slot->Value = m_Current.load( std::memory_order_relaxed )->Value;
+		modifier( slot->Value );
+		Publish( slot );
+	}
+
+private:
+	// Initial number of snapshot storage slots (the current snapshot, the previous snapshot which readers might still hold, and a spare).
+	static constexpr size_t kInitialSlots = 3;
+
+	// Adds a new storage slot, returning the slot.
+	// The writer mutex must be held by the caller (or the caller must be the constructor).
+	Slot* AddSlot()
+	{
+		m_Slots.push_back( std::make_unique<Slot>() );
+		Slot* slot = m_Slots.back().get();
+		if ( m_Initialiser ) {
+			m_Initialiser( slot->Value );
+		}
+		return slot;
+	}
+
+	// Returns a storage slot which is not the current snapshot, and which is not pinned by any reader.
+	// If all slots are pinned, a new slot is added (which only happens when readers hold on to several older snapshots).
+	// The writer mutex must be held by the caller.
+	Slot* GetSpareSlot()
+	{
+		Slot* current = m_Current.load( std::memory_order_relaxed );
+		for ( const auto& slot : m_Slots ) {
+			// Once a slot has been replaced as the current snapshot, a reader can only pin it if the reader has not yet seen the replacement, in which case the reader unpins the slot without accessing the value.
+			// An unpinned count is acquired, so that the reader's accesses of the value happen before the slot is reused.
+			if ( ( current != slot.get() ) && ( 0 == slot->Pins.load( std::memory_order_seq_cst ) ) ) {
+				return slot.get();
+			}
+		}
+		return AddSlot();
+	}
+
+	// Publishes the storage 'slot' as the current snapshot.
+	// The writer mutex must be held by the caller.
+	void Publish( Slot* slot )
+	{
+		m_Current.store( slot, std::memory_order_seq_cst );
+		++m_Version;
+	}
+
+	// Current snapshot.
+	std::atomic<Slot*> m_Current;
+
+	// Snapshot storage slots (only accessed by writers).
+	std::vector<std::unique_ptr<Slot>> m_Slots;
+
+	// Initialiser for new storage slots.
+	const Initialiser m_Initialiser;
+
+	// Snapshot version.
+	std::atomic<uint64_t> m_Version;
+
+	// Serialises writers.
+	std::mutex m_WriterMutex;
+};
@@ -0,0 +1,284 @@
+#include "TaskScheduler.h"
+
+#include <algorithm>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <objbase.h>
+#endif
+
+// Minimum number of worker threads, so that long running library tasks do not starve other work on machines with few hardware threads.
+constexpr size_t kMinimumThreadCount = 4;
+
+// Interval at which a worker thread waiting on a group checks for other tasks to run.
+constexpr std::chrono::milliseconds kHelpInterval( 10 );
+
+// The scheduler to which the calling thread belongs, if it is a worker thread.
+thread_local TaskScheduler* s_CurrentScheduler = nullptr;
+
+// The worker index of the calling thread, if it is a worker thread.
+thread_local size_t s_CurrentIndex = 0;
+
+TaskScheduler::Group::Group() :
+	m_State( std::make_shared<State>() )
+{
+}
+
+TaskScheduler::Group::~Group()
+{
+	Cancel();
+}
+
+bool TaskScheduler::Group::IsCancelled() const
+{
+	return m_State->Cancelled.load();
+}
+
+size_t TaskScheduler::Group::GetCount() const
+{
+	return m_State->Count.load();
+}
+
+void TaskScheduler::Group::Wait()
+{
+	size_t index = 0;
+	TaskScheduler* scheduler = GetCurrentScheduler( index );
+	while ( m_State->Count.load() > 0 ) {
+		if ( nullptr != scheduler ) {
+			// Help out with this group's own tasks while waiting, so that worker threads cannot all end up blocked on each other.
+			if ( !scheduler->RunPendingTask( m_State.get() ) ) {
+				std::unique_lock<std::mutex> lock( m_State->Mutex );
+				m_State->Finished.wait_for( lock, kHelpInterval, [ state = m_State.get() ] () { return 0 == state->Count.load(); } );
+			}
+		} else {
+			std::unique_lock<std::mutex> lock( m_State->Mutex );
+			m_State->Finished.wait( lock, [ state = m_State.get() ] () { return 0 == state->Count.load(); } );
+		}
+	}
+}
+
+void TaskScheduler::Group::Cancel()
+{
+	m_State->Cancelled.store( true );
+	Wait();
+	m_State->Cancelled.store( false );
+}
+
+TaskScheduler::TaskScheduler( const size_t threadCount, ThreadCallback onThreadStart, ThreadCallback onThreadStop ) :
+	m_Workers(),
+	m_Threads(),
+	m_Counters(),
+	m_QueuedCount( 0 ),
+	m_Steals( 0 ),
+	m_NextWorker( 0 ),
+	m_IdleMutex(),
+	m_IdleCondition(),
+	m_Stopping( false ),
+	m_OnThreadStart( onThreadStart ),
+	m_OnThreadStop( onThreadStop )
+{
+	const size_t workerCount = ( threadCount > 0 ) ? threadCount : std::max<size_t>( kMinimumThreadCount, std::thread::hardware_concurrency() );
+	m_Workers.reserve( workerCount );
+	for ( size_t index = 0; index < workerCount; index++ ) {
+		m_Workers.push_back( std::make_unique<Worker>() );
+	}
+	m_Threads.reserve( workerCount );
+	for ( size_t index = 0; index < workerCount; index++ ) {
+		m_Threads.push_back( std::thread( &TaskScheduler::WorkerHandler, this, index ) );
+	}
+}
+
+TaskScheduler::~TaskScheduler()
+{
+	{
+		std::lock_guard<std::mutex> lock( m_IdleMutex );
+		m_Stopping = true;
+	}
+	m_IdleCondition.notify_all();
+	for ( auto& thread : m_Threads ) {
+		thread.join();
+	}
+}
+
+TaskScheduler& TaskScheduler::Get()
+{
+#ifdef _WIN32
+	// Worker threads join the multithreaded apartment for their whole lifetime, so that tasks do not need to initialise COM themselves.
+	static TaskScheduler s_Scheduler( 0 /*threadCount*/,
+		[] () { CoInitializeEx( NULL /*reserved*/, COINIT_MULTITHREADED ); },
+		[] () { CoUninitialize(); } );
+#else
+	static TaskScheduler s_Scheduler;
+#endif
+	return s_Scheduler;
+}
+
+TaskScheduler& TaskScheduler::GetBackground()
+{
+#ifdef _WIN32
+	static TaskScheduler s_Scheduler( 0 /*threadCount*/,
+		[] () {
+			CoInitializeEx( NULL /*reserved*/, COINIT_MULTITHREADED );
+			SetThreadPriority( GetCurrentThread(), THREAD_PRIORITY_LOWEST );
+		},
+		[] () { CoUninitialize(); } );
+#else
+	static TaskScheduler s_Scheduler;
+#endif
+	return s_Scheduler;
+}
+
+TaskScheduler* TaskScheduler::GetCurrentScheduler( size_t& index )
+{
+	index = s_CurrentIndex;
+	return s_CurrentScheduler;
+}
+
+void TaskScheduler::Submit( Group& group, const Priority priority, std::function<void()> task )
+{
+	if ( task && ( priority < Priority::_Count ) ) {
+		++group.m_State->Count;
+
+		// Tasks submitted from a worker thread are queued on that worker, otherwise the workers are used in turn.
+		size_t index = 0;
+		const size_t workerIndex = ( this == GetCurrentScheduler( index ) ) ? index : ( m_NextWorker++ % m_Workers.size() );
+		const size_t priorityIndex = static_cast<size_t>( priority );
+		Worker& worker = *m_Workers[ workerIndex ];
+		{
+			std::lock_guard<std::mutex> lock( worker.Mutex );
+			worker.Queues[ priorityIndex ].push_back( { std::move( task ), group.m_State, priority, Clock::now() } );
+		}
+
+		Counters& counters = m_Counters[ priorityIndex ];
+		++counters.Submitted;
+		++counters.QueueDepth;
+		{
+			std::lock_guard<std::mutex> lock( m_IdleMutex );
+			++m_QueuedCount;
+		}
+		m_IdleCondition.notify_one();
+	}
+}
+
+bool TaskScheduler::TakeTask( const size_t index, Task& task, const Group::State* groupState )
+{
+	bool taken = false;
+	const size_t workerCount = m_Workers.size();
+	for ( size_t priorityIndex = 0; !taken && ( priorityIndex < kPriorityCount ); priorityIndex++ ) {
+		// Check the worker's own queue first, then steal from the other workers.
+		for ( size_t offset = 0; !taken && ( offset < workerCount ); offset++ ) {
+			Worker& worker = *m_Workers[ ( index + offset ) % workerCount ];
+			std::lock_guard<std::mutex> lock( worker.Mutex );
+			auto& queue = worker.Queues[ priorityIndex ];
+			const auto queued = ( nullptr == groupState ) ? queue.begin() :
+				std::find_if( queue.begin(), queue.end(), [ groupState ] ( const Task& queuedTask ) { return groupState == queuedTask.GroupState.get(); } );
+			if ( queue.end() != queued ) {
+				task = std::move( *queued );
+				queue.erase( queued );
+				taken = true;
+				if ( 0 != offset ) {
+					++m_Steals;
+				}
+			}
+		}
+		if ( taken ) {
+			--m_Counters[ priorityIndex ].QueueDepth;
+			--m_QueuedCount;
+		}
+	}
+	return taken;
+}
+
+void TaskScheduler::RunTask( Task& task )
+{
+	Counters& counters = m_Counters[ static_cast<size_t>( task.TaskPriority ) ];
+	const Clock::time_point startTime = Clock::now();
+	const uint64_t latency = static_cast<uint64_t>( std::chrono::duration_cast<std::chrono::microseconds>( startTime - task.SubmitTime ).count() );
+	counters.TotalLatency += latency;
+	uint64_t maxLatency = counters.MaxLatency.load();
+	while ( ( latency > maxLatency ) && !counters.MaxLatency.compare_exchange_weak( maxLatency, latency ) ) {
+	}
+
+	if ( task.GroupState->Cancelled.load() ) {
+		++counters.Discarded;
+	} else {
+		task.Function();
+		counters.TotalRunTime += static_cast<uint64_t>( std::chrono::duration_cast<std::chrono::microseconds>( Clock::now() - startTime ).count() );
+		++counters.Completed;
+	}
+	task.Function = nullptr;
+
+	const std::shared_ptr<Group::State> groupState = std::move( task.GroupState );
+	std::lock_guard<std::mutex> lock( groupState->Mutex );
+	if ( 0 == --groupState->Count ) {
+		groupState->Finished.notify_all();
+	}
+}
+
+bool TaskScheduler::RunPendingTask( Group& group )
+{
+	return RunPendingTask( group.m_State.get() );
+}
+
+bool TaskScheduler::RunPendingTask( const Group::State* groupState )
+{
+	size_t index = 0;
+	Task task;
+	const bool taken = ( this == GetCurrentScheduler( index ) ) && TakeTask( index, task, groupState );
+	if ( taken ) {
+		RunTask( task );
+	}
+	return taken;
+}
+
+void TaskScheduler::WorkerHandler( const size_t index )
+{
+	if ( m_OnThreadStart ) {
+		m_OnThreadStart();
+	}
+	s_CurrentScheduler = this;
+	s_CurrentIndex = index;
+	bool stop = false;
+	while ( !stop ) {
+		Task task;
+		if ( TakeTask( index, task ) ) {
+			RunTask( task );
+		} else {
+			std::unique_lock<std::mutex> lock( m_IdleMutex );
+			m_IdleCondition.wait( lock, [ this ] () { return m_Stopping || ( m_QueuedCount.load() > 0 ); } );
+			stop = m_Stopping && ( 0 == m_QueuedCount.load() );
+		}
+	}
+	s_CurrentScheduler = nullptr;
+	if ( m_OnThreadStop ) {
+		m_OnThreadStop();
+	}
+}
+
+TaskScheduler::Metrics TaskScheduler::GetMetrics() const
+{
+	Metrics metrics;
+	metrics.ThreadCount = m_Threads.size();
+	metrics.Steals = m_Steals.load();
+	for ( size_t priorityIndex = 0; priorityIndex < kPriorityCount; priorityIndex++ ) {
+		const Counters& counters = m_Counters[ priorityIndex ];
+		PriorityMetrics& priorityMetrics = metrics.Priorities[ priorityIndex ];
+		priorityMetrics.QueueDepth = counters.QueueDepth.load();
+		priorityMetrics.Submitted = counters.Submitted.load();
+		priorityMetrics.Completed = counters.Completed.load();
+		priorityMetrics.Discarded = counters.Discarded.load();
+		if ( const uint64_t started = priorityMetrics.Completed + priorityMetrics.Discarded; started > 0 ) {
+			priorityMetrics.AverageLatency = static_cast<double>( counters.TotalLatency.load() ) / started / 1e6;
+		}
+		priorityMetrics.MaxLatency = static_cast<double>( counters.MaxLatency.load() ) / 1e6;
+		if ( priorityMetrics.Completed > 0 ) {
+			priorityMetrics.AverageRunTime = static_cast<double>( counters.TotalRunTime.load() ) / priorityMetrics.Completed / 1e6;
+		}
+	}
+	return metrics;
+}
+
+size_t TaskScheduler::GetThreadCount() const
+{
+	return m_Threads.size();
+}
@@ -0,0 +1,202 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Application-wide work-stealing task scheduler.
+// Each worker thread has its own set of task queues, with idle workers stealing the oldest tasks from busy workers.
+// Tasks are always run in priority order, and can be cancelled cooperatively via the task group to which they belong.
+// The scheduler core only uses the standard library, so that it is portable.
+// Long running, low priority work (such as library maintenance & gain calculation) should use the background scheduler, whose worker threads run at a lower thread priority, so that it cannot hold up interactive work.
+class TaskScheduler
+{
+public:
+	// Task priority, from highest to lowest.
+	enum class Priority {
+		Playback,
+		UI,
+		Library,
+		Analysis,
+
+		_Count
+	};
+
+	// Number of priority levels.
+	static constexpr size_t kPriorityCount = static_cast<size_t>( Priority::_Count );
+
+	// A group of tasks which can be waited upon, and cancelled, together.
+	// Groups can be reused once all their tasks have finished.
+	class Group
+	{
+	public:
+		Group();
+
+		virtual ~Group();
+
+		// Returns whether the group has been cancelled.
+		// Long running tasks should check this periodically, and return early when cancelled.
+		bool IsCancelled() const;
+
+		// Returns the number of tasks which are queued or running.
+		size_t GetCount() const;
+
+		// Waits for all tasks in the group to finish.
+		// If called from a worker thread, queued tasks belonging to this group are run while waiting (tasks from other groups are never run, so that a waiting task cannot end up running unrelated work on its stack).
+		void Wait();
+
+		// Cancels all tasks in the group, waits for any running tasks to finish, then resets the group for reuse.
+		// Queued tasks which have not started are discarded.
+		void Cancel();
+
+	private:
+		friend class TaskScheduler;
+
+		// Shared group state, which outlives the group for any tasks still held by the scheduler.
+		struct State {
+			std::atomic<bool> Cancelled = false;
+			std::atomic<size_t> Count = 0;
+			std::mutex Mutex;
+			std::condition_variable Finished;
+		};
+
+		// Group state.
+		std::shared_ptr<State> m_State;
+	};
+
+	// Metrics for a priority level.
+	struct PriorityMetrics {
+		size_t QueueDepth = 0;						// Number of tasks currently queued.
+		uint64_t Submitted = 0;						// Total number of tasks submitted.
+		uint64_t Completed = 0;						// Total number of tasks run to completion.
+		uint64_t Discarded = 0;						// Total number of cancelled tasks discarded before starting.
+		double AverageLatency = 0;				// Average time between submission and start, in seconds.
+		double MaxLatency = 0;						// Maximum time between submission and start, in seconds.
+		double AverageRunTime = 0;				// Average task run time, in seconds.
+	};
+
+	// Scheduler metrics.
+	struct Metrics {
+		size_t ThreadCount = 0;																// Number of worker threads.
+		uint64_t Steals = 0;																	// Total number of tasks stolen from another worker.
+		std::array<PriorityMetrics, kPriorityCount> Priorities;	// Per priority level metrics.
+	};
+
+	// A callback which is run on each worker thread, when the thread starts or just before it exits.
+	using ThreadCallback = std::function<void()>;
+
+	// 'threadCount' - number of worker threads, or zero to use one per hardware thread (with a minimum of four).
+	// 'onThreadStart' - called on each worker thread before it runs any tasks (e.g. to initialise COM, or to set the thread priority).
+	// 'onThreadStop' - called on each worker thread after it has run its last task.
+	explicit TaskScheduler( const size_t threadCount = 0, ThreadCallback onThreadStart = nullptr, ThreadCallback onThreadStop = nullptr );
+
+	virtual ~TaskScheduler();
+
+	// Returns the application-wide scheduler, for playback & UI work.
+	static TaskScheduler& Get();
+
+	// Returns the application-wide background scheduler, for library & analysis work, whose worker threads run at the lowest thread priority.
+	static TaskScheduler& GetBackground();
+
+	// Submits a 'task' to run at a 'priority', as part of a 'group'.
+	void Submit( Group& group, const Priority priority, std::function<void()> task );
+
+	// Runs a single queued task belonging to the 'group', if the calling thread is one of this scheduler's worker threads.
+	// This allows a long running task to help with the group's work, rather than holding on to its worker while other workers are busy.
+	// Returns whether a task was run.
+	bool RunPendingTask( Group& group );
+
+	// Returns the current scheduler metrics.
+	Metrics GetMetrics() const;
+
+	// Returns the number of worker threads.
+	size_t GetThreadCount() const;
+
+private:
+	// Clock used for latency measurements.
+	using Clock = std::chrono::steady_clock;
+
+	// A queued task.
+	struct Task {
+		std::function<void()> Function;
+		std::shared_ptr<Group::State> GroupState;
+		Priority TaskPriority = Priority::Analysis;
+		Clock::time_point SubmitTime;
+	};
+
+	// Per worker task queues.
+	struct Worker {
+		std::mutex Mutex;
+		std::array<std::deque<Task>, kPriorityCount> Queues;
+	};
+
+	// Per priority level counters.
+	struct Counters {
+		std::atomic<size_t> QueueDepth = 0;
+		std::atomic<uint64_t> Submitted = 0;
+		std::atomic<uint64_t> Completed = 0;
+		std::atomic<uint64_t> Discarded = 0;
+		std::atomic<uint64_t> TotalLatency = 0;	// In microseconds.
+		std::atomic<uint64_t> MaxLatency = 0;		// In microseconds.
+		std::atomic<uint64_t> TotalRunTime = 0;	// In microseconds.
+	};
+
+	// Worker thread handler.
+	// 'index' - worker index.
+	void WorkerHandler( const size_t index );
+
+	// Takes the highest priority task available to the worker with the 'index', returning whether a task was taken.
+	// 'groupState' - if not null, only a task belonging to this group is taken.
+	bool TakeTask( const size_t index, Task& task, const Group::State* groupState = nullptr );
+
+	// Runs (or discards, if its group has been cancelled) a 'task'.
+	void RunTask( Task& task );
+
+	// Runs a single queued task belonging to the group with the 'groupState' on the calling worker thread, returning whether a task was run.
+	bool RunPendingTask( const Group::State* groupState );
+
+	// Returns the scheduler & worker index for the calling thread, or nullptr if the calling thread is not a worker thread.
+	static TaskScheduler* GetCurrentScheduler( size_t& index );
+
+	// Worker queues.
+	std::vector<std::unique_ptr<Worker>> m_Workers;
+
+	// Worker threads.
+	std::vector<std::thread> m_Threads;
+
+	// Per priority level counters.
+	std::array<Counters, kPriorityCount> m_Counters;
+
+	// Total number of queued tasks.
+	std::atomic<size_t> m_QueuedCount;
+
+	// Total number of stolen tasks.
+	std::atomic<uint64_t> m_Steals;
+
+	// Next worker to which a task submitted from a non-worker thread is assigned.
+	std::atomic<size_t> m_NextWorker;
+
+	// Mutex for idle workers.
+	std::mutex m_IdleMutex;
+
+	// Wakes idle workers.
+	std::condition_variable m_IdleCondition;
+
+	// Indicates whether the scheduler is stopping.
+	bool m_Stopping;
+
+	// Called on each worker thread when it starts.
+	ThreadCallback m_OnThreadStart;
+
+	// Called on each worker thread just before it exits.
+	ThreadCallback m_OnThreadStop;
+};
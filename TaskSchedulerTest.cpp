@@ -0,0 +1,330 @@
+#include "TaskSchedulerTest.h"
+
+#include "TaskScheduler.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+// Number of threads submitting tasks, when checking that all tasks are run.
+constexpr size_t kSubmitThreads = 4;
+
+// Number of tasks submitted by each thread, when checking that all tasks are run.
+constexpr long long kTasksPerThread = 2500;
+
+// Interval at which a submitted task also submits a nested task, when checking that all tasks are run.
+constexpr long long kNestedTaskInterval = 10;
+
+// Number of worker threads, when checking work stealing & thread callbacks.
+constexpr size_t kWorkerThreads = 4;
+
+// Number of tasks to submit for the cancel, worker wait & work stealing checks.
+constexpr long long kTaskCount = 64;
+
+// Duration of each task, when checking work stealing.
+constexpr std::chrono::milliseconds kStealTaskDuration( 2 );
+
+// Indicates whether the thread start callback has been run on the calling thread.
+thread_local bool s_ThreadStarted = false;
+
+TaskSchedulerTest::TaskSchedulerTest()
+{
+}
+
+TaskSchedulerTest::~TaskSchedulerTest()
+{
+}
+
+bool TaskSchedulerTest::Run( const std::wstring& outputFilename ) const
+{
+	Results results;
+	results.push_back( CheckAllTasksRun() );
+	results.push_back( CheckPriorityOrder() );
+	for ( const auto& checks : { CheckCancel(), CheckWorkerWait(), CheckRunPendingTask(), CheckThreadCallbacks() } ) {
+		results.insert( results.end(), checks.begin(), checks.end() );
+	}
+	results.push_back( CheckStealing() );
+
+	bool passed = true;
+	for ( const auto& result : results ) {
+		passed = passed && result.Passed;
+	}
+
+	const bool success = IsBenchmarkCSV( outputFilename ) ? WriteCSV( results, outputFilename ) : WriteJSON( results, outputFilename );
+	return passed && success;
+}
+
+TaskSchedulerTest::Result TaskSchedulerTest::MakeResult( const std::string& name, const long long expected, const long long actual )
+{
+	Result result;
+	result.Name = name;
+	result.Expected = expected;
+	result.Actual = actual;
+	result.Passed = ( expected == actual );
+	return result;
+}
+
+TaskSchedulerTest::Result TaskSchedulerTest::CheckAllTasksRun()
+{
+	std::atomic<long long> count = 0;
+	{
+		TaskScheduler scheduler( kWorkerThreads );
+		std::array<TaskScheduler::Group, 2> groups;
+		std::vector<std::thread> threads;
+		for ( size_t threadIndex = 0; threadIndex < kSubmitThreads; threadIndex++ ) {
+			threads.push_back( std::thread( [ &scheduler, &groups, &count ] ()
+			{
+				for ( long long taskIndex = 0; taskIndex < kTasksPerThread; taskIndex++ ) {
+					TaskScheduler::Group& group = groups[ static_cast<size_t>( taskIndex ) % groups.size() ];
+					const auto priority = static_cast<TaskScheduler::Priority>( taskIndex % static_cast<long long>( TaskScheduler::kPriorityCount ) );
+					scheduler.Submit( group, priority, [ &scheduler, &group, &count, priority, nested = ( 0 == ( taskIndex % kNestedTaskInterval ) ) ] ()
+					{
+						++count;
+						if ( nested ) {
+							scheduler.Submit( group, priority, [ &count ] () { ++count; } );
+						}
+					} );
+				}
+			} ) );
+		}
+		for ( auto& thread : threads ) {
+			thread.join();
+		}
+		for ( auto& group : groups ) {
+			group.Wait();
+		}
+	}
+
+	const long long expected = static_cast<long long>( kSubmitThreads ) * ( kTasksPerThread + kTasksPerThread / kNestedTaskInterval );
+	return MakeResult( "all_tasks_run", expected, count );
+}
+
+TaskSchedulerTest::Result TaskSchedulerTest::CheckPriorityOrder()
+{
+	// A single worker is blocked while the tasks are queued, in the reverse of priority order.
+	std::vector<TaskScheduler::Priority> order;
+	{
+		TaskScheduler scheduler( 1 /*threadCount*/ );
+		TaskScheduler::Group blocker;
+		TaskScheduler::Group group;
+		std::promise<void> started;
+		std::promise<void> gate;
+		std::shared_future<void> opened = gate.get_future().share();
+		scheduler.Submit( blocker, TaskScheduler::Priority::Playback, [ &started, opened ] ()
+		{
+			started.set_value();
+			opened.wait();
+		} );
+		started.get_future().wait();
+
+		for ( size_t priorityIndex = TaskScheduler::kPriorityCount; priorityIndex > 0; priorityIndex-- ) {
+			const auto priority = static_cast<TaskScheduler::Priority>( priorityIndex - 1 );
+			scheduler.Submit( group, priority, [ &order, priority ] () { order.push_back( priority ); } );
+		}
+		gate.set_value();
+		blocker.Wait();
+		group.Wait();
+	}
+
+	long long outOfOrder = static_cast<long long>( TaskScheduler::kPriorityCount ) - static_cast<long long>( order.size() );
+	for ( size_t index = 0; index < order.size(); index++ ) {
+		if ( static_cast<size_t>( order[ index ] ) != index ) {
+			++outOfOrder;
+		}
+	}
+	return MakeResult( "priority_order_errors", 0, outOfOrder );
+}
+
+TaskSchedulerTest::Results TaskSchedulerTest::CheckCancel()
+{
+	Results results;
+	TaskScheduler scheduler( 1 /*threadCount*/ );
+	TaskScheduler::Group blocker;
+	TaskScheduler::Group group;
+	std::atomic<long long> count = 0;
+	std::promise<void> started;
+	std::promise<void> gate;
+	std::shared_future<void> opened = gate.get_future().share();
+	scheduler.Submit( blocker, TaskScheduler::Priority::Playback, [ &started, opened ] ()
+	{
+		started.set_value();
+		opened.wait();
+	} );
+	started.get_future().wait();
+
+	for ( long long taskIndex = 0; taskIndex < kTaskCount; taskIndex++ ) {
+		scheduler.Submit( group, TaskScheduler::Priority::Analysis, [ &count ] () { ++count; } );
+	}
+
+	// The group is cancelled while its tasks are still queued behind the blocked worker.
+	std::thread cancelThread( [ &group ] () { group.Cancel(); } );
+	while ( !group.IsCancelled() ) {
+		std::this_thread::yield();
+	}
+	gate.set_value();
+	cancelThread.join();
+	blocker.Wait();
+
+	const size_t analysis = static_cast<size_t>( TaskScheduler::Priority::Analysis );
+	results.push_back( MakeResult( "cancel_tasks_run", 0, count ) );
+	results.push_back( MakeResult( "cancel_tasks_discarded", kTaskCount, static_cast<long long>( scheduler.GetMetrics().Priorities[ analysis ].Discarded ) ) );
+
+	for ( long long taskIndex = 0; taskIndex < kTaskCount; taskIndex++ ) {
+		scheduler.Submit( group, TaskScheduler::Priority::Analysis, [ &count ] () { ++count; } );
+	}
+	group.Wait();
+	results.push_back( MakeResult( "cancel_group_reused", kTaskCount, count ) );
+	return results;
+}
+
+TaskSchedulerTest::Results TaskSchedulerTest::CheckWorkerWait()
+{
+	// With a single worker, a task waits on a group of lower priority tasks, while a higher priority task from another group is also queued.
+	TaskScheduler scheduler( 1 /*threadCount*/ );
+	TaskScheduler::Group outer;
+	TaskScheduler::Group inner;
+	TaskScheduler::Group other;
+	std::atomic<long long> innerCount = 0;
+	std::atomic<bool> otherRun = false;
+	long long innerCountAfterWait = 0;
+	bool otherRunDuringWait = true;
+	scheduler.Submit( outer, TaskScheduler::Priority::Library, [ & ] ()
+	{
+		scheduler.Submit( other, TaskScheduler::Priority::Playback, [ &otherRun ] () { otherRun = true; } );
+		for ( long long taskIndex = 0; taskIndex < kTaskCount; taskIndex++ ) {
+			scheduler.Submit( inner, TaskScheduler::Priority::Analysis, [ &innerCount ] () { ++innerCount; } );
+		}
+		inner.Wait();
+		innerCountAfterWait = innerCount;
+		otherRunDuringWait = otherRun;
+	} );
+	outer.Wait();
+	other.Wait();
+
+	Results results;
+	results.push_back( MakeResult( "worker_wait_own_tasks_run", kTaskCount, innerCountAfterWait ) );
+	results.push_back( MakeResult( "worker_wait_other_tasks_run", 0, otherRunDuringWait ? 1 : 0 ) );
+	results.push_back( MakeResult( "worker_wait_other_tasks_run_afterwards", 1, otherRun ? 1 : 0 ) );
+	return results;
+}
+
+TaskSchedulerTest::Results TaskSchedulerTest::CheckRunPendingTask()
+{
+	// With a single worker, a task runs the pending tasks of another group, which could not otherwise run until the task had finished.
+	TaskScheduler scheduler( 1 /*threadCount*/ );
+	TaskScheduler::Group outer;
+	TaskScheduler::Group inner;
+	std::atomic<long long> innerCount = 0;
+	long long innerCountAfterRun = 0;
+	scheduler.Submit( outer, TaskScheduler::Priority::Library, [ & ] ()
+	{
+		for ( long long taskIndex = 0; taskIndex < kTaskCount; taskIndex++ ) {
+			scheduler.Submit( inner, TaskScheduler::Priority::Library, [ &innerCount ] () { ++innerCount; } );
+		}
+		while ( scheduler.RunPendingTask( inner ) ) {
+		}
+		innerCountAfterRun = innerCount;
+	} );
+	outer.Wait();
+
+	// Tasks cannot be run from a thread which is not a worker thread.
+	std::promise<void> started;
+	std::promise<void> gate;
+	std::shared_future<void> opened = gate.get_future().share();
+	scheduler.Submit( outer, TaskScheduler::Priority::Playback, [ &started, opened ] ()
+	{
+		started.set_value();
+		opened.wait();
+	} );
+	started.get_future().wait();
+	scheduler.Submit( inner, TaskScheduler::Priority::Library, [ &innerCount ] () { ++innerCount; } );
+	const bool runFromOtherThread = scheduler.RunPendingTask( inner );
+	gate.set_value();
+	outer.Wait();
+	inner.Wait();
+
+	Results results;
+	results.push_back( MakeResult( "run_pending_tasks_run", kTaskCount, innerCountAfterRun ) );
+	results.push_back( MakeResult( "run_pending_tasks_run_from_other_thread", 0, runFromOtherThread ? 1 : 0 ) );
+	return results;
+}
+
+TaskSchedulerTest::Result TaskSchedulerTest::CheckStealing()
+{
+	// Tasks submitted from a worker thread are queued on that worker, so any other worker which runs one of them must have stolen it.
+	std::set<std::thread::id> threads;
+	std::mutex threadsMutex;
+	TaskScheduler scheduler( kWorkerThreads );
+	TaskScheduler::Group group;
+	scheduler.Submit( group, TaskScheduler::Priority::Library, [ & ] ()
+	{
+		for ( long long taskIndex = 0; taskIndex < kTaskCount; taskIndex++ ) {
+			scheduler.Submit( group, TaskScheduler::Priority::Library, [ & ] ()
+			{
+				std::this_thread::sleep_for( kStealTaskDuration );
+				std::lock_guard<std::mutex> lock( threadsMutex );
+				threads.insert( std::this_thread::get_id() );
+			} );
+		}
+	} );
+	group.Wait();
+
+	const bool stolen = ( scheduler.GetMetrics().Steals > 0 ) && ( threads.size() > 1 );
+	return MakeResult( "tasks_stolen", 1, stolen ? 1 : 0 );
+}
+
+TaskSchedulerTest::Results TaskSchedulerTest::CheckThreadCallbacks()
+{
+	std::atomic<long long> starts = 0;
+	std::atomic<long long> stops = 0;
+	std::atomic<long long> tasksBeforeStart = 0;
+	{
+		TaskScheduler scheduler( kWorkerThreads, [ &starts ] () { ++starts; s_ThreadStarted = true; }, [ &stops ] () { ++stops; } );
+		TaskScheduler::Group group;
+		for ( long long taskIndex = 0; taskIndex < kTaskCount; taskIndex++ ) {
+			scheduler.Submit( group, TaskScheduler::Priority::UI, [ &tasksBeforeStart ] ()
+			{
+				if ( !s_ThreadStarted ) {
+					++tasksBeforeStart;
+				}
+			} );
+		}
+		group.Wait();
+	}
+
+	Results results;
+	results.push_back( MakeResult( "thread_start_callbacks", static_cast<long long>( kWorkerThreads ), starts ) );
+	results.push_back( MakeResult( "thread_stop_callbacks", static_cast<long long>( kWorkerThreads ), stops ) );
+	results.push_back( MakeResult( "tasks_run_before_thread_start", 0, tasksBeforeStart ) );
+	return results;
+}
+
+bool TaskSchedulerTest::WriteJSON( const Results& results, const std::wstring& outputFilename )
+{
+	nlohmann::json document = nlohmann::json::array();
+	for ( const auto& result : results ) {
+		nlohmann::json entry;
+		entry[ "test" ] = result.Name;
+		entry[ "expected" ] = result.Expected;
+		entry[ "actual" ] = result.Actual;
+		entry[ "passed" ] = result.Passed;
+		document.push_back( entry );
+	}
+
+	return WriteBenchmarkJSON( document, outputFilename );
+}
+
+bool TaskSchedulerTest::WriteCSV( const Results& results, const std::wstring& outputFilename )
+{
+	return WriteBenchmarkCSV( outputFilename, "test,expected,actual,passed", [ &results ] ( std::ostream& stream )
+	{
+		for ( const auto& result : results ) {
+			stream << result.Name << "," << result.Expected << "," << result.Actual << "," << ( result.Passed ? "true" : "false" ) << std::endl;
+		}
+	} );
+}
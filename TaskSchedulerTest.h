@@ -0,0 +1,65 @@
+#pragma once
+
+#include "stdafx.h"
+
+#include "BenchmarkUtility.h"
+
+#include <string>
+#include <vector>
+
+// Checks the task scheduler: that all tasks are run, in priority order, that cancelled tasks are discarded,
+// that waiting on a group from a worker thread only runs that group's tasks, that a worker can run a group's pending tasks, that idle workers steal tasks, and that the worker thread callbacks are run.
+class TaskSchedulerTest
+{
+public:
+	TaskSchedulerTest();
+
+	virtual ~TaskSchedulerTest();
+
+	// Runs the test.
+	// 'outputFilename' - results file, written as CSV if the file has a .csv extension, otherwise as JSON.
+	// Returns whether all checks passed and the results were written.
+	bool Run( const std::wstring& outputFilename ) const;
+
+private:
+	// Result for a test case.
+	struct Result {
+		std::string Name;							// Test case name.
+		long long Expected = 0;				// Expected value.
+		long long Actual = 0;					// Actual value.
+		bool Passed = false;					// Whether the check passed.
+	};
+
+	// A list of results.
+	using Results = std::vector<Result>;
+
+	// Checks that all tasks submitted from several threads, across several groups, are run exactly once.
+	static Result CheckAllTasksRun();
+
+	// Checks that queued tasks are run in priority order.
+	static Result CheckPriorityOrder();
+
+	// Checks that queued tasks are discarded when their group is cancelled, and that the group can then be reused.
+	static Results CheckCancel();
+
+	// Checks that waiting on a group from a worker thread runs the group's own queued tasks, but not tasks from other groups.
+	static Results CheckWorkerWait();
+
+	// Checks that a worker thread can run a group's pending tasks itself, and that other threads cannot.
+	static Results CheckRunPendingTask();
+
+	// Checks that tasks queued on a single worker are stolen by idle workers.
+	static Result CheckStealing();
+
+	// Checks that the thread start & stop callbacks are run once on each worker thread.
+	static Results CheckThreadCallbacks();
+
+	// Returns a result for the test case with the 'name', which passes if the 'actual' value matches the 'expected' value.
+	static Result MakeResult( const std::string& name, const long long expected, const long long actual );
+
+	// Writes the 'results' as JSON to the 'outputFilename', returning whether the file was written.
+	static bool WriteJSON( const Results& results, const std::wstring& outputFilename );
+
+	// Writes the 'results' as CSV to the 'outputFilename', returning whether the file was written.
+	static bool WriteCSV( const Results& results, const std::wstring& outputFilename );
+};
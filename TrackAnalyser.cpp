@@ -0,0 +1,248 @@
+#include "TrackAnalyser.h"
+
+#include "Handlers.h"
+#include "Library.h"
+#include "Utility.h"
+
+#include <algorithm>
+#include <cmath>
+
+// The relative volume at which to set the crossfade position on a track.
+constexpr double kCrossfadeVolume = 0.3;
+
+// The number of RMS windows per second.
+constexpr long kWindowsPerSecond = 10;
+
+// Read block size, in samples per channel.
+constexpr long kReadBlockSize = 4096;
+
+bool TrackAnalyser::Results::IsComplete() const
+{
+	return TrackGain.has_value() && TruePeak.has_value() && LeadingSilence.has_value() && TrailingSilence.has_value() && CrossfadePosition.has_value();
+}
+
+void TrackAnalyser::Results::Merge( const Results& other )
+{
+	if ( !TrackGain.has_value() ) {
+		TrackGain = other.TrackGain;
+	}
+	if ( !TruePeak.has_value() ) {
+		TruePeak = other.TruePeak;
+	}
+	if ( !LeadingSilence.has_value() ) {
+		LeadingSilence = other.LeadingSilence;
+	}
+	if ( !TrailingSilence.has_value() ) {
+		TrailingSilence = other.TrailingSilence;
+	}
+	if ( !CrossfadePosition.has_value() ) {
+		CrossfadePosition = other.CrossfadePosition;
+	}
+}
+
+TrackAnalyser::TrackAnalyser( const long channels, const long sampleRate, const Analysers& analysers ) :
+	m_Channels( static_cast<size_t>( std::max<long>( 0l, channels ) ) ),
+	m_SampleRate( sampleRate ),
+	m_Analysers( analysers ),
+	m_R128State( nullptr ),
+	m_Failed( ( channels <= 0 ) || ( sampleRate <= 0 ) ),
+	m_TotalFrames( 0 ),
+	m_LeadingSilentFrames( 0 ),
+	m_HasSound( false ),
+	m_LastSoundFrame( 0 ),
+	m_WindowSize( static_cast<size_t>( std::max<long>( 1l, sampleRate / kWindowsPerSecond ) ) ),
+	m_WindowFrames( 0 ),
+	m_WindowTotal( 0 ),
+	m_CumulativeTotal( 0 ),
+	m_CumulativeCount( 0 ),
+	m_Position( 0 ),
+	m_CrossfadePosition( 0 )
+{
+	if ( !m_Failed && ( m_Analysers.Loudness || m_Analysers.Peak ) ) {
+		int mode = 0;
+		if ( m_Analysers.Loudness ) {
+			mode |= EBUR128_MODE_I;
+		}
+		if ( m_Analysers.Peak ) {
+			mode |= EBUR128_MODE_TRUE_PEAK;
+		}
+		m_R128State = ebur128_init( static_cast<unsigned int>( channels ), static_cast<unsigned long>( sampleRate ), mode );
+		m_Failed = ( nullptr == m_R128State );
+	}
+}
+
+TrackAnalyser::~TrackAnalyser()
+{
+	if ( nullptr != m_R128State ) {
+		ebur128_destroy( &m_R128State );
+	}
+}
+
+TrackAnalyser::Analysers TrackAnalyser::GetAllAnalysers()
+{
+	return Analysers();
+}
+
+bool TrackAnalyser::Add( const float* samples, const size_t frames )
+{
+	if ( !m_Failed && ( nullptr != samples ) && ( frames > 0 ) ) {
+		if ( nullptr != m_R128State ) {
+			m_Failed = ( EBUR128_SUCCESS != ebur128_add_frames_float( m_R128State, samples, frames ) );
+		}
+
+		if ( m_Analysers.Silence || m_Analysers.Crossfade ) {
+			for ( size_t frame = 0; frame < frames; frame++ ) {
+				const float* frameSamples = samples + frame * m_Channels;
+				double frameTotal = 0;
+				bool silent = true;
+				for ( size_t channel = 0; channel < m_Channels; channel++ ) {
+					const double value = frameSamples[ channel ];
+					silent = silent && ( 0 == value );
+					frameTotal += value * value;
+				}
+
+				if ( !silent ) {
+					m_HasSound = true;
+					m_LastSoundFrame = m_TotalFrames;
+				} else if ( !m_HasSound ) {
+					++m_LeadingSilentFrames;
+				}
+				++m_TotalFrames;
+
+				// The RMS envelope starts at the end of any leading silence, which is skipped when crossfading.
+				if ( m_Analysers.Crossfade && m_HasSound ) {
+					m_WindowTotal += frameTotal;
+					if ( ++m_WindowFrames == m_WindowSize ) {
+						ApplyWindow( m_WindowFrames, m_WindowTotal, m_CumulativeTotal, m_CumulativeCount, m_Position, m_CrossfadePosition );
+						m_WindowFrames = 0;
+						m_WindowTotal = 0;
+					}
+				}
+			}
+		} else {
+			m_TotalFrames += static_cast<long long>( frames );
+		}
+	}
+	return !m_Failed;
+}
+
+void TrackAnalyser::ApplyWindow( const size_t frames, const double windowTotal, double& cumulativeTotal, long long& cumulativeCount, double& position, double& crossfadePosition ) const
+{
+	const long long sampleCount = static_cast<long long>( frames * m_Channels );
+	cumulativeTotal += windowTotal;
+	cumulativeCount += sampleCount;
+	position += static_cast<double>( frames ) / m_SampleRate;
+
+	const double windowRMS = sqrt( windowTotal / static_cast<double>( sampleCount ) );
+	const double cumulativeRMS = sqrt( cumulativeTotal / static_cast<double>( cumulativeCount ) );
+	if ( windowRMS > cumulativeRMS ) {
+		crossfadePosition = position;
+	} else if ( ( cumulativeRMS > 0 ) && ( ( windowRMS / cumulativeRMS ) > kCrossfadeVolume ) ) {
+		crossfadePosition = position;
+	}
+}
+
+TrackAnalyser::Results TrackAnalyser::GetResults() const
+{
+	Results results;
+	if ( !m_Failed ) {
+		if ( m_Analysers.Loudness ) {
+			double loudness = 0;
+			if ( EBUR128_SUCCESS == ebur128_loudness_global( m_R128State, &loudness ) ) {
+				results.TrackGain = LOUDNESS_REFERENCE - static_cast<float>( loudness );
+			}
+		}
+
+		if ( m_Analysers.Peak ) {
+			double peak = 0;
+			bool success = true;
+			for ( unsigned int channel = 0; success && ( channel < m_Channels ); channel++ ) {
+				double channelPeak = 0;
+				success = ( EBUR128_SUCCESS == ebur128_true_peak( m_R128State, channel, &channelPeak ) );
+				peak = std::max<float>( peak, channelPeak );
+			}
+			if ( success ) {
+				results.TruePeak = static_cast<float>( peak );
+			}
+		}
+
+		if ( m_Analysers.Silence || m_Analysers.Crossfade ) {
+			results.LeadingSilence = static_cast<float>( static_cast<double>( m_LeadingSilentFrames ) / m_SampleRate );
+		}
+
+		if ( m_Analysers.Silence ) {
+			const long long trailingFrames = m_HasSound ? ( m_TotalFrames - m_LastSoundFrame - 1 ) : 0;
+			results.TrailingSilence = static_cast<float>( static_cast<double>( trailingFrames ) / m_SampleRate );
+		}
+
+		if ( m_Analysers.Crossfade ) {
+			// Include any partial window at the end of the stream.
+			double cumulativeTotal = m_CumulativeTotal;
+			long long cumulativeCount = m_CumulativeCount;
+			double position = m_Position;
+			double crossfadePosition = m_CrossfadePosition;
+			if ( m_WindowFrames > 0 ) {
+				ApplyWindow( m_WindowFrames, m_WindowTotal, cumulativeTotal, cumulativeCount, position, crossfadePosition );
+			}
+			results.CrossfadePosition = static_cast<float>( crossfadePosition );
+		}
+	}
+	return results;
+}
+
+std::optional<float> TrackAnalyser::GetAlbumGain( const std::vector<Ptr>& analysers )
+{
+	std::optional<float> albumGain;
+	std::vector<ebur128_state*> r128States;
+	r128States.reserve( analysers.size() );
+	for ( const auto& analyser : analysers ) {
+		if ( analyser && !analyser->m_Failed && analyser->m_Analysers.Loudness && ( nullptr != analyser->m_R128State ) ) {
+			r128States.push_back( analyser->m_R128State );
+		}
+	}
+	if ( !r128States.empty() ) {
+		double loudness = 0;
+		if ( EBUR128_SUCCESS == ebur128_loudness_global_multiple( r128States.data(), r128States.size(), &loudness ) ) {
+			albumGain = LOUDNESS_REFERENCE - static_cast<float>( loudness );
+		}
+	}
+	return albumGain;
+}
+
+std::optional<TrackAnalyser::Results> TrackAnalyser::Analyse( Decoder& decoder, const Analysers& analysers, Decoder::CanContinue canContinue )
+{
+	std::optional<Results> results;
+	const long channels = decoder.GetChannels();
+	const long sampleRate = decoder.GetSampleRate();
+	if ( ( channels > 0 ) && ( sampleRate > 0 ) ) {
+		TrackAnalyser analyser( channels, sampleRate, analysers );
+		std::vector<float> buffer( kReadBlockSize * channels );
+		bool success = true;
+		long samplesRead = decoder.Read( buffer.data(), kReadBlockSize );
+		while ( success && ( samplesRead > 0 ) && canContinue() ) {
+			success = analyser.Add( buffer.data(), static_cast<size_t>( samplesRead ) );
+			samplesRead = decoder.Read( buffer.data(), kReadBlockSize );
+		}
+		if ( success && canContinue() ) {
+			results = analyser.GetResults();
+		}
+	}
+	return results;
+}
+
+std::optional<TrackAnalyser::Results> TrackAnalyser::AnalyseFile( const MediaInfo& mediaInfo, Library& library, const Handlers& handlers, Decoder::CanContinue canContinue )
+{
+	std::optional<Results> results = library.GetAnalysis( mediaInfo );
+	if ( !results.has_value() || !results->IsComplete() ) {
+		const std::wstring& filename = mediaInfo.GetFilename();
+		if ( ( nullptr != canContinue ) && !IsURL( filename ) ) {
+			if ( const Decoder::Ptr decoder = handlers.OpenDecoder( filename ); decoder ) {
+				if ( const auto analysis = Analyse( *decoder, GetAllAnalysers(), canContinue ); analysis.has_value() ) {
+					results = analysis;
+					library.SetAnalysis( mediaInfo, *results );
+				}
+			}
+		}
+	}
+	return results;
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+#include "stdafx.h"
+
+#include "Decoder.h"
+#include "MediaInfo.h"
+
+#include "ebur128.h"
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+class Handlers;
+class Library;
+
+// Analyses decoded sample data in a single pass, applying any combination of analysers.
+// This allows a file to be decoded once, with all results persisted together in the media library.
+class TrackAnalyser
+{
+public:
+	// Shared track analyser pointer type.
+	using Ptr = std::shared_ptr<TrackAnalyser>;
+
+	// Analysers to apply.
+	struct Analysers {
+		bool Loudness = true;		// Integrated loudness (EBU R128).
+		bool Peak = true;				// True peak.
+		bool Silence = true;		// Leading & trailing silence.
+		bool Crossfade = true;	// RMS envelope, from which the crossfade position is determined.
+	};
+
+	// Analysis results, where each value is only available if the corresponding analyser was applied.
+	struct Results {
+		std::optional<float> TrackGain;					// Track gain, in dB.
+		std::optional<float> TruePeak;					// True peak, as a linear amplitude.
+		std::optional<float> LeadingSilence;		// Leading silence, in seconds.
+		std::optional<float> TrailingSilence;		// Trailing silence, in seconds.
+		std::optional<float> CrossfadePosition;	// Crossfade position, in seconds, relative to the end of any leading silence.
+
+		// Returns whether all results are available.
+		bool IsComplete() const;
+
+		// Fills in any unavailable results from 'other'.
+		void Merge( const Results& other );
+	};
+
+	// 'channels' - number of channels.
+	// 'sampleRate' - sample rate.
+	// 'analysers' - analysers to apply.
+	TrackAnalyser( const long channels, const long sampleRate, const Analysers& analysers );
+
+	virtual ~TrackAnalyser();
+
+	// Returns all analysers.
+	static Analysers GetAllAnalysers();
+
+	// Adds sample data to the analysis.
+	// 'samples' - interleaved sample data.
+	// 'frames' - number of samples per channel.
+	// Returns false if the analysis failed.
+	bool Add( const float* samples, const size_t frames );
+
+	// Returns the analysis results for all sample data added so far.
+	Results GetResults() const;
+
+	// Returns the album gain, in dB, for the 'analysers' (which should all have applied loudness analysis), or nullopt if the album gain could not be calculated.
+	static std::optional<float> GetAlbumGain( const std::vector<Ptr>& analysers );
+
+	// Analyses a 'decoder', from its current position to the end of the stream.
+	// 'analysers' - analysers to apply.
+	// 'canContinue' - callback which returns whether the analysis can continue.
+	// Returns the analysis results, or nullopt if the analysis failed or was cancelled.
+	static std::optional<Results> Analyse( Decoder& decoder, const Analysers& analysers, Decoder::CanContinue canContinue );
+
+	// Returns the complete analysis results for the 'mediaInfo' file, from the 'library' if available, otherwise by decoding the file once and storing the results in the 'library'.
+	// 'handlers' - media handlers.
+	// 'canContinue' - callback which returns whether the analysis can continue.
+	// Returns the analysis results, or nullopt if the analysis failed or was cancelled.
+	static std::optional<Results> AnalyseFile( const MediaInfo& mediaInfo, Library& library, const Handlers& handlers, Decoder::CanContinue canContinue );
+
+private:
+	// Applies the RMS envelope for a window of 'frames' with a 'windowTotal' sum of squares, updating the cumulative state & the 'crossfadePosition'.
+	void ApplyWindow( const size_t frames, const double windowTotal, double& cumulativeTotal, long long& cumulativeCount, double& position, double& crossfadePosition ) const;
+
+	// Number of channels.
+	const size_t m_Channels;
+
+	// Sample rate.
+	const long m_SampleRate;
+
+	// Analysers to apply.
+	const Analysers m_Analysers;
+
+	// EBU R128 state, used for loudness & true peak analysis.
+	ebur128_state* m_R128State;
+
+	// Indicates whether the analysis has failed.
+	bool m_Failed;
+
+	// Total number of frames analysed.
+	long long m_TotalFrames;
+
+	// Number of leading silent frames.
+	long long m_LeadingSilentFrames;
+
+	// Indicates whether any non-silent frame has been analysed.
+	bool m_HasSound;
+
+	// The index of the last non-silent frame.
+	long long m_LastSoundFrame;
+
+	// RMS window length, in frames.
+	const size_t m_WindowSize;
+
+	// Number of frames in the current RMS window.
+	size_t m_WindowFrames;
+
+	// Sum of squares for the current RMS window.
+	double m_WindowTotal;
+
+	// Cumulative sum of squares, for all complete RMS windows.
+	double m_CumulativeTotal;
+
+	// Cumulative sample count, for all complete RMS windows.
+	long long m_CumulativeCount;
+
+	// Position at the end of the last complete RMS window, in seconds (relative to the end of any leading silence).
+	double m_Position;
+
+	// Crossfade position determined from all complete RMS windows, in seconds.
+	double m_CrossfadePosition;
+};
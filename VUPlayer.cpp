@@ -66,8 +66,10 @@ VUPlayer::VUPlayer( const HINSTANCE instance, const HWND hwnd, const std::list<s
 	m_Library( m_Database, m_Handlers ),
 	m_Maintainer( m_hInst, m_Library, m_Handlers ),
 	m_Settings( m_Database, m_Library, portableSettings ),
-	m_Output( m_hInst, m_hWnd, m_Handlers, m_Settings ),
+	m_SeekIndexer( m_Library, m_Handlers ),
+	m_Output( m_hInst, m_hWnd, m_Handlers, m_Settings, m_SeekIndexer ),
 	m_GainCalculator( m_Library, m_Handlers ),
+	m_CrossfadeCalculator( m_Library, m_Handlers ),
 	m_Scrobbler( m_Database, m_Settings, portable /*disable*/ ),
 	m_MusicBrainz( m_hInst, m_hWnd, m_Settings, portable /*disable*/ ),
 	m_DiscManager( m_hInst, m_hWnd, m_Library, m_Handlers, m_MusicBrainz ),
@@ -580,6 +582,8 @@ void VUPlayer::OnDestroy()
 	UpdateScrobbler( m_CurrentOutput, m_Output.GetCurrentPlaying() );
 
 	m_GainCalculator.Stop();
+	m_CrossfadeCalculator.Stop();
+	m_SeekIndexer.Stop();
 	m_Maintainer.Stop();
 
 	WriteWindowSettings();
@@ -854,6 +858,10 @@ void VUPlayer::OnCommand( const int commandID )
 			OnCalculateGain();
 			break;
 		}
+		case ID_FILE_CALCULATECROSSFADE : {
+			OnCalculateCrossfade();
+			break;
+		}
 		case ID_VIEW_TRACKINFORMATION : {
 			OnTrackInformation();
 			break;
@@ -934,13 +942,14 @@ void VUPlayer::OnCommand( const int commandID )
 			OnOptions();
 			break;
 		}
-		case ID_FILE_REFRESHMEDIALIBRARY : {
+		case ID_FILE_REFRESHMEDIALIBRARY :
+		case ID_FILE_QUICKREFRESHMEDIALIBRARY : {
 			m_Maintainer.Start( [ playlistAll = m_Tree.GetPlaylistAll() ] ( const std::filesystem::path& file )
 			{
 				if ( playlistAll ) {
 					playlistAll->AddPending( file );
 				}
-			} );
+			}, ( ID_FILE_QUICKREFRESHMEDIALIBRARY == commandID ) );
 			break;
 		}
 		case ID_FILE_CONVERT : {
@@ -1103,6 +1112,10 @@ void VUPlayer::OnCommand( const int commandID )
 			ShellExecute( NULL, L"open", s_OnlineDocs, NULL, NULL, SW_SHOWNORMAL );
 			break;
 		}
+		case ID_HELP_SAVEAUDIODIAGNOSTICS : {
+			OnSaveAudioDiagnostics();
+			break;
+		}
 		case ID_TOOLBAR_FILE :
 		case ID_TOOLBAR_PLAYLIST :
 		case ID_TOOLBAR_FAVOURITES :
@@ -1172,8 +1185,11 @@ void VUPlayer::OnInitMenu( const HMENU menu )
 		EnableMenuItem( menu, ID_FILE_ADDTOFAVOURITES, MF_BYCOMMAND | addToFavouritesEnabled );
 		const UINT gainCalculatorEnabled = selectedItems ? MF_ENABLED : MF_DISABLED;
 		EnableMenuItem( menu, ID_FILE_CALCULATEGAIN, MF_BYCOMMAND | gainCalculatorEnabled );
+		const UINT crossfadeCalculatorEnabled = ( playlist && ( Playlist::Type::CDDA != playlist->GetType() ) && ( playlist->GetCount() > 0 ) ) ? MF_ENABLED : MF_DISABLED;
+		EnableMenuItem( menu, ID_FILE_CALCULATECROSSFADE, MF_BYCOMMAND | crossfadeCalculatorEnabled );
 		const UINT refreshLibraryEnabled = ( m_IsPortableMode || m_Maintainer.IsActive() ) ? MF_DISABLED : MF_ENABLED;
 		EnableMenuItem( menu, ID_FILE_REFRESHMEDIALIBRARY, MF_BYCOMMAND | refreshLibraryEnabled );
+		EnableMenuItem( menu, ID_FILE_QUICKREFRESHMEDIALIBRARY, MF_BYCOMMAND | refreshLibraryEnabled );
 		const UINT musicbrainzEnabled = ( playlist && ( Playlist::Type::CDDA == playlist->GetType() ) && IsMusicBrainzEnabled() ) ? MF_ENABLED : MF_DISABLED;
 		EnableMenuItem( menu, ID_FILE_MUSICBRAINZ_QUERY, MF_BYCOMMAND | musicbrainzEnabled );
 
@@ -1364,16 +1380,41 @@ void VUPlayer::OnMediaUpdated( const MediaInfo& previousMediaInfo, const MediaIn
 	PostMessage( m_hWnd, MSG_MEDIAUPDATED, reinterpret_cast<WPARAM>( previousInfo ), reinterpret_cast<LPARAM>( updatedInfo ) );
 }
 
+void VUPlayer::OnMediaUpdated( const MediaInfo::UpdateList& updates )
+{
+	MediaInfo::UpdateList* updateList = new MediaInfo::UpdateList( updates );
+	PostMessage( m_hWnd, MSG_MEDIALISTUPDATED, reinterpret_cast<WPARAM>( updateList ), 0 );
+}
+
 void VUPlayer::OnHandleMediaUpdate( const MediaInfo* previousMediaInfo, const MediaInfo* updatedMediaInfo )
 {
-	if ( ( nullptr != previousMediaInfo ) && ( nullptr != updatedMediaInfo ) && ( previousMediaInfo->GetSource() == updatedMediaInfo->GetSource() ) ) {
-		const Playlist::Set updatedPlaylists = m_Tree.OnUpdatedMedia( *previousMediaInfo, *updatedMediaInfo );
+	if ( ( nullptr != previousMediaInfo ) && ( nullptr != updatedMediaInfo ) ) {
+		const MediaInfo::UpdateList updates = { std::make_pair( *previousMediaInfo, *updatedMediaInfo ) };
+		OnHandleMediaUpdate( &updates );
+	}
+}
+
+void VUPlayer::OnHandleMediaUpdate( const MediaInfo::UpdateList* updates )
+{
+	if ( nullptr != updates ) {
+		bool outputUpdated = false;
 		const Playlist::Ptr currentPlaylist = m_List.GetPlaylist();
-		if ( currentPlaylist && ( updatedPlaylists.end() != updatedPlaylists.find( currentPlaylist ) ) ) {
-			m_List.OnUpdatedMedia( *updatedMediaInfo );
+		for ( const auto& update : *updates ) {
+			const MediaInfo& previousMediaInfo = update.first;
+			const MediaInfo& updatedMediaInfo = update.second;
+			if ( previousMediaInfo.GetSource() == updatedMediaInfo.GetSource() ) {
+				const Playlist::Set updatedPlaylists = m_Tree.OnUpdatedMedia( previousMediaInfo, updatedMediaInfo );
+				if ( currentPlaylist && ( updatedPlaylists.end() != updatedPlaylists.find( currentPlaylist ) ) ) {
+					m_List.OnUpdatedMedia( updatedMediaInfo );
+				}
+				if ( m_Output.OnUpdatedMedia( updatedMediaInfo ) ) {
+					outputUpdated = true;
+				}
+			}
 		}
 
-		if ( m_Output.OnUpdatedMedia( *updatedMediaInfo ) ) {
+		// Refresh the output related windows once for the whole batch.
+		if ( outputUpdated ) {
 			if ( ID_VISUAL_ARTWORK == m_Visual.GetCurrentVisualID() ) {
 				m_Splitter.Resize();
 				m_Visual.DoRender();
@@ -1576,6 +1617,13 @@ void VUPlayer::OnCalculateGain()
 	m_GainCalculator.Calculate( selectedItems );
 }
 
+void VUPlayer::OnCalculateCrossfade()
+{
+	if ( const Playlist::Ptr playlist = m_List.GetPlaylist(); playlist ) {
+		m_CrossfadeCalculator.Calculate( playlist->GetItems() );
+	}
+}
+
 Playlist::Ptr VUPlayer::NewPlaylist()
 {
 	Playlist::Ptr playlist = m_Tree.NewPlaylist();
@@ -2012,6 +2060,40 @@ void VUPlayer::OnExportSettings()
 	}
 }
 
+void VUPlayer::OnSaveAudioDiagnostics()
+{
+	WCHAR title[ MAX_PATH ] = {};
+	LoadString( m_hInst, IDS_AUDIODIAGNOSTICS_TITLE, title, MAX_PATH );
+
+	WCHAR filter[ MAX_PATH ] = {};
+	LoadString( m_hInst, IDS_AUDIODIAGNOSTICS_FILTER, filter, MAX_PATH );
+	const std::wstring filter1( filter );
+	const std::wstring filter2( L"*.json" );
+	std::vector<WCHAR> filterStr;
+	filterStr.reserve( MAX_PATH );
+	filterStr.insert( filterStr.end(), filter1.begin(), filter1.end() );
+	filterStr.push_back( 0 );
+	filterStr.insert( filterStr.end(), filter2.begin(), filter2.end() );
+	filterStr.push_back( 0 );
+	filterStr.push_back( 0 );
+
+	WCHAR buffer[ MAX_PATH ] = {};
+	LoadString( m_hInst, IDS_AUDIODIAGNOSTICS_DEFAULT, buffer, MAX_PATH );
+
+	OPENFILENAME ofn = {};
+	ofn.lStructSize = sizeof( OPENFILENAME );
+	ofn.hwndOwner = m_hWnd;
+	ofn.lpstrTitle = title;
+	ofn.lpstrFilter = &filterStr[ 0 ];
+	ofn.nFilterIndex = 1;
+	ofn.Flags = OFN_OVERWRITEPROMPT | OFN_PATHMUSTEXIST | OFN_EXPLORER;
+	ofn.lpstrFile = buffer;
+	ofn.nMaxFile = MAX_PATH;
+	if ( FALSE != GetSaveFileName( &ofn ) ) {
+		m_Output.SaveAudioPathMetrics( ofn.lpstrFile );
+	}
+}
+
 HWND VUPlayer::GetEQ() const
 {
 	return m_EQ.GetWindowHandle();
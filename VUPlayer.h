@@ -4,6 +4,7 @@
 
 #include "resource.h"
 
+#include "CrossfadeCalculator.h"
 #include "Database.h"
 #include "DiscManager.h"
 #include "GainCalculator.h"
@@ -13,6 +14,7 @@
 #include "MusicBrainz.h"
 #include "Output.h"
 #include "Scrobbler.h"
+#include "SeekIndexer.h"
 #include "Settings.h"
 
 #include "DlgEQ.h"
@@ -47,6 +49,11 @@
 // 'lParam' : pointer to updated MediaInfo, to be deleted by the message handler.
 static constexpr UINT MSG_MEDIAUPDATED = WM_APP + 77;
 
+// Message ID for signalling that media information has been updated for a batch of media.
+// 'wParam' : pointer to MediaInfo::UpdateList, to be deleted by the message handler.
+// 'lParam' : unused.
+static constexpr UINT MSG_MEDIALISTUPDATED = WM_APP + 78;
+
 // Message ID for signalling that the list of available optical discs has been refreshed.
 // 'wParam' : unused.
 // 'lParam' : unused.
@@ -119,9 +126,16 @@ public:
 	// 'updatedMediaInfo' - the updated media information.
 	void OnMediaUpdated( const MediaInfo& previousMediaInfo, const MediaInfo& updatedMediaInfo );
 
+	// Called when information in the media database is updated for a batch of media.
+	// 'updates' - the previous and updated media information.
+	void OnMediaUpdated( const MediaInfo::UpdateList& updates );
+
 	// Handles the update of 'previousMediaInfo' to 'updatedMediaInfo', from the main thread.
 	void OnHandleMediaUpdate( const MediaInfo* previousMediaInfo, const MediaInfo* updatedMediaInfo );
 
+	// Handles a batch of media information 'updates', from the main thread.
+	void OnHandleMediaUpdate( const MediaInfo::UpdateList* updates );
+
 	// Handles the refreshing of available optical discs.
 	void OnHandleDiscRefreshed();
 
@@ -183,6 +197,9 @@ public:
 	// Exports application settings, for use when running in 'portable' mode.
 	void OnExportSettings();
 
+	// Called when the Save Audio Diagnostics command is received.
+	void OnSaveAudioDiagnostics();
+
 	// Returns the EQ modeless dialog window handle.
 	HWND GetEQ() const;
 
@@ -246,6 +263,9 @@ private:
 	// Called when the Calculate Gain command is received.
 	void OnCalculateGain();
 
+	// Called when the Calculate Crossfade Points command is received.
+	void OnCalculateCrossfade();
+
 	// Called when the Add to Favourites command is received.
 	void OnAddToFavourites();
 
@@ -304,12 +324,18 @@ private:
 	// Application settings.
 	Settings m_Settings;
 
+	// Seek index generator.
+	SeekIndexer m_SeekIndexer;
+
 	// Output.
 	Output m_Output;
 
 	// Gain calculator.
 	GainCalculator m_GainCalculator;
 
+	// Crossfade point calculator.
+	CrossfadeCalculator m_CrossfadeCalculator;
+
 	// Scrobbler manager.
 	Scrobbler m_Scrobbler;
 
@@ -759,6 +759,9 @@ void WndList::OnContextMenu( const POINT& position )
 			const UINT enableGainCalculator = hasSelectedItems ? MF_ENABLED : MF_DISABLED;
 			EnableMenuItem( listmenu, ID_FILE_CALCULATEGAIN, MF_BYCOMMAND | enableGainCalculator );
 
+			const UINT enableCrossfadeCalculator = ( m_Playlist && ( Playlist::Type::CDDA != m_Playlist->GetType() ) && ( m_Playlist->GetCount() > 0 ) ) ? MF_ENABLED : MF_DISABLED;
+			EnableMenuItem( listmenu, ID_FILE_CALCULATECROSSFADE, MF_BYCOMMAND | enableCrossfadeCalculator );
+
 			VUPlayer* vuplayer = VUPlayer::Get();
 
 			const UINT musicbrainzEnabled = ( m_Playlist && ( Playlist::Type::CDDA == m_Playlist->GetType() ) && ( nullptr != vuplayer ) && vuplayer->IsMusicBrainzEnabled() ) ? MF_ENABLED : MF_DISABLED;
@@ -1,5 +1,14 @@
 #include "stdafx.h"
 
+#include "DecoderBenchmark.h"
+#include "DSPBenchmark.h"
+#include "FileReadBenchmark.h"
+#include "GainCalculatorBenchmark.h"
+#include "IngestBenchmark.h"
+#include "LibraryBenchmark.h"
+#include "GaplessTest.h"
+#include "ResamplerBenchmark.h"
+#include "TaskSchedulerTest.h"
 #include "Utility.h"
 #include "VUPlayer.h"
 
@@ -33,6 +42,33 @@ static const TCHAR s_portableCmdLineSwitch[] = L"-portable";
 // Command line switch to set the database access mode.
 static const TCHAR s_databasemodeCmdLineSwitch[] = L"-mode";
 
+// Command line switch to run the decoder benchmark, and then exit.
+static const TCHAR s_benchmarkCmdLineSwitch[] = L"-benchmark";
+
+// Command line switch to run the resampler benchmark, and then exit.
+static const TCHAR s_resamplerBenchmarkCmdLineSwitch[] = L"-resamplerbenchmark";
+
+// Command line switch to run the DSP benchmark, and then exit.
+static const TCHAR s_dspBenchmarkCmdLineSwitch[] = L"-dspbenchmark";
+
+// Command line switch to run the gain calculator benchmark, and then exit.
+static const TCHAR s_gainBenchmarkCmdLineSwitch[] = L"-gainbenchmark";
+
+// Command line switch to run the gapless transition test, and then exit.
+static const TCHAR s_gaplessTestCmdLineSwitch[] = L"-gaplesstest";
+
+// Command line switch to run the task scheduler test, and then exit.
+static const TCHAR s_schedulerTestCmdLineSwitch[] = L"-schedulertest";
+
+// Command line switch to run the file read benchmark, and then exit.
+static const TCHAR s_fileReadBenchmarkCmdLineSwitch[] = L"-iobenchmark";
+
+// Command line switch to run the media library benchmark, and then exit.
+static const TCHAR s_libraryBenchmarkCmdLineSwitch[] = L"-librarybenchmark";
+
+// Command line switch to run the media library ingest benchmark, and then exit.
+static const TCHAR s_ingestBenchmarkCmdLineSwitch[] = L"-ingestbenchmark";
+
 // Makes a basic check to see whether a command line entry represents Audio CD autoplay.
 // Returns the Audio CD path to autoplay, or an empty string otherwise.
 std::wstring AutoplayAudioCD( LPCWSTR cmdLineEntry )
@@ -67,6 +103,17 @@ int APIENTRY wWinMain( _In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstanc
 	bool portable = false;
 	std::string portableSettings;
 	Database::Mode mode = Database::Mode::Temp;
+	std::wstring benchmarkFolder;
+	std::wstring benchmarkResults;
+	std::wstring resamplerBenchmarkResults;
+	std::wstring dspBenchmarkResults;
+	std::wstring gainBenchmarkResults;
+	std::wstring gaplessTestResults;
+	std::wstring schedulerTestResults;
+	std::wstring fileReadBenchmarkFolder;
+	std::wstring fileReadBenchmarkResults;
+	std::wstring libraryBenchmarkResults;
+	std::wstring ingestBenchmarkResults;
 
 	int numArgs = 0;
 	LPWSTR* args = CommandLineToArgvW( GetCommandLine(), &numArgs );
@@ -107,6 +154,62 @@ int APIENTRY wWinMain( _In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstanc
 					} catch ( ... ) {
 					}
 				}
+			} else if ( 0 == _wcsicmp( args[ argc ], s_benchmarkCmdLineSwitch ) ) {
+				// Handle the '-benchmark' command-line switch (and the following media folder & results file arguments).
+				if ( ( argc + 2 ) < numArgs ) {
+					benchmarkFolder = args[ argc + 1 ];
+					benchmarkResults = args[ argc + 2 ];
+					argc += 2;
+				}
+			} else if ( 0 == _wcsicmp( args[ argc ], s_resamplerBenchmarkCmdLineSwitch ) ) {
+				// Handle the '-resamplerbenchmark' command-line switch (and the following results file argument).
+				if ( ( argc + 1 ) < numArgs ) {
+					resamplerBenchmarkResults = args[ argc + 1 ];
+					++argc;
+				}
+			} else if ( 0 == _wcsicmp( args[ argc ], s_dspBenchmarkCmdLineSwitch ) ) {
+				// Handle the '-dspbenchmark' command-line switch (and the following results file argument).
+				if ( ( argc + 1 ) < numArgs ) {
+					dspBenchmarkResults = args[ argc + 1 ];
+					++argc;
+				}
+			} else if ( 0 == _wcsicmp( args[ argc ], s_gainBenchmarkCmdLineSwitch ) ) {
+				// Handle the '-gainbenchmark' command-line switch (and the following results file argument).
+				if ( ( argc + 1 ) < numArgs ) {
+					gainBenchmarkResults = args[ argc + 1 ];
+					++argc;
+				}
+			} else if ( 0 == _wcsicmp( args[ argc ], s_gaplessTestCmdLineSwitch ) ) {
+				// Handle the '-gaplesstest' command-line switch (and the following results file argument).
+				if ( ( argc + 1 ) < numArgs ) {
+					gaplessTestResults = args[ argc + 1 ];
+					++argc;
+				}
+			} else if ( 0 == _wcsicmp( args[ argc ], s_schedulerTestCmdLineSwitch ) ) {
+				// Handle the '-schedulertest' command-line switch (and the following results file argument).
+				if ( ( argc + 1 ) < numArgs ) {
+					schedulerTestResults = args[ argc + 1 ];
+					++argc;
+				}
+			} else if ( 0 == _wcsicmp( args[ argc ], s_fileReadBenchmarkCmdLineSwitch ) ) {
+				// Handle the '-iobenchmark' command-line switch (and the following media folder & results file arguments).
+				if ( ( argc + 2 ) < numArgs ) {
+					fileReadBenchmarkFolder = args[ argc + 1 ];
+					fileReadBenchmarkResults = args[ argc + 2 ];
+					argc += 2;
+				}
+			} else if ( 0 == _wcsicmp( args[ argc ], s_libraryBenchmarkCmdLineSwitch ) ) {
+				// Handle the '-librarybenchmark' command-line switch (and the following results file argument).
+				if ( ( argc + 1 ) < numArgs ) {
+					libraryBenchmarkResults = args[ argc + 1 ];
+					++argc;
+				}
+			} else if ( 0 == _wcsicmp( args[ argc ], s_ingestBenchmarkCmdLineSwitch ) ) {
+				// Handle the '-ingestbenchmark' command-line switch (and the following results file argument).
+				if ( ( argc + 1 ) < numArgs ) {
+					ingestBenchmarkResults = args[ argc + 1 ];
+					++argc;
+				}
 			} else {
 				const DWORD attributes = GetFileAttributes( args[ argc ] );
 				if ( ( INVALID_FILE_ATTRIBUTES != attributes ) && !( FILE_ATTRIBUTE_DIRECTORY & attributes ) ) {
@@ -123,6 +226,90 @@ int APIENTRY wWinMain( _In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstanc
 		LocalFree( args );
 	}
 
+	if ( !benchmarkFolder.empty() ) {
+		// Run the decoder benchmark without creating the main window.
+		BASS_Init( 0 /*device*/, 48000 /*freq*/, 0 /*flags*/, NULL /*hwnd*/, NULL /*dsGUID*/ );
+		bool success = false;
+		{
+			const Handlers handlers;
+			success = DecoderBenchmark( handlers ).Run( benchmarkFolder, benchmarkResults );
+		}
+		BASS_Free();
+		return success ? 0 : 1;
+	}
+
+	if ( !resamplerBenchmarkResults.empty() ) {
+		// Run the resampler benchmark without creating the main window.
+		const bool success = ResamplerBenchmark().Run( resamplerBenchmarkResults );
+		return success ? 0 : 1;
+	}
+
+	if ( !dspBenchmarkResults.empty() ) {
+		// Run the DSP benchmark without creating the main window.
+		const bool success = DSPBenchmark().Run( dspBenchmarkResults );
+		return success ? 0 : 1;
+	}
+
+	if ( !gainBenchmarkResults.empty() ) {
+		// Run the gain calculator benchmark without creating the main window.
+		BASS_Init( 0 /*device*/, 48000 /*freq*/, 0 /*flags*/, NULL /*hwnd*/, NULL /*dsGUID*/ );
+		bool success = false;
+		{
+			const Handlers handlers;
+			success = GainCalculatorBenchmark( handlers ).Run( gainBenchmarkResults );
+		}
+		BASS_Free();
+		return success ? 0 : 1;
+	}
+
+	if ( !gaplessTestResults.empty() ) {
+		// Run the gapless transition test without creating the main window.
+		const bool success = GaplessTest( hInstance ).Run( gaplessTestResults );
+		return success ? 0 : 1;
+	}
+
+	if ( !schedulerTestResults.empty() ) {
+		// Run the task scheduler test without creating the main window.
+		const bool success = TaskSchedulerTest().Run( schedulerTestResults );
+		return success ? 0 : 1;
+	}
+
+	if ( !fileReadBenchmarkFolder.empty() ) {
+		// Run the file read benchmark without creating the main window.
+		BASS_Init( 0 /*device*/, 48000 /*freq*/, 0 /*flags*/, NULL /*hwnd*/, NULL /*dsGUID*/ );
+		bool success = false;
+		{
+			const Handlers handlers;
+			success = FileReadBenchmark( handlers ).Run( fileReadBenchmarkFolder, fileReadBenchmarkResults );
+		}
+		BASS_Free();
+		return success ? 0 : 1;
+	}
+
+	if ( !libraryBenchmarkResults.empty() ) {
+		// Run the media library benchmark without creating the main window.
+		BASS_Init( 0 /*device*/, 48000 /*freq*/, 0 /*flags*/, NULL /*hwnd*/, NULL /*dsGUID*/ );
+		bool success = false;
+		{
+			const Handlers handlers;
+			success = LibraryBenchmark( handlers ).Run( libraryBenchmarkResults );
+		}
+		BASS_Free();
+		return success ? 0 : 1;
+	}
+
+	if ( !ingestBenchmarkResults.empty() ) {
+		// Run the media library ingest benchmark without creating the main window.
+		BASS_Init( 0 /*device*/, 48000 /*freq*/, 0 /*flags*/, NULL /*hwnd*/, NULL /*dsGUID*/ );
+		bool success = false;
+		{
+			const Handlers handlers;
+			success = IngestBenchmark( handlers ).Run( ingestBenchmarkResults );
+		}
+		BASS_Free();
+		return success ? 0 : 1;
+	}
+
 	// Limit application to a single instance
 	const HANDLE hMutex = CreateMutex( NULL /*attributes*/, FALSE /*initialOwner*/, g_szWindowClass );
 	if ( ( NULL != hMutex ) && ( ERROR_ALREADY_EXISTS == GetLastError() ) ) {
@@ -394,6 +581,15 @@ LRESULT CALLBACK WndProc( HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam
 			}
 			break;
 		}
+		case MSG_MEDIALISTUPDATED : {
+			if ( nullptr != vuplayer ) {
+				const MediaInfo::UpdateList* updates = reinterpret_cast<const MediaInfo::UpdateList*>( wParam );
+				vuplayer->OnHandleMediaUpdate( updates );
+				delete updates;
+				updates = nullptr;
+			}
+			break;
+		}
 		case MSG_DISCREFRESHED : {
 			if ( nullptr != vuplayer ) {
 				vuplayer->OnHandleDiscRefreshed();
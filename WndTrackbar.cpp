@@ -5,6 +5,8 @@
 #include "VUPlayer.h"
 #include "windowsx.h"
 
+#include <algorithm>
+
 // Trackbar control ID
 UINT_PTR WndTrackbar::s_WndTrackbarID = 1600;
 
@@ -137,7 +139,8 @@ WndTrackbar::WndTrackbar( HINSTANCE instance, HWND parent, Output& output, Setti
 	m_BackgroundColour( GetSysColor( COLOR_WINDOW ) ),
 	m_IsHighContrast( IsHighContrastActive() ),
 	m_IsClassicTheme( IsClassicThemeActive() ),
-	m_IsWindows10( IsWindows10() )
+	m_IsWindows10( IsWindows10() ),
+	m_HighlightRange()
 {
 	WNDCLASSEX wc = {};
 	wc.cbSize = sizeof( WNDCLASSEX );
@@ -211,6 +214,14 @@ int WndTrackbar::GetRange() const
 	return range;
 }
 
+void WndTrackbar::SetHighlightRange( const std::optional<std::pair<int, int>>& range )
+{
+	if ( range != m_HighlightRange ) {
+		m_HighlightRange = range;
+		InvalidateRect( m_hTrackbarWnd, nullptr /*rect*/, FALSE /*erase*/ );
+	}
+}
+
 HINSTANCE WndTrackbar::GetInstanceHandle() const
 {
 	return m_hInst;
@@ -302,7 +313,9 @@ std::optional<LRESULT> WndTrackbar::OnCustomDraw( LPNMCUSTOMDRAW nmcd )
 		if ( CDDS_PREPAINT == nmcd->dwDrawStage ) {
 			result = CDRF_NOTIFYITEMDRAW;
 		} else if ( CDDS_ITEMPREPAINT == nmcd->dwDrawStage ) {
-			if ( TBCD_THUMB == nmcd->dwItemSpec ) {
+			if ( ( TBCD_CHANNEL == nmcd->dwItemSpec ) && m_HighlightRange ) {
+				result = CDRF_NOTIFYPOSTPAINT;
+			} else if ( TBCD_THUMB == nmcd->dwItemSpec ) {
 				Gdiplus::Graphics graphics( nmcd->hdc );
 				Gdiplus::Color colour;
 				colour.SetFromCOLORREF( GetThumbColour( nmcd->rc ) );
@@ -314,11 +327,42 @@ std::optional<LRESULT> WndTrackbar::OnCustomDraw( LPNMCUSTOMDRAW nmcd )
 				graphics.FillRectangle( &brush, x, y, width - 1, height - 1 );
 				result = CDRF_SKIPDEFAULT;
 			}
+		} else if ( CDDS_ITEMPOSTPAINT == nmcd->dwDrawStage ) {
+			if ( TBCD_CHANNEL == nmcd->dwItemSpec ) {
+				DrawHighlightRange( nmcd->hdc, nmcd->rc );
+				result = CDRF_DODEFAULT;
+			}
 		}
 	}
 	return result;
 }
 
+void WndTrackbar::DrawHighlightRange( const HDC dc, const RECT& channelRect ) const
+{
+	const int range = GetRange();
+	if ( m_HighlightRange && ( range > 0 ) ) {
+		// The thumb centre moves between the channel ends, inset by half the thumb width.
+		RECT thumbRect = {};
+		SendMessage( m_hTrackbarWnd, TBM_GETTHUMBRECT, 0, reinterpret_cast<LPARAM>( &thumbRect ) );
+		const int minValue = static_cast<int>( SendMessage( m_hTrackbarWnd, TBM_GETRANGEMIN, 0, 0 ) );
+		const int inset = ( thumbRect.right - thumbRect.left ) / 2;
+		const int channelWidth = std::max<int>( 0, static_cast<int>( channelRect.right - channelRect.left ) - 2 * inset );
+		const auto toX = [ & ] ( const int position )
+		{
+			return channelRect.left + inset + MulDiv( std::clamp( position - minValue, 0, range ), channelWidth, range );
+		};
+		const int left = toX( m_HighlightRange->first );
+		const int right = toX( m_HighlightRange->second );
+		if ( right > left ) {
+			Gdiplus::Graphics graphics( dc );
+			Gdiplus::Color colour;
+			colour.SetFromCOLORREF( m_ThumbColour );
+			Gdiplus::SolidBrush brush( Gdiplus::Color( 128 /*alpha*/, colour.GetR(), colour.GetG(), colour.GetB() ) );
+			graphics.FillRectangle( &brush, left, channelRect.top, right - left, channelRect.bottom - channelRect.top );
+		}
+	}
+}
+
 bool WndTrackbar::ShowContextMenu( const POINT& /*position*/ )
 {
 	return true;
@@ -110,6 +110,9 @@ protected:
 	// Returns the trackbar range.
 	int GetRange() const;
 
+	// Sets a 'range' of trackbar positions to highlight in the trackbar channel, or nullopt to remove the highlight.
+	void SetHighlightRange( const std::optional<std::pair<int, int>>& range );
+
 private:
 	// Window procedure for the window that hosts the trackbar.
 	static LRESULT CALLBACK TrackbarHostProc( HWND hwnd, UINT message, WPARAM wParam, LPARAM lParam );
@@ -136,6 +139,11 @@ private:
 	// 'thumbRect' - thumb location, in client coordinates.
 	COLORREF GetThumbColour( const RECT& thumbRect ) const;
 
+	// Draws the highlight range onto the trackbar channel.
+	// 'dc' - device context.
+	// 'channelRect' - channel location, in client coordinates.
+	void DrawHighlightRange( const HDC dc, const RECT& channelRect ) const;
+
 	// Module instance handle.
 	HINSTANCE m_hInst;
 
@@ -171,5 +179,8 @@ private:
 
 	// Indicates whether the OS is Windows 10 (or later).
 	const bool m_IsWindows10;
+
+	// Range of trackbar positions to highlight in the trackbar channel.
+	std::optional<std::pair<int, int>> m_HighlightRange;
 };
 
@@ -85,12 +85,20 @@ void WndTrackbarSeek::Update( Output& output, const Playlist::Ptr playlist, cons
 		}
 		const float duration = m_OutputItem.PlaylistItem.Info.GetDuration();
 		SetEnabled( duration > 0.0f );
+		std::optional<std::pair<int, int>> highlightRange;
 		if ( duration > 0.0f ) {
 			const float position = m_OutputItem.Position;
 			const int seekPos = static_cast<int>( position * s_RangeMax / duration );
 			SetPosition( seekPos );
+
+			// Show the part of the item which is buffered in memory, within which seeks are immediate.
+			if ( const auto bufferedRange = output.GetBufferedRange( m_OutputItem.PlaylistItem.ID ); bufferedRange ) {
+				const auto& [ start, end ] = *bufferedRange;
+				highlightRange = { static_cast<int>( start * s_RangeMax / duration ), static_cast<int>( end * s_RangeMax / duration ) };
+			}
 		} else {
 			SetPosition( 0 );
 		}
+		SetHighlightRange( highlightRange );
 	}
 }
@@ -871,7 +871,7 @@ void WndTree::OnDestroy()
 	for ( const auto& iter : m_PlaylistMap ) {
 		const Playlist::Ptr playlist = iter.second;
 		if ( playlist ) {
-			playlist->StopPendingThread();
+			playlist->StopPendingTask();
 		}
 	}
 
@@ -883,52 +883,52 @@ void WndTree::OnDestroy()
 	}
 
 	if ( m_PlaylistFavourites ) {
-		m_PlaylistFavourites->StopPendingThread();
+		m_PlaylistFavourites->StopPendingTask();
 		m_Settings.SavePlaylist( *m_PlaylistFavourites );
 	}
 
 	if ( m_PlaylistStreams ) {
-		m_PlaylistStreams->StopPendingThread();
+		m_PlaylistStreams->StopPendingTask();
 	}
 
 	if ( m_PlaylistAll ) {
-		m_PlaylistAll->StopPendingThread();
+		m_PlaylistAll->StopPendingTask();
 	}
 
 	for ( const auto& iter : m_ArtistMap ) {
 		if ( iter.second ) {
-			iter.second->StopPendingThread();
+			iter.second->StopPendingTask();
 		}
 	}
 
 	for ( const auto& iter : m_AlbumMap ) {
 		if ( iter.second ) {
-			iter.second->StopPendingThread();
+			iter.second->StopPendingTask();
 		}
 	}
 
 	for ( const auto& iter : m_GenreMap ) {
 		if ( iter.second ) {
-			iter.second->StopPendingThread();
+			iter.second->StopPendingTask();
 		}
 	}
 
 	for ( const auto& iter : m_YearMap ) {
 		if ( iter.second ) {
-			iter.second->StopPendingThread();
+			iter.second->StopPendingTask();
 		}
 	}
 
 	for ( const auto& iter : m_CDDAMap ) {
 		if ( iter.second ) {
-			iter.second->StopPendingThread();
+			iter.second->StopPendingTask();
 		}
 	}
 
 	std::lock_guard<std::mutex> lock( m_FolderPlaylistMapMutex );
 	for ( const auto& iter : m_FolderPlaylistMap ) {
 		if ( iter.second ) {
-			iter.second->StopPendingThread();
+			iter.second->StopPendingTask();
 		}
 	}
 
@@ -971,7 +971,7 @@ void WndTree::AddPlaylist( const Playlist::Ptr playlist )
 			TreeView_SelectItem( m_hWnd, hItem );
 			SetFocus( m_hWnd );
 			if ( playlist->GetPendingCount() > 0 ) {
-				playlist->StartPendingThread();
+				playlist->StartPendingTask();
 			}
 		}
 	}
@@ -1033,7 +1033,7 @@ void WndTree::ImportPlaylist( const std::wstring& filename )
 
 	if ( !playlistFilename.empty() ) {
 		Playlist::Ptr playlist( new Playlist( m_Library, Playlist::Type::User ) );
-		if ( playlist->AddPlaylist( playlistFilename, false /*startPendingThread*/ ) ) {
+		if ( playlist->AddPlaylist( playlistFilename, false /*startPendingTask*/ ) ) {
 			const size_t nameDelimiter = playlistFilename.find_last_of( L"/\\" );
 			const size_t extDelimiter = playlistFilename.rfind( '.' );
 			if ( ( std::wstring::npos != nameDelimiter ) && ( extDelimiter > nameDelimiter ) ) {
@@ -1146,7 +1146,7 @@ void WndTree::ProcessPendingPlaylists()
 	for ( const auto& iter : m_PlaylistMap ) {
 		Playlist::Ptr playlist = iter.second;
 		if ( playlist && ( playlist->GetPendingCount() > 0 ) ) {
-			playlist->StartPendingThread();
+			playlist->StartPendingTask();
 		}
 	}
 }